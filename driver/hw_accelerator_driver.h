@@ -59,7 +59,9 @@ int hw_driver_is_hwsecured(bool*);
 /* Get all three version nbs of the IP (major, minor & patch) */
 int hw_driver_get_version_tags(uint32_t*, uint32_t*, uint32_t*);
 
-/* Set the curve parameters a, b, p and q */
+/* Set the curve parameters a, b, p and q
+ * (if the IP has curve context slots, a curve already set before
+ * is restored from its slot instead of being uploaded again) */
 int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
 			const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz);
 
@@ -231,6 +233,97 @@ int hw_driver_set_small_scalar_size(uint32_t bit_sz);
 /* To get hardware capabilities from the IP */
 int hw_driver_get_capabilities(bool* secure, bool* shuffle, bool* nndyn, bool* axi64, uint32_t* nnmax);
 
+/* Hardware command queue (only if the IP was synthesized with 'cmdqsize' > 0)
+ *
+ * [k]P computations are enqueued with hw_driver_cmdq_push_mul() and replayed
+ * back-to-back by the IP, results being retrieved in the same order with
+ * hw_driver_cmdq_pop_mul(). While the queue is enabled, per-operation IRQs
+ * are coalesced into one IRQ every 'irq_thr' completions. A push is refused
+ * when the results not retrieved yet would overflow the result FIFO (which
+ * has the depth of the queue), and polling loops give up after some time.
+ */
+int hw_driver_cmdq_enable(uint32_t irq_thr);
+int hw_driver_cmdq_disable(void);
+int hw_driver_cmdq_flush(void);
+int hw_driver_cmdq_push_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+		const uint8_t *scalar, uint32_t scalar_sz, uint32_t tag);
+int hw_driver_cmdq_pop_mul(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+		uint32_t *tag);
+int hw_driver_cmdq_get_idle_cycles(uint32_t *cycles);
+
+/* AXI-Stream transfer of big numbers (only if the IP was synthesized with
+ * 'axistream' = TRUE): 'tx' & 'rx' are the memory-mapped windows of the
+ * bridge that feeds/drains the AXI-Stream ports of the IP.
+ */
+int hw_driver_set_axis_window(volatile uint8_t *tx, volatile uint8_t *rx);
+
+/* Read 'out_sz' bytes of random produced by the IP TRNG (only if the IP was
+ * synthesized with 'trngexport' = TRUE, in HW unsecure mode), e.g to seed
+ * a software DRBG.
+ */
+int hw_driver_get_random(uint8_t *out, uint32_t out_sz);
+
+/* Continuous health tests over the raw random bits of the TRNG
+ * (repetition count & adaptive proportion tests of NIST SP 800-90B,
+ * running bias & autocorrelation estimates), see source file
+ * hw_accelerator_driver_ipecc_health.c.
+ *
+ * hw_driver_trng_health_init() sets the min-entropy claimed per raw bit
+ * (in hundredths of bit, 1 to 100) & clears all counters. Raw bits are
+ * then either fed by the caller, packed into 32-bit words, through
+ * hw_driver_trng_health_feed() or acquired from the IP by a background
+ * thread (Linux only, HW unsecure mode only) between calls to
+ * hw_driver_trng_health_start_DBG() & hw_driver_trng_health_stop_DBG().
+ *
+ * The background thread is an offline/idle-time tool, not a monitor of a
+ * live IP: each window it acquires disables the post-processing of the
+ * TRNG, no other driver function may be called while it runs (except
+ * hw_driver_trng_health_get()), and it tests only a fraction of the raw
+ * bits produced (acquisition is much slower than the entropy source).
+ */
+#define TRNG_HEALTH_LAGS   8
+
+typedef struct {
+	uint32_t rct_cutoff;                   /* cutoff of the repetition count test */
+	uint32_t apt_cutoff;                   /* cutoff of the adaptive proportion test */
+	uint64_t bits;                         /* nb of raw bits tested */
+	uint64_t rct_fail;                     /* nb of runs of identical bits >= rct_cutoff */
+	uint32_t rct_max;                      /* longest run of identical bits */
+	uint64_t apt_windows;                  /* nb of APT windows (1024 bits) tested */
+	uint64_t apt_fail;                     /* nb of APT windows with count >= apt_cutoff */
+	uint32_t apt_max;                      /* largest count in an APT window */
+	uint64_t ones;                         /* nb of bits at 1 (bias = ones / bits) */
+	uint64_t lag_pairs[TRNG_HEALTH_LAGS];  /* nb of pairs (b[i], b[i+k]) tested, k = 1.. */
+	uint64_t lag_equal[TRNG_HEALTH_LAGS];  /* nb of them with b[i] = b[i+k] */
+	/* background thread only */
+	uint64_t windows;                      /* nb of windows of raw bits acquired */
+	uint64_t acq_errors;                   /* nb of failed acquisitions */
+	uint64_t raw_cycles;                   /* time for the IP to produce them (clk cycles) */
+	uint64_t acq_ns;                       /* time spent acquiring them */
+	uint64_t test_ns;                      /* time spent testing them */
+} trng_health_t;
+
+int hw_driver_trng_health_init(uint32_t h_x100);
+int hw_driver_trng_health_feed(const uint32_t* words, uint32_t nbbits, bool cont);
+int hw_driver_trng_health_get(trng_health_t* cnt);
+int hw_driver_trng_health_start_DBG(void);
+int hw_driver_trng_health_stop_DBG(void);
+
+/* DMA engine (only if the IP was instanciated through top-level 'ecc_dma')
+ *
+ * [k]P computations are written as job descriptors into a ring in a DMA-able
+ * buffer with hw_driver_dma_push_mul(), processed by the IP acting as a bus
+ * master, and retrieved in the same order with hw_driver_dma_pop_mul().
+ * The IRQ of the engine is raised every 'irq_thr' completions. While jobs
+ * are pending no other function of the driver must be called.
+ */
+int hw_driver_dma_enable(uint32_t irq_thr);
+int hw_driver_dma_disable(void);
+int hw_driver_dma_push_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+		const uint8_t *scalar, uint32_t scalar_sz, uint32_t tag);
+int hw_driver_dma_pop_mul(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+		uint32_t *tag);
+
 /* To determine if the IP is in mode "HW unsecure"
  *
  * Watch-out/reminder: this is not a dynamic mode but a static one:
@@ -467,6 +560,34 @@ int hw_driver_get_trng_raw_fifo_state_DBG(bool*, uint32_t*);
  */
 int hw_driver_get_content_of_trng_raw_random_fifo_DBG(char*, uint32_t*);
 
+/* Acquire one window of contiguous raw random bits from the TRNG (the
+ * whole raw FIFO) packed into 32-bit words, along with the nb of cycles
+ * it took the entropy source to produce them.
+ * (only in HW unsecure mode).
+ */
+int hw_driver_get_trng_raw_window_DBG(uint32_t*, uint32_t*, uint32_t*);
+
+/* Pseudo TRNG device (only if instanciated next to the IP, see
+ * hdl/common/pseudo_trng.vhd): map it, select it (or the entropy
+ * source of the IP back) as the raw random source, empty its FIFO
+ * & push bytes into it.
+ * (only in HW unsecure mode).
+ */
+int hw_driver_pseudotrng_setup_DBG(void);
+int hw_driver_trng_use_pseudo_source_DBG(bool);
+int hw_driver_pseudotrng_reset_DBG(void);
+int hw_driver_pseudotrng_push_DBG(const uint8_t*, uint32_t, uint32_t*);
+
+/* Deterministic replay of the raw random source through the pseudo TRNG
+ * device, from a file in the format of HDL parameter 'simtrngfile' or from
+ * a seeded PRNG, see source file hw_accelerator_driver_ipecc_replay.c.
+ * (only in HW unsecure mode).
+ */
+void hw_driver_pseudotrng_prng(uint64_t* state, uint8_t* out, uint32_t sz);
+int hw_driver_pseudotrng_replay_start_DBG(const char* simtrngfile, uint64_t seed);
+int hw_driver_pseudotrng_replay_refill_DBG(void);
+int hw_driver_pseudotrng_replay_stop_DBG(uint64_t* nbbytes, bool* eof);
+
 /* To estimate from software the IP clock frequenciies
  * (only in HW unsecure mode).
  */
@@ -116,10 +116,34 @@ err:
  * specific routines.
  */
 static volatile uint64_t *ipecc_baddr = NULL;
-/* Uncomment line below to use the Pseudo TRNG feature
- * (not yet officially released on the IPECC repo).
- */
-/* static volatile uint64_t *ipecc_pseudotrng_baddr = NULL; */
+/* Base address of the optional pseudo TRNG device (see below). It is only
+ * mapped on demand, by hw_driver_pseudotrng_setup_DBG(), and stays NULL
+ * otherwise.
+ */
+static volatile uint64_t *ipecc_pseudotrng_baddr = NULL;
+
+/* Windows of the memory-mapped to AXI-Stream bridge (if any) connected
+ * to the AXI-Stream ports of the IP: each word written at increasing
+ * addresses of 'ipecc_axis_tx' is pushed as one beat on the slave port,
+ * each word read at increasing addresses of 'ipecc_axis_rx' is popped
+ * from the master port. Set with hw_driver_set_axis_window(), they stay
+ * NULL otherwise (big numbers then go through W_WRITE_DATA/R_READ_DATA).
+ */
+static volatile ip_ecc_word *ipecc_axis_tx = NULL;
+static volatile ip_ecc_word *ipecc_axis_rx = NULL;
+
+/* Last value written into (write-only) register W_DBG_TRNG_CFG, so that
+ * the raw random source can be switched without changing the rest of
+ * the TRNG configuration. Defaults are those of the IP after its AXI
+ * reset (a soft reset doesn't change them), 'ta' being the default value
+ * of parameter 'trngta' in ecc_customize.
+ */
+static struct {
+	int debias;
+	uint32_t ta;
+	uint32_t idle;
+	bool pseudo;
+} ipecc_trng_cfg = { 1, 32, 0, false };
 
 /* NOTE: addresses in the IP are 64-bit aligned */
 #define IPECC_ALIGNED(a) ((a) / sizeof(uint64_t))
@@ -149,6 +173,29 @@ static volatile uint64_t *ipecc_baddr = NULL;
 /* Read-only registers */
 #define IPECC_PSEUDOTRNG_R_FIFO_COUNT   (ipecc_pseudotrng_baddr + IPECC_ALIGNED(0x00))
 
+/* Size (in bytes) of the FIFO of the pseudo TRNG device
+ * (constant FIFO_BYTE_SIZE in pseudo_trng.vhd) */
+#define IPECC_PSEUDOTRNG_FIFO_SZ        (4096)
+
+/* Register bank of the DMA engine (only if the IP was instanciated through
+ * top-level 'ecc_dma', see ecc_dma.vhd). It is mapped right after the
+ * register bank of the IP itself, i.e at offset 0x200 from its base address.
+ */
+/* Write-only registers */
+#define IPECC_DMA_W_CTRL        (ipecc_baddr + IPECC_ALIGNED(0x200))
+#define IPECC_DMA_W_RING_BASE   (ipecc_baddr + IPECC_ALIGNED(0x208))
+#define IPECC_DMA_W_RING_LOG    (ipecc_baddr + IPECC_ALIGNED(0x210))
+#define IPECC_DMA_W_TAIL        (ipecc_baddr + IPECC_ALIGNED(0x218))
+#define IPECC_DMA_W_IRQ_ACK     (ipecc_baddr + IPECC_ALIGNED(0x220))
+
+/* Read-only registers */
+#define IPECC_DMA_R_CTRL        (ipecc_baddr + IPECC_ALIGNED(0x200))
+#define IPECC_DMA_R_RING_BASE   (ipecc_baddr + IPECC_ALIGNED(0x208))
+#define IPECC_DMA_R_RING_LOG    (ipecc_baddr + IPECC_ALIGNED(0x210))
+#define IPECC_DMA_R_TAIL        (ipecc_baddr + IPECC_ALIGNED(0x218))
+#define IPECC_DMA_R_STATUS      (ipecc_baddr + IPECC_ALIGNED(0x220))
+#define IPECC_DMA_R_HEAD        (ipecc_baddr + IPECC_ALIGNED(0x228))
+
 /*************************************
  * Bit & fields positions in registers
  *************************************/
@@ -166,6 +213,7 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_W_CTRL_WRITE_NB		(((uint32_t)0x1) << 16)
 #define IPECC_W_CTRL_READ_NB		(((uint32_t)0x1) << 17)
 #define IPECC_W_CTRL_WRITE_K		(((uint32_t)0x1) << 18)
+#define IPECC_W_CTRL_AXIS		(((uint32_t)0x1) << 19)
 #define IPECC_W_CTRL_NBADDR_MSK		(0xfff)
 #define IPECC_W_CTRL_NBADDR_POS		(20)
 
@@ -341,8 +389,77 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_W_ATK_DIVMM_FACTOR_POS     (16)
 #define IPECC_W_ATK_DIVMM_FACTOR_MASK    (0xfffe)
 
+/* Fields for W_CMDQ_OP */
+#define IPECC_W_CMDQ_OP_REG_POS   (0)
+#define IPECC_W_CMDQ_OP_REG_MSK   (0x3f)
+#define IPECC_W_CMDQ_OP_KIND_POS   (8)
+#define IPECC_W_CMDQ_OP_KIND_MSK   (0x3)
+#define IPECC_CMDQ_KIND_WRITE   (0x0)
+#define IPECC_CMDQ_KIND_READ    (0x1)
+#define IPECC_CMDQ_KIND_DONE    (0x2)
+
+/* Fields for W_CMDQ_CTRL */
+#define IPECC_W_CMDQ_CTRL_EN   (((uint32_t)0x1) << 0)
+#define IPECC_W_CMDQ_CTRL_FLUSH   (((uint32_t)0x1) << 4)
+#define IPECC_W_CMDQ_CTRL_IRQ_POS   (16)
+#define IPECC_W_CMDQ_CTRL_IRQ_MSK   (0xffff)
+
+/* Fields for W_CURVE_SELECT */
+#define IPECC_W_CURVE_SELECT_SLOT_POS   (0)
+#define IPECC_W_CURVE_SELECT_SLOT_MSK   (0xf)
+#define IPECC_W_CURVE_SELECT_LOAD   (((uint32_t)0x1) << 8)
+
+/* Fields for W_FASTRED */
+#define IPECC_W_FASTRED_MODE_POS   (0)
+#define IPECC_W_FASTRED_MODE_MSK   (0x3)
+#define IPECC_FASTRED_NONE   (0x0)
+#define IPECC_FASTRED_P256   (0x1)
+#define IPECC_FASTRED_P384   (0x2)
+
+/* Fields for W_MTYCST */
+#define IPECC_W_MTYCST_NB_POS   (0)
+#define IPECC_W_MTYCST_NB_MSK   (0x3)
+#define IPECC_MTYCST_R2MODP   (0x0)
+#define IPECC_MTYCST_TWOP   (0x1)
+#define IPECC_MTYCST_RMODP   (0x2)
+#define IPECC_MTYCST_PPRIME   (0x3)
+
+/* Fields for DMA_W_CTRL & DMA_R_CTRL */
+#define IPECC_DMA_CTRL_EN   (((uint32_t)0x1) << 0)
+#define IPECC_DMA_CTRL_IRQ_POS   (16)
+#define IPECC_DMA_CTRL_IRQ_MSK   (0xffff)
+
+/* Fields for DMA_R_STATUS */
+#define IPECC_DMA_ST_ACTIVE   (((uint32_t)0x1) << 0)
+#define IPECC_DMA_ST_IRQ   (((uint32_t)0x1) << 1)
+#define IPECC_DMA_ST_BUSERR   (((uint32_t)0x1) << 2)
+#define IPECC_DMA_ST_DONE_POS   (16)
+#define IPECC_DMA_ST_DONE_MSK   (0xffff)
+
+/* Max value in DMA_W_RING_LOG */
+#define IPECC_DMA_RING_LOG_MAX   (15)
+
+/* Layout of a DMA job descriptor (in words of the AXI data bus) */
+#define IPECC_DMA_DESC_WORDS   (8)
+#define IPECC_DMA_DESC_CTRL   (0)
+#define IPECC_DMA_DESC_K   (1)
+#define IPECC_DMA_DESC_P0   (2)
+#define IPECC_DMA_DESC_P1   (3)
+#define IPECC_DMA_DESC_RES   (4)
+#define IPECC_DMA_DESC_TAG   (5)
+/* Fields of word IPECC_DMA_DESC_CTRL of a descriptor */
+#define IPECC_DMA_DESC_OP_POS   (0)   /* position of the command bit in W_CTRL */
+#define IPECC_DMA_DESC_OP_MSK   (0x7)
+#define IPECC_DMA_DESC_R0_NULL   (((uint32_t)0x1) << 8)
+#define IPECC_DMA_DESC_R1_NULL   (((uint32_t)0x1) << 9)
+#define IPECC_DMA_DESC_CURVE_POS   (16)
+#define IPECC_DMA_DESC_CURVE_MSK   (0xff)
+#define IPECC_DMA_DESC_DONE   (((uint32_t)0x1) << 31)
+
 /* Fields for R_STATUS */
 #define IPECC_R_STATUS_BUSY	   (((uint32_t)0x1) << 0)
+#define IPECC_R_STATUS_CMDQ	   (((uint32_t)0x1) << 1)
+#define IPECC_R_STATUS_MTYOVL	   (((uint32_t)0x1) << 2)
 #define IPECC_R_STATUS_KP	   (((uint32_t)0x1) << 4)
 #define IPECC_R_STATUS_MTY	   (((uint32_t)0x1) << 5)
 #define IPECC_R_STATUS_POP	   (((uint32_t)0x1) << 6)
@@ -359,12 +476,47 @@ static volatile uint64_t *ipecc_baddr = NULL;
 
 /* Fields for R_CAPABILITIES */
 #define IPECC_R_CAPABILITIES_DBG_N_PROD   (((uint32_t)0x1) << 0)
+#define IPECC_R_CAPABILITIES_MTYOVL   (((uint32_t)0x1) << 1)
+#define IPECC_R_CAPABILITIES_HOSTMTY   (((uint32_t)0x1) << 2)
+#define IPECC_R_CAPABILITIES_FASTRED   (((uint32_t)0x1) << 3)
 #define IPECC_R_CAPABILITIES_SHF   (((uint32_t)0x1) << 4)
+#define IPECC_R_CAPABILITIES_CMDQ   (((uint32_t)0x1) << 5)
+#define IPECC_R_CAPABILITIES_AXIS   (((uint32_t)0x1) << 6)
+#define IPECC_R_CAPABILITIES_CTX   (((uint32_t)0x1) << 7)
 #define IPECC_R_CAPABILITIES_NNDYN   (((uint32_t)0x1) << 8)
 #define IPECC_R_CAPABILITIES_W64   (((uint32_t)0x1) << 9)
+#define IPECC_R_CAPABILITIES_TRNGEXP   (((uint32_t)0x1) << 10)
 #define IPECC_R_CAPABILITIES_NNMAX_MSK	(0xfffff)
 #define IPECC_R_CAPABILITIES_NNMAX_POS	(12)
 
+/* Fields for R_CMDQ_STATUS */
+#define IPECC_R_CMDQ_STATUS_FREE_POS   (0)
+#define IPECC_R_CMDQ_STATUS_FREE_MSK   (0xffff)
+#define IPECC_R_CMDQ_STATUS_RES_POS   (16)
+#define IPECC_R_CMDQ_STATUS_RES_MSK   (0xffff)
+
+/* Fields for R_MTYCST */
+#define IPECC_R_MTYCST_WW_POS   (0)
+#define IPECC_R_MTYCST_WW_MSK   (0xff)
+#define IPECC_R_MTYCST_SEEN_POS   (8)
+#define IPECC_R_MTYCST_SEEN_MSK   (0xf)
+#define IPECC_R_MTYCST_ARMED   (((uint32_t)0x1) << 12)
+
+/* Fields for R_TRNG_STATUS */
+#define IPECC_R_TRNG_STATUS_CNT_POS   (0)
+#define IPECC_R_TRNG_STATUS_CNT_MSK   (0xffffff)
+#define IPECC_R_TRNG_STATUS_WW_POS   (24)
+#define IPECC_R_TRNG_STATUS_WW_MSK   (0xff)
+
+/* Fields for R_CURVE_STATUS */
+#define IPECC_R_CURVE_STATUS_VALID_POS   (0)
+#define IPECC_R_CURVE_STATUS_VALID_MSK   (0xffff)
+#define IPECC_R_CURVE_STATUS_CUR_POS   (16)
+#define IPECC_R_CURVE_STATUS_CUR_MSK   (0xf)
+#define IPECC_R_CURVE_STATUS_BOUND   (((uint32_t)0x1) << 20)
+#define IPECC_R_CURVE_STATUS_NB_POS   (24)
+#define IPECC_R_CURVE_STATUS_NB_MSK   (0x1f)
+
 /* Fields for R_HW_VERSION */
 #define IPECC_R_HW_VERSION_MAJOR_POS    (24)
 #define IPECC_R_HW_VERSION_MAJOR_MSK    (0xff)
@@ -503,6 +655,15 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_BUSY_WAIT() do { \
 	while(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_BUSY){}; \
 } while(0)
+/* Same as IPECC_BUSY_WAIT but also returns when the IP, only busy
+ * computing the Montgomery constants, accepts the write of a, b or q
+ * (bit MTYOVL of R_STATUS, only if CAP_MTYOVL is set in R_CAPABILITIES).
+ */
+#define IPECC_BUSY_WAIT_MTYOVL() do { \
+	while((IPECC_GET_REG(IPECC_R_STATUS) \
+	       & (IPECC_R_STATUS_BUSY | IPECC_R_STATUS_MTYOVL)) \
+	      == IPECC_R_STATUS_BUSY){}; \
+} while(0)
 /* The following macros IPECC_IS_BUSY_* are to obtain more info, when the IP is busy,
  * on why it is busy.
  * However one should keep in mind that polling code should restrict to IPECC_BUSY_WAIT
@@ -592,12 +753,15 @@ static volatile uint64_t *ipecc_baddr = NULL;
 /* Write in register W_CTRL the address of the big number to read
  * and assert the read-command bit.
  *
- * Also assert the specific bit if the number to read is the token.
+ * Also assert the specific bit if the number to read is the token,
+ * and the AXIS bit if the words are to be popped from the AXI-Stream
+ * master port instead of from register R_READ_DATA.
  */
-#define IPECC_SET_READ_ADDR(addr, token) do { \
+#define IPECC_SET_READ_ADDR(addr, token, axis) do { \
 	ip_ecc_word val = 0; \
 	val |= IPECC_W_CTRL_READ_NB; \
 	val |= ((token) ? IPECC_W_CTRL_RD_TOKEN : 0); \
+	val |= ((axis) ? IPECC_W_CTRL_AXIS : 0); \
 	val |= (((addr) & IPECC_W_CTRL_NBADDR_MSK) << IPECC_W_CTRL_NBADDR_POS); \
 	IPECC_SET_REG(IPECC_W_CTRL, val); \
 } while(0)
@@ -620,12 +784,15 @@ static volatile uint64_t *ipecc_baddr = NULL;
 /* Write in register W_CTRL the address of the big number to write
  * and assert the write-command bit.
  *
- * Also assert the specific bit if the number to write is the scalar.
+ * Also assert the specific bit if the number to write is the scalar,
+ * and the AXIS bit if the words are to be pushed through the AXI-Stream
+ * slave port instead of into register W_WRITE_DATA.
  */
-#define IPECC_SET_WRITE_ADDR(addr, scal) do { \
+#define IPECC_SET_WRITE_ADDR(addr, scal, axis) do { \
 	ip_ecc_word val = 0; \
 	val |= IPECC_W_CTRL_WRITE_NB; \
 	val |= ((scal) ? IPECC_W_CTRL_WRITE_K : 0); \
+	val |= ((axis) ? IPECC_W_CTRL_AXIS : 0); \
 	val |= ((addr & IPECC_W_CTRL_NBADDR_MSK) << IPECC_W_CTRL_NBADDR_POS); \
 	IPECC_SET_REG(IPECC_W_CTRL, val); \
 } while(0)
@@ -895,6 +1062,178 @@ static volatile uint64_t *ipecc_baddr = NULL;
 	(IPECC_SET_REG(IPECC_W_SOFT_RESET, 1)); /* written value actually is indifferent */ \
 } while (0)
 
+/*
+ * Actions using registers W_CMDQ_* & R_CMDQ_*
+ * (hardware command queue)
+ * *******************************************
+ */
+/* Index of a register as expected in field REG of W_CMDQ_OP */
+#define IPECC_CMDQ_REG_IDX(reg)	((uint32_t)((reg) - ipecc_baddr))
+
+/* Set the (sticky) kind & target register of the next entries to push */
+#define IPECC_CMDQ_SET_OP(kind, idx) do { \
+	IPECC_SET_REG(IPECC_W_CMDQ_OP, \
+			(((kind) & IPECC_W_CMDQ_OP_KIND_MSK) << IPECC_W_CMDQ_OP_KIND_POS) \
+			| (((idx) & IPECC_W_CMDQ_OP_REG_MSK) << IPECC_W_CMDQ_OP_REG_POS)); \
+} while (0)
+
+/* Push one entry (made of the current op & of 'data') into the queue */
+#define IPECC_CMDQ_PUSH(data) do { \
+	IPECC_SET_REG(IPECC_W_CMDQ_PUSH, (data)); \
+} while (0)
+
+/* Enable/disable the dispatcher & set the IRQ coalescing threshold */
+#define IPECC_CMDQ_SET_CTRL(en, thr) do { \
+	IPECC_SET_REG(IPECC_W_CMDQ_CTRL, ((en) ? IPECC_W_CMDQ_CTRL_EN : 0) \
+			| (((thr) & IPECC_W_CMDQ_CTRL_IRQ_MSK) << IPECC_W_CMDQ_CTRL_IRQ_POS)); \
+} while (0)
+
+/* Empty both the command queue & the result FIFO (also stops the dispatcher) */
+#define IPECC_CMDQ_FLUSH() do { \
+	IPECC_SET_REG(IPECC_W_CMDQ_CTRL, IPECC_W_CMDQ_CTRL_FLUSH); \
+} while (0)
+
+/* Nb of free entries in the command queue */
+#define IPECC_CMDQ_GET_FREE() \
+	((IPECC_GET_REG(IPECC_R_CMDQ_STATUS) >> IPECC_R_CMDQ_STATUS_FREE_POS) \
+	 & IPECC_R_CMDQ_STATUS_FREE_MSK)
+
+/* Nb of words available in the result FIFO */
+#define IPECC_CMDQ_GET_RES_COUNT() \
+	((IPECC_GET_REG(IPECC_R_CMDQ_STATUS) >> IPECC_R_CMDQ_STATUS_RES_POS) \
+	 & IPECC_R_CMDQ_STATUS_RES_MSK)
+
+/* Pop one word from the result FIFO */
+#define IPECC_CMDQ_POP_RESULT() (IPECC_GET_REG(IPECC_R_CMDQ_RESULT))
+
+/* Nb of cycles the dispatcher stalled while the IP was idle */
+#define IPECC_CMDQ_GET_IDLE_CYCLES() (IPECC_GET_REG(IPECC_R_CMDQ_IDLE))
+
+/* Is the command queue still holding or replaying entries? */
+#define IPECC_IS_CMDQ_ACTIVE() \
+	(!!(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_CMDQ))
+
+/*
+ * Actions using registers W_CURVE_SELECT & R_CURVE_STATUS
+ * (curve context slots)
+ * *******************************************************
+ */
+/* Bind curve context slot 'slot': the parameters written next
+ * (p, a, b & q) are also recorded into that slot */
+#define IPECC_CURVE_BIND(slot) do { \
+	IPECC_SET_REG(IPECC_W_CURVE_SELECT, \
+			((slot) & IPECC_W_CURVE_SELECT_SLOT_MSK) << IPECC_W_CURVE_SELECT_SLOT_POS); \
+} while (0)
+
+/* Restore the curve recorded in context slot 'slot' (also binds it) */
+#define IPECC_CURVE_LOAD(slot) do { \
+	IPECC_SET_REG(IPECC_W_CURVE_SELECT, IPECC_W_CURVE_SELECT_LOAD \
+			| (((slot) & IPECC_W_CURVE_SELECT_SLOT_MSK) << IPECC_W_CURVE_SELECT_SLOT_POS)); \
+} while (0)
+
+/*
+ * Actions using register W_FASTRED
+ * ********************************
+ */
+/* Select the reduction mode (IPECC_FASTRED_*) of the Montgomery
+ * multipliers - this invalidates p & a */
+#define IPECC_SET_FASTRED(mode) do { \
+	IPECC_SET_REG(IPECC_W_FASTRED, \
+			((mode) & IPECC_W_FASTRED_MODE_MSK) << IPECC_W_FASTRED_MODE_POS); \
+} while (0)
+
+/*
+ * Actions using registers W_MTYCST, W_MTYCST_DATA & R_MTYCST
+ * **********************************************************
+ */
+/* Select the Montgomery constant (IPECC_MTYCST_*) the next limbs
+ * are for - this invalidates p & a */
+#define IPECC_SET_MTYCST(nb) do { \
+	IPECC_SET_REG(IPECC_W_MTYCST, \
+			((nb) & IPECC_W_MTYCST_NB_MSK) << IPECC_W_MTYCST_NB_POS); \
+} while (0)
+
+/* Write the next 'ww'-bit limb of the selected Montgomery constant */
+#define IPECC_WRITE_MTYCST_LIMB(limb) do { \
+	IPECC_SET_REG(IPECC_W_MTYCST_DATA, (limb)); \
+} while (0)
+
+/* Value of parameter 'ww' (bit size of the limbs) */
+#define IPECC_GET_MTYCST_WW() \
+	((IPECC_GET_REG(IPECC_R_MTYCST) >> IPECC_R_MTYCST_WW_POS) \
+	 & IPECC_R_MTYCST_WW_MSK)
+
+/* Bitmap of the Montgomery constants completely written since last write of p */
+#define IPECC_GET_MTYCST_SEEN() \
+	((IPECC_GET_REG(IPECC_R_MTYCST) >> IPECC_R_MTYCST_SEEN_POS) \
+	 & IPECC_R_MTYCST_SEEN_MSK)
+
+/*
+ * Actions using registers R_TRNG_STATUS & R_TRNG_DATA
+ * ***************************************************
+ */
+/* Nb of random words which can be read from R_TRNG_DATA without stalling */
+#define IPECC_GET_TRNG_WORDS_AVAIL() \
+	((IPECC_GET_REG(IPECC_R_TRNG_STATUS) >> IPECC_R_TRNG_STATUS_CNT_POS) \
+	 & IPECC_R_TRNG_STATUS_CNT_MSK)
+
+/* Bit size of the random words (value of parameter 'ww') */
+#define IPECC_GET_TRNG_WORD_SZ() \
+	((IPECC_GET_REG(IPECC_R_TRNG_STATUS) >> IPECC_R_TRNG_STATUS_WW_POS) \
+	 & IPECC_R_TRNG_STATUS_WW_MSK)
+
+/* Pop one random word */
+#define IPECC_READ_TRNG_WORD() \
+	((uint32_t)IPECC_GET_REG(IPECC_R_TRNG_DATA))
+
+/* Nb of curve context slots the IP was synthesized with */
+#define IPECC_GET_CURVE_SLOTS_NB() \
+	((IPECC_GET_REG(IPECC_R_CURVE_STATUS) >> IPECC_R_CURVE_STATUS_NB_POS) \
+	 & IPECC_R_CURVE_STATUS_NB_MSK)
+
+/* Bitmap of the slots holding a complete curve */
+#define IPECC_GET_CURVE_SLOTS_VALID() \
+	((IPECC_GET_REG(IPECC_R_CURVE_STATUS) >> IPECC_R_CURVE_STATUS_VALID_POS) \
+	 & IPECC_R_CURVE_STATUS_VALID_MSK)
+
+/*
+ * Actions involving the DMA engine (top-level 'ecc_dma' only)
+ * ***********************************************************
+ */
+/* Enable/disable the engine & set the IRQ coalescing threshold */
+#define IPECC_DMA_SET_CTRL(en, thr) do { \
+	IPECC_SET_REG(IPECC_DMA_W_CTRL, ((en) ? IPECC_DMA_CTRL_EN : 0) \
+			| (((thr) & IPECC_DMA_CTRL_IRQ_MSK) << IPECC_DMA_CTRL_IRQ_POS)); \
+} while (0)
+
+/* Set the bus address & the size (2**lg descriptors) of the ring */
+#define IPECC_DMA_SET_RING(base, lg) do { \
+	IPECC_SET_REG(IPECC_DMA_W_RING_BASE, (base)); \
+	IPECC_SET_REG(IPECC_DMA_W_RING_LOG, (lg)); \
+} while (0)
+
+/* Advance the producer index */
+#define IPECC_DMA_SET_TAIL(idx) do { \
+	IPECC_SET_REG(IPECC_DMA_W_TAIL, (idx)); \
+} while (0)
+
+/* Consumer index */
+#define IPECC_DMA_GET_HEAD() (IPECC_GET_REG(IPECC_DMA_R_HEAD))
+
+/* Acknowledge the DMA interrupt (also clears the count of completed jobs
+ * & the bus error flag) */
+#define IPECC_DMA_ACK_IRQ() do { \
+	IPECC_SET_REG(IPECC_DMA_W_IRQ_ACK, 1); /* written value actually is indifferent */ \
+} while (0)
+
+/* Does the engine still own the register bank of the IP? */
+#define IPECC_IS_DMA_ACTIVE() \
+	(!!(IPECC_GET_REG(IPECC_DMA_R_STATUS) & IPECC_DMA_ST_ACTIVE))
+
+/* Did the engine receive an error response from memory? */
+#define IPECC_IS_DMA_BUSERR() \
+	(!!(IPECC_GET_REG(IPECC_DMA_R_STATUS) & IPECC_DMA_ST_BUSERR))
+
 /*
  * Actions using register R_CAPABILITIES
  * (Capabilities handling)
@@ -913,6 +1252,48 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_IS_W64() \
 	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_W64)))
 
+/* To know if the IP hardware was synthesized with
+ * the hardware command queue ('cmdqsize' > 0).
+ */
+#define IPECC_IS_CMDQ_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_CMDQ)))
+
+/* To know if the IP hardware was synthesized with
+ * the AXI-Stream port for large numbers ('axistream' = TRUE).
+ */
+#define IPECC_IS_AXIS_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_AXIS)))
+
+/* To know if the IP hardware was synthesized with
+ * curve context slots ('nbctx' > 0).
+ */
+#define IPECC_IS_CTX_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_CTX)))
+
+/* To know if the IP hardware was synthesized with the Solinas
+ * reduction mode for P-256 & P-384 ('fastred' = TRUE).
+ */
+#define IPECC_IS_FASTRED_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_FASTRED)))
+
+/* To know if the IP hardware accepts the write of a, b & q while
+ * computing the Montgomery constants ('mtyovl' = TRUE).
+ */
+#define IPECC_IS_MTYOVL_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_MTYOVL)))
+
+/* To know if the IP hardware accepts the Montgomery constants
+ * from software ('hostmty' = TRUE & 'hwsecure' = FALSE).
+ */
+#define IPECC_IS_HOSTMTY_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_HOSTMTY)))
+
+/* To know if the IP hardware lets software read random words from
+ * its TRNG ('trngexport' = TRUE & 'hwsecure' = FALSE).
+ */
+#define IPECC_IS_TRNGEXP_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_TRNGEXP)))
+
 /* Returns the maximum (and default) value allowed for 'nn' parameter (if the IP was
  * synthesized with the 'nn modifiable at runtime' option) or simply the static,
  * unique value of 'nn' the IP supports (otherwise).
@@ -1070,7 +1451,7 @@ static volatile uint64_t *ipecc_baddr = NULL;
  * (configuration of TRNG)
  * *****************************************
  */
-#define IPECC_TRNG_CONFIG(debias, ta, idlenb) do { \
+#define IPECC_TRNG_CONFIG(debias, ta, idlenb, pseudo) do { \
 	uint32_t val = 0; \
 	/* Configure Von Neumann debias logic */ \
 	if (debias) { \
@@ -1080,6 +1461,10 @@ static volatile uint64_t *ipecc_baddr = NULL;
 	  << IPECC_W_DBG_TRNG_CFG_TA_POS; \
 	val |= ((idlenb) & IPECC_W_DBG_TRNG_CFG_TRNG_IDLE_MSK) \
 	  << IPECC_W_DBG_TRNG_CFG_TRNG_IDLE_POS; \
+	/* Select the pseudo TRNG device as raw random source */ \
+	if (pseudo) { \
+		val |= IPECC_W_DBG_TRNG_CFG_USE_PSEUDO; \
+	} \
 	IPECC_SET_REG(IPECC_W_DBG_TRNG_CFG, val); \
 } while (0)
 
@@ -1734,6 +2119,13 @@ static volatile uint64_t *ipecc_baddr = NULL;
 	(IPECC_SET_REG(IPECC_PSEUDOTRNG_W_WRITE_DATA, (data))); \
 } while (0)
 
+/* Actions using register IPECC_PSEUDOTRNG_R_FIFO_COUNT
+ * ****************************************************
+ */
+/* Nb of bytes currently buffered in the FIFO of the pseudo TRNG device */
+#define IPECC_PSEUDOTRNG_GET_FIFO_COUNT() \
+	(IPECC_GET_REG(IPECC_PSEUDOTRNG_R_FIFO_COUNT) & ((2 * IPECC_PSEUDOTRNG_FIFO_SZ) - 1))
+
 
 /************************************************
  * One layer up - Middle-level macros & functions
@@ -1860,8 +2252,25 @@ static inline int ip_ecc_check_error(ip_ecc_error *out)
 	return ret;
 }
 
-/* Select a register for R/W */
-static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw)
+/* Set by hw_driver_set_curve() while it writes a, b & q, to have
+ * ip_ecc_busy_wait() not wait for the end of the computation of the
+ * Montgomery constants (if the IP has CAP_MTYOVL).
+ */
+static bool ip_ecc_mtyovl = false;
+
+/* Wait until the IP is not busy (or only busy computing the Montgomery
+ * constants, if ip_ecc_mtyovl is set) */
+static inline void ip_ecc_busy_wait(void)
+{
+	if(ip_ecc_mtyovl){
+		IPECC_BUSY_WAIT_MTYOVL();
+	} else {
+		IPECC_BUSY_WAIT();
+	}
+}
+
+/* Select a register for R/W (through the AXI-Stream ports if 'axis' is set) */
+static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw, uint8_t axis)
 {
 	uint32_t addr = 0, scal = 0, token = 0;
 
@@ -1914,15 +2323,15 @@ static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw)
 	}
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_busy_wait();
 
 	switch(rw){
 		case EC_HW_REG_READ:{
-			IPECC_SET_READ_ADDR(addr, token);
+			IPECC_SET_READ_ADDR(addr, token, axis);
 			break;
 		}
 		case EC_HW_REG_WRITE:{
-			IPECC_SET_WRITE_ADDR(addr, scal);
+			IPECC_SET_WRITE_ADDR(addr, scal, axis);
 			break;
 		}
 		default:{
@@ -1931,7 +2340,7 @@ static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw)
 	}
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_busy_wait();
 
 	/* Check for error */
 	if(ip_ecc_check_error(NULL)){
@@ -1950,12 +2359,12 @@ static inline int ip_ecc_push_word(const ip_ecc_word *w)
 		goto err;
 	}
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_busy_wait();
 
 	IPECC_WRITE_DATA((*w));
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_busy_wait();
 
 	/* Check for error */
 	if(ip_ecc_check_error(NULL)){
@@ -2213,7 +2622,7 @@ err:
 static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_register reg)
 {
 	uint32_t nn_size, curr_word_sz, words_sent, bytes_idx, j;
-	uint8_t end;
+	uint8_t end, axis;
 
 	ip_ecc_word w;
 
@@ -2246,8 +2655,11 @@ static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_re
 		IPECC_ENOUGH_WK_RANDOM_WAIT();
 	}
 
+	/* Use the AXI-Stream port if there is a bridge to feed it with */
+	axis = (ipecc_axis_tx != NULL);
+
 	/* Select the write mode for the current register */
-	if(ip_ecc_select_reg(reg, EC_HW_REG_WRITE)){
+	if(ip_ecc_select_reg(reg, EC_HW_REG_WRITE, axis)){
 		goto err;
 	}
 
@@ -2270,12 +2682,24 @@ static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_re
 			}
 		}
 		/* Push it to the IP */
-		if(ip_ecc_push_word(&w)){
+		if(axis){
+			/* No need to poll R_STATUS between words here, the IP
+			 * back-pressures the bridge with TREADY */
+			ipecc_axis_tx[words_sent] = w;
+		} else if(ip_ecc_push_word(&w)){
 			goto err;
 		}
 		words_sent++;
 	}
 
+	if(axis){
+		/* Wait until the last word is shifted in & check for error */
+		IPECC_BUSY_WAIT();
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+	}
+
 	return 0;
 err:
 	return -1;
@@ -2291,7 +2715,7 @@ err:
 static inline int ip_ecc_read_bignum(uint8_t *a, uint32_t a_sz, ip_ecc_register reg)
 {
 	uint32_t nn_size, curr_word_sz, words_received, bytes_idx, j;
-	uint8_t end;
+	uint8_t end, axis;
 
 	ip_ecc_word w;
 
@@ -2310,8 +2734,11 @@ static inline int ip_ecc_read_bignum(uint8_t *a, uint32_t a_sz, ip_ecc_register
 		goto err;
 	}
 
+	/* Use the AXI-Stream port if there is a bridge to drain it with */
+	axis = (ipecc_axis_rx != NULL);
+
 	/* Select the read mode for the current register */
-	if(ip_ecc_select_reg(reg, EC_HW_REG_READ)){
+	if(ip_ecc_select_reg(reg, EC_HW_REG_READ, axis)){
 		goto err;
 	}
 
@@ -2321,7 +2748,9 @@ static inline int ip_ecc_read_bignum(uint8_t *a, uint32_t a_sz, ip_ecc_register
 	end = ((a_sz >= 1) ? 0 : 1);
 	while(words_received < nn_size){
 		/* Pop the word from the IP */
-		if(ip_ecc_pop_word(&w)){
+		if(axis){
+			w = ipecc_axis_rx[words_received];
+		} else if(ip_ecc_pop_word(&w)){
 			goto err;
 		}
 		if(!end){
@@ -2338,6 +2767,14 @@ static inline int ip_ecc_read_bignum(uint8_t *a, uint32_t a_sz, ip_ecc_register
 		words_received++;
 	}
 
+	if(axis){
+		/* Wait until the IP is back to idle & check for error */
+		IPECC_BUSY_WAIT();
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+	}
+
 	return 0;
 err:
 	return -1;
@@ -2992,9 +3429,72 @@ static inline int ip_ecc_configure_trng(int debias, uint32_t ta, uint32_t cycles
 
 	/* Memory-mapped register access */
 	/*   (TRNG configuration register) */
-	IPECC_TRNG_CONFIG(debias, ta, cycles);
+	IPECC_TRNG_CONFIG(debias, ta, cycles, ipecc_trng_cfg.pseudo);
+
+	/* Register W_DBG_TRNG_CFG is write-only: keep track of it */
+	ipecc_trng_cfg.debias = debias;
+	ipecc_trng_cfg.ta = ta;
+	ipecc_trng_cfg.idle = cycles;
+
+	return 0;
+}
+
+/* Select the raw random source of the TRNG post-processing: either
+ * the entropy source of the IP or the external pseudo TRNG device
+ * (whatever the bytes software pushes into it).
+ *
+ * (should be called only in HW unsecure mode)
+ */
+static inline int ip_ecc_trng_use_pseudo_source(bool pseudo)
+{
+	IPECC_TRNG_CONFIG(ipecc_trng_cfg.debias, ipecc_trng_cfg.ta,
+			ipecc_trng_cfg.idle, pseudo);
+	ipecc_trng_cfg.pseudo = pseudo;
+
+	return 0;
+}
+
+/* Empty the FIFO of the pseudo TRNG device
+ *
+ * (should be called only in HW unsecure mode)
+ */
+static inline int ip_ecc_pseudotrng_reset(void)
+{
+	if (ipecc_pseudotrng_baddr == NULL) {
+		goto err;
+	}
+	IPECC_PSEUDOTRNG_SOFT_RESET();
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Push at most 'sz' bytes into the FIFO of the pseudo TRNG device,
+ * as many as it has room for (the device doesn't check for overflow),
+ * the nb of which is returned in *pushed.
+ *
+ * (should be called only in HW unsecure mode)
+ */
+static inline int ip_ecc_pseudotrng_push(const uint8_t* buf, uint32_t sz, uint32_t* pushed)
+{
+	uint32_t i, room;
+
+	if (ipecc_pseudotrng_baddr == NULL) {
+		goto err;
+	}
+	room = IPECC_PSEUDOTRNG_FIFO_SZ - IPECC_PSEUDOTRNG_GET_FIFO_COUNT();
+	if (sz > room) {
+		sz = room;
+	}
+	for (i = 0; i < sz; i++) {
+		IPECC_PSEUDOTRNG_PUSH_DATA(buf[i]);
+	}
+	*pushed = sz;
 
 	return 0;
+err:
+	return -1;
 }
 
 /* Reset the raw random bits FIFO
@@ -4014,6 +4514,77 @@ int ip_ecc_get_content_of_trng_raw_random_fifo(char* buf, uint32_t* nbbits)
 	return 0;
 }
 
+/* Acquire one window of contiguous raw random bits from the TRNG
+ *
+ *   The FIFO of raw random bits is emptied and the function waits
+ *   until the entropy source has completely filled it up again,
+ *   with the post-processing pull disabled meanwhile: the bits
+ *   read back are thus a contiguous sequence of the raw stream.
+ *
+ *   Bits are packed into 32-bit words (bit i of the window is
+ *   bit (i % 32) of words[i / 32]) hence 'words' must hold at
+ *   least 1/32th of the size of the FIFO as returned by function
+ *   hw_driver_get_more_capabilities_DBG().
+ *
+ *   Upon completion *nbbits is the nb of bits of the window and
+ *   *duration the nb of cycles (of the main clock) the entropy
+ *   source took to produce them (see R_DBG_RAWDUR).
+ *
+ * Each bit costs two register accesses, so the acquisition rate
+ * is bounded by the bus, not by the entropy source.
+ *
+ * (should be called only in HW unsecure mode)
+ */
+static inline int ip_ecc_get_trng_raw_window(uint32_t* words, uint32_t* nbbits,
+		uint32_t* duration)
+{
+	uint32_t i, qty, watchdog = 0;
+	bool timeout = true;
+
+	/* Step 1/6: disable the post-processing pull of raw random bits */
+	IPECC_TRNG_DISABLE_POSTPROC();
+
+	/* Step 2/6: reset the TRNG raw FIFO */
+	IPECC_TRNG_RESET_RAW_FIFO();
+
+	/* Step 3/6: Poll until the IP shows raw FIFO is full */
+	while (watchdog < 0x1000000U) /* quite arbitrary */
+	{
+		if (IPECC_IS_TRNG_RAW_FIFO_FULL()) {
+			timeout = false;
+			break;
+		}
+		watchdog++;
+	}
+	if (timeout) {
+		IPECC_TRNG_ENABLE_POSTPROC();
+		goto err;
+	}
+	*duration = IPECC_GET_TRNG_RAW_FIFO_FILLUP_TIME();
+
+	/* Step 4/6: disable the read port of the FIFO
+	 * (the write pointer has wrapped to 0, the FIFO being full) */
+	IPECC_TRNG_DISABLE_RAW_FIFO_READ_PORT();
+	qty = IPECC_GET_TRNG_RAW_SZ();
+	memset(words, 0, (qty / 32) * sizeof(uint32_t));
+
+	/* Step 5/6: loop on the nb of bits */
+	for (i = 0; i < qty; i++) {
+		IPECC_TRNG_SET_RAW_BIT_ADDR(i);
+		words[i / 32] |= ((uint32_t)(IPECC_TRNG_GET_RAW_BIT() & 0x1)) << (i % 32);
+	}
+	*nbbits = qty;
+
+	/* Step 6/6: enable back the read port & the post-processing */
+	IPECC_TRNG_ENABLE_RAW_FIFO_READ_PORT();
+	IPECC_TRNG_ENABLE_POSTPROC();
+
+	return 0;
+
+err:
+	return -1;
+}
+
 /* To get the diagnostic counters for random source "AXI"
  *
  * (should be called only in HW unsecure mode)
@@ -5214,33 +5785,37 @@ err:
 	return -1;
 }
 
-#if 0
-/* Function to get the random output of the RAW FIFO */
+/* Read 'out_sz' bytes of random from the IP TRNG ('trngexport' = TRUE).
+ *
+ * Words are popped from the FIFO of internal random numbers serving the
+ * on-the-fly masking of the scalar. Only as many words as R_TRNG_STATUS
+ * reports available are read in a row (so that no read of R_TRNG_DATA
+ * ever stalls the bus) and the 'ww'-bit words are packed into bytes,
+ * least significant bits first. Bits of the last word which don't fill
+ * a whole byte are dropped.
+ */
 static inline int ip_ecc_get_random(uint8_t *out, uint32_t out_sz)
 {
-	uint32_t read = 0, addr;
-	uint8_t bit;
+	uint32_t i, avail, ww, rd = 0;
+	uint32_t accbits = 0;
+	uint64_t acc = 0, msk;
 
-	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ww = IPECC_GET_TRNG_WORD_SZ();
+	if ((ww == 0) || (ww > 32)) {
+		log_print("In ip_ecc_get_random(): unexpected word size %d\n\r", ww);
+		goto err;
+	}
+	msk = (((uint64_t)1) << ww) - 1;
 
-	/* Read in a loop the asked size */
-	while(read != (8 * out_sz)){
-		uint32_t i;
-		/* Wait until our FIFO is full */
-		IPECC_TRNG_RAW_FIFO_FULL_BUSY_WAIT();
-		/* Read all our data */
-		addr = 0;
-		for(i = 0; i < IPECC_GET_TRNG_RAW_SZ(); i++){
-			IPECC_TRNG_READ_FIFO_RAW(addr, &bit);
-			if((read % 8) == 0){
-				out[(read / 8)] = 0;
-			}
-			out[(read / 8)] |= (bit << (read % 8));
-			addr++;
-			read++;
-			if(read == (8 * out_sz)){
-				break;
+	while (rd < out_sz) {
+		avail = IPECC_GET_TRNG_WORDS_AVAIL();
+		for (i = 0; (i < avail) && (rd < out_sz); i++) {
+			acc |= (((uint64_t)IPECC_READ_TRNG_WORD()) & msk) << accbits;
+			accbits += ww;
+			while ((accbits >= 8) && (rd < out_sz)) {
+				out[rd++] = (uint8_t)acc;
+				acc >>= 8;
+				accbits -= 8;
 			}
 		}
 	}
@@ -5249,140 +5824,201 @@ static inline int ip_ecc_get_random(uint8_t *out, uint32_t out_sz)
 err:
 	return -1;
 }
-#endif
 
-static volatile uint8_t hw_driver_setup_state = 0;
+/*
+ * Hardware command queue (only if the IP was synthesized with 'cmdqsize' > 0)
+ *
+ * Entries are pushed through registers W_CMDQ_OP (sticky op: kind of the
+ * entry & index of its target register) and W_CMDQ_PUSH (data of the entry).
+ * To spare AXI transfers, W_CMDQ_OP is only rewritten when the op changes,
+ * and the nb of free entries in the queue is only polled back from the IP
+ * once the local credit is exhausted.
+ *
+ * The driver also keeps count of the words that the entries it enqueued
+ * will push into the result FIFO and have not been popped yet: entries are
+ * not enqueued if their results could not fit in it (the dispatcher would
+ * then stall until software pops results, which it may never do if it is
+ * itself waiting for room in the queue).
+ */
+static uint32_t ip_ecc_cmdq_op = 0xffffffff; /* op currently set in W_CMDQ_OP */
+static uint32_t ip_ecc_cmdq_credit = 0; /* free entries known to be in the queue */
+static uint32_t ip_ecc_cmdq_size = 0; /* depth of queue & result FIFO (0 = unknown) */
+static uint32_t ip_ecc_cmdq_res_pending = 0; /* result words enqueued but not popped */
 
-static inline int driver_setup(void)
+/* Forget local state about the command queue (after a flush or a reset) */
+static inline void ip_ecc_cmdq_forget(void)
 {
-	bool hw_unsecure;
+	ip_ecc_cmdq_op = 0xffffffff;
+	ip_ecc_cmdq_credit = 0;
+	ip_ecc_cmdq_size = 0;
+	ip_ecc_cmdq_res_pending = 0;
+}
 
-	if(!hw_driver_setup_state){
-		/* Ask the lower layer for a setup */
-		if(hw_driver_setup((volatile uint8_t**)&ipecc_baddr, NULL /*(volatile uint8_t**)&ipecc_pseudotrng_baddr)*/)) {
+/* Get the depth of the command queue & of the result FIFO ('cmdqsize'),
+ * which is the nb of free entries when the queue is empty & idle (hence
+ * it can only be learnt at that time, e.g after hw_driver_cmdq_flush()).
+ */
+static inline int ip_ecc_cmdq_get_size(uint32_t *size)
+{
+	if(ip_ecc_cmdq_size == 0){
+		if(IPECC_IS_CMDQ_ACTIVE() || (IPECC_CMDQ_GET_RES_COUNT() != 0)){
+			log_print("Size of command queue unknown while it is active "
+					"(flush it first)\n\r");
 			goto err;
 		}
-		/* Reset the IP for a clean state */
-		IPECC_SOFT_RESET();
-
-		/* Enable TRNG post-processing
-		 *
-		 * This is for the case where the IP is in HW unsecure mode (not to be done otherwise
-		 * as an error UNKNOWN_REG would be issued).
-		 *
-		 * NOTE:
-		 *   We can make this call even before setting 'hw_driver_setup_state' to 1
-		 *   below, because neither ip_ecc_is_hw_unsecure() nor ip_ecc_trng_postproc_enable()
-		 *   call driver_setup()
-		 *   (so no risk of recursive deadlock).
-		 */
-		ip_ecc_is_hw_unsecure(&hw_unsecure);
-		if (hw_unsecure) {
-			ip_ecc_trng_postproc_enable();
-		}
-
-#if 0
-		/* Reset the pseudo TRNG device to empty its FIFO of pseudo raw random bytes */
-		IPECC_PSEUDOTRNG_SOFT_RESET();
-#endif
-
-		/* We are in the initialized state */
-		hw_driver_setup_state = 1;
+		ip_ecc_cmdq_size = IPECC_CMDQ_GET_FREE();
+		ip_ecc_cmdq_credit = ip_ecc_cmdq_size;
 	}
+	(*size) = ip_ecc_cmdq_size;
 
 	return 0;
 err:
 	return -1;
 }
 
-/*********************************************
- **  Driver API (top-layer exported functions)
- *********************************************/
-
-/* Reset the hardware */
-int hw_driver_reset(void)
+/* Push one entry into the command queue.
+ *
+ * Note that if the queue is full, this function polls until the dispatcher
+ * frees one entry, hence the dispatcher must be enabled for this function
+ * to return (it gives up after some time otherwise).
+ */
+static inline int ip_ecc_cmdq_push(uint32_t kind, uint32_t idx, ip_ecc_word data)
 {
-	/* Reset the IP for a clean state */
-	IPECC_SOFT_RESET();
+	uint32_t op;
+	uint32_t watchdog = 0;
 
-	return 0;
-}
+	op = ((kind & IPECC_W_CMDQ_OP_KIND_MSK) << IPECC_W_CMDQ_OP_KIND_POS)
+		| ((idx & IPECC_W_CMDQ_OP_REG_MSK) << IPECC_W_CMDQ_OP_REG_POS);
 
-/* To know if the IP is in 'HW secure' or 'HW unsecure' mode */
-int hw_driver_is_hw_unsecure(bool* hw_unsecure)
-{
-	if(driver_setup()){
-		goto err;
-	}
-	if (ip_ecc_is_hw_unsecure(hw_unsecure)){
-		goto err;
-	}
-	return 0;
-err:
-	return -1;
-}
-int hw_driver_is_hw_secure(bool* hw_secure)
-{
-	if(driver_setup()){
-		goto err;
+	/* Wait until there is room in the queue */
+	while(ip_ecc_cmdq_credit == 0){
+		if(watchdog >= 0x1000000U){ /* quite arbitrary */
+			log_print("Timeout while waiting for room in the command queue "
+					"(is it enabled?)\n\r");
+			goto err;
+		}
+		ip_ecc_cmdq_credit = IPECC_CMDQ_GET_FREE();
+		watchdog++;
 	}
-	if (ip_ecc_is_hw_secure(hw_secure)){
-		goto err;
+
+	if(op != ip_ecc_cmdq_op){
+		IPECC_CMDQ_SET_OP(kind, idx);
+		ip_ecc_cmdq_op = op;
 	}
+	IPECC_CMDQ_PUSH(data);
+	ip_ecc_cmdq_credit--;
+
 	return 0;
 err:
 	return -1;
 }
 
-/* To get hardware capabilities from the IP
+/* Enqueue the write of a big number (same word formatting as in
+ * ip_ecc_write_bignum()).
  */
-int hw_driver_get_capabilities(bool* hwsecure, bool* shuffle, bool* nndyn, bool* axi64, uint32_t* nnmax)
+static inline int ip_ecc_cmdq_push_write_bignum(const uint8_t *a, uint32_t a_sz,
+		uint32_t addr, uint32_t scal, uint32_t nn_size)
 {
-	if(driver_setup()){
+	uint32_t words_sent, bytes_idx, j;
+	uint8_t end;
+	ip_ecc_word w;
+
+	if(ip_ecc_nn_words_from_bytes_sz(a_sz) > nn_size){
+		/* We overflow, this is an error! */
 		goto err;
 	}
-	if (ip_ecc_get_capabilities(hwsecure, shuffle, nndyn, axi64, nnmax)){
+
+	/* Select the write mode for the big number */
+	w = IPECC_W_CTRL_WRITE_NB;
+	w |= ((scal) ? IPECC_W_CTRL_WRITE_K : 0);
+	w |= ((addr & IPECC_W_CTRL_NBADDR_MSK) << IPECC_W_CTRL_NBADDR_POS);
+	if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_WRITE, IPECC_CMDQ_REG_IDX(IPECC_W_CTRL), w)){
 		goto err;
 	}
+
+	/* Send our words beginning with the last */
+	words_sent = 0;
+	bytes_idx = ((a_sz >= 1) ? (a_sz - 1) : 0);
+	end = ((a_sz >= 1) ? 0 : 1);
+	while(words_sent < nn_size){
+		w = 0;
+		if(!end){
+			for(j = 0; j < sizeof(w); j++){
+				w |= (ip_ecc_word)(a[bytes_idx] << (8 * j));
+				if(bytes_idx == 0){
+					end = 1;
+					break;
+				}
+				bytes_idx--;
+			}
+		}
+		if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_WRITE,
+					IPECC_CMDQ_REG_IDX(IPECC_W_WRITE_DATA), w)){
+			goto err;
+		}
+		words_sent++;
+	}
+
 	return 0;
 err:
 	return -1;
 }
 
-	/* Get major version of the IP */
-int hw_driver_get_version_tags(uint32_t* maj, uint32_t* min, uint32_t* patch)
+/* Enqueue the read of a big number (its words will be pushed by the IP
+ * into the result FIFO).
+ */
+static inline int ip_ecc_cmdq_push_read_bignum(uint32_t addr, uint32_t token,
+		uint32_t nn_size)
 {
-	if(driver_setup()){
+	ip_ecc_word w;
+
+	w = IPECC_W_CTRL_READ_NB;
+	w |= ((token) ? IPECC_W_CTRL_RD_TOKEN : 0);
+	w |= ((addr & IPECC_W_CTRL_NBADDR_MSK) << IPECC_W_CTRL_NBADDR_POS);
+	if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_WRITE, IPECC_CMDQ_REG_IDX(IPECC_W_CTRL), w)){
 		goto err;
 	}
-	if (ip_ecc_get_version_tags(maj, min, patch)){
+	/* Reg field is indifferent for a read entry (always R_READ_DATA) */
+	if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_READ, 0, nn_size)){
 		goto err;
 	}
+
 	return 0;
 err:
 	return -1;
 }
 
-/* To halt the IP - This freezes execution of microcode
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+/* Pop a big number from the result FIFO (same word formatting as in
+ * ip_ecc_read_bignum()). Caller must have checked that at least 'nn_size'
+ * words are available.
  */
-int hw_driver_halt_DBG(void)
+static inline int ip_ecc_cmdq_pop_bignum(uint8_t *a, uint32_t a_sz, uint32_t nn_size)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	uint32_t words_received, bytes_idx, j;
+	uint8_t end;
+	ip_ecc_word w;
 
-	/* Test HW unsecure capabilities */
-	if (IPECC_IS_HW_SECURE())
-	{
+	if(ip_ecc_nn_words_from_bytes_sz(a_sz) > nn_size){
+		/* We overflow, this is an error! */
 		goto err;
 	}
 
-	/* call to low-level routine */
-	if (ip_ecc_debug_halt()){
-		goto err;
+	words_received = 0;
+	bytes_idx = ((a_sz >= 1) ? (a_sz - 1) : 0);
+	end = ((a_sz >= 1) ? 0 : 1);
+	while(words_received < nn_size){
+		w = IPECC_CMDQ_POP_RESULT();
+		if(!end){
+			for(j = 0; j < sizeof(w); j++){
+				a[bytes_idx] = (w >> (8 * j)) & 0xff;
+				if(bytes_idx == 0){
+					end = 1;
+					break;
+				}
+				bytes_idx--;
+			}
+		}
+		words_received++;
 	}
 
 	return 0;
@@ -5390,30 +6026,81 @@ err:
 	return -1;
 }
 
-/* To set and activate a new breakpoint
+/*
+ * DMA engine (only if the IP was instanciated through top-level 'ecc_dma')
  *
- *   Note: the breakpoint is enabled for whatever the state
- *         the IP FSM is in when the microcode hits the address.
- *         Please c.f comment help of ip_ecc_set_breakpoint().
+ * The DMA-able buffer given by the platform layer is split into the ring
+ * of 2**ip_ecc_dma_lg job descriptors, followed by one data area per slot
+ * of the ring, made of (in words):
  *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+ *   K (nn_size) | P0 = x, y (2.nn_size) | RES = x, y, token, status, tag (3.nn_size + 2)
+ *
+ * Slots are given back to software in order (ip_ecc_dma_pop), hence a slot
+ * is never reused before its result has been retrieved.
  */
-int hw_driver_set_breakpoint_DBG(uint32_t addr, uint32_t id)
+static ip_ecc_word *ip_ecc_dma_buf = NULL; /* virtual address of the buffer */
+static uint64_t ip_ecc_dma_phys = 0; /* bus address of the buffer */
+static uint32_t ip_ecc_dma_sz = 0; /* size of the buffer, in bytes */
+static uint32_t ip_ecc_dma_lg = 0; /* ring of 2**ip_ecc_dma_lg descriptors */
+static uint32_t ip_ecc_dma_nn_sz = 0; /* nb of bytes of big numbers */
+static uint32_t ip_ecc_dma_nn_size = 0; /* nb of words of big numbers */
+static uint32_t ip_ecc_dma_tail = 0; /* producer index */
+static uint32_t ip_ecc_dma_pop = 0; /* oldest job whose result was not retrieved yet */
+
+#define IPECC_DMA_RING_MASK()   ((((uint32_t)1) << ip_ecc_dma_lg) - 1)
+#define IPECC_DMA_SLOT_WORDS()   ((6 * ip_ecc_dma_nn_size) + 2)
+
+/* Offset (in words from the start of the buffer) of descriptor 'i' */
+static inline uint32_t ip_ecc_dma_desc_off(uint32_t i)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	return i * IPECC_DMA_DESC_WORDS;
+}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+/* Offset (in words from the start of the buffer) of the data area of slot 'i' */
+static inline uint32_t ip_ecc_dma_data_off(uint32_t i)
+{
+	return (IPECC_DMA_DESC_WORDS << ip_ecc_dma_lg) + (i * IPECC_DMA_SLOT_WORDS());
+}
+
+/* Bus address (as seen by the DMA engine) of word 'off' of the buffer */
+static inline uint64_t ip_ecc_dma_bus_addr(uint32_t off)
+{
+	return ip_ecc_dma_phys + (off * sizeof(ip_ecc_word));
+}
+
+/* Copy a big number into the buffer (same word formatting as in
+ * ip_ecc_write_bignum(), words being stored the way they would be
+ * written into W_WRITE_DATA).
+ */
+static inline int ip_ecc_dma_put_bignum(uint32_t off, const uint8_t *a, uint32_t a_sz,
+		uint32_t nn_size)
+{
+	uint32_t words_sent, bytes_idx, j;
+	uint8_t end;
+	ip_ecc_word w;
+
+	if(ip_ecc_nn_words_from_bytes_sz(a_sz) > nn_size){
+		/* We overflow, this is an error! */
 		goto err;
 	}
 
-	/* call to low-level routine */
-	if (ip_ecc_set_breakpoint(addr, id)){
-		goto err;
+	words_sent = 0;
+	bytes_idx = ((a_sz >= 1) ? (a_sz - 1) : 0);
+	end = ((a == NULL) || (a_sz == 0));
+	while(words_sent < nn_size){
+		w = 0;
+		if(!end){
+			for(j = 0; j < sizeof(w); j++){
+				w |= (ip_ecc_word)(a[bytes_idx] << (8 * j));
+				if(bytes_idx == 0){
+					end = 1;
+					break;
+				}
+				bytes_idx--;
+			}
+		}
+		IPECC_SET_REG(&ip_ecc_dma_buf[off + words_sent], w);
+		words_sent++;
 	}
 
 	return 0;
@@ -5421,26 +6108,37 @@ err:
 	return -1;
 }
 
-/* To remove/disable a breakpoint
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+/* Copy a big number out of the buffer (same word formatting as in
+ * ip_ecc_read_bignum()).
  */
-int hw_driver_remove_breakpoint_DBG(uint32_t id)
+static inline int ip_ecc_dma_get_bignum(uint8_t *a, uint32_t a_sz, uint32_t off,
+		uint32_t nn_size)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	uint32_t words_received, bytes_idx, j;
+	uint8_t end;
+	ip_ecc_word w;
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	if(ip_ecc_nn_words_from_bytes_sz(a_sz) > nn_size){
+		/* We overflow, this is an error! */
 		goto err;
 	}
 
-	/* call to low-level routine */
-	if (ip_ecc_remove_breakpoint(id)){
-		goto err;
+	words_received = 0;
+	bytes_idx = ((a_sz >= 1) ? (a_sz - 1) : 0);
+	end = ((a_sz >= 1) ? 0 : 1);
+	while(words_received < nn_size){
+		w = IPECC_GET_REG(&ip_ecc_dma_buf[off + words_received]);
+		if(!end){
+			for(j = 0; j < sizeof(w); j++){
+				a[bytes_idx] = (w >> (8 * j)) & 0xff;
+				if(bytes_idx == 0){
+					end = 1;
+					break;
+				}
+				bytes_idx--;
+			}
+		}
+		words_received++;
 	}
 
 	return 0;
@@ -5448,140 +6146,489 @@ err:
 	return -1;
 }
 
-/* Have IP to execute a certain nb of opcodes in microcode
+/*
+ * Curve context slots (only if the IP was synthesized with 'nbctx' > 0)
  *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+ * Each hardware slot keeps a whole curve (p, a, b, q & the Montgomery
+ * constants derived from p). The driver keeps here a copy of the parameters
+ * each slot was bound with so that hw_driver_set_curve() can switch back to
+ * an already known curve with a single write of W_CURVE_SELECT instead of
+ * uploading the four numbers again (which triggers the computation of the
+ * Montgomery constants). Slots are replaced in LRU order.
+ *
+ * Parameters larger than IPECC_CTX_NB_MAX_SZ bytes are not cached (the curve
+ * is then simply uploaded without any slot being bound).
  */
-int hw_driver_run_opcodes_DBG(uint32_t nbops)
+#define IPECC_CTX_SLOTS_MAX   (16)
+#define IPECC_CTX_NB_MAX_SZ   (80)
+
+typedef struct {
+	uint32_t nn; /* 0 means slot is empty (or its content unknown) */
+	uint32_t stamp; /* date of last use */
+	uint32_t sz[4]; /* p, a, b, q */
+	uint8_t nb[4][IPECC_CTX_NB_MAX_SZ];
+} ip_ecc_ctx_slot;
+
+static ip_ecc_ctx_slot ip_ecc_ctx[IPECC_CTX_SLOTS_MAX];
+static uint32_t ip_ecc_ctx_date = 0;
+
+static inline void ip_ecc_ctx_forget_all(void)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	uint32_t i;
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
+	for(i = 0; i < IPECC_CTX_SLOTS_MAX; i++){
+		ip_ecc_ctx[i].nn = 0;
 	}
+	ip_ecc_ctx_date = 0;
+}
 
-	/* call to low-level routine */
-	if (ip_ecc_run_opcodes(nbops)) {
-		goto err;
-	}
+/* Does slot 'i' hold exactly the parameters in 'nb' & 'sz'? */
+static inline bool ip_ecc_ctx_match(uint32_t i, uint32_t nn, const uint8_t *nb[4],
+		const uint32_t sz[4])
+{
+	uint32_t j;
 
-	/* Note: it is the caller's responsability to further test that the IP
-	 * is again halted, hence meaning that the 'nbops' opcodes have been
-	 * run - use API function hw_driver_is_debug_halted_DBG()
-	 */
+	if(ip_ecc_ctx[i].nn != nn){
+		return false;
+	}
+	for(j = 0; j < 4; j++){
+		if(ip_ecc_ctx[i].sz[j] != sz[j]){
+			return false;
+		}
+		if(sz[j] && memcmp(ip_ecc_ctx[i].nb[j], nb[j], sz[j])){
+			return false;
+		}
+	}
 
-	return 0;
-err:
-	return -1;
+	return true;
 }
 
-/* Same as hw_driver_run_opcodes_DBG() but single step
- */
-int hw_driver_single_step_DBG()
+/*
+ * Solinas (fast) reduction mode
+ *
+ * If the IP advertises it (CAP_FASTRED), the multiplications modulo the
+ * NIST primes p256 & p384 can be reduced by a fold of the product words
+ * instead of the generic Montgomery reduction. The driver recognizes the
+ * two primes (big-endian, possibly with leading zero bytes) on its own.
+ */
+static const uint8_t ip_ecc_p256[32] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static const uint8_t ip_ecc_p384[48] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff
+};
+
+static inline uint32_t ip_ecc_fastred_mode(const uint8_t *p, uint32_t p_sz)
 {
-	if(driver_setup()){
-		goto err;
+	if(p == NULL){
+		return IPECC_FASTRED_NONE;
 	}
-
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
+	while((p_sz > 0) && (*p == 0)){
+		p++;
+		p_sz--;
+	}
+	if((p_sz == sizeof(ip_ecc_p256)) && !memcmp(p, ip_ecc_p256, p_sz)){
+		return IPECC_FASTRED_P256;
 	}
+	if((p_sz == sizeof(ip_ecc_p384)) && !memcmp(p, ip_ecc_p384, p_sz)){
+		return IPECC_FASTRED_P384;
+	}
+	return IPECC_FASTRED_NONE;
+}
 
-	/* call to low-level routine */
-	if (ip_ecc_single_step()) {
-		goto err;
+/*
+ * Montgomery constants computed by software
+ *
+ * If the IP advertises it (CAP_HOSTMTY), the constants associated with p,
+ * that is R^2 mod p, 2p, R mod p & p' = -p^-1 mod R (with R = 2^(nn + 2)),
+ * can be written by software instead of being computed by the IP (routine
+ * .constMTYL, which involves two modular inversions). They only depend on
+ * p, nn & ww: we compute them with plain shift & add arithmetic on 32-bit
+ * words and keep those of the last curves in a small cache keyed by
+ * (p, nn, ww).
+ */
+#define IPECC_MTYCST_CACHE_SZ   (4)
+/* Nb of 32-bit words to hold a number of nn + 4 bits */
+#define IPECC_MTYCST_WORDS_MAX   (((8 * IPECC_CTX_NB_MAX_SZ) + 4 + 31) / 32)
+
+typedef struct {
+	uint32_t nn; /* 0 means entry is empty */
+	uint32_t ww;
+	uint32_t stamp; /* date of last use */
+	uint32_t p_sz;
+	uint8_t p[IPECC_CTX_NB_MAX_SZ];
+	/* in the order of IPECC_MTYCST_* values, least significant word first */
+	uint32_t cst[4][IPECC_MTYCST_WORDS_MAX];
+} ip_ecc_mtycst_entry;
+
+static ip_ecc_mtycst_entry ip_ecc_mtycst[IPECC_MTYCST_CACHE_SZ];
+static uint32_t ip_ecc_mtycst_date = 0;
+
+static inline uint32_t ip_ecc_mp_cmp(const uint32_t *x, const uint32_t *y, uint32_t l)
+{
+	while(l--){
+		if(x[l] != y[l]){
+			return (x[l] > y[l]) ? 1 : 0;
+		}
 	}
+	return 1; /* x == y */
+}
 
-	/* Note: it is the caller's responsability to further test that the IP
-	 * is again halted, hence meaning that the one opcode have been
-	 * run - use API function hw_driver_is_debug_halted_DBG()
-	 */
+/* x <- x - y (assuming x >= y) */
+static inline void ip_ecc_mp_sub(uint32_t *x, const uint32_t *y, uint32_t l)
+{
+	uint32_t i, b = 0;
+	uint64_t d;
 
-	return 0;
-err:
-	return -1;
+	for(i = 0; i < l; i++){
+		d = (uint64_t)x[i] - y[i] - b;
+		x[i] = (uint32_t)d;
+		b = (uint32_t)(d >> 63);
+	}
 }
 
-/* Resume execution of microcode
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
- */
-int hw_driver_resume_DBG()
+/* x <- x + y */
+static inline void ip_ecc_mp_add(uint32_t *x, const uint32_t *y, uint32_t l)
 {
-	if(driver_setup()){
-		goto err;
+	uint32_t i;
+	uint64_t s = 0;
+
+	for(i = 0; i < l; i++){
+		s += (uint64_t)x[i] + y[i];
+		x[i] = (uint32_t)s;
+		s >>= 32;
 	}
+}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
+/* x <- 2x */
+static inline void ip_ecc_mp_dbl(uint32_t *x, uint32_t l)
+{
+	uint32_t i;
+
+	for(i = l - 1; i > 0; i--){
+		x[i] = (x[i] << 1) | (x[i - 1] >> 31);
 	}
+	x[0] <<= 1;
+}
 
-	/* call to low-level routine */
-	if (ip_ecc_resume()){
+/* x <- x mod 2^k */
+static inline void ip_ecc_mp_trunc(uint32_t *x, uint32_t l, uint32_t k)
+{
+	uint32_t i;
+
+	for(i = 0; i < l; i++){
+		if((32 * i) >= k){
+			x[i] = 0;
+		} else if((32 * (i + 1)) > k){
+			x[i] &= (((uint32_t)1) << (k % 32)) - 1;
+		}
+	}
+}
+
+/* Compute the 4 constants of entry 'e' (the fields of which other than
+ * 'cst' must already be set) */
+static inline int ip_ecc_mtycst_compute(ip_ecc_mtycst_entry *e)
+{
+	uint32_t p[IPECC_MTYCST_WORDS_MAX], t[IPECC_MTYCST_WORDS_MAX];
+	uint32_t *y;
+	uint32_t i, k, l;
+
+	k = e->nn + 2;
+	l = (e->nn + 4 + 31) / 32;
+	memset(p, 0, sizeof(p));
+	for(i = 0; i < e->p_sz; i++){
+		p[i / 4] |= ((uint32_t)e->p[e->p_sz - 1 - i]) << (8 * (i % 4));
+	}
+	/* p must be odd for p' to exist */
+	if(!(p[0] & 1)){
 		goto err;
 	}
+	memset(e->cst, 0, sizeof(e->cst));
+	/* 2p */
+	memcpy(e->cst[IPECC_MTYCST_TWOP], p, sizeof(p));
+	ip_ecc_mp_dbl(e->cst[IPECC_MTYCST_TWOP], l);
+	/* R mod p & R^2 mod p, by doubling 1 modulo p k times & 2k times */
+	e->cst[IPECC_MTYCST_RMODP][0] = 1;
+	for(i = 0; i < (2 * k); i++){
+		ip_ecc_mp_dbl(e->cst[IPECC_MTYCST_RMODP], l);
+		if(ip_ecc_mp_cmp(e->cst[IPECC_MTYCST_RMODP], p, l)){
+			ip_ecc_mp_sub(e->cst[IPECC_MTYCST_RMODP], p, l);
+		}
+		if(i == (k - 1)){
+			memcpy(e->cst[IPECC_MTYCST_R2MODP], e->cst[IPECC_MTYCST_RMODP],
+					sizeof(e->cst[0]));
+		}
+	}
+	/* Swap the two of them (the loop above ends with R^2 mod p) */
+	memcpy(t, e->cst[IPECC_MTYCST_RMODP], sizeof(t));
+	memcpy(e->cst[IPECC_MTYCST_RMODP], e->cst[IPECC_MTYCST_R2MODP], sizeof(t));
+	memcpy(e->cst[IPECC_MTYCST_R2MODP], t, sizeof(t));
+	/* p^-1 mod R, one bit at a time: y is the inverse modulo 2^(i + 1)
+	 * of p and t = p * y mod R (only bits above i may be set, but
+	 * bit 0) */
+	y = e->cst[IPECC_MTYCST_PPRIME];
+	y[0] = 1;
+	memcpy(t, p, sizeof(t));
+	for(i = 1; i < k; i++){
+		ip_ecc_mp_dbl(p, l);
+		ip_ecc_mp_trunc(p, l, k);
+		if((t[i / 32] >> (i % 32)) & 1){
+			y[i / 32] |= ((uint32_t)1) << (i % 32);
+			ip_ecc_mp_add(t, p, l);
+			ip_ecc_mp_trunc(t, l, k);
+		}
+	}
+	/* p' = -y mod R */
+	for(i = 0; i < l; i++){
+		y[i] = ~y[i];
+	}
+	memset(t, 0, sizeof(t));
+	t[0] = 1;
+	ip_ecc_mp_add(y, t, l);
+	ip_ecc_mp_trunc(y, l, k);
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Arm trigger function
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+/* Limb 'i' (of 'ww' bits, 'ww' <= 32) of number 'x' */
+static inline uint32_t ip_ecc_mtycst_limb(const uint32_t *x, uint32_t i, uint32_t ww)
+{
+	uint32_t pos = i * ww;
+	uint64_t v = 0;
+
+	if((pos / 32) < IPECC_MTYCST_WORDS_MAX){
+		v = x[pos / 32];
+	}
+	if(((pos / 32) + 1) < IPECC_MTYCST_WORDS_MAX){
+		v |= ((uint64_t)x[(pos / 32) + 1]) << 32;
+	}
+	v >>= (pos % 32);
+
+	return (uint32_t)(v & ((((uint64_t)1) << ww) - 1));
+}
+
+/* Write the Montgomery constants associated with 'p' into the IP, so
+ * that the write of p which follows does not trigger their computation.
+ * Nothing is done (and the IP computes them) if the IP does not support
+ * it or if 'p' does not fit in the cache.
  */
-int hw_driver_arm_trigger_DBG()
+static inline int ip_ecc_write_mtycst(const uint8_t *p, uint32_t p_sz)
+{
+	ip_ecc_mtycst_entry *e;
+	uint32_t nn, ww, w, i, j;
+
+	if(!IPECC_IS_HOSTMTY_SUPPORTED() || (p == NULL)){
+		return 0;
+	}
+	while((p_sz > 0) && (*p == 0)){
+		p++;
+		p_sz--;
+	}
+	nn = ip_ecc_get_nn_bit_size();
+	ww = IPECC_GET_MTYCST_WW();
+	if((p_sz == 0) || (p_sz > IPECC_CTX_NB_MAX_SZ) || ((8 * p_sz) > nn)
+			|| (ww == 0) || (ww > 32)){
+		return 0;
+	}
+	/* Look for the constants in the cache, otherwise compute them into
+	 * an empty entry or into the least recently used one */
+	e = NULL;
+	for(i = 0; i < IPECC_MTYCST_CACHE_SZ; i++){
+		if((ip_ecc_mtycst[i].nn == nn) && (ip_ecc_mtycst[i].ww == ww)
+				&& (ip_ecc_mtycst[i].p_sz == p_sz)
+				&& !memcmp(ip_ecc_mtycst[i].p, p, p_sz)){
+			e = &ip_ecc_mtycst[i];
+			break;
+		}
+	}
+	if(e == NULL){
+		e = &ip_ecc_mtycst[0];
+		for(i = 0; i < IPECC_MTYCST_CACHE_SZ; i++){
+			if(ip_ecc_mtycst[i].nn == 0){
+				e = &ip_ecc_mtycst[i];
+				break;
+			}
+			if(ip_ecc_mtycst[i].stamp < e->stamp){
+				e = &ip_ecc_mtycst[i];
+			}
+		}
+		e->nn = nn;
+		e->ww = ww;
+		e->p_sz = p_sz;
+		memcpy(e->p, p, p_sz);
+		if(ip_ecc_mtycst_compute(e)){
+			/* Let the IP compute them */
+			e->nn = 0;
+			return 0;
+		}
+	}
+	e->stamp = ++ip_ecc_mtycst_date;
+
+	/* Write them, w limbs each, lower ones first */
+	w = DIV(nn + 4, ww);
+	for(j = 0; j < 4; j++){
+		IPECC_BUSY_WAIT();
+		IPECC_SET_MTYCST(j);
+		for(i = 0; i < w; i++){
+			IPECC_WRITE_MTYCST_LIMB(ip_ecc_mtycst_limb(e->cst[j], i, ww));
+		}
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+static volatile uint8_t hw_driver_setup_state = 0;
+
+static inline int driver_setup(void)
+{
+	bool hw_unsecure;
+
+	if(!hw_driver_setup_state){
+		/* Ask the lower layer for a setup */
+		if(hw_driver_setup((volatile uint8_t**)&ipecc_baddr, NULL /*(volatile uint8_t**)&ipecc_pseudotrng_baddr)*/)) {
+			goto err;
+		}
+		/* Reset the IP for a clean state */
+		IPECC_SOFT_RESET();
+
+		/* Whatever the curve context slots may still hold from a previous
+		 * session, we don't know it (they will simply be bound anew).
+		 */
+		ip_ecc_ctx_forget_all();
+
+		/* Enable TRNG post-processing
+		 *
+		 * This is for the case where the IP is in HW unsecure mode (not to be done otherwise
+		 * as an error UNKNOWN_REG would be issued).
+		 *
+		 * NOTE:
+		 *   We can make this call even before setting 'hw_driver_setup_state' to 1
+		 *   below, because neither ip_ecc_is_hw_unsecure() nor ip_ecc_trng_postproc_enable()
+		 *   call driver_setup()
+		 *   (so no risk of recursive deadlock).
+		 */
+		ip_ecc_is_hw_unsecure(&hw_unsecure);
+		if (hw_unsecure) {
+			ip_ecc_trng_postproc_enable();
+		}
+
+#if 0
+		/* Reset the pseudo TRNG device to empty its FIFO of pseudo raw random bytes */
+		IPECC_PSEUDOTRNG_SOFT_RESET();
+#endif
+
+		/* We are in the initialized state */
+		hw_driver_setup_state = 1;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/*********************************************
+ **  Driver API (top-layer exported functions)
+ *********************************************/
+
+/* Reset the hardware */
+int hw_driver_reset(void)
+{
+	/* Reset the IP for a clean state */
+	IPECC_SOFT_RESET();
+
+	return 0;
+}
+
+/* To know if the IP is in 'HW secure' or 'HW unsecure' mode */
+int hw_driver_is_hw_unsecure(bool* hw_unsecure)
 {
 	if(driver_setup()){
 		goto err;
 	}
-
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	if (ip_ecc_is_hw_unsecure(hw_unsecure)){
+		goto err;
+	}
+	return 0;
+err:
+	return -1;
+}
+int hw_driver_is_hw_secure(bool* hw_secure)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	if (ip_ecc_is_hw_secure(hw_secure)){
 		goto err;
 	}
+	return 0;
+err:
+	return -1;
+}
 
-	/* call to low-level routine */
-	if (ip_ecc_arm_trigger()){
+/* To get hardware capabilities from the IP
+ */
+int hw_driver_get_capabilities(bool* hwsecure, bool* shuffle, bool* nndyn, bool* axi64, uint32_t* nnmax)
+{
+	if(driver_setup()){
 		goto err;
 	}
+	if (ip_ecc_get_capabilities(hwsecure, shuffle, nndyn, axi64, nnmax)){
+		goto err;
+	}
+	return 0;
+err:
+	return -1;
+}
 
+	/* Get major version of the IP */
+int hw_driver_get_version_tags(uint32_t* maj, uint32_t* min, uint32_t* patch)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	if (ip_ecc_get_version_tags(maj, min, patch)){
+		goto err;
+	}
 	return 0;
 err:
 	return -1;
 }
 
-/* Disarm/disable trigger function
+/* To halt the IP - This freezes execution of microcode
  *
  * (only allowed in HW unsecure mode, otherwise an error
  * is returned, with no action taken).
  */
-int hw_driver_disarm_trigger_DBG()
+int hw_driver_halt_DBG(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
+	/* Test HW unsecure capabilities */
 	if (IPECC_IS_HW_SECURE())
 	{
 		goto err;
 	}
 
 	/* call to low-level routine */
-	if (ip_ecc_disarm_trigger()){
+	if (ip_ecc_debug_halt()){
 		goto err;
 	}
 
@@ -5590,12 +6637,16 @@ err:
 	return -1;
 }
 
-/* Set configuration of UP trigger detection
+/* To set and activate a new breakpoint
+ *
+ *   Note: the breakpoint is enabled for whatever the state
+ *         the IP FSM is in when the microcode hits the address.
+ *         Please c.f comment help of ip_ecc_set_breakpoint().
  *
  * (only allowed in HW unsecure mode, otherwise an error
  * is returned, with no action taken).
  */
-int hw_driver_set_trigger_up_DBG(uint32_t time)
+int hw_driver_set_breakpoint_DBG(uint32_t addr, uint32_t id)
 {
 	if(driver_setup()){
 		goto err;
@@ -5608,7 +6659,7 @@ int hw_driver_set_trigger_up_DBG(uint32_t time)
 	}
 
 	/* call to low-level routine */
-	if (ip_ecc_set_trigger_up(time)){
+	if (ip_ecc_set_breakpoint(addr, id)){
 		goto err;
 	}
 
@@ -5617,12 +6668,12 @@ err:
 	return -1;
 }
 
-/* Set configuration of DOWN trigger detection
+/* To remove/disable a breakpoint
  *
  * (only allowed in HW unsecure mode, otherwise an error
  * is returned, with no action taken).
  */
-int hw_driver_set_trigger_down_DBG(uint32_t time)
+int hw_driver_remove_breakpoint_DBG(uint32_t id)
 {
 	if(driver_setup()){
 		goto err;
@@ -5635,7 +6686,7 @@ int hw_driver_set_trigger_down_DBG(uint32_t time)
 	}
 
 	/* call to low-level routine */
-	if (ip_ecc_set_trigger_down(time)){
+	if (ip_ecc_remove_breakpoint(id)){
 		goto err;
 	}
 
@@ -5644,18 +6695,12 @@ err:
 	return -1;
 }
 
-/* Patch a single opcode in the microcode.
- * 
- *   'opcode_msb' must contain the upper 32-bit part of the opcode in case
- *   size of opcodes is larger than 32-bit (and in this case 'opsz' must = 2).
- *
- *   'opcode_lsb' must contain the lower 32-bit part of the opcode in case
- *   size of the opcode is larger than 32-bit, OR the opcode word in case
- *   the size is 32-bit or less (and in this case 'opsz' must = 1).
+/* Have IP to execute a certain nb of opcodes in microcode
  *
- * (in HW unsecure mode only).
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
  */
-int hw_driver_patch_one_opcode_DBG(uint32_t address, uint32_t opcode_msb, uint32_t opcode_lsb, uint32_t opsz)
+int hw_driver_run_opcodes_DBG(uint32_t nbops)
 {
 	if(driver_setup()){
 		goto err;
@@ -5668,23 +6713,28 @@ int hw_driver_patch_one_opcode_DBG(uint32_t address, uint32_t opcode_msb, uint32
 	}
 
 	/* call to low-level routine */
-	ip_ecc_patch_one_opcode(address, opcode_msb, opcode_lsb, opsz);
+	if (ip_ecc_run_opcodes(nbops)) {
+		goto err;
+	}
+
+	/* Note: it is the caller's responsability to further test that the IP
+	 * is again halted, hence meaning that the 'nbops' opcodes have been
+	 * run - use API function hw_driver_is_debug_halted_DBG()
+	 */
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Patch a portion or the whole of microcode image
- *
- * (in HW unsecure mode only).
+/* Same as hw_driver_run_opcodes_DBG() but single step
  */
-int hw_driver_patch_microcode_DBG(uint32_t* buf, uint32_t nbops, uint32_t opsz)
+int hw_driver_single_step_DBG()
 {
 	if(driver_setup()){
 		goto err;
 	}
-	
+
 	/* Test HW unsecure capability */
 	if (IPECC_IS_HW_SECURE())
 	{
@@ -5692,26 +6742,31 @@ int hw_driver_patch_microcode_DBG(uint32_t* buf, uint32_t nbops, uint32_t opsz)
 	}
 
 	/* call to low-level routine */
-	if (ip_ecc_patch_microcode(buf, nbops, opsz)) {
+	if (ip_ecc_single_step()) {
 		goto err;
 	}
 
+	/* Note: it is the caller's responsability to further test that the IP
+	 * is again halted, hence meaning that the one opcode have been
+	 * run - use API function hw_driver_is_debug_halted_DBG()
+	 */
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Set configuration of TRNG
+/* Resume execution of microcode
  *
  * (only allowed in HW unsecure mode, otherwise an error
  * is returned, with no action taken).
  */
-int hw_driver_configure_trng_DBG(int debias, uint32_t ta, uint32_t cycles)
+int hw_driver_resume_DBG()
 {
 	if(driver_setup()){
 		goto err;
 	}
-	
+
 	/* Test HW unsecure capability */
 	if (IPECC_IS_HW_SECURE())
 	{
@@ -5719,7 +6774,7 @@ int hw_driver_configure_trng_DBG(int debias, uint32_t ta, uint32_t cycles)
 	}
 
 	/* call to low-level routine */
-	if (ip_ecc_configure_trng(debias, ta, cycles)) {
+	if (ip_ecc_resume()){
 		goto err;
 	}
 
@@ -5728,17 +6783,17 @@ err:
 	return -1;
 }
 
-/* Reset the raw random bits FIFO
+/* Arm trigger function
  *
  * (only allowed in HW unsecure mode, otherwise an error
  * is returned, with no action taken).
  */
-int hw_driver_reset_trng_raw_fifo_DBG(void)
+int hw_driver_arm_trigger_DBG()
 {
 	if(driver_setup()){
 		goto err;
 	}
-	
+
 	/* Test HW unsecure capability */
 	if (IPECC_IS_HW_SECURE())
 	{
@@ -5746,7 +6801,7 @@ int hw_driver_reset_trng_raw_fifo_DBG(void)
 	}
 
 	/* call to low-level routine */
-	if (ip_ecc_reset_trng_raw_fifo()) {
+	if (ip_ecc_arm_trigger()){
 		goto err;
 	}
 
@@ -5755,17 +6810,209 @@ err:
 	return -1;
 }
 
-/* Reset all the internal random number FIFOs
+/* Disarm/disable trigger function
  *
  * (only allowed in HW unsecure mode, otherwise an error
  * is returned, with no action taken).
  */
-int hw_driver_reset_trng_irn_fifos_DBG(void)
+int hw_driver_disarm_trigger_DBG()
 {
 	if(driver_setup()){
 		goto err;
 	}
-	
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_disarm_trigger()){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Set configuration of UP trigger detection
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_set_trigger_up_DBG(uint32_t time)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_set_trigger_up(time)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Set configuration of DOWN trigger detection
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_set_trigger_down_DBG(uint32_t time)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_set_trigger_down(time)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Patch a single opcode in the microcode.
+ * 
+ *   'opcode_msb' must contain the upper 32-bit part of the opcode in case
+ *   size of opcodes is larger than 32-bit (and in this case 'opsz' must = 2).
+ *
+ *   'opcode_lsb' must contain the lower 32-bit part of the opcode in case
+ *   size of the opcode is larger than 32-bit, OR the opcode word in case
+ *   the size is 32-bit or less (and in this case 'opsz' must = 1).
+ *
+ * (in HW unsecure mode only).
+ */
+int hw_driver_patch_one_opcode_DBG(uint32_t address, uint32_t opcode_msb, uint32_t opcode_lsb, uint32_t opsz)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	ip_ecc_patch_one_opcode(address, opcode_msb, opcode_lsb, opsz);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Patch a portion or the whole of microcode image
+ *
+ * (in HW unsecure mode only).
+ */
+int hw_driver_patch_microcode_DBG(uint32_t* buf, uint32_t nbops, uint32_t opsz)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_patch_microcode(buf, nbops, opsz)) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Set configuration of TRNG
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_configure_trng_DBG(int debias, uint32_t ta, uint32_t cycles)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_configure_trng(debias, ta, cycles)) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Reset the raw random bits FIFO
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_reset_trng_raw_fifo_DBG(void)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_reset_trng_raw_fifo()) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Reset all the internal random number FIFOs
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_reset_trng_irn_fifos_DBG(void)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	
 	/* Test HW unsecure capability */
 	if (IPECC_IS_HW_SECURE())
 	{
@@ -6660,62 +7907,779 @@ int hw_driver_attack_set_level(int level)
 			 */
 			break;
 
-		default: 
-			break;
+		default: 
+			break;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To get some more capabilties than offered by hw_driver_get_capabilities()
+ *
+ * (only in HW unsecure mode, as some of the infos might give inside to the internal
+ * features of the IP which are not at all required for its nominal (secure)
+ * use.
+ */
+int hw_driver_get_more_capabilities_DBG(uint32_t* ww, uint32_t* nbop,
+		uint32_t* opsz, uint32_t* rawramsz, uint32_t* irnshw)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_get_more_capabilities(ww, nbop, opsz, rawramsz, irnshw)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To determine if the IP is currently debug-halted
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_is_debug_halted_DBG(bool* halted)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_is_debug_halted(halted)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Is the IP currently halted on a breakpoint hit?
+ * (and if it is, return the breakpoint ID).
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_halted_breakpoint_hit_DBG(bool* hit, uint32_t* id)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_halted_breakpoint_hit(hit, id)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Get the value of Program Counter
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_pc_DBG(uint32_t* pc)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_get_pc(pc)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To get the FSM state the IP is currently in.
+ *
+ *    The state is returned as a relatively short character string
+ *    (copied in 'state') which allocated size must be passed using
+ *    'sz'. No more than 'sz' bytes will be copied by the function.
+ *    However allow sufficient space, e.g 32 bytes to get enough
+ *    info.
+ *
+ *    See file <ecc_states.h> in folder hdl/common/ecc_curve_iram/
+ *    for a list of all state identifiers (this is one of the files
+ *    which are automatically generated when running 'make' in that
+ *    folder).
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_fsm_state_DBG(char* state, uint32_t sz)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_get_fsm_state(state, sz)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To get value of point-operation time counter.
+ *
+ *     Each time a point-based operation is started (including [k]P
+ *     computation) an internal counter is started and incremented at
+ *     each cycle of the main clock. Reading this counter allows to
+ *     measure computation duration of point operations.
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_time_DBG(uint32_t* clk_cycles)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* call to low-level routine */
+	if (ip_ecc_get_time(clk_cycles)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To assess the production throughput of TRNG raw random bits.
+ *
+ *     This function measures the time it takes to fill-up
+ *     the RAW random FIFO of the TRNG. It first disables
+ *     the post-processing function of the TRNG (so that not to
+ *     have any read empyting the FIFO), then reset (empty) it,
+ *     then poll debug status until it shows that the FIFO is
+ *     full. When it is, the value in register R_DBG_RAWDUR
+ *     yiels the nb of cycles (of the main clock) the filling-up
+ *     process took.
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_trng_raw_fifo_filling_time_DBG(uint32_t* duration)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_get_trng_raw_fifo_filling_time(duration)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Returns the state of the TRNG FIFO of raw random bits.
+ *
+ *   *full   = true is the FIFO is full
+ *   *nbbits = nb of raw random bits currently
+ *             buffered in the FIFO.
+ *
+ * It is recommended to wait for the IP to be in idle state
+ * (no running computation) or to be debug-halted before
+ * calling the function.
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_trng_raw_fifo_state_DBG(bool* full, uint32_t* nbbits)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_get_trng_raw_fifo_state(full, nbbits)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Read the whole content of the TRNG FIFO of raw random bits
+ *
+ *   'buf' must point to a buffer whose allocated size must
+ *   be sufficient to store the whole content of the FIFO,
+ *   the size of which shall be obtained through a call to
+ *   function hw_driver_get_more_capabilities_DBG()
+ *   (see that function)
+ *
+ * The function temporarily disables the post-processing unit
+ * of TRNG from reading bits from the FIFO. Hence it is strongly
+ * advised to wait for the IP to be in idle state (no computation)
+ * or debug-halted before calling this funtion.
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_content_of_trng_raw_random_fifo_DBG(char* buf, uint32_t* nbbits)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_get_content_of_trng_raw_random_fifo(buf, nbbits)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Acquire one window of contiguous raw random bits from the TRNG,
+ * packed into 32-bit words (see ip_ecc_get_trng_raw_window()).
+ *
+ *   'words' must hold at least 1/32th of the size of the FIFO
+ *   as returned by function hw_driver_get_more_capabilities_DBG().
+ *
+ * The IP internal random FIFOs are starved for the duration of the
+ * acquisition, hence it is strongly advised to wait for the IP to be
+ * in idle state (no computation) before calling this function.
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_get_trng_raw_window_DBG(uint32_t* words, uint32_t* nbbits, uint32_t* duration)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_get_trng_raw_window(words, nbbits, duration)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Map the pseudo TRNG device (if it was instanciated next to the IP)
+ *
+ * Only needed before the other hw_driver_pseudotrng_*_DBG() functions,
+ * the device is not mapped otherwise (see hw_driver_setup()).
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_pseudotrng_setup_DBG(void)
+{
+	volatile uint8_t* baddr;
+
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	if (ipecc_pseudotrng_baddr == NULL) {
+		/* (the IP itself gets mapped a second time, this is harmless) */
+		if (hw_driver_setup(&baddr, (volatile uint8_t**)&ipecc_pseudotrng_baddr)) {
+			ipecc_pseudotrng_baddr = NULL;
+			goto err;
+		}
+		if (ipecc_pseudotrng_baddr == NULL) {
+			goto err;
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Select the raw random source of the TRNG: the pseudo TRNG device
+ * if 'pseudo' is true, the entropy source of the IP otherwise.
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_trng_use_pseudo_source_DBG(bool pseudo)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_trng_use_pseudo_source(pseudo)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Empty the FIFO of the pseudo TRNG device
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_pseudotrng_reset_DBG(void)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_pseudotrng_reset()){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Push at most 'sz' bytes into the FIFO of the pseudo TRNG device
+ * (as many as it has room for, the nb of which is returned in *pushed).
+ *
+ * (only allowed in HW unsecure mode, otherwise an error
+ * is returned, with no action taken).
+ */
+int hw_driver_pseudotrng_push_DBG(const uint8_t* buf, uint32_t sz, uint32_t* pushed)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_pseudotrng_push(buf, sz, pushed)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To get an estimation of the frequency of clocks in the IP ('clk' & 'clkmm')
+ *
+ *     Parameter 'sec' is the time to wait for estimation (in seconds).
+ *
+ *     The larger the value of 'sec', the better the estimation
+ *     (3 seconds is enough, max allowed is 10 (error otherwise)).
+ */
+int hw_driver_get_clocks_freq_DBG(uint32_t* mhz, uint32_t* mhz_mm, uint32_t sec)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	if (sec > 10) {
+		goto err;
+	}
+
+	/* Sample the start counters */
+	if (ip_ecc_get_clocks_freq(mhz, mhz_mm, sec)) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* To get permutation address of each sensitive large numbers [XY]R[01]
+ * (when XY-shuffling countermeasure is active) both the input address
+ * and the ouput address.
+ */
+int hw_driver_get_xyshuf_perms_DBG(uint8_t* x0, uint8_t* y0, uint8_t* x1, uint8_t* y1,
+		uint8_t* x0n, uint8_t* y0n, uint8_t* x1n, uint8_t* y1n)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	ip_ecc_get_xyshuf_perms(x0, y0, x1, y1, x0n, y0n, x1n, y1n);
+
+	return 0;
+err:
+	return -1;
+}
+
+
+/* To get all the TRNG diagnostic infos in one API call
+ */
+int hw_driver_get_trng_diagnostics_DBG(trng_diagcnt_t* tdg)
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	/* Test HW unsecure capability */
+	if (IPECC_IS_HW_SECURE())
+	{
+		goto err;
+	}
+
+	/* Call to low level equivalent function */
+	if (ip_ecc_get_trng_diagnostics(tdg)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+int hw_driver_attack_enable_nnrndsf(void)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	if (ip_ecc_attack_enable_nnrndsf()){
+		goto err;
+	}
+	return 0;
+err:
+	return -1;
+}
+
+int hw_driver_attack_disable_nnrndsf(void)
+{
+	if(driver_setup()){
+		goto err;
+	}
+	if (ip_ecc_attack_disable_nnrndsf()){
+		goto err;
+	}
+	return 0;
+err:
+	return -1;
+}
+
+/* Attack features: set clk & clkmm division & out feature.
+ * (set div to 0 to switch off clock 'clk',
+ *  set divmm to 0 to switch off clock 'clkmm').
+ */
+int hw_driver_attack_set_clock_div_out(int div, int divmm) /* set to 0 to switch off clock */
+{
+	if(driver_setup()){
+		goto err;
+	}
+
+	if (ip_ecc_attack_set_clock_div_out(div, divmm)){
+		goto err;
+	}
+	return 0;
+err:
+	return -1;
+}
+
+/* Set the curve parameters a, b, p and q.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ *
+ * Note: if software does not intend to later use the blinding
+ * countermeasure, then the order 'q' of the curve is not mandatory
+ * (using e.g an arbitrary number for argument 'q' and setting 'q_sz'
+ * the same as 'p_sz').
+ *
+ * Note however that the IP could have been synthesized with an
+ * active hardware-locked blinding countermeasure, which, if the IP
+ * was further synthesized in production (secure) mode, won't be
+ * disengageable by software. In this situation, since every scalar
+ * multiplication will be run by the IP with active blinding, 'q'
+ * and 'q_sz' arguments should be rigorously set.
+ */
+int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+       		        const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz)
+{
+	const uint8_t *nb[4];
+	uint32_t sz[4];
+	uint32_t nn, i, slot, nbslots;
+	bool cache;
+
+	if(driver_setup()){
+		goto err;
+	}
+	/* We set the dynamic NN size value to be the max
+	 * of P and Q size
+	 */
+	nn = 8 * ((p_sz > q_sz) ? p_sz : q_sz);
+	if(ip_ecc_set_nn_bit_size(nn)){
+		goto err;
+	}
+
+	/* Select the Solinas reduction mode if the IP has it and 'p' is
+	 * one of the primes it supports (the Montgomery one otherwise).
+	 *
+	 * Note: this must be done before the curve is restored from or
+	 * bound to a slot, as the IP records the mode along with the
+	 * slot content (and as changing it invalidates p & a).
+	 */
+	if(IPECC_IS_FASTRED_SUPPORTED()){
+		IPECC_BUSY_WAIT();
+		IPECC_SET_FASTRED(ip_ecc_fastred_mode(p, p_sz));
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+	}
+
+	/* If the IP has curve context slots, look for the curve in them
+	 * and if it's there, restore it (nothing to upload then).
+	 *
+	 * Note: the write of W_PRIME_SIZE made above unbinds the current
+	 * slot, and a slot can only be restored if it was recorded with
+	 * the same value of 'nn' (which is also part of our match).
+	 */
+	cache = false;
+	slot = 0;
+	nbslots = 0;
+	if(IPECC_IS_CTX_SUPPORTED()){
+		nbslots = IPECC_GET_CURVE_SLOTS_NB();
+		if(nbslots > IPECC_CTX_SLOTS_MAX){
+			nbslots = IPECC_CTX_SLOTS_MAX;
+		}
+		nb[0] = p; sz[0] = p_sz;
+		nb[1] = a; sz[1] = a_sz;
+		nb[2] = b; sz[2] = b_sz;
+		nb[3] = q; sz[3] = q_sz;
+		cache = (nbslots > 0);
+		for(i = 0; i < 4; i++){
+			if((sz[i] > IPECC_CTX_NB_MAX_SZ) || (sz[i] && (nb[i] == NULL))){
+				cache = false;
+			}
+		}
+	}
+	if(cache){
+		for(i = 0; i < nbslots; i++){
+			if(ip_ecc_ctx_match(i, nn, nb, sz)
+					&& (IPECC_GET_CURVE_SLOTS_VALID() & (((uint32_t)1) << i))){
+				IPECC_CURVE_LOAD(i);
+				/* Wait until the IP is not busy (the restore is over) */
+				IPECC_BUSY_WAIT();
+				if(ip_ecc_check_error(NULL)){
+					/* Forget the slot & upload the curve the usual way */
+					ip_ecc_ctx[i].nn = 0;
+					break;
+				}
+				ip_ecc_ctx[i].stamp = ++ip_ecc_ctx_date;
+				return 0;
+			}
+		}
+		/* Not found: pick an empty slot if any, otherwise the least
+		 * recently used one, and bind it.
+		 */
+		for(i = 0; i < nbslots; i++){
+			if(ip_ecc_ctx[i].nn == 0){
+				slot = i;
+				break;
+			}
+			if(ip_ecc_ctx[i].stamp < ip_ecc_ctx[slot].stamp){
+				slot = i;
+			}
+		}
+		ip_ecc_ctx[slot].nn = 0;
+		IPECC_BUSY_WAIT();
+		IPECC_CURVE_BIND(slot);
+		IPECC_BUSY_WAIT();
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
 	}
 
-	return 0;
-err:
-	return -1;
-}
+	/* Write the Montgomery constants associated with p if the IP
+	 * lets us (and if it does not use the Solinas mode, the constants
+	 * of which are trivial), so that the write of p does not trigger
+	 * their computation.
+	 */
+	if(!IPECC_IS_FASTRED_SUPPORTED()
+			|| (ip_ecc_fastred_mode(p, p_sz) == IPECC_FASTRED_NONE)){
+		if(ip_ecc_write_mtycst(p, p_sz)){
+			goto err;
+		}
+	}
 
-/* To get some more capabilties than offered by hw_driver_get_capabilities()
- *
- * (only in HW unsecure mode, as some of the infos might give inside to the internal
- * features of the IP which are not at all required for its nominal (secure)
- * use.
- */
-int hw_driver_get_more_capabilities_DBG(uint32_t* ww, uint32_t* nbop,
-		uint32_t* opsz, uint32_t* rawramsz, uint32_t* irnshw)
-{
-	if(driver_setup()){
+	/* Set a, b, p, q
+	 *
+	 * Note: if the IP has CAP_MTYOVL, a, b & q are written while it
+	 * computes the Montgomery constants associated with p, and we only
+	 * wait for the end of that computation afterwards.
+	 */
+	if(ip_ecc_write_bignum(p, p_sz, EC_HW_REG_P)){
 		goto err;
 	}
-
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	ip_ecc_mtyovl = IPECC_IS_MTYOVL_SUPPORTED();
+	if(ip_ecc_write_bignum(a, a_sz, EC_HW_REG_A)){
 		goto err;
 	}
-
-	/* call to low-level routine */
-	if (ip_ecc_get_more_capabilities(ww, nbop, opsz, rawramsz, irnshw)){
+	if(ip_ecc_write_bignum(b, b_sz, EC_HW_REG_B)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(q, q_sz, EC_HW_REG_Q)){
 		goto err;
 	}
+	if(ip_ecc_mtyovl){
+		ip_ecc_mtyovl = false;
+		IPECC_BUSY_WAIT();
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+	}
+
+	/* Remember what the bound slot now holds */
+	if(cache){
+		for(i = 0; i < 4; i++){
+			ip_ecc_ctx[slot].sz[i] = sz[i];
+			if(sz[i]){
+				memcpy(ip_ecc_ctx[slot].nb[i], nb[i], sz[i]);
+			}
+		}
+		ip_ecc_ctx[slot].nn = nn;
+		ip_ecc_ctx[slot].stamp = ++ip_ecc_ctx_date;
+	}
 
 	return 0;
 err:
+	ip_ecc_mtyovl = false;
 	return -1;
 }
 
-/* To determine if the IP is currently debug-halted
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+/* Activate the blinding for scalar multiplication.
+ *
+ * Argument 'blinding_size' must be given in bits, and must be
+ * strictly less than the value of 'nn' currently set in the
+ * hardware (hance 'nn' - 1 is the largest authorized value).
+ *
+ * Otherwise error 'ERR_BLN' is raised in R_STATUS register.
+ *
+ * A value of 0 for input argument 'blinding_size' is counter-
+ * intuitive and will be held as meaning to disable the blinding
+ * countermeasure (consider using instead  explicit function
+ * hw_driver_disable_blinding()).
  */
-int hw_driver_is_debug_halted_DBG(bool* halted)
+int hw_driver_enable_blinding_and_set_size(uint32_t blinding_size)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
-	}
-
-	/* call to low-level routine */
-	if (ip_ecc_is_debug_halted(halted)){
+	if(ip_ecc_enable_blinding_and_set_size(blinding_size)){
 		goto err;
 	}
 
@@ -6724,25 +8688,15 @@ err:
 	return -1;
 }
 
-/* Is the IP currently halted on a breakpoint hit?
- * (and if it is, return the breakpoint ID).
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+/* Disable the blinding for scalar multiplication.
  */
-int hw_driver_halted_breakpoint_hit_DBG(bool* hit, uint32_t* id)
+int hw_driver_disable_blinding(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
-	}
-
-	/* call to low-level routine */
-	if (ip_ecc_halted_breakpoint_hit(hit, id)){
+	if(ip_ecc_disable_blinding()){
 		goto err;
 	}
 
@@ -6751,24 +8705,14 @@ err:
 	return -1;
 }
 
-/* Get the value of Program Counter
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
- */
-int hw_driver_get_pc_DBG(uint32_t* pc)
+/* Activate the shuffling for scalar multiplication */
+int hw_driver_enable_shuffling(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
-	}
-
-	/* call to low-level routine */
-	if (ip_ecc_get_pc(pc)){
+	if(ip_ecc_enable_shuffling()){
 		goto err;
 	}
 
@@ -6777,36 +8721,14 @@ err:
 	return -1;
 }
 
-/* To get the FSM state the IP is currently in.
- *
- *    The state is returned as a relatively short character string
- *    (copied in 'state') which allocated size must be passed using
- *    'sz'. No more than 'sz' bytes will be copied by the function.
- *    However allow sufficient space, e.g 32 bytes to get enough
- *    info.
- *
- *    See file <ecc_states.h> in folder hdl/common/ecc_curve_iram/
- *    for a list of all state identifiers (this is one of the files
- *    which are automatically generated when running 'make' in that
- *    folder).
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
- */
-int hw_driver_get_fsm_state_DBG(char* state, uint32_t sz)
+/* Disable the shuffling for scalar multiplication */
+int hw_driver_disable_shuffling(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
-	}
-
-	/* call to low-level routine */
-	if (ip_ecc_get_fsm_state(state, sz)){
+	if(ip_ecc_disable_shuffling()){
 		goto err;
 	}
 
@@ -6815,30 +8737,15 @@ err:
 	return -1;
 }
 
-/* To get value of point-operation time counter.
- *
- *     Each time a point-based operation is started (including [k]P
- *     computation) an internal counter is started and incremented at
- *     each cycle of the main clock. Reading this counter allows to
- *     measure computation duration of point operations.
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
- */
-int hw_driver_get_time_DBG(uint32_t* clk_cycles)
+/* Activate and configure the periodic Z-remasking countermeasure
+ * (the 'period' arguement is expressed in number of bits of the scalar */
+int hw_driver_enable_zremask_and_set_period(uint32_t period)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
-	}
-
-	/* call to low-level routine */
-	if (ip_ecc_get_time(clk_cycles)){
+	if(ip_ecc_enable_zremask_and_set_period(period)){
 		goto err;
 	}
 
@@ -6847,34 +8754,14 @@ err:
 	return -1;
 }
 
-/* To assess the production throughput of TRNG raw random bits.
- *
- *     This function measures the time it takes to fill-up
- *     the RAW random FIFO of the TRNG. It first disables
- *     the post-processing function of the TRNG (so that not to
- *     have any read empyting the FIFO), then reset (empty) it,
- *     then poll debug status until it shows that the FIFO is
- *     full. When it is, the value in register R_DBG_RAWDUR
- *     yiels the nb of cycles (of the main clock) the filling-up
- *     process took.
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
- */
-int hw_driver_get_trng_raw_fifo_filling_time_DBG(uint32_t* duration)
+/* Disable the periodic Z-remasking countermeasure for scalar multiplication */
+int hw_driver_disable_zremask(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
-		goto err;
-	}
-
-	/* Call to low level equivalent function */
-	if (ip_ecc_get_trng_raw_fifo_filling_time(duration)){
+	if(ip_ecc_disable_zremask()){
 		goto err;
 	}
 
@@ -6883,71 +8770,51 @@ err:
 	return -1;
 }
 
-/* Returns the state of the TRNG FIFO of raw random bits.
- *
- *   *full   = true is the FIFO is full
- *   *nbbits = nb of raw random bits currently
- *             buffered in the FIFO.
+/* Check if an affine point (x, y) is on the curve currently defined
+ * in the IP (this curve was previously set in the hardware using
+ * function hw_driver_set_curve() - c.f above).
  *
- * It is recommended to wait for the IP to be in idle state
- * (no running computation) or to be debug-halted before
- * calling the function.
+ * All size arguments (*_sz) must be given in bytes.
  *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
  */
-int hw_driver_get_trng_raw_fifo_state_DBG(bool* full, uint32_t* nbbits)
+int hw_driver_is_on_curve(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                     	  int *on_curve)
 {
+	int inf_r0, inf_r1;
+
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
 		goto err;
 	}
-
-	/* Call to low level equivalent function */
-	if (ip_ecc_get_trng_raw_fifo_state(full, nbbits)){
+	if(ip_ecc_get_r1_inf(&inf_r1)){
 		goto err;
 	}
 
-	return 0;
-err:
-	return -1;
-}
-
-/* Read the whole content of the TRNG FIFO of raw random bits
- *
- *   'buf' must point to a buffer whose allocated size must
- *   be sufficient to store the whole content of the FIFO,
- *   the size of which shall be obtained through a call to
- *   function hw_driver_get_more_capabilities_DBG()
- *   (see that function)
- *
- * The function temporarily disables the post-processing unit
- * of TRNG from reading bits from the FIFO. Hence it is strongly
- * advised to wait for the IP to be in idle state (no computation)
- * or debug-halted before calling this funtion.
- *
- * (only allowed in HW unsecure mode, otherwise an error
- * is returned, with no action taken).
- */
-int hw_driver_get_content_of_trng_raw_random_fifo_DBG(char* buf, uint32_t* nbbits)
-{
-	if(driver_setup()){
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
 		goto err;
 	}
 
-	/* Call to low level equivalent function */
-	if (ip_ecc_get_content_of_trng_raw_random_fifo(buf, nbbits)){
+	/* Check if it is on curve */
+	if(ip_ecc_exec_command(PT_CHK, on_curve, NULL, NULL, NULL)){
 		goto err;
 	}
 
@@ -6956,31 +8823,57 @@ err:
 	return -1;
 }
 
-/* To get an estimation of the frequency of clocks in the IP ('clk' & 'clkmm')
+/* Check if affine points (x1, y1) and (x2, y2) are equal.
  *
- *     Parameter 'sec' is the time to wait for estimation (in seconds).
+ * All size arguments (*_sz) must be given in bytes.
  *
- *     The larger the value of 'sec', the better the estimation
- *     (3 seconds is enough, max allowed is 10 (error otherwise)).
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
  */
-int hw_driver_get_clocks_freq_DBG(uint32_t* mhz, uint32_t* mhz_mm, uint32_t sec)
+int hw_driver_eq(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+       	    	 const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+                 int *is_eq)
 {
+	int inf_r0, inf_r1;
+
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
 		goto err;
 	}
 
-	if (sec > 10) {
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	/* Write our R1 register */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
 		goto err;
 	}
 
-	/* Sample the start counters */
-	if (ip_ecc_get_clocks_freq(mhz, mhz_mm, sec)) {
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Check if it the points are equal */
+	if(ip_ecc_exec_command(PT_EQU, is_eq, NULL, NULL, NULL)){
 		goto err;
 	}
 
@@ -6989,48 +8882,58 @@ err:
 	return -1;
 }
 
-/* To get permutation address of each sensitive large numbers [XY]R[01]
- * (when XY-shuffling countermeasure is active) both the input address
- * and the ouput address.
+/* Check if affine points (x1, y1) and (x2, y2) are opposite.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
  */
-int hw_driver_get_xyshuf_perms_DBG(uint8_t* x0, uint8_t* y0, uint8_t* x1, uint8_t* y1,
-		uint8_t* x0n, uint8_t* y0n, uint8_t* x1n, uint8_t* y1n)
+int hw_driver_opp(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+               	  int *is_opp)
 {
+	int inf_r0, inf_r1;
+
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
 		goto err;
 	}
 
-	/* Call to low level equivalent function */
-	ip_ecc_get_xyshuf_perms(x0, y0, x1, y1, x0n, y0n, x1n, y1n);
-
-	return 0;
-err:
-	return -1;
-}
-
-
-/* To get all the TRNG diagnostic infos in one API call
- */
-int hw_driver_get_trng_diagnostics_DBG(trng_diagcnt_t* tdg)
-{
-	if(driver_setup()){
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	/* Write our R1 register */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
 		goto err;
 	}
 
-	/* Test HW unsecure capability */
-	if (IPECC_IS_HW_SECURE())
-	{
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
 		goto err;
 	}
 
-	/* Call to low level equivalent function */
-	if (ip_ecc_get_trng_diagnostics(tdg)){
+
+	/* Check if the points are opposite */
+	if(ip_ecc_exec_command(PT_OPP, is_opp, NULL, NULL, NULL)){
 		goto err;
 	}
 
@@ -7039,129 +8942,193 @@ err:
 	return -1;
 }
 
-int hw_driver_attack_enable_nnrndsf(void)
+/* Check if the infinity point flag is set in the hardware for
+ * point at index idx.
+ *
+ * Argument 'index' must be either 0, identifying point R0, or 1,
+ * identifying point R1.
+ */
+int hw_driver_point_iszero(uint8_t idx, int *iszero)
 {
 	if(driver_setup()){
 		goto err;
 	}
-	if (ip_ecc_attack_enable_nnrndsf()){
-		goto err;
+
+	switch(idx){
+		case 0:{
+			/* Get our R0 register infinity flag */
+			if(ip_ecc_get_r0_inf(iszero)){
+				goto err;
+			}
+			break;
+		}
+		case 1:{
+			/* Get our R1 register infinity flag */
+			if(ip_ecc_get_r1_inf(iszero)){
+				goto err;
+			}
+			break;
+		}
+		default:{
+			/* Index not supported */
+			goto err;
+		}
 	}
+
 	return 0;
 err:
 	return -1;
 }
 
-int hw_driver_attack_disable_nnrndsf(void)
+/* Set the infinity point flag in the hardware for point
+ * at index idx. This tells hardware to hold the corresponding
+ * point (R0 or R1) as being the null point (aka point at infinity).
+ *
+ * Any values of the affine coordinates the hardware was currently
+ * holding for that point will become irrelevant, either they were
+ * resulting from a previous computation or transmitted by software.
+ *
+ * Argument 'index' must be either 0, identifying point R0, or 1,
+ * identifying point R1.
+ */
+int hw_driver_point_zero(uint8_t idx)
 {
 	if(driver_setup()){
 		goto err;
 	}
-	if (ip_ecc_attack_disable_nnrndsf()){
-		goto err;
+
+	switch(idx){
+		case 0:{
+			/* Write our R0 register infinity flag */
+			if(ip_ecc_set_r0_inf(1)){
+				goto err;
+			}
+			break;
+		}
+		case 1:{
+			/* Write our R1 register infinity flag */
+			if(ip_ecc_set_r1_inf(1)){
+				goto err;
+			}
+			break;
+		}
+		default:{
+			/* Index not supported */
+			goto err;
+		}
 	}
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Attack features: set clk & clkmm division & out feature.
- * (set div to 0 to switch off clock 'clk',
- *  set divmm to 0 to switch off clock 'clkmm').
+/* Unset the infinity point flag in the hardware for
+ * point at index idx. This tells hardware to hold the corresponding
+ * point (R0 or R1) as NOT being the null point (aka point at infinity).
+ *
+ * The affine coordinates the hardware was currently holding for that
+ * point will then become relevant, either they were resulting from a
+ * previous computation or transmitted by software.
+ *
+ * Further note that transmitting coordinates to the hardware for one
+ * of particular points R0 or R1 (using ip_ecc_write_bignum()) automatically
+ * set that point as being not null, just as hw_driver_point_unzero()
+ * would do.
+ *
+ * Argument 'index' must be either 0, identifying point R0, or 1,
+ * identifying point R1.
  */
-int hw_driver_attack_set_clock_div_out(int div, int divmm) /* set to 0 to switch off clock */
+int hw_driver_point_unzero(uint8_t idx)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	if (ip_ecc_attack_set_clock_div_out(div, divmm)){
-		goto err;
+	switch(idx){
+		case 0:{
+			/* Write our R0 register infinity flag */
+			if(ip_ecc_set_r0_inf(0)){
+				goto err;
+			}
+			break;
+		}
+		case 1:{
+			/* Write our R1 register infinity flag */
+			if(ip_ecc_set_r1_inf(0)){
+				goto err;
+			}
+			break;
+		}
+		default:{
+			/* Index not supported */
+			goto err;
+		}
 	}
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Set the curve parameters a, b, p and q.
+/* Return (out_x, out_y) = -(x, y) i.e the opposite of the
+ * intput point.
  *
  * All size arguments (*_sz) must be given in bytes.
  *
  * Please read and take into consideration the 'NOTE:' mentionned
  * at the top of the prototype file <hw_accelerator_driver.h>
  * about the formatting and size of large numbers.
- *
- * Note: if software does not intend to later use the blinding
- * countermeasure, then the order 'q' of the curve is not mandatory
- * (using e.g an arbitrary number for argument 'q' and setting 'q_sz'
- * the same as 'p_sz').
- *
- * Note however that the IP could have been synthesized with an
- * active hardware-locked blinding countermeasure, which, if the IP
- * was further synthesized in production (secure) mode, won't be
- * disengageable by software. In this situation, since every scalar
- * multiplication will be run by the IP with active blinding, 'q'
- * and 'q_sz' arguments should be rigorously set.
  */
-int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
-       		        const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz)
+int hw_driver_neg(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
 {
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
 	if(driver_setup()){
 		goto err;
 	}
-	/* We set the dynamic NN size value to be the max
-	 * of P and Q size
-	 */
-	if(p_sz > q_sz){
-		if(ip_ecc_set_nn_bit_size(8 * p_sz)){
-			goto err;
-		}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
 	}
-	else{
-		if(ip_ecc_set_nn_bit_size(8 * q_sz)){
-			goto err;
-		}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
 	}
 
-	/* Set a, b, p, q */
-	if(ip_ecc_write_bignum(p, p_sz, EC_HW_REG_P)){
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(a, a_sz, EC_HW_REG_A)){
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(b, b_sz, EC_HW_REG_B)){
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(q, q_sz, EC_HW_REG_Q)){
+	if(ip_ecc_set_r1_inf(inf_r1)){
 		goto err;
 	}
 
-	return 0;
-err:
-	return -1;
-}
-
-/* Activate the blinding for scalar multiplication.
- *
- * Argument 'blinding_size' must be given in bits, and must be
- * strictly less than the value of 'nn' currently set in the
- * hardware (hance 'nn' - 1 is the largest authorized value).
- *
- * Otherwise error 'ERR_BLN' is raised in R_STATUS register.
- *
- * A value of 0 for input argument 'blinding_size' is counter-
- * intuitive and will be held as meaning to disable the blinding
- * countermeasure (consider using instead  explicit function
- * hw_driver_disable_blinding()).
- */
-int hw_driver_enable_blinding_and_set_size(uint32_t blinding_size)
-{
-	if(driver_setup()){
+	/* Execute our NEG command */
+	if(ip_ecc_exec_command(PT_NEG, NULL, NULL, NULL, NULL)){
 		goto err;
 	}
 
-	if(ip_ecc_enable_blinding_and_set_size(blinding_size)){
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
 		goto err;
 	}
 
@@ -7170,80 +9137,64 @@ err:
 	return -1;
 }
 
-/* Disable the blinding for scalar multiplication.
+/* Return (out_x, out_y) = 2 * (x, y), i.e the double of the
+ * input point.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
  */
-int hw_driver_disable_blinding(void)
+int hw_driver_dbl(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
 {
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
 	if(driver_setup()){
 		goto err;
 	}
 
-	if(ip_ecc_disable_blinding()){
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
 		goto err;
 	}
-
-	return 0;
-err:
-	return -1;
-}
-
-/* Activate the shuffling for scalar multiplication */
-int hw_driver_enable_shuffling(void)
-{
-	if(driver_setup()){
+	if(ip_ecc_get_r1_inf(&inf_r1)){
 		goto err;
 	}
 
-	if(ip_ecc_enable_shuffling()){
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
 		goto err;
 	}
-
-	return 0;
-err:
-	return -1;
-}
-
-/* Disable the shuffling for scalar multiplication */
-int hw_driver_disable_shuffling(void)
-{
-	if(driver_setup()){
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
 		goto err;
 	}
 
-	if(ip_ecc_disable_shuffling()){
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
 		goto err;
 	}
-
-	return 0;
-err:
-	return -1;
-}
-
-/* Activate and configure the periodic Z-remasking countermeasure
- * (the 'period' arguement is expressed in number of bits of the scalar */
-int hw_driver_enable_zremask_and_set_period(uint32_t period)
-{
-	if(driver_setup()){
+	if(ip_ecc_set_r1_inf(inf_r1)){
 		goto err;
 	}
 
-	if(ip_ecc_enable_zremask_and_set_period(period)){
+	/* Execute our DBL command */
+	if(ip_ecc_exec_command(PT_DBL, NULL, NULL, NULL, NULL)){
 		goto err;
 	}
 
-	return 0;
-err:
-	return -1;
-}
-
-/* Disable the periodic Z-remasking countermeasure for scalar multiplication */
-int hw_driver_disable_zremask(void)
-{
-	if(driver_setup()){
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
 		goto err;
 	}
-
-	if(ip_ecc_disable_zremask()){
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
 		goto err;
 	}
 
@@ -7252,9 +9203,9 @@ err:
 	return -1;
 }
 
-/* Check if an affine point (x, y) is on the curve currently defined
- * in the IP (this curve was previously set in the hardware using
- * function hw_driver_set_curve() - c.f above).
+
+/* Return (out_x, out_y) = (x1, y1) + (x2, y2), i.e perform addition
+ * of the two input points.
  *
  * All size arguments (*_sz) must be given in bytes.
  *
@@ -7262,10 +9213,12 @@ err:
  * at the top of the prototype file <hw_accelerator_driver.h>
  * about the formatting and size of large numbers.
  */
-int hw_driver_is_on_curve(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                     	  int *on_curve)
+int hw_driver_add(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
 {
 	int inf_r0, inf_r1;
+	uint32_t nn_sz;
 
 	if(driver_setup()){
 		goto err;
@@ -7280,10 +9233,17 @@ int hw_driver_is_on_curve(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uin
 	}
 
 	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	/* Write our R1 register */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
 		goto err;
 	}
 
@@ -7295,8 +9255,21 @@ int hw_driver_is_on_curve(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uin
 		goto err;
 	}
 
-	/* Check if it is on curve */
-	if(ip_ecc_exec_command(PT_CHK, on_curve, NULL, NULL, NULL)){
+	/* Execute our ADD command */
+	if(ip_ecc_exec_command(PT_ADD, NULL, NULL, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
 		goto err;
 	}
 
@@ -7305,7 +9278,8 @@ err:
 	return -1;
 }
 
-/* Check if affine points (x1, y1) and (x2, y2) are equal.
+/* Return (out_x, out_y) = scalar * (x, y), i.e perform the scalar 
+ * multiplication of the input point by the input scalar.
  *
  * All size arguments (*_sz) must be given in bytes.
  *
@@ -7313,304 +9287,386 @@ err:
  * at the top of the prototype file <hw_accelerator_driver.h>
  * about the formatting and size of large numbers.
  */
-int hw_driver_eq(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
-       	    	 const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
-                 int *is_eq)
+int hw_driver_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                  const uint8_t *scalar, uint32_t scalar_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+									uint32_t* kp_time, uint32_t* zmask, kp_trace_info_t* ktrc)
 {
 	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
+	/* 32768 bits are more than enough for any practical
+	 * use of elliptic curve cryptography.
+	 */
+	uint8_t token[4096] = {0, }; /* Heck, a whole page? Yes indeed. */
 
 	if(driver_setup()){
+		log_print("In hw_driver_mul(): Error in driver_setup()\n\r");
+		goto err;
+	}
+
+	/* Nb of bytes corresponding to current value of 'nn' in the IP.
+	 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+
+	/* Check that the current value of 'nn' does not exceed the size
+	 * allocated to the token on the stack.
+	 */
+	if(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()) > 4096){
+		log_print("In hw_driver_mul(): Error in ip_ecc_nn_bytes_from_bits_sz()\n\r");
 		goto err;
 	}
 
 	/* Preserve our inf flags in a constant time fashion */
 	if(ip_ecc_get_r0_inf(&inf_r0)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_get_r0_inf()\n\r");
 		goto err;
 	}
 	if(ip_ecc_get_r1_inf(&inf_r1)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_get_r1_inf()\n\r");
 		goto err;
 	}
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+	/* Get the random one-shot token */
+	if (ip_ecc_get_token(token, nn_sz)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_get_token()\n\r");
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+
+	/* Write our scalar register with the scalar k */
+	if(ip_ecc_write_bignum(scalar, scalar_sz, EC_HW_REG_SCALAR)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
+		goto err;
+	}
+	/* Write our R1 register with the point to be multiplied */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R1_X)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R1_Y)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_set_r0_inf()\n\r");
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_set_r1_inf()\n\r");
+		goto err;
+	}
+
+	/* Execute our [k]P command */
+	if(ip_ecc_exec_command(PT_KP, NULL, kp_time, zmask, ktrc)) {
+		log_print("In hw_driver_mul(): Error in ip_ecc_exec_command()\n\r");
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		log_print("In hw_driver_mul(): *out_x_sz = %d\n\r", *out_x_sz);
+		log_print("In hw_driver_mul(): *out_y_sz = %d\n\r", *out_y_sz);
+		log_print("In hw_driver_mul(): nn_sz = %d\n\r", nn_sz);
+		log_print("In hw_driver_mul(): Error in sizes' comparison\n\r");
 		goto err;
 	}
-	/* Write our R1 register */
-	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_read_bignum()\n\r");
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_read_bignum()\n\r");
 		goto err;
 	}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+	/* Unmask the [k]P result coordinates with the one-shot token */
+	if (ip_ecc_unmask_with_token(out_x, (*out_x_sz), token, nn_sz, out_x, out_x_sz)) {
+		log_print("In hw_driver_mul(): Error in ip_ecc_unmask_with_token()\n\r");
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	if (ip_ecc_unmask_with_token(out_y, (*out_y_sz), token, nn_sz, out_y, out_y_sz)) {
+		log_print("In hw_driver_mul(): Error in ip_ecc_unmask_with_token()\n\r");
 		goto err;
-	}
+	};
 
-	/* Check if it the points are equal */
-	if(ip_ecc_exec_command(PT_EQU, is_eq, NULL, NULL, NULL)){
-		goto err;
-	}
+	/* Clear the token */
+	ip_ecc_clear_token(token, nn_sz);
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Check if affine points (x1, y1) and (x2, y2) are opposite.
+/* Set the small scalar size in the hardware.
  *
- * All size arguments (*_sz) must be given in bytes.
+ * The 'small scalar size' feature is provided by the IP in order
+ * to provide a computation speed-up for really small scalar.
  *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
- */
-int hw_driver_opp(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
-                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
-               	  int *is_opp)
+ * This is a "one shot" feature, meaning the 'nn' parameter is
+ * still recorded by the IP and will become applicable again
+ * as soon as the scalar multiplication following the call to
+ * function hw_driver_set_small_scalar_size() is done.
+ *
+ * Hence hw_driver_set_small_scalar_size() must be called
+ * each time the feature is needed.
+ *
+ * Obviously this feature only concerns the scalar multiplication.
+ * */
+int hw_driver_set_small_scalar_size(uint32_t bit_sz)
 {
-	int inf_r0, inf_r1;
-
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
-		goto err;
-	}
+	/* NOTE: sanity check on this size should be performed by
+	 * the hardware (e.g. is this size exceeds the nn size, and
+	 * so on). So no need to sanity check anything here. */
+	IPECC_SET_SMALL_SCALAR_SIZE(bit_sz);
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
-		goto err;
-	}
-	/* Write our R1 register */
-	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
-		goto err;
-	}
+	return 0;
+err:
+	return -1;
+}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+/* Enable the hardware command queue.
+ *
+ * Once enabled, the IP replays the entries pushed into its command queue
+ * one after the other, as soon as it is ready to accept them, and per-
+ * operation IRQs are replaced by one IRQ every 'irq_thr' completions
+ * (a value of 0 is understood as 1) or when the queue gets empty.
+ */
+int hw_driver_cmdq_enable(uint32_t irq_thr)
+{
+	if(driver_setup()){
 		goto err;
 	}
 
-
-	/* Check if the points are opposite */
-	if(ip_ecc_exec_command(PT_OPP, is_opp, NULL, NULL, NULL)){
+	if(!IPECC_IS_CMDQ_SUPPORTED()){
+		log_print("In hw_driver_cmdq_enable(): no command queue in hardware\n\r");
 		goto err;
 	}
 
+	IPECC_CMDQ_SET_CTRL(1, irq_thr);
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Check if the infinity point flag is set in the hardware for
- * point at index idx.
- *
- * Argument 'index' must be either 0, identifying point R0, or 1,
- * identifying point R1.
+/* Disable the hardware command queue (entry being replayed, if any,
+ * is completed, others stay in the queue).
  */
-int hw_driver_point_iszero(uint8_t idx, int *iszero)
+int hw_driver_cmdq_disable(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	switch(idx){
-		case 0:{
-			/* Get our R0 register infinity flag */
-			if(ip_ecc_get_r0_inf(iszero)){
-				goto err;
-			}
-			break;
-		}
-		case 1:{
-			/* Get our R1 register infinity flag */
-			if(ip_ecc_get_r1_inf(iszero)){
-				goto err;
-			}
-			break;
-		}
-		default:{
-			/* Index not supported */
-			goto err;
-		}
-	}
+	IPECC_CMDQ_SET_CTRL(0, 0);
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Set the infinity point flag in the hardware for point
- * at index idx. This tells hardware to hold the corresponding
- * point (R0 or R1) as being the null point (aka point at infinity).
- *
- * Any values of the affine coordinates the hardware was currently
- * holding for that point will become irrelevant, either they were
- * resulting from a previous computation or transmitted by software.
- *
- * Argument 'index' must be either 0, identifying point R0, or 1,
- * identifying point R1.
+/* Empty the command queue and the result FIFO (this also disables
+ * the queue).
  */
-int hw_driver_point_zero(uint8_t idx)
+int hw_driver_cmdq_flush(void)
 {
 	if(driver_setup()){
 		goto err;
 	}
 
-	switch(idx){
-		case 0:{
-			/* Write our R0 register infinity flag */
-			if(ip_ecc_set_r0_inf(1)){
-				goto err;
-			}
-			break;
-		}
-		case 1:{
-			/* Write our R1 register infinity flag */
-			if(ip_ecc_set_r1_inf(1)){
-				goto err;
-			}
-			break;
-		}
-		default:{
-			/* Index not supported */
-			goto err;
-		}
-	}
+	IPECC_CMDQ_FLUSH();
+	ip_ecc_cmdq_forget();
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Unset the infinity point flag in the hardware for
- * point at index idx. This tells hardware to hold the corresponding
- * point (R0 or R1) as NOT being the null point (aka point at infinity).
+/* Enqueue a complete [k]P computation: (x, y) is the point to be multiplied
+ * (it can't be the point at infinity, use hw_driver_mul() for that) and
+ * 'tag' is an arbitrary value which hw_driver_cmdq_pop_mul() will give back
+ * along with the result.
  *
- * The affine coordinates the hardware was currently holding for that
- * point will then become relevant, either they were resulting from a
- * previous computation or transmitted by software.
- *
- * Further note that transmitting coordinates to the hardware for one
- * of particular points R0 or R1 (using ip_ecc_write_bignum()) automatically
- * set that point as being not null, just as hw_driver_point_unzero()
- * would do.
+ * This function does not wait for the IP to be idle, hence several [k]P
+ * computations can be enqueued while a previous one is still running,
+ * and the IP chains them without any software round-trip inbetween.
+ * Results must be retrieved, in the same order, with hw_driver_cmdq_pop_mul().
  *
- * Argument 'index' must be either 0, identifying point R0, or 1,
- * identifying point R1.
+ * Each computation pushes 3.nn_size + 2 words into the result FIFO (token,
+ * x, y, tag & status), which has the depth of the queue: the computation is
+ * refused if its result could not fit in the FIFO along with the ones not
+ * retrieved yet (results must then be popped first) or at all (the IP was
+ * synthesized with a too small value of 'cmdqsize' for the current 'nn').
+ * If an error occurs once entries were enqueued, the queue should be flushed
+ * (hw_driver_cmdq_flush()).
  */
-int hw_driver_point_unzero(uint8_t idx)
+int hw_driver_cmdq_push_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+		const uint8_t *scalar, uint32_t scalar_sz, uint32_t tag)
 {
+	uint32_t nn_size, nbres, size;
+
 	if(driver_setup()){
+		log_print("In hw_driver_cmdq_push_mul(): Error in driver_setup()\n\r");
 		goto err;
 	}
 
-	switch(idx){
-		case 0:{
-			/* Write our R0 register infinity flag */
-			if(ip_ecc_set_r0_inf(0)){
-				goto err;
-			}
-			break;
-		}
-		case 1:{
-			/* Write our R1 register infinity flag */
-			if(ip_ecc_set_r1_inf(0)){
-				goto err;
-			}
-			break;
-		}
-		default:{
-			/* Index not supported */
-			goto err;
-		}
+	/* Nb of words corresponding to current value of 'nn' in the IP */
+	nn_size = ip_ecc_nn_words_from_bytes_sz(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()));
+
+	/* Room for the result in the result FIFO */
+	nbres = (3 * nn_size) + 2;
+	if(ip_ecc_cmdq_get_size(&size)){
+		log_print("In hw_driver_cmdq_push_mul(): Error in ip_ecc_cmdq_get_size()\n\r");
+		goto err;
+	}
+	if(nbres > size){
+		log_print("In hw_driver_cmdq_push_mul(): result (%d words) can't fit in "
+				"the result FIFO (%d words, see 'cmdqsize')\n\r", nbres, size);
+		goto err;
+	}
+	if((ip_ecc_cmdq_res_pending + nbres) > size){
+		log_print("In hw_driver_cmdq_push_mul(): result FIFO would overflow, "
+				"pop results first\n\r");
+		goto err;
+	}
+
+	/* Generation of the random one-shot token & readback of it
+	 * (token is routed to the result FIFO, see hw_driver_cmdq_pop_mul()) */
+	if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_WRITE, IPECC_CMDQ_REG_IDX(IPECC_W_TOKEN), 1)){
+		goto err;
+	}
+	if(ip_ecc_cmdq_push_read_bignum(0, 1, nn_size)){
+		goto err;
+	}
+	/* Scalar k (the IP waits by itself for enough random to mask it) */
+	if(ip_ecc_cmdq_push_write_bignum(scalar, scalar_sz, IPECC_BNUM_K, 1, nn_size)){
+		log_print("In hw_driver_cmdq_push_mul(): Error in ip_ecc_cmdq_push_write_bignum()\n\r");
+		goto err;
+	}
+	/* Point to be multiplied, in R1 */
+	if(ip_ecc_cmdq_push_write_bignum(x, x_sz, IPECC_BNUM_R1_X, 0, nn_size)){
+		log_print("In hw_driver_cmdq_push_mul(): Error in ip_ecc_cmdq_push_write_bignum()\n\r");
+		goto err;
+	}
+	if(ip_ecc_cmdq_push_write_bignum(y, y_sz, IPECC_BNUM_R1_Y, 0, nn_size)){
+		log_print("In hw_driver_cmdq_push_mul(): Error in ip_ecc_cmdq_push_write_bignum()\n\r");
+		goto err;
+	}
+	/* [k]P command */
+	if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_WRITE, IPECC_CMDQ_REG_IDX(IPECC_W_CTRL),
+				IPECC_W_CTRL_PT_KP)){
+		goto err;
+	}
+	/* Readback of the (token-masked) result from R1 */
+	if(ip_ecc_cmdq_push_read_bignum(IPECC_BNUM_R1_X, 0, nn_size)){
+		goto err;
+	}
+	if(ip_ecc_cmdq_push_read_bignum(IPECC_BNUM_R1_Y, 0, nn_size)){
+		goto err;
+	}
+	/* Completion marker */
+	if(ip_ecc_cmdq_push(IPECC_CMDQ_KIND_DONE, 0, tag)){
+		goto err;
 	}
+	ip_ecc_cmdq_res_pending += nbres;
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Return (out_x, out_y) = -(x, y) i.e the opposite of the
- * intput point.
- *
- * All size arguments (*_sz) must be given in bytes.
+/* Retrieve the result of the oldest [k]P computation enqueued with
+ * hw_driver_cmdq_push_mul() (polls until it is available, or gives up
+ * after some time).
  *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+ * The coordinates are unmasked with the token that was read back by
+ * the IP at the start of the same computation. The tag given at enqueue
+ * time is returned in 'tag' (if not NULL).
  */
-int hw_driver_neg(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+int hw_driver_cmdq_pop_mul(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+		uint32_t *tag)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
+	uint32_t nn_size, nn_sz, status, err, nbres;
+	uint32_t watchdog = 0;
+	bool timeout = true;
+
+	/* 32768 bits are more than enough for any practical
+	 * use of elliptic curve cryptography (see hw_driver_mul()).
+	 */
+	uint8_t token[4096] = {0, };
 
 	if(driver_setup()){
+		log_print("In hw_driver_cmdq_pop_mul(): Error in driver_setup()\n\r");
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	nn_size = ip_ecc_nn_words_from_bytes_sz(nn_sz);
+
+	if((nn_sz > 4096) || ((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		log_print("In hw_driver_cmdq_pop_mul(): Error in sizes' comparison\n\r");
 		goto err;
 	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+	/* Token, XR1, YR1, tag & status */
+	nbres = (3 * nn_size) + 2;
+	if(ip_ecc_cmdq_res_pending < nbres){
+		log_print("In hw_driver_cmdq_pop_mul(): no [k]P pending in the command queue\n\r");
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+	while (watchdog < 0x1000000U) /* quite arbitrary */
+	{
+		if (IPECC_CMDQ_GET_RES_COUNT() >= nbres) {
+			timeout = false;
+			break;
+		}
+		watchdog++;
+	}
+	if (timeout) {
+		log_print("In hw_driver_cmdq_pop_mul(): timeout while waiting for the result "
+				"(is the queue enabled?)\n\r");
 		goto err;
 	}
+	ip_ecc_cmdq_res_pending -= nbres;
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+	if(ip_ecc_cmdq_pop_bignum(token, nn_sz, nn_size)){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	if(ip_ecc_cmdq_pop_bignum(out_x, (*out_x_sz), nn_size)){
 		goto err;
 	}
-
-	/* Execute our NEG command */
-	if(ip_ecc_exec_command(PT_NEG, NULL, NULL, NULL, NULL)){
+	if(ip_ecc_cmdq_pop_bignum(out_y, (*out_y_sz), nn_size)){
 		goto err;
 	}
+	if(tag != NULL){
+		(*tag) = (uint32_t)IPECC_CMDQ_POP_RESULT();
+	} else {
+		(void)IPECC_CMDQ_POP_RESULT();
+	}
+	status = (uint32_t)IPECC_CMDQ_POP_RESULT();
 
-	/* Get back the result from R1 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+	/* Unmask the [k]P result coordinates with the one-shot token */
+	if (ip_ecc_unmask_with_token(out_x, (*out_x_sz), token, nn_sz, out_x, out_x_sz)) {
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+	if (ip_ecc_unmask_with_token(out_y, (*out_y_sz), token, nn_sz, out_y, out_y_sz)) {
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+	ip_ecc_clear_token(token, nn_sz);
+
+	/* Errors raised while replaying the computation (snapshot of R_STATUS) */
+	err = (status >> IPECC_R_STATUS_ERRID_POS) & IPECC_R_STATUS_ERRID_MSK;
+	if(err){
+		log_print("In hw_driver_cmdq_pop_mul(): error flags 0x%x\n\r", err);
+		IPECC_ACK_ERROR(err);
 		goto err;
 	}
 
@@ -7619,64 +9675,70 @@ err:
 	return -1;
 }
 
-/* Return (out_x, out_y) = 2 * (x, y), i.e the double of the
- * input point.
- *
- * All size arguments (*_sz) must be given in bytes.
- *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+/* Get the nb of cycles during which the command queue had an entry ready
+ * to be replayed and the IP was idle, but the entry could not be issued
+ * (starvation of random for the masking of the scalar, or concurrent AXI
+ * accesses from software). Counter is cleared by hw_driver_cmdq_flush().
  */
-int hw_driver_dbl(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+int hw_driver_cmdq_get_idle_cycles(uint32_t *cycles)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
-
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
-		goto err;
-	}
+	(*cycles) = (uint32_t)IPECC_CMDQ_GET_IDLE_CYCLES();
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
-		goto err;
-	}
+	return 0;
+err:
+	return -1;
+}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+/* Set the windows of the memory-mapped to AXI-Stream bridge connected
+ * to the AXI-Stream ports of the IP (only if the IP was synthesized with
+ * 'axistream' = TRUE).
+ *
+ * Once set, all big numbers (curve parameters, point coordinates, scalar
+ * & token) are transferred as word bursts through these windows instead
+ * of one polled register access per word. Passing two NULL pointers
+ * reverts to W_WRITE_DATA/R_READ_DATA.
+ */
+int hw_driver_set_axis_window(volatile uint8_t *tx, volatile uint8_t *rx)
+{
+	if(driver_setup()){
 		goto err;
 	}
 
-	/* Execute our DBL command */
-	if(ip_ecc_exec_command(PT_DBL, NULL, NULL, NULL, NULL)){
+	if(((tx != NULL) || (rx != NULL)) && (!IPECC_IS_AXIS_SUPPORTED())){
+		log_print("In hw_driver_set_axis_window(): no AXI-Stream port in hardware\n\r");
 		goto err;
 	}
 
-	/* Get back the result from R1 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+	ipecc_axis_tx = (volatile ip_ecc_word*)tx;
+	ipecc_axis_rx = (volatile ip_ecc_word*)rx;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Read 'out_sz' bytes of random produced by the IP TRNG (only if the IP
+ * was synthesized with 'trngexport' = TRUE, in HW unsecure mode).
+ *
+ * Random words are taken from the FIFO which otherwise serves the masking
+ * of the scalar (a word is never both read by software and used by the IP).
+ */
+int hw_driver_get_random(uint8_t *out, uint32_t out_sz)
+{
+	if(driver_setup()){
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+
+	if(!IPECC_IS_TRNGEXP_SUPPORTED()){
+		log_print("In hw_driver_get_random(): no random export in hardware\n\r");
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+
+	if(ip_ecc_get_random(out, out_sz)){
 		goto err;
 	}
 
@@ -7685,228 +9747,250 @@ err:
 	return -1;
 }
 
-
-/* Return (out_x, out_y) = (x1, y1) + (x2, y2), i.e perform addition
- * of the two input points.
+/* Enable the DMA engine (only if the IP was instanciated through top-level
+ * 'ecc_dma').
  *
- * All size arguments (*_sz) must be given in bytes.
+ * The DMA-able buffer is acquired from the platform layer (see
+ * hw_driver_dma_buffer()) on first call, and the ring is sized so that
+ * the buffer holds its descriptors & the data areas of all its slots for
+ * the current value of 'nn' (hence the engine must be enabled again
+ * after any change of 'nn').
  *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+ * Once enabled, the engine processes the jobs enqueued with
+ * hw_driver_dma_push_mul() without any CPU intervention, and raises one
+ * IRQ every 'irq_thr' completions (a value of 0 is understood as 1) or
+ * when the ring gets empty.
+ *
+ * Watch-out: while the engine is processing jobs it owns the register
+ * bank of the IP, and any access to it from software receives an error
+ * response. Hence no other function of this driver should be called until
+ * all the jobs enqueued have been retrieved with hw_driver_dma_pop_mul()
+ * (or until hw_driver_dma_disable() has returned).
  */
-int hw_driver_add(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
-                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+int hw_driver_dma_enable(uint32_t irq_thr)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
+	volatile uint8_t *virt;
+	uint32_t lg, words;
 
 	if(driver_setup()){
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
-		goto err;
+	if(ip_ecc_dma_buf == NULL){
+		if(hw_driver_dma_buffer(&virt, &ip_ecc_dma_phys, &ip_ecc_dma_sz)){
+			log_print("In hw_driver_dma_enable(): no DMA-able buffer\n\r");
+			goto err;
+		}
+		ip_ecc_dma_buf = (ip_ecc_word*)virt;
 	}
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+#if defined(WITH_EC_HW_ACCELERATOR_WORD32)
+	/* Pointers in descriptors are one word */
+	if((ip_ecc_dma_phys + ip_ecc_dma_sz) > (((uint64_t)1) << 32)){
+		log_print("In hw_driver_dma_enable(): DMA-able buffer out of reach\n\r");
 		goto err;
 	}
-	/* Write our R1 register */
-	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
-		goto err;
+#endif
+
+	/* Stop the engine before reconfiguring it */
+	IPECC_DMA_SET_CTRL(0, 0);
+	while(IPECC_IS_DMA_ACTIVE()){};
+
+	/* Cached, as the register bank of the IP is not accessible to software
+	 * while the engine is processing jobs */
+	ip_ecc_dma_nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	ip_ecc_dma_nn_size = ip_ecc_nn_words_from_bytes_sz(ip_ecc_dma_nn_sz);
+
+	/* Largest ring that fits in the buffer */
+	words = ip_ecc_dma_sz / sizeof(ip_ecc_word);
+	for(lg = IPECC_DMA_RING_LOG_MAX; lg > 0; lg--){
+		if(((uint64_t)(IPECC_DMA_DESC_WORDS + IPECC_DMA_SLOT_WORDS()) << lg) <= words){
+			break;
+		}
 	}
-	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+	if(lg == 0){
+		/* A ring of 1 descriptor can't hold any job */
+		log_print("In hw_driver_dma_enable(): DMA-able buffer too small\n\r");
 		goto err;
 	}
+	ip_ecc_dma_lg = lg;
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+	IPECC_DMA_SET_RING(ip_ecc_dma_bus_addr(0), lg);
+	/* Consumer index is never reset by hardware (except by the reset of
+	 * the IP) so start from where the engine currently stands */
+	ip_ecc_dma_tail = ip_ecc_dma_pop = (uint32_t)IPECC_DMA_GET_HEAD() & IPECC_DMA_RING_MASK();
+	IPECC_DMA_SET_TAIL(ip_ecc_dma_tail);
+	IPECC_DMA_ACK_IRQ();
+	IPECC_DMA_SET_CTRL(1, irq_thr);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Disable the DMA engine (the job being processed, if any, is completed,
+ * others stay in the ring).
+ */
+int hw_driver_dma_disable(void)
+{
+	if(driver_setup()){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+
+	IPECC_DMA_SET_CTRL(0, 0);
+	while(IPECC_IS_DMA_ACTIVE()){};
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Enqueue a complete [k]P computation into the ring of the DMA engine:
+ * (x, y) is the point to be multiplied (it can't be the point at infinity,
+ * use hw_driver_mul() for that) and 'tag' is an arbitrary value which
+ * hw_driver_dma_pop_mul() will give back along with the result.
+ *
+ * This function only writes to memory & to the register bank of the DMA
+ * engine. Results must be retrieved, in the same order, with
+ * hw_driver_dma_pop_mul().
+ */
+int hw_driver_dma_push_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+		const uint8_t *scalar, uint32_t scalar_sz, uint32_t tag)
+{
+	uint32_t d, data, nn_size, next;
+
+	if(ip_ecc_dma_buf == NULL){
+		log_print("In hw_driver_dma_push_mul(): DMA engine not enabled\n\r");
 		goto err;
 	}
 
-	/* Execute our ADD command */
-	if(ip_ecc_exec_command(PT_ADD, NULL, NULL, NULL, NULL)){
+	nn_size = ip_ecc_dma_nn_size;
+	next = (ip_ecc_dma_tail + 1) & IPECC_DMA_RING_MASK();
+	if(next == ip_ecc_dma_pop){
+		log_print("In hw_driver_dma_push_mul(): ring is full, pop results first\n\r");
 		goto err;
 	}
 
-	/* Get back the result from R1 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+	d = ip_ecc_dma_desc_off(ip_ecc_dma_tail);
+	data = ip_ecc_dma_data_off(ip_ecc_dma_tail);
+
+	/* Operands */
+	if(ip_ecc_dma_put_bignum(data, scalar, scalar_sz, nn_size)){
+		log_print("In hw_driver_dma_push_mul(): Error in ip_ecc_dma_put_bignum()\n\r");
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+	if(ip_ecc_dma_put_bignum(data + nn_size, x, x_sz, nn_size)){
+		log_print("In hw_driver_dma_push_mul(): Error in ip_ecc_dma_put_bignum()\n\r");
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+	if(ip_ecc_dma_put_bignum(data + (2 * nn_size), y, y_sz, nn_size)){
+		log_print("In hw_driver_dma_push_mul(): Error in ip_ecc_dma_put_bignum()\n\r");
 		goto err;
 	}
 
+	/* Descriptor (R1 holds the point, hence is not null) */
+	IPECC_SET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_CTRL],
+			(0 & IPECC_DMA_DESC_OP_MSK) << IPECC_DMA_DESC_OP_POS); /* [k]P */
+	IPECC_SET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_K], ip_ecc_dma_bus_addr(data));
+	IPECC_SET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_P0], ip_ecc_dma_bus_addr(data + nn_size));
+	IPECC_SET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_P1], 0);
+	IPECC_SET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_RES],
+			ip_ecc_dma_bus_addr(data + (3 * nn_size)));
+	IPECC_SET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_TAG], tag);
+
+	/* Make the descriptor visible to the engine before handing it over */
+	__sync_synchronize();
+	ip_ecc_dma_tail = next;
+	IPECC_DMA_SET_TAIL(ip_ecc_dma_tail);
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Return (out_x, out_y) = scalar * (x, y), i.e perform the scalar 
- * multiplication of the input point by the input scalar.
- *
- * All size arguments (*_sz) must be given in bytes.
+/* Retrieve the result of the oldest [k]P computation enqueued with
+ * hw_driver_dma_push_mul() (polls the descriptor until the engine has
+ * marked it as done).
  *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+ * The coordinates are unmasked with the token that was read back by
+ * the engine at the start of the same computation. The tag given at
+ * enqueue time is returned in 'tag' (if not NULL).
  */
-int hw_driver_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                  const uint8_t *scalar, uint32_t scalar_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
-									uint32_t* kp_time, uint32_t* zmask, kp_trace_info_t* ktrc)
+int hw_driver_dma_pop_mul(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+		uint32_t *tag)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
+	uint32_t d, res, nn_size, nn_sz, status, err;
 
 	/* 32768 bits are more than enough for any practical
-	 * use of elliptic curve cryptography.
-	 */
-	uint8_t token[4096] = {0, }; /* Heck, a whole page? Yes indeed. */
-
-	if(driver_setup()){
-		log_print("In hw_driver_mul(): Error in driver_setup()\n\r");
-		goto err;
-	}
-
-	/* Nb of bytes corresponding to current value of 'nn' in the IP.
-	 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-
-	/* Check that the current value of 'nn' does not exceed the size
-	 * allocated to the token on the stack.
+	 * use of elliptic curve cryptography (see hw_driver_mul()).
 	 */
-	if(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()) > 4096){
-		log_print("In hw_driver_mul(): Error in ip_ecc_nn_bytes_from_bits_sz()\n\r");
-		goto err;
-	}
+	uint8_t token[4096] = {0, };
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_get_r0_inf()\n\r");
+	if(ip_ecc_dma_buf == NULL){
+		log_print("In hw_driver_dma_pop_mul(): DMA engine not enabled\n\r");
 		goto err;
 	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_get_r1_inf()\n\r");
+	if(ip_ecc_dma_pop == ip_ecc_dma_tail){
+		log_print("In hw_driver_dma_pop_mul(): no job in the ring\n\r");
 		goto err;
 	}
 
-	/* Get the random one-shot token */
-	if (ip_ecc_get_token(token, nn_sz)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_get_token()\n\r");
+	nn_sz = ip_ecc_dma_nn_sz;
+	nn_size = ip_ecc_dma_nn_size;
+	if((nn_sz > 4096) || ((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		log_print("In hw_driver_dma_pop_mul(): Error in sizes' comparison\n\r");
 		goto err;
 	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
 
-	/* Write our scalar register with the scalar k */
-	if(ip_ecc_write_bignum(scalar, scalar_sz, EC_HW_REG_SCALAR)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
-		goto err;
-	}
-	/* Write our R1 register with the point to be multiplied */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R1_X)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R1_Y)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
-		goto err;
-	}
+	d = ip_ecc_dma_desc_off(ip_ecc_dma_pop);
+	res = ip_ecc_dma_data_off(ip_ecc_dma_pop) + (3 * nn_size);
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_set_r0_inf()\n\r");
-		goto err;
-	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_set_r1_inf()\n\r");
-		goto err;
+	/* Wait for the engine to be done with the job */
+	while(!(IPECC_GET_REG(&ip_ecc_dma_buf[d + IPECC_DMA_DESC_CTRL]) & IPECC_DMA_DESC_DONE)){
+		if(IPECC_IS_DMA_BUSERR()){
+			log_print("In hw_driver_dma_pop_mul(): bus error in DMA engine\n\r");
+			goto err;
+		}
 	}
+	__sync_synchronize();
 
-	/* Execute our [k]P command */
-	if(ip_ecc_exec_command(PT_KP, NULL, kp_time, zmask, ktrc)) {
-		log_print("In hw_driver_mul(): Error in ip_ecc_exec_command()\n\r");
+	if(ip_ecc_dma_get_bignum(out_x, (*out_x_sz), res, nn_size)){
 		goto err;
 	}
-
-	/* Get back the result from R1 */
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
-		log_print("In hw_driver_mul(): *out_x_sz = %d\n\r", *out_x_sz);
-		log_print("In hw_driver_mul(): *out_y_sz = %d\n\r", *out_y_sz);
-		log_print("In hw_driver_mul(): nn_sz = %d\n\r", nn_sz);
-		log_print("In hw_driver_mul(): Error in sizes' comparison\n\r");
+	if(ip_ecc_dma_get_bignum(out_y, (*out_y_sz), res + nn_size, nn_size)){
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_read_bignum()\n\r");
+	if(ip_ecc_dma_get_bignum(token, nn_sz, res + (2 * nn_size), nn_size)){
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_read_bignum()\n\r");
-		goto err;
+	status = (uint32_t)IPECC_GET_REG(&ip_ecc_dma_buf[res + (3 * nn_size)]);
+	if(tag != NULL){
+		(*tag) = (uint32_t)IPECC_GET_REG(&ip_ecc_dma_buf[res + (3 * nn_size) + 1]);
 	}
+	ip_ecc_dma_pop = (ip_ecc_dma_pop + 1) & IPECC_DMA_RING_MASK();
 
 	/* Unmask the [k]P result coordinates with the one-shot token */
 	if (ip_ecc_unmask_with_token(out_x, (*out_x_sz), token, nn_sz, out_x, out_x_sz)) {
-		log_print("In hw_driver_mul(): Error in ip_ecc_unmask_with_token()\n\r");
 		goto err;
 	}
 	if (ip_ecc_unmask_with_token(out_y, (*out_y_sz), token, nn_sz, out_y, out_y_sz)) {
-		log_print("In hw_driver_mul(): Error in ip_ecc_unmask_with_token()\n\r");
 		goto err;
-	};
-
-	/* Clear the token */
+	}
 	ip_ecc_clear_token(token, nn_sz);
 
-	return 0;
-err:
-	return -1;
-}
-
-/* Set the small scalar size in the hardware.
- *
- * The 'small scalar size' feature is provided by the IP in order
- * to provide a computation speed-up for really small scalar.
- *
- * This is a "one shot" feature, meaning the 'nn' parameter is
- * still recorded by the IP and will become applicable again
- * as soon as the scalar multiplication following the call to
- * function hw_driver_set_small_scalar_size() is done.
- *
- * Hence hw_driver_set_small_scalar_size() must be called
- * each time the feature is needed.
- *
- * Obviously this feature only concerns the scalar multiplication.
- * */
-int hw_driver_set_small_scalar_size(uint32_t bit_sz)
-{
-	if(driver_setup()){
+	/* Errors raised during the computation (snapshot of R_STATUS, errors
+	 * were already acknowledged by the engine) */
+	err = (status >> IPECC_R_STATUS_ERRID_POS) & IPECC_R_STATUS_ERRID_MSK;
+	if(err){
+		log_print("In hw_driver_dma_pop_mul(): error flags 0x%x\n\r", err);
 		goto err;
 	}
 
-	/* NOTE: sanity check on this size should be performed by
-	 * the hardware (e.g. is this size exceeds the nn size, and
-	 * so on). So no need to sanity check anything here. */
-	IPECC_SET_SMALL_SCALAR_SIZE(bit_sz);
+	/* All results retrieved: acknowledge the coalesced IRQ */
+	if(ip_ecc_dma_pop == ip_ecc_dma_tail){
+		IPECC_DMA_ACK_IRQ();
+	}
 
 	return 0;
 err:
@@ -0,0 +1,441 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Continuous health tests over the raw random bits of the TRNG, in the
+ * spirit of NIST SP 800-90B section 4.4 (binary source):
+ *
+ *   - Repetition Count Test (RCT), cutoff C = 1 + ceil(20 / H)
+ *   - Adaptive Proportion Test (APT), window W = 1024, cutoff
+ *     C = 1 + CRITBINOM(W, 2^-H, 1 - 2^-20)
+ *
+ * where H is the min-entropy per raw bit claimed for the entropy source
+ * (false positive probability alpha = 2^-20 for both tests), plus running
+ * estimates of the bias and of the autocorrelation at lags 1 to
+ * TRNG_HEALTH_LAGS.
+ *
+ * Raw bits are consumed packed into 32-bit words (bit i of a sequence
+ * is bit (i % 32) of word i / 32) and all tests work word-wise with
+ * population counts, never bit by bit.
+ *
+ * On Linux targets a background thread can be started which acquires
+ * windows of raw bits from the IP (see hw_driver_get_trng_raw_window_DBG())
+ * and feeds them to the tests, using one window-sized buffer only. It is
+ * meant for characterization while the IP is otherwise idle (bench, or
+ * idle time of a product in HW unsecure mode): the post-processing of the
+ * TRNG is disabled during each acquisition and the IP can't be used for
+ * computations meanwhile, and windows are tested one after the other,
+ * not as a continuous stream of all raw bits produced.
+ */
+
+#include "hw_accelerator_driver.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(WITH_EC_HW_ACCELERATOR) && !defined(WITH_EC_HW_SOCKET_EMUL)
+
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM)
+#define HLT_THREAD
+#include <pthread.h>
+#include <time.h>
+static pthread_mutex_t hlt_mtx = PTHREAD_MUTEX_INITIALIZER;
+#define HLT_LOCK()    pthread_mutex_lock(&hlt_mtx)
+#define HLT_UNLOCK()  pthread_mutex_unlock(&hlt_mtx)
+#else
+#define HLT_LOCK()    do {} while (0)
+#define HLT_UNLOCK()  do {} while (0)
+#endif
+
+/* Window size of the APT, in 32-bit words (W = 1024 bits) */
+#define HLT_APT_WORDS    32
+
+/* Internal state of the tests */
+static struct {
+	bool init;
+	/* RCT: value & length of the current run of identical bits */
+	uint32_t run_bit;
+	uint32_t run_len;
+	/* lags: last word of the current contiguous sequence */
+	bool has_prev;
+	uint32_t prev;
+	/* APT: nb of words of the current window & count of its first bit */
+	uint32_t apt_nw;
+	uint32_t apt_ref;
+	uint32_t apt_cnt;
+	trng_health_t cnt;
+} hlt;
+
+static inline uint32_t hlt_popcnt(uint32_t w)
+{
+	return (uint32_t)__builtin_popcount(w);
+}
+
+/* 2^x for x in [-1, 0] (Taylor series of exp, to avoid depending on libm) */
+static double hlt_exp2(double x)
+{
+	double y = x * 0.69314718055994530942, t = 1., s = 1.;
+	uint32_t i;
+
+	for (i = 1; i < 32; i++) {
+		t *= y / (double)i;
+		s += t;
+	}
+	return s;
+}
+
+/* Cutoff of the APT for a binary source: 1 + CRITBINOM(W, p, 1 - 2^-20)
+ * with p = 2^-H. The binomial distribution is computed by ratios around
+ * its mode (to remain in range of doubles) then normalized.
+ */
+static uint32_t hlt_apt_cutoff(double h)
+{
+	static double pmf[(HLT_APT_WORDS * 32) + 1];
+	const uint32_t w = HLT_APT_WORDS * 32;
+	double p = hlt_exp2(-h), r = p / (1. - p), sum, cdf;
+	uint32_t k, m;
+
+	m = (uint32_t)((double)(w + 1) * p);
+	if (m > w) {
+		m = w;
+	}
+	pmf[m] = 1.;
+	sum = 1.;
+	for (k = m; k < w; k++) {
+		pmf[k + 1] = pmf[k] * ((double)(w - k) / (double)(k + 1)) * r;
+		sum += pmf[k + 1];
+	}
+	for (k = m; k > 0; k--) {
+		pmf[k - 1] = pmf[k] * ((double)k / (double)(w - k + 1)) / r;
+		sum += pmf[k - 1];
+	}
+	for (k = 0, cdf = 0.; k < w; k++) {
+		cdf += pmf[k] / sum;
+		if (cdf >= (1. - (1. / (double)(1UL << 20)))) {
+			break;
+		}
+	}
+	return k + 1;
+}
+
+/* Close the current run of identical bits (RCT) */
+static inline void hlt_rct_close(void)
+{
+	if (hlt.run_len > hlt.cnt.rct_max) {
+		hlt.cnt.rct_max = hlt.run_len;
+	}
+	if (hlt.run_len >= hlt.cnt.rct_cutoff) {
+		hlt.cnt.rct_fail++;
+	}
+	hlt.run_len = 0;
+}
+
+/* End of a contiguous sequence: pending run is closed, a pending
+ * (incomplete) APT window is dropped */
+static void hlt_break(void)
+{
+	if (hlt.run_len) {
+		hlt_rct_close();
+	}
+	hlt.has_prev = false;
+	hlt.apt_nw = 0;
+}
+
+/* RCT kernel: only transitions between bits are visited (count trailing
+ * zeros), so a word costs one iteration per change of value, not 32 */
+static void hlt_rct(const uint32_t* words, uint32_t nbw)
+{
+	uint32_t i, w, t, pos, bit;
+
+	for (i = 0; i < nbw; i++) {
+		w = words[i];
+		if (hlt.run_len == 0) {
+			hlt.run_bit = w & 0x1;
+		}
+		/* bit j of t is set if bit j of w differs from the preceding bit */
+		t = w ^ ((w << 1) | hlt.run_bit);
+		pos = 0;
+		while (t) {
+			bit = (uint32_t)__builtin_ctz(t);
+			hlt.run_len += bit - pos;
+			hlt_rct_close();
+			pos = bit;
+			t &= t - 1;
+		}
+		hlt.run_len += 32 - pos;
+		hlt.run_bit = w >> 31;
+	}
+}
+
+/* APT kernel: one population count per word of the window */
+static void hlt_apt(const uint32_t* words, uint32_t nbw)
+{
+	uint32_t i;
+
+	for (i = 0; i < nbw; i++) {
+		if (hlt.apt_nw == 0) {
+			hlt.apt_ref = words[i] & 0x1;
+			hlt.apt_cnt = 0;
+		}
+		hlt.apt_cnt += hlt.apt_ref ? hlt_popcnt(words[i]) : 32 - hlt_popcnt(words[i]);
+		if (++hlt.apt_nw == HLT_APT_WORDS) {
+			if (hlt.apt_cnt > hlt.cnt.apt_max) {
+				hlt.cnt.apt_max = hlt.apt_cnt;
+			}
+			if (hlt.apt_cnt >= hlt.cnt.apt_cutoff) {
+				hlt.cnt.apt_fail++;
+			}
+			hlt.cnt.apt_windows++;
+			hlt.apt_nw = 0;
+		}
+	}
+}
+
+/* Bias & autocorrelation kernel: for lag k, bits of word w are XOR'ed
+ * with the bits k positions before (taken from w & from the previous
+ * word), so 32 pairs are compared with one population count */
+static void hlt_bias_lags(const uint32_t* words, uint32_t nbw)
+{
+	uint32_t i, k, w, p, start = 0, ones = 0;
+	uint32_t eq[TRNG_HEALTH_LAGS];
+
+	memset(eq, 0, sizeof(eq));
+	for (i = 0; i < nbw; i++) {
+		ones += hlt_popcnt(words[i]);
+	}
+	hlt.cnt.ones += ones;
+
+	if (!hlt.has_prev && nbw) {
+		/* first word of a sequence: only bits k..31 have a k-predecessor */
+		w = words[0];
+		for (k = 1; k <= TRNG_HEALTH_LAGS; k++) {
+			eq[k - 1] += hlt_popcnt(~(w ^ (w << k)) & (0xffffffffU << k));
+			hlt.cnt.lag_pairs[k - 1] += 32 - k;
+		}
+		hlt.prev = w;
+		hlt.has_prev = true;
+		start = 1;
+	}
+	for (i = start, p = hlt.prev; i < nbw; i++) {
+		w = words[i];
+		for (k = 1; k <= TRNG_HEALTH_LAGS; k++) {
+			eq[k - 1] += 32 - hlt_popcnt(w ^ ((w << k) | (p >> (32 - k))));
+		}
+		p = w;
+	}
+	if (nbw) {
+		hlt.prev = words[nbw - 1];
+	}
+	for (k = 0; k < TRNG_HEALTH_LAGS; k++) {
+		hlt.cnt.lag_equal[k] += eq[k];
+		hlt.cnt.lag_pairs[k] += 32 * (uint64_t)(nbw - start);
+	}
+}
+
+/* (Re-)initialize the health tests for a claimed min-entropy of
+ * 'h_x100' / 100 bits per raw bit (1 to 100) & clear all counters */
+int hw_driver_trng_health_init(uint32_t h_x100)
+{
+	double h;
+
+	if ((h_x100 == 0) || (h_x100 > 100)) {
+		goto err;
+	}
+	h = (double)h_x100 / 100.;
+
+	HLT_LOCK();
+	memset(&hlt, 0, sizeof(hlt));
+	hlt.cnt.rct_cutoff = 1 + ((2000 + h_x100 - 1) / h_x100);
+	hlt.cnt.apt_cutoff = hlt_apt_cutoff(h);
+	hlt.init = true;
+	HLT_UNLOCK();
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Feed 'nbbits' raw random bits packed into 'words' to the health tests
+ *
+ *   If 'cont' is true the bits are the continuation of the ones of the
+ *   previous call, otherwise they start a new contiguous sequence.
+ *
+ *   'nbbits' must be a multiple of 32 (trailing bits are ignored).
+ */
+int hw_driver_trng_health_feed(const uint32_t* words, uint32_t nbbits, bool cont)
+{
+	uint32_t nbw = nbbits / 32;
+
+	if (!hlt.init) {
+		goto err;
+	}
+
+	HLT_LOCK();
+	if (!cont) {
+		hlt_break();
+	}
+	hlt_rct(words, nbw);
+	hlt_apt(words, nbw);
+	hlt_bias_lags(words, nbw);
+	hlt.cnt.bits += (uint64_t)nbw * 32;
+	HLT_UNLOCK();
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Get a snapshot of the counters of the health tests */
+int hw_driver_trng_health_get(trng_health_t* cnt)
+{
+	if (!hlt.init) {
+		goto err;
+	}
+
+	HLT_LOCK();
+	memcpy(cnt, &hlt.cnt, sizeof(trng_health_t));
+	HLT_UNLOCK();
+
+	return 0;
+err:
+	return -1;
+}
+
+#if defined(HLT_THREAD)
+
+static pthread_t hlt_tid;
+static bool hlt_running = false;
+static bool hlt_stop = false;
+static uint32_t* hlt_buf = NULL;
+
+static inline uint64_t hlt_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void* hlt_thread(void* arg)
+{
+	uint32_t nbbits, duration;
+	uint64_t t0, t1, t2;
+	bool stop;
+
+	(void)arg;
+	for (;;) {
+		HLT_LOCK();
+		stop = hlt_stop;
+		HLT_UNLOCK();
+		if (stop) {
+			break;
+		}
+		t0 = hlt_ns();
+		if (hw_driver_get_trng_raw_window_DBG(hlt_buf, &nbbits, &duration)) {
+			HLT_LOCK();
+			hlt.cnt.acq_errors++;
+			HLT_UNLOCK();
+			continue;
+		}
+		t1 = hlt_ns();
+		/* Windows are not contiguous with one another */
+		hw_driver_trng_health_feed(hlt_buf, nbbits, false);
+		t2 = hlt_ns();
+		HLT_LOCK();
+		hlt.cnt.windows++;
+		hlt.cnt.raw_cycles += duration;
+		hlt.cnt.acq_ns += t1 - t0;
+		hlt.cnt.test_ns += t2 - t1;
+		HLT_UNLOCK();
+	}
+	return NULL;
+}
+
+/* Start the background thread acquiring & testing raw random bits
+ * (hw_driver_trng_health_init() must have been called first)
+ *
+ * This is an offline/idle-time tool: while it runs no other function of
+ * the driver must be called but hw_driver_trng_health_get() (each window
+ * acquisition disables the post-processing of the TRNG).
+ * (only in HW unsecure mode)
+ */
+int hw_driver_trng_health_start_DBG(void)
+{
+	uint32_t ww, nbop, opsz, rawramsz, irnshw;
+
+	if ((!hlt.init) || hlt_running) {
+		goto err;
+	}
+	if (hw_driver_get_more_capabilities_DBG(&ww, &nbop, &opsz, &rawramsz, &irnshw)) {
+		goto err;
+	}
+	if ((rawramsz < 32) || ((hlt_buf = malloc((rawramsz / 32) * sizeof(uint32_t))) == NULL)) {
+		goto err;
+	}
+	hlt_stop = false;
+	if (pthread_create(&hlt_tid, NULL, hlt_thread, NULL)) {
+		free(hlt_buf);
+		hlt_buf = NULL;
+		goto err;
+	}
+	hlt_running = true;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Stop the background thread (returns once it has completed the
+ * acquisition/test of its current window) */
+int hw_driver_trng_health_stop_DBG(void)
+{
+	if (!hlt_running) {
+		goto err;
+	}
+	HLT_LOCK();
+	hlt_stop = true;
+	HLT_UNLOCK();
+	pthread_join(hlt_tid, NULL);
+	free(hlt_buf);
+	hlt_buf = NULL;
+	hlt_running = false;
+
+	return 0;
+err:
+	return -1;
+}
+
+#else
+
+int hw_driver_trng_health_start_DBG(void)
+{
+	return -1;
+}
+
+int hw_driver_trng_health_stop_DBG(void)
+{
+	return -1;
+}
+
+#endif /* HLT_THREAD */
+
+#else
+/*
+ * Dummy definition to avoid the empty translation unit ISO C warning
+ */
+typedef int dummy;
+#endif /* WITH_EC_HW_ACCELERATOR */
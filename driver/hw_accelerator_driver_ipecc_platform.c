@@ -72,6 +72,20 @@
   #endif
 #endif
 
+/* DMA-able buffer for the DMA engine of top-level 'ecc_dma'.
+ *
+ * In standalone mode this is a static buffer (the linker script or the MMU
+ * setup must make it non-cacheable, or caches must be flushed/invalidated
+ * around its accesses). Under Linux it is provided by the 'u-dma-buf' kernel
+ * module (or any CMA-backed equivalent exposing the same interface), which
+ * exports the physical address & the size of the buffer through sysfs.
+ */
+#ifndef IPECC_DMA_BUF_SZ
+#define IPECC_DMA_BUF_SZ                (65536)
+#endif
+#define IPECC_DEV_UDMABUF               "/dev/udmabuf0"
+#define IPECC_SYS_UDMABUF               "/sys/class/u-dma-buf/udmabuf0"
+
 /* Setup the driver depending on the environment.
  *
  * If 'pseudotrng_base_addr_p' is not NULL then the setup will also try
@@ -225,6 +239,94 @@ err:
 	return ret;
 }
 
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM)
+/* Read one numerical attribute of the udmabuf device from sysfs */
+static int hw_driver_udmabuf_attr(const char *attr, uint64_t *val)
+{
+	char path[128], buf[32];
+	ssize_t n;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/%s", IPECC_SYS_UDMABUF, attr);
+	fd = open(path, O_RDONLY);
+	if(fd == -1){
+		printf("Error when opening %s\n\r", path);
+		perror("open udmabuf attribute");
+		return -1;
+	}
+	n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if(n <= 0){
+		return -1;
+	}
+	buf[n] = 0;
+	/* base 0: 'phys_addr' is in hex (0x prefix), 'size' in decimal */
+	(*val) = strtoull(buf, NULL, 0);
+
+	return 0;
+}
+#endif
+
+int hw_driver_dma_buffer(volatile uint8_t **virt_p, uint64_t *phys_p, uint32_t *size_p)
+{
+	int ret = -1;
+
+	if((virt_p == NULL) || (phys_p == NULL) || (size_p == NULL)){
+		ret = -1;
+		goto err;
+	}
+#if defined(WITH_EC_HW_STANDALONE)
+	{
+		static uint8_t dma_buf[IPECC_DMA_BUF_SZ] __attribute__((aligned(64)));
+
+		(*virt_p) = dma_buf;
+		(*phys_p) = (uint64_t)(uintptr_t)dma_buf;
+		(*size_p) = IPECC_DMA_BUF_SZ;
+	}
+#else
+	{
+		int dma_fd;
+		uint64_t phys, size;
+		void *base_address;
+
+		if(hw_driver_udmabuf_attr("phys_addr", &phys)
+				|| hw_driver_udmabuf_attr("size", &size)){
+			ret = -1;
+			goto err;
+		}
+		if(size > 0xffffffff){
+			size = 0xffffffff;
+		}
+		/* NOTE: O_SYNC here to get a non-cached mapping */
+		dma_fd = open(IPECC_DEV_UDMABUF, O_RDWR | O_SYNC);
+		if(dma_fd == -1){
+			printf("Error when opening %s\n\r", IPECC_DEV_UDMABUF);
+			perror("open udmabuf");
+			ret = -1;
+			goto err;
+		}
+		base_address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, dma_fd, 0);
+		/* The mapping (if any) stays valid once the file is closed */
+		close(dma_fd);
+		if(base_address == MAP_FAILED){
+			printf("Error during udmabuf mmap!\n\r");
+			perror("mmap udmabuf");
+			ret = -1;
+			goto err;
+		}
+		(*virt_p) = base_address;
+		(*phys_p) = phys;
+		(*size_p) = (uint32_t)size;
+	}
+#endif
+	log_print("OK, DMA-able buffer @%p (bus address 0x%llx, %u bytes)\n\r",
+			(void*)(*virt_p), (unsigned long long)(*phys_p), (*size_p));
+
+	ret = 0;
+err:
+	return ret;
+}
+
 #else
 /*
  * Dummy definition to avoid the empty translation unit ISO C warning
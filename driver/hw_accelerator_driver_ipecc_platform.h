@@ -73,6 +73,12 @@
  */
 int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p);
 
+/* Get a DMA-able buffer (physically contiguous & not cached) for the DMA
+ * engine of top-level 'ecc_dma': its virtual address, its bus address
+ * and its size in bytes.
+ */
+int hw_driver_dma_buffer(volatile uint8_t **virt_p, uint64_t *phys_p, uint32_t *size_p);
+
 #endif /* WITH_EC_HW_ACCELERATOR */
 
 #endif /* __HW_ACCELERATOR_DRIVER_PLATFORM_H__ */
@@ -0,0 +1,332 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Deterministic replay of the raw random source of the IP (HW unsecure
+ * mode only) through the pseudo TRNG device (hdl/common/pseudo_trng.vhd).
+ *
+ * The post-processing of the TRNG is fed with a given byte sequence in
+ * place of the entropy source, so that all the random the IP consumes
+ * (blinding, shuffling, Z-masking...) is the same from one run to the
+ * next, and so is its timing. The sequence is either:
+ *
+ *   - read from a file in the format of HDL parameter 'simtrngfile'
+ *     (one byte per line, in decimal, see sim/HOWTO-random.txt) so that
+ *     the same file can be replayed in the GHDL testbench (Linux only);
+ *
+ *   - or produced by a seeded PRNG (splitmix64, bytes in little endian
+ *     order), see hw_driver_pseudotrng_prng() and tool
+ *     linux/ecc-trng-seedfile.c which writes the same sequence out
+ *     into a 'simtrngfile' file.
+ *
+ * On Linux targets a background thread keeps the FIFO of the device
+ * filled, otherwise hw_driver_pseudotrng_replay_refill_DBG() must be
+ * called regularly (e.g between two computations).
+ */
+
+#include "hw_accelerator_driver.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(WITH_EC_HW_ACCELERATOR) && !defined(WITH_EC_HW_SOCKET_EMUL)
+
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM)
+#define RPL_THREAD
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#endif
+
+/* Nb of bytes fetched at once from the source */
+#define RPL_CHUNK    4096
+
+static struct {
+	bool active;
+	uint64_t prng;
+#if defined(RPL_THREAD)
+	FILE* fp;
+	pthread_t tid;
+	volatile bool stop;
+	volatile bool err;
+#endif
+	bool eof;
+	uint64_t bytes;
+	uint32_t bufi;
+	uint32_t bufn;
+	uint8_t buf[RPL_CHUNK];
+} rpl;
+
+/* PRNG of the replay (splitmix64): 'sz' bytes are output, each 64-bit
+ * output word being written in little endian order (the last word
+ * possibly truncated) */
+void hw_driver_pseudotrng_prng(uint64_t* state, uint8_t* out, uint32_t sz)
+{
+	uint64_t z;
+	uint32_t i, j;
+
+	for (i = 0; i < sz; ) {
+		*state += 0x9e3779b97f4a7c15ULL;
+		z = *state;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z = z ^ (z >> 31);
+		for (j = 0; (j < 8) && (i < sz); j++, i++) {
+			out[i] = (uint8_t)(z >> (8 * j));
+		}
+	}
+}
+
+/* Fetch the next chunk of bytes from the source
+ * (returns -1 at end of file, nothing fetched) */
+static int rpl_fetch(void)
+{
+	rpl.bufi = 0;
+	rpl.bufn = 0;
+#if defined(RPL_THREAD)
+	if (rpl.fp) {
+		char line[32];
+		unsigned long val;
+
+		while ((rpl.bufn < RPL_CHUNK) && fgets(line, sizeof(line), rpl.fp)) {
+			val = strtoul(line, NULL, 10);
+			if (val > 255) {
+				/* (the testbench stops on such a value as well) */
+				break;
+			}
+			rpl.buf[rpl.bufn++] = (uint8_t)val;
+		}
+		if (rpl.bufn == 0) {
+			rpl.eof = true;
+			return -1;
+		}
+		return 0;
+	}
+#endif
+	hw_driver_pseudotrng_prng(&rpl.prng, rpl.buf, RPL_CHUNK);
+	rpl.bufn = RPL_CHUNK;
+
+	return 0;
+}
+
+/* Push as many bytes as the FIFO of the device has room for */
+static int rpl_refill(uint32_t* total)
+{
+	uint32_t pushed;
+
+	*total = 0;
+	while (!rpl.eof) {
+		if ((rpl.bufi == rpl.bufn) && rpl_fetch()) {
+			break;
+		}
+		if (hw_driver_pseudotrng_push_DBG(rpl.buf + rpl.bufi, rpl.bufn - rpl.bufi, &pushed)) {
+			goto err;
+		}
+		rpl.bufi += pushed;
+		rpl.bytes += pushed;
+		*total += pushed;
+		if (rpl.bufi < rpl.bufn) {
+			/* FIFO is full */
+			break;
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+#if defined(RPL_THREAD)
+static void* rpl_thread(void* arg)
+{
+	uint32_t total;
+
+	(void)arg;
+	while (!rpl.stop) {
+		if (rpl_refill(&total)) {
+			rpl.err = true;
+			break;
+		}
+		if (total == 0) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+#endif
+
+/* Start the replay of a byte sequence as raw random source of the IP
+ *
+ *   If 'simtrngfile' is not NULL the sequence is read from that file
+ *   (Linux only), otherwise it is the output of the PRNG seeded with
+ *   'seed'.
+ *
+ * The FIFOs of internal random numbers of the IP are emptied so that
+ * all random consumed from now on derives from the sequence, from its
+ * first byte. To also reproduce how the IP dispatches it among its
+ * internal FIFOs, leave the IP idle long enough between computations
+ * for these to fill up again.
+ *
+ * (only in HW unsecure mode, and only if the pseudo TRNG device
+ * was instanciated next to the IP)
+ */
+int hw_driver_pseudotrng_replay_start_DBG(const char* simtrngfile, uint64_t seed)
+{
+	uint32_t total;
+
+	if (rpl.active) {
+		goto err;
+	}
+	memset(&rpl, 0, sizeof(rpl));
+	if (simtrngfile) {
+#if defined(RPL_THREAD)
+		if ((rpl.fp = fopen(simtrngfile, "r")) == NULL) {
+			goto err;
+		}
+#else
+		goto err;
+#endif
+	} else {
+		rpl.prng = seed;
+	}
+
+	/* Stall the post-processing while the source is switched & emptied */
+	if (hw_driver_pseudotrng_setup_DBG()) {
+		goto err_close;
+	}
+	if (hw_driver_trng_post_proc_disable_DBG()) {
+		goto err_close;
+	}
+	if (hw_driver_trng_use_pseudo_source_DBG(true)) {
+		goto err_close;
+	}
+	if (hw_driver_pseudotrng_reset_DBG()) {
+		goto err_close;
+	}
+	if (hw_driver_reset_trng_irn_fifos_DBG()) {
+		goto err_close;
+	}
+	if (rpl_refill(&total)) {
+		goto err_close;
+	}
+#if defined(RPL_THREAD)
+	if (pthread_create(&rpl.tid, NULL, rpl_thread, NULL)) {
+		goto err_close;
+	}
+#endif
+	rpl.active = true;
+	if (hw_driver_trng_post_proc_enable_DBG()) {
+		hw_driver_pseudotrng_replay_stop_DBG(NULL, NULL);
+		goto err;
+	}
+
+	return 0;
+
+err_close:
+#if defined(RPL_THREAD)
+	if (rpl.fp) {
+		fclose(rpl.fp);
+		rpl.fp = NULL;
+	}
+#endif
+err:
+	return -1;
+}
+
+/* Top-up the FIFO of the pseudo TRNG device
+ * (only needed when the replay has no background thread) */
+int hw_driver_pseudotrng_replay_refill_DBG(void)
+{
+	uint32_t total;
+
+	if (!rpl.active) {
+		goto err;
+	}
+#if defined(RPL_THREAD)
+	if (rpl.err) {
+		goto err;
+	}
+#else
+	if (rpl_refill(&total)) {
+		goto err;
+	}
+#endif
+	(void)total;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Stop the replay & restore the entropy source of the IP
+ *
+ *   *nbbytes (if not NULL) is the nb of bytes of the sequence pushed
+ *   to the device, *eof (if not NULL) tells if the end of the file
+ *   was reached (in which case the IP may have starved from random).
+ */
+int hw_driver_pseudotrng_replay_stop_DBG(uint64_t* nbbytes, bool* eof)
+{
+	bool err = false;
+
+	if (!rpl.active) {
+		goto err;
+	}
+#if defined(RPL_THREAD)
+	rpl.stop = true;
+	pthread_join(rpl.tid, NULL);
+	err = rpl.err;
+	if (rpl.fp) {
+		fclose(rpl.fp);
+		rpl.fp = NULL;
+	}
+#endif
+	rpl.active = false;
+	if (nbbytes) {
+		*nbbytes = rpl.bytes;
+	}
+	if (eof) {
+		*eof = rpl.eof;
+	}
+
+	/* Don't let random derived from the sequence be used afterwards */
+	if (hw_driver_trng_post_proc_disable_DBG()) {
+		goto err;
+	}
+	if (hw_driver_trng_use_pseudo_source_DBG(false)) {
+		goto err;
+	}
+	if (hw_driver_reset_trng_irn_fifos_DBG()) {
+		goto err;
+	}
+	if (hw_driver_trng_post_proc_enable_DBG()) {
+		goto err;
+	}
+	if (err) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+#else
+/*
+ * Dummy definition to avoid the empty translation unit ISO C warning
+ */
+typedef int dummy;
+#endif /* WITH_EC_HW_ACCELERATOR */
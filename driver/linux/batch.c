@@ -0,0 +1,205 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Curve-affinity batching of tests (option -b of ecc-test-linux).
+ *
+ * Setting a curve in the IP is expensive (transfer of its parameters &
+ * computation of Montgomery constants), and input streams which mix curves
+ * (e.g several vector files concatenated) pay it each time a curve comes
+ * back. Here tests are buffered by windows of 'window' tests, grouped by
+ * curve (same id & same parameters), and each group is executed in a row,
+ * groups being in order of first appearance in the window. A curve is not
+ * set again if it is already the one in the IP (e.g the last one of the
+ * previous window). Results are then checked & reported in the original
+ * order of the tests.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "ecc-test-linux.h"
+
+/* Stages (see ecc-test-linux.c) */
+extern int stage_hw_curve(curve_t*);
+extern int stage_hw_test(ipecc_test_t*);
+extern void stage_chk_test(ipecc_test_t*, all_stats_t*, int, const char*, unsigned int);
+extern void print_stats_and_exit(ipecc_test_t*, all_stats_t*, const char*, unsigned int);
+
+typedef struct {
+	ipecc_test_t test;
+	uint32_t crv;
+	int hwerr;
+	char dbg[DBG_MSG_SZ];
+	unsigned int linenum;
+} batch_test_t;
+
+static batch_test_t* tests = NULL;
+static uint32_t* order;
+static uint32_t* count;
+static curve_t* curves;
+static uint32_t window;
+static uint32_t nbtests = 0;
+static uint32_t nbcurves = 0;
+/* Curve of the tests being parsed (index in 'curves') */
+static uint32_t crv_cur;
+static bool crv_cur_valid = false;
+/* Curve currently set in the IP */
+static curve_t crv_hw;
+static bool crv_hw_valid = false;
+static all_stats_t* bstats;
+
+/* Nb of windows executed, nb of curves not set because already in the IP */
+static uint32_t nbbatches = 0;
+static uint32_t nbsaved = 0;
+
+static bool same_curve(curve_t* c0, curve_t* c1)
+{
+	uint32_t sz = NN_SZ(c0->nn);
+
+	return (c0->id == c1->id) && (c0->nn == c1->nn)
+		&& !memcmp(c0->p.val, c1->p.val, sz) && !memcmp(c0->a.val, c1->a.val, sz)
+		&& !memcmp(c0->b.val, c1->b.val, sz) && !memcmp(c0->q.val, c1->q.val, sz);
+}
+
+int batch_start(uint32_t w, all_stats_t* st)
+{
+	window = w;
+	if (((tests = malloc(window * sizeof(batch_test_t))) == NULL)
+			|| ((order = malloc(window * sizeof(uint32_t))) == NULL)
+			|| ((count = malloc((window + 1) * sizeof(uint32_t))) == NULL)
+			/* One more curve than tests, for the one being parsed */
+			|| ((curves = malloc((window + 1) * sizeof(curve_t))) == NULL)) {
+		printf("%sError: Can't allocate buffers for a window of %d tests.%s\n\r", KERR, window, KNRM);
+		return -1;
+	}
+	bstats = st;
+
+	return 0;
+}
+
+void batch_add_curve(curve_t* crv)
+{
+	uint32_t i;
+
+	for (i = 0; i < nbcurves; i++) {
+		if (same_curve(&curves[i], crv)) {
+			break;
+		}
+	}
+	if (i == nbcurves) {
+		if (nbcurves == (window + 1)) {
+			/* Table full (curves without tests) */
+			batch_flush();
+			i = nbcurves;
+		}
+		memcpy(&curves[nbcurves++], crv, sizeof(curve_t));
+	}
+	crv_cur = i;
+	crv_cur_valid = true;
+}
+
+/*
+ * Execute the tests of the window, grouped by curve, then check
+ * them in the order they were added.
+ */
+void batch_flush(void)
+{
+	uint32_t i, c, n;
+	curve_t* crv;
+	batch_test_t* bt;
+
+	if (nbtests == 0) {
+		goto reset;
+	}
+	nbbatches++;
+	/* Counting sort of tests by curve (stable) */
+	memset(count, 0, (nbcurves + 1) * sizeof(uint32_t));
+	for (i = 0; i < nbtests; i++) {
+		count[tests[i].crv + 1]++;
+	}
+	for (c = 0; c < nbcurves; c++) {
+		count[c + 1] += count[c];
+	}
+	for (i = 0; i < nbtests; i++) {
+		order[count[tests[i].crv]++] = i;
+	}
+	/* Execute them */
+	for (n = 0; n < nbtests; n++) {
+		bt = &tests[order[n]];
+		crv = &curves[bt->crv];
+		if (crv->set_in_hw == false) {
+			if (crv_hw_valid && same_curve(crv, &crv_hw)) {
+				crv->set_in_hw = true;
+				nbsaved++;
+			} else if (stage_hw_curve(crv)) {
+				printf("%sError: Could not transmit curve parameters to driver.%s\n\r", KERR, KNRM);
+				print_stats_and_exit(&bt->test, bstats, bt->dbg, bt->linenum);
+			} else {
+				memcpy(&crv_hw, crv, sizeof(curve_t));
+				crv_hw_valid = true;
+			}
+		}
+		bt->hwerr = stage_hw_test(&bt->test);
+	}
+	/* Check them in original order */
+	for (i = 0; i < nbtests; i++) {
+		stage_chk_test(&tests[i].test, bstats, tests[i].hwerr, tests[i].dbg, tests[i].linenum);
+	}
+reset:
+	/* Only keep the curve being parsed, for the tests to come */
+	if (crv_cur_valid) {
+		if (crv_cur != 0) {
+			memcpy(&curves[0], &curves[crv_cur], sizeof(curve_t));
+		}
+		curves[0].set_in_hw = false;
+		crv_cur = 0;
+		nbcurves = 1;
+	} else {
+		nbcurves = 0;
+	}
+	nbtests = 0;
+}
+
+void batch_add_test(ipecc_test_t* t, const char* dbg, unsigned int linenum)
+{
+	batch_test_t* bt;
+
+	if (!crv_cur_valid) {
+		printf("%sError: Test before any curve.%s\n\r", KERR, KNRM);
+		print_stats_and_exit(t, bstats, dbg, linenum);
+	}
+	bt = &tests[nbtests++];
+	memcpy(&bt->test, t, sizeof(ipecc_test_t));
+	bt->test.curve = &curves[crv_cur];
+	bt->crv = crv_cur;
+	snprintf(bt->dbg, sizeof(bt->dbg), "%s", dbg);
+	bt->linenum = linenum;
+	if (nbtests == window) {
+		batch_flush();
+	}
+}
+
+void batch_print_stats(void)
+{
+	if (tests == NULL) {
+		return;
+	}
+	printf("Batching (windows of %d tests): %d windows, %d curve settings saved as already in the IP\n\r",
+			window, nbbatches, nbsaved);
+}
@@ -0,0 +1,400 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Open-loop load generator, for capacity planning of services built on
+ * the IP (signature, ECDH...).
+ *
+ * Requests ([k]P, P + Q & "is P on curve?" tests read from a binary
+ * test-vector stream, see linux/tvbin.c, each one checked against its
+ * expected result) are issued at a given rate, either constant or with
+ * exponential inter-arrival times (Poisson), by a pool of threads sharing
+ * the IP (or the mock backend, see linux/mock.c). Each request has an
+ * intended start time computed beforehand from the rate, and its latency
+ * is measured from that time, not from when a thread actually got to it,
+ * so that a saturated IP shows up as growing latencies instead of a
+ * silently lower offered rate (coordinated omission).
+ *
+ * With a target p99 (-s), the rate is increased step by step until p99
+ * exceeds it, and the last rate meeting the target is reported.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include "ecc-test-linux.h"
+
+#if defined(KP_TRACE) || defined(KP_SET_ZMASK)
+#error "ecc-load-gen doesn't support -DKP_TRACE nor -DKP_SET_ZMASK"
+#endif
+
+extern int ip_test_set_curve(curve_t*);
+extern int ip_test_set_pt_and_run_kp(ipecc_test_t*);
+extern int check_kp_result(ipecc_test_t*, bool*);
+extern int ip_test_set_pts_and_run_ptadd(ipecc_test_t*);
+extern int check_ptadd_result(ipecc_test_t*, bool*);
+extern int ip_test_set_pt_and_check_on_curve(ipecc_test_t*);
+extern int check_test_oncurve(ipecc_test_t*, bool*);
+
+#define NBTESTS_DEFAULT  1024
+#define STEPS_MAX        64
+
+/* Requests */
+static ipecc_test_t** tests = NULL;
+static uint32_t nbtests = 0;
+
+/* Options */
+static bool mock = false;
+static uint32_t mock_usec = 0;
+static bool poisson = false;
+static uint32_t nbthreads = 4;
+
+/* Current step */
+static uint64_t* intended;    /* intended start of requests (ns) */
+static uint64_t* latency;     /* latency of requests (ns) */
+static uint32_t nbreq;
+static _Atomic uint32_t next_req;
+static _Atomic uint32_t nberr;
+static _Atomic uint64_t last_end;
+
+/* The IP (or mock) is shared by all threads */
+static pthread_mutex_t ip_lock = PTHREAD_MUTEX_INITIALIZER;
+static curve_t* crv_hw = NULL;
+static uint32_t nbcurvesets = 0;
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return ((uint64_t)t.tv_sec * 1000000000ULL) + t.tv_nsec;
+}
+
+/* Load up to 'max' supported tests from a binary stream */
+static int load_tests(FILE* in, uint32_t max)
+{
+	tvbin_t tv;
+	uint8_t type, flags;
+	const uint8_t* pl;
+	uint32_t len, nbskip = 0;
+	curve_t* crv = NULL;
+	ipecc_test_t* t;
+	int ret;
+
+	if (tvbin_open(&tv, in)) {
+		goto err;
+	}
+	if ((tests = malloc(max * sizeof(ipecc_test_t*))) == NULL) {
+		goto err_alloc;
+	}
+	while ((nbtests < max) && ((ret = tvbin_next(&tv, &type, &flags, &pl, &len)) == 0)) {
+		if (type == TVBIN_REC_CURVE) {
+			if ((crv = calloc(1, sizeof(curve_t))) == NULL) {
+				goto err_alloc;
+			}
+			if (tvbin_get_curve(pl, len, crv)) {
+				goto err;
+			}
+		} else if (type == TVBIN_REC_TEST) {
+			if (crv == NULL) {
+				printf("%sError: Test record before any curve record.%s\n\r", KERR, KNRM);
+				goto err;
+			}
+			if ((t = calloc(1, sizeof(ipecc_test_t))) == NULL) {
+				goto err_alloc;
+			}
+			t->curve = crv;
+			if (tvbin_get_test(flags, pl, len, t)) {
+				goto err;
+			}
+			if ((t->op == OP_KP) || (t->op == OP_PTADD) || (t->op == OP_TST_CHK)) {
+				tests[nbtests++] = t;
+			} else {
+				free(t);
+				nbskip++;
+			}
+		}
+	}
+	tvbin_close(&tv);
+	if (ret < 0) {
+		goto err;
+	}
+	if (nbtests == 0) {
+		printf("%sError: No [k]P, P + Q nor \"is P on curve?\" test in input.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	printf("%d requests loaded (%d tests of other types skipped)\n\r", nbtests, nbskip);
+
+	return 0;
+err_alloc:
+	printf("%sError: Can't allocate memory for tests.%s\n\r", KERR, KNRM);
+err:
+	return -1;
+}
+
+/* Have the IP (or mock) process request 't' & check its result */
+static int process(ipecc_test_t* t)
+{
+	int err = 0;
+	bool res = false;
+
+	pthread_mutex_lock(&ip_lock);
+	if (t->curve != crv_hw) {
+		if (crv_hw) {
+			crv_hw->set_in_hw = false;
+		}
+		crv_hw = t->curve;
+		nbcurvesets++;
+		if (mock ? mock_set_curve(crv_hw, mock_usec) : ip_test_set_curve(crv_hw)) {
+			crv_hw = NULL;
+			err = -1;
+			goto out;
+		}
+	}
+	t->pt_hw_res.valid = false;
+	t->hw_answer.valid = false;
+	if (mock) {
+		err = mock_run(t, mock_usec);
+	} else if (t->op == OP_KP) {
+		err = ip_test_set_pt_and_run_kp(t);
+	} else if (t->op == OP_PTADD) {
+		err = ip_test_set_pts_and_run_ptadd(t);
+	} else {
+		err = ip_test_set_pt_and_check_on_curve(t);
+	}
+	if (err) {
+		goto out;
+	}
+	if (t->op == OP_KP) {
+		err = check_kp_result(t, &res);
+	} else if (t->op == OP_PTADD) {
+		err = check_ptadd_result(t, &res);
+	} else {
+		err = check_test_oncurve(t, &res);
+	}
+	if (!res) {
+		err = -1;
+	}
+out:
+	pthread_mutex_unlock(&ip_lock);
+	return err;
+}
+
+static void* worker(void* arg)
+{
+	uint32_t i;
+	uint64_t end, prev;
+	struct timespec ts;
+
+	(void)arg;
+	while ((i = atomic_fetch_add(&next_req, 1)) < nbreq) {
+		ts.tv_sec = intended[i] / 1000000000ULL;
+		ts.tv_nsec = intended[i] % 1000000000ULL;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL))
+			;
+		if (process(tests[i % nbtests])) {
+			atomic_fetch_add(&nberr, 1);
+		}
+		end = now_ns();
+		latency[i] = end - intended[i];
+		prev = atomic_load(&last_end);
+		while ((end > prev) && !atomic_compare_exchange_weak(&last_end, &prev, end))
+			;
+	}
+	return NULL;
+}
+
+static int cmp_u64(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+static inline double pct_us(double p)
+{
+	uint32_t i = (uint32_t)ceil(p * nbreq) - 1;
+
+	return latency[(i < nbreq) ? i : nbreq - 1] / 1e3;
+}
+
+/*
+ * Run 'nbreq' requests at 'rate' requests per second, return
+ * p99 latency (in us) & achieved throughput (requests per second)
+ */
+static int run_step(double rate, unsigned short* xsubi, double* p99, double* achieved)
+{
+	pthread_t tid[nbthreads];
+	uint64_t t0, off = 0;
+	uint32_t i;
+
+	/* Schedule, starting a bit later to let threads be created */
+	t0 = now_ns() + 10000000ULL;
+	for (i = 0; i < nbreq; i++) {
+		intended[i] = t0 + off;
+		off += (uint64_t)((poisson ? -log(1. - erand48(xsubi)) : 1.) * 1e9 / rate);
+	}
+	atomic_store(&next_req, 0);
+	atomic_store(&nberr, 0);
+	atomic_store(&last_end, 0);
+	for (i = 0; i < nbthreads; i++) {
+		if (pthread_create(&tid[i], NULL, worker, NULL)) {
+			printf("%sError: Can't create thread.%s\n\r", KERR, KNRM);
+			return -1;
+		}
+	}
+	for (i = 0; i < nbthreads; i++) {
+		pthread_join(tid[i], NULL);
+	}
+	qsort(latency, nbreq, sizeof(uint64_t), cmp_u64);
+	*p99 = pct_us(0.99);
+	*achieved = nbreq / ((atomic_load(&last_end) - t0) / 1e9);
+	printf("%10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %8d\n\r", rate, *achieved,
+			pct_us(0.5), pct_us(0.9), *p99, pct_us(0.999), latency[nbreq - 1] / 1e3, atomic_load(&nberr));
+
+	return 0;
+}
+
+static void usage(const char* prog)
+{
+	printf("Usage: %s -r rate [-s p99] [-g growth] [-d sec] [-t threads] [-P] [-S seed] [-n tests] [-m usec] [file]\n\r",
+			prog);
+	printf("Reads requests from a binary test-vector stream (file or standard input).\n\r");
+	printf("  -r : offered rate (requests per second), or first rate if -s\n\r");
+	printf("  -s : target p99 latency (us): the rate is multiplied by 'growth' (default\n\r");
+	printf("       1.25) until p99 exceeds it\n\r");
+	printf("  -d : duration of each rate step (default 5 s)\n\r");
+	printf("  -t : nb of threads issuing requests (default 4)\n\r");
+	printf("  -P : Poisson arrivals (otherwise at constant rate)\n\r");
+	printf("  -S : seed of arrival times (default 1)\n\r");
+	printf("  -n : max nb of tests loaded (default %d), requests cycling over them\n\r", NBTESTS_DEFAULT);
+	printf("  -m : mock backend, the IP is not accessed & each operation returns the\n\r");
+	printf("       expected result after 'usec' microseconds\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+	int opt;
+	double rate = 0, growth = 1.25, slo = 0, sec = 5, p99, achieved;
+	double ok_rate = 0, ok_achieved = 0;
+	uint32_t max = NBTESTS_DEFAULT, step;
+	unsigned short xsubi[3] = { 0x330e, 1, 0 };
+	bool hw_unsecure;
+	FILE* in = stdin;
+
+	while ((opt = getopt(argc, argv, "r:s:g:d:t:PS:n:m:h")) != -1) {
+		switch (opt) {
+			case 'r':
+				rate = strtod(optarg, NULL);
+				break;
+			case 's':
+				slo = strtod(optarg, NULL);
+				break;
+			case 'g':
+				growth = strtod(optarg, NULL);
+				break;
+			case 'd':
+				sec = strtod(optarg, NULL);
+				break;
+			case 't':
+				nbthreads = strtoul(optarg, NULL, 0);
+				break;
+			case 'P':
+				poisson = true;
+				break;
+			case 'S':
+				xsubi[1] = (unsigned short)strtoul(optarg, NULL, 0);
+				xsubi[2] = (unsigned short)(strtoul(optarg, NULL, 0) >> 16);
+				break;
+			case 'n':
+				max = strtoul(optarg, NULL, 0);
+				break;
+			case 'm':
+				mock = true;
+				mock_usec = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if ((rate <= 0) || (sec <= 0) || (nbthreads == 0) || (max == 0) || (growth <= 1.)) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	if ((optind < argc) && ((in = fopen(argv[optind], "r")) == NULL)) {
+		printf("%sError: can't open file '%s'.%s\n\r", KERR, argv[optind], KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (load_tests(in, max)) {
+		exit(EXIT_FAILURE);
+	}
+
+	if (!mock) {
+		if (hw_driver_is_hw_unsecure(&hw_unsecure)) {
+			printf("%sError: Probing 'HW secure/unsecure mode' triggered an error.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+		/* Post-processing of the TRNG is disabled upon reset in HW unsecure mode */
+		if (hw_unsecure && hw_driver_trng_post_proc_enable_DBG()) {
+			printf("%sError: Enabling TRNG post-processing on hardware triggered an error.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	printf("%s arrivals, %d threads, %.1f s per step, %s\n\r", poisson ? "Poisson" : "Constant-rate",
+			nbthreads, sec, mock ? "mock backend" : "hardware");
+	printf("%10s %10s %10s %10s %10s %10s %10s %8s\n\r", "offered/s", "achieved/s",
+			"p50 (us)", "p90 (us)", "p99 (us)", "p99.9 (us)", "max (us)", "errors");
+	for (step = 0; step < STEPS_MAX; step++) {
+		nbreq = (uint32_t)ceil(rate * sec);
+		if (((intended = malloc(nbreq * sizeof(uint64_t))) == NULL)
+				|| ((latency = malloc(nbreq * sizeof(uint64_t))) == NULL)) {
+			printf("%sError: Can't allocate memory for %d requests.%s\n\r", KERR, nbreq, KNRM);
+			exit(EXIT_FAILURE);
+		}
+		if (run_step(rate, xsubi, &p99, &achieved)) {
+			exit(EXIT_FAILURE);
+		}
+		free(intended);
+		free(latency);
+		if ((slo == 0) || (p99 > slo)) {
+			break;
+		}
+		ok_rate = rate;
+		ok_achieved = achieved;
+		rate *= growth;
+	}
+	printf("%d curve settings\n\r", nbcurvesets);
+	if (slo != 0) {
+		if (p99 <= slo) {
+			printf("p99 still below %.1f us at %.1f requests/s (last step)\n\r", slo, ok_rate);
+		} else if (ok_rate == 0) {
+			printf("p99 exceeds %.1f us from the first rate (%.1f requests/s)\n\r", slo, rate);
+		} else {
+			printf("p99 exceeds %.1f us at %.1f requests/s: target met up to %s%.1f requests/s%s"
+					" (achieved %.1f)\n\r", slo, rate, KBOLD, ok_rate, KNOBOLD, ok_achieved);
+		}
+	}
+
+	exit(EXIT_SUCCESS);
+}
@@ -18,6 +18,7 @@
 #include "ecc-test-linux.h"
 #include <signal.h>
 #include <sys/time.h>
+#include <time.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -231,7 +232,9 @@ static ipecc_test_t test = {
 	.ktrc = NULL,
 #endif
 	.kptime = NULL,
-	.tdg = &tdiag
+	.tdg = &tdiag,
+	.hwns = 0,
+	.hwcycles = 0
 };
 
 /* Statistics */
@@ -248,14 +251,42 @@ static all_stats_t stats = {
 	.nn_max = 0,
 	.nn_avr = 0,
 	.nbcurves = 0
+	/* (histograms are zero-initialized) */
 };
 
 /*
- * Pointer 'line' will be allocated by getline, but freed by us
- * as recommanded in the man GETLINE(3) page (see function
+ * Upper bounds of the ranges of nn that histograms of statistics are
+ * split into (the standard curve sizes fall in distinct ranges).
+ */
+static const uint32_t nn_bucket_max[NN_BUCKETS] = {
+	192, 256, 320, 384, 448, 528, 1024, 0xffffffffUL
+};
+
+/* Names of operations in the CSV dump of histograms */
+static const char* op_name[OP_TST_OPP + 1] = {
+	"none", "kp", "ptadd", "ptdbl", "ptneg", "tst_chk", "tst_equ", "tst_opp"
+};
+
+/*
+ * Lines of input, either pointing into the mapping of the input file
+ * or allocated by getline() (see linux/txtparse.c), the latter being
+ * freed by us as recommanded in the man GETLINE(3) page (see function
  * print_stats_and_exit() hereafter).
  */
-char* line = NULL;
+static txtin_t txtin;
+const char* line = NULL;
+
+/* Options (see usage()) */
+static bool pipelined = false;
+static bool batched = false;
+static bool mock = false;
+static uint32_t mock_usec = 0;
+static const char* csvfile = NULL;
+
+/* Start time of tests, for throughput */
+static struct timespec t_start;
+/* Nb of times a curve was set in the IP */
+static uint32_t nbcurvesets = 0;
 
 #define max(a,b) do { \
    ({ __typeof__ (a) _a = (a); \
@@ -263,11 +294,11 @@ char* line = NULL;
      _a > _b ? _a : _b; }) \
  while (0)
 
-static bool line_is_empty(char *l)
+static bool line_is_empty(const char *l, ssize_t n)
 {
-	uint32_t c;
+	ssize_t c;
 	bool ret = true;
-	for (c=0; ;c++) {
+	for (c=0; c<n; c++) {
 		if ((l[c] == '\r') || (l[c] == '\n')) {
 			break;
 		} else if ((l[c] != ' ') && (l[c] != '\t')) {
@@ -278,17 +309,63 @@ static bool line_is_empty(char *l)
 	return ret;
 }
 
+static uint32_t nn_bucket(uint32_t nn)
+{
+	uint32_t i;
+
+	for (i = 0; i < (NN_BUCKETS - 1); i++) {
+		if (nn <= nn_bucket_max[i]) {
+			break;
+		}
+	}
+	return i;
+}
+
+/* Merge the histograms of operation 'op' for all ranges of nn into 'h' */
+static void hist_of_op(all_stats_t* st, operation_t op, hdr_t* h)
+{
+	uint32_t i;
+
+	for (i = 0; i < NN_BUCKETS; i++) {
+		hdr_merge(h, &st->ns[op][i]);
+	}
+}
+
+/* Print percentile 'p' of the hardware time of each operation (in us) */
+static void print_pct_line(all_stats_t* st, const char* label, double p)
+{
+	static hdr_t h[OP_TST_OPP + 1];
+	hdr_t* all = &h[OP_NONE];
+	uint32_t op;
+
+	memset(h, 0, sizeof(h));
+	for (op = OP_KP; op <= OP_TST_OPP; op++) {
+		hist_of_op(st, op, &h[op]);
+		hdr_merge(all, &h[op]);
+	}
+	printf("%s%s%s: %*.0f  %*.0f  %*.0f  %*.0f  %*.0f  %*.0f  %*.0f  %s%*.0f%s%s\n",
+			KBOLD, KYEL, label,
+			6, hdr_percentile(&h[OP_KP], p) / 1e3, 6, hdr_percentile(&h[OP_PTADD], p) / 1e3,
+			6, hdr_percentile(&h[OP_PTDBL], p) / 1e3, 6, hdr_percentile(&h[OP_PTNEG], p) / 1e3,
+			6, hdr_percentile(&h[OP_TST_EQU], p) / 1e3, 6, hdr_percentile(&h[OP_TST_OPP], p) / 1e3,
+			6, hdr_percentile(&h[OP_TST_CHK], p) / 1e3, KCYN, 6, hdr_percentile(all, p) / 1e3,
+			KNRM, KNOBOLD);
+}
+
 static void print_stats_regularly(all_stats_t* st, bool force)
 {
 	static bool only_once = true;
+	static hdr_t kpcyc;
+	uint32_t i;
 
 	if (((st->all.total % DISPLAY_MODULO) == DISPLAY_MODULO - 1) || (force)) {
 		if (only_once) {
-			printf("\n\n\n\n\n");
+			printf("\n\n\n\n\n\n\n\n");
 			only_once = false;
 		}
 		/* nn min, max */
-		printf("%s%s%s%s%s%s%s%s%s%s%s%s",
+		printf("%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
+				KERASELINE, KMVUP1LINE, KERASELINE, KMVUP1LINE, KERASELINE, KMVUP1LINE,
 				KERASELINE, KMVUP1LINE, KERASELINE, KMVUP1LINE, KERASELINE, KMVUP1LINE,
 				KERASELINE, KMVUP1LINE, KERASELINE, KMVUP1LINE, KERASELINE, KBOLD);
 		if (st->nbcurves)  {
@@ -320,18 +397,81 @@ static void print_stats_regularly(all_stats_t* st, bool force)
 				6, st->kp.total, 6, st->ptadd.total, 6, st->ptdbl.total, 6, st->ptneg.total,
 				6, st->test_equ.total, 6, st->test_opp.total, 6, st->test_crv.total, KCYN,
 				6, st->all.total, KNRM, KNOBOLD);
+		/* Percentiles of the hardware time (us) */
+		print_pct_line(st, "p50us", 0.50);
+		print_pct_line(st, "p99us", 0.99);
+		/* [k]P time measured by the IP */
+		memset(&kpcyc, 0, sizeof(kpcyc));
+		for (i = 0; i < NN_BUCKETS; i++) {
+			hdr_merge(&kpcyc, &st->kpcycles[i]);
+		}
+		if (kpcyc.n) {
+			printf("%s[k]P cycles p50|p99|max: %s%llu%s%s|%s%llu%s%s|%s%llu%s%s\n",
+					KBOLD, KORA, (unsigned long long)hdr_percentile(&kpcyc, 0.50), KNRM, KBOLD,
+					KVIO, (unsigned long long)hdr_percentile(&kpcyc, 0.99), KNRM, KBOLD,
+					KORA, (unsigned long long)kpcyc.max, KNRM, KNOBOLD);
+		} else {
+			printf("%s[k]P cycles p50|p99|max: %s.%s%s|%s.%s%s|%s.%s%s\n",
+					KBOLD, KORA, KNRM, KBOLD, KVIO, KNRM, KBOLD, KORA, KNRM, KNOBOLD);
+		}
 	}
 }
 
+/*
+ * Dump the histograms of statistics in CSV file given with option -H,
+ * one line per non-empty bucket: the bucket bounds, its count & the
+ * fraction of the samples of the histogram up to it (as the percentile
+ * distribution output of HdrHistogram). 'metric' is 'ns' for the time
+ * of the hardware stage, 'cycles' for the [k]P time measured by the IP.
+ */
+static void stats_dump_csv(all_stats_t* st)
+{
+	FILE* fp;
+	uint32_t op, i;
+
+	if (csvfile == NULL) {
+		return;
+	}
+	if ((fp = fopen(csvfile, "w")) == NULL) {
+		printf("%sError: Can't open '%s' to dump histograms.%s\n\r", KERR, csvfile, KNRM);
+		return;
+	}
+	fprintf(fp, "metric,op,nn_min,nn_max,bucket_lo,bucket_hi,count,percentile\n");
+	for (op = OP_KP; op <= OP_TST_OPP + 1; op++) {
+		for (i = 0; i < NN_BUCKETS; i++) {
+			hdr_t* h = (op <= OP_TST_OPP) ? &st->ns[op][i] : &st->kpcycles[i];
+			uint64_t acc = 0, hi;
+			uint32_t b;
+
+			for (b = 0; (b < HDR_NB_BUCKETS) && (acc < h->n); b++) {
+				if (h->cnt[b] == 0) {
+					continue;
+				}
+				acc += h->cnt[b];
+				hi = hdr_bucket_hi(b);
+				fprintf(fp, "%s,%s,%u,%u,%llu,%llu,%u,%.6f\n",
+						(op <= OP_TST_OPP) ? "ns" : "cycles", op_name[(op <= OP_TST_OPP) ? op : OP_KP],
+						i ? nn_bucket_max[i - 1] + 1 : 0, nn_bucket_max[i],
+						(unsigned long long)hdr_bucket_lo(b), (unsigned long long)((hi > h->max) ? h->max : hi),
+						h->cnt[b], (double)acc / h->n);
+			}
+		}
+	}
+	fclose(fp);
+	printf("Histograms dumped in %s\n\r", csvfile);
+}
+
 void print_stats_and_exit(ipecc_test_t* t, all_stats_t* s, const char* msg, unsigned int linenum)
 {
 	print_stats_regularly(s, true);
+	stats_dump_csv(s);
 	printf("Stopped on test %d.%d%s\n\r", t->curve->id, t->id, KNRM);
 #ifndef KP_TRACE
 	printf("You can compile with -DKP_TRACE to get debug info from [k]P tracing log (see Makefile).\n");
 #endif
-	if (line) {
-		free(line);
+	if (!pipelined) {
+		/* (otherwise the parser may still be using it, exit() will release it) */
+		txtin_close(&txtin);
 	}
 	/* Remove color on terminal, make the cursor visible again
 	 * and set normal (no bold) font
@@ -340,6 +480,26 @@ void print_stats_and_exit(ipecc_test_t* t, all_stats_t* s, const char* msg, unsi
 	error_at_line(-1, EXIT_FAILURE, __FILE__, linenum, "%s", msg);
 }
 
+/* Print nb of tests per second since the first one */
+static void print_throughput(void)
+{
+	struct timespec t;
+	double elapsed;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	elapsed = (t.tv_sec - t_start.tv_sec) + ((t.tv_nsec - t_start.tv_nsec) / 1e9);
+	printf("%d tests in %.3f s: %s%.1f tests/s%s, %d curve settings (%s%s)\n\r", stats.all.total,
+			elapsed, KBOLD, (elapsed > 0) ? stats.all.total / elapsed : 0., KNOBOLD, nbcurvesets,
+			pipelined ? "pipelined, " : (batched ? "batched, " : "sequential, "),
+			mock ? "mock backend" : "hardware");
+	if (pipelined) {
+		pipeline_print_stats(elapsed);
+	}
+	if (batched) {
+		batch_print_stats();
+	}
+}
+
 /* Irq handler for the SIGINT (Ctrl-C) signal to restore the cursor,
  * a normal color and no bold font in the terminal before leaving.
  */
@@ -348,6 +508,8 @@ void int_handler(int dummy)
 	(void)(dummy); /* To avoid unused parameter warning from gcc */
 	if (stats.all.total > 0) {
 		print_stats_regularly(&stats, true);
+		print_throughput();
+		stats_dump_csv(&stats);
 	}
 	/* Remove color on terminal, make the cursor visible again
 	 * and set normal (no bold) font
@@ -357,55 +519,29 @@ void int_handler(int dummy)
 }
 
 /*
- * Convert one hexadecimal digit into an integer.
- */
-static int hex2dec(const char c, unsigned char *nb)
-{
-	if ( (c >= 'a') && (c <= 'f') ) {
-		*nb = c - 'a' + 10;
-	} else if ( (c >= 'A') && (c <= 'F') ) {
-		*nb = c - 'A' + 10;
-	} else if ( (c >= '0') && (c <= '9') ) {
-		*nb = c - '0';
-	} else {
-		printf("%sError: '%c' not an hexadecimal digit%s\n\r", KERR, c, KNRM);
-		goto err;
-	}
-	return 0;
-err:
-	return -1;
-}
-
-/*
- * Extract an hexadecimal string (without the 0x) from a position in a line 
- * (pointed to by parameter 'pc') convert it in binary form and fill buffer
- * 'nb_x' with it, parsing exactly 'nbchar' - 2 characters.
- *
- * Also set the size (in bytes) of the output buffer.
+ * Extract an hexadecimal string (without the 0x) from a position in a line
+ * (pointed to by parameter 'pc', up to the end of the line, 'nbchar' being
+ * its nb of characters) convert it in binary form and fill buffer 'nb_x'
+ * with it (see hex_to_bin() in linux/txtparse.c).
  */
 static int hex_to_large_num(const char *pc, unsigned char* nb_x, unsigned int valnn, const ssize_t nbchar)
 {
-	int i, j;
+	ssize_t n = nbchar;
 	unsigned int k;
-	uint8_t tmp;
-
-	/* Format bytes of large number; */
-	j = 0;
-	for (i = nbchar - 2 ; i>=0 ; i--) {
-	//for (i = 0; i < nbchar - 1 ; i++) {
-		if (hex2dec(pc[i], &tmp)) {
-			printf("%sError while trying to convert character string '%s'"
-					" into an hexadecimal number%s\n\r", KERR, pc, KNRM);
-			goto err;
-		} else {
-			nb_x[DIV(valnn, 8) - 1 - j/2] = ( (j % 2) ? nb_x[DIV(valnn, 8) - 1 - j/2] : 0) + ( tmp * (0x1U << (4*(j % 2))) );
-			j++;
-		}
+
+	/* Don't count the end of line (nor trailing blanks) */
+	while ((n > 0) && ((pc[n - 1] == '\n') || (pc[n - 1] == '\r') || (pc[n - 1] == ' ')
+				|| (pc[n - 1] == '\t'))) {
+		n--;
 	}
-	 /* Fill possible remaining buffer space with 0s.
-	 */
-	for (k = 1 + (j-1)/2; k < DIV(valnn, 8); k++) {
-		nb_x[k] = 0;
+	if (DIV(valnn, 8) > NBMAXSZ) {
+		printf("%sError: nn = %d is too large for buffers of large numbers%s\n\r", KERR, valnn, KNRM);
+		goto err;
+	}
+	if (hex_to_bin(pc, n, nb_x, DIV(valnn, 8))) {
+		printf("%sError while trying to convert character string '%.*s'"
+				" into an hexadecimal number%s\n\r", KERR, (int)n, pc, KNRM);
+		goto err;
 	}
 	for (k=0; k<DIV(valnn, 8); k++) {
 		PRINTF(" %02x", nb_x[k]);
@@ -433,40 +569,325 @@ static int strtol_with_err(const char *nptr, unsigned int* nb)
 	}
 }
 
-int cmp_two_pts_coords(point_t* p0, point_t* p1, bool* res)
+/*
+ * Extract the nb of a test from the end of its header line, that is
+ * what follows the dot in "x.y" ('pc' pointing to "x.y", 'n' being the
+ * nb of characters up to the end of the line).
+ */
+static int get_test_id(const char* pc, ssize_t n, unsigned int* nb)
+{
+	const char* dot;
+
+	if ((dot = memchr(pc, '.', n)) == NULL) {
+		return -1;
+	}
+	return strtol_with_err(dot + 1, nb);
+}
+
+/* Account for a new curve in statistics */
+static void stats_new_curve(all_stats_t* st, uint32_t nn)
 {
-	uint32_t i;
+	st->nbcurves++;
+	if (nn > st->nn_max) {
+		st->nn_max = nn;
+	}
+	if (nn < st->nn_min) {
+		st->nn_min = nn;
+	}
+	st->nn_avr += nn;
+}
 
+/*
+ * Hardware stage of test 't' (all its inputs & expected result being set):
+ * have the hardware (or the mock backend) execute it, & time it.
+ */
+int stage_hw_test(ipecc_test_t* t)
+{
+	struct timespec t0, t1;
+	int ret;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	if (mock) {
+		ret = mock_run(t, mock_usec);
+	} else {
+		switch (t->op) {
+			case OP_KP:
+				ret = ip_test_set_pt_and_run_kp(t, &kp_trace_info);
+				break;
+			case OP_PTADD:
+				ret = ip_test_set_pts_and_run_ptadd(t);
+				break;
+			case OP_PTDBL:
+				ret = ip_test_set_pt_and_run_ptdbl(t);
+				break;
+			case OP_PTNEG:
+				ret = ip_test_set_pt_and_run_ptneg(t);
+				break;
+			case OP_TST_CHK:
+				ret = ip_test_set_pt_and_check_on_curve(t);
+				break;
+			case OP_TST_EQU:
+				ret = ip_test_set_pts_and_test_equal(t);
+				break;
+			case OP_TST_OPP:
+				ret = ip_test_set_pts_and_test_oppos(t);
+				break;
+			default:
+				ret = -1;
+				break;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	t->hwns = ((t1.tv_sec - t0.tv_sec) * 1000000000ULL) + t1.tv_nsec - t0.tv_nsec;
 	/*
-	 * If four coordinates sizes do not match, that's an error
-	 * (don't even compare).
+	 * 'kptime' points to a single variable for all tests: read it
+	 * now, the pipeline (or batch) may run other tests before the
+	 * checker stage of this one.
 	 */
-	if ( (p0->x.sz != p0->y.sz) || (p0->x.sz != p1->x.sz) || (p0->y.sz != p1->x.sz)
-			|| (p0->y.sz != p1->y.sz) || (p1->x.sz != p1->y.sz) )
-	{
-		printf("%sError: can't compare coord. buffers that are not of the same byte size to begin with.%s\n\r",
-				KERR, KNRM);
-		goto err;
+	t->hwcycles = ((t->op == OP_KP) && (t->kptime)) ? *(t->kptime) : 0;
+
+	return ret;
+}
+
+/* Account for the times of (successful) test 't' in statistics */
+static void stats_add_times(all_stats_t* st, ipecc_test_t* t)
+{
+	uint32_t b = nn_bucket(t->curve->nn);
+
+	hdr_add(&st->ns[t->op][b], t->hwns);
+	if (t->hwcycles) {
+		hdr_add(&st->kpcycles[b], t->hwcycles);
 	}
-	/* Compare the X & Y coordinates one byte after the other. */
-	*res = true;
-	for (i = 0; i < p0->x.sz; i++) {
-		if ((p0->x.val[i] != p1->x.val[i]) || (p0->y.val[i] != p1->y.val[i])) {
-			*res = false;
+}
+
+/*
+ * Checker stage of test 't': check its result against the expected one
+ * (unless the hardware stage returned error 'hwerr') & update statistics.
+ * Exits on any error ('dbg' & 'linenum' are those of the caller of
+ * run_test(), see print_stats_and_exit()).
+ */
+void stage_chk_test(ipecc_test_t* t, all_stats_t* st, int hwerr, const char* dbg, unsigned int linenum)
+{
+	stats_t* s;
+	const char* what;
+	int err;
+	bool res;
+
+	switch (t->op) {
+		case OP_KP:
+			s = &st->kp;
+			what = "[k]P";
+			break;
+		case OP_PTADD:
+			s = &st->ptadd;
+			what = "P + Q";
+			break;
+		case OP_PTDBL:
+			s = &st->ptdbl;
+			what = "[2]P";
+			break;
+		case OP_PTNEG:
+			s = &st->ptneg;
+			what = "-P";
 			break;
+		case OP_TST_CHK:
+			s = &st->test_crv;
+			what = "point test \"is on curve?\"";
+			break;
+		case OP_TST_EQU:
+			s = &st->test_equ;
+			what = "point test \"are pts equal?\"";
+			break;
+		case OP_TST_OPP:
+			s = &st->test_opp;
+			what = "point test \"are pts opposite?\"";
+			break;
+		default:
+			printf("%sError: unknown or undefined type of operation.%s\n\r", KERR, KNRM);
+			print_stats_and_exit(t, st, dbg, linenum);
+			return;
+	}
+	if (hwerr) {
+		s->nok++;
+		s->total++;
+		st->all.nok++;
+		st->all.total++;
+		printf("%sError: Computation of %s on hardware triggered an error.%s\n\r", KERR, what, KNRM);
+		if (t->op == OP_KP) {
+			kp_error_log(t);
 		}
+		print_stats_and_exit(t, st, dbg, linenum);
 	}
-	return 0;
-err:
-	return -1;
+	/*
+	 * Check IP result against the expected one.
+	 */
+	switch (t->op) {
+		case OP_KP:
+			err = check_kp_result(t, &res, &kp_trace_info);
+			break;
+		case OP_PTADD:
+			err = check_ptadd_result(t, &res);
+			break;
+		case OP_PTDBL:
+			err = check_ptdbl_result(t, &res);
+			break;
+		case OP_PTNEG:
+			err = check_ptneg_result(t, &res);
+			break;
+		case OP_TST_CHK:
+			err = check_test_oncurve(t, &res);
+			break;
+		case OP_TST_EQU:
+			err = check_test_equal(t, &res);
+			break;
+		case OP_TST_OPP:
+		default:
+			err = check_test_oppos(t, &res);
+			break;
+	}
+	if (err) {
+		if (t->op == OP_KP) {
+			/*
+			 * Dump [k]P trace log.
+			 */
+			kp_error_log(t);
+		}
+		s->nok++;
+		s->total++;
+		st->all.nok++;
+		st->all.total++;
+		printf("%sError: Couldn't compare %s hardware result w/ the expected one.%s\n\r", KERR, what, KNRM);
+		print_stats_and_exit(t, st, dbg, linenum);
+	}
+	/*
+	 * Stats
+	 */
+	s->ok++;
+	s->total++;
+	st->all.ok++;
+	st->all.total++;
+	stats_add_times(st, t);
+	print_stats_regularly(st, false);
 }
 
-int main(int argc, char *argv[])
+/* Hardware stage of a new curve: transfer its parameters to the IP */
+int stage_hw_curve(curve_t* crv)
+{
+	nbcurvesets++;
+	if (mock) {
+		return mock_set_curve(crv, mock_usec);
+	}
+	return ip_test_set_curve(crv);
+}
+
+/* Checker stage of a new curve */
+void stage_chk_curve(curve_t* crv, all_stats_t* st, int hwerr, const char* dbg, unsigned int linenum)
+{
+	if (hwerr) {
+		printf("%sError: Could not transmit curve parameters to driver.%s\n\r", KERR, KNRM);
+		print_stats_and_exit(&test, st, dbg, linenum);
+	}
+	stats_new_curve(st, crv->nn);
+}
+
+/*
+ * Have test 't' executed & checked, either right away, or by the
+ * pipeline (option -p), or with the next tests of the same curve
+ * (option -b).
+ */
+static void run_test(ipecc_test_t* t, all_stats_t* st, const char* dbg, unsigned int linenum)
+{
+	if (pipelined) {
+		pipeline_submit_test(t, dbg, linenum);
+	} else if (batched) {
+		batch_add_test(t, dbg, linenum);
+	} else {
+		stage_chk_test(t, st, stage_hw_test(t), dbg, linenum);
+	}
+}
+
+/* Same as run_test() for a new curve */
+static void set_curve(curve_t* crv, all_stats_t* st, const char* dbg, unsigned int linenum)
+{
+	if (pipelined) {
+		pipeline_submit_curve(crv, dbg, linenum);
+	} else if (batched) {
+		stats_new_curve(st, crv->nn);
+		batch_add_curve(crv);
+	} else {
+		stage_chk_curve(crv, st, stage_hw_curve(crv), dbg, linenum);
+	}
+}
+
+/* Wait for all tests to be executed & checked */
+static void end_of_tests(void)
+{
+	if (pipelined) {
+		pipeline_end();
+	} else if (batched) {
+		batch_flush();
+	}
+}
+
+/*
+ * Same as the main loop of main() hereafter, but for a binary
+ * test-vector stream (see linux/tvbin.c).
+ */
+static void run_tvbin(FILE* in)
+{
+	tvbin_t tv;
+	uint8_t type, flags;
+	const uint8_t* pl;
+	uint32_t len;
+	int ret;
+
+	if (tvbin_open(&tv, in)) {
+		print_stats_and_exit(&test, &stats, "(debug info: opening binary input)", __LINE__);
+	}
+	while ((ret = tvbin_next(&tv, &type, &flags, &pl, &len)) == 0) {
+		switch (type) {
+			case TVBIN_REC_CURVE:{
+				if (tvbin_get_curve(pl, len, &curve)) {
+					print_stats_and_exit(&test, &stats, "(debug info: in binary curve record)", __LINE__);
+				}
+				/*
+				 * Transfer curve parameters to the IP.
+				 */
+				set_curve(&curve, &stats, "(debug info: in binary curve record)", __LINE__);
+				break;
+			}
+			case TVBIN_REC_TEST:{
+				test.ptp.valid = false;
+				test.ptq.valid = false;
+				test.k.valid = false;
+				test.pt_sw_res.valid = false;
+				test.pt_hw_res.valid = false;
+				test.sw_answer.valid = false;
+				test.hw_answer.valid = false;
+				if (tvbin_get_test(flags, pl, len, &test)) {
+					print_stats_and_exit(&test, &stats, "(debug info: in binary test record)", __LINE__);
+				}
+				run_test(&test, &stats, "(debug info: in binary test record)", __LINE__);
+				break;
+			}
+			default:{
+				/* Unknown record, skip it */
+				break;
+			}
+		}
+	}
+	tvbin_close(&tv);
+	if (ret < 0) {
+		print_stats_and_exit(&test, &stats, "(debug info: reading binary input)", __LINE__);
+	}
+}
+
+/*
+ * Probe the IP & estimate a few of its characteristics (HW unsecure
+ * mode only), before running tests.
+ */
+static void ip_setup(void)
 {
-	uint32_t i;
-	line_t line_type_expected = EXPECT_NONE;
-	size_t len = 0;
-	ssize_t nread;
 	bool hw_unsecure;
 	uint32_t vmajor, vminor, vpatch;
 
@@ -477,25 +898,10 @@ int main(int argc, char *argv[])
 	bool axi64;
 	uint32_t nnmax;
 
-	bool result_pts_are_equal;
-	bool result_tests_are_identical;
-
 	uint32_t fclk, fclkmm;
 
 	uint32_t raw_ff_time, raw_ff_step, mean_raw_ff_time = 0;
 
-	(void)argc;
-	(void)argv;
-
-
-	/* Move the claptrap below rather in --help it it exists one day. */
-#if 0
-	printf("Reads test-vectors from standard-input, has them computed by hardware,\n\r");
-	printf("then checks that result matches what was expected.\n\r");
-	printf("Text format for tests is described in the IPECC doc.\n\r");
-	printf("(c.f Appendix \"Simulating & testing the IP\").%s\n\r", KNRM);
-#endif
-
 #if 1
 	/* Is it a 'HW secure' or a 'HW unsecure' version of the IP? */
 	if (hw_driver_is_hw_unsecure(&hw_unsecure)) {
@@ -600,11 +1006,6 @@ int main(int argc, char *argv[])
 	printf("%sTRNG bypassed using all 0 values instead%s\n\r", KWHT, KNRM);
 #endif
 
-	/* Before entering the main loop, hook up the SIGINT signal
-	 * to our own handler.
-	 */
-	signal(SIGINT, int_handler);
-
 	if (hw_unsecure) {
 		/* Estimate clock frequencies
 		 */
@@ -633,11 +1034,95 @@ int main(int argc, char *argv[])
 		exit(EXIT_FAILURE);
 	}
 #endif
+}
+
+static void usage(const char* prog)
+{
+	printf("Usage: %s [-p depth | -b window] [-m usec] [-H csvfile]\n\r", prog);
+	printf("Reads test-vectors from standard-input, has them computed by hardware,\n\r");
+	printf("then checks that result matches what was expected.\n\r");
+	printf("  -p : pipeline parsing, hardware & checking of tests in three threads,\n\r");
+	printf("       with 'depth' tests in flight at most (0 for the default, %d)\n\r", PIPE_DEPTH_DEFAULT);
+	printf("  -b : execute tests by windows of 'window' tests, grouped by curve to\n\r");
+	printf("       limit curve settings (0 for the default, %d), results being still\n\r",
+			BATCH_WINDOW_DEFAULT);
+	printf("       checked in input order\n\r");
+	printf("  -m : mock backend, the IP is not accessed & each operation returns the\n\r");
+	printf("       expected result after 'usec' microseconds\n\r");
+	printf("  -H : on exit (or Ctrl-C, or error) dump in 'csvfile' the histograms of\n\r");
+	printf("       hardware time of tests (ns) per operation & range of nn, and of\n\r");
+	printf("       [k]P time measured by the IP (cycles, HW unsecure mode only)\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+	line_t line_type_expected = EXPECT_NONE;
+	ssize_t nread;
+	int opt;
+	uint32_t depth = 0, window = 0;
+
+	while ((opt = getopt(argc, argv, "p:b:m:H:h")) != -1) {
+		switch (opt) {
+			case 'p':
+				pipelined = true;
+				depth = strtoul(optarg, NULL, 0);
+				break;
+			case 'b':
+				batched = true;
+				window = strtoul(optarg, NULL, 0);
+				break;
+			case 'm':
+				mock = true;
+				mock_usec = strtoul(optarg, NULL, 0);
+				break;
+			case 'H':
+				csvfile = optarg;
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if (pipelined && batched) {
+		printf("%sError: Options -p & -b can't be used together.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+
+	if (mock) {
+		printf("Mock backend, operations take %d us (the IP is not accessed)\n\r", mock_usec);
+	} else {
+		ip_setup();
+	}
+
+	/* Before entering the main loop, hook up the SIGINT signal
+	 * to our own handler.
+	 */
+	signal(SIGINT, int_handler);
 
 	/* Make cursor invisible from the terminal window.
 	 */
 	printf("%s", KCURSORINVIS);
 
+	if (pipelined) {
+		if (pipeline_start(depth ? depth : PIPE_DEPTH_DEFAULT, &stats)) {
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (batched) {
+		if (batch_start(window ? window : BATCH_WINDOW_DEFAULT, &stats)) {
+			exit(EXIT_FAILURE);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t_start);
+
+	/* Binary test-vector stream (otherwise the text format, below).
+	 */
+	if (tvbin_probe(stdin)) {
+		run_tvbin(stdin);
+		end_of_tests();
+		int_handler(0);
+	}
+
 	/* Main infinite loop, parsing lines from standard input to extract:
 	 *   - input vectors
 	 *   - type of operation
@@ -646,7 +1131,8 @@ int main(int argc, char *argv[])
 	 * checking the result of hardware against the expected one.
 	 */
 
-	while (((nread = getline(&line, &len, stdin))) != -1) {
+	txtin_open(&txtin, stdin);
+	while (((nread = txtin_getline(&txtin, &line))) != -1) {
 		/*
 		 * Allow comment lines starting with #
 		 * (simply assert exception flag if it starts with "# EXCEPTION"
@@ -661,7 +1147,7 @@ int main(int argc, char *argv[])
 		/*
 		 * Allow empty lines
 		 */
-		if (line_is_empty(line) == true) {
+		if (line_is_empty(line, nread) == true) {
 			continue;
 		}
 		/*
@@ -683,16 +1169,9 @@ int main(int argc, char *argv[])
 					curve.valid = false;
 				} else if ( (strncmp(line, "== TEST [k]P #", strlen("== TEST [k]P #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST [k]P #") + i) == '.') {
-							*(line + strlen("== TEST [k]P #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST [k]P #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST [k]P #"), nread - strlen("== TEST [k]P #"), &test.id);
 					test.op = OP_KP;
 					test.ptp.valid = false;
 					test.k.valid = false;
@@ -706,16 +1185,9 @@ int main(int argc, char *argv[])
 					test.blinding = 0;
 				} else if ( (strncmp(line, "== TEST P+Q #", strlen("== TEST P+Q #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST P+Q #") + i) == '.') {
-							*(line + strlen("== TEST P+Q #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST P+Q #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST P+Q #"), nread - strlen("== TEST P+Q #"), &test.id);
 					test.op = OP_PTADD;
 					test.ptp.valid = false;
 					test.ptq.valid = false;
@@ -724,16 +1196,9 @@ int main(int argc, char *argv[])
 					line_type_expected = EXPECT_PX;
 				} else if ( (strncmp(line, "== TEST [2]P #", strlen("== TEST [2]P #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST [2]P #") + i) == '.') {
-							*(line + strlen("== TEST [2]P #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST [2]P #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST [2]P #"), nread - strlen("== TEST [2]P #"), &test.id);
 					test.op = OP_PTDBL;
 					test.ptp.valid = false;
 					test.pt_sw_res.valid = false;
@@ -741,16 +1206,9 @@ int main(int argc, char *argv[])
 					line_type_expected = EXPECT_PX;
 				} else if ( (strncmp(line, "== TEST -P #", strlen("== TEST -P #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST -P #") + i) == '.') {
-							*(line + strlen("== TEST -P #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST -P #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST -P #"), nread - strlen("== TEST -P #"), &test.id);
 					test.op = OP_PTNEG;
 					test.ptp.valid = false;
 					test.pt_sw_res.valid = false;
@@ -758,16 +1216,9 @@ int main(int argc, char *argv[])
 					line_type_expected = EXPECT_PX;
 				} else if ( (strncmp(line, "== TEST isPoncurve #", strlen("== TEST isPoncurve #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST isPoncurve #") + i) == '.') {
-							*(line + strlen("== TEST isPoncurve #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST isPoncurve #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST isPoncurve #"), nread - strlen("== TEST isPoncurve #"), &test.id);
 					test.op = OP_TST_CHK;
 					test.ptp.valid = false;
 					test.sw_answer.valid = false;
@@ -775,16 +1226,9 @@ int main(int argc, char *argv[])
 					line_type_expected = EXPECT_PX;
 				} else if ( (strncmp(line, "== TEST isP==Q #", strlen("== TEST isP==Q #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST isP==Q #") + i) == '.') {
-							*(line + strlen("== TEST isP==Q #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST isP==Q #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST isP==Q #"), nread - strlen("== TEST isP==Q #"), &test.id);
 					test.op = OP_TST_EQU;
 					test.ptp.valid = false;
 					test.ptq.valid = false;
@@ -793,16 +1237,9 @@ int main(int argc, char *argv[])
 					line_type_expected = EXPECT_PX;
 				} else if ( (strncmp(line, "== TEST isP==-Q #", strlen("== TEST isP==-Q #"))) == 0 ) {
 					/*
-					 * Extract the computation nb, after '#' character.
+					 * Extract the computation nb, after the dot following '#' character.
 					 */
-					/* Determine position of the dot in the line. */
-					for (i=0; ; i++) {
-						if (*(line + strlen("== TEST isP==-Q #") + i) == '.') {
-							*(line + strlen("== TEST isP==-Q #") + i) = '\0';
-							break;
-						}
-					}
-					strtol_with_err(line + strlen("== TEST isP==-Q #") + i + 1, &test.id);
+					get_test_id(line + strlen("== TEST isP==-Q #"), nread - strlen("== TEST isP==-Q #"), &test.id);
 					test.op = OP_TST_OPP;
 					test.ptp.valid = false;
 					test.ptq.valid = false;
@@ -826,14 +1263,6 @@ int main(int argc, char *argv[])
 					strtol_with_err(&line[3], &curve.nn);
 					PRINTF("%snn=%d\n\r%s", KINF, curve.nn, KNRM);
 					line_type_expected = EXPECT_P;
-					stats.nbcurves++;
-					if (curve.nn > stats.nn_max) {
-						stats.nn_max = curve.nn;
-					}
-					if (curve.nn < stats.nn_min) {
-						stats.nn_min = curve.nn;
-					}
-					stats.nn_avr += curve.nn;
 				} else {
 					printf("%sError: Could not find the expected token \"nn=\" "
 							"from input file/stream.\n\r", KERR);
@@ -845,7 +1274,7 @@ int main(int argc, char *argv[])
 			case EXPECT_P:{
 				/* Parse line to extract value of p */
 				if ( (strncmp(line, "p=0x", strlen("p=0x"))) == 0 ) {
-					PRINTF("%sp=0x%s%s", KINF, line + strlen("p=0x"), KNRM);
+					PRINTF("%sp=0x%.*s%s", KINF, (int)(nread - strlen("p=0x")), line + strlen("p=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of p to create the list
 					 * of bytes to transfer to the IP.
@@ -871,7 +1300,7 @@ int main(int argc, char *argv[])
 			case EXPECT_A:{
 				/* Parse line to extract value of a */
 				if ( (strncmp(line, "a=0x", strlen("a=0x"))) == 0 ) {
-					PRINTF("%sa=0x%s%s", KINF, line + strlen("a=0x"), KNRM);
+					PRINTF("%sa=0x%.*s%s", KINF, (int)(nread - strlen("a=0x")), line + strlen("a=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of a to create the list
 					 * of bytes to transfer to the IP.
@@ -897,7 +1326,7 @@ int main(int argc, char *argv[])
 			case EXPECT_B:{
 				/* Parse line to extract value of b/ */
 				if ( (strncmp(line, "b=0x", strlen("b=0x"))) == 0 ) {
-					PRINTF("%sb=0x%s%s", KINF, line + strlen("b=0x"), KNRM);
+					PRINTF("%sb=0x%.*s%s", KINF, (int)(nread - strlen("b=0x")), line + strlen("b=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of b to create the list
 					 * of bytes to transfer to the IP.
@@ -924,7 +1353,7 @@ int main(int argc, char *argv[])
 				/* Parse line to extract value of q. */
 				if ( (strncmp(line, "q=0x", strlen("q=0x"))) == 0 )
 				{
-					PRINTF("%sq=0x%s%s", KINF, line + strlen("q=0x"), KNRM);
+					PRINTF("%sq=0x%.*s%s", KINF, (int)(nread - strlen("q=0x")), line + strlen("q=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of q to create the list
 					 * of bytes to transfer to the IP (also set the size of
@@ -943,11 +1372,7 @@ int main(int argc, char *argv[])
 					/*
 					 * Transfer curve parameters to the IP.
 					 */
-					if (ip_test_set_curve(test.curve))
-					{
-						printf("%sError: Could not transmit curve parameters to driver.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_Q')", __LINE__);
-					}
+					set_curve(test.curve, &stats, "(debug info: in state 'EXPECT_Q')", __LINE__);
 					line_type_expected = EXPECT_NONE;
 				} else {
 					printf("%sError: Could not find the expected token \"q=0x\" "
@@ -960,7 +1385,7 @@ int main(int argc, char *argv[])
 			case EXPECT_PX:{
 				/* Parse line to extract value of Px */
 				if ( (strncmp(line, "Px=0x", strlen("Px=0x"))) == 0 ) {
-					PRINTF("%sPx=0x%s%s", KINF, line + strlen("Px=0x"), KNRM);
+					PRINTF("%sPx=0x%.*s%s", KINF, (int)(nread - strlen("Px=0x")), line + strlen("Px=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of Px to create the list
 					 * of bytes to transfer to the IP.
@@ -1012,7 +1437,7 @@ int main(int argc, char *argv[])
 			case EXPECT_PY:{
 				/* Parse line to extract value of Py */
 				if ( (strncmp(line, "Py=0x", strlen("Py=0x"))) == 0 ) {
-					PRINTF("%sPy=0x%s%s", KINF, line + strlen("Py=0x"), KNRM);
+					PRINTF("%sPy=0x%.*s%s", KINF, (int)(nread - strlen("Py=0x")), line + strlen("Py=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of Py to create the list
 					 * of bytes to transfer to the IP.
@@ -1053,7 +1478,7 @@ int main(int argc, char *argv[])
 			case EXPECT_QX:{
 				/* Parse line to extract value of Qx. */
 				if ( (strncmp(line, "Qx=0x", strlen("Qx=0x"))) == 0 ) {
-					PRINTF("%sQx=0x%s%s", KINF, line + strlen("Qx=0x"), KNRM);
+					PRINTF("%sQx=0x%.*s%s", KINF, (int)(nread - strlen("Qx=0x")), line + strlen("Qx=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of Qx to create the list
 					 * of bytes to transfer to the IP.
@@ -1101,7 +1526,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of Py.
 				 */
 				if ( (strncmp(line, "Qy=0x", strlen("Qy=0x"))) == 0 ) {
-					PRINTF("%sQy=0x%s%s", KINF, line + strlen("Qy=0x"), KNRM);
+					PRINTF("%sQy=0x%.*s%s", KINF, (int)(nread - strlen("Qy=0x")), line + strlen("Qy=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of Py to create the list
 					 * of bytes to transfer to the IP.
@@ -1138,7 +1563,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of k.
 				 */
 				if ( (strncmp(line, "k=0x", strlen("k=0x"))) == 0 ) {
-					PRINTF("%sk=0x%s%s", KINF, line + strlen("k=0x"), KNRM);
+					PRINTF("%sk=0x%.*s%s", KINF, (int)(nread - strlen("k=0x")), line + strlen("k=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of k to create the list
 					 * of bytes to transfer to the IP.
@@ -1166,7 +1591,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract possible nb of blinding bits.
 				 * */
 				if ( (strncmp(line, "nbbld=", strlen("nbbld="))) == 0 ) {
-					PRINTF("%snbbld=%s%s", KINF, line + strlen("nbbld="), KNRM);
+					PRINTF("%snbbld=%.*s%s", KINF, (int)(nread - strlen("nbbld=")), line + strlen("nbbld="), KNRM);
 					if (strtol_with_err(line + strlen("nbbld="), &test.blinding))
 					{
 						printf("%sError: while converting \"nbbld=\" argument to a number.%s\n\r", KERR, KNRM);
@@ -1174,7 +1599,7 @@ int main(int argc, char *argv[])
 					}
 					/* Keep line_type_expected to EXPECT_KPX_OR_BLD to parse point [k]P coordinates */
 				} else if ( (strncmp(line, "kPx=0x", strlen("kPx=0x"))) == 0 ) {
-					PRINTF("%skPx=0x%s%s", KINF, line + strlen("kPx=0x"), KNRM);
+					PRINTF("%skPx=0x%.*s%s", KINF, (int)(nread - strlen("kPx=0x")), line + strlen("kPx=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of kPx for comparison with HW.
 					 */
@@ -1199,43 +1624,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.is_null = true;
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a [k]P computation test on hardware.
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					if (ip_test_set_pt_and_run_kp(&test, &kp_trace_info))
-					{
-						stats.kp.nok++;
-						stats.kp.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of scalar multiplication on hardware triggered an error.%s\n\r", KERR, KNRM);
-						kp_error_log(&test);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_KPX_OR_BLD')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one (which is the point at infinity)
-					 */
-					if (check_kp_result(&test, &result_pts_are_equal, &kp_trace_info))
-					{
-						/*
-						 * Dump [k]P trace log.
-						 */
-						kp_error_log(&test);
-						stats.kp.nok++;
-						stats.kp.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare [k]P hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_KPX_OR_BLD')", __LINE__);
-					}
-					/*
-					 * Stats
-					 */
-					stats.kp.ok++;
-					stats.kp.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_KPX_OR_BLD')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1255,7 +1647,7 @@ int main(int argc, char *argv[])
 			case EXPECT_KPY:{
 				/* Parse line to extract value of [k]Py (y of result) */
 				if ( (strncmp(line, "kPy=0x", strlen("kPy=0x"))) == 0 ) {
-					PRINTF("%skPy=0x%s%s", KINF, line + strlen("kPy=0x"), KNRM);
+					PRINTF("%skPy=0x%.*s%s", KINF, (int)(nread - strlen("kPy=0x")), line + strlen("kPy=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of kPy for comparison with HW
 					 */
@@ -1269,43 +1661,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.y.sz = DIV(test.curve->nn, 8);
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a [k]P computation test on harware.
-					 */
-					if (ip_test_set_pt_and_run_kp(&test, &kp_trace_info))
-					{
-						stats.kp.nok++;
-						stats.kp.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of scalar multiplication on hardware triggered an error.%s\n\r", KERR, KNRM);
-						kp_error_log(&test);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_KPY')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
-					 */
-					if (check_kp_result(&test, &result_pts_are_equal, &kp_trace_info))
-					{
-						/*
-						 * Dump [k]P trace log.
-						 */
-						kp_error_log(&test);
-						stats.kp.nok++;
-						stats.kp.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare [k]P hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_KPY')", __LINE__);
-					}
-					/*
-					 * Stats
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					stats.kp.ok++;
-					stats.kp.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_KPY')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1327,7 +1686,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of (P+Q).x
 				 */
 				if ( (strncmp(line, "PplusQx=0x", strlen("PplusQx=0x"))) == 0 ) {
-					PRINTF("%s(P+Q)x=0x%s%s", KINF, line + strlen("PplusQx=0x"), KNRM);
+					PRINTF("%s(P+Q)x=0x%.*s%s", KINF, (int)(nread - strlen("PplusQx=0x")), line + strlen("PplusQx=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of (P+Q).x for comparison with HW
 					 */
@@ -1346,38 +1705,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.is_null = true;
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a P + Q computation test on hardware.
-					 */
-					if (ip_test_set_pts_and_run_ptadd(&test))
-					{
-						stats.ptadd.nok++;
-						stats.ptadd.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of P + Q on hardware triggered an error.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_P_PLUS_QX')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					if (check_ptadd_result(&test, &result_pts_are_equal))
-					{
-						stats.ptadd.nok++;
-						stats.ptadd.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare P + Q hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_P_PLUS_QX')", __LINE__);
-					}
-					/*
-					 * Stats
-					 */
-					stats.ptadd.ok++;
-					stats.ptadd.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_P_PLUS_QX')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1399,7 +1730,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of (P+Q).y
 				 */
 				if ( (strncmp(line, "PplusQy=0x", strlen("PplusQy=0x"))) == 0 ) {
-					PRINTF("%s(P+Q)y=0x%s%s", KINF, line + strlen("PplusQy=0x"), KNRM);
+					PRINTF("%s(P+Q)y=0x%.*s%s", KINF, (int)(nread - strlen("PplusQy=0x")), line + strlen("PplusQy=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of (P+Q).y for comparison with HW
 					 */
@@ -1414,38 +1745,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.y.sz = DIV(test.curve->nn, 8);
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a P + Q computation test on harware.
-					 */
-					if (ip_test_set_pts_and_run_ptadd(&test))
-					{
-						stats.ptadd.nok++;
-						stats.ptadd.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of P + Q on hardware triggered an error.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_P_PLUS_QY')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
-					 */
-					if (check_ptadd_result(&test, &result_pts_are_equal))
-					{
-						stats.ptadd.nok++;
-						stats.ptadd.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare P + Q hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_P_PLUS_QY')", __LINE__);
-					}
-					/*
-					 * Stats
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					stats.ptadd.ok++;
-					stats.ptadd.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_P_PLUS_QY')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1467,7 +1770,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of [2]P.x
 				 */
 				if ( (strncmp(line, "twoPx=0x", strlen("twoPx=0x"))) == 0 ) {
-					PRINTF("%s[2]P.x=0x%s%s", KINF, line + strlen("twoPx=0x"), KNRM);
+					PRINTF("%s[2]P.x=0x%.*s%s", KINF, (int)(nread - strlen("twoPx=0x")), line + strlen("twoPx=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of [2]P.x for comparison with HW
 					 */
@@ -1487,38 +1790,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.is_null = true;
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a [2]P computation test on hardware.
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					if (ip_test_set_pt_and_run_ptdbl(&test))
-					{
-						stats.ptdbl.nok++;
-						stats.ptdbl.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of [2]P on hardware triggered an error.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TWOP_X')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
-					 */
-					if (check_ptdbl_result(&test, &result_pts_are_equal))
-					{
-						stats.ptdbl.nok++;
-						stats.ptdbl.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare [2]P hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TWOP_X')", __LINE__);
-					}
-					/*
-					 * Stats
-					 */
-					stats.ptdbl.ok++;
-					stats.ptdbl.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_TWOP_X')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1540,7 +1815,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of [2]P.y
 				 */
 				if ( (strncmp(line, "twoPy=0x", strlen("twoPy=0x"))) == 0 ) {
-					PRINTF("%s[2]P.y=0x%s%s", KINF, line + strlen("twoPy=0x"), KNRM);
+					PRINTF("%s[2]P.y=0x%.*s%s", KINF, (int)(nread - strlen("twoPy=0x")), line + strlen("twoPy=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of [2]P.y for comparison with HW
 					 */
@@ -1555,38 +1830,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.y.sz = DIV(test.curve->nn, 8);
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a [2]P computation test on hardware.
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					if (ip_test_set_pt_and_run_ptdbl(&test))
-					{
-						stats.ptdbl.nok++;
-						stats.ptdbl.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of [2]P on hardware triggered an error.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TWOP_Y')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
-					 */
-					if (check_ptdbl_result(&test, &result_pts_are_equal))
-					{
-						stats.ptdbl.nok++;
-						stats.ptdbl.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare [2]P hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TWOP_Y')", __LINE__);
-					}
-					/*
-					 * Stats
-					 */
-					stats.ptdbl.ok++;
-					stats.ptdbl.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_TWOP_Y')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1608,7 +1855,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of -P.x
 				 */
 				if ( (strncmp(line, "negPx=0x", strlen("negPx=0x"))) == 0 ) {
-					PRINTF("%s-P.x=0x%s%s", KINF, line + strlen("negPx=0x"), KNRM);
+					PRINTF("%s-P.x=0x%.*s%s", KINF, (int)(nread - strlen("negPx=0x")), line + strlen("negPx=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of -P.x for comparison with HW
 					 */
@@ -1628,38 +1875,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.is_null = true;
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a -P computation test on hardware.
-					 */
-					if (ip_test_set_pt_and_run_ptneg(&test))
-					{
-						stats.ptneg.nok++;
-						stats.ptneg.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of -P on hardware triggered an error.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_NEGP_X')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
-					 */
-					if (check_ptneg_result(&test, &result_pts_are_equal))
-					{
-						stats.ptneg.nok++;
-						stats.ptneg.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare -P hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_NEGP_X')", __LINE__);
-					}
-					/*
-					 * Stats
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					stats.ptneg.ok++;
-					stats.ptneg.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_NEGP_X')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1681,7 +1900,7 @@ int main(int argc, char *argv[])
 				 * Parse line to extract value of -P.y
 				 */
 				if ( (strncmp(line, "negPy=0x", strlen("negPy=0x"))) == 0 ) {
-					PRINTF("%s-P.y=0x%s%s", KINF, line + strlen("negPy=0x"), KNRM);
+					PRINTF("%s-P.y=0x%.*s%s", KINF, (int)(nread - strlen("negPy=0x")), line + strlen("negPy=0x"), KNRM);
 					/*
 					 * Process the hexadecimal value of -P.y for comparison with HW
 					 */
@@ -1696,38 +1915,10 @@ int main(int argc, char *argv[])
 					test.pt_sw_res.y.sz = DIV(test.curve->nn, 8);
 					test.pt_sw_res.valid = true;
 					/*
-					 * Set and execute a -P computation test on hardware.
-					 */
-					if (ip_test_set_pt_and_run_ptneg(&test))
-					{
-						stats.ptneg.nok++;
-						stats.ptneg.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Computation of -P on hardware triggered an error.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_NEGP_Y')", __LINE__);
-					}
-					/*
-					 * Check IP result against the expected one.
+					 * Set and execute the computation on hardware & check its result.
 					 */
-					if (check_ptneg_result(&test, &result_pts_are_equal))
-					{
-						stats.ptneg.nok++;
-						stats.ptneg.total++;
-						stats.all.nok++;
-						stats.all.total++;
-						printf("%sError: Couldn't compare -P hardware result w/ the expected one.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_NEGP_Y')", __LINE__);
-					}
-					/*
-					 * Stats
-					 */
-					stats.ptneg.ok++;
-					stats.ptneg.total++;
-					stats.all.ok++;
-					stats.all.total++;
+					run_test(&test, &stats, "(debug info: in state 'EXPECT_NEGP_Y')", __LINE__);
 					line_type_expected = EXPECT_NONE;
-					print_stats_regularly(&stats, false);
 #if 0
 					/*
 					 * Mark the next test to come as not being an exception (a priori)
@@ -1785,124 +1976,11 @@ int main(int argc, char *argv[])
 					print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
 				}
 				/*
-				 * Set and execute one or two points on which to perform the test on hardware.
-				 */
-				switch (test.op) {
-					case OP_TST_CHK:{
-						if (ip_test_set_pt_and_check_on_curve(&test))
-						{
-							stats.test_crv.nok++;
-							stats.test_crv.total++;
-							stats.all.nok++;
-							stats.all.total++;
-							printf("%sError: Point test \"is on curve?\" on hardware triggered an error.%s\n\r", KERR, KNRM);
-							print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						}
-						break;
-					}
-					case OP_TST_EQU:{
-						if (ip_test_set_pts_and_test_equal(&test))
-						{
-							stats.test_equ.nok++;
-							stats.test_equ.total++;
-							stats.all.nok++;
-							stats.all.total++;
-							printf("%sError: Point test \"are pts equal?\" on hardware triggered an error.%s\n\r", KERR, KNRM);
-							print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						}
-						break;
-					}
-					case OP_TST_OPP:{
-						if (ip_test_set_pts_and_test_oppos(&test))
-						{
-							stats.test_opp.nok++;
-							stats.test_opp.total++;
-							stats.all.nok++;
-							stats.all.total++;
-							printf("%sError: Point test \"are pts opposite?\" on hardware triggered an error.%s\n\r", KERR, KNRM);
-							print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						}
-						break;
-					}
-					default:{
-						printf("%sError: Invalid test type.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						break;
-					}
-				}
-				/*
-				 * Check IP answer to the test against the expected one.
+				 * Set and execute one or two points on which to perform the test on hardware
+				 * & check its answer.
 				 */
-				switch (test.op) {
-					case OP_TST_CHK:{
-						if (check_test_oncurve(&test, &result_tests_are_identical))
-						{
-							stats.test_crv.nok++;
-							stats.test_crv.total++;
-							stats.all.nok++;
-							stats.all.total++;
-							printf("%sError: Couldn't compare hardware result to test \"is on curve?\" "
-									"w/ the expected one.%s\n\r", KERR, KNRM);
-							print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						}
-						break;
-					}
-					case OP_TST_EQU:{
-						if (check_test_equal(&test, &result_tests_are_identical))
-						{
-							stats.test_equ.nok++;
-							stats.test_equ.total++;
-							stats.all.nok++;
-							stats.all.total++;
-							printf("%sError: Couldn't compare hardware result to test \"are pts equal?\" "
-									"w/ the expected one.%s\n\r", KERR, KNRM);
-							print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						}
-						break;
-					}
-					case OP_TST_OPP:{
-						if (check_test_oppos(&test, &result_tests_are_identical))
-						{
-							stats.test_opp.nok++;
-							stats.test_opp.total++;
-							stats.all.nok++;
-							stats.all.total++;
-							printf("%sError: Couldn't compare hardware result to test \"are pts opposite?\" "
-									"w/ the expected one.%s\n\r", KERR, KNRM);
-							print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						}
-						break;
-					}
-					default:{
-						printf("%sError: Invalid test type.%s\n\r", KERR, KNRM);
-						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
-						break;
-					}
-				}
-				stats.all.ok++;
-				stats.all.total++;
-				switch (test.op) {
-					case OP_TST_CHK:{
-						stats.test_crv.ok++;
-						stats.test_crv.total++;
-						break;
-					}
-					case OP_TST_EQU:{
-						stats.test_equ.ok++;
-						stats.test_equ.total++;
-						break;
-					}
-					case OP_TST_OPP:{
-						stats.test_opp.ok++;
-						stats.test_opp.total++;
-						break;
-					}
-					default:{
-						break;
-					}
-				}
+				run_test(&test, &stats, "(debug info: in state 'EXPECT_TRUE_OR_FALSE')", __LINE__);
 				line_type_expected = EXPECT_NONE;
-				print_stats_regularly(&stats, false);
 #if 0
 				/*
 				 * Mark the next test to come as not being an exception (a priori)
@@ -1940,9 +2018,11 @@ int main(int argc, char *argv[])
 	/* End of main inf. loop
 	 * (e.g TCP socket shutdown by 'nc -N' or Ctrl-C, or std input simply was closed).
 	 *
-	 * Before leaving, print stats, restore the cursor, a normal
-	 * color and a not bold font in the terminal.
+	 * Before leaving, wait for the tests still in the pipeline or in
+	 * the batch if any, print stats, restore the cursor, a normal color
+	 * and a not bold font in the terminal.
 	 */
+	end_of_tests();
 	int_handler(0);
 
 	return EXIT_SUCCESS;
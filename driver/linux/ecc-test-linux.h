@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdatomic.h>
 
 #if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM)    
 #include <unistd.h>                               
@@ -128,6 +129,30 @@ typedef struct {
 	uint32_t total;
 } stats_t;
 
+/*
+ * HDR-style (log-linear) histogram of durations (see linux/hdr.c):
+ * 2^HDR_SUB_BITS buckets per power of two, up to 2^(HDR_MSB_MAX+1).
+ */
+#define HDR_SUB_BITS    5
+#define HDR_MSB_MAX     47
+#define HDR_NB_BUCKETS  ((HDR_MSB_MAX - HDR_SUB_BITS + 2) << HDR_SUB_BITS)
+
+typedef struct {
+	uint64_t n;
+	uint64_t min;
+	uint64_t max;
+	uint32_t cnt[HDR_NB_BUCKETS];
+} hdr_t;
+
+extern void hdr_add(hdr_t*, uint64_t);
+extern void hdr_merge(hdr_t*, const hdr_t*);
+extern uint64_t hdr_percentile(const hdr_t*, double);
+extern uint64_t hdr_bucket_lo(uint32_t);
+extern uint64_t hdr_bucket_hi(uint32_t);
+
+/* Nb of ranges of nn for histograms (see nn_bucket_max[] in ecc-test-linux.c) */
+#define NN_BUCKETS  8
+
 typedef struct {
 	stats_t kp;
 	stats_t ptadd;
@@ -141,6 +166,12 @@ typedef struct {
 	uint32_t nn_max;
 	uint32_t nn_avr;
 	uint32_t nbcurves;
+	/* Wall-clock time (ns) of the hardware stage of tests, per type
+	 * of operation & range of nn */
+	hdr_t ns[OP_TST_OPP + 1][NN_BUCKETS];
+	/* [k]P computation time measured by the IP (cycles, HW unsecure
+	 * mode only), per range of nn */
+	hdr_t kpcycles[NN_BUCKETS];
 } all_stats_t;
 
 /*
@@ -166,8 +197,131 @@ typedef struct {
 	kp_trace_info_t *ktrc;
 	uint32_t* kptime;
 	trng_diagcnt_t* tdg;
+	/* Set by the hardware stage: its wall-clock time (ns) &, for [k]P, the
+	 * value read at 'kptime' (0 if not measured) */
+	uint64_t hwns;
+	uint32_t hwcycles;
 } ipecc_test_t;
 
+/*
+ * Binary test-vector stream (see linux/tvbin.c & sage/tvbin.py
+ * for the format).
+ */
+#define TVBIN_MAGIC        "IPECCTV1"
+#define TVBIN_MAGIC_SZ     8
+#define TVBIN_HDR_SZ       8
+
+typedef enum {
+	TVBIN_REC_CURVE = 1,
+	TVBIN_REC_TEST = 2,
+	TVBIN_REC_COMMENT = 3 /* comment line of the text format (skipped) */
+} tvbin_rec_t;
+
+#define TVBIN_F_EXCEPTION  0x01
+#define TVBIN_F_P_NULL     0x02
+#define TVBIN_F_Q_NULL     0x04
+#define TVBIN_F_R_NULL     0x08
+#define TVBIN_F_ANSWER     0x10
+
+typedef struct {
+	/* Input either mmap'ed (regular file)... */
+	const uint8_t* map;
+	size_t mapsz;
+	size_t pos;
+	/* ...or read as a stream (pipe, socket) */
+	FILE* fp;
+	uint8_t* buf;
+	uint32_t bufsz;
+} tvbin_t;
+
+extern bool tvbin_probe(FILE*);
+extern int tvbin_open(tvbin_t*, FILE*);
+extern int tvbin_next(tvbin_t*, uint8_t*, uint8_t*, const uint8_t**, uint32_t*);
+extern int tvbin_get_curve(const uint8_t*, uint32_t, curve_t*);
+extern int tvbin_get_test(uint8_t, const uint8_t*, uint32_t, ipecc_test_t*);
+extern void tvbin_close(tvbin_t*);
+
+/*
+ * Text test-vector input (see linux/txtparse.c).
+ */
+typedef struct {
+	/* Input either mmap'ed (regular file)... */
+	const char* map;
+	size_t mapsz;
+	size_t pos;
+	/* ...or read with getline() */
+	FILE* fp;
+	char* buf;
+	size_t bufsz;
+} txtin_t;
+
+extern int hex_to_bin(const char*, uint32_t, uint8_t*, uint32_t);
+extern int txtin_open(txtin_t*, FILE*);
+extern ssize_t txtin_getline(txtin_t*, const char**);
+extern void txtin_close(txtin_t*);
+
+/*
+ * Max size of the debug message kept with a test whose check is deferred
+ * (pipeline & batch): it's copied, as the string of the caller is not
+ * guaranteed to outlive the call.
+ */
+#define DBG_MSG_SZ  96
+
+/*
+ * Pipelined execution of tests (see linux/pipeline.c): a parser stage
+ * (the main thread), a hardware stage & a checker stage, linked by
+ * lock-free single-producer/single-consumer rings of slot indexes.
+ */
+typedef enum {
+	JOB_CURVE = 0,
+	JOB_TEST = 1,
+	JOB_END = 2
+} job_t;
+
+typedef struct {
+	job_t type;
+	curve_t curve;
+	ipecc_test_t test;
+	/* Set by the hardware stage for the checker one */
+	int hwerr;
+	/* Location in main() the job was submitted from (for error messages) */
+	char dbg[DBG_MSG_SZ];
+	unsigned int linenum;
+} pipe_slot_t;
+
+typedef struct {
+	_Atomic uint32_t head;   /* written by the producer only */
+	_Atomic uint32_t tail;   /* written by the consumer only */
+	uint32_t mask;
+	uint32_t* idx;
+} spsc_t;
+
+/* Default nb of slots (a power of 2) */
+#define PIPE_DEPTH_DEFAULT  32
+
+extern int pipeline_start(uint32_t, all_stats_t*);
+extern void pipeline_submit_curve(curve_t*, const char*, unsigned int);
+extern void pipeline_submit_test(ipecc_test_t*, const char*, unsigned int);
+extern void pipeline_end(void);
+extern void pipeline_print_stats(double);
+
+/*
+ * Curve-affinity batching of tests (see linux/batch.c).
+ */
+#define BATCH_WINDOW_DEFAULT  256
+
+extern int batch_start(uint32_t, all_stats_t*);
+extern void batch_add_curve(curve_t*);
+extern void batch_add_test(ipecc_test_t*, const char*, unsigned int);
+extern void batch_flush(void);
+extern void batch_print_stats(void);
+
+/*
+ * Mock backend (see linux/mock.c), to run the harness without the IP.
+ */
+extern int mock_set_curve(curve_t*, uint32_t);
+extern int mock_run(ipecc_test_t*, uint32_t);
+
 /*
  * DIV(i, s) returns the number of s-bit limbs required to encode
  * an i-bit number.
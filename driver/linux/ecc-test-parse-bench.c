@@ -0,0 +1,226 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Micro-benchmark of the parsing of text test-vector files (e.g
+ * sim/std-curves-test-vectors.txt, or larger ones output by
+ * sage/generate-tests.sage).
+ *
+ * Every file is read line by line in place from its mapping
+ * (txtin_getline()) and each of its large numbers is converted both
+ * with hex_to_bin() (linux/txtparse.c) and with the former nibble
+ * by nibble conversion of ecc-test-linux.c, checking that results are
+ * the same. Reports the time per large number & the throughput of both.
+ *
+ * Doesn't access the IP (it can be run on a host, or on the target
+ * without the IP being loaded).
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "ecc-test-linux.h"
+
+/* Former conversion of one hexadecimal digit */
+static int hex2dec(const char c, unsigned char *nb)
+{
+	if ( (c >= 'a') && (c <= 'f') ) {
+		*nb = c - 'a' + 10;
+	} else if ( (c >= 'A') && (c <= 'F') ) {
+		*nb = c - 'A' + 10;
+	} else if ( (c >= '0') && (c <= '9') ) {
+		*nb = c - '0';
+	} else {
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Former conversion of a large number ('nbchar' digits), but for its
+ * zero-padding which cleared the least significant bytes instead of
+ * the most significant ones when there were less than 2*NN_SZ digits.
+ */
+static int hex_to_large_num_ref(const char *pc, unsigned char* nb_x, unsigned int valnn, const ssize_t nbchar)
+{
+	int i, j;
+	unsigned int k;
+	uint8_t tmp;
+
+	j = 0;
+	for (i = nbchar - 1 ; i>=0 ; i--) {
+		if (hex2dec(pc[i], &tmp)) {
+			return -1;
+		} else {
+			nb_x[DIV(valnn, 8) - 1 - j/2] = ( (j % 2) ? nb_x[DIV(valnn, 8) - 1 - j/2] : 0) + ( tmp * (0x1U << (4*(j % 2))) );
+			j++;
+		}
+	}
+	for (k = 0; k < DIV(valnn, 8) - (1 + (j-1)/2); k++) {
+		nb_x[k] = 0;
+	}
+	return 0;
+}
+
+typedef struct {
+	uint64_t nbnum;
+	uint64_t nbdigits;
+	uint64_t ns;
+} bench_t;
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return ((uint64_t)t.tv_sec * 1000000000ULL) + t.tv_nsec;
+}
+
+/*
+ * One pass over a file: scan lines & convert the large numbers with
+ * 'ref' or not (or none if 'scan_only', to get the cost of the scan)
+ */
+static int bench_file(const char* fname, bool ref, bool scan_only, bool check, bench_t* b)
+{
+	FILE* fp;
+	txtin_t in;
+	const char* l;
+	const char* eq;
+	ssize_t n;
+	uint32_t nn = 0, nd;
+	uint64_t t0;
+	static uint8_t val[NBMAXSZ], val_ref[NBMAXSZ];
+
+	if ((fp = fopen(fname, "r")) == NULL) {
+		fprintf(stderr, "%sError: can't open file '%s'.%s\n\r", KERR, fname, KNRM);
+		return -1;
+	}
+	txtin_open(&in, fp);
+	t0 = now_ns();
+	while ((n = txtin_getline(&in, &l)) != -1) {
+		if (strncmp(l, "nn=", strlen("nn=")) == 0) {
+			nn = strtoul(l + strlen("nn="), NULL, 10);
+			continue;
+		}
+		if ((l[0] == '=') || (l[0] == '#') || ((eq = memchr(l, '=', n)) == NULL)
+				|| (strncmp(eq, "=0x", strlen("=0x")) != 0)) {
+			continue;
+		}
+		eq += strlen("=0x");
+		nd = n - (eq - l) - 1;
+		if ((nd == 0) || (nn == 0) || (DIV(nn, 8) > NBMAXSZ)) {
+			continue;
+		}
+		b->nbnum++;
+		b->nbdigits += nd;
+		if (scan_only) {
+			continue;
+		}
+		if (ref) {
+			if (hex_to_large_num_ref(eq, val_ref, nn, nd)) {
+				goto err_num;
+			}
+		} else {
+			if (hex_to_bin(eq, nd, val, DIV(nn, 8))) {
+				goto err_num;
+			}
+		}
+		if (check) {
+			if (hex_to_large_num_ref(eq, val_ref, nn, nd) || memcmp(val, val_ref, DIV(nn, 8))) {
+				fprintf(stderr, "%sError: mismatch on '%.*s'.%s\n\r", KERR, (int)n - 1, l, KNRM);
+				goto err;
+			}
+		}
+	}
+	b->ns += now_ns() - t0;
+	txtin_close(&in);
+	fclose(fp);
+	return 0;
+
+err_num:
+	fprintf(stderr, "%sError: can't convert '%.*s'.%s\n\r", KERR, (int)n - 1, l, KNRM);
+err:
+	txtin_close(&in);
+	fclose(fp);
+	return -1;
+}
+
+static void usage(const char* prog)
+{
+	printf("Usage: %s [-n iterations] file...\n\r", prog);
+	printf("  -n : nb of passes over each file (default 20)\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+	int opt, f;
+	uint32_t iter = 20, i;
+	bench_t bscan, bref, bnew;
+	double nsscan;
+
+	while ((opt = getopt(argc, argv, "n:h")) != -1) {
+		switch (opt) {
+			case 'n':
+				iter = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if ((optind == argc) || (iter == 0)) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	printf("%-40s %10s %8s %12s %12s %12s %8s\n\r", "file", "numbers", "digits",
+			"scan ns/nb", "ref ns/nb", "new ns/nb", "speedup");
+	for (f = optind; f < argc; f++) {
+		memset(&bscan, 0, sizeof(bench_t));
+		memset(&bref, 0, sizeof(bench_t));
+		memset(&bnew, 0, sizeof(bench_t));
+		/* First pass checks both conversions give the same result */
+		if (bench_file(argv[f], false, false, true, &bscan)) {
+			exit(EXIT_FAILURE);
+		}
+		memset(&bscan, 0, sizeof(bench_t));
+		for (i = 0; i < iter; i++) {
+			if (bench_file(argv[f], false, true, false, &bscan)
+					|| bench_file(argv[f], true, false, false, &bref)
+					|| bench_file(argv[f], false, false, false, &bnew)) {
+				exit(EXIT_FAILURE);
+			}
+		}
+		if (bscan.nbnum == 0) {
+			printf("%-40s (no large number)\n\r", argv[f]);
+			continue;
+		}
+		/* Conversion times exclude the time to scan lines */
+		nsscan = (double)bscan.ns / bscan.nbnum;
+		printf("%-40s %10llu %8.1f %12.1f %12.1f %12.1f %7.1fx\n\r", argv[f],
+				(unsigned long long)(bscan.nbnum / iter), (double)bscan.nbdigits / bscan.nbnum,
+				nsscan, ((double)bref.ns / bref.nbnum) - nsscan, ((double)bnew.ns / bnew.nbnum) - nsscan,
+				(((double)bref.ns / bref.nbnum) - nsscan) / (((double)bnew.ns / bnew.nbnum) - nsscan));
+		printf("%-40s %10s %8s %12s %9.1f MB/s %7.1f MB/s\n\r", "", "", "", "",
+				(double)bref.nbdigits * 1e3 / bref.ns, (double)bnew.nbdigits * 1e3 / bnew.ns);
+	}
+
+	exit(EXIT_SUCCESS);
+}
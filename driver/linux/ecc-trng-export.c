@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Export of random bytes produced by the IP TRNG (IP synthesized with
+ * 'trngexport' = TRUE in HW unsecure mode), using hw_driver_get_random().
+ *
+ * Reads the requested nb of bytes by batches of a given size and either
+ * writes them out (e.g to feed the entropy pool of a software DRBG) or
+ * simply measures the throughput of the export.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#define BATCH_MAX   (1024 * 1024)
+
+static uint8_t batch[BATCH_MAX];
+
+static void usage(const char* prog)
+{
+	printf("Usage: %s [-n bytes] [-b batch] [-o file]\n\r", prog);
+	printf("  -n : nb of random bytes to read (default 1048576)\n\r");
+	printf("  -b : nb of bytes per call to hw_driver_get_random() (default 4096, max %d)\n\r",
+			BATCH_MAX);
+	printf("  -o : output file ('-' for standard output), otherwise bytes\n\r");
+	printf("       are only read to measure the throughput\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+	int opt;
+	uint32_t total = 1024 * 1024, bsz = 4096, sz, done = 0;
+	const char* outname = NULL;
+	FILE* out = NULL;
+	struct timespec t0, t1;
+	double sec;
+
+	while ((opt = getopt(argc, argv, "n:b:o:h")) != -1) {
+		switch (opt) {
+			case 'n':
+				total = strtoul(optarg, NULL, 0);
+				break;
+			case 'b':
+				bsz = strtoul(optarg, NULL, 0);
+				break;
+			case 'o':
+				outname = optarg;
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if ((bsz == 0) || (bsz > BATCH_MAX)) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	if (outname) {
+		if (strcmp(outname, "-") == 0) {
+			out = stdout;
+		} else if ((out = fopen(outname, "wb")) == NULL) {
+			fprintf(stderr, "%sError: can't open file '%s'.%s\n\r", KERR, outname, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	while (done < total) {
+		sz = ((total - done) < bsz) ? (total - done) : bsz;
+		if (hw_driver_get_random(batch, sz)) {
+			fprintf(stderr, "%sError: Reading random from the IP triggered an error"
+					" (was it synthesized with 'trngexport' = TRUE and 'hwsecure' = FALSE?).%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+		if (out && (fwrite(batch, 1, sz, out) != sz)) {
+			fprintf(stderr, "%sError: Writing random bytes failed.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+		done += sz;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	if (out && (out != stdout)) {
+		fclose(out);
+	}
+
+	/* Throughput (includes the time to write the output, if any) */
+	sec = (double)(t1.tv_sec - t0.tv_sec) + ((double)(t1.tv_nsec - t0.tv_nsec) / 1e9);
+	fprintf(stderr, "%d bytes in %.3f s (batches of %d bytes): %.1f kB/s, %.3f Mbit/s\n\r",
+			done, sec, bsz, (sec > 0) ? ((double)done / 1024. / sec) : 0.,
+			(sec > 0) ? ((double)done * 8. / 1e6 / sec) : 0.);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Writes the byte sequence that hw_driver_pseudotrng_replay_start_DBG()
+ * replays for a given seed into a file in the format of HDL parameter
+ * 'simtrngfile' (one byte per line, in decimal), so that the GHDL
+ * testbench consumes the very same raw random as the hardware.
+ *
+ * Doesn't access the IP, hence can be run on the simulation host.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CHUNK   4096
+
+static void usage(const char* prog)
+{
+	printf("Usage: %s -s seed [-n bytes] [-o file]\n\r", prog);
+	printf("  -s : seed of the replay PRNG\n\r");
+	printf("  -n : nb of bytes (default 134217728, as in sim/HOWTO-random.txt)\n\r");
+	printf("  -o : output file (default /tmp/random.txt, '-' for standard output)\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+	int opt;
+	uint64_t seed = 0, total = 128 * 1024 * 1024, done;
+	uint32_t i, sz;
+	bool has_seed = false;
+	const char* outname = "/tmp/random.txt";
+	FILE* out;
+	uint8_t buf[CHUNK];
+
+	while ((opt = getopt(argc, argv, "s:n:o:h")) != -1) {
+		switch (opt) {
+			case 's':
+				seed = strtoull(optarg, NULL, 0);
+				has_seed = true;
+				break;
+			case 'n':
+				total = strtoull(optarg, NULL, 0);
+				break;
+			case 'o':
+				outname = optarg;
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if (!has_seed) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	if (strcmp(outname, "-") == 0) {
+		out = stdout;
+	} else if ((out = fopen(outname, "w")) == NULL) {
+		fprintf(stderr, "%sError: can't open file '%s'.%s\n\r", KERR, outname, KNRM);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Same chunking as the replay (a multiple of 8 bytes, so that no output
+	 * word of the PRNG is truncated but the very last one) */
+	for (done = 0; done < total; done += sz) {
+		sz = ((total - done) < CHUNK) ? (uint32_t)(total - done) : CHUNK;
+		hw_driver_pseudotrng_prng(&seed, buf, sz);
+		for (i = 0; i < sz; i++) {
+			if (fprintf(out, "%u\n", buf[i]) < 0) {
+				fprintf(stderr, "%sError: Writing output file failed.%s\n\r", KERR, KNRM);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	if (out != stdout) {
+		fclose(out);
+	}
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,428 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Sizing study of the FIFOs of random numbers of the IP TRNG.
+ *
+ * Runs back-to-back [k]P computations (with random scalars) on one of the
+ * NIST curves P-256, P-384 or P-521 and after each of them reads back the
+ * TRNG diagnostic counters maintained by ecc_axi (see (s260) in ecc_axi.vhd),
+ * i.e for each client of ecc_trng_srv:
+ *
+ *   - the min & max fill level of its FIFO during the computation,
+ *   - the nb of clock cycles where it was starving,
+ *   - the nb of random words it actually got.
+ *
+ * These are dumped as CSV lines (one per client and per computation) to
+ * be plotted over time, and the program then recommends, for each client,
+ * the smallest value of parameter 'trng_ramsz_[raw|axi|efp|crv|shf]' (see
+ * ecc_customize.vhd) that would have seen no starvation for the same load.
+ *
+ * Diagnostic counters are only available in HW unsecure mode.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NB_CLIENTS   5
+#define NBMAXSZ      1024
+
+typedef struct {
+	const char* name;
+	const char* p;
+	const char* a;
+	const char* b;
+	const char* q;
+	const char* px;
+	const char* py;
+} sizing_curve_t;
+
+static const sizing_curve_t curves[] = {
+	{ "P-256",
+		"ffffffff00000001000000000000000000000000ffffffffffffffffffffffff",
+		"ffffffff00000001000000000000000000000000fffffffffffffffffffffffc",
+		"5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b",
+		"ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551",
+		"6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",
+		"4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5" },
+	{ "P-384",
+		"fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+		"ffffffff0000000000000000ffffffff",
+		"fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+		"ffffffff0000000000000000fffffffc",
+		"b3312fa7e23ee7e4988e056be3f82d19181d9c6efe8141120314088f5013875a"
+		"c656398d8a2ed19d2a85c8edd3ec2aef",
+		"ffffffffffffffffffffffffffffffffffffffffffffffffc7634d81f4372ddf"
+		"581a0db248b0a77aecec196accc52973",
+		"aa87ca22be8b05378eb1c71ef320ad746e1d3b628ba79b9859f741e082542a38"
+		"5502f25dbf55296c3a545e3872760ab7",
+		"3617de4a96262c6f5d9e98bf9292dc29f8f41dbd289a147ce9da3113b5f0b8c0"
+		"0a60b1ce1d7e819d7a431d7c90ea0e5f" },
+	{ "P-521",
+		"01ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+		"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+		"ffff",
+		"01ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+		"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+		"fffc",
+		"0051953eb9618e1c9a1f929a21a0b68540eea2da725b99b315f3b8b489918ef1"
+		"09e156193951ec7e937b1652c0bd3bb1bf073573df883d2c34f1ef451fd46b50"
+		"3f00",
+		"01ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+		"fa51868783bf2f966b7fcc0148f709a5d03bb5c9b8899c47aebb6fb71e913864"
+		"09",
+		"00c6858e06b70404e9cd9e3ecb662395b4429c648139053fb521f828af606b4d"
+		"3dbaa14b5e77efe75928fe1dc127a2ffa8de3348b3c1856a429bf97e7e31c2e5"
+		"bd66",
+		"011839296a789a3bc0045c8a5fb42c7d1bd998f54449579b446817afbd17273e"
+		"662c97ee72995ef42640c550b9013fad0761353c7086a272c24088be94769fd1"
+		"6650" },
+};
+
+/*
+ * Statistics gathered over the whole run for one client of ecc_trng_srv.
+ */
+typedef struct {
+	const char* name;
+	const char* param;  /* associated parameter in ecc_customize.vhd */
+	uint32_t width;     /* bitwidth of one FIFO element */
+	uint32_t fill;      /* largest fill level ever seen (i.e FIFO capacity) */
+	uint32_t drain;     /* largest (max - min) fill level within one [k]P */
+	uint32_t words;     /* largest nb of words consumed within one [k]P */
+	uint32_t starved;   /* nb of [k]P during which the client starved */
+	uint64_t starv;     /* total nb of starving cycles */
+	uint64_t ok;        /* total nb of words consumed */
+} sizing_client_t;
+
+/*
+ * Convert an hexadecimal string into a big-endian byte buffer of 'sz' bytes
+ * (left-padded with 0s).
+ */
+static int hex_to_bytes(const char* hex, uint8_t* buf, uint32_t sz)
+{
+	uint32_t len = strlen(hex);
+	uint32_t i, nbytes = (len + 1) / 2;
+	char tmp[3] = { 0, 0, 0 };
+
+	if (nbytes > sz) {
+		return -1;
+	}
+	memset(buf, 0, sz);
+	for (i = 0; i < nbytes; i++) {
+		/* First byte may be a half one if 'len' is odd */
+		if ((i == 0) && (len & 1)) {
+			tmp[0] = '0';
+			tmp[1] = hex[0];
+		} else {
+			tmp[0] = hex[2 * i - (len & 1)];
+			tmp[1] = hex[2 * i - (len & 1) + 1];
+		}
+		buf[sz - nbytes + i] = (uint8_t)strtoul(tmp, NULL, 16);
+	}
+	return 0;
+}
+
+/*
+ * Smallest power of 2 greater or equal to 'x' (the way ecc_trng_pkg
+ * rounds FIFO sizes, see function ge_pow_of_2() in ecc_utils.vhd).
+ */
+static uint32_t ge_pow_of_2(uint32_t x)
+{
+	uint32_t r = 1;
+
+	while (r < x) {
+		r <<= 1;
+	}
+	return r;
+}
+
+/*
+ * Smallest value (in kB) of parameter 'trng_ramsz_*' yielding a FIFO of at
+ * least 'words' elements of 'width' bits each.
+ */
+static uint32_t ramsz_for(uint32_t words, uint32_t width)
+{
+	uint32_t kb = ((words * width) + 8191) / 8192;
+
+	return (kb == 0) ? 1 : kb;
+}
+
+static void usage(const char* prog)
+{
+	printf("Usage: %s [-c 256|384|521] [-n nn] [-b blinding] [-s 0|1]\n\r", prog);
+	printf("          [-k nb] [-i usec] [-o file.csv]\n\r");
+	printf("  -c : curve (P-256, P-384 or P-521, default P-256)\n\r");
+	printf("  -n : value of nn (multiple of 8, default: smallest one fitting the curve)\n\r");
+	printf("  -b : blinding size in bits (0 = no blinding, default 0)\n\r");
+	printf("  -s : shuffling of the memory of large numbers (default 0)\n\r");
+	printf("  -k : nb of [k]P computations (default 1000)\n\r");
+	printf("  -i : idle time between two computations in usec (default 0 = back-to-back)\n\r");
+	printf("  -o : CSV output file (default: standard output)\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+	int opt;
+	uint32_t i, j, c;
+	const sizing_curve_t* crv = &curves[0];
+	uint32_t nn = 0, blinding = 0, nbkp = 1000, idle = 0;
+	bool shuffle = false;
+	const char* csvname = NULL;
+	FILE* csv = stdout;
+
+	/* HW capabilities */
+	bool hw_unsecure, secure, shf, nndyn, axi64;
+	uint32_t nnmax, ww, nbop, opsz, rawramsz, irnshw;
+
+	uint8_t p[NBMAXSZ], a[NBMAXSZ], b[NBMAXSZ], q[NBMAXSZ];
+	uint8_t px[NBMAXSZ], py[NBMAXSZ], k[NBMAXSZ];
+	uint8_t kpx[NBMAXSZ], kpy[NBMAXSZ];
+	uint32_t sz, kpx_sz, kpy_sz, kp_time;
+
+	trng_diagcnt_t tdg;
+	uint32_t dmin[NB_CLIENTS], dmax[NB_CLIENTS], dok[NB_CLIENTS], dstarv[NB_CLIENTS];
+	sizing_client_t cl[NB_CLIENTS] = {
+		{ "raw", "trng_ramsz_raw", 1, 0, 0, 0, 0, 0, 0 },
+		{ "axi", "trng_ramsz_axi", 0, 0, 0, 0, 0, 0, 0 },
+		{ "efp", "trng_ramsz_efp", 0, 0, 0, 0, 0, 0, 0 },
+		{ "crv", "trng_ramsz_crv", 2, 0, 0, 0, 0, 0, 0 },
+		{ "shf", "trng_ramsz_shf", 0, 0, 0, 0, 0, 0, 0 },
+	};
+	uint32_t need;
+
+	while ((opt = getopt(argc, argv, "c:n:b:s:k:i:o:h")) != -1) {
+		switch (opt) {
+			case 'c':
+				if (strcmp(optarg, "256") == 0) {
+					crv = &curves[0];
+				} else if (strcmp(optarg, "384") == 0) {
+					crv = &curves[1];
+				} else if (strcmp(optarg, "521") == 0) {
+					crv = &curves[2];
+				} else {
+					usage(argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			case 'n':
+				nn = strtoul(optarg, NULL, 0);
+				break;
+			case 'b':
+				blinding = strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				shuffle = (strtoul(optarg, NULL, 0) != 0);
+				break;
+			case 'k':
+				nbkp = strtoul(optarg, NULL, 0);
+				break;
+			case 'i':
+				idle = strtoul(optarg, NULL, 0);
+				break;
+			case 'o':
+				csvname = optarg;
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	/* Diagnostic counters only exist in HW unsecure mode */
+	if (hw_driver_is_hw_unsecure(&hw_unsecure)) {
+		printf("%sError: Probing 'HW secure/unsecure mode' triggered an error.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (!hw_unsecure) {
+		printf("%sError: TRNG diagnostics are only available in HW unsecure mode.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (hw_driver_get_capabilities(&secure, &shf, &nndyn, &axi64, &nnmax)
+			|| hw_driver_get_more_capabilities_DBG(&ww, &nbop, &opsz, &rawramsz, &irnshw)) {
+		printf("%sError: Probing capabilities of the IP triggered an error.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	cl[1].width = ww;
+	cl[2].width = ww;
+	cl[4].width = irnshw;
+
+	/* Curve size (nn is derived by the driver from the byte size of p & q) */
+	sz = (strlen(crv->p) + 1) / 2;
+	if (nn == 0) {
+		nn = 8 * sz;
+	}
+	if ((nn % 8) || (nn < (8 * sz)) || (nn > nnmax) || ((nn != nnmax) && !nndyn)) {
+		printf("%sError: nn = %d can't be used with curve %s on this IP (nnmax = %d%s).%s\n\r",
+				KERR, nn, crv->name, nnmax, nndyn ? "" : ", no dynamic nn", KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (shuffle && !shf) {
+		printf("%sError: IP was not synthesized with shuffling support.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	sz = nn / 8;
+
+	if (csvname) {
+		if ((csv = fopen(csvname, "w")) == NULL) {
+			printf("%sError: can't open file '%s'.%s\n\r", KERR, csvname, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	 * In HW unsecure mode the pulling of raw random bytes by the
+	 * post-processing function is disabled upon reset.
+	 */
+	if (hw_driver_trng_post_proc_enable_DBG()) {
+		printf("%sError: Enabling TRNG post-processing on hardware triggered an error.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Set the curve & the countermeasures */
+	hex_to_bytes(crv->p, p, sz);
+	hex_to_bytes(crv->a, a, sz);
+	hex_to_bytes(crv->b, b, sz);
+	hex_to_bytes(crv->q, q, sz);
+	hex_to_bytes(crv->px, px, sz);
+	hex_to_bytes(crv->py, py, sz);
+	if (hw_driver_set_curve(a, sz, b, sz, p, sz, q, sz)) {
+		printf("%sError: Setting curve %s triggered an error.%s\n\r", KERR, crv->name, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (blinding) {
+		if (hw_driver_enable_blinding_and_set_size(blinding)) {
+			printf("%sError: Setting blinding size triggered an error.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	} else if (hw_driver_disable_blinding()) {
+		printf("%sError: Disabling blinding triggered an error.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (shf) {
+		if ((shuffle ? hw_driver_enable_shuffling() : hw_driver_disable_shuffling())) {
+			printf("%sError: Setting shuffling mode triggered an error.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	printf("Curve %s, nn = %d, blinding = %d, shuffle = %s, %d [k]P, %d us idle\n\r",
+			crv->name, nn, blinding, shuffle ? "on" : "off", nbkp, idle);
+	fprintf(csv, "kp,cycles,client,min,max,ok,starv\n");
+
+	/* Back-to-back [k]P computations */
+	for (i = 0; i < nbkp; i++) {
+		/* Random scalar, lower than q */
+		for (j = 0; j < sz; j++) {
+			k[j] = (uint8_t)rand();
+		}
+		for (j = 0; (j < sz) && (q[j] == 0); j++) {
+			k[j] = 0;
+		}
+		if (j < sz) {
+			k[j] &= (q[j] >> 1);
+		}
+		kpx_sz = kpy_sz = sz;
+		if (hw_driver_mul(px, sz, py, sz, k, sz, kpx, &kpx_sz, kpy, &kpy_sz,
+					&kp_time, NULL, NULL)) {
+			printf("%sError: [k]P computation #%d triggered an error.%s\n\r", KERR, i, KNRM);
+			exit(EXIT_FAILURE);
+		}
+		/* Diagnostic counters were reset at the start of the computation */
+		if (hw_driver_get_trng_diagnostics_DBG(&tdg)) {
+			printf("%sError: Reading TRNG diagnostics triggered an error.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+		dmin[0] = tdg.rawmin; dmax[0] = tdg.rawmax; dok[0] = tdg.rawok; dstarv[0] = tdg.rawstarv;
+		dmin[1] = tdg.aximin; dmax[1] = tdg.aximax; dok[1] = tdg.axiok; dstarv[1] = tdg.axistarv;
+		dmin[2] = tdg.efpmin; dmax[2] = tdg.efpmax; dok[2] = tdg.efpok; dstarv[2] = tdg.efpstarv;
+		dmin[3] = tdg.crvmin; dmax[3] = tdg.crvmax; dok[3] = tdg.crvok; dstarv[3] = tdg.crvstarv;
+		dmin[4] = tdg.shfmin; dmax[4] = tdg.shfmax; dok[4] = tdg.shfok; dstarv[4] = tdg.shfstarv;
+		for (c = 0; c < NB_CLIENTS; c++) {
+			if ((c == 4) && !shuffle) {
+				continue;
+			}
+			/* Min is left to all 1s if the FIFO was never sampled */
+			if (dmin[c] > dmax[c]) {
+				dmin[c] = dmax[c];
+			}
+			fprintf(csv, "%d,%d,%s,%d,%d,%d,%d\n", i, kp_time, cl[c].name,
+					dmin[c], dmax[c], dok[c], dstarv[c]);
+			if (dmax[c] > cl[c].fill) {
+				cl[c].fill = dmax[c];
+			}
+			if ((dmax[c] - dmin[c]) > cl[c].drain) {
+				cl[c].drain = dmax[c] - dmin[c];
+			}
+			if (dok[c] > cl[c].words) {
+				cl[c].words = dok[c];
+			}
+			if (dstarv[c]) {
+				cl[c].starved++;
+			}
+			cl[c].starv += dstarv[c];
+			cl[c].ok += dok[c];
+		}
+		if (idle) {
+			usleep(idle);
+		}
+	}
+
+	if (csvname) {
+		fclose(csv);
+	}
+
+	/*
+	 * Recommendation.
+	 *
+	 * A client which never starved never needed more than 'drain' words
+	 * in its FIFO at the start of a computation: this, rounded up to the
+	 * next power of 2 by ecc_trng_pkg, is the smallest size that would
+	 * have sustained the same load.
+	 *
+	 * A client which starved emptied its FIFO: all we know is that a FIFO
+	 * able to hold all the words consumed in one computation, and refilled
+	 * in-between two of them, can't starve. If starvation remains with that
+	 * size (or with the FIFO already larger) then the bottleneck is the
+	 * throughput of the entropy source ('nbtrng', 'trngta'), not the size.
+	 */
+	printf("\n\r%-16s %6s %8s %8s %8s %10s %10s\n\r", "parameter", "width",
+			"fill", "drain", "starved", "need(wd)", "need(kB)");
+	for (c = 0; c < NB_CLIENTS; c++) {
+		if ((c == 4) && !shuffle) {
+			continue;
+		}
+		need = ge_pow_of_2(cl[c].starved ? cl[c].words : cl[c].drain);
+		printf("%s%-16s %6d %8d %8d %8d %10d %10d%s\n\r",
+				cl[c].starved ? KORA : KNRM, cl[c].param, cl[c].width, cl[c].fill,
+				cl[c].drain, cl[c].starved, need, ramsz_for(need, cl[c].width), KNRM);
+		if (cl[c].starved && (need <= cl[c].fill)) {
+			printf("%s  '%s' starved although its FIFO can hold a whole [k]P worth of random:"
+					" increase 'nbtrng' or the idle time instead.%s\n\r", KORA, cl[c].name, KNRM);
+		}
+	}
+	for (c = 0; c < NB_CLIENTS; c++) {
+		if (cl[c].starv + cl[c].ok) {
+			printf("%s: %d%% of starving cycles\n\r", cl[c].name,
+					(uint32_t)((100 * cl[c].starv) / (cl[c].starv + cl[c].ok)));
+		}
+	}
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * HDR-style (log-linear) histograms of durations.
+ *
+ * Values below 2^HDR_SUB_BITS have one bucket each, then each power of
+ * two is split into 2^HDR_SUB_BITS buckets of equal width, so that the
+ * relative error on any value is at most 2^-HDR_SUB_BITS (~3%) whatever
+ * its magnitude, with a fixed number of buckets. Values of 2^(HDR_MSB_MAX+1)
+ * or more fall in the last bucket (min & max are exact anyway).
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "ecc-test-linux.h"
+
+#define HDR_SUB  (1U << HDR_SUB_BITS)
+
+static inline uint32_t hdr_index(uint64_t v)
+{
+	uint32_t msb;
+
+	if (v < HDR_SUB) {
+		return (uint32_t)v;
+	}
+	msb = 63 - __builtin_clzll(v);
+	if (msb > HDR_MSB_MAX) {
+		return HDR_NB_BUCKETS - 1;
+	}
+	return ((msb - HDR_SUB_BITS + 1) << HDR_SUB_BITS) + ((v >> (msb - HDR_SUB_BITS)) & (HDR_SUB - 1));
+}
+
+/* Lowest value of bucket 'i' */
+uint64_t hdr_bucket_lo(uint32_t i)
+{
+	uint32_t e = i >> HDR_SUB_BITS;
+
+	if (e == 0) {
+		return i;
+	}
+	return ((uint64_t)(HDR_SUB + (i & (HDR_SUB - 1)))) << (e - 1);
+}
+
+/* Highest value of bucket 'i' */
+uint64_t hdr_bucket_hi(uint32_t i)
+{
+	if (i == (HDR_NB_BUCKETS - 1)) {
+		return UINT64_MAX;
+	}
+	return hdr_bucket_lo(i + 1) - 1;
+}
+
+void hdr_add(hdr_t* h, uint64_t v)
+{
+	h->cnt[hdr_index(v)]++;
+	if ((h->n == 0) || (v < h->min)) {
+		h->min = v;
+	}
+	if (v > h->max) {
+		h->max = v;
+	}
+	h->n++;
+}
+
+void hdr_merge(hdr_t* dst, const hdr_t* src)
+{
+	uint32_t i;
+
+	if (src->n == 0) {
+		return;
+	}
+	for (i = 0; i < HDR_NB_BUCKETS; i++) {
+		dst->cnt[i] += src->cnt[i];
+	}
+	if ((dst->n == 0) || (src->min < dst->min)) {
+		dst->min = src->min;
+	}
+	if (src->max > dst->max) {
+		dst->max = src->max;
+	}
+	dst->n += src->n;
+}
+
+/*
+ * Value below which a fraction 'p' of the samples fall (highest value of
+ * their bucket, bounded by the max), 0 if the histogram is empty.
+ */
+uint64_t hdr_percentile(const hdr_t* h, double p)
+{
+	uint64_t rank, acc = 0, hi;
+	uint32_t i;
+
+	if (h->n == 0) {
+		return 0;
+	}
+	rank = (uint64_t)(p * h->n);
+	if (rank >= h->n) {
+		rank = h->n - 1;
+	}
+	for (i = 0; i < HDR_NB_BUCKETS; i++) {
+		acc += h->cnt[i];
+		if (acc > rank) {
+			break;
+		}
+	}
+	hi = hdr_bucket_hi(i);
+	if (hi > h->max) {
+		hi = h->max;
+	}
+	if (hi < h->min) {
+		hi = h->min;
+	}
+	return hi;
+}
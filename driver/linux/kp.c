@@ -24,7 +24,34 @@
 extern uint32_t zmask[];
 #endif
 
-extern int cmp_two_pts_coords(point_t*, point_t*, bool*);
+/* Also used by linux/ptops.c */
+int cmp_two_pts_coords(point_t* p0, point_t* p1, bool* res)
+{
+	uint32_t i;
+
+	/*
+	 * If four coordinates sizes do not match, that's an error
+	 * (don't even compare).
+	 */
+	if ( (p0->x.sz != p0->y.sz) || (p0->x.sz != p1->x.sz) || (p0->y.sz != p1->x.sz)
+			|| (p0->y.sz != p1->y.sz) || (p1->x.sz != p1->y.sz) )
+	{
+		printf("%sError: can't compare coord. buffers that are not of the same byte size to begin with.%s\n\r",
+				KERR, KNRM);
+		goto err;
+	}
+	/* Compare the X & Y coordinates one byte after the other. */
+	*res = true;
+	for (i = 0; i < p0->x.sz; i++) {
+		if ((p0->x.val[i] != p1->x.val[i]) || (p0->y.val[i] != p1->y.val[i])) {
+			*res = false;
+			break;
+		}
+	}
+	return 0;
+err:
+	return -1;
+}
 
 int ip_test_set_pt_and_run_kp(ipecc_test_t* t)
 {
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Mock backend of ecc-test-linux (option -m): nothing is sent to the IP,
+ * the "hardware" result of each test is simply its expected one, after
+ * busy-waiting a given time to stand for the IP computation (the driver
+ * polls the IP too), the same time being spent to set a curve. Used to
+ * measure the throughput of the harness itself (parsing, checking,
+ * pipeline, batching) with or without the IP in the system.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "ecc-test-linux.h"
+
+static void mock_busy_wait(uint32_t usec)
+{
+	struct timespec t0, t;
+
+	if (usec == 0) {
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &t);
+	} while ((((t.tv_sec - t0.tv_sec) * 1000000L) + ((t.tv_nsec - t0.tv_nsec) / 1000L)) < (long)usec);
+}
+
+/* Set curve 'crv', which takes 'usec' microseconds */
+int mock_set_curve(curve_t* crv, uint32_t usec)
+{
+	if ((crv->valid == false) || (crv->p.valid == false) || (crv->a.valid == false)
+			|| (crv->b.valid == false) || (crv->q.valid == false)) {
+		printf("%sError: Can't set mock backend with curve (incomplete description).%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	/* Stands for the transfer of parameters & the computation of constants */
+	mock_busy_wait(usec);
+	crv->set_in_hw = true;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Run test 't', the operation taking 'usec' microseconds */
+int mock_run(ipecc_test_t* t, uint32_t usec)
+{
+	if (t->curve->set_in_hw == false) {
+		printf("%sError: Can't run test on mock backend, curve not set.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	mock_busy_wait(usec);
+	switch (t->op) {
+		case OP_KP:
+		case OP_PTADD:
+		case OP_PTDBL:
+		case OP_PTNEG:
+			memcpy(&t->pt_hw_res, &t->pt_sw_res, sizeof(point_t));
+			t->pt_hw_res.valid = true;
+			break;
+		case OP_TST_CHK:
+		case OP_TST_EQU:
+		case OP_TST_OPP:
+			t->hw_answer = t->sw_answer;
+			t->hw_answer.valid = true;
+			break;
+		default:
+			goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
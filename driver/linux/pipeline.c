@@ -0,0 +1,255 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Pipelined execution of tests (option -p of ecc-test-linux).
+ *
+ * Three stages, each in its own thread:
+ *
+ *   - the parser (the main thread, through pipeline_submit_*()) fills
+ *     slots with curves & tests as soon as they're read from input;
+ *   - the hardware stage has the IP process them (set curve, run the
+ *     operation), in order;
+ *   - the checker stage compares results with the expected ones, updates
+ *     statistics & exits on any error, as run_test() would do.
+ *
+ * Slots are allocated once. Their indexes go round three single-producer/
+ * single-consumer lock-free rings: free (checker -> parser), hw (parser ->
+ * hardware) & chk (hardware -> checker). Each ring can hold all the slots,
+ * so the only stage that can be blocked by a full pipeline is the parser,
+ * and as long as it's ahead the hardware stage always has a test waiting.
+ *
+ * Each slot embeds a copy of the curve of its test, so that the checker
+ * (which needs its parameters to print errors) can lag behind a change
+ * of curve. Note that with -DKP_TRACE the [k]P trace log is that of the
+ * last [k]P run by the hardware stage, which may not be the one being
+ * checked: use the sequential mode to debug.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "ecc-test-linux.h"
+
+/* Stages (see ecc-test-linux.c) */
+extern int stage_hw_curve(curve_t*);
+extern int stage_hw_test(ipecc_test_t*);
+extern void stage_chk_curve(curve_t*, all_stats_t*, int, const char*, unsigned int);
+extern void stage_chk_test(ipecc_test_t*, all_stats_t*, int, const char*, unsigned int);
+
+static pipe_slot_t* slots = NULL;
+static uint32_t nbslots;
+static spsc_t ring_free, ring_hw, ring_chk;
+static pthread_t tid_hw, tid_chk;
+static all_stats_t* pstats;
+
+/* Hardware stage is the only writer of the 'hw_' counters,
+ * the parser of the 'parse_' ones */
+static uint64_t hw_busy_ns = 0;
+static uint64_t hw_wait_ns = 0;
+static uint64_t hw_nbwait = 0;
+static uint64_t parse_wait_ns = 0;
+static uint64_t parse_nbwait = 0;
+
+static inline uint64_t pipe_now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return ((uint64_t)t.tv_sec * 1000000000ULL) + t.tv_nsec;
+}
+
+static int spsc_init(spsc_t* r, uint32_t sz)
+{
+	atomic_init(&r->head, 0);
+	atomic_init(&r->tail, 0);
+	r->mask = sz - 1;
+	if ((r->idx = malloc(sz * sizeof(uint32_t))) == NULL) {
+		return -1;
+	}
+	return 0;
+}
+
+/* Rings never hold more than all the slots, so a push never waits */
+static inline void spsc_push(spsc_t* r, uint32_t i)
+{
+	uint32_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+
+	r->idx[h & r->mask] = i;
+	atomic_store_explicit(&r->head, h + 1, memory_order_release);
+}
+
+/* Pop next index, yielding the CPU while the ring is empty
+ * (the time spent waiting is accounted in 'wait_ns' & 'nbwait') */
+static inline uint32_t spsc_pop(spsc_t* r, uint64_t* wait_ns, uint64_t* nbwait)
+{
+	uint32_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+	uint32_t i;
+	uint64_t t0;
+
+	if (atomic_load_explicit(&r->head, memory_order_acquire) == t) {
+		t0 = pipe_now_ns();
+		while (atomic_load_explicit(&r->head, memory_order_acquire) == t) {
+			sched_yield();
+		}
+		if (wait_ns) {
+			*wait_ns += pipe_now_ns() - t0;
+			(*nbwait)++;
+		}
+	}
+	i = r->idx[t & r->mask];
+	atomic_store_explicit(&r->tail, t + 1, memory_order_release);
+
+	return i;
+}
+
+static void* pipe_hw_thread(void* arg)
+{
+	pipe_slot_t* s;
+	bool curve_set = false;
+	uint64_t t0;
+
+	(void)arg;
+	for (;;) {
+		s = &slots[spsc_pop(&ring_hw, &hw_wait_ns, &hw_nbwait)];
+		t0 = pipe_now_ns();
+		switch (s->type) {
+			case JOB_CURVE:
+				s->hwerr = stage_hw_curve(&s->curve);
+				curve_set = (s->hwerr == 0);
+				break;
+			case JOB_TEST:
+				s->curve.set_in_hw = curve_set;
+				s->hwerr = stage_hw_test(&s->test);
+				break;
+			case JOB_END:
+			default:
+				spsc_push(&ring_chk, s - slots);
+				return NULL;
+		}
+		hw_busy_ns += pipe_now_ns() - t0;
+		spsc_push(&ring_chk, s - slots);
+	}
+}
+
+static void* pipe_chk_thread(void* arg)
+{
+	pipe_slot_t* s;
+
+	(void)arg;
+	for (;;) {
+		s = &slots[spsc_pop(&ring_chk, NULL, NULL)];
+		switch (s->type) {
+			case JOB_CURVE:
+				stage_chk_curve(&s->curve, pstats, s->hwerr, s->dbg, s->linenum);
+				break;
+			case JOB_TEST:
+				stage_chk_test(&s->test, pstats, s->hwerr, s->dbg, s->linenum);
+				break;
+			case JOB_END:
+			default:
+				return NULL;
+		}
+		spsc_push(&ring_free, s - slots);
+	}
+}
+
+/* 'depth' is the nb of slots (rounded up to a power of 2) */
+int pipeline_start(uint32_t depth, all_stats_t* st)
+{
+	uint32_t i;
+
+	for (nbslots = 2; nbslots < depth; nbslots <<= 1)
+		;
+	if ((slots = malloc(nbslots * sizeof(pipe_slot_t))) == NULL) {
+		printf("%sError: Can't allocate %d slots for the pipeline.%s\n\r", KERR, nbslots, KNRM);
+		goto err;
+	}
+	if (spsc_init(&ring_free, nbslots) || spsc_init(&ring_hw, nbslots) || spsc_init(&ring_chk, nbslots)) {
+		printf("%sError: Can't allocate rings for the pipeline.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	for (i = 0; i < nbslots; i++) {
+		spsc_push(&ring_free, i);
+	}
+	pstats = st;
+	if (pthread_create(&tid_hw, NULL, pipe_hw_thread, NULL)
+			|| pthread_create(&tid_chk, NULL, pipe_chk_thread, NULL)) {
+		printf("%sError: Can't create threads of the pipeline.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+static inline pipe_slot_t* pipe_get_slot(job_t type, const char* dbg, unsigned int linenum)
+{
+	pipe_slot_t* s = &slots[spsc_pop(&ring_free, &parse_wait_ns, &parse_nbwait)];
+
+	s->type = type;
+	snprintf(s->dbg, sizeof(s->dbg), "%s", dbg);
+	s->linenum = linenum;
+
+	return s;
+}
+
+void pipeline_submit_curve(curve_t* crv, const char* dbg, unsigned int linenum)
+{
+	pipe_slot_t* s = pipe_get_slot(JOB_CURVE, dbg, linenum);
+
+	memcpy(&s->curve, crv, sizeof(curve_t));
+	spsc_push(&ring_hw, s - slots);
+}
+
+void pipeline_submit_test(ipecc_test_t* t, const char* dbg, unsigned int linenum)
+{
+	pipe_slot_t* s = pipe_get_slot(JOB_TEST, dbg, linenum);
+
+	memcpy(&s->curve, t->curve, sizeof(curve_t));
+	memcpy(&s->test, t, sizeof(ipecc_test_t));
+	s->test.curve = &s->curve;
+	spsc_push(&ring_hw, s - slots);
+}
+
+/* Wait for all submitted jobs to be checked */
+void pipeline_end(void)
+{
+	pipe_slot_t* s = pipe_get_slot(JOB_END, "", 0);
+
+	spsc_push(&ring_hw, s - slots);
+	pthread_join(tid_hw, NULL);
+	pthread_join(tid_chk, NULL);
+}
+
+/* 'elapsed' is the time since the first job, in seconds */
+void pipeline_print_stats(double elapsed)
+{
+	if (slots == NULL) {
+		return;
+	}
+	printf("Pipeline (%d slots): hardware stage busy %.1f%% of the time, waited %llu times for"
+			" the parser (%.3f s), parser waited %llu times for a free slot (%.3f s)\n\r", nbslots,
+			(elapsed > 0) ? (100. * hw_busy_ns) / (elapsed * 1e9) : 0.,
+			(unsigned long long)hw_nbwait, hw_wait_ns / 1e9,
+			(unsigned long long)parse_nbwait, parse_wait_ns / 1e9);
+}
@@ -0,0 +1,285 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Reader of the binary test-vector stream (produced by generate-tests.sage
+ * with BINARY = True, or converted from the text format with sage/tvbin.py).
+ *
+ * The stream starts with the 8-byte magic TVBIN_MAGIC followed by records,
+ * each made of an 8-byte header:
+ *
+ *   type (1 byte) | flags (1 byte) | 0 (2 bytes) | len (4 bytes, little endian)
+ *
+ * and 'len' bytes of payload. Integers in payloads are 32-bit little endian,
+ * large numbers are big endian on exactly NN_SZ(nn) bytes, the byte order of
+ * large_number_t, so they're simply copied in place. Records of unknown type
+ * are skipped.
+ *
+ *   TVBIN_REC_CURVE: id, nn, p, a, b, q
+ *   TVBIN_REC_TEST:  op, curve id, test id, nbbld, then
+ *                      Px Py (unless flag TVBIN_F_P_NULL)
+ *                      Qx Qy (OP_PTADD, OP_TST_EQU, OP_TST_OPP, unless TVBIN_F_Q_NULL)
+ *                      k     (OP_KP)
+ *                      Rx Ry (result of OP_KP, OP_PTADD, OP_PTDBL, OP_PTNEG,
+ *                             unless TVBIN_F_R_NULL)
+ *   TVBIN_REC_COMMENT: one "# ..." line of the text format (only kept for
+ *                    sage/tvbin.py to decode the stream back into text)
+ *
+ * A regular file is mmap'ed and records are handed out in place, otherwise
+ * (pipe, socket) each record is read into one buffer.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ecc-test-linux.h"
+
+/* Largest possible record (a P + Q test) */
+#define TVBIN_REC_MAX    (16 + (6 * NBMAXSZ))
+
+static inline uint32_t tvbin_le32(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Does the stream start with the magic of the binary format?
+ * (only its first character is looked at, as it can't start a line
+ * of the text format, so it can be pushed back in case it's not) */
+bool tvbin_probe(FILE* fp)
+{
+	int c;
+
+	c = getc(fp);
+	if (c == EOF) {
+		return false;
+	}
+	ungetc(c, fp);
+
+	return (c == TVBIN_MAGIC[0]);
+}
+
+int tvbin_open(tvbin_t* tv, FILE* fp)
+{
+	struct stat st;
+	uint8_t magic[TVBIN_MAGIC_SZ];
+
+	memset(tv, 0, sizeof(tvbin_t));
+	if ((fstat(fileno(fp), &st) == 0) && S_ISREG(st.st_mode) && (st.st_size >= TVBIN_MAGIC_SZ)) {
+		tv->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+		if (tv->map == MAP_FAILED) {
+			tv->map = NULL;
+			printf("%sError: Can't mmap input file.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+		madvise((void*)tv->map, st.st_size, MADV_SEQUENTIAL);
+		tv->mapsz = st.st_size;
+		memcpy(magic, tv->map, TVBIN_MAGIC_SZ);
+		tv->pos = TVBIN_MAGIC_SZ;
+	} else {
+		tv->fp = fp;
+		if ((tv->buf = malloc(TVBIN_REC_MAX)) == NULL) {
+			printf("%sError: Can't allocate buffer for input records.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+		tv->bufsz = TVBIN_REC_MAX;
+		if (fread(magic, 1, TVBIN_MAGIC_SZ, fp) != TVBIN_MAGIC_SZ) {
+			printf("%sError: Input stream too short.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	if (memcmp(magic, TVBIN_MAGIC, TVBIN_MAGIC_SZ)) {
+		printf("%sError: Input is not a binary test-vector stream.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+
+	return 0;
+err:
+	tvbin_close(tv);
+	return -1;
+}
+
+/* Get next record (returns 1 at end of stream) */
+int tvbin_next(tvbin_t* tv, uint8_t* type, uint8_t* flags, const uint8_t** payload, uint32_t* len)
+{
+	const uint8_t* hdr;
+	uint8_t hbuf[TVBIN_HDR_SZ];
+
+	if (tv->map) {
+		if (tv->pos == tv->mapsz) {
+			return 1;
+		}
+		if ((tv->mapsz - tv->pos) < TVBIN_HDR_SZ) {
+			goto err_trunc;
+		}
+		hdr = tv->map + tv->pos;
+		*len = tvbin_le32(hdr + 4);
+		if ((tv->mapsz - tv->pos - TVBIN_HDR_SZ) < *len) {
+			goto err_trunc;
+		}
+		*payload = hdr + TVBIN_HDR_SZ;
+		tv->pos += TVBIN_HDR_SZ + *len;
+	} else {
+		if (fread(hbuf, 1, TVBIN_HDR_SZ, tv->fp) != TVBIN_HDR_SZ) {
+			if (feof(tv->fp)) {
+				return 1;
+			}
+			goto err_trunc;
+		}
+		hdr = hbuf;
+		*len = tvbin_le32(hdr + 4);
+		if (*len > tv->bufsz) {
+			printf("%sError: Record of %d bytes in input stream is too large.%s\n\r", KERR, *len, KNRM);
+			goto err;
+		}
+		if (fread(tv->buf, 1, *len, tv->fp) != *len) {
+			goto err_trunc;
+		}
+		*payload = tv->buf;
+	}
+	*type = hdr[0];
+	*flags = hdr[1];
+
+	return 0;
+err_trunc:
+	printf("%sError: Truncated record in input stream.%s\n\r", KERR, KNRM);
+err:
+	return -1;
+}
+
+static inline void tvbin_get_num(const uint8_t** pl, large_number_t* n, uint32_t sz)
+{
+	memcpy(n->val, *pl, sz);
+	n->sz = sz;
+	n->valid = true;
+	*pl += sz;
+}
+
+int tvbin_get_curve(const uint8_t* pl, uint32_t len, curve_t* crv)
+{
+	uint32_t sz;
+
+	if (len < 8) {
+		goto err_len;
+	}
+	crv->id = tvbin_le32(pl);
+	crv->nn = tvbin_le32(pl + 4);
+	sz = NN_SZ(crv->nn);
+	if ((sz > NBMAXSZ) || (len != (8 + (4 * sz)))) {
+		goto err_len;
+	}
+	pl += 8;
+	tvbin_get_num(&pl, &crv->p, sz);
+	tvbin_get_num(&pl, &crv->a, sz);
+	tvbin_get_num(&pl, &crv->b, sz);
+	tvbin_get_num(&pl, &crv->q, sz);
+	crv->set_in_hw = false;
+	crv->valid = true;
+
+	return 0;
+err_len:
+	printf("%sError: Curve record of inconsistent size in input stream.%s\n\r", KERR, KNRM);
+	return -1;
+}
+
+/* Set test 't' from a test record (its curve must be the current one) */
+int tvbin_get_test(uint8_t flags, const uint8_t* pl, uint32_t len, ipecc_test_t* t)
+{
+	uint32_t sz, nb;
+	operation_t op;
+	bool has_q, has_res;
+
+	if (len < 16) {
+		goto err_len;
+	}
+	op = (operation_t)tvbin_le32(pl);
+	if ((op < OP_KP) || (op > OP_TST_OPP)) {
+		printf("%sError: Unknown operation %d in input stream.%s\n\r", KERR, op, KNRM);
+		goto err;
+	}
+	if ((t->curve->valid == false) || (tvbin_le32(pl + 4) != t->curve->id)) {
+		printf("%sError: Test record for a curve that isn't the current one in input stream.%s\n\r",
+				KERR, KNRM);
+		goto err;
+	}
+	t->op = op;
+	t->id = tvbin_le32(pl + 8);
+	t->blinding = tvbin_le32(pl + 12);
+	t->is_an_exception = INT_TO_BOOLEAN(flags & TVBIN_F_EXCEPTION);
+	has_q = (op == OP_PTADD) || (op == OP_TST_EQU) || (op == OP_TST_OPP);
+	has_res = (op == OP_KP) || (op == OP_PTADD) || (op == OP_PTDBL) || (op == OP_PTNEG);
+
+	/* Check size before copying anything */
+	sz = NN_SZ(t->curve->nn);
+	nb = (flags & TVBIN_F_P_NULL) ? 0 : 2;
+	nb += (has_q && !(flags & TVBIN_F_Q_NULL)) ? 2 : 0;
+	nb += (op == OP_KP) ? 1 : 0;
+	nb += (has_res && !(flags & TVBIN_F_R_NULL)) ? 2 : 0;
+	if (len != (16 + (nb * sz))) {
+		goto err_len;
+	}
+	pl += 16;
+
+	t->ptp.is_null = INT_TO_BOOLEAN(flags & TVBIN_F_P_NULL);
+	if (!t->ptp.is_null) {
+		tvbin_get_num(&pl, &t->ptp.x, sz);
+		tvbin_get_num(&pl, &t->ptp.y, sz);
+	}
+	t->ptp.valid = true;
+	if (has_q) {
+		t->ptq.is_null = INT_TO_BOOLEAN(flags & TVBIN_F_Q_NULL);
+		if (!t->ptq.is_null) {
+			tvbin_get_num(&pl, &t->ptq.x, sz);
+			tvbin_get_num(&pl, &t->ptq.y, sz);
+		}
+		t->ptq.valid = true;
+	}
+	if (op == OP_KP) {
+		tvbin_get_num(&pl, &t->k, sz);
+	}
+	if (has_res) {
+		t->pt_sw_res.is_null = INT_TO_BOOLEAN(flags & TVBIN_F_R_NULL);
+		if (!t->pt_sw_res.is_null) {
+			tvbin_get_num(&pl, &t->pt_sw_res.x, sz);
+			tvbin_get_num(&pl, &t->pt_sw_res.y, sz);
+		}
+		t->pt_sw_res.valid = true;
+	} else {
+		t->sw_answer.answer = INT_TO_BOOLEAN(flags & TVBIN_F_ANSWER);
+		t->sw_answer.valid = true;
+	}
+
+	return 0;
+err_len:
+	printf("%sError: Test record of inconsistent size in input stream.%s\n\r", KERR, KNRM);
+err:
+	return -1;
+}
+
+void tvbin_close(tvbin_t* tv)
+{
+	if (tv->map) {
+		munmap((void*)tv->map, tv->mapsz);
+		tv->map = NULL;
+	}
+	if (tv->buf) {
+		free(tv->buf);
+		tv->buf = NULL;
+	}
+}
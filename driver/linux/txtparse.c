@@ -0,0 +1,213 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Parsing helpers for the text format of test vectors:
+ *
+ *   - hex_to_bin() converts hexadecimal digits into a big endian large
+ *     number (the byte order of large_number_t), eight digits at a time
+ *     in a 64-bit word (SWAR) on little endian hosts, with a table for
+ *     the remaining ones;
+ *
+ *   - txtin_*() hand out lines of the input: in place from the mapping
+ *     if it is a regular file, otherwise through getline(). Lines are
+ *     not NUL-terminated (but for the last one if it has no '\n'), so
+ *     only use them with their length, or with functions that stop on
+ *     '\n' (strncmp() with a prefix, strtol()...).
+ *
+ * See linux/ecc-test-parse-bench.c for a micro-benchmark.
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ecc-test-linux.h"
+
+/* Value of hexadecimal digits or'ed with 0x10 (0 for any other character) */
+#define H(c, v)  [c] = (0x10 | (v))
+static const uint8_t hexval[256] = {
+	H('0', 0), H('1', 1), H('2', 2), H('3', 3), H('4', 4),
+	H('5', 5), H('6', 6), H('7', 7), H('8', 8), H('9', 9),
+	H('a', 10), H('b', 11), H('c', 12), H('d', 13), H('e', 14), H('f', 15),
+	H('A', 10), H('B', 11), H('C', 12), H('D', 13), H('E', 14), H('F', 15),
+};
+#undef H
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define HEX_SWAR
+
+#define ONES    0x0101010101010101ULL
+#define HIGHS   0x8080808080808080ULL
+
+/* Bit 7 of each byte of 'x' (all < 0x80) set if the byte is in [lo : hi] */
+#define IN_RANGE(x, lo, hi) \
+	(((x) + (ONES * (0x80 - (lo)))) & ~((x) + (ONES * (0x7f - (hi)))) & HIGHS)
+
+/*
+ * Convert 8 hexadecimal digits into 4 bytes, returns -1 if any of
+ * them is not an hexadecimal digit.
+ */
+static inline int hex8_to_bin(const char* s, uint8_t* out)
+{
+	uint64_t x, v;
+	uint32_t w;
+
+	memcpy(&x, s, 8);
+	if (x & HIGHS) {
+		return -1;
+	}
+	if ((IN_RANGE(x, '0', '9') | IN_RANGE(x, 'a', 'f') | IN_RANGE(x, 'A', 'F')) != HIGHS) {
+		return -1;
+	}
+	/* Value of digits (the first one in the lowest byte): low nibble,
+	 * plus 9 for letters (which all have bit 6 set, unlike numbers) */
+	v = (x & (ONES * 0x0f)) + (((x >> 6) & ONES) * 9);
+	/* Pack the nibbles two by two... */
+	v = ((v << 4) | (v >> 8)) & 0x00ff00ff00ff00ffULL;
+	/* ...then the bytes */
+	v = (v | (v >> 8)) & 0x0000ffff0000ffffULL;
+	w = (uint32_t)(v | (v >> 16));
+	memcpy(out, &w, 4);
+
+	return 0;
+}
+#endif
+
+/*
+ * Convert the 'n' hexadecimal digits of 's' into the 'sz'-byte big endian
+ * number 'out' (right-aligned, the most significant bytes being padded with
+ * 0s if there are less than 2*sz digits).
+ */
+int hex_to_bin(const char* s, uint32_t n, uint8_t* out, uint32_t sz)
+{
+	uint32_t nb, i;
+	uint8_t h0, h1, bad;
+
+	if (n > (2 * sz)) {
+		goto err;
+	}
+	nb = DIV(n, 2);
+	memset(out, 0, sz - nb);
+	out += sz - nb;
+	if (n & 1) {
+		/* Odd nb of digits, the first one is a byte of its own */
+		h1 = hexval[(uint8_t)*s++];
+		if (!(h1 & 0x10)) {
+			goto err;
+		}
+		*out++ = h1 & 0xf;
+		n--;
+	}
+#if defined(HEX_SWAR)
+	for ( ; n >= 8; n -= 8, s += 8, out += 4) {
+		if (hex8_to_bin(s, out)) {
+			goto err;
+		}
+	}
+#endif
+	bad = 0x10;
+	for (i = 0; i < n; i += 2) {
+		h0 = hexval[(uint8_t)s[i]];
+		h1 = hexval[(uint8_t)s[i + 1]];
+		bad &= h0 & h1;
+		*out++ = (uint8_t)((h0 << 4) | (h1 & 0xf));
+	}
+	if (!bad) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+int txtin_open(txtin_t* in, FILE* fp)
+{
+	struct stat st;
+
+	memset(in, 0, sizeof(txtin_t));
+	if ((fstat(fileno(fp), &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)
+			&& (ftell(fp) == 0)) {
+		in->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+		if (in->map != MAP_FAILED) {
+			madvise((void*)in->map, st.st_size, MADV_SEQUENTIAL);
+			in->mapsz = st.st_size;
+			return 0;
+		}
+		/* Fall back on getline() */
+		in->map = NULL;
+	}
+	in->fp = fp;
+
+	return 0;
+}
+
+/*
+ * Get next line (including its '\n' if any) & return its length,
+ * or -1 at end of input.
+ */
+ssize_t txtin_getline(txtin_t* in, const char** line)
+{
+	const char* l;
+	const char* nl;
+	size_t n;
+	ssize_t ret;
+
+	if (in->map == NULL) {
+		ret = getline(&in->buf, &in->bufsz, in->fp);
+		*line = in->buf;
+		return ret;
+	}
+	if (in->pos == in->mapsz) {
+		return -1;
+	}
+	l = in->map + in->pos;
+	nl = memchr(l, '\n', in->mapsz - in->pos);
+	if (nl) {
+		n = nl + 1 - l;
+		in->pos += n;
+		*line = l;
+		return n;
+	}
+	/* Last line, without '\n': copy it so that it can be terminated */
+	n = in->mapsz - in->pos;
+	in->pos = in->mapsz;
+	if ((in->buf = realloc(in->buf, n + 2)) == NULL) {
+		return -1;
+	}
+	memcpy(in->buf, l, n);
+	in->buf[n] = '\n';
+	in->buf[n + 1] = '\0';
+	*line = in->buf;
+
+	return n + 1;
+}
+
+void txtin_close(txtin_t* in)
+{
+	if (in->map) {
+		munmap((void*)in->map, in->mapsz);
+		in->map = NULL;
+	}
+	if (in->buf) {
+		free(in->buf);
+		in->buf = NULL;
+	}
+}
@@ -63,6 +63,14 @@ entity ecc_axi is
 		s_axi_rresp : out std_logic_vector(1 downto 0);
 		s_axi_rvalid : out std_logic;
 		s_axi_rready : in std_logic;
+		-- AXI-Stream ports for large numbers (only if 'axistream' = TRUE)
+		s_axis_tdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axis_tvalid : in std_logic;
+		s_axis_tready : out std_logic;
+		m_axis_tdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		m_axis_tvalid : out std_logic;
+		m_axis_tready : in std_logic;
+		m_axis_tlast : out std_logic;
 		-- interrupt
 		irq : out std_logic;
 		-- interface with ecc_scalar
@@ -96,6 +104,8 @@ entity ecc_axi is
 		--   Montgomery constants computation
 		agocstmty : out std_logic;
 		mtydone : in std_logic;
+		--   reduction mode (Montgomery or Solinas, see (s306))
+		redmode : out std_logic_vector(1 downto 0);
 		--   constant 'a' Montgomery transform
 		agomtya : out std_logic;
 		amtydone : in std_logic;
@@ -134,6 +144,11 @@ entity ecc_axi is
 		xwdata : out std_logic_vector(ww - 1 downto 0);
 		xre : out std_logic;
 		xrdata : in std_logic_vector(ww - 1 downto 0);
+		-- snooping of writes into ecc_fp_dram (curve context slots, see (s303))
+		fpwe : in std_logic;
+		fpwaddr : in std_logic_vector(FP_ADDR - 1 downto 0);
+		fpwdata : in std_logic_vector(ww - 1 downto 0);
+		crvppen : in std_logic;
 		nndyn_nnrnd_mask : out std_logic_vector(ww - 1 downto 0);
 		nndyn_nnrnd_maskwg : out unsigned(log2(w) - 1 downto 0);
 		-- interface with ecc_trng
@@ -143,6 +158,7 @@ entity ecc_axi is
 		trngaxiirncount : in std_logic_vector(log2(irn_fifo_size_axi) - 1 downto 0);
 		-- broadcast interface to Montgomery multipliers
 		pen : out std_logic;
+		ppen : out std_logic;
 		nndyn_mask : out std_logic_vector(ww - 1 downto 0);
 		nndyn_shrcnt : out unsigned(log2(ww) - 1 downto 0);
 		nndyn_shlcnt : out unsigned(log2(ww) - 1 downto 0);
@@ -271,6 +287,7 @@ architecture rtl of ecc_axi is
 		irn : std_logic_vector(ww - 1 downto 0);
 		irnempty : std_logic;
 		trngrdy : std_logic;
+		expend : std_logic; -- read of R_TRNG_DATA pending, see (s312)
 		kmask, kmasked : std_logic_vector(ww - 1 downto 0);
 		kmaskfull : std_logic;
 		bitsirn : unsigned(log2(ww - 1) - 1 downto 0);
@@ -411,6 +428,14 @@ architecture rtl of ecc_axi is
 		-- software reset
 		swrst : std_logic;
 		swrst_cnt : unsigned(2 downto 0);
+		-- reduction mode (FASTRED_NONE = Montgomery)
+		redmode : std_logic_vector(1 downto 0);
+		-- Montgomery constants written by software (see (s310))
+		hmty : std_logic;
+		hseen : std_logic_vector(3 downto 0);
+		hnb : std_logic_vector(1 downto 0);
+		hlimb : unsigned(log2(w - 1) - 1 downto 0);
+		hppen : std_logic;
 	end record; -- ctrl
 
 	type nndyn_reg_type is record
@@ -591,6 +616,116 @@ architecture rtl of ecc_axi is
 		-- pragma translate_on
 	;
 
+	-- hardware command queue (see (s287))
+	constant cmdqsz : positive := max(cmdqsize, 2); -- for widths only
+	constant CMDQW : positive := 2 + ADB + C_S_AXI_DATA_WIDTH; -- kind & reg & data
+	type cmdq_state_type is
+		(idle, fetch, fetched, waitrdy, lock, wbeat, rbeat, done1, done2);
+
+	type cmdq_reg_type is record
+		en : std_logic;
+		state : cmdq_state_type;
+		-- sticky op, set by software through W_CMDQ_OP register
+		opkind : std_logic_vector(1 downto 0);
+		opreg : std_logic_vector(ADB - 1 downto 0);
+		-- command FIFO (write port driven by W_CMDQ_PUSH, read port by dispatcher)
+		we : std_logic;
+		wdata : std_logic_vector(CMDQW - 1 downto 0);
+		wptr, rptr : unsigned(log2(cmdqsz - 1) - 1 downto 0);
+		count : unsigned(log2(cmdqsz) - 1 downto 0);
+		re : std_logic;
+		-- entry being currently replayed
+		kind : std_logic_vector(1 downto 0);
+		reg : std_logic_vector(ADB - 1 downto 0);
+		data : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		nbw : unsigned(15 downto 0);
+		-- masks AXI handshakes from software while an access is being replayed
+		lock : std_logic;
+		-- result FIFO (write port driven by dispatcher, read by R_CMDQ_RESULT)
+		reswe : std_logic;
+		reswdata : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		reswptr, resrptr : unsigned(log2(cmdqsz - 1) - 1 downto 0);
+		rescount : unsigned(log2(cmdqsz) - 1 downto 0);
+		resre : std_logic;
+		resdv : std_logic;
+		-- completion IRQ coalescing
+		irqthr : unsigned(CMDQ_CTRL_IRQ_MSB - CMDQ_CTRL_IRQ_LSB downto 0);
+		donecnt : unsigned(CMDQ_CTRL_IRQ_MSB - CMDQ_CTRL_IRQ_LSB downto 0);
+		-- stall cycles (see (s288))
+		idlecnt : unsigned(31 downto 0);
+	end record;
+
+	-- AXI-Stream ports for large numbers (see (s298))
+	type axis_state_type is (idle, wbeat, wdecode, rbeat);
+
+	type axis_reg_type is record
+		state : axis_state_type;
+		-- current large number is transferred through the stream ports
+		wr, rd : std_logic;
+		-- masks AXI handshakes from software while a beat is being injected
+		lock : std_logic;
+		tready : std_logic;
+	end record;
+
+	-- curve context slots (see (s303))
+	constant nbctxsz : positive := max(nbctx, 2); -- for widths only
+	constant CTXSLOTW : positive := log2(nbctxsz - 1);
+	constant CTXAW : positive := CTXSLOTW + 3 + log2z(n - 1);
+	type ctx_state_type is (idle, gap, rd, rdw, wr, drain);
+	type ctx_nn_array is array(0 to nbctxsz - 1) of unsigned(log2(nn) - 1 downto 0);
+	type ctx_red_array is array(0 to nbctxsz - 1) of std_logic_vector(1 downto 0);
+
+	type ctx_reg_type is record
+		state : ctx_state_type;
+		-- slot bound to the content of ecc_fp_dram
+		bound : std_logic;
+		cur : unsigned(CTXSLOTW - 1 downto 0);
+		valid : std_logic_vector(nbctxsz - 1 downto 0);
+		-- value of nn each slot was computed with
+		nntag : ctx_nn_array;
+		-- reduction mode each slot was computed with
+		redtag : ctx_red_array;
+		-- p, a, b & q written by software since slot was bound
+		seen : std_logic_vector(3 downto 0);
+		-- write port (mirror of the writes into ecc_fp_dram)
+		we : std_logic;
+		waddr : std_logic_vector(CTXAW - 1 downto 0);
+		wdata : std_logic_vector(ww - 1 downto 0);
+		ppcnt : unsigned(log2(w - 1) - 1 downto 0);
+		-- read port (restore of a slot into ecc_fp_dram)
+		re : std_logic;
+		raddr : std_logic_vector(CTXAW - 1 downto 0);
+		idx : unsigned(2 downto 0);
+		limb : unsigned(log2(w - 1) - 1 downto 0);
+		cnt : unsigned(1 downto 0);
+		ppen : std_logic;
+	end record;
+
+	-- staging of a, b & q during computation of Montgomery constants
+	-- (see (s307))
+	constant OVLAW : positive := 2 + log2z(n - 1);
+	type ovl_state_type is (idle, rd, rdw, wr);
+
+	type ovl_reg_type is record
+		state : ovl_state_type;
+		-- large number being written goes into the staging RAM
+		stg : std_logic;
+		-- 0 = a, 1 = b, 2 = q
+		idx : unsigned(1 downto 0);
+		-- large numbers held by the staging RAM
+		staged : std_logic_vector(2 downto 0);
+		-- Montgomery constants are computed, staged nbs wait to be replayed
+		pend : std_logic;
+		-- write port
+		we : std_logic;
+		waddr : std_logic_vector(OVLAW - 1 downto 0);
+		wdata : std_logic_vector(ww - 1 downto 0);
+		-- read port (replay into ecc_fp_dram)
+		re : std_logic;
+		raddr : std_logic_vector(OVLAW - 1 downto 0);
+		limb : unsigned(log2(w - 1) - 1 downto 0);
+	end record;
+
 	-- all registers
 	type reg_type is record
 		axi : reg_axi_type;
@@ -601,9 +736,20 @@ architecture rtl of ecc_axi is
 		ctrl : ctrl_reg_type;
 		nndyn : nndyn_reg_type;
 		debug : debug_reg_type;
+		cmdq : cmdq_reg_type;
+		axis : axis_reg_type;
+		ctx : ctx_reg_type;
+		ovl : ovl_reg_type;
 	end record;
 
 	signal r, rin : reg_type;
+	signal cmdq_dob : std_logic_vector(CMDQW - 1 downto 0);
+	signal cmdqres_dob : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+	signal r_cmdq_wptr, r_cmdq_rptr : std_logic_vector(log2(cmdqsz - 1) - 1 downto 0);
+	signal r_cmdqres_wptr, r_cmdqres_rptr
+		: std_logic_vector(log2(cmdqsz - 1) - 1 downto 0);
+	signal ctx_dob : std_logic_vector(ww - 1 downto 0);
+	signal ovl_dob : std_logic_vector(ww - 1 downto 0);
 	signal nndyn_mask_s : std_logic_vector(ww - 1 downto 0);
 	signal nndyn_mask_is_all1_but_msb_s : std_logic;
 	signal nndyn_wm1_s : unsigned(log2(w - 1) - 1 downto 0);
@@ -763,12 +909,40 @@ begin
 			 & "to fit in register R_DBG_TRNG_STATUS."
 			severity WARNING;
 
+	-- (s289), see (s287)
+	assert (cmdqsize = 0 or (is_a_power_of_two(cmdqsize)
+	                          and cmdqsize >= 2 and cmdqsize <= 32768))
+		report "Value of parameter cmdqsize in ecc_customize.vhd must be 0 or "
+		     & "a power of 2 between 2 and 32768."
+			severity FAILURE;
+
+	-- (s315), see (s312)
+	assert ((not hwsecure) or (not trngexport))
+		report "In HW secure mode (hwsecure = TRUE), the export of random words "
+		     & "to software (parameter 'trngexport' in ecc_customize.vhd) is "
+				 & "removed from the design."
+			severity WARNING;
+
+	-- (s316), see (s315)
+	assert ((not hwsecure) or (not hostmty))
+		report "In HW secure mode (hwsecure = TRUE), the upload of Montgomery "
+		     & "constants by software (parameter 'hostmty' in ecc_customize.vhd) "
+				 & "is removed from the design."
+			severity WARNING;
+
+	assert (nbctx = 0 or (is_a_power_of_two(nbctx)
+	                      and nbctx >= 2 and nbctx <= 16))
+		report "Value of parameter nbctx in ecc_customize.vhd must be 0 or "
+		     & "a power of 2 between 2 and 16."
+			severity FAILURE;
+
 	-- combinational logic
 	comb: process(s_axi_aresetn, r,
 	              s_axi_awaddr, s_axi_awprot, s_axi_awvalid,
 	              s_axi_wdata, s_axi_wvalid, s_axi_bready,
 	              s_axi_araddr, s_axi_arprot, s_axi_arvalid,
 	              s_axi_rready, ardy, aerr_inpt_not_on_curve,
+	              s_axis_tdata, s_axis_tvalid, m_axis_tready,
 	              aerr_outpt_not_on_curve,
 	              kpdone, mtydone, popdone, yes, yesen, xrdata,
 	              trngvalid, trngdata, initdone,
@@ -790,7 +964,9 @@ begin
 	              dbgtrngaxirdy, dbgtrngaxivalid, dbgtrngefprdy, dbgtrngefpvalid,
 	              dbgtrngcrvrdy, dbgtrngcrvvalid, dbgtrngshfrdy, dbgtrngshfvalid,
 	              dbgtrngrawrdy, dbgtrngrawvalid,
-	              r_debug_clkmmcnt
+	              r_debug_clkmmcnt,
+	              cmdq_dob, cmdqres_dob,
+	              fpwe, fpwaddr, fpwdata, crvppen, ctx_dob, ovl_dob
 								-- /HW unsecure only
 	              , laststep, firstzdbl, firstzaddu, first2pz, first3pz, 
 	              torsion2, kap, kapp, zu, zc, r0z, r1z, dbgjoyebit,
@@ -817,6 +993,7 @@ begin
 		variable dw : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
 		variable v_pop_possible, v_kp_possible : boolean;
 		variable v_busy, v_wlock : boolean;
+		variable v_busy_ovl, v_ovlwr : boolean;
 		variable vtmp6 : unsigned(BLD_BITS_MSB - BLD_BITS_LSB + 1 downto 0);
 		variable vtmp7 : unsigned(BLD_BITS_MSB - BLD_BITS_LSB + 1 downto 0);
 		variable v_blindiff : unsigned(BLD_BITS_MSB - BLD_BITS_LSB + 1 downto 0);
@@ -840,6 +1017,21 @@ begin
 		variable vtmp40 : unsigned(log2(w) downto 0);
 		variable vtmp41, vtmp42, vtmp43 : signed(NB_SLK_BITS downto 0);
 		variable vtmp44, vtmp45, vtmp46 : signed(NB_SLK_BITS downto 0);
+		variable v_status : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		variable v_rready : std_logic;
+		variable v_cmdq_push, v_cmdq_pop, v_cmdq_flush : boolean;
+		variable v_res_push, v_res_pop : boolean;
+		variable v_res_data : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		variable v_cmdq_go : boolean;
+		variable v_ctx_slot : unsigned(CURVE_SEL_SLOT_MSB - CURVE_SEL_SLOT_LSB
+			downto 0);
+		variable v_ctx_idx : unsigned(3 downto 0);
+		variable v_ctx_nb : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+		variable v_ctx_wm1 : unsigned(log2(w - 1) - 1 downto 0);
+		variable v_ovl_nb : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+		variable v_ovl_wm1 : unsigned(log2(w - 1) - 1 downto 0);
+		variable v_hmty_wm1 : unsigned(log2(w - 1) - 1 downto 0);
+		variable v_hmty_nb : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
 	begin
 		v := r;
 
@@ -1045,16 +1237,30 @@ begin
 		-- of r.write.active allows software to poll R_STATUS register inbetween
 		-- the different single 32 (or 64) bit data transfers involved in one
 		-- large number read or write.
-		v_busy := (initdone = '0')
+		-- (s307) When parameter 'mtyovl' is set, software can write a, b & q
+		-- while the Montgomery constants (routine .constMTYL) are computed in
+		-- the background, that is as long as the IP is not busy for any other
+		-- reason (v_busy_ovl), which is reported to software by the MTYOVL bit
+		-- of R_STATUS (the BUSY bit keeps its meaning, so that software unaware
+		-- of it still waits for the end of the computation). These writes (and
+		-- only them, any other action still faces v_busy) are redirected to a
+		-- staging RAM, see (s308), and replayed into ecc_fp_dram as soon as the
+		-- constants are computed, see (s309)
+		v_busy_ovl := (initdone = '0')
              or r.ctrl.kppending = '1'
-		         or r.ctrl.mtypending = '1' or r.ctrl.agocstmty = '1'
 		         or r.ctrl.amtypending = '1' or r.ctrl.agomtya = '1'
 		         or r.ctrl.poppending = '1'
 		         or r.write.busy = '1' or r.read.busy = '1'
 		         or (nn_dynamic and r.nndyn.active = '1')
 		         or r.read.trngreading = '1'
 		         or r.ctrl.tokpending = '1' or r.ctrl.gentoken = '1'
-		         or r.ctrl.lockaxi = '1';
+		         or r.ctrl.lockaxi = '1'
+		         or (nbctx > 0 and r.ctx.state /= idle)
+		         or (mtyovl and (r.ovl.pend = '1' or r.ovl.state /= idle))
+		         -- last limb of p' written by software, 'ppen' not deasserted yet
+		         or (HOSTMTY_EN and r.ctrl.hppen = '1' and r.ctrl.hseen(3) = '1');
+		v_busy := v_busy_ovl
+		         or r.ctrl.mtypending = '1' or r.ctrl.agocstmty = '1';
 		-- (s161) - Compared to v_busy, v_wlock adds the condition that the last
 		-- prime size set by software did not incur an error - thus preventing
 		-- software from performing undesirable actions when nn is not set properly
@@ -1073,6 +1279,87 @@ begin
 		if v_busy then v.ctrl.busy := '1'; else v.ctrl.busy := '0'; end if;
 		-- pragma translate_on
 
+		-- value of R_STATUS register (also snapshotted into the result FIFO
+		-- of the command queue upon each completion marker, see (s293))
+		v_status := (others => '0');
+		-- Informational bits
+		if v_busy then -- (s160), see (s30)
+			v_status(STATUS_BUSY) := '1';
+		else
+			v_status(STATUS_BUSY) := '0';
+		end if;
+		-- the IP is busy only because of the computation of Montgomery
+		-- constants & accepts the write of a, b or q (see (s307))
+		if mtyovl and v_busy and (not v_busy_ovl) then
+			v_status(STATUS_MTYOVL) := '1';
+		else
+			v_status(STATUS_MTYOVL) := '0';
+		end if;
+		if cmdqsize > 0 then -- statically resolved by synthesizer
+			if r.cmdq.count /= 0 or r.cmdq.state /= idle then
+				v_status(STATUS_CMDQ) := '1';
+			end if;
+		end if;
+		v_status(STATUS_KP) := r.ctrl.kppending;
+		v_status(STATUS_MTY) :=
+		     r.ctrl.mtypending or r.ctrl.agocstmty -- or r.ctrl.newp;
+		  or r.ctrl.amtypending or r.ctrl.agomtya or r.ovl.pend;
+		v_status(STATUS_POP) := r.ctrl.poppending;
+		v_status(STATUS_R_OR_W) := r.write.busy or r.read.busy;
+		v_status(STATUS_INIT) := not initdone;
+		v_status(STATUS_ENOUGH_RND_WK) := not r.write.rnd.enough_random;
+		if nn_dynamic then -- statically resolved by synthesizer
+			v_status(STATUS_NNDYNACT) := r.nndyn.active;
+		else
+			v_status(STATUS_NNDYNACT) := '0';
+		end if;
+		v_status(STATUS_YES) := r.ctrl.yes; -- (s98), was set by (s96)
+		v_status(STATUS_R0_IS_NULL) := r.ctrl.r0_is_null;
+		v_status(STATUS_R1_IS_NULL) := r.ctrl.r1_is_null;
+		v_status(STATUS_TOKEN_GEN) := r.ctrl.tokpending or r.ctrl.gentoken;
+		-- Error bits
+		v_status(STATUS_ERR_IN_PT_NOT_ON_CURVE) := aerr_inpt_not_on_curve;
+		v_status(STATUS_ERR_OUT_PT_NOT_ON_CURVE) := aerr_outpt_not_on_curve;
+		v_status(STATUS_ERR_I_MSB downto STATUS_ERR_I_LSB) := r.ctrl.ierrid;
+
+		-- (s294) while the command queue is replaying a read of R_READ_DATA,
+		-- the AXI read-data channel is hidden from software (see (s295)) and
+		-- the "ready" of the handshake is driven by the command queue itself,
+		-- which accepts the data as long as its result FIFO is not full (this
+		-- is always the case, see (s314))
+		if cmdqsize > 0 and r.cmdq.lock = '1' then -- cmdqsize stat. resolved
+			if r.cmdq.state = rbeat and r.cmdq.rescount /= to_unsigned(cmdqsz,
+				log2(cmdqsz))
+			then
+				v_rready := '1';
+			else
+				v_rready := '0';
+			end if;
+		elsif axistream and r.axis.lock = '1' then -- axistream stat. resolved
+			-- same for a read injected on behalf of the stream port m_axis_*
+			-- (see (s298))
+			if r.axis.state = rbeat then
+				v_rready := m_axis_tready;
+			else
+				v_rready := '0';
+			end if;
+		else
+			v_rready := s_axi_rready;
+		end if;
+
+		-- strobes of the command queue & of its result FIFO
+		v_cmdq_push := FALSE;
+		v_cmdq_pop := FALSE;
+		v_cmdq_flush := FALSE;
+		v_res_push := FALSE;
+		v_res_pop := FALSE;
+		v_res_data := (others => '0');
+		v.cmdq.we := '0';
+		v.cmdq.re := '0';
+		v.cmdq.reswe := '0';
+		v.cmdq.resre := '0';
+		v.cmdq.resdv := r.cmdq.resre; -- (s290)
+
 		-- ----------------------------------------------
 		-- generation of signal r.write.rnd.enough_random
 		-- ----------------------------------------------
@@ -1411,7 +1698,11 @@ begin
 		-- ----------------------------------------------------------
 
 		-- handshake over AXI address-write channel
-		if s_axi_awvalid = '1' and r.axi.awready = '1' then
+		-- (r.cmdq.lock & r.axis.lock mask software accesses while the command
+		-- queue is replaying one or a stream beat is being injected, see (s295))
+		if s_axi_awvalid = '1' and r.axi.awready = '1'
+			and r.cmdq.lock = '0' and r.axis.lock = '0'
+		then
 			v.axi.awpending := '1';
 			v.axi.waddr := s_axi_awaddr(C_S_AXI_ADDR_WIDTH - 1 downto 3);
 			v.axi.awready := '0';
@@ -1419,7 +1710,9 @@ begin
 		end if;
 
 		-- handshake over AXI data-write channel
-		if s_axi_wvalid = '1' and r.axi.wready = '1' then
+		if s_axi_wvalid = '1' and r.axi.wready = '1'
+			and r.cmdq.lock = '0' and r.axis.lock = '0'
+		then
 			v.axi.dwpending := '1';
 			-- note that r.axi.wdatax, which content is both pulled from AXI bus
 			-- and pushed into r.write.shdataww in shift-register mode, cannot be
@@ -1472,7 +1765,17 @@ begin
 				v.axi.arready := '1';
 				-- drive write-response to initiator
 				v.axi.bvalid := '1';
-				if (not v_wlock) or (not hwsecure) then -- (s162), see (s161)
+				-- write of a, b or q while Montgomery constants are being
+				-- computed (see (s307))
+				v_ovl_nb := r.axi.wdatax(
+						CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB);
+				v_ovlwr := mtyovl and r.axi.wdatax(CTRL_WRITE_NB) = '1'
+					and (r.ctrl.mtypending = '1' or r.ctrl.agocstmty = '1')
+					and (v_ovl_nb = CST_ADDR_A or v_ovl_nb = CST_ADDR_B
+					     or v_ovl_nb = CST_ADDR_Q);
+				if (not v_wlock) or (not hwsecure)
+					or (v_ovlwr and (not v_busy_ovl)) -- (s162), see (s161)
+				then
 					-- in HW unsecure mode we always grant write access to W_CTRL register
 					-- (so use with care)
 					-- Decode content of W_CTRL register. Since sevaral actions can
@@ -1533,14 +1836,18 @@ begin
 							-- the current value of curve parameter 'a'
 							v.ctrl.a_set := '0';
 							v.ctrl.a_set_and_mty := '0';
+							v.ctx.seen(0) := '1'; -- see (s305)
 						elsif v_axi_wdatax_msb = CST_ADDR_A then
 							v.ctrl.a_set := '0'; -- (s181), see (s113)
 							v.ctrl.a_set_and_mty := '0'; -- (s182), see (s111)
 							v.ctrl.newa := '1'; -- (s121), bypass of (s120)
+							v.ctx.seen(1) := '1';
 						elsif v_axi_wdatax_msb = CST_ADDR_B then
 							v.ctrl.b_set := '0';
+							v.ctx.seen(2) := '1';
 						elsif v_axi_wdatax_msb = CST_ADDR_Q then
 							v.ctrl.q_set := '0';
+							v.ctx.seen(3) := '1';
 						elsif v_axi_wdatax_msb = CST_ADDR_XR1 then
 							v.ctrl.x_set := '0';
 							v.ctrl.r1_is_null := '0';
@@ -1555,6 +1862,20 @@ begin
 						if hwsecure then -- statically resolved by synthesizer
 							v.ctrl.read_forbidden := '1';
 						end if;
+						-- (s308) while Montgomery constants are computed, ecc_fp_dram
+						-- is not accessible: the limbs of a, b or q go to the staging
+						-- RAM instead (see (s307))
+						v.ovl.stg := '0';
+						if v_ovlwr then
+							v.ovl.stg := '1';
+							if v_ovl_nb = CST_ADDR_A then
+								v.ovl.idx := "00";
+							elsif v_ovl_nb = CST_ADDR_B then
+								v.ovl.idx := "01";
+							else
+								v.ovl.idx := "10";
+							end if;
+						end if;
 						if r.axi.wdatax(
 								CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
 							= CST_ADDR_P
@@ -1698,6 +2019,9 @@ begin
 							-- discarded due to r.ctrl.state not being switched to 'writeln'
 							-- (see (s57))
 							v.ctrl.state := writeln;
+							if axistream then -- statically resolved by synthesizer
+								v.axis.wr := r.axi.wdatax(CTRL_AXIS); -- (s299), see (s298)
+							end if;
 						end if;
 					elsif r.axi.wdatax(CTRL_READ_NB) = '1' then
 						-- ----------------------------------------------------------
@@ -1773,6 +2097,9 @@ begin
 									v.read.bitstotal := to_unsigned(nn - 1, log2(nn));
 								end if;
 								v.ctrl.state := readln;
+								if axistream then -- statically resolved by synthesizer
+									v.axis.rd := r.axi.wdatax(CTRL_AXIS); -- (s299)
+								end if;
 								-- deassertion of r.axi.rvalid by (s192) means: no valid read
 								-- data available from the IP yet on AXI read-data channel
 								v.axi.rvalid := '0'; -- (s192)
@@ -1967,6 +2294,14 @@ begin
 						v.ctrl.state := newnn;
 						v.nndyn.active := '1';
 						v.nndyn.testnn := '1'; -- asserted only 1 cycle, see (s169)
+						-- a new prime size makes the content of ecc_fp_dram obsolete,
+						-- hence the curve context slot bound to it is released (the
+						-- slot stays valid but can only be restored once nn is set
+						-- back to the value it was computed with, see (s304))
+						v.ctx.bound := '0';
+						-- and so are Montgomery constants written by software
+						v.ctrl.hmty := '0';
+						v.ctrl.hseen := (others => '0');
 						-- clear possible past error
 						v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
 					else
@@ -2235,6 +2570,223 @@ begin
 					-- before being generated", see (s247))
 					v.ctrl.ierrid(STATUS_ERR_I_TOKEN) := '1'; -- (s248)
 				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_CMDQ_OP register
+			-- ------------------------------------------------
+			-- writing registers W_CMDQ_* is always allowed (even when the IP is
+			-- busy, which is the whole point of the command queue, see (s287))
+			elsif cmdqsize > 0 and r.axi.waddr = W_CMDQ_OP then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				v.cmdq.opkind := r.axi.wdatax(CMDQ_OP_KIND_MSB downto CMDQ_OP_KIND_LSB);
+				v.cmdq.opreg := r.axi.wdatax(CMDQ_OP_REG_MSB downto CMDQ_OP_REG_LSB);
+			-- ------------------------------------------------
+			-- decoding write to W_CMDQ_PUSH register
+			-- ------------------------------------------------
+			elsif cmdqsize > 0 and r.axi.waddr = W_CMDQ_PUSH then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				if r.cmdq.count /= to_unsigned(cmdqsz, log2(cmdqsz)) then
+					-- push entry {kind, reg, data} into the command queue
+					v.cmdq.we := '1';
+					v.cmdq.wdata := r.cmdq.opkind & r.cmdq.opreg & r.axi.wdatax;
+					v_cmdq_push := TRUE;
+				else
+					-- command queue is full
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_CMDQ_CTRL register
+			-- ------------------------------------------------
+			elsif cmdqsize > 0 and r.axi.waddr = W_CMDQ_CTRL then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				v.cmdq.en := r.axi.wdatax(CMDQ_CTRL_EN);
+				v.cmdq.irqthr :=
+					unsigned(r.axi.wdatax(CMDQ_CTRL_IRQ_MSB downto CMDQ_CTRL_IRQ_LSB));
+				if r.axi.wdatax(CMDQ_CTRL_FLUSH) = '1' then
+					v_cmdq_flush := TRUE; -- applied by (s296)
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_CURVE_SELECT register
+			-- ------------------------------------------------
+			-- (s304), see (s303)
+			elsif nbctx > 0 and r.axi.waddr = W_CURVE_SELECT then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				v_ctx_slot := unsigned(
+					r.axi.wdatax(CURVE_SEL_SLOT_MSB downto CURVE_SEL_SLOT_LSB));
+				if v_wlock or to_integer(v_ctx_slot) >= nbctx then
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				elsif r.axi.wdatax(CURVE_SEL_LOAD) = '0' then
+					-- bind the slot to the curve software is about to upload: its
+					-- content becomes valid only once p, a, b & q have all been
+					-- written (and the Montgomery constants computed) from now on
+					v.ctx.bound := '1';
+					v.ctx.cur := resize(v_ctx_slot, CTXSLOTW);
+					v.ctx.seen := (others => '0');
+					v.ctx.valid(to_integer(v_ctx_slot)) := '0';
+				elsif r.ctx.valid(to_integer(v_ctx_slot)) = '1' and ((not nn_dynamic)
+					or r.ctx.nntag(to_integer(v_ctx_slot)) = r.nndyn.valnn)
+					and r.ctx.redtag(to_integer(v_ctx_slot)) = r.ctrl.redmode
+				then
+					-- switch to the curve held by the slot: replay it into
+					-- ecc_fp_dram, starting with p (hence with 'pen' asserted)
+					v.ctx.bound := '1';
+					v.ctx.cur := resize(v_ctx_slot, CTXSLOTW);
+					v.ctx.idx := (others => '0');
+					v.ctx.limb := (others => '0');
+					v.ctx.cnt := (others => '1');
+					v.ctx.state := gap;
+					v.ctrl.pen := '1';
+					-- all curve parameters are obsolete until the end of the replay
+					v.ctrl.p_set := '0';
+					v.ctrl.p_set_and_mty := '0';
+					v.ctrl.a_set := '0';
+					v.ctrl.a_set_and_mty := '0';
+					v.ctrl.b_set := '0';
+					v.ctrl.q_set := '0';
+					v.ctrl.newp := '0';
+					v.ctrl.newa := '0';
+				else
+					-- slot does not hold any curve (or not a complete one, or one
+					-- computed with another value of nn or another reduction mode)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_FASTRED register
+			-- ------------------------------------------------
+			-- (s306) selection of the reduction mode of the Montgomery
+			-- multipliers: either the generic Montgomery one or the Solinas
+			-- one (fold of the 32-bit words of the product) for P-256 or P-384.
+			-- The mode is used by ecc_scalar to select the routine computing
+			-- the "Montgomery" constants (see (s127) in ecc_scalar.vhd), so
+			-- changing it makes p & a obsolete, exactly as a new value of p
+			elsif FASTRED_EN and r.axi.waddr = W_FASTRED then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				if v_busy or r.axi.wdatax(FASTRED_MODE_MSB downto FASTRED_MODE_LSB)
+					= "11"
+				then
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				elsif r.axi.wdatax(FASTRED_MODE_MSB downto FASTRED_MODE_LSB)
+					/= r.ctrl.redmode
+				then
+					v.ctrl.redmode :=
+						r.axi.wdatax(FASTRED_MODE_MSB downto FASTRED_MODE_LSB);
+					v.ctrl.p_set := '0';
+					v.ctrl.p_set_and_mty := '0';
+					v.ctrl.a_set := '0';
+					v.ctrl.a_set_and_mty := '0';
+					v.ctrl.newp := '0';
+					v.ctrl.newa := '0';
+					-- same as for a new prime size, see W_PRIME_SIZE above
+					v.ctx.bound := '0';
+					v.ctrl.hmty := '0';
+					v.ctrl.hseen := (others => '0');
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_MTYCST register
+			-- ------------------------------------------------
+			-- (s310) Montgomery constants written by software instead of being
+			-- computed by routine .constMTYL, see (s311). Writing W_MTYCST selects
+			-- the constant the next 'w' writes of W_MTYCST_DATA are for (one
+			-- 'ww'-bit limb each, lower ones first). These are written into
+			-- ecc_fp_dram the same way ecc_curve would (p' at the address of
+			-- variable 'inverse' with 'ppen' asserted, so that the Montgomery
+			-- multipliers sample it)
+			elsif HOSTMTY_EN and r.axi.waddr = W_MTYCST then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				if v_busy then
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				else
+					v.ctrl.hmty := '1';
+					v.ctrl.hnb := r.axi.wdatax(MTYCST_NB_MSB downto MTYCST_NB_LSB);
+					v.ctrl.hlimb := (others => '0');
+					v.ctrl.hseen(to_integer(unsigned(
+						r.axi.wdatax(MTYCST_NB_MSB downto MTYCST_NB_LSB)))) := '0';
+					if r.axi.wdatax(MTYCST_NB_MSB downto MTYCST_NB_LSB)
+						= MTYCST_PPRIME
+					then
+						v.ctrl.hppen := '1';
+					else
+						v.ctrl.hppen := '0';
+					end if;
+					-- current value of p becomes obsolete (its constants are being
+					-- overwritten) until the next write of p
+					v.ctrl.p_set := '0';
+					v.ctrl.p_set_and_mty := '0';
+					v.ctrl.a_set := '0';
+					v.ctrl.a_set_and_mty := '0';
+					v.ctrl.newp := '0';
+					v.ctrl.newa := '0';
+					-- clear possible past error
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_MTYCST_DATA register
+			-- ------------------------------------------------
+			elsif HOSTMTY_EN and r.axi.waddr = W_MTYCST_DATA then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				if v_busy or r.ctrl.hmty = '0'
+					or r.ctrl.hseen(to_integer(unsigned(r.ctrl.hnb))) = '1'
+				then
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				else
+					if nn_dynamic then -- statically resolved by synthesizer
+						v_hmty_wm1 := nndyn_wm1_s;
+					else
+						v_hmty_wm1 := to_unsigned(w - 1, log2(w - 1));
+					end if;
+					if r.ctrl.hnb = MTYCST_R2MODP then
+						v_hmty_nb := CST_ADDR_R2MODP;
+					elsif r.ctrl.hnb = MTYCST_TWOP then
+						v_hmty_nb := CST_ADDR_TWOP;
+					elsif r.ctrl.hnb = MTYCST_RMODP then
+						v_hmty_nb := CST_ADDR_RMODP;
+					else
+						v_hmty_nb := CST_ADDR_INVERSE;
+					end if;
+					-- same write path as the one of large numbers written by
+					-- software (overriding the one set from r.write.fpwe0 &
+					-- r.fpaddr0, both being idle here)
+					v.write.fpwe := '1';
+					v.fpaddr := v_hmty_nb
+						& std_logic_vector(resize(r.ctrl.hlimb, log2z(n - 1)));
+					v.write.fpwdata := r.axi.wdatax(ww - 1 downto 0);
+					v.ctrl.hlimb := r.ctrl.hlimb + 1;
+					if r.ctrl.hlimb = v_hmty_wm1 then
+						v.ctrl.hseen(to_integer(unsigned(r.ctrl.hnb))) := '1';
+						v.ctrl.hlimb := (others => '0');
+						if r.ctrl.hppen = '1' then
+							-- let the last limb reach the Montgomery multipliers
+							-- before deasserting 'ppen', see (s185)
+							v.ctrl.pendownsh(3) := '1';
+						end if;
+					end if;
+					-- clear possible past error
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				end if;
 			-- ------------------------------
 			-- below are DEBUG only registers
 			-- ------------------------------
@@ -2719,6 +3271,27 @@ begin
 			end if;
 		end if;
 
+		-- (s312) export of random words to software (read of R_TRNG_DATA
+		-- register, see (s313))
+		-- Only a word which was entirely received from ecc_trng and of which
+		-- no bit has been shifted out for the masking of the scalar is served.
+		-- A word partially used by the masking is dropped instead (and a new
+		-- one requested) so that no random bit is ever used twice.
+		if TRNGEXP_EN then -- statically resolved by synthesizer
+			if r.write.rnd.expend = '1' and r.ctrl.wk = '0'
+				and r.write.rnd.irnempty = '0' and r.write.rnd.trngrdy = '0'
+			then
+				if r.write.rnd.bitsirn = to_unsigned(ww - 1, log2(ww - 1)) then
+					v.axi.rdatax := (others => '0');
+					v.axi.rdatax(ww - 1 downto 0) := r.write.rnd.irn;
+					v.axi.rvalid := '1';
+					v.write.rnd.expend := '0';
+				end if;
+				v.write.rnd.irnempty := '1';
+				v.write.rnd.trngrdy := '1';
+			end if;
+		end if;
+
 		-- --------------
 		-- shift-register during write of large numbers (from AXI to ecc_fp_dram)
 		-- --------------
@@ -2814,14 +3387,37 @@ begin
 						-- large number 'p'
 						v.ctrl.pendownsh(3) := '1';
 					end if;
-					if r.ctrl.newp = '1' and r.ctrl.mtypending = '0' then -- (s11)
+					if r.ctrl.newp = '1' and r.ctrl.mtypending = '0'
+						and HOSTMTY_EN and r.ctrl.hmty = '1' and r.ctrl.hseen = "1111"
+					then
+						-- (s311) Montgomery constants were all written by software
+						-- beforehand (see (s310)): no need to execute .constMTYL, we
+						-- end up in the same state as after (s107)-(s110)
+						v.ctrl.newp := '0';
+						v.write.busy := '0';
+						v.ctrl.p_set_and_mty := '1';
+						v.ctrl.irqsh(3) := '1';
+						if r.ctrl.irqen = '1' and r.cmdq.en = '0' then -- (s297)
+							v.ctrl.irq := '1';
+						end if;
+					elsif r.ctrl.newp = '1' and r.ctrl.mtypending = '0' then -- (s11)
 						v.ctrl.agocstmty := '1'; -- reset by (s1) after ecc_scalar's ACK
 						v.write.busy := '0';
 					end if;
+					if r.ctrl.newp = '1' then
+						-- constants written by software (if any) are consumed
+						v.ctrl.hmty := '0';
+						v.ctrl.hseen := (others => '0');
+					end if;
 					-- (s178), see (s177)
 					v_fpaddr0_msb :=
 						r.fpaddr0(log2z(n - 1) + FP_ADDR_MSB - 1 downto log2z(n - 1));
-					if v_fpaddr0_msb = CST_ADDR_P then
+					if mtyovl and r.ovl.stg = '1' then
+						-- the large number is only in the staging RAM for now, its
+						-- flag will be set once replayed into ecc_fp_dram, see (s309)
+						v.ovl.stg := '0';
+						v.ovl.staged(to_integer(r.ovl.idx)) := '1';
+					elsif v_fpaddr0_msb = CST_ADDR_P then
 						v.ctrl.p_set := '1'; -- (s112)
 					elsif v_fpaddr0_msb = CST_ADDR_A then
 						v.ctrl.a_set := '1'; -- (s113), see (s181)
@@ -3094,6 +3690,7 @@ begin
 		end if;
 		if r.ctrl.pendownsh(0) = '1' then
 			v.ctrl.pen := '0';
+			v.ctrl.hppen := '0';
 		end if;
 
 		-- interrupt, once raised, lasts 4 cycles
@@ -3110,7 +3707,13 @@ begin
 			-- we test if curve parameter 'a' has already been set by software,
 			-- and if so we make ecc_scalar execute routine .aMontyL to switch
 			-- 'a' in Montgomery domain
-			if r.ctrl.a_set = '1' then
+			if mtyovl and (r.ovl.stg = '1' or r.ovl.staged /= "000") then
+				-- some of a, b & q were written meanwhile & must first be
+				-- replayed into ecc_fp_dram: the test on 'a' is made at the end
+				-- of the replay, see (s309)
+				v.ovl.pend := '1';
+				v.ctrl.mtypending := '1';
+			elsif r.ctrl.a_set = '1' then
 				v.ctrl.agomtya := '1'; -- (s104), will be reset by (s105)
 				v.ctrl.mtyirq_postponed := '1'; -- (s106)
 				-- we keep .mtypending asserted to maintain (s30) coherent
@@ -3120,7 +3723,7 @@ begin
 				-- post-processing (means SW has first written 'p', and then 'a')
 				-- so we generate the IRQ now
 				v.ctrl.irqsh(3) := '1';
-				if r.ctrl.irqen = '1' then
+				if r.ctrl.irqen = '1' and r.cmdq.en = '0' then -- (s297)
 					v.ctrl.irq := '1';
 				end if;
 			end if;
@@ -3162,7 +3765,7 @@ begin
 			if r.ctrl.mtyirq_postponed = '1' then
 				v.ctrl.mtyirq_postponed := '0';
 				v.ctrl.irqsh(3) := '1';
-				if r.ctrl.irqen = '1' then
+				if r.ctrl.irqen = '1' and r.cmdq.en = '0' then -- (s297)
 					v.ctrl.irq := '1';
 				end if;
 			end if;
@@ -3173,7 +3776,7 @@ begin
 		if kpdone = '1' and r.ctrl.kpdone_d = '0' then
 			v.ctrl.kppending := '0';
 			v.ctrl.irqsh(3) := '1';
-			if r.ctrl.irqen = '1' then
+			if r.ctrl.irqen = '1' and r.cmdq.en = '0' then -- (s297)
 				v.ctrl.irq := '1';
 			end if;
 			-- r.ctrl.[kxy]_set are considered stale at the end of a [k]P computation
@@ -3261,7 +3864,7 @@ begin
 		if popdone = '1' and r.ctrl.popdone_d = '0' then
 			v.ctrl.poppending := '0';
 			v.ctrl.irqsh(3) := '1';
-			if r.ctrl.irqen = '1' then
+			if r.ctrl.irqen = '1' and r.cmdq.en = '0' then -- (s297)
 				v.ctrl.irq := '1';
 			end if;
 			-- authorize SW to read the result
@@ -3311,7 +3914,9 @@ begin
 		-- ----------------------------------------------------------
 
 		-- handshake over AXI address-read channel
-		if s_axi_arvalid = '1' and r.axi.arready = '1' then
+		if s_axi_arvalid = '1' and r.axi.arready = '1'
+			and r.cmdq.lock = '0' and r.axis.lock = '0'
+		then
 			-- by immediately deasserting r.axi.arready (which directly drives
 			-- s_axi_arready) in (s143) below, we're telling AXI fabric that
 			-- we're not ready to accept a new read address again, not until...
@@ -3336,35 +3941,7 @@ begin
 			--  or ((hwsecure) and s_axi_araddr(ADB + 1 downto 3) =
 			--		R_STATUS(ADB - 2 downto 0))
 			then
-				dw := (others => '0');
-				-- Informational bits
-				if v_busy then -- (s160), see (s30)
-					dw(STATUS_BUSY) := '1';
-				else
-					dw(STATUS_BUSY) := '0';
-				end if;
-				dw(STATUS_KP) := r.ctrl.kppending;
-				dw(STATUS_MTY) :=
-				     r.ctrl.mtypending or r.ctrl.agocstmty -- or r.ctrl.newp;
-				  or r.ctrl.amtypending or r.ctrl.agomtya;
-				dw(STATUS_POP) := r.ctrl.poppending;
-				dw(STATUS_R_OR_W) := r.write.busy or r.read.busy;
-				dw(STATUS_INIT) := not initdone;
-				dw(STATUS_ENOUGH_RND_WK) := not r.write.rnd.enough_random;
-				if nn_dynamic then -- statically resolved by synthesizer
-					dw(STATUS_NNDYNACT) := r.nndyn.active;
-				else
-					dw(STATUS_NNDYNACT) := '0';
-				end if;
-				dw(STATUS_YES) := r.ctrl.yes; -- (s98), was set by (s96)
-				dw(STATUS_R0_IS_NULL) := r.ctrl.r0_is_null;
-				dw(STATUS_R1_IS_NULL) := r.ctrl.r1_is_null;
-				dw(STATUS_TOKEN_GEN) := r.ctrl.tokpending or r.ctrl.gentoken;
-				-- Error bits
-				dw(STATUS_ERR_IN_PT_NOT_ON_CURVE) := aerr_inpt_not_on_curve;
-				dw(STATUS_ERR_OUT_PT_NOT_ON_CURVE) := aerr_outpt_not_on_curve;
-				dw(STATUS_ERR_I_MSB downto STATUS_ERR_I_LSB) := r.ctrl.ierrid;
-				v.axi.rdatax := dw;
+				v.axi.rdatax := v_status;
 				v.axi.rvalid := '1'; -- (s5)
 			-- -------------------------------------
 			-- decoding read of R_READ_DATA register
@@ -3413,6 +3990,48 @@ begin
 				else
 					dw(CAP_SHF) := '0';
 				end if;
+				-- is hardware command queue implemented?
+				if cmdqsize > 0 then -- statically resolved by synthesizer
+					dw(CAP_CMDQ) := '1';
+				else
+					dw(CAP_CMDQ) := '0';
+				end if;
+				-- are AXI-Stream ports for large numbers implemented?
+				if axistream then -- statically resolved by synthesizer
+					dw(CAP_AXIS) := '1';
+				else
+					dw(CAP_AXIS) := '0';
+				end if;
+				-- are curve context slots implemented?
+				if nbctx > 0 then -- statically resolved by synthesizer
+					dw(CAP_CTX) := '1';
+				else
+					dw(CAP_CTX) := '0';
+				end if;
+				-- can a, b & q be written while Montgomery constants are computed?
+				if mtyovl then -- statically resolved by synthesizer
+					dw(CAP_MTYOVL) := '1';
+				else
+					dw(CAP_MTYOVL) := '0';
+				end if;
+				-- can software write the Montgomery constants?
+				if HOSTMTY_EN then -- statically resolved by synthesizer
+					dw(CAP_HOSTMTY) := '1';
+				else
+					dw(CAP_HOSTMTY) := '0';
+				end if;
+				-- can software read random words from the TRNG?
+				if TRNGEXP_EN then -- statically resolved by synthesizer
+					dw(CAP_TRNGEXP) := '1';
+				else
+					dw(CAP_TRNGEXP) := '0';
+				end if;
+				-- is Solinas reduction mode implemented?
+				if FASTRED_EN then -- statically resolved by synthesizer
+					dw(CAP_FASTRED) := '1';
+				else
+					dw(CAP_FASTRED) := '0';
+				end if;
 				-- is AXI interface 32 or 64 bit
 				if C_S_AXI_DATA_WIDTH = 64 then
 					dw(CAP_W64) := '1';
@@ -3461,6 +4080,99 @@ begin
 					resize(r.nndyn.valnn, C_S_AXI_DATA_WIDTH));
 				v.axi.rdatax := dw;
 				v.axi.rvalid := '1'; -- (s5)
+			-- ---------------------------------------
+			-- decoding read of R_CMDQ_STATUS register
+			-- ---------------------------------------
+			elsif cmdqsize > 0 and s_axi_araddr(ADB + 2 downto 3) = R_CMDQ_STATUS
+			then
+				dw := (others => '0');
+				-- nb of free entries in the command queue
+				dw(CMDQ_ST_FREE_MSB downto CMDQ_ST_FREE_LSB) := std_logic_vector(
+					to_unsigned(cmdqsize, CMDQ_ST_FREE_MSB - CMDQ_ST_FREE_LSB + 1)
+					- resize(r.cmdq.count, CMDQ_ST_FREE_MSB - CMDQ_ST_FREE_LSB + 1));
+				-- nb of words available in the result FIFO
+				dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB) := std_logic_vector(
+					resize(r.cmdq.rescount, CMDQ_ST_RES_MSB - CMDQ_ST_RES_LSB + 1));
+				v.axi.rdatax := dw;
+				v.axi.rvalid := '1'; -- (s5)
+			-- ---------------------------------------
+			-- decoding read of R_CMDQ_RESULT register
+			-- ---------------------------------------
+			elsif cmdqsize > 0 and s_axi_araddr(ADB + 2 downto 3) = R_CMDQ_RESULT
+			then
+				if r.cmdq.rescount /= 0 then
+					-- pop one word from the result FIFO, r.axi.rvalid will be
+					-- asserted by (s290) once the word is out of the memory
+					v.cmdq.resre := '1';
+					v_res_pop := TRUE;
+				else
+					v.axi.rdatax := (others => '1'); -- 0xFFF...FF
+					v.axi.rvalid := '1'; -- (s5)
+					v.ctrl.ierrid(STATUS_ERR_I_RREG_FBD) := '1';
+				end if;
+			-- -------------------------------------
+			-- decoding read of R_CMDQ_IDLE register
+			-- -------------------------------------
+			elsif cmdqsize > 0 and s_axi_araddr(ADB + 2 downto 3) = R_CMDQ_IDLE then
+				v.axi.rdatax := std_logic_vector(
+					resize(r.cmdq.idlecnt, C_S_AXI_DATA_WIDTH));
+				v.axi.rvalid := '1'; -- (s5)
+			-- ----------------------------------------
+			-- decoding read of R_CURVE_STATUS register
+			-- ----------------------------------------
+			elsif nbctx > 0 and s_axi_araddr(ADB + 2 downto 3) = R_CURVE_STATUS
+			then
+				dw := (others => '0');
+				for i in 0 to nbctx - 1 loop
+					dw(CURVE_ST_VALID_LSB + i) := r.ctx.valid(i);
+				end loop;
+				dw(CURVE_ST_CUR_MSB downto CURVE_ST_CUR_LSB) := std_logic_vector(
+					resize(r.ctx.cur, CURVE_ST_CUR_MSB - CURVE_ST_CUR_LSB + 1));
+				dw(CURVE_ST_BOUND) := r.ctx.bound;
+				dw(CURVE_ST_NB_MSB downto CURVE_ST_NB_LSB) := std_logic_vector(
+					to_unsigned(nbctx, CURVE_ST_NB_MSB - CURVE_ST_NB_LSB + 1));
+				v.axi.rvalid := '1'; -- (s5)
+				v.axi.rdatax := dw;
+			-- ----------------------------------
+			-- decoding read of R_MTYCST register
+			-- ----------------------------------
+			elsif HOSTMTY_EN and s_axi_araddr(ADB + 2 downto 3) = R_MTYCST then
+				dw := (others => '0');
+				dw(MTYCST_ST_WW_MSB downto MTYCST_ST_WW_LSB) := std_logic_vector(
+					to_unsigned(ww, MTYCST_ST_WW_MSB - MTYCST_ST_WW_LSB + 1));
+				dw(MTYCST_ST_SEEN_MSB downto MTYCST_ST_SEEN_LSB) := r.ctrl.hseen;
+				dw(MTYCST_ST_ARMED) := r.ctrl.hmty;
+				v.axi.rvalid := '1'; -- (s5)
+				v.axi.rdatax := dw;
+			-- ---------------------------------------
+			-- decoding read of R_TRNG_STATUS register
+			-- ---------------------------------------
+			elsif TRNGEXP_EN and s_axi_araddr(ADB + 2 downto 3) = R_TRNG_STATUS
+			then
+				dw := (others => '0');
+				-- nb of words in the FIFO, plus the one possibly already pulled
+				-- out of it (if not partially used, see (s312))
+				dw(TRNG_ST_CNT_MSB downto TRNG_ST_CNT_LSB) := std_logic_vector(
+					resize(unsigned(trngaxiirncount),
+						TRNG_ST_CNT_MSB - TRNG_ST_CNT_LSB + 1));
+				if r.ctrl.wk = '0' and r.write.rnd.irnempty = '0'
+					and r.write.rnd.bitsirn = to_unsigned(ww - 1, log2(ww - 1))
+				then
+					dw(TRNG_ST_CNT_MSB downto TRNG_ST_CNT_LSB) := std_logic_vector(
+						resize(unsigned(trngaxiirncount),
+							TRNG_ST_CNT_MSB - TRNG_ST_CNT_LSB + 1) + 1);
+				end if;
+				dw(TRNG_ST_WW_MSB downto TRNG_ST_WW_LSB) := std_logic_vector(
+					to_unsigned(ww, TRNG_ST_WW_MSB - TRNG_ST_WW_LSB + 1));
+				v.axi.rvalid := '1'; -- (s5)
+				v.axi.rdatax := dw;
+			-- -------------------------------------
+			-- decoding read of R_TRNG_DATA register
+			-- -------------------------------------
+			elsif TRNGEXP_EN and s_axi_araddr(ADB + 2 downto 3) = R_TRNG_DATA then
+				-- (s313) r.axi.rvalid will be asserted by (s312) as soon as a
+				-- fresh random word is available
+				v.write.rnd.expend := '1';
 			-- ------------------------------
 			-- below are DEBUG only registers
 			-- ------------------------------
@@ -3828,7 +4540,7 @@ begin
 		end if;
 
 		-- handshake over AXI data-read channel
-		if r.axi.rvalid = '1' and s_axi_rready = '1' then
+		if r.axi.rvalid = '1' and v_rready = '1' then -- (s294)
 			v.axi.rvalid := '0';
 			-- tell AXI fabric that our AXI address-read channel is ready
 			-- to accept a new address again
@@ -3867,6 +4579,604 @@ begin
 			end if;
 		end if;
 
+		-- ----------------------------------------------------------
+		--              h a r d w a r e   c o m m a n d
+		--                         q u e u e
+		-- ----------------------------------------------------------
+		-- (s287)
+		-- Software driver can enqueue register accesses into the command queue
+		-- (using registers W_CMDQ_OP & W_CMDQ_PUSH) at any time, including while
+		-- the IP is busy computing. Each entry is made of a kind, the address
+		-- of a register & a data word:
+		--
+		--   - CMDQ_KIND_WRITE: write of 'data' into write register 'reg' ;
+		--   - CMDQ_KIND_READ: 'data' successive reads of R_READ_DATA register,
+		--       each word read being pushed into the result FIFO ;
+		--   - CMDQ_KIND_DONE: completion marker, pushes 'data' (a tag chosen
+		--       by software) followed by a snapshot of R_STATUS register into
+		--       the result FIFO & (possibly) raises the IRQ, see (s293).
+		--
+		-- When enabled (bit CMDQ_CTRL_EN of W_CMDQ_CTRL) the dispatcher below
+		-- pops entries one after the other and, as soon as the IP is no longer
+		-- busy (v_busy, see (s30)), replays them through the very same decoding
+		-- logic as the one used for the AXI accesses made by software (by
+		-- injecting them into r.axi.[aw|dw]pending and r.read.arpending). Hence
+		-- all the checks & countermeasures attached to register accesses (token,
+		-- on-the-fly masking of the scalar, etc) equally apply.
+		-- While an access is being replayed, the AXI handshake signals are
+		-- hidden from software (r.cmdq.lock, see (s295)).
+		if cmdqsize > 0 then -- statically resolved by synthesizer
+			-- pointers are incremented once the access to memory was actually done
+			if r.cmdq.we = '1' then
+				v.cmdq.wptr := r.cmdq.wptr + 1;
+			end if;
+			if r.cmdq.re = '1' then
+				v.cmdq.rptr := r.cmdq.rptr + 1;
+			end if;
+			if r.cmdq.reswe = '1' then
+				v.cmdq.reswptr := r.cmdq.reswptr + 1;
+			end if;
+			if r.cmdq.resre = '1' then
+				v.cmdq.resrptr := r.cmdq.resrptr + 1;
+			end if;
+			-- (s290) word popped from the result FIFO by a read of R_CMDQ_RESULT
+			-- is available on the output of the memory
+			if r.cmdq.resdv = '1' then
+				v.axi.rdatax := cmdqres_dob;
+				v.axi.rvalid := '1';
+			end if;
+			-- dispatcher
+			case r.cmdq.state is
+				when idle =>
+					if r.cmdq.en = '1' and r.cmdq.count /= 0 then
+						v.cmdq.re := '1';
+						v_cmdq_pop := TRUE;
+						v.cmdq.state := fetch;
+					end if;
+				when fetch =>
+					-- entry is being read from memory in this cycle
+					v.cmdq.state := fetched;
+				when fetched =>
+					v.cmdq.kind := cmdq_dob(CMDQW - 1 downto CMDQW - 2);
+					v.cmdq.reg := cmdq_dob(CMDQW - 3 downto C_S_AXI_DATA_WIDTH);
+					v.cmdq.data := cmdq_dob(C_S_AXI_DATA_WIDTH - 1 downto 0);
+					v.cmdq.nbw := unsigned(cmdq_dob(15 downto 0));
+					v.cmdq.state := waitrdy;
+					if cmdq_dob(CMDQW - 1 downto CMDQW - 2) = CMDQ_KIND_WRITE then
+						-- the command queue does not act upon itself: entries targeting
+						-- registers W_CMDQ_* are simply dropped
+						if cmdq_dob(CMDQW - 3 downto C_S_AXI_DATA_WIDTH) = W_CMDQ_OP
+							or cmdq_dob(CMDQW - 3 downto C_S_AXI_DATA_WIDTH) = W_CMDQ_PUSH
+							or cmdq_dob(CMDQW - 3 downto C_S_AXI_DATA_WIDTH) = W_CMDQ_CTRL
+						then
+							v.cmdq.state := idle;
+						end if;
+					elsif cmdq_dob(CMDQW - 1 downto CMDQW - 2) = CMDQ_KIND_READ then
+						if cmdq_dob(15 downto 0) = x"0000" then
+							v.cmdq.state := idle;
+						end if;
+					elsif cmdq_dob(CMDQW - 1 downto CMDQW - 2) /= CMDQ_KIND_DONE then
+						-- reserved kind, entry is dropped
+						v.cmdq.state := idle;
+					end if;
+				when waitrdy =>
+					v_cmdq_go := (not v_busy) and r.axis.lock = '0';
+					-- a write of the scalar can only start if there are enough random
+					-- numbers to mask it on-the-fly (the software driver would else
+					-- poll bit STATUS_ENOUGH_RND_WK of R_STATUS register before)
+					if r.cmdq.kind = CMDQ_KIND_WRITE and r.cmdq.reg = W_CTRL
+						and r.cmdq.data(CTRL_WRITE_K) = '1'
+						and r.write.rnd.enough_random = '0'
+						and (hwsecure or r.debug.noaxirnd = '0')
+					then
+						v_cmdq_go := FALSE;
+					end if;
+					-- (s314) a read of R_READ_DATA can only be replayed if its word
+					-- has room in the result FIFO: once it is injected, AXI handshakes
+					-- are hidden from software (r.cmdq.lock) which thus could no longer
+					-- read R_CMDQ_RESULT to make room in the FIFO. Only the dispatcher
+					-- pushes into it, so room checked here is still there in rbeat
+					if r.cmdq.kind = CMDQ_KIND_READ
+						and r.cmdq.rescount = to_unsigned(cmdqsz, log2(cmdqsz))
+					then
+						v_cmdq_go := FALSE;
+					end if;
+					if v_cmdq_go then
+						if r.cmdq.kind = CMDQ_KIND_DONE then
+							v.cmdq.state := done1;
+						else
+							v.cmdq.lock := '1';
+							v.cmdq.state := lock;
+						end if;
+					elsif not v_busy then
+						-- (s288) count the cycles where the IP is idle & an entry is
+						-- ready to be replayed, but can't (starvation of random numbers,
+						-- result FIFO full, or race with an AXI access from software, see
+						-- below). These
+						-- are the only idle cycles the dispatcher introduces between two
+						-- replayed accesses besides its own fixed pipeline latency
+						v.cmdq.idlecnt := r.cmdq.idlecnt + 1;
+					end if;
+				when lock =>
+					-- AXI handshakes are now hidden from software, but one of its
+					-- accesses may have been accepted in the previous cycle
+					if (not v_busy) and r.axis.lock = '0'
+						and r.axi.awpending = '0' and r.axi.dwpending = '0'
+						and r.axi.awready = '1' and r.axi.wready = '1'
+						and r.axi.arready = '1' and r.axi.rvalid = '0'
+						and r.read.arpending = '0'
+					then
+						if r.cmdq.kind = CMDQ_KIND_WRITE then
+							-- inject the write as if it came from both AXI address-write &
+							-- data-write channels (see handshakes of (s0))
+							v.axi.awpending := '1';
+							v.axi.dwpending := '1';
+							v.axi.waddr := std_logic_vector(
+								resize(unsigned(r.cmdq.reg), C_S_AXI_ADDR_WIDTH - 3));
+							v.axi.wdatax := r.cmdq.data;
+							v.axi.awready := '0';
+							v.axi.wready := '0';
+							v.axi.arready := '0';
+							v.cmdq.state := wbeat;
+						else -- CMDQ_KIND_READ
+							-- inject a read of R_READ_DATA (same as (s143) & following)
+							v.axi.arready := '0';
+							if r.ctrl.state = readln then
+								v.read.arpending := '1';
+							else
+								v.axi.rvalid := '1';
+								v.axi.rdatax := (others => '1'); -- 0xFFF...FF
+								v.ctrl.ierrid(STATUS_ERR_I_RREG_FBD) := '1';
+							end if;
+							v.cmdq.state := rbeat;
+						end if;
+					else
+						v.cmdq.lock := '0';
+						v.cmdq.state := waitrdy;
+						v.cmdq.idlecnt := r.cmdq.idlecnt + 1; -- (s288)
+					end if;
+				when wbeat =>
+					-- (s292) the write-response channel must stay the one of software
+					-- (the replayed write was decoded as any other one & may have
+					-- asserted r.axi.bvalid, possibly later, e.g W_BLINDING)
+					if r.axi.bvalid = '1' and s_axi_bready = '1' then
+						v.axi.bvalid := '0';
+					else
+						v.axi.bvalid := r.axi.bvalid;
+					end if;
+					-- end of the write beat is signaled by the reassertion of both
+					-- AWREADY & WREADY
+					if r.axi.awpending = '0' and r.axi.awready = '1'
+						and r.axi.wready = '1'
+					then
+						v.cmdq.lock := '0';
+						v.cmdq.state := idle;
+					end if;
+				when rbeat =>
+					-- the handshake over AXI data-read channel takes place with
+					-- v_rready, see (s294)
+					if r.axi.rvalid = '1' and v_rready = '1' then
+						v_res_push := TRUE;
+						v_res_data := r.axi.rdatax;
+						v.cmdq.lock := '0';
+						v.cmdq.nbw := r.cmdq.nbw - 1;
+						if r.cmdq.nbw = 1 then
+							v.cmdq.state := idle;
+						else
+							-- next word will be available once v_busy is deasserted again
+							v.cmdq.state := waitrdy;
+						end if;
+					end if;
+				when done1 =>
+					-- (s293) completion marker needs two free words in result FIFO
+					if r.cmdq.rescount <= to_unsigned(cmdqsz - 2, log2(cmdqsz)) then
+						v_res_push := TRUE;
+						v_res_data := r.cmdq.data; -- tag
+						v.cmdq.state := done2;
+					end if;
+				when done2 =>
+					v_res_push := TRUE;
+					v_res_data := v_status;
+					v.cmdq.state := idle;
+					-- IRQ coalescing: one IRQ every 'irqthr' completion markers (a
+					-- threshold of 0 behaves as 1) or when the queue gets empty
+					v.cmdq.donecnt := r.cmdq.donecnt + 1;
+					if r.cmdq.donecnt + 1 >= r.cmdq.irqthr or r.cmdq.count = 0 then
+						v.cmdq.donecnt := (others => '0');
+						v.ctrl.irqsh(3) := '1';
+						if r.ctrl.irqen = '1' then
+							v.ctrl.irq := '1';
+						end if;
+					end if;
+			end case;
+			-- update of FIFOs' fill levels
+			if v_cmdq_push and not v_cmdq_pop then
+				v.cmdq.count := r.cmdq.count + 1;
+			elsif v_cmdq_pop and not v_cmdq_push then
+				v.cmdq.count := r.cmdq.count - 1;
+			end if;
+			if v_res_push then
+				v.cmdq.reswe := '1';
+				v.cmdq.reswdata := v_res_data;
+			end if;
+			if v_res_push and not v_res_pop then
+				v.cmdq.rescount := r.cmdq.rescount + 1;
+			elsif v_res_pop and not v_res_push then
+				v.cmdq.rescount := r.cmdq.rescount - 1;
+			end if;
+			-- (s296) flush of both the command queue & the result FIFO (the pop
+			-- of a word from result FIFO that may be in progress is let complete)
+			if v_cmdq_flush then
+				v.cmdq.state := idle;
+				v.cmdq.lock := '0';
+				v.cmdq.we := '0';
+				v.cmdq.re := '0';
+				v.cmdq.wptr := (others => '0');
+				v.cmdq.rptr := (others => '0');
+				v.cmdq.count := (others => '0');
+				v.cmdq.reswe := '0';
+				v.cmdq.reswptr := v.cmdq.resrptr;
+				v.cmdq.rescount := (others => '0');
+				v.cmdq.donecnt := (others => '0');
+				v.cmdq.idlecnt := (others => '0');
+			end if;
+		end if; -- cmdqsize > 0
+
+		-- ----------------------------------------------------------
+		--             A X I - S t r e a m   p o r t s
+		--                  for large numbers
+		-- ----------------------------------------------------------
+		-- (s298)
+		-- When software sets bit CTRL_AXIS in W_CTRL along with CTRL_WRITE_NB
+		-- (resp. CTRL_READ_NB), see (s299), the words of the large number are
+		-- transferred through s_axis_* (resp. m_axis_*) instead of register
+		-- W_WRITE_DATA (resp. R_READ_DATA). Each beat is injected into the
+		-- decoding logic exactly as a write of W_WRITE_DATA (resp. a read of
+		-- R_READ_DATA) made by software, the same way the command queue does
+		-- (see (s287)), so that the shift-registers to & from ecc_fp_dram and
+		-- the on-the-fly masking of the scalar are left unchanged. Software
+		-- keeps access to the AXI-lite interface inbetween two beats.
+		if axistream then -- statically resolved by synthesizer
+			v.axis.tready := '0';
+			case r.axis.state is
+				when idle =>
+					if r.cmdq.lock = '0' and v.cmdq.lock = '0' then
+						-- grab the write channels only if software is not currently
+						-- using them (including in this very cycle) & if the previous
+						-- word has been entirely shifted (reassertion of WREADY)
+						if r.axis.wr = '1' and r.ctrl.state = writeln
+							and r.axi.awpending = '0' and r.axi.dwpending = '0'
+							and v.axi.awpending = '0' and v.axi.dwpending = '0'
+							and r.axi.awready = '1' and r.axi.wready = '1'
+						then
+							v.axis.lock := '1';
+							v.axis.tready := '1';
+							v.axis.state := wbeat;
+						-- same for the read channels
+						elsif r.axis.rd = '1' and r.ctrl.state = readln
+							and r.axi.arready = '1' and v.axi.arready = '1'
+							and r.axi.rvalid = '0' and v.axi.rvalid = '0'
+							and r.read.arpending = '0'
+							and r.axi.awpending = '0' and v.axi.awpending = '0'
+						then
+							-- inject a read of R_READ_DATA (same as (s143) & following)
+							v.axis.lock := '1';
+							v.read.arpending := '1';
+							v.axi.arready := '0';
+							v.axis.state := rbeat;
+						end if;
+					end if;
+				when wbeat =>
+					if s_axis_tvalid = '1' then
+						-- inject the write as if it came from both AXI address-write &
+						-- data-write channels (see handshakes of (s0))
+						v.axi.awpending := '1';
+						v.axi.dwpending := '1';
+						v.axi.waddr := std_logic_vector(
+							resize(unsigned(W_WRITE_DATA), C_S_AXI_ADDR_WIDTH - 3));
+						v.axi.wdatax := s_axis_tdata;
+						v.axi.awready := '0';
+						v.axi.wready := '0';
+						v.axi.arready := '0';
+						v.axis.state := wdecode;
+					else
+						-- no data on the stream yet: release the AXI-lite interface
+						-- & try again later
+						v.axis.lock := '0';
+						v.axis.state := idle;
+					end if;
+				when wdecode =>
+					-- the injected write is being decoded in this cycle: the write-
+					-- response channel must stay the one of software (same as (s292))
+					if r.axi.bvalid = '1' and s_axi_bready = '1' then
+						v.axi.bvalid := '0';
+					else
+						v.axi.bvalid := r.axi.bvalid;
+					end if;
+					v.axis.lock := '0';
+					v.axis.state := idle;
+				when rbeat =>
+					-- the handshake over AXI data-read channel takes place with
+					-- v_rready, see (s294)
+					if r.axi.rvalid = '1' and v_rready = '1' then
+						v.axis.lock := '0';
+						v.axis.state := idle;
+					end if;
+			end case;
+			-- end of the large number transfer
+			if v.ctrl.state /= writeln then
+				v.axis.wr := '0';
+			end if;
+			if v.ctrl.state /= readln then
+				v.axis.rd := '0';
+			end if;
+		end if; -- axistream
+
+		-- ----------------------------------------------------------
+		--              C u r v e   c o n t e x t   s l o t s
+		-- ----------------------------------------------------------
+		-- (s303)
+		-- Each of the 'nbctx' slots of the context RAM holds the 8 large
+		-- numbers which only depend on the curve, at index:
+		--   0: p          2: b          4: R^2 mod p     6: R mod p
+		--   1: a (Mty)    3: q          5: 2p            7: p'
+		-- p' is not kept in ecc_fp_dram but only in the Montgomery multipliers:
+		-- it is captured as ecc_curve pushes it to them during routine
+		-- .constMTYL ('crvppen' asserted).
+		-- The slot bound by software (see (s304)) is kept in sync by snooping
+		-- all writes into ecc_fp_dram. It becomes valid once p, a, b & q have
+		-- all been written since binding and the Montgomery constants have
+		-- been computed, i.e when [k]P computation would be authorized.
+		-- Restoring a slot replays the 8 numbers into ecc_fp_dram, 2 cycles per
+		-- limb, with 'pen' asserted while replaying p and 'ppen' asserted while
+		-- replaying p' (the latter being written at the address of variable
+		-- 'inverse' which is only a temporary), so that the Montgomery
+		-- multipliers sample them exactly as when they were first computed.
+		if nbctx > 0 then -- statically resolved by synthesizer
+			v.ctx.we := '0';
+			v.ctx.re := '0';
+			if nn_dynamic then -- statically resolved by synthesizer
+				v_ctx_wm1 := nndyn_wm1_s;
+			else
+				v_ctx_wm1 := to_unsigned(w - 1, log2(w - 1));
+			end if;
+			-- snooping of writes into ecc_fp_dram
+			v_ctx_nb := fpwaddr(FP_ADDR - 1 downto FP_ADDR - FP_ADDR_MSB);
+			if v_ctx_nb = CST_ADDR_P then
+				v_ctx_idx := to_unsigned(0, 4);
+			elsif v_ctx_nb = CST_ADDR_A then
+				v_ctx_idx := to_unsigned(1, 4);
+			elsif v_ctx_nb = CST_ADDR_B then
+				v_ctx_idx := to_unsigned(2, 4);
+			elsif v_ctx_nb = CST_ADDR_Q then
+				v_ctx_idx := to_unsigned(3, 4);
+			elsif v_ctx_nb = CST_ADDR_R2MODP then
+				v_ctx_idx := to_unsigned(4, 4);
+			elsif v_ctx_nb = CST_ADDR_TWOP then
+				v_ctx_idx := to_unsigned(5, 4);
+			elsif v_ctx_nb = CST_ADDR_RMODP then
+				v_ctx_idx := to_unsigned(6, 4);
+			else
+				v_ctx_idx := to_unsigned(8, 4); -- not part of a curve context
+			end if;
+			if fpwe = '1' and (crvppen = '1' or r.ctrl.hppen = '1') then
+				-- limbs of p' are pushed in order, w of them each time (same
+				-- counting as in mm_ndsp)
+				v.ctx.ppcnt := r.ctx.ppcnt + 1;
+				if r.ctx.ppcnt = v_ctx_wm1 then
+					v.ctx.ppcnt := (others => '0');
+				end if;
+				v.ctx.we := r.ctx.bound;
+				v.ctx.waddr := std_logic_vector(r.ctx.cur) & "111"
+					& std_logic_vector(resize(r.ctx.ppcnt, log2z(n - 1)));
+				v.ctx.wdata := fpwdata;
+			elsif fpwe = '1' and v_ctx_idx(3) = '0' then
+				v.ctx.we := r.ctx.bound;
+				v.ctx.waddr := std_logic_vector(r.ctx.cur)
+					& std_logic_vector(v_ctx_idx(2 downto 0))
+					& fpwaddr(log2z(n - 1) - 1 downto 0);
+				v.ctx.wdata := fpwdata;
+			end if;
+			-- (s305) validity of the bound slot (see (s304))
+			if r.ctx.bound = '1' and r.ctx.state = idle then
+				v.ctx.valid(to_integer(r.ctx.cur)) := r.ctx.seen(0)
+					and r.ctx.seen(1) and r.ctx.seen(2) and r.ctx.seen(3)
+					and r.ctrl.p_set and r.ctrl.p_set_and_mty
+					and r.ctrl.a_set and r.ctrl.a_set_and_mty
+					and r.ctrl.b_set and r.ctrl.q_set;
+				v.ctx.nntag(to_integer(r.ctx.cur)) := r.nndyn.valnn;
+				v.ctx.redtag(to_integer(r.ctx.cur)) := r.ctrl.redmode;
+			end if;
+			-- replay of a slot into ecc_fp_dram
+			case r.ctx.state is
+				when idle =>
+					null;
+				when gap =>
+					-- let 'pen'/'ppen' settle before first limb is written
+					v.ctx.cnt := r.ctx.cnt - 1;
+					if r.ctx.cnt = "00" then
+						v.ctx.state := rd;
+					end if;
+				when rd =>
+					-- read of the first limb from the context RAM
+					v.ctx.re := '1';
+					v.ctx.raddr := std_logic_vector(r.ctx.cur)
+						& std_logic_vector(r.ctx.idx)
+						& std_logic_vector(resize(r.ctx.limb, log2z(n - 1)));
+					v.ctx.state := rdw;
+				when rdw =>
+					-- limb is being read (r.ctx.re asserted)
+					v.ctx.state := wr;
+				when wr =>
+					-- same write path as the one of large numbers written by
+					-- software (overriding the one set from r.write.fpwe0 &
+					-- r.fpaddr0, both being idle here)
+					if r.ctx.idx = "000" then
+						v_ctx_nb := CST_ADDR_P;
+					elsif r.ctx.idx = "001" then
+						v_ctx_nb := CST_ADDR_A;
+					elsif r.ctx.idx = "010" then
+						v_ctx_nb := CST_ADDR_B;
+					elsif r.ctx.idx = "011" then
+						v_ctx_nb := CST_ADDR_Q;
+					elsif r.ctx.idx = "100" then
+						v_ctx_nb := CST_ADDR_R2MODP;
+					elsif r.ctx.idx = "101" then
+						v_ctx_nb := CST_ADDR_TWOP;
+					elsif r.ctx.idx = "110" then
+						v_ctx_nb := CST_ADDR_RMODP;
+					else
+						v_ctx_nb := CST_ADDR_INVERSE;
+					end if;
+					v.write.fpwe := '1';
+					v.fpaddr := v_ctx_nb
+						& std_logic_vector(resize(r.ctx.limb, log2z(n - 1)));
+					v.write.fpwdata := ctx_dob;
+					if r.ctx.limb = v_ctx_wm1 then
+						v.ctx.limb := (others => '0');
+						v.ctx.cnt := (others => '1');
+						v.ctx.state := drain;
+					else
+						-- read of next limb, in parallel to the write of this one
+						v.ctx.limb := r.ctx.limb + 1;
+						v.ctx.re := '1';
+						v.ctx.raddr := std_logic_vector(r.ctx.cur)
+							& std_logic_vector(r.ctx.idx)
+							& std_logic_vector(resize(r.ctx.limb + 1, log2z(n - 1)));
+						v.ctx.state := rdw;
+					end if;
+				when drain =>
+					-- let the last limb reach the Montgomery multipliers before
+					-- deasserting 'pen'/'ppen'
+					v.ctx.cnt := r.ctx.cnt - 1;
+					if r.ctx.cnt = "00" then
+						v.ctrl.pen := '0';
+						v.ctx.ppen := '0';
+						v.ctx.idx := r.ctx.idx + 1;
+						v.ctx.cnt := (others => '1');
+						v.ctx.state := gap;
+						if r.ctx.idx = "110" then
+							v.ctx.ppen := '1'; -- next one is p'
+						elsif r.ctx.idx = "111" then
+							-- end of replay: the IP is in the very same state as after
+							-- software uploaded p, a, b & q
+							v.ctx.state := idle;
+							v.ctrl.p_set := '1';
+							v.ctrl.p_set_and_mty := '1';
+							v.ctrl.a_set := '1';
+							v.ctrl.a_set_and_mty := '1';
+							v.ctrl.b_set := '1';
+							v.ctrl.q_set := '1';
+							v.ctx.seen := (others => '1');
+						end if;
+					end if;
+			end case;
+			-- Montgomery multipliers reset their p' counter upon software reset
+			if r.ctrl.swrst = '1' then
+				v.ctx.ppcnt := (others => '0');
+			end if;
+		end if; -- nbctx > 0
+
+		-- (s309) staging RAM of a, b & q (see (s307) & (s308))
+		if mtyovl then -- statically resolved by synthesizer
+			v.ovl.we := '0';
+			v.ovl.re := '0';
+			if nn_dynamic then -- statically resolved by synthesizer
+				v_ovl_wm1 := nndyn_wm1_s;
+			else
+				v_ovl_wm1 := to_unsigned(w - 1, log2(w - 1));
+			end if;
+			-- limbs of the large number being written by software (the same
+			-- ones that ecc_fp ignores as long as it computes the constants)
+			if r.ovl.stg = '1' and r.write.fpwe = '1' then
+				v.ovl.we := '1';
+				v.ovl.waddr := std_logic_vector(r.ovl.idx)
+					& r.fpaddr(log2z(n - 1) - 1 downto 0);
+				v.ovl.wdata := r.write.fpwdata;
+			end if;
+			-- replay into ecc_fp_dram, one large number after the other, once
+			-- the constants are computed & the current write (if any) is over
+			case r.ovl.state is
+				when idle =>
+					if r.ovl.pend = '1' and r.ovl.stg = '0'
+						and r.ctrl.state = idle and r.write.fpwe = '0'
+					then
+						v.ovl.limb := (others => '0');
+						v.ovl.state := rd;
+						if r.ovl.staged(0) = '1' then
+							v.ovl.idx := "00";
+						elsif r.ovl.staged(1) = '1' then
+							v.ovl.idx := "01";
+						elsif r.ovl.staged(2) = '1' then
+							v.ovl.idx := "10";
+						else
+							-- all replayed: same end as (s104)-(s106) would have been
+							v.ovl.state := idle;
+							v.ovl.pend := '0';
+							v.ctrl.mtypending := '0';
+							if r.ctrl.a_set = '1' then
+								v.ctrl.agomtya := '1'; -- will be reset by (s105)
+								v.ctrl.mtyirq_postponed := '1';
+								v.ctrl.mtypending := '1'; -- see (s108)
+							else
+								v.ctrl.irqsh(3) := '1';
+								if r.ctrl.irqen = '1' and r.cmdq.en = '0' then
+									v.ctrl.irq := '1';
+								end if;
+							end if;
+						end if;
+					end if;
+				when rd =>
+					v.ovl.re := '1';
+					v.ovl.raddr := std_logic_vector(r.ovl.idx)
+						& std_logic_vector(resize(r.ovl.limb, log2z(n - 1)));
+					v.ovl.state := rdw;
+				when rdw =>
+					v.ovl.state := wr;
+				when wr =>
+					-- same write path as the one used by software (see (s303))
+					if r.ovl.idx = "00" then
+						v_ovl_nb := CST_ADDR_A;
+					elsif r.ovl.idx = "01" then
+						v_ovl_nb := CST_ADDR_B;
+					else
+						v_ovl_nb := CST_ADDR_Q;
+					end if;
+					v.write.fpwe := '1';
+					v.fpaddr := v_ovl_nb
+						& std_logic_vector(resize(r.ovl.limb, log2z(n - 1)));
+					v.write.fpwdata := ovl_dob;
+					if r.ovl.limb = v_ovl_wm1 then
+						v.ovl.staged(to_integer(r.ovl.idx)) := '0';
+						if r.ovl.idx = "00" then
+							v.ctrl.a_set := '1';
+						elsif r.ovl.idx = "01" then
+							v.ctrl.b_set := '1';
+						else
+							v.ctrl.q_set := '1';
+						end if;
+						v.ovl.state := idle;
+					else
+						v.ovl.limb := r.ovl.limb + 1;
+						v.ovl.re := '1';
+						v.ovl.raddr := std_logic_vector(r.ovl.idx)
+							& std_logic_vector(resize(r.ovl.limb + 1, log2z(n - 1)));
+						v.ovl.state := rdw;
+					end if;
+			end case;
+			-- software reset drops staged large numbers (software will have to
+			-- write them again)
+			if r.ctrl.swrst = '1' then
+				v.ovl.state := idle;
+				v.ovl.stg := '0';
+				v.ovl.staged := (others => '0');
+				v.ovl.pend := '0';
+				if r.ovl.pend = '1' then
+					v.ctrl.mtypending := '0';
+				end if;
+			end if;
+		end if; -- mtyovl
+
 		--                      --------------------
 		--                          state-machine
 		--                      for read accesses to
@@ -4733,6 +6043,48 @@ begin
 		-- synchronous (active low) reset
 		if s_axi_aresetn = '0' then
 			v.ctrl.state := idle;
+			v.cmdq.en := '0';
+			v.cmdq.state := idle;
+			v.cmdq.opkind := CMDQ_KIND_WRITE;
+			v.cmdq.we := '0';
+			v.cmdq.re := '0';
+			v.cmdq.wptr := (others => '0');
+			v.cmdq.rptr := (others => '0');
+			v.cmdq.count := (others => '0');
+			v.cmdq.lock := '0';
+			v.cmdq.reswe := '0';
+			v.cmdq.resre := '0';
+			v.cmdq.resdv := '0';
+			v.cmdq.reswptr := (others => '0');
+			v.cmdq.resrptr := (others => '0');
+			v.cmdq.rescount := (others => '0');
+			v.cmdq.irqthr := (others => '0');
+			v.cmdq.donecnt := (others => '0');
+			v.cmdq.idlecnt := (others => '0');
+			v.axis.state := idle;
+			v.axis.wr := '0';
+			v.axis.rd := '0';
+			v.axis.lock := '0';
+			v.axis.tready := '0';
+			v.ctx.state := idle;
+			v.ctx.bound := '0';
+			v.ctx.cur := (others => '0');
+			v.ctx.valid := (others => '0');
+			v.ctx.seen := (others => '0');
+			v.ctx.we := '0';
+			v.ctx.re := '0';
+			v.ctx.ppcnt := (others => '0');
+			v.ctx.ppen := '0';
+			v.ctrl.redmode := FASTRED_NONE;
+			v.ctrl.hmty := '0';
+			v.ctrl.hseen := (others => '0');
+			v.ctrl.hppen := '0';
+			v.ovl.state := idle;
+			v.ovl.stg := '0';
+			v.ovl.staged := (others => '0');
+			v.ovl.pend := '0';
+			v.ovl.we := '0';
+			v.ovl.re := '0';
 			v.axi.awpending := '0';
 			v.axi.dwpending := '0';
 			v.axi.awready := '1';
@@ -4872,6 +6224,7 @@ begin
 			end if;
 			v.write.rnd.irnempty := '1';
 			v.write.rnd.trngrdy := '1';
+			v.write.rnd.expend := '0';
 			v.write.rnd.kmaskfull := '0';
 			v.write.rnd.doshift := '0';
 			v.write.rnd.avail4mask := '0';
@@ -5052,6 +6405,7 @@ begin
 	-- to ecc_scalar
 	agokp <= r.ctrl.agokp;
 	agocstmty <= r.ctrl.agocstmty;
+	redmode <= r.ctrl.redmode;
 	agomtya <= r.ctrl.agomtya;
 	doblinding <= r.ctrl.doblinding;
 	blindbits <= std_logic_vector(r.ctrl.blindbits);
@@ -5087,20 +6441,115 @@ begin
 	xre <= r.read.fpre;
 
 	-- to external AXI interface
-	s_axi_awready <= r.axi.awready;
-	s_axi_wready <= r.axi.wready;
+	-- (s295) while the command queue is replaying an access, or while a
+	-- stream beat is being injected, the AXI handshake signals are hidden
+	-- from software (see (s287) & (s298))
+	s_axi_awready <= r.axi.awready and not (r.cmdq.lock or r.axis.lock);
+	s_axi_wready <= r.axi.wready and not (r.cmdq.lock or r.axis.lock);
 	s_axi_bresp <= CST_AXI_RESP_OKAY;
 	s_axi_bvalid <= r.axi.bvalid;
-	s_axi_arready <= r.axi.arready;
+	s_axi_arready <= r.axi.arready and not (r.cmdq.lock or r.axis.lock);
 	s_axi_rdata <= r.axi.rdatax;
 	s_axi_rresp <= CST_AXI_RESP_OKAY;
-	s_axi_rvalid <= r.axi.rvalid;
+	s_axi_rvalid <= r.axi.rvalid and not (r.cmdq.lock or r.axis.lock);
+
+	-- to AXI-Stream ports (see (s298))
+	s_axis_tready <= r.axis.tready;
+	m_axis_tdata <= r.axi.rdatax;
+	m_axis_tvalid <= r.axi.rvalid when r.axis.state = rbeat else '0';
+	m_axis_tlast <= r.read.lastwordx;
 
 	-- interrupt
 	irq <= r.ctrl.irq;
 
+	-- command queue & its result FIFO (see (s287))
+	cq0: if cmdqsize > 0 generate -- statically resolved by synthesizer
+		r_cmdq_wptr <= std_logic_vector(r.cmdq.wptr);
+		r_cmdq_rptr <= std_logic_vector(r.cmdq.rptr);
+		r_cmdqres_wptr <= std_logic_vector(r.cmdq.reswptr);
+		r_cmdqres_rptr <= std_logic_vector(r.cmdq.resrptr);
+		cq00: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => CMDQW, datadepth => cmdqsize)
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => r_cmdq_wptr,
+				wea => r.cmdq.we,
+				dia => r.cmdq.wdata,
+				-- port B (R only)
+				addrb => r_cmdq_rptr,
+				reb => r.cmdq.re,
+				dob => cmdq_dob
+			);
+		cq01: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => C_S_AXI_DATA_WIDTH, datadepth => cmdqsize)
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => r_cmdqres_wptr,
+				wea => r.cmdq.reswe,
+				dia => r.cmdq.reswdata,
+				-- port B (R only)
+				addrb => r_cmdqres_rptr,
+				reb => r.cmdq.resre,
+				dob => cmdqres_dob
+			);
+	end generate;
+
+	cq1: if cmdqsize = 0 generate -- statically resolved by synthesizer
+		cmdq_dob <= (others => '0');
+		cmdqres_dob <= (others => '0');
+	end generate;
+
+	-- context RAM of curve slots (see (s303))
+	cx0: if nbctx > 0 generate -- statically resolved by synthesizer
+		cx00: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => ww, datadepth => 2**CTXAW)
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => r.ctx.waddr,
+				wea => r.ctx.we,
+				dia => r.ctx.wdata,
+				-- port B (R only)
+				addrb => r.ctx.raddr,
+				reb => r.ctx.re,
+				dob => ctx_dob
+			);
+	end generate;
+
+	cx1: if nbctx = 0 generate -- statically resolved by synthesizer
+		ctx_dob <= (others => '0');
+	end generate;
+
+	-- staging RAM of a, b & q (see (s307))
+	ov0: if mtyovl generate -- statically resolved by synthesizer
+		ov00: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => ww, datadepth => 2**OVLAW)
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => r.ovl.waddr,
+				wea => r.ovl.we,
+				dia => r.ovl.wdata,
+				-- port B (R only)
+				addrb => r.ovl.raddr,
+				reb => r.ovl.re,
+				dob => ovl_dob
+			);
+	end generate;
+
+	ov1: if not mtyovl generate -- statically resolved by synthesizer
+		ovl_dob <= (others => '0');
+	end generate;
+
 	-- to mm_ndsp's
 	pen <= r.ctrl.pen; -- (s9)
+	ppen <= r.ctx.ppen or r.ctrl.hppen; -- see (s303) & (s310)
 
 	n0: if nn_dynamic generate -- statically resolved by synthesizer
 		nndyn_mask <= r.nndyn.mask; -- (s279)
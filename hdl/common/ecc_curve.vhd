@@ -198,6 +198,7 @@ architecture rtl of ecc_curve is
 		xxor : std_logic;
 		rnd : std_logic;
 		redc : std_logic;
+		sqr : std_logic;
 		tpar : std_logic;
 		tparsh : std_logic;
 		div2 : std_logic;
@@ -757,6 +758,7 @@ begin
 				v.decode.a.ssrl := '0'; v.decode.a.ssrl_sh := '0';
 				v.decode.a.ssll := '0'; v.decode.a.xxor := '0';
 				v.decode.a.redc := '0'; v.decode.a.div2 := '0';
+				v.decode.a.sqr := '0';
 				v.decode.a.tpar := '0'; v.decode.a.tparsh := '0';
 				v.decode.a.rnd := '0'; v.decode.a.rndm := '0';
 				v.decode.a.rndsh := '0'; v.decode.a.rndshf := '0';
@@ -805,7 +807,7 @@ begin
 					v.decode.a.ssrl := '0'; v.decode.a.ssll := '0';
 					v.decode.a.xxor := '0'; v.decode.a.rnd := '0';
 					v.decode.a.redc := '0'; v.decode.a.tpar := '0';
-					v.decode.a.div2 := '0';
+					v.decode.a.div2 := '0'; v.decode.a.sqr := '0';
 
 					if r.decode.c.opcode = OPCODE_ARITH_ADD then
 						v.decode.a.add := '1';
@@ -824,6 +826,9 @@ begin
 						v.decode.a.rnd := '1';
 					elsif r.decode.c.opcode = OPCODE_ARITH_RED then
 						v.decode.a.redc := '1';
+					elsif r.decode.c.opcode = OPCODE_ARITH_SQR then
+						v.decode.a.redc := '1';
+						v.decode.a.sqr := '1';
 					elsif r.decode.c.opcode = OPCODE_ARITH_TST then
 						v.decode.a.tpar := '1';
 					elsif r.decode.c.opcode = OPCODE_ARITH_TSH then
@@ -3609,6 +3614,7 @@ begin
 	opi.rnd <= r.decode.a.rnd;
 	opi.xxor <= r.decode.a.xxor;
 	opi.redc <= r.decode.a.redc;
+	opi.sqr <= r.decode.a.sqr;
 	opi.extended <= r.decode.c.extended; -- (s1)
 	opi.par <= r.decode.a.tpar;
 	opi.div2 <= r.decode.a.div2;
@@ -81,6 +81,19 @@
 	NNADD,p5	red	patchme	Rmodp
 	STOP
 
+.constSOLL:
+.constSOLL_export:
+# *****************************************************************
+# Solinas (fast reduction) mode: the Montgomery multipliers then
+# compute  x.y mod p  (result < 2p) instead of  x.y.R^-1 mod p, which
+# is as if R = 1. Conversions into & out of Montgomery representation
+# hence become multiplications by 1 and no p' is needed
+# *****************************************************************
+	NNADD	p	p	twop
+	NNMOV	one		R2modp
+	NNMOV	one		Rmodp
+	STOP
+
 .aMontyL:
 .aMontyL_export:
 # *****************************************************************
@@ -342,6 +342,26 @@ def fpredc_emulate(ins, execution_context):
     execution_context.ip += 1
     return execution_context
 
+def fpsqr_emulate(ins, execution_context):
+    # Unpack values
+    addr, instruction, options, abstract_operands, l = ins
+    execution_context.executed_line = l
+    # Get the operands (FPSQR has no operand b)
+    opa = abstract_operands[0][2]
+    opc = abstract_operands[2][2]
+    # Apply the possible patches
+    execution_context, opa, _, opc = apply_patch(execution_context, opa, opa, opc, options)
+    A = execution_context.r[opa]
+    # NOTE: we add 4 bits for the Monty trick using R > 4p
+    # for the 0 < u, v, w < 2p invariant
+    MontyR = 2**(BIGNUM_BITS_SIZE + 4)
+    C = (A * A * modinv(MontyR, execution_context.p)) % execution_context.p
+    # Result
+    execution_context.r[opc] = C
+    # Increment IP
+    execution_context.ip += 1
+    return execution_context
+
 def testpar_emulate(ins, execution_context):
     # Unpack values
     addr, instruction, options, abstract_operands, l = ins
@@ -1062,6 +1082,9 @@ ipecc_instructions_dict = {
 	"NNRNDS" : ([None, ipecc_const(), ipecc_operand()], "ARITH", "1100", "RNH", nnrnds_emulate),
 	"NNRNDF" : ([None, ipecc_const(), ipecc_operand()], "ARITH", "1101", "RNF", nnrndf_emumate),
 	"NNSRLS" : ([ipecc_operand(), ipecc_const(), ipecc_operand()], "ARITH", "1110", "SRH", nnsrls_emulate),
+	# FPSQR is not meant to be written in sources: FPREDC is emitted as
+	# FPSQR by the assembler when both its input operands are the same
+	"FPSQR" : ([ipecc_operand(), None, ipecc_operand()], "ARITH", "1111", "SQR", fpsqr_emulate),
 	# branch instructions, the None is to be updated with a
     # proper label after the fitst pass
 	"J"    : ([None], "BRANCH", "0001", "B", j_emulate),
@@ -1204,7 +1227,15 @@ def resolve_labels(asm):
             ipecc_instructions_dict[k][0][0] = ipecc_label_
 
 # Encode the opcodes
+# Nb of FPREDC instructions emitted as FPSQR by encode_opcodes()
+FPSQR_EMITTED = 0
+# Set environment variable NOFPSQR (e.g 'make NOFPSQR=1') to keep all
+# FPREDC as they are, so the gain of FPSQR can be measured in simulation
+# (see target 'sqr' of sim/Makefile)
+FPSQR_DISABLED = (os.environ.get("NOFPSQR", "") not in ["", "0"])
+
 def encode_opcodes(asm):
+    global FPSQR_EMITTED
     lines = asm.splitlines()
     line_num = 1
     # The encoding
@@ -1316,6 +1347,15 @@ def encode_opcodes(asm):
                         # External operand
                         NEWOPERANDS.append(op)
                 OPERANDS = NEWOPERANDS
+            # An FPREDC of a variable by itself is emitted as FPSQR (the
+            # Montgomery multiplier is then only fed with one operand).
+            # This is not done for patched instructions, as the patch may
+            # change their operands at runtime.
+            if (instruction == "FPREDC") and (not FPSQR_DISABLED) and (ipecc_operands_dict[OPERANDS[0]] == ipecc_operands_dict[OPERANDS[1]]):
+                if not any(re.search(r"p([0-9]+)", p) for p in OPTIONS):
+                    instruction = "FPSQR"
+                    OPERANDS = [OPERANDS[0], OPERANDS[2]]
+                    FPSQR_EMITTED += 1
             if ipecc_instructions_dict[instruction][1] == "PSEUDO":
                 if instruction == "BARRIER":
                     barrier_set = True
@@ -1458,7 +1498,7 @@ def assemble_file(infile):
         print("    -> First pass for labels resolution done")
         # Second pass for encoding opcodes
         (encoding, abstract_asm) = encode_opcodes(asm)
-        print("    -> Second pass for opcode encoding done")
+        print("    -> Second pass for opcode encoding done (%d FPREDC emitted as FPSQR)" % FPSQR_EMITTED)
         # Now format our assembly output
         output = ""
         lines = encoding.splitlines()
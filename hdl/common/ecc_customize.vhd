@@ -36,8 +36,16 @@ package ecc_customize is
 	constant multwidth : positive := 32; -- 32 seems fair for an ASIC default
 	constant nbmult : positive range 1 to 2 := 2;
 	constant nbdsp : positive := 6;
+	constant nbchain : natural := 0; -- 0 = single DSP chain (mm_ndsp)
+	constant fastred : boolean := FALSE; -- Solinas mode for P-256/P-384
 	constant sramlat : positive range 1 to 2 := 2;
 	constant async : boolean := FALSE;
+	constant nbcores : positive := 2; -- only used by top-level ecc_multi
+	constant cmdqsize : natural := 0; -- 0 = no hardware command queue
+	constant axistream : boolean := FALSE; -- AXI-Stream port for large numbers
+	constant nbctx : natural := 0; -- curve context slots (0 = none)
+	constant mtyovl : boolean := FALSE; -- write a, b, q during .constMTYL
+	constant hostmty : boolean := FALSE; -- Montgomery constants set by software
 	-- -------------------------------------------------------------
 	-- Side-channel countermeasures & HW security related parameters
 	-- -------------------------------------------------------------
@@ -64,6 +72,9 @@ package ecc_customize is
 	constant trng_ramsz_efp : positive := 4; -- in kB
 	constant trng_ramsz_crv : positive := 4; -- in kB
 	constant trng_ramsz_shf : positive := 16; -- in kB
+	constant trngdrbg : boolean := FALSE; -- ChaCha20 expander of raw words
+	constant trngdrbg_reseed : positive := 1024; -- in 64-byte blocks
+	constant trngexport : boolean := FALSE; -- random words readable by software
 	-- -------------
 	-- Miscellaneous
 	-- -------------
@@ -76,6 +87,7 @@ package ecc_customize is
 	constant simvecfile : string := "/tmp/ecc_vec_in.txt";
 	constant simkb : natural range 0 to natural'high := 0; -- if 0 then ignored
 	constant simlogfile : string := "/tmp/ecc.log";
+	constant simcyclesfile : string := "/tmp/ecc_cycles.csv";
 	constant simxyshuflogfile : string := "/tmp/ecc_xyshuf.log";
 	constant simtrngfile : string := "/tmp/random.txt";
 	-- ********************************
@@ -386,6 +398,84 @@ end package ecc_customize;
 --       17 is already a suboptimal value for 'nbdsp', and that you'd probably
 --       better set 'nbdsp' = 10 instead.
 --
+-- SEE ALSO
+--       'nbchain'
+--
+-- ============================================================================
+-- NAME
+--       'nbchain'
+--
+-- DEFINITION
+--       Number of parallel MACC/DSP chains per Montgomery multiplier
+--
+-- TYPE/VALUE
+--       Integer, 0 (default) or a divisor of 'nbdsp'
+--
+-- DESCRIPTION
+--       When left to 0, Montgomery multipliers are instances of mm_ndsp
+--       (source file mm_ndsp.vhd) in which the 'nbdsp' MACC/DSP blocks form
+--       one single chain, which yields the speed plateau illustrated in the
+--       table of 'nbdsp' above.
+--       When set to a non-null value, Montgomery multipliers are instead
+--       instances of mm_ndsp_mc (source file mm_ndsp_mc.vhd) which has the
+--       exact same interface but splits the 'nbdsp' blocks into 'nbchain'
+--       shorter chains of 'nbdsp' / 'nbchain' blocks each. The chains work
+--       in parallel on independent columns of the product (product scanning)
+--       and the carries between columns are then merged by a dedicated stage.
+--       Operand terms are kept in registers instead of SRAM blocks, so that
+--       the area cost is higher in logic (though not in MACC/DSP blocks).
+--       'nbchain' = 1 is legal and means one chain of 'nbdsp' blocks working
+--       on one column at a time.
+--       Target 'mc' of sim/Makefile measures the effect of this parameter:
+--       it simulates mm_ndsp_tb (both multipliers on the same random
+--       operands, results checked) over the same grid of 'ww' & 'nbdsp'
+--       values as the table of 'nbdsp' above ('nn' = 256, 'nbchain' = 2),
+--       displaying a table of the same layout, then simulates ecc_tb with
+--       'nbchain' = 0, 2 & 3 on one [k]P for each of P-256, P-384 & P-521
+--       (results checked), displaying the latency of each [k]P.
+--
+--       Parameter 'async' must be set to FALSE when 'nbchain' is not 0.
+--
+-- SEE ALSO
+--       'fastred'
+--
+-- ============================================================================
+-- NAME
+--       'fastred'
+--
+-- DEFINITION
+--       Solinas (fast) reduction mode of Montgomery multipliers for NIST
+--       curves P-256 & P-384
+--
+-- TYPE/VALUE
+--       Boolean (default FALSE)
+--
+-- DESCRIPTION
+--       When set to TRUE (and if 'nbchain' > 0 and 'ww' divides 32) the
+--       Montgomery multipliers (mm_ndsp_mc) can replace the two last phases
+--       of the REDC operation (s * p' mod R, then (s + alpha * p) / R) with
+--       a fold of the 32-bit words of the product s = x * y, based on the
+--       special form of the NIST primes p256 & p384. The result is then
+--       x * y mod p (lower than 2p) instead of x * y / R mod p.
+--       The mode is selected by software through register W_FASTRED, which
+--       the driver does automatically when the curve it is given has one of
+--       these two primes and the IP advertises CAP_FASTRED in register
+--       R_CAPABILITIES. In this mode the computation of the Montgomery
+--       constants is replaced by setting R^2 mod p & R mod p to 1, so that
+--       the microcode is unchanged (conversions into and out of Montgomery
+--       representation simply become multiplications by 1).
+--       Target 'fastred' of sim/Makefile measures the effect of this
+--       parameter: it simulates mm_ndsp_tb ('nn' = 384, 'ww' = 16,
+--       'nbchain' = 2 and 'nbdsp' = 2 to 12), where multiplications modulo
+--       p256 & p384 are run in both modes (results checked), then ecc_tb
+--       with 'fastred' = FALSE & TRUE on one [k]P for each of P-256, P-384
+--       & P-521 (results checked, ecc_tb selects the mode like the driver
+--       does), displaying the latency of each [k]P.
+--
+--       The fold itself costs one accumulator per 'ww'-bit word of the
+--       result (24 with 'ww' = 16) fed with small multiples (-4 to 5) of
+--       the product words, and uses no MACC/DSP block.
+--
 -- ============================================================================
 -- NAME
 --       'sramlat'
@@ -477,6 +567,236 @@ end package ecc_customize;
 --
 -- ============================================================================
 -- NAME
+--       'nbcores'
+--
+-- DEFINITION
+--       Number of [k]P engines instanciated by the multi-core top-level
+--       entity 'ecc_multi' (see file ecc_multi.vhd).
+--
+-- TYPE/VALUE
+--       Integer. Default is 2.
+--
+-- DESCRIPTION
+--       This parameter is ignored if you use the standard top-level entity
+--       'ecc' (which implements only one engine).
+--
+--       With 'ecc_multi', each of the 'nbcores' engines has its own register
+--       bank, mapped at offset 0x200 x i from base address of the IP (where i
+--       is the engine index, from 0 to nbcores - 1) and its own Montgomery
+--       multipliers, microcode & data memories, so that the software driver
+--       can run up to 'nbcores' computations concurrently, possibly on
+--       different curves.
+--       On the other hand, only one TRNG (es_trng, ecc_trng_pp & ecc_trng_srv)
+--       is instanciated and each of its entropy client channels is shared
+--       between the engines in round-robin.
+--
+--       The TRNG is only reset by the AXI reset, never by the software reset
+--       of one engine.
+--
+--       In HW unsecure mode, the TRNG debug registers are only effective in
+--       the register bank of engine 0 (see header of ecc_multi.vhd).
+--
+--       'make multicmp' in sim/ simulates two concurrent [k]P on ecc_multi
+--       with 2 engines and, if Vivado is installed, synthesizes 'ecc' and
+--       'ecc_multi' to compare their resources (see syn/utilization.tcl).
+--
+-- SEE ALSO
+--       'nbtrng', 'async'
+--
+-- ============================================================================
+-- NAME
+--       'cmdqsize'
+--
+-- DEFINITION
+--       Depth (in entries) of the hardware command queue of ecc_axi.
+--
+-- TYPE/VALUE
+--       Natural. Must be 0 or a power of 2 between 2 and 32768.
+--       Default is 0 (no command queue). Its testbench sim/ecc_cmdq_tb.vhd
+--       is run with 'cmdqsize' = 256 by 'make cmdqrun' in sim/.
+--
+-- DESCRIPTION
+--       The command queue allows software driver to enqueue register accesses
+--       (writes of any write register, series of reads of R_READ_DATA, and
+--       completion markers) using registers W_CMDQ_OP & W_CMDQ_PUSH, even
+--       while the IP is busy computing. These accesses are then replayed by
+--       hardware, one after the other, as soon as the IP is ready to accept
+--       them, so that consecutive [k]P computations can be chained without
+--       any software round-trip inbetween. Words read back from R_READ_DATA
+--       and completion markers are pushed into a result FIFO of the same
+--       depth, which software driver pops through register R_CMDQ_RESULT.
+--
+--       Each entry of the command queue is (2 + 6 + C_S_AXI_DATA_WIDTH) bits
+--       wide and each entry of the result FIFO is C_S_AXI_DATA_WIDTH bits wide,
+--       both are implemented as Block-RAMs.
+--
+--       Setting 'cmdqsize' to 0 removes the command queue from the design
+--       (registers W_CMDQ_* and R_CMDQ_* are then decoded as unknown registers
+--       and bit CAP_CMDQ of R_CAPABILITIES register reads 0).
+--
+-- SEE ALSO
+--       'nbcores', 'axistream'
+--
+-- ============================================================================
+-- NAME
+--       'axistream'
+--
+-- DEFINITION
+--       To add a pair of AXI-Stream ports to the IP, through which large
+--       numbers can be written & read back.
+--
+-- TYPE/VALUE
+--       Boolean. Default is FALSE.
+--
+-- DESCRIPTION
+--       When 'axistream' is TRUE, a write (resp. a read) of a large number
+--       can be made through the AXI-Stream slave port s_axis_* (resp. master
+--       port m_axis_*) instead of register W_WRITE_DATA (resp. R_READ_DATA):
+--       software driver simply sets bit CTRL_AXIS in W_CTRL along with bit
+--       CTRL_WRITE_NB (resp. CTRL_READ_NB). All C_S_AXI_DATA_WIDTH-bit words
+--       of the large number are then transferred as successive beats on the
+--       stream port (least significant word first, TLAST being asserted with
+--       the last word on port m_axis_*) without any address phase, while
+--       configuration & status remain on the AXI-lite interface.
+--
+--       The stream ports are meant to be connected to a bridge converting
+--       AXI4 bursts (e.g. from a memcpy into a memory-mapped window) into
+--       stream beats, or to a DMA.
+--
+--       When 'axistream' is FALSE, ports s_axis_* & m_axis_* are still present
+--       on the top-level entity 'ecc' but are left unused (s_axis_tready and
+--       m_axis_tvalid being tied to 0), bit CTRL_AXIS of W_CTRL is ignored and
+--       bit CAP_AXIS of R_CAPABILITIES register reads 0.
+--       Top-level entity 'ecc_multi' does not have any AXI-Stream port.
+--
+--       'make axisrun' in sim/ runs testbench sim/ecc_axis_tb.vhd with
+--       'axistream' = TRUE, which compares the nb of cycles needed to write
+--       & read back one coordinate through registers W_WRITE_DATA &
+--       R_READ_DATA and through the stream ports.
+--
+-- SEE ALSO
+--       'cmdqsize'
+--
+-- ============================================================================
+-- NAME
+--       'nbctx'
+--
+-- DEFINITION
+--       Number of curve context slots.
+--
+-- TYPE/VALUE
+--       Natural. Must be 0 or a power of 2 between 2 and 16.
+--       Default is 0 (no context RAM).
+--
+-- DESCRIPTION
+--       A curve context is made of the 8 large numbers which depend on the
+--       curve only: p, a (in Montgomery representation), b, q, R^2 mod p,
+--       2p, R mod p & the Montgomery constant p' (the latter being held by
+--       Montgomery multipliers, not in ecc_fp_dram).
+--
+--       When 'nbctx' > 0, ecc_axi implements a context RAM of 'nbctx' slots.
+--       Software binds one slot to the current curve with register
+--       W_CURVE_SELECT, after what the slot is kept in sync by hardware (by
+--       snooping all writes into ecc_fp_dram) while software uploads p, a,
+--       b & q and while routines .constMTYL & .aMontyL are executed. Later,
+--       switching back to that curve is done with one write of W_CURVE_SELECT
+--       (with bit CURVE_SEL_LOAD set) which makes hardware copy the slot back
+--       into ecc_fp_dram & into the Montgomery multipliers, in 2 cycles per
+--       limb, instead of uploading the 4 curve parameters again & recomputing
+--       the Montgomery constants (which involves a modular inversion).
+--
+--       Each slot holds 8 x 2**ceil(log2(n)) words of 'ww' bits, and the
+--       context RAM is implemented as a Block-RAM. Each slot is tagged with
+--       the value of nn it was computed with, and can only be restored while
+--       the prime size (W_PRIME_SIZE register) has that same value.
+--
+--       Setting 'nbctx' to 0 removes the context RAM from the design (register
+--       W_CURVE_SELECT & R_CURVE_STATUS are then decoded as unknown registers
+--       and bit CAP_CTX of R_CAPABILITIES register reads 0).
+
+--       In simulation, ecc_tb binds & restores slots the way the driver does
+--       (see set_curve() in sim/ecc_tb_pkg.vhd), and 'make ctxrun' in sim/
+--       compares the nb of cycles of curve switches with & without slots.
+--
+-- SEE ALSO
+--       'cmdqsize', 'mtyovl'
+--
+-- ============================================================================
+-- NAME
+--       'mtyovl'
+--
+-- DEFINITION
+--       Allows software to write curve parameters a, b & q while the
+--       Montgomery constants associated with a new value of p are being
+--       computed.
+--
+-- TYPE/VALUE
+--       Boolean (default FALSE)
+--
+-- DESCRIPTION
+--       Writing p makes the IP execute routine .constMTYL (which involves a
+--       modular inversion) and without this parameter the BUSY bit of
+--       R_STATUS register remains set during the whole computation, so that
+--       software can only write a, b & q after it's done.
+--       When 'mtyovl' is set to TRUE, ecc_axi accepts the write of a, b & q
+--       during that time, holding them in a small staging RAM (3 x
+--       2**ceil(log2(n)) words of 'ww' bits, plus one unused slot) as
+--       ecc_fp_dram is not accessible, and copies them into ecc_fp_dram as
+--       soon as the constants are computed (2 cycles per limb). The BUSY &
+--       MTY bits of R_STATUS keep their meaning (they stay set until the
+--       constants are computed, the staged large numbers copied & parameter
+--       'a' switched into Montgomery representation) while bit MTYOVL tells
+--       when the IP, busy only because of that computation, accepts the
+--       write of a, b or q. Any other action (including the write of other
+--       large numbers) still waits for the BUSY bit to go low.
+--       The driver takes advantage of it when bit CAP_MTYOVL of register
+--       R_CAPABILITIES is set, and so does ecc_tb (see 'make ctxrun' in sim/).
+--
+-- SEE ALSO
+--       'nbctx', 'hostmty'
+--
+-- ============================================================================
+-- NAME
+--       'hostmty'
+--
+-- DEFINITION
+--       Allows software to upload the Montgomery constants associated with p
+--       instead of having the IP compute them (HW unsecure mode only).
+--
+-- TYPE/VALUE
+--       Boolean (default FALSE)
+--
+-- DESCRIPTION
+--       The constants R^2 mod p, 2p, R mod p & p' = -p^-1 mod R (where
+--       R = 2^(nn + 2)) are pure functions of p & nn. When 'hostmty' is set
+--       to TRUE, software can write them, one 'ww'-bit limb at a time, using
+--       registers W_MTYCST (selection of the constant) & W_MTYCST_DATA (one
+--       limb, lower ones first). If all four constants have been written
+--       when the write of p is over, the IP skips routine .constMTYL (which
+--       involves two modular inversions) and p is immediately usable.
+--       Otherwise, the constants are computed as usual.
+--       Writing the constants makes the current value of p obsolete, and
+--       they must be written again after any write of W_PRIME_SIZE or
+--       W_FASTRED register.
+--       Register R_MTYCST gives the value of 'ww' (software needs it to
+--       split the constants into limbs). The driver keeps the constants of
+--       the last curves it has loaded in a cache keyed by (p, nn, ww) and
+--       uses it when bit CAP_HOSTMTY of register R_CAPABILITIES is set.
+--       The constants are not checked by hardware: wrong values make every
+--       modular reduction wrong, which would give software an easy way to
+--       inject faults into the computations. Hence the feature is removed
+--       from the design in HW secure mode (whatever the value of 'hostmty',
+--       registers W_MTYCST, W_MTYCST_DATA & R_MTYCST are then decoded as
+--       unknown registers and bit CAP_HOSTMTY of R_CAPABILITIES register
+--       reads 0).
+--       'ww' must not be greater than 'axi32or64', otherwise the feature is
+--       removed from the design.
+--
+-- SEE ALSO
+--       'mtyovl', 'nbctx'
+--
+-- ============================================================================
+-- NAME
 --       'hwsecure'
 --
 -- DEFINITION
@@ -1062,6 +1382,8 @@ end package ecc_customize;
 --       design or reuse to implement the postprocessing, provided that its
 --       interfaces fit the ones we use inside the IP TRNG (which are very
 --       basic).
+--       An optional deterministic expander can nonetheless be inserted at
+--       that place (see parameter 'trngdrbg' below).
 --
 --       Past the postprocessing unit, random bits are pushed one at a time
 --       into one of the 4 possible target FIFOs, each serving as the entropy
@@ -1234,7 +1556,99 @@ end package ecc_customize;
 --           in ./ecc_trng/ecc_trng_pkg.vhd).
 --
 -- SEE ALSO
---       'nbtrng', 'notrng', 'shuffle_type'
+--       'nbtrng', 'notrng', 'shuffle_type', 'trngdrbg'
+--
+-- ============================================================================
+-- NAME
+--       'trngdrbg', 'trngdrbg_reseed'
+--
+-- DEFINITION
+--       Insert a deterministic random bit expander (ChaCha20 keystream
+--       generator seeded by the ES-TRNG) between the raw random FIFO and the
+--       4 FIFOs of internal random numbers.
+--
+-- TYPE/VALUE
+--       'trngdrbg' is a boolean.
+--       'trngdrbg_reseed' is a positive integer, expressed in number of 64-
+--       byte blocks.
+--
+-- DESCRIPTION
+--       With the default 'nbtrng' & 'trngta' values the raw entropy source
+--       delivers far less than one bit per clock cycle, and the 4 FIFOs of
+--       internal random numbers can run dry when [k]P computations follow
+--       each other closely (the IP then stalls until they are refilled).
+--
+--       When 'trngdrbg' is set to TRUE, the 32-bit words built by
+--       ecc_trng_pp from raw random bits are no longer served as is: each
+--       group of 8 of them (256 raw bits) is XORed into the key of a ChaCha20
+--       block function (20 rounds), the keystream of which is served instead.
+--       The block function is computed by a single quarter-round datapath (4
+--       adders of 32 bits) in 161 cycles per block, so that the expander
+--       delivers 512 bits every 178 cycles (i.e ~2.9 bits/cycle) whatever
+--       the throughput of the entropy source, which only limits the rate at
+--       which the key is refreshed.
+--
+--       No more than 'trngdrbg_reseed' blocks are generated from the same
+--       key: past that limit the expander stalls until 256 fresh raw bits
+--       are available. Lowering 'trngdrbg_reseed' therefore trades output
+--       bandwidth for the amount of entropy per output bit, down to the
+--       value 2 for which the output rate can't exceed twice the raw one.
+--
+--       The expander requires 'pp_irn_width' (see ecc_trng/ecc_trng_pkg.vhd)
+--       to be equal to 32, otherwise it is ignored.
+--
+--       Target 'drbg' of sim/Makefile first runs ecc_trng_pp_tb, a known-
+--       answer test of the block function (RFC 8439 test vectors), then
+--       simulates ecc_tb in HW unsecure mode with 'trngdrbg' = FALSE & TRUE
+--       on one [k]P for each of P-256, P-384 & P-521, displaying the latency
+--       of each [k]P and the total nb of cycles the TRNG clients were
+--       starving.
+--
+--       Mind that a DRBG does not add any entropy: it only stretches it.
+--       Whether that is acceptable for the masking & shuffling counter-
+--       measures of the IP is a decision left to the integrator.
+--
+-- SEE ALSO
+--       'nbtrng', 'trngta', 'trng_ramsz_[raw|axi|efp|crv|shf]'
+--
+-- ============================================================================
+-- NAME
+--       'trngexport'
+--
+-- DEFINITION
+--       Allows software to read internal random numbers produced by the IP
+--       TRNG, e.g to seed a software DRBG (HW unsecure mode only).
+--
+-- TYPE/VALUE
+--       Boolean (default FALSE)
+--
+-- DESCRIPTION
+--       When 'trngexport' is set to TRUE, each read of register R_TRNG_DATA
+--       pops one 'ww'-bit word from the FIFO of internal random numbers
+--       which serves ecc_axi (the one sized by 'trng_ramsz_axi', otherwise
+--       used to mask the scalar on-the-fly as it is written by software).
+--       Register R_TRNG_STATUS gives the nb of words currently available,
+--       so that software can read that many words in a row without the
+--       read ever being stalled (a read of R_TRNG_DATA while the FIFO is
+--       empty is only acknowledged once a new word has been produced).
+--       Words are never served twice nor partially: a word of which some
+--       bits were already used to mask the scalar is discarded.
+--
+--       This is a trade-off: the FIFO is shared with a countermeasure. Any
+--       software able to read R_TRNG_DATA can drain it, which starves the
+--       masking of the scalar (its write then waits for the FIFO to be
+--       refilled, see bit STATUS_ERR_I_NOT_ENOUGH_RANDOM_WK) and makes the
+--       timing of the write depend on software activity, and the words it
+--       drops waste entropy. Hence the feature is removed from the design in
+--       HW secure mode (whatever the value of 'trngexport', registers
+--       R_TRNG_STATUS & R_TRNG_DATA are then decoded as unknown registers and
+--       bit CAP_TRNGEXP of R_CAPABILITIES register reads 0), and should only
+--       be enabled when no untrusted software can access the IP.
+--       'ww' must not be greater than 'axi32or64', otherwise the feature is
+--       removed from the design.
+--
+-- SEE ALSO
+--       'trng_ramsz_[raw|axi|efp|crv|shf]', 'trngdrbg'
 --
 -- ============================================================================
 -- NAME
@@ -1480,6 +1894,27 @@ end package ecc_customize;
 --
 -- ============================================================================
 -- NAME
+--       'simcyclesfile'
+--
+-- DEFINITION
+--       Only used in simulation. File path for the cycle accounting of tests
+--       by the testbench (sim/ecc_tb.vhd).
+--
+-- TYPE/VALUE
+--       Character string indicating a file path which should be accessible
+--       in write mode.
+--       Default is "/tmp/ecc_cycles.csv".
+--
+-- DESCRIPTION
+--       CSV file where the testbench writes one line per test: its label,
+--       the operation, nn, the nb of blinding bits, then the nb of AXI clock
+--       cycles spent in each phase of the test (setup, selection of operands,
+--       writes of operands, command, computation, selection of the result,
+--       reads of the result, and their total) and whether it passed. See the
+--       description of phases in process 'steam' of sim/ecc_tb.vhd.
+--
+-- ============================================================================
+-- NAME
 --       'simtrngfile'
 --
 -- DEFINITION
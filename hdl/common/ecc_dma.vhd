@@ -0,0 +1,1132 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.ecc_vars.all; -- for LARGE_NB_[K|XR0|YR0|XR1|YR1]_ADDR
+use work.ecc_software.all;
+
+-- DMA top-level: one standard 'ecc' IP plus a DMA engine which, acting as an
+-- AXI4 master on external memory (e.g DDR), fetches job descriptors from a
+-- ring, executes them on 'ecc' and writes results & status back to memory,
+-- without any intervention of the CPU.
+--
+-- Address map (AXI-lite slave interface):
+--
+--   0x000 - 0x1f8 : register bank of 'ecc' (see ecc_software.vhd)
+--   0x200 - 0x3f8 : register bank of the DMA engine (DMA_* constants in
+--                   ecc_software.vhd)
+--
+-- Software first configures 'ecc' as usual (nn, curve, blinding, etc), then
+-- sets the base address & the size (2**DMA_W_RING_LOG descriptors) of the
+-- ring and enables the engine (DMA_W_CTRL). Software produces descriptors
+-- by writing them in the ring & by then advancing the producer index
+-- (DMA_W_TAIL). The engine consumes them in order (consumer index can be read
+-- in DMA_R_HEAD) and stops when the ring is empty (HEAD = TAIL), one slot
+-- hence always being left unused by software when the ring is full.
+--
+-- Each descriptor is made of DMA_DESC_WORDS words (of C_S_AXI_DATA_WIDTH bits)
+-- holding the point operation (field OP = position of its command bit in
+-- W_CTRL), the R0/R1 null flags, the curve (0 to keep the current curve,
+-- otherwise the job first switches to curve context slot CURVE - 1 through
+-- W_CURVE_SELECT, see parameter 'nbctx' in ecc_customize.vhd), the byte
+-- addresses of the scalar (K), of the first point (P0, x then y) and of the
+-- second point (P1, x then y), the byte address of the result area (RES)
+-- and a tag. Large numbers are made of nbw = ceil(nn / C_S_AXI_DATA_WIDTH)
+-- words in memory, least significant word first (the same word order as
+-- with W_WRITE_DATA & R_READ_DATA). Upon completion of a job, the result
+-- area receives:
+--
+--   RES + 0      : x-coordinate of the result (nbw words, if any)
+--   RES + nbw    : y-coordinate of the result (nbw words, if any)
+--   RES + 2.nbw  : token which x & y are masked with ([k]P only, nbw words)
+--   RES + 3.nbw  : snapshot of R_STATUS right after the operation (YES flag,
+--                  R0/R1 null flags & errors, which are then acknowledged)
+--   RES + 3.nbw+1: tag of the descriptor
+--
+-- and bit DMA_DESC_DONE is set in the first word of the descriptor.
+--
+-- Interrupt coalescing: the DMA interrupt is raised once the nb of completed
+-- jobs since the last write to DMA_W_IRQ_ACK reaches the threshold set in
+-- DMA_W_CTRL (0 is understood as 1), when the ring gets empty, or upon an
+-- error response from memory (the engine is then disabled after the current
+-- job). Output 'irq' is the OR of the interrupts of 'ecc' & of the DMA engine.
+--
+-- While the engine is active (bit DMA_ST_ACTIVE in DMA_R_STATUS) it owns the
+-- register bank of 'ecc', and accesses from software to it receive a SLVERR
+-- response. Software regains access once the ring is empty or the engine has
+-- been disabled and has completed its current job.
+--
+-- Memory transactions are single-beat ones: the DMA engine writes each word
+-- to 'ecc' as software does through W_WRITE_DATA (i.e bit-serially), hence
+-- memory bandwidth is never the bottleneck here.
+entity ecc_dma is
+	generic(
+		-- width of AXI data buses (both slave & master)
+		constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+		-- width of AXI-lite slave address bus
+		constant C_S_AXI_ADDR_WIDTH : integer := AXIAW + 1;
+		-- width of AXI4 master address bus
+		constant C_M_AXI_ADDR_WIDTH : integer := 32
+	);
+	port(
+		-- AXI clock
+		s_axi_aclk : in std_logic;
+		-- AXI reset (expected active low, async asserted, sync deasserted)
+		s_axi_aresetn : in std_logic;
+		-- AXI write-address channel
+		s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+		s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+		s_axi_awvalid : in std_logic;
+		s_axi_awready : out std_logic;
+		-- AXI write-data channel
+		s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+		s_axi_wvalid : in std_logic;
+		s_axi_wready : out std_logic;
+		-- AXI write-response channel
+		s_axi_bresp : out std_logic_vector(1 downto 0);
+		s_axi_bvalid : out std_logic;
+		s_axi_bready : in std_logic;
+		-- AXI read-address channel
+		s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+		s_axi_arvalid : in std_logic;
+		s_axi_arready : out std_logic;
+		-- AXI read-data channel
+		s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_rresp : out std_logic_vector(1 downto 0);
+		s_axi_rvalid : out std_logic;
+		s_axi_rready : in std_logic;
+		-- AXI4 master write-address channel (to external memory)
+		m_axi_awaddr : out std_logic_vector(C_M_AXI_ADDR_WIDTH - 1 downto 0);
+		m_axi_awlen : out std_logic_vector(7 downto 0);
+		m_axi_awsize : out std_logic_vector(2 downto 0);
+		m_axi_awburst : out std_logic_vector(1 downto 0);
+		m_axi_awcache : out std_logic_vector(3 downto 0);
+		m_axi_awprot : out std_logic_vector(2 downto 0);
+		m_axi_awvalid : out std_logic;
+		m_axi_awready : in std_logic;
+		-- AXI4 master write-data channel
+		m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+		m_axi_wlast : out std_logic;
+		m_axi_wvalid : out std_logic;
+		m_axi_wready : in std_logic;
+		-- AXI4 master write-response channel
+		m_axi_bresp : in std_logic_vector(1 downto 0);
+		m_axi_bvalid : in std_logic;
+		m_axi_bready : out std_logic;
+		-- AXI4 master read-address channel
+		m_axi_araddr : out std_logic_vector(C_M_AXI_ADDR_WIDTH - 1 downto 0);
+		m_axi_arlen : out std_logic_vector(7 downto 0);
+		m_axi_arsize : out std_logic_vector(2 downto 0);
+		m_axi_arburst : out std_logic_vector(1 downto 0);
+		m_axi_arcache : out std_logic_vector(3 downto 0);
+		m_axi_arprot : out std_logic_vector(2 downto 0);
+		m_axi_arvalid : out std_logic;
+		m_axi_arready : in std_logic;
+		-- AXI4 master read-data channel
+		m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		m_axi_rresp : in std_logic_vector(1 downto 0);
+		m_axi_rlast : in std_logic;
+		m_axi_rvalid : in std_logic;
+		m_axi_rready : out std_logic;
+		-- clock for Montgomery multipliers in the async case
+		clkmm : in std_logic;
+		-- interrupt (OR of 'ecc' & DMA engine interrupts)
+		irq : out std_logic;
+		-- busy signal for [k]P computation
+		busy : out std_logic;
+		-- HW unsecure/Side-Channel analysis features
+		--   off-chip trigger
+		dbgtrigger : out std_logic;
+		dbghalted : out std_logic;
+		--   pseudo-trng port
+		dbgptdata : in std_logic_vector(7 downto 0);
+		dbgptvalid : in std_logic;
+		dbgptrdy : out std_logic;
+		-- clk & clkmm division & out feature
+		clkdivo : out std_logic;
+		clkmmdivo : out std_logic
+	);
+end entity ecc_dma;
+
+architecture rtl of ecc_dma is
+
+	-- following attributes are Xilinx specific but they should not do any harm
+	-- on other platforms
+	attribute X_INTERFACE_INFO : string;
+	attribute X_INTERFACE_PARAMETER : string;
+	attribute X_INTERFACE_INFO of irq : signal is
+		"xilinx.com:signal:interrupt:1.0 irq INTERRUPT";
+	attribute X_INTERFACE_PARAMETER of irq : signal is "SENSITIVITY EDGE_RISING";
+
+	component ecc is
+		generic(
+			-- width of AXI data bus
+			C_S_AXI_DATA_WIDTH : integer := axi32or64;
+			-- width of AXI address bus
+			C_S_AXI_ADDR_WIDTH : integer := AXIAW
+		);
+		port(
+			-- AXI clock & reset
+			s_axi_aclk : in  std_logic;
+			s_axi_aresetn : in std_logic;
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			--  AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation
+			busy : out std_logic;
+			-- HW unsecure/SCA analysis feature (off-chip trigger)
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic;
+			-- clk & clkmm division & out feature
+			clkdivo : out std_logic;
+			clkmmdivo : out std_logic
+		);
+	end component ecc;
+
+	-- nb of bytes in one AXI data word
+	constant DB : positive := C_S_AXI_DATA_WIDTH / 8;
+	-- max nb of AXI words of a large number (and of a descriptor)
+	constant NBWMAX : positive := max(div(nn, C_S_AXI_DATA_WIDTH), DMA_DESC_WORDS);
+
+	subtype dma_word is std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+	subtype dma_addr is unsigned(C_M_AXI_ADDR_WIDTH - 1 downto 0);
+	type desc_array_type is array(0 to DMA_DESC_TAG) of dma_word;
+
+	-- phases of the processing of one job descriptor, in order
+	-- (see (s301) & function phase_used() below)
+	type job_phase_type is (
+		jidle,    -- waiting for a descriptor
+		jfetch,   -- read of the descriptor
+		jcurve,   -- write of W_CURVE_SELECT (only if field CURVE is not 0)
+		jnn,      -- read of R_PRIME_SIZE (gives nbw)
+		jtokgen,  -- token generation ([k]P only)
+		jtokrd,   -- token read into RES + 2.nbw ([k]P only)
+		jk,       -- scalar write ([k]P only)
+		jp0x,     -- first point, x-coordinate (into R1 for [k]P, R0 otherwise)
+		jp0y,     -- first point, y-coordinate (into R1 for [k]P, R0 otherwise)
+		jp1x,     -- second point, x-coordinate (into R1)
+		jp1y,     -- second point, y-coordinate (into R1)
+		jr0null,  -- write of W_R0_NULL
+		jr1null,  -- write of W_R1_NULL
+		jexec,    -- write of the command in W_CTRL
+		jwait,    -- wait for the end of the command (snapshot of R_STATUS)
+		jrx,      -- read of R1 x-coordinate into RES
+		jry,      -- read of R1 y-coordinate into RES + nbw
+		jerrack,  -- acknowledgement of errors (only if any)
+		jstatus,  -- write of the R_STATUS snapshot into RES + 3.nbw
+		jtag,     -- write of the tag into RES + 3.nbw + 1
+		jdone     -- write-back of the descriptor with DMA_DESC_DONE set
+	);
+
+	-- steps within one phase
+	type job_step_type is (
+		spoll,    -- poll R_STATUS until not busy, then go to step 'nxt'
+		sctrl,    -- register write (W_CTRL, W_TOKEN, W_R[01]_NULL, W_ERR_ACK)
+		smemrd,   -- read of one word from memory
+		seccwr,   -- write of one word into W_WRITE_DATA
+		seccrd,   -- read of one word from R_READ_DATA (or R_PRIME_SIZE)
+		smemwr,   -- write of one word to memory
+		sfin      -- end of phase
+	);
+
+	-- one single-beat AXI transaction initiated by the DMA engine (either
+	-- toward 'ecc' or toward external memory)
+	type mst_reg_type is record
+		awvalid : std_logic;
+		wvalid : std_logic;
+		arvalid : std_logic;
+		rready : std_logic;
+		-- transaction in flight
+		busy : std_logic;
+		-- completion of transaction (1-cycle pulse)
+		done : std_logic;
+		-- error response (SLVERR or DECERR)
+		err : std_logic;
+		addr : dma_addr;
+		wdata : dma_word;
+		rdata : dma_word;
+	end record;
+
+	-- selection of the register bank (ecc or DMA) targeted by AXI
+	-- transactions from software
+	type bank_reg_type is record
+		-- write transaction
+		wbusy : std_logic;
+		wdma : std_logic;
+		werr : std_logic;
+		wreg : rat;
+		awdone : std_logic;
+		wdone : std_logic;
+		bvalid : std_logic;
+		-- read transaction
+		rbusy : std_logic;
+		rdma : std_logic;
+		rerr : std_logic;
+		ardone : std_logic;
+		rvalid : std_logic;
+		rdata : dma_word;
+	end record;
+
+	-- DMA engine registers & job sequencer
+	type dma_reg_type is record
+		en : std_logic;
+		irqthr : unsigned(DMA_CTRL_IRQ_MSB - DMA_CTRL_IRQ_LSB downto 0);
+		base : dma_addr;
+		lg : unsigned(DMA_RING_LOG_MSB - DMA_RING_LOG_LSB downto 0);
+		head : unsigned(15 downto 0);
+		tail : unsigned(15 downto 0);
+		-- engine owns the register bank of 'ecc'
+		own : std_logic;
+		irq : std_logic;
+		buserr : std_logic;
+		donecnt : unsigned(DMA_ST_DONE_MSB - DMA_ST_DONE_LSB downto 0);
+		-- job sequencer
+		phase : job_phase_type;
+		step : job_step_type;
+		nxt : job_step_type;
+		widx : natural range 0 to NBWMAX - 1;
+		nbw : natural range 0 to NBWMAX;
+		desc : desc_array_type;
+		status : dma_word;
+		data : dma_word;
+	end record;
+
+	type reg_type is record
+		bank : bank_reg_type;
+		dma : dma_reg_type;
+		e : mst_reg_type;
+		m : mst_reg_type;
+	end record;
+
+	signal r, rin : reg_type;
+
+	-- AXI signals between the bank selection / DMA engine & 'ecc'
+	signal ecc_awaddr : std_logic_vector(AXIAW - 1 downto 0);
+	signal ecc_awvalid, ecc_awready : std_logic;
+	signal ecc_wdata : dma_word;
+	signal ecc_wvalid, ecc_wready : std_logic;
+	signal ecc_bresp : std_logic_vector(1 downto 0);
+	signal ecc_bvalid, ecc_bready : std_logic;
+	signal ecc_araddr : std_logic_vector(AXIAW - 1 downto 0);
+	signal ecc_arvalid, ecc_arready : std_logic;
+	signal ecc_rdata : dma_word;
+	signal ecc_rresp : std_logic_vector(1 downto 0);
+	signal ecc_rvalid, ecc_rready : std_logic;
+	signal ecc_irq : std_logic;
+
+	signal s_axi_aresetn_rsh : std_logic_vector(2 downto 0);
+	alias s_axi_aresetn_resync : std_logic is s_axi_aresetn_rsh(0);
+
+	-- is phase 'ph' part of the processing of a job with command 'op'
+	-- ('crv' telling if the job selects a curve context slot & 'errs' telling
+	-- if the command raised errors)
+	function phase_used(
+		ph : job_phase_type; op : natural; crv, errs : boolean) return boolean is
+	begin
+		case ph is
+			when jcurve =>
+				return crv;
+			when jtokgen | jtokrd | jk =>
+				return op = CTRL_KP;
+			when jp1x | jp1y =>
+				return op = CTRL_PT_ADD or op = CTRL_PT_EQU or op = CTRL_PT_OPP;
+			when jexec =>
+				return op <= CTRL_PT_OPP;
+			when jrx | jry =>
+				return op = CTRL_KP or op = CTRL_PT_ADD or op = CTRL_PT_DBL
+				    or op = CTRL_PT_NEG;
+			when jerrack =>
+				return errs;
+			when others =>
+				return TRUE;
+		end case;
+	end function phase_used;
+
+	-- first step of phase 'ph'
+	function first_step(ph : job_phase_type) return job_step_type is
+	begin
+		case ph is
+			when jfetch => return smemrd;
+			when jnn => return seccrd;
+			when jstatus | jtag | jdone => return smemwr;
+			when others => return spoll;
+		end case;
+	end function first_step;
+
+	-- W_CTRL value selecting the write or the read of large number 'addr'
+	function ctrl_nb(
+		wr : boolean; k : boolean; token : boolean; addr : natural)
+		return dma_word is
+		variable dw : dma_word;
+	begin
+		dw := (others => '0');
+		if wr then
+			dw(CTRL_WRITE_NB) := '1';
+		else
+			dw(CTRL_READ_NB) := '1';
+		end if;
+		if k then
+			dw(CTRL_WRITE_K) := '1';
+		end if;
+		if token then
+			dw(CTRL_RD_TOKEN) := '1';
+		end if;
+		dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+			:= std_logic_vector(to_unsigned(addr, FP_ADDR_MSB));
+		return dw;
+	end function ctrl_nb;
+
+begin
+
+	assert (C_M_AXI_ADDR_WIDTH <= C_S_AXI_DATA_WIDTH)
+		report "ecc_dma: generic C_M_AXI_ADDR_WIDTH must not be greater than "
+		     & "C_S_AXI_DATA_WIDTH (pointers in descriptors are one AXI word)."
+			severity FAILURE;
+
+	assert (C_M_AXI_ADDR_WIDTH >= AXIAW)
+		report "ecc_dma: generic C_M_AXI_ADDR_WIDTH must be at least AXIAW."
+			severity FAILURE;
+
+	assert (C_S_AXI_ADDR_WIDTH > AXIAW)
+		report "ecc_dma: generic C_S_AXI_ADDR_WIDTH is too small to address "
+		     & "the register bank of the DMA engine (must be at least AXIAW + 1)."
+			severity FAILURE;
+
+	-- force resynchronization of input reset s_axi_aresetn in the
+	-- s_axi_aclk clock domain
+	process(s_axi_aclk, s_axi_aresetn)
+	begin
+		if (s_axi_aresetn = '0') then
+			s_axi_aresetn_rsh <= (others => '0');
+		elsif s_axi_aclk'event and s_axi_aclk = '1' then
+			s_axi_aresetn_rsh(s_axi_aresetn_rsh'length - 1 downto 0) <=
+				'1' & s_axi_aresetn_rsh(s_axi_aresetn_rsh'length - 1 downto 1);
+		end if;
+	end process;
+
+	comb: process(r, s_axi_aresetn_resync, s_axi_awaddr, s_axi_awvalid,
+	              s_axi_wdata, s_axi_wvalid, s_axi_bready, s_axi_araddr,
+	              s_axi_arvalid, s_axi_rready,
+	              ecc_awready, ecc_wready, ecc_bvalid, ecc_arready, ecc_rdata,
+	              ecc_rvalid,
+	              m_axi_awready, m_axi_wready, m_axi_bresp, m_axi_bvalid,
+	              m_axi_arready, m_axi_rdata, m_axi_rresp, m_axi_rvalid)
+		variable v : reg_type;
+		variable v_op : natural range 0 to 2**(DMA_DESC_OP_MSB - DMA_DESC_OP_LSB + 1) - 1;
+		variable v_crv : boolean;
+		variable v_slot : unsigned(DMA_DESC_CURVE_MSB - DMA_DESC_CURVE_LSB downto 0);
+		variable v_errs : boolean;
+		variable v_next : boolean;
+		variable v_mask : unsigned(15 downto 0);
+		variable v_thr : unsigned(DMA_CTRL_IRQ_MSB - DMA_CTRL_IRQ_LSB downto 0);
+		variable v_ptr : dma_addr;
+		variable v_off : natural range 0 to 3*NBWMAX + 1;
+		variable v_maddr : dma_addr;
+		variable v_mdata : dma_word;
+		variable v_ereg : rat;
+		variable v_edata : dma_word;
+		variable v_nbaddr : natural;
+		variable v_valnn : unsigned(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		variable dw : dma_word;
+	begin
+		v := r;
+
+		v_mask := resize(
+			shift_left(to_unsigned(1, 17), to_integer(r.dma.lg)) - 1, 16);
+
+		-- ------------------------------------------------------------
+		-- (s300) single-beat AXI transactions initiated by the DMA engine
+		-- (handshakes & completion), toward 'ecc' (r.e) and toward
+		-- external memory (r.m)
+		-- ------------------------------------------------------------
+		v.e.done := '0';
+		if r.e.busy = '1' then
+			if r.e.awvalid = '1' and ecc_awready = '1' then
+				v.e.awvalid := '0';
+			end if;
+			if r.e.wvalid = '1' and ecc_wready = '1' then
+				v.e.wvalid := '0';
+			end if;
+			if r.e.arvalid = '1' and ecc_arready = '1' then
+				v.e.arvalid := '0';
+			end if;
+			-- write response (ecc_bready is held high while the engine owns 'ecc')
+			if ecc_bvalid = '1' then
+				v.e.busy := '0';
+				v.e.done := '1';
+			end if;
+			-- read response
+			if r.e.rready = '1' and ecc_rvalid = '1' then
+				v.e.rready := '0';
+				v.e.rdata := ecc_rdata;
+				v.e.busy := '0';
+				v.e.done := '1';
+			end if;
+		end if;
+
+		v.m.done := '0';
+		if r.m.busy = '1' then
+			if r.m.awvalid = '1' and m_axi_awready = '1' then
+				v.m.awvalid := '0';
+			end if;
+			if r.m.wvalid = '1' and m_axi_wready = '1' then
+				v.m.wvalid := '0';
+			end if;
+			if r.m.arvalid = '1' and m_axi_arready = '1' then
+				v.m.arvalid := '0';
+			end if;
+			if m_axi_bvalid = '1' then
+				v.m.busy := '0';
+				v.m.done := '1';
+				v.m.err := m_axi_bresp(1);
+			end if;
+			if r.m.rready = '1' and m_axi_rvalid = '1' then
+				v.m.rready := '0';
+				v.m.rdata := m_axi_rdata;
+				v.m.busy := '0';
+				v.m.done := '1';
+				v.m.err := m_axi_rresp(1);
+			end if;
+		end if;
+
+		-- error response from memory: the current job is completed anyway
+		-- (so as to leave 'ecc' in a consistent state) but the engine is
+		-- then disabled
+		if r.m.done = '1' and r.m.err = '1' then
+			v.dma.buserr := '1';
+			v.dma.irq := '1';
+			v.dma.en := '0';
+		end if;
+
+		-- ------------------------------------------------------------
+		-- write of DMA engine registers by software (see (s302) for the
+		-- transaction itself)
+		-- ------------------------------------------------------------
+		if r.bank.wbusy = '1' and r.bank.wdma = '1' and r.bank.werr = '0'
+			and r.bank.wdone = '0' and s_axi_wvalid = '1'
+		then
+			if r.bank.wreg = DMA_W_CTRL then
+				v.dma.en := s_axi_wdata(DMA_CTRL_EN);
+				v.dma.irqthr := unsigned(
+					s_axi_wdata(DMA_CTRL_IRQ_MSB downto DMA_CTRL_IRQ_LSB));
+			elsif r.bank.wreg = DMA_W_RING_BASE then
+				v.dma.base := unsigned(s_axi_wdata(C_M_AXI_ADDR_WIDTH - 1 downto 0));
+			elsif r.bank.wreg = DMA_W_RING_LOG then
+				v.dma.lg := unsigned(
+					s_axi_wdata(DMA_RING_LOG_MSB downto DMA_RING_LOG_LSB));
+			elsif r.bank.wreg = DMA_W_TAIL then
+				v.dma.tail := unsigned(s_axi_wdata(15 downto 0)) and v_mask;
+			elsif r.bank.wreg = DMA_W_IRQ_ACK then
+				v.dma.irq := '0';
+				v.dma.buserr := '0';
+				v.dma.donecnt := (others => '0');
+			end if;
+		end if;
+
+		-- ------------------------------------------------------------
+		--                  J o b   s e q u e n c e r
+		-- ------------------------------------------------------------
+		-- (s301)
+		-- Each job descriptor is processed as a series of phases (see type
+		-- job_phase_type) reproducing the exact sequence of register accesses
+		-- that the software driver performs for the same point operation
+		-- (including the polling of R_STATUS before each write). Phases which
+		-- are not relevant for the command of the descriptor are skipped.
+		v_op := to_integer(unsigned(
+			r.dma.desc(DMA_DESC_CTRL)(DMA_DESC_OP_MSB downto DMA_DESC_OP_LSB)));
+		-- a non-null CURVE field selects curve context slot CURVE - 1
+		v_slot := unsigned(
+			r.dma.desc(DMA_DESC_CTRL)(DMA_DESC_CURVE_MSB downto DMA_DESC_CURVE_LSB));
+		v_crv := v_slot /= 0;
+		v_slot := v_slot - 1;
+		v_errs := r.dma.status(STATUS_ERR_MSB downto STATUS_ERR_LSB)
+			/= (STATUS_ERR_MSB downto STATUS_ERR_LSB => '0');
+		v_next := FALSE;
+
+		-- memory address & data of the current step (if relevant)
+		v_ptr := (others => '0');
+		v_off := 0;
+		v_mdata := r.dma.data;
+		case r.dma.phase is
+			when jfetch | jdone =>
+				v_ptr := r.dma.base + shift_left(resize(r.dma.head,
+					C_M_AXI_ADDR_WIDTH), log2((DMA_DESC_WORDS * DB) - 1));
+			when jk =>
+				v_ptr := unsigned(
+					r.dma.desc(DMA_DESC_K)(C_M_AXI_ADDR_WIDTH - 1 downto 0));
+			when jp0x | jp0y =>
+				v_ptr := unsigned(
+					r.dma.desc(DMA_DESC_P0)(C_M_AXI_ADDR_WIDTH - 1 downto 0));
+			when jp1x | jp1y =>
+				v_ptr := unsigned(
+					r.dma.desc(DMA_DESC_P1)(C_M_AXI_ADDR_WIDTH - 1 downto 0));
+			when others =>
+				v_ptr := unsigned(
+					r.dma.desc(DMA_DESC_RES)(C_M_AXI_ADDR_WIDTH - 1 downto 0));
+		end case;
+		case r.dma.phase is
+			when jp0y | jp1y | jry => v_off := r.dma.nbw;
+			when jtokrd => v_off := 2 * r.dma.nbw;
+			when jstatus =>
+				v_off := 3 * r.dma.nbw;
+				v_mdata := r.dma.status;
+			when jtag =>
+				v_off := (3 * r.dma.nbw) + 1;
+				v_mdata := r.dma.desc(DMA_DESC_TAG);
+			when jdone =>
+				v_mdata := r.dma.desc(DMA_DESC_CTRL);
+				v_mdata(DMA_DESC_DONE) := '1';
+			when others => v_off := 0;
+		end case;
+		v_maddr := v_ptr + to_unsigned((v_off + r.dma.widx) * DB, C_M_AXI_ADDR_WIDTH);
+
+		-- register of 'ecc' & value written in step sctrl
+		v_ereg := W_CTRL;
+		v_edata := (others => '0');
+		if v_op = CTRL_KP then
+			v_nbaddr := LARGE_NB_XR1_ADDR;
+		else
+			v_nbaddr := LARGE_NB_XR0_ADDR;
+		end if;
+		case r.dma.phase is
+			when jcurve =>
+				v_ereg := W_CURVE_SELECT;
+				v_edata(CURVE_SEL_SLOT_MSB downto CURVE_SEL_SLOT_LSB) :=
+					std_logic_vector(v_slot(CURVE_SEL_SLOT_MSB - CURVE_SEL_SLOT_LSB
+						downto 0));
+				v_edata(CURVE_SEL_LOAD) := '1';
+			when jtokgen =>
+				v_ereg := W_TOKEN;
+				v_edata(0) := '1'; -- value actually does not matter
+			when jtokrd =>
+				v_edata := ctrl_nb(FALSE, FALSE, TRUE, 0);
+			when jk =>
+				v_edata := ctrl_nb(TRUE, TRUE, FALSE, LARGE_NB_K_ADDR);
+			when jp0x =>
+				v_edata := ctrl_nb(TRUE, FALSE, FALSE, v_nbaddr);
+			when jp0y =>
+				if v_op = CTRL_KP then
+					v_edata := ctrl_nb(TRUE, FALSE, FALSE, LARGE_NB_YR1_ADDR);
+				else
+					v_edata := ctrl_nb(TRUE, FALSE, FALSE, LARGE_NB_YR0_ADDR);
+				end if;
+			when jp1x =>
+				v_edata := ctrl_nb(TRUE, FALSE, FALSE, LARGE_NB_XR1_ADDR);
+			when jp1y =>
+				v_edata := ctrl_nb(TRUE, FALSE, FALSE, LARGE_NB_YR1_ADDR);
+			when jr0null =>
+				v_ereg := W_R0_NULL;
+				v_edata(WR0_IS_NULL) := r.dma.desc(DMA_DESC_CTRL)(DMA_DESC_R0_NULL);
+			when jr1null =>
+				v_ereg := W_R1_NULL;
+				v_edata(WR1_IS_NULL) := r.dma.desc(DMA_DESC_CTRL)(DMA_DESC_R1_NULL);
+			when jexec =>
+				v_edata(v_op) := '1';
+			when jrx =>
+				v_edata := ctrl_nb(FALSE, FALSE, FALSE, LARGE_NB_XR1_ADDR);
+			when jry =>
+				v_edata := ctrl_nb(FALSE, FALSE, FALSE, LARGE_NB_YR1_ADDR);
+			when jerrack =>
+				v_ereg := W_ERR_ACK;
+				v_edata(STATUS_ERR_MSB downto STATUS_ERR_LSB) :=
+					r.dma.status(STATUS_ERR_MSB downto STATUS_ERR_LSB);
+			when others =>
+				null;
+		end case;
+
+		if r.dma.phase = jidle then
+			-- wait for a descriptor, but do not take the register bank of 'ecc'
+			-- away from software in the middle of one of its transactions
+			if r.dma.en = '1' and r.dma.head /= r.dma.tail
+				and not (r.bank.wbusy = '1' and r.bank.wdma = '0' and r.bank.werr = '0')
+				and not (r.bank.rbusy = '1' and r.bank.rdma = '0' and r.bank.rerr = '0')
+			then
+				v.dma.own := '1';
+				v.dma.phase := jfetch;
+				v.dma.step := first_step(jfetch);
+				v.dma.widx := 0;
+			else
+				v.dma.own := '0';
+			end if;
+		elsif not phase_used(r.dma.phase, v_op, v_crv, v_errs) then
+			v_next := TRUE;
+		else
+			case r.dma.step is
+
+				when spoll =>
+					if r.e.done = '1' then
+						if r.e.rdata(STATUS_BUSY) = '0' and (r.dma.phase /= jk
+							or r.e.rdata(STATUS_ENOUGH_RND_WK) = '1')
+						then
+							if r.dma.phase = jwait then
+								v.dma.status := r.e.rdata;
+							end if;
+							v.dma.step := r.dma.nxt;
+						end if; -- otherwise poll again
+					elsif r.e.busy = '0' then
+						v.e.addr := resize(unsigned(R_STATUS & "000"), C_M_AXI_ADDR_WIDTH);
+						v.e.arvalid := '1';
+						v.e.rready := '1';
+						v.e.busy := '1';
+					end if;
+
+				when sctrl =>
+					if r.e.done = '1' then
+						case r.dma.phase is
+							when jtokrd | jrx | jry =>
+								v.dma.step := spoll;
+								v.dma.nxt := seccrd;
+							when jk | jp0x | jp0y | jp1x | jp1y =>
+								v.dma.step := smemrd;
+							when others =>
+								v.dma.step := sfin;
+						end case;
+					elsif r.e.busy = '0' then
+						v.e.addr := resize(unsigned(v_ereg & "000"), C_M_AXI_ADDR_WIDTH);
+						v.e.wdata := v_edata;
+						v.e.awvalid := '1';
+						v.e.wvalid := '1';
+						v.e.busy := '1';
+					end if;
+
+				when smemrd =>
+					if r.m.done = '1' then
+						if r.dma.phase = jfetch then
+							v.dma.desc(r.dma.widx) := r.m.rdata;
+							if r.dma.widx = DMA_DESC_TAG then
+								v.dma.step := sfin;
+							else
+								v.dma.widx := r.dma.widx + 1;
+							end if;
+						else
+							v.dma.data := r.m.rdata;
+							v.dma.step := spoll;
+							v.dma.nxt := seccwr;
+						end if;
+					elsif r.m.busy = '0' then
+						v.m.addr := v_maddr;
+						v.m.arvalid := '1';
+						v.m.rready := '1';
+						v.m.busy := '1';
+					end if;
+
+				when seccwr =>
+					if r.e.done = '1' then
+						if r.dma.widx = r.dma.nbw - 1 then
+							v.dma.step := sfin;
+						else
+							v.dma.widx := r.dma.widx + 1;
+							v.dma.step := smemrd;
+						end if;
+					elsif r.e.busy = '0' then
+						v.e.addr := resize(unsigned(W_WRITE_DATA & "000"),
+							C_M_AXI_ADDR_WIDTH);
+						v.e.wdata := r.dma.data;
+						v.e.awvalid := '1';
+						v.e.wvalid := '1';
+						v.e.busy := '1';
+					end if;
+
+				when seccrd =>
+					if r.e.done = '1' then
+						if r.dma.phase = jnn then
+							-- nbw = ceil(nn / C_S_AXI_DATA_WIDTH)
+							v_valnn := unsigned(r.e.rdata) + (C_S_AXI_DATA_WIDTH - 1);
+							v.dma.nbw := to_integer(resize(shift_right(v_valnn,
+								log2(C_S_AXI_DATA_WIDTH - 1)), log2(NBWMAX)));
+							v.dma.step := sfin;
+						else
+							v.dma.data := r.e.rdata;
+							v.dma.step := smemwr;
+						end if;
+					elsif r.e.busy = '0' then
+						if r.dma.phase = jnn then
+							v.e.addr := resize(unsigned(R_PRIME_SIZE & "000"),
+								C_M_AXI_ADDR_WIDTH);
+						else
+							v.e.addr := resize(unsigned(R_READ_DATA & "000"),
+								C_M_AXI_ADDR_WIDTH);
+						end if;
+						v.e.arvalid := '1';
+						v.e.rready := '1';
+						v.e.busy := '1';
+					end if;
+
+				when smemwr =>
+					if r.m.done = '1' then
+						if r.dma.phase = jdone then
+							-- end of job
+							v.dma.head := (r.dma.head + 1) and v_mask;
+							v.dma.donecnt := v.dma.donecnt + 1;
+							v_thr := r.dma.irqthr;
+							if v_thr = 0 then
+								v_thr := to_unsigned(1, v_thr'length);
+							end if;
+							if v.dma.donecnt >= v_thr or v.dma.head = v.dma.tail then
+								v.dma.irq := '1';
+							end if;
+							v.dma.phase := jidle;
+						elsif (r.dma.phase = jtokrd or r.dma.phase = jrx
+							or r.dma.phase = jry) and r.dma.widx /= r.dma.nbw - 1
+						then
+							v.dma.widx := r.dma.widx + 1;
+							v.dma.step := spoll;
+							v.dma.nxt := seccrd;
+						else
+							v.dma.step := sfin;
+						end if;
+					elsif r.m.busy = '0' then
+						v.m.addr := v_maddr;
+						v.m.wdata := v_mdata;
+						v.m.awvalid := '1';
+						v.m.wvalid := '1';
+						v.m.busy := '1';
+					end if;
+
+				when sfin =>
+					v_next := TRUE;
+
+			end case;
+		end if;
+
+		-- switch to next phase
+		if v_next then
+			v.dma.phase := job_phase_type'succ(r.dma.phase);
+			v.dma.step := first_step(v.dma.phase);
+			if v.dma.phase = jwait then
+				v.dma.nxt := sfin;
+			else
+				v.dma.nxt := sctrl;
+			end if;
+			v.dma.widx := 0;
+		end if;
+
+		-- ------------------------------------------------------------
+		-- (s302) selection of the register bank targeted by AXI transactions
+		-- from software (same as in ecc_multi.vhd): only one write and one
+		-- read transaction can be in flight at the same time, the bank being
+		-- latched upon arrival of the address. Transactions targeting 'ecc'
+		-- while the DMA engine owns it are answered with SLVERR.
+		-- ------------------------------------------------------------
+		-- write transactions
+		if r.bank.wbusy = '0' then
+			if s_axi_awvalid = '1' then
+				v.bank.wbusy := '1';
+				v.bank.awdone := '0';
+				v.bank.wdone := '0';
+				v.bank.wdma := s_axi_awaddr(AXIAW);
+				v.bank.wreg := s_axi_awaddr(AXIAW - 1 downto 3);
+				v.bank.werr := '0';
+				if to_integer(unsigned(
+					s_axi_awaddr(C_S_AXI_ADDR_WIDTH - 1 downto AXIAW))) > 1
+					or (s_axi_awaddr(AXIAW) = '0' and v.dma.own = '1')
+				then
+					v.bank.werr := '1';
+				end if;
+			end if;
+		else -- r.bank.wbusy = 1
+			if r.bank.wdma = '0' and r.bank.werr = '0' then
+				if ecc_awready = '1' and s_axi_awvalid = '1' and r.bank.awdone = '0' then
+					v.bank.awdone := '1';
+				end if;
+				if ecc_wready = '1' and s_axi_wvalid = '1' and r.bank.wdone = '0' then
+					v.bank.wdone := '1';
+				end if;
+				if ecc_bvalid = '1' and s_axi_bready = '1' then
+					v.bank.wbusy := '0';
+				end if;
+			else -- DMA bank or error: transaction handled locally
+				if s_axi_awvalid = '1' and r.bank.awdone = '0' then
+					v.bank.awdone := '1';
+				end if;
+				if s_axi_wvalid = '1' and r.bank.wdone = '0' then
+					v.bank.wdone := '1';
+				end if;
+				if r.bank.awdone = '1' and r.bank.wdone = '1' and r.bank.bvalid = '0' then
+					v.bank.bvalid := '1';
+				end if;
+				if r.bank.bvalid = '1' and s_axi_bready = '1' then
+					v.bank.bvalid := '0';
+					v.bank.wbusy := '0';
+				end if;
+			end if;
+		end if;
+
+		-- read transactions
+		if r.bank.rbusy = '0' then
+			if s_axi_arvalid = '1' then
+				v.bank.rbusy := '1';
+				v.bank.ardone := '0';
+				v.bank.rdma := s_axi_araddr(AXIAW);
+				v.bank.rerr := '0';
+				if to_integer(unsigned(
+					s_axi_araddr(C_S_AXI_ADDR_WIDTH - 1 downto AXIAW))) > 1
+					or (s_axi_araddr(AXIAW) = '0' and v.dma.own = '1')
+				then
+					v.bank.rerr := '1';
+				end if;
+			end if;
+		else -- r.bank.rbusy = 1
+			if r.bank.rdma = '0' and r.bank.rerr = '0' then
+				if ecc_arready = '1' and s_axi_arvalid = '1' and r.bank.ardone = '0' then
+					v.bank.ardone := '1';
+				end if;
+				if ecc_rvalid = '1' and s_axi_rready = '1' then
+					v.bank.rbusy := '0';
+				end if;
+			else -- DMA bank or error: transaction handled locally
+				if s_axi_arvalid = '1' and r.bank.ardone = '0' then
+					v.bank.ardone := '1';
+					v.bank.rvalid := '1';
+					dw := (others => '0');
+					if r.bank.rerr = '1' then
+						null;
+					elsif s_axi_araddr(AXIAW - 1 downto 3) = DMA_R_CTRL then
+						dw(DMA_CTRL_EN) := r.dma.en;
+						dw(DMA_CTRL_IRQ_MSB downto DMA_CTRL_IRQ_LSB) :=
+							std_logic_vector(r.dma.irqthr);
+					elsif s_axi_araddr(AXIAW - 1 downto 3) = DMA_R_RING_BASE then
+						dw(C_M_AXI_ADDR_WIDTH - 1 downto 0) := std_logic_vector(r.dma.base);
+					elsif s_axi_araddr(AXIAW - 1 downto 3) = DMA_R_RING_LOG then
+						dw(DMA_RING_LOG_MSB downto DMA_RING_LOG_LSB) :=
+							std_logic_vector(r.dma.lg);
+					elsif s_axi_araddr(AXIAW - 1 downto 3) = DMA_R_TAIL then
+						dw(15 downto 0) := std_logic_vector(r.dma.tail);
+					elsif s_axi_araddr(AXIAW - 1 downto 3) = DMA_R_STATUS then
+						dw(DMA_ST_ACTIVE) := r.dma.own;
+						dw(DMA_ST_IRQ) := r.dma.irq;
+						dw(DMA_ST_BUSERR) := r.dma.buserr;
+						dw(DMA_ST_DONE_MSB downto DMA_ST_DONE_LSB) :=
+							std_logic_vector(r.dma.donecnt);
+					elsif s_axi_araddr(AXIAW - 1 downto 3) = DMA_R_HEAD then
+						dw(15 downto 0) := std_logic_vector(r.dma.head);
+					end if;
+					v.bank.rdata := dw;
+				end if;
+				if r.bank.rvalid = '1' and s_axi_rready = '1' then
+					v.bank.rvalid := '0';
+					v.bank.rbusy := '0';
+				end if;
+			end if;
+		end if;
+
+		-- synchronous reset
+		if s_axi_aresetn_resync = '0' then
+			v.bank.wbusy := '0';
+			v.bank.bvalid := '0';
+			v.bank.rbusy := '0';
+			v.bank.rvalid := '0';
+			v.dma.en := '0';
+			v.dma.irqthr := (others => '0');
+			v.dma.base := (others => '0');
+			v.dma.lg := (others => '0');
+			v.dma.head := (others => '0');
+			v.dma.tail := (others => '0');
+			v.dma.own := '0';
+			v.dma.irq := '0';
+			v.dma.buserr := '0';
+			v.dma.donecnt := (others => '0');
+			v.dma.phase := jidle;
+			v.dma.status := (others => '0');
+			v.e.awvalid := '0';
+			v.e.wvalid := '0';
+			v.e.arvalid := '0';
+			v.e.rready := '0';
+			v.e.busy := '0';
+			v.e.done := '0';
+			v.m.awvalid := '0';
+			v.m.wvalid := '0';
+			v.m.arvalid := '0';
+			v.m.rready := '0';
+			v.m.busy := '0';
+			v.m.done := '0';
+			v.m.err := '0';
+		end if;
+
+		rin <= v;
+	end process comb;
+
+	regs: process(s_axi_aclk)
+	begin
+		if s_axi_aclk'event and s_axi_aclk = '1' then
+			r <= rin;
+		end if;
+	end process regs;
+
+	-- -------------------------------------------------------------
+	-- AXI-lite interface of 'ecc': driven either by software (through
+	-- the bank selection) or by the DMA engine when it owns it
+	-- -------------------------------------------------------------
+	ecc_awaddr <= std_logic_vector(r.e.addr(AXIAW - 1 downto 0))
+	              when r.dma.own = '1' else s_axi_awaddr(AXIAW - 1 downto 0);
+	ecc_awvalid <= r.e.awvalid when r.dma.own = '1' else
+	               s_axi_awvalid when r.bank.wbusy = '1' and r.bank.wdma = '0'
+	               and r.bank.werr = '0' and r.bank.awdone = '0' else '0';
+	ecc_wdata <= r.e.wdata when r.dma.own = '1' else s_axi_wdata;
+	ecc_wvalid <= r.e.wvalid when r.dma.own = '1' else
+	              s_axi_wvalid when r.bank.wbusy = '1' and r.bank.wdma = '0'
+	              and r.bank.werr = '0' and r.bank.wdone = '0' else '0';
+	ecc_bready <= '1' when r.dma.own = '1' else
+	              s_axi_bready when r.bank.wbusy = '1' and r.bank.wdma = '0'
+	              and r.bank.werr = '0' else '0';
+	ecc_araddr <= std_logic_vector(r.e.addr(AXIAW - 1 downto 0))
+	              when r.dma.own = '1' else s_axi_araddr(AXIAW - 1 downto 0);
+	ecc_arvalid <= r.e.arvalid when r.dma.own = '1' else
+	               s_axi_arvalid when r.bank.rbusy = '1' and r.bank.rdma = '0'
+	               and r.bank.rerr = '0' and r.bank.ardone = '0' else '0';
+	ecc_rready <= r.e.rready when r.dma.own = '1' else
+	              s_axi_rready when r.bank.rbusy = '1' and r.bank.rdma = '0'
+	              and r.bank.rerr = '0' else '0';
+
+	-- AXI-lite slave interface (software)
+	s_axi_awready <= '0' when r.bank.wbusy = '0' or r.bank.awdone = '1' else
+	                 '1' when r.bank.wdma = '1' or r.bank.werr = '1' else
+	                 ecc_awready;
+	s_axi_wready <= '0' when r.bank.wbusy = '0' or r.bank.wdone = '1' else
+	                '1' when r.bank.wdma = '1' or r.bank.werr = '1' else
+	                ecc_wready;
+	s_axi_bvalid <= '0' when r.bank.wbusy = '0' else
+	                r.bank.bvalid when r.bank.wdma = '1' or r.bank.werr = '1' else
+	                ecc_bvalid;
+	s_axi_bresp <= "10" when r.bank.werr = '1' else -- SLVERR
+	               "00" when r.bank.wdma = '1' else ecc_bresp;
+	s_axi_arready <= '0' when r.bank.rbusy = '0' or r.bank.ardone = '1' else
+	                 '1' when r.bank.rdma = '1' or r.bank.rerr = '1' else
+	                 ecc_arready;
+	s_axi_rvalid <= '0' when r.bank.rbusy = '0' else
+	                r.bank.rvalid when r.bank.rdma = '1' or r.bank.rerr = '1' else
+	                ecc_rvalid;
+	s_axi_rresp <= "10" when r.bank.rerr = '1' else -- SLVERR
+	               "00" when r.bank.rdma = '1' else ecc_rresp;
+	s_axi_rdata <= r.bank.rdata when r.bank.rdma = '1' or r.bank.rerr = '1'
+	               else ecc_rdata;
+
+	-- AXI4 master interface (single-beat INCR bursts)
+	m_axi_awaddr <= std_logic_vector(r.m.addr);
+	m_axi_awlen <= (others => '0');
+	m_axi_awsize <= std_logic_vector(to_unsigned(log2(DB - 1), 3));
+	m_axi_awburst <= "01"; -- INCR
+	m_axi_awcache <= "0011"; -- normal non-cacheable bufferable
+	m_axi_awprot <= "000";
+	m_axi_awvalid <= r.m.awvalid;
+	m_axi_wdata <= r.m.wdata;
+	m_axi_wstrb <= (others => '1');
+	m_axi_wlast <= '1';
+	m_axi_wvalid <= r.m.wvalid;
+	m_axi_bready <= r.m.busy;
+	m_axi_araddr <= std_logic_vector(r.m.addr);
+	m_axi_arlen <= (others => '0');
+	m_axi_arsize <= std_logic_vector(to_unsigned(log2(DB - 1), 3));
+	m_axi_arburst <= "01"; -- INCR
+	m_axi_arcache <= "0011"; -- normal non-cacheable bufferable
+	m_axi_arprot <= "000";
+	m_axi_arvalid <= r.m.arvalid;
+	m_axi_rready <= r.m.rready;
+
+	irq <= ecc_irq or r.dma.irq;
+
+	-- -------------------
+	-- ECC IP (one engine)
+	-- -------------------
+	e0: ecc
+		generic map(
+			C_S_AXI_DATA_WIDTH => C_S_AXI_DATA_WIDTH,
+			C_S_AXI_ADDR_WIDTH => AXIAW)
+		port map(
+			-- AXI clock & reset
+			s_axi_aclk => s_axi_aclk,
+			s_axi_aresetn => s_axi_aresetn_resync,
+			-- AXI write-address channel
+			s_axi_awaddr => ecc_awaddr,
+			s_axi_awprot => s_axi_awprot,
+			s_axi_awvalid => ecc_awvalid,
+			s_axi_awready => ecc_awready,
+			-- AXI write-data channel
+			s_axi_wdata => ecc_wdata,
+			s_axi_wstrb => s_axi_wstrb,
+			s_axi_wvalid => ecc_wvalid,
+			s_axi_wready => ecc_wready,
+			-- AXI write-response channel
+			s_axi_bresp => ecc_bresp,
+			s_axi_bvalid => ecc_bvalid,
+			s_axi_bready => ecc_bready,
+			-- AXI read-address channel
+			s_axi_araddr => ecc_araddr,
+			s_axi_arprot => s_axi_arprot,
+			s_axi_arvalid => ecc_arvalid,
+			s_axi_arready => ecc_arready,
+			--  AXI read-data channel
+			s_axi_rdata => ecc_rdata,
+			s_axi_rresp => ecc_rresp,
+			s_axi_rvalid => ecc_rvalid,
+			s_axi_rready => ecc_rready,
+			-- clock for Montgomery multipliers in the async case
+			clkmm => clkmm,
+			-- interrupt
+			irq => ecc_irq,
+			-- busy signal for [k]P computation
+			busy => busy,
+			-- HW unsecure/SCA analysis feature (off-chip trigger)
+			dbgtrigger => dbgtrigger,
+			dbghalted => dbghalted,
+			-- pseudo-trng port
+			dbgptdata => dbgptdata,
+			dbgptvalid => dbgptvalid,
+			dbgptrdy => dbgptrdy,
+			-- clk & clkmm division & out feature
+			clkdivo => clkdivo,
+			clkmmdivo => clkmmdivo
+		);
+
+end architecture rtl;
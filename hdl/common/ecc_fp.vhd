@@ -145,6 +145,8 @@ architecture rtl of ecc_fp is
 		rd : std_logic;
 		rdcnt : unsigned(log2(w - 1) - 1 downto 0);
 		opaorb : std_logic;
+		-- squaring (FPSQR): only operand A is read & pushed, see (s158)
+		sqr : std_logic;
 		-- for 'gosh' some bits will be trimmed by synthesizer depending on shuffle
 		gosh : std_logic_vector(readlat + 1 downto 0);
 		opic : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
@@ -897,6 +899,7 @@ begin
 			-- of the operation submitted by ecc_curve
 			if opi.redc = '1' then
 				v.mm.push.opaorb := '1';
+				v.mm.push.sqr := opi.sqr;
 				-- latch address of opcodes A, B & C
 				v.opa := opi.a & std_logic_vector(to_unsigned(0, log2z(n - 1)));
 				v.opb := opi.b & std_logic_vector(to_unsigned(0, log2z(n - 1)));
@@ -1037,6 +1040,9 @@ begin
 				-- (i.e with no other operation being accepted coming from ecc_curve
 				-- before themselves are completely carried out)
 				v.mm.push.opc(r.mm.push.id0) := r.mm.push.opic; -- (s91)
+				-- tell the multiplier whether to take Y operand from its X terms
+				-- (this stays stable until the multiplier is selected again)
+				v.mm.mmi(r.mm.push.id0).sqr := r.mm.push.sqr;
 				v.mm.push.shstart(readlat + 1) := '1'; -- (s95) bypass of (s94)
 				v.mm.push.rdcnt := nndyn_wm1;
 				v.mm.push.rd := '1';
@@ -1087,7 +1093,13 @@ begin
 					std_logic_vector(unsigned(r.opb(log2(n - 1) - 1 downto 0)) + 1);
 			end if;
 			if r.mm.push.rdcnt = (r.mm.push.rdcnt'range => '0') then
-				if r.mm.push.opaorb = '1' then
+				if r.mm.push.opaorb = '1' and r.mm.push.sqr = '1' then
+					-- (s158) squaring: there is no 2nd operand read burst, the
+					-- Montgomery multiplier reuses the x_i terms in place of
+					-- the y_i ones, which saves w cycles of operand transfer
+					v.mm.push.rd := '0';
+					v.mm.push.gosh(readlat + 1) := '1';
+				elsif r.mm.push.opaorb = '1' then
 					-- switch .opaorb so that to record that we're now starting the
 					-- second operand read burst
 					v.mm.push.opaorb := '0';
@@ -1137,6 +1149,7 @@ begin
 		-- give selected multiplier a go so that Montgomery multiplication
 		-- is actually started
 		if r.mm.push.gosh(0) = '1' then
+			v.mm.mmi(r.mm.push.id1).xen := '0'; -- only useful in the FPSQR case
 			v.mm.mmi(r.mm.push.id1).yen := '0';
 			v.mm.mmi(r.mm.push.id1).go := '1'; -- 1 cycle thx to (s6) in !async case
 		end if;
@@ -2396,6 +2409,7 @@ begin
 			for i in 0 to nbmult - 1 loop
 				v.mm.mmi(i).xen := '0';
 				v.mm.mmi(i).yen := '0';
+				v.mm.mmi(i).sqr := '0';
 				v.mm.mmi(i).go := '0';
 				v.mm.mmi(i).zren := '0';
 			end loop;
@@ -2410,6 +2424,7 @@ begin
 			-- redc
 			v.mm.push.busy := '0';
 			v.mm.push.do := '0';
+			v.mm.push.sqr := '0';
 			v.mm.nb_pending_redc := (others => '0');
 			v.mm.pending_redc := '0';
 			-- add & sub
@@ -2598,7 +2613,11 @@ begin
 						write(lineout, string'("[0x"));
 						hex_write(lineout, pc);
 						write(lineout, string'("] "));
-						write(lineout, string'("  FPREDC"));
+						if r.mm.push.sqr = '1' then
+							write(lineout, string'("  FPSQR "));
+						else
+							write(lineout, string'("  FPREDC"));
+						end if;
 						-- possible ',p' patch
 						if patching = '1' then
 							if patchid < 10 then
@@ -2620,8 +2639,13 @@ begin
 						write_addr2(lineout,
 							r.opa(FP_ADDR_MSB - 1 + log2z(n - 1) downto log2z(n - 1)));
 						write(lineout, string'("  x  "));
-						write_addr2(lineout,
-							r.opb(FP_ADDR_MSB - 1 + log2z(n - 1) downto log2z(n - 1)));
+						if r.mm.push.sqr = '1' then
+							write_addr2(lineout,
+								r.opa(FP_ADDR_MSB - 1 + log2z(n - 1) downto log2z(n - 1)));
+						else
+							write_addr2(lineout,
+								r.opb(FP_ADDR_MSB - 1 + log2z(n - 1) downto log2z(n - 1)));
+						end if;
 						write(lineout, string'(")  ["));
 						write(lineout, time'image(now));
 						write(lineout, string'("]"));
@@ -0,0 +1,854 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.mm_ndsp_pkg.all;
+use work.ecc_trng_pkg.all;
+use work.ecc_shuffle_pkg.all;
+
+-- pragma translate_off
+use std.textio.all;
+-- pragma translate_on
+
+-- Multi-core top-level: 'nbcores' [k]P engines (ecc_core) behind one single
+-- AXI-lite slave interface, sharing one single TRNG.
+--
+-- Address map: the register bank of engine #i (identical to the one of the
+-- standard 'ecc' top-level, see ecc_software.vhd) is mapped at offset
+-- i x 2**AXIAW (= i x 0x200) from base address of the IP. The upper bits
+-- of the AXI address buses (above AXIAW - 1) hence select the engine.
+-- Accessing a bank beyond the last engine results in a SLVERR response.
+--
+-- Interrupt is the OR of the interrupts of all engines: upon interrupt the
+-- software driver should check the R_STATUS register of each engine it has
+-- programmed a computation on.
+--
+-- Software reset (W_SOFT_RESET) only resets the engine whose register bank
+-- it is written to, never the shared TRNG (see (s1) in architecture).
+--
+-- TRNG debug registers (HW unsecure mode only): W_DBG_TRNG_CFG, *_RESET,
+-- *_CTRL_POSTP, *_CTRL_BYPASS & *_RAW_READ only act from the register bank
+-- of engine 0 (they are ignored in other banks, see (s0) in architecture). Likewise R_DBG_TRNG_STATUS, *_RAW_DATA,
+-- *_RAWDUR & *_DIAG_MIN/MAX report the shared TRNG and its shared IRN FIFOs,
+-- hence they are only meaningful in bank 0. Only the R_DBG_TRNG_DIAG_OK &
+-- *_DIAG_STARV counters of clients axi, efp, crv & shf are per engine (they
+-- count the handshakes of each engine with its own output of the fan-outs).
+entity ecc_multi is
+	generic(
+		-- width of AXI data bus
+		constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+		-- width of AXI address bus
+		constant C_S_AXI_ADDR_WIDTH : integer := AXIAW + log2(nbcores - 1)
+	);
+	port(
+		-- AXI clock
+		s_axi_aclk : in std_logic;
+		-- AXI reset (expected active low, async asserted, sync deasserted) 
+		s_axi_aresetn : in std_logic;
+		-- AXI write-address channel
+		s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+		s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+		s_axi_awvalid : in std_logic;
+		s_axi_awready : out std_logic;
+		-- AXI write-data channel
+		s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+		s_axi_wvalid : in std_logic;
+		s_axi_wready : out std_logic;
+		-- AXI write-response channel
+		s_axi_bresp : out std_logic_vector(1 downto 0);
+		s_axi_bvalid : out std_logic;
+		s_axi_bready : in std_logic;
+		-- AXI read-address channel
+		s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+		s_axi_arvalid : in std_logic;
+		s_axi_arready : out std_logic;
+		-- AXI read-data channel
+		s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_rresp : out std_logic_vector(1 downto 0);
+		s_axi_rvalid : out std_logic;
+		s_axi_rready : in std_logic;
+		-- clock for Montgomery multipliers in the async case
+		clkmm : in std_logic;
+		-- interrupt (OR of all engines)
+		irq : out std_logic;
+		-- busy signals for [k]P computation (one per engine)
+		busy : out std_logic_vector(nbcores - 1 downto 0);
+		-- HW unsecure/Side-Channel analysis features
+		--   off-chip trigger (OR of all engines)
+		dbgtrigger : out std_logic;
+		dbghalted : out std_logic;
+		--   pseudo-trng port
+		dbgptdata : in std_logic_vector(7 downto 0);
+		dbgptvalid : in std_logic;
+		dbgptrdy : out std_logic;
+		-- clk & clkmm division & out feature (engine 0 only)
+		clkdivo : out std_logic;
+		clkmmdivo : out std_logic
+	);
+end entity ecc_multi;
+
+architecture struct of ecc_multi is
+
+	-- following attributes are Xilinx specific but they should not do any harm
+	-- on other platforms
+	attribute X_INTERFACE_INFO : string;
+	attribute X_INTERFACE_PARAMETER : string;
+	attribute X_INTERFACE_INFO of irq : signal is
+		"xilinx.com:signal:interrupt:1.0 irq INTERRUPT";
+	attribute X_INTERFACE_PARAMETER of irq : signal is "SENSITIVITY EDGE_RISING";
+
+	-- [k]P engine (everything but the TRNG)
+	component ecc_core is
+		generic(
+			-- width of AXI data bus
+			constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+			-- width of AXI address bus
+			constant C_S_AXI_ADDR_WIDTH : integer := AXIAW -- in ecc_pkg
+		);
+		port(
+			-- AXI clock
+			s_axi_aclk : in std_logic;
+			-- AXI reset (active low, expected to be already resynchronized
+			-- in the s_axi_aclk clock domain by the parent entity)
+			s_axi_aresetn : in std_logic;
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			-- AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- AXI-Stream ports for large numbers (only if 'axistream' = TRUE)
+			s_axis_tdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axis_tvalid : in std_logic;
+			s_axis_tready : out std_logic;
+			m_axis_tdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axis_tvalid : out std_logic;
+			m_axis_tready : in std_logic;
+			m_axis_tlast : out std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation
+			busy : out std_logic;
+			-- HW unsecure/Side-Channel analysis features
+			--   off-chip trigger
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			-- software reset (to the entropy server)
+			swrst : out std_logic;
+			-- interface with entropy server ecc_trng (client ecc_axi)
+			trngaxirdy : out std_logic;
+			trngaxivalid : in std_logic;
+			trngaxidata : in std_logic_vector(ww - 1 downto 0);
+			trngaxiirncount : in std_logic_vector(log2(irn_fifo_size_axi) - 1 downto 0);
+			-- interface with entropy server ecc_trng (client ecc_fp)
+			trngefprdy : out std_logic;
+			trngefpvalid : in std_logic;
+			trngefpdata : in std_logic_vector(ww - 1 downto 0);
+			dbgtrngefpirncount : in std_logic_vector(log2(irn_fifo_size_efp) - 1 downto 0);
+			-- interface with entropy server ecc_trng (client ecc_curve)
+			trngcrvrdy : out std_logic;
+			trngcrvvalid : in std_logic;
+			trngcrvdata : in std_logic_vector(1 downto 0);
+			dbgtrngcrvirncount : in std_logic_vector(log2(irn_fifo_size_crv) - 1 downto 0);
+			-- interface with entropy server ecc_trng (client ecc_fp_dram_sh_*)
+			trngshfrdy : out std_logic;
+			trngshfvalid : in std_logic;
+			trngshfdata : in std_logic_vector(irn_width_sh - 1 downto 0);
+			dbgtrngshfirncount : in std_logic_vector(log2(irn_fifo_size_shf) - 1 downto 0);
+			-- HW unsecure/Side-Channel analysis features (interface with ecc_trng)
+			dbgtrngta : out unsigned(15 downto 0);
+			dbgtrngrawreset : out std_logic;
+			dbgtrngirnreset : out std_logic;
+			dbgtrngrawfull : in std_logic;
+			dbgtrngrawwaddr : in std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawraddr : out std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawdata : in std_logic;
+			dbgtrngrawfiforeaddis : out std_logic;
+			dbgtrngcompletebypass : out std_logic;
+			dbgtrngcompletebypassbit : out std_logic;
+			dbgtrngrawduration : in unsigned(31 downto 0);
+			dbgtrngvonneuman : out std_logic;
+			dbgtrngidletime : out unsigned(3 downto 0);
+			dbgtrngrawcount : in std_logic_vector(log2(raw_ram_size) - 1 downto 0);
+			dbgtrngusepseudosource : out std_logic;
+			dbgtrngrawpullppdis : out std_logic;
+			dbgtrngrawrdy : in std_logic;
+			dbgtrngrawvalid : in std_logic;
+			-- clk & clkmm division & out feature
+			clkdivo : out std_logic;
+			clkmmdivo : out std_logic
+		);
+	end component ecc_core;
+
+	-- True random number generator w/ embedded post-processing
+	component ecc_trng is
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_scalar
+			irn_reset : in std_logic;
+			-- interface with entropy client ecc_axi
+			rdy0 : in std_logic;
+			valid0 : out std_logic;
+			data0 : out std_logic_vector(ww - 1 downto 0);
+			irncount0 : out std_logic_vector(log2(irn_fifo_size_axi) - 1 downto 0);
+			-- interface with entropy client ecc_fp
+			rdy1 : in std_logic;
+			valid1 : out std_logic;
+			data1 : out std_logic_vector(ww - 1 downto 0);
+			irncount1 : out std_logic_vector(log2(irn_fifo_size_efp) - 1 downto 0);
+			-- interface with entropy client ecc_curve
+			rdy2 : in std_logic;
+			valid2 : out std_logic;
+			data2 : out std_logic_vector(1 downto 0);
+			irncount2 : out std_logic_vector(log2(irn_fifo_size_crv) - 1 downto 0);
+			-- interface with entropy client ecc_fp_dram_sh_*
+			rdy3 : in std_logic;
+			valid3 : out std_logic;
+			data3 : out std_logic_vector(irn_width_sh - 1 downto 0);
+			irncount3 : out std_logic_vector(log2(irn_fifo_size_shf) - 1 downto 0);
+			-- interface with ecc_axi (only usable in HW unsecure mode)
+			dbgtrngta : in unsigned(15 downto 0);
+			dbgtrngrawreset : in std_logic;
+			dbgtrngrawfull : out std_logic;
+			dbgtrngrawwaddr : out std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawraddr : in std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawdata : out std_logic;
+			dbgtrngrawfiforeaddis : in std_logic;
+			dbgtrngcompletebypass : in std_logic;
+			dbgtrngcompletebypassbit : in std_logic;
+			dbgtrngrawduration : out unsigned(31 downto 0);
+			dbgtrngvonneuman : in std_logic;
+			dbgtrngidletime : in unsigned(3 downto 0);
+			dbgtrngrawcount : out std_logic_vector(log2(raw_ram_size) - 1 downto 0);
+			dbgtrngusepseudosource : in std_logic;
+			dbgtrngrawpullppdis : in std_logic;
+			-- interface with the external pseudo TRNG component
+			dbgpseudotrngdata : in std_logic_vector(7 downto 0);
+			dbgpseudotrngvalid : in std_logic;
+			dbgpseudotrngrdy : out std_logic;
+			dbgtrngrawrdy : out std_logic;
+			dbgtrngrawvalid : out std_logic
+		);
+	end component ecc_trng;
+
+	-- fan-out of one entropy client channel to all engines
+	component ecc_trng_fanout is
+		generic(
+			datawidth : positive;
+			nbclients : positive);
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_trng_srv (upstream)
+			rdy : out std_logic;
+			valid : in std_logic;
+			data : in std_logic_vector(datawidth - 1 downto 0);
+			-- interface with the consumers (downstream)
+			rdyi : in std_logic_vector(nbclients - 1 downto 0);
+			valido : out std_logic_vector(nbclients - 1 downto 0);
+			datao : out std_logic_vector(nbclients*datawidth - 1 downto 0)
+		);
+	end component ecc_trng_fanout;
+
+	-- number of bits in AXI address buses selecting the engine
+	constant BKB : positive := C_S_AXI_ADDR_WIDTH - AXIAW;
+
+	subtype std_logic_cores is std_logic_vector(nbcores - 1 downto 0);
+	type axi_data_array_type is array(0 to nbcores - 1)
+		of std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+	type axi_resp_array_type is array(0 to nbcores - 1)
+		of std_logic_vector(1 downto 0);
+
+	-- bank selection for AXI transactions
+	type bank_reg_type is record
+		-- write transaction
+		wbusy : std_logic;
+		wbank : natural range 0 to nbcores - 1;
+		werr : std_logic;
+		awdone : std_logic;
+		wdone : std_logic;
+		bvalid : std_logic;
+		-- read transaction
+		rbusy : std_logic;
+		rbank : natural range 0 to nbcores - 1;
+		rerr : std_logic;
+		ardone : std_logic;
+		rvalid : std_logic;
+	end record;
+
+	signal r, rin : bank_reg_type;
+
+	-- AXI signals between bank selection & engines
+	signal awvalid, awready : std_logic_cores;
+	signal wvalid, wready : std_logic_cores;
+	signal bvalid, bready : std_logic_cores;
+	signal bresp : axi_resp_array_type;
+	signal arvalid, arready : std_logic_cores;
+	signal rvalid, rready : std_logic_cores;
+	signal rresp : axi_resp_array_type;
+	signal rdata : axi_data_array_type;
+	signal awaddr : std_logic_vector(AXIAW - 1 downto 0);
+	signal araddr : std_logic_vector(AXIAW - 1 downto 0);
+
+	-- signals between engines & top-level outputs
+	signal irqs : std_logic_cores;
+	signal dbgtriggers : std_logic_cores;
+	signal dbghalteds : std_logic_cores;
+	signal clkdivos : std_logic_cores;
+	signal clkmmdivos : std_logic_cores;
+	signal axis_zero : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+
+	-- signals between ecc_trng & the fan-outs
+	signal trng_rdy_axi : std_logic;
+	signal trng_valid_axi : std_logic;
+	signal trng_data_axi : std_logic_vector(ww - 1 downto 0);
+	signal trngaxiirncount : std_logic_vector(log2(irn_fifo_size_axi) - 1 downto 0);
+	signal trng_rdy_fp : std_logic;
+	signal trng_valid_fp : std_logic;
+	signal trng_data_fp : std_logic_vector(ww - 1 downto 0);
+	signal trng_rdy_curve : std_logic;
+	signal trng_valid_curve : std_logic;
+	signal trng_data_curve : std_logic_vector(1 downto 0);
+	signal trng_rdy_sh : std_logic;
+	signal trng_valid_sh : std_logic;
+	signal trng_data_sh : std_logic_vector(irn_width_sh - 1 downto 0);
+
+	-- signals between the fan-outs & the engines
+	signal trng_rdy_axis : std_logic_cores;
+	signal trng_valid_axis : std_logic_cores;
+	signal trng_data_axis : std_logic_vector(nbcores*ww - 1 downto 0);
+	signal trng_rdy_fps : std_logic_cores;
+	signal trng_valid_fps : std_logic_cores;
+	signal trng_data_fps : std_logic_vector(nbcores*ww - 1 downto 0);
+	signal trng_rdy_curves : std_logic_cores;
+	signal trng_valid_curves : std_logic_cores;
+	signal trng_data_curves : std_logic_vector(nbcores*2 - 1 downto 0);
+	signal trng_rdy_shs : std_logic_cores;
+	signal trng_valid_shs : std_logic_cores;
+	signal trng_data_shs : std_logic_vector(nbcores*irn_width_sh - 1 downto 0);
+
+	-- HW unsecure/Side-Channel analysis features (signals between
+	-- ecc_trng & the ecc_axi of engine 0)
+	signal dbgtrngrawrdy : std_logic;
+	signal dbgtrngrawvalid : std_logic;
+	signal dbgtrngta : unsigned(15 downto 0);
+	signal dbgtrngrawreset : std_logic;
+	signal dbgtrngirnreset : std_logic;
+	signal dbgtrngrawfull : std_logic;
+	signal dbgtrngrawwaddr : std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+	signal dbgtrngrawraddr : std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+	signal dbgtrngrawdata : std_logic;
+	signal dbgtrngrawfiforeaddis : std_logic;
+	signal dbgtrngcompletebypass, dbgtrngcompletebypassbit : std_logic;
+	signal dbgtrngrawduration : unsigned(31 downto 0);
+	signal dbgtrngvonneuman : std_logic;
+	signal dbgtrngidletime : unsigned(3 downto 0);
+	signal dbgtrngefpirncount : std_logic_vector(log2(irn_fifo_size_efp) - 1 downto 0);
+	signal dbgtrngcrvirncount : std_logic_vector(log2(irn_fifo_size_crv) - 1 downto 0);
+	signal dbgtrngshfirncount : std_logic_vector(log2(irn_fifo_size_shf) - 1 downto 0);
+	signal dbgtrngrawcount : std_logic_vector(log2(raw_ram_size) - 1 downto 0);
+	signal dbgtrngusepseudosource : std_logic;
+	signal dbgtrngrawpullppdis : std_logic;
+	-- (same as above, driven by each engine)
+	type dbgtrngta_array_type is array(0 to nbcores - 1) of unsigned(15 downto 0);
+	type dbgtrngrawraddr_array_type is array(0 to nbcores - 1)
+		of std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+	type dbgtrngidletime_array_type is array(0 to nbcores - 1)
+		of unsigned(3 downto 0);
+	signal dbgtrngtas : dbgtrngta_array_type;
+	signal dbgtrngrawresets : std_logic_cores;
+	signal dbgtrngirnresets : std_logic_cores;
+	signal dbgtrngrawraddrs : dbgtrngrawraddr_array_type;
+	signal dbgtrngrawfiforeaddiss : std_logic_cores;
+	signal dbgtrngcompletebypasss : std_logic_cores;
+	signal dbgtrngcompletebypassbits : std_logic_cores;
+	signal dbgtrngvonneumans : std_logic_cores;
+	signal dbgtrngidletimes : dbgtrngidletime_array_type;
+	signal dbgtrngusepseudosources : std_logic_cores;
+	signal dbgtrngrawpullppdiss : std_logic_cores;
+
+	signal s_axi_aresetn_rsh : std_logic_vector(2 downto 0);
+	alias s_axi_aresetn_resync : std_logic is s_axi_aresetn_rsh(0);
+
+	-- OR-reduction of a vector
+	function or_reduce(constant v : std_logic_cores) return std_logic is
+		variable o : std_logic;
+	begin
+		o := '0';
+		for i in v'range loop
+			o := o or v(i);
+		end loop;
+		return o;
+	end function or_reduce;
+
+begin
+
+	axis_zero <= (others => '0');
+
+	assert (C_S_AXI_ADDR_WIDTH >= AXIAW + log2(nbcores - 1))
+		report "ecc_multi: generic C_S_AXI_ADDR_WIDTH is too small to address "
+		     & "the register banks of all the engines (must be at least "
+		     & "AXIAW + log2(nbcores - 1))."
+			severity FAILURE;
+
+	-- force resynchronization of input reset s_axi_aresetn in the
+	-- s_axi_aclk clock domain
+	process(s_axi_aclk, s_axi_aresetn)
+	begin
+		if (s_axi_aresetn = '0') then
+			s_axi_aresetn_rsh <= (others => '0');
+		elsif s_axi_aclk'event and s_axi_aclk = '1' then
+			s_axi_aresetn_rsh(s_axi_aresetn_rsh'length - 1 downto 0) <=
+				'1' & s_axi_aresetn_rsh(s_axi_aresetn_rsh'length - 1 downto 1);
+		end if;
+	end process;
+
+	-- -----------------------------------------------------------------
+	-- Selection of the register bank (i.e of the engine) targeted by
+	-- AXI transactions. Only one write and one read transactions can
+	-- be in flight at the same time: the bank is latched upon arrival
+	-- of the address and held until the response has been accepted.
+	-- -----------------------------------------------------------------
+	comb: process(r, s_axi_aresetn_resync, s_axi_awaddr, s_axi_awvalid,
+	              s_axi_wvalid, s_axi_bready, s_axi_araddr, s_axi_arvalid,
+	              s_axi_rready, awready, wready, bvalid, arready, rvalid)
+		variable v : bank_reg_type;
+		variable v_bank : natural;
+	begin
+		v := r;
+
+		-- ------------------
+		-- write transactions
+		-- ------------------
+		if r.wbusy = '0' then
+			if s_axi_awvalid = '1' then
+				v_bank := to_integer(unsigned(
+					s_axi_awaddr(C_S_AXI_ADDR_WIDTH - 1 downto AXIAW)));
+				v.wbusy := '1';
+				v.awdone := '0';
+				v.wdone := '0';
+				if v_bank < nbcores then
+					v.wbank := v_bank;
+					v.werr := '0';
+				else
+					v.wbank := 0;
+					v.werr := '1';
+				end if;
+			end if;
+		else -- r.wbusy = 1
+			if r.werr = '0' then
+				if awready(r.wbank) = '1' and s_axi_awvalid = '1' and r.awdone = '0' then
+					v.awdone := '1';
+				end if;
+				if wready(r.wbank) = '1' and s_axi_wvalid = '1' and r.wdone = '0' then
+					v.wdone := '1';
+				end if;
+				if bvalid(r.wbank) = '1' and s_axi_bready = '1' then
+					v.wbusy := '0';
+				end if;
+			else -- r.werr = 1
+				-- address & data are accepted but not forwarded to any engine
+				if s_axi_awvalid = '1' and r.awdone = '0' then
+					v.awdone := '1';
+				end if;
+				if s_axi_wvalid = '1' and r.wdone = '0' then
+					v.wdone := '1';
+				end if;
+				if r.awdone = '1' and r.wdone = '1' and r.bvalid = '0' then
+					v.bvalid := '1';
+				end if;
+				if r.bvalid = '1' and s_axi_bready = '1' then
+					v.bvalid := '0';
+					v.wbusy := '0';
+				end if;
+			end if;
+		end if;
+
+		-- -----------------
+		-- read transactions
+		-- -----------------
+		if r.rbusy = '0' then
+			if s_axi_arvalid = '1' then
+				v_bank := to_integer(unsigned(
+					s_axi_araddr(C_S_AXI_ADDR_WIDTH - 1 downto AXIAW)));
+				v.rbusy := '1';
+				v.ardone := '0';
+				if v_bank < nbcores then
+					v.rbank := v_bank;
+					v.rerr := '0';
+				else
+					v.rbank := 0;
+					v.rerr := '1';
+				end if;
+			end if;
+		else -- r.rbusy = 1
+			if r.rerr = '0' then
+				if arready(r.rbank) = '1' and s_axi_arvalid = '1' and r.ardone = '0' then
+					v.ardone := '1';
+				end if;
+				if rvalid(r.rbank) = '1' and s_axi_rready = '1' then
+					v.rbusy := '0';
+				end if;
+			else -- r.rerr = 1
+				if s_axi_arvalid = '1' and r.ardone = '0' then
+					v.ardone := '1';
+					v.rvalid := '1';
+				end if;
+				if r.rvalid = '1' and s_axi_rready = '1' then
+					v.rvalid := '0';
+					v.rbusy := '0';
+				end if;
+			end if;
+		end if;
+
+		-- synchronous reset
+		if s_axi_aresetn_resync = '0' then
+			v.wbusy := '0';
+			v.bvalid := '0';
+			v.rbusy := '0';
+			v.rvalid := '0';
+		end if;
+
+		rin <= v;
+	end process comb;
+
+	regs: process(s_axi_aclk)
+	begin
+		if s_axi_aclk'event and s_axi_aclk = '1' then
+			r <= rin;
+		end if;
+	end process regs;
+
+	-- address & data buses are broadcast to all engines, only
+	-- the handshake signals are routed to the selected one
+	awaddr <= s_axi_awaddr(AXIAW - 1 downto 0);
+	araddr <= s_axi_araddr(AXIAW - 1 downto 0);
+
+	b0: for i in 0 to nbcores - 1 generate
+		awvalid(i) <= s_axi_awvalid when r.wbusy = '1' and r.werr = '0'
+		              and r.awdone = '0' and r.wbank = i else '0';
+		wvalid(i) <= s_axi_wvalid when r.wbusy = '1' and r.werr = '0'
+		             and r.wdone = '0' and r.wbank = i else '0';
+		bready(i) <= s_axi_bready when r.wbusy = '1' and r.werr = '0'
+		             and r.wbank = i else '0';
+		arvalid(i) <= s_axi_arvalid when r.rbusy = '1' and r.rerr = '0'
+		              and r.ardone = '0' and r.rbank = i else '0';
+		rready(i) <= s_axi_rready when r.rbusy = '1' and r.rerr = '0'
+		             and r.rbank = i else '0';
+	end generate;
+
+	s_axi_awready <= '0' when r.wbusy = '0' or r.awdone = '1' else
+	                 '1' when r.werr = '1' else awready(r.wbank);
+	s_axi_wready <= '0' when r.wbusy = '0' or r.wdone = '1' else
+	                '1' when r.werr = '1' else wready(r.wbank);
+	s_axi_bvalid <= '0' when r.wbusy = '0' else
+	                r.bvalid when r.werr = '1' else bvalid(r.wbank);
+	s_axi_bresp <= "10" when r.werr = '1' else bresp(r.wbank); -- SLVERR
+	s_axi_arready <= '0' when r.rbusy = '0' or r.ardone = '1' else
+	                 '1' when r.rerr = '1' else arready(r.rbank);
+	s_axi_rvalid <= '0' when r.rbusy = '0' else
+	                r.rvalid when r.rerr = '1' else rvalid(r.rbank);
+	s_axi_rresp <= "10" when r.rerr = '1' else rresp(r.rbank); -- SLVERR
+	s_axi_rdata <= (others => '0') when r.rerr = '1' else rdata(r.rbank);
+
+	-- -------
+	-- engines
+	-- -------
+	e0: for i in 0 to nbcores - 1 generate
+		c0: ecc_core
+			generic map(
+				C_S_AXI_DATA_WIDTH => C_S_AXI_DATA_WIDTH,
+				C_S_AXI_ADDR_WIDTH => AXIAW)
+			port map(
+				-- AXI clock & reset
+				s_axi_aclk => s_axi_aclk,
+				s_axi_aresetn => s_axi_aresetn_resync,
+				-- AXI write-address channel
+				s_axi_awaddr => awaddr,
+				s_axi_awprot => s_axi_awprot,
+				s_axi_awvalid => awvalid(i),
+				s_axi_awready => awready(i),
+				-- AXI write-data channel
+				s_axi_wdata => s_axi_wdata,
+				s_axi_wstrb => s_axi_wstrb,
+				s_axi_wvalid => wvalid(i),
+				s_axi_wready => wready(i),
+				-- AXI write-response channel
+				s_axi_bresp => bresp(i),
+				s_axi_bvalid => bvalid(i),
+				s_axi_bready => bready(i),
+				-- AXI read-address channel
+				s_axi_araddr => araddr,
+				s_axi_arprot => s_axi_arprot,
+				s_axi_arvalid => arvalid(i),
+				s_axi_arready => arready(i),
+				-- AXI read-data channel
+				s_axi_rdata => rdata(i),
+				s_axi_rresp => rresp(i),
+				s_axi_rvalid => rvalid(i),
+				s_axi_rready => rready(i),
+				-- AXI-Stream ports for large numbers (not available with ecc_multi)
+				s_axis_tdata => axis_zero,
+				s_axis_tvalid => '0',
+				s_axis_tready => open,
+				m_axis_tdata => open,
+				m_axis_tvalid => open,
+				m_axis_tready => '0',
+				m_axis_tlast => open,
+				-- clock for Montgomery multipliers in the async case
+				clkmm => clkmm,
+				-- interrupt
+				irq => irqs(i),
+				-- busy signal for [k]P computation
+				busy => busy(i),
+				-- HW unsecure/Side-Channel analysis features
+				--   off-chip trigger
+				dbgtrigger => dbgtriggers(i),
+				dbghalted => dbghalteds(i),
+				-- software reset (not to the shared entropy server, see (s1))
+				swrst => open,
+				-- interface with entropy server ecc_trng (client ecc_axi)
+				trngaxirdy => trng_rdy_axis(i),
+				trngaxivalid => trng_valid_axis(i),
+				trngaxidata => trng_data_axis(((i + 1) * ww) - 1 downto i * ww),
+				trngaxiirncount => trngaxiirncount,
+				-- interface with entropy server ecc_trng (client ecc_fp)
+				trngefprdy => trng_rdy_fps(i),
+				trngefpvalid => trng_valid_fps(i),
+				trngefpdata => trng_data_fps(((i + 1) * ww) - 1 downto i * ww),
+				dbgtrngefpirncount => dbgtrngefpirncount,
+				-- interface with entropy server ecc_trng (client ecc_curve)
+				trngcrvrdy => trng_rdy_curves(i),
+				trngcrvvalid => trng_valid_curves(i),
+				trngcrvdata => trng_data_curves(((i + 1) * 2) - 1 downto i * 2),
+				dbgtrngcrvirncount => dbgtrngcrvirncount,
+				-- interface with entropy server ecc_trng (client ecc_fp_dram_sh_*)
+				trngshfrdy => trng_rdy_shs(i),
+				trngshfvalid => trng_valid_shs(i),
+				trngshfdata => trng_data_shs(
+					((i + 1) * irn_width_sh) - 1 downto i * irn_width_sh),
+				dbgtrngshfirncount => dbgtrngshfirncount,
+				-- HW unsecure/Side-Channel analysis features (interface with
+				-- ecc_trng): only the outputs of engine 0 are actually connected
+				-- to the TRNG, see (s0) below
+				dbgtrngta => dbgtrngtas(i),
+				dbgtrngrawreset => dbgtrngrawresets(i),
+				dbgtrngirnreset => dbgtrngirnresets(i),
+				dbgtrngrawfull => dbgtrngrawfull,
+				dbgtrngrawwaddr => dbgtrngrawwaddr,
+				dbgtrngrawraddr => dbgtrngrawraddrs(i),
+				dbgtrngrawdata => dbgtrngrawdata,
+				dbgtrngrawfiforeaddis => dbgtrngrawfiforeaddiss(i),
+				dbgtrngcompletebypass => dbgtrngcompletebypasss(i),
+				dbgtrngcompletebypassbit => dbgtrngcompletebypassbits(i),
+				dbgtrngrawduration => dbgtrngrawduration,
+				dbgtrngvonneuman => dbgtrngvonneumans(i),
+				dbgtrngidletime => dbgtrngidletimes(i),
+				dbgtrngrawcount => dbgtrngrawcount,
+				dbgtrngusepseudosource => dbgtrngusepseudosources(i),
+				dbgtrngrawpullppdis => dbgtrngrawpullppdiss(i),
+				dbgtrngrawrdy => dbgtrngrawrdy,
+				dbgtrngrawvalid => dbgtrngrawvalid,
+				-- clk & clkmm division & out feature
+				clkdivo => clkdivos(i),
+				clkmmdivo => clkmmdivos(i)
+			); -- ecc_core
+	end generate;
+
+	-- (s0) the shared TRNG is controlled (in HW unsecure mode) by the debug
+	-- registers of engine 0 only
+	dbgtrngta <= dbgtrngtas(0);
+	dbgtrngrawreset <= dbgtrngrawresets(0);
+	dbgtrngirnreset <= dbgtrngirnresets(0);
+	dbgtrngrawraddr <= dbgtrngrawraddrs(0);
+	dbgtrngrawfiforeaddis <= dbgtrngrawfiforeaddiss(0);
+	dbgtrngcompletebypass <= dbgtrngcompletebypasss(0);
+	dbgtrngcompletebypassbit <= dbgtrngcompletebypassbits(0);
+	dbgtrngvonneuman <= dbgtrngvonneumans(0);
+	dbgtrngidletime <= dbgtrngidletimes(0);
+	dbgtrngusepseudosource <= dbgtrngusepseudosources(0);
+	dbgtrngrawpullppdis <= dbgtrngrawpullppdiss(0);
+
+	-- TRNG (shared by all engines)
+	--
+	-- (s1) the TRNG & the 4 fan-outs below are only reset by the AXI reset:
+	-- a software reset written to the register bank of one engine must not
+	-- disturb the others (e.g. by flushing the IRN FIFOs they are drawing from
+	-- during a [k]P computation)
+	t0: ecc_trng
+		port map(
+			clk => s_axi_aclk,
+			rstn => s_axi_aresetn_resync,
+			swrst => '0',
+			-- interface with ecc_scalar
+			irn_reset => dbgtrngirnreset,
+			-- interface with entropy client ecc_axi
+			rdy0 => trng_rdy_axi,
+			valid0 => trng_valid_axi,
+			data0 => trng_data_axi,
+			irncount0 => trngaxiirncount,
+			-- interface with entropy client ecc_fp
+			rdy1 => trng_rdy_fp,
+			valid1 => trng_valid_fp,
+			data1 => trng_data_fp,
+			irncount1 => dbgtrngefpirncount,
+			-- interface with entropy client ecc_curve
+			rdy2 => trng_rdy_curve,
+			valid2 => trng_valid_curve,
+			data2 => trng_data_curve,
+			irncount2 => dbgtrngcrvirncount,
+			-- interface with entropy client ecc_fp_dram_sh
+			rdy3 => trng_rdy_sh,
+			valid3 => trng_valid_sh,
+			data3 => trng_data_sh,
+			irncount3 => dbgtrngshfirncount,
+			-- interface with ecc_axi (only usable in HW unsecure mode)
+			dbgtrngta => dbgtrngta,
+			dbgtrngrawreset => dbgtrngrawreset,
+			dbgtrngrawfull => dbgtrngrawfull,
+			dbgtrngrawwaddr => dbgtrngrawwaddr,
+			dbgtrngrawraddr => dbgtrngrawraddr,
+			dbgtrngrawdata => dbgtrngrawdata,
+			dbgtrngrawfiforeaddis => dbgtrngrawfiforeaddis,
+			dbgtrngcompletebypass => dbgtrngcompletebypass,
+			dbgtrngcompletebypassbit => dbgtrngcompletebypassbit,
+			dbgtrngrawduration => dbgtrngrawduration,
+			dbgtrngvonneuman => dbgtrngvonneuman,
+			dbgtrngidletime => dbgtrngidletime,
+			dbgtrngrawcount => dbgtrngrawcount,
+			dbgtrngusepseudosource => dbgtrngusepseudosource,
+			dbgtrngrawpullppdis => dbgtrngrawpullppdis,
+			-- interface with the external pseudo TRNG component
+			dbgpseudotrngdata => dbgptdata,
+			dbgpseudotrngvalid => dbgptvalid,
+			dbgpseudotrngrdy => dbgptrdy,
+			dbgtrngrawrdy => dbgtrngrawrdy,
+			dbgtrngrawvalid => dbgtrngrawvalid
+		); -- ecc_trng
+
+	-- fan-out of entropy client channel ecc_axi
+	f0: ecc_trng_fanout
+		generic map(datawidth => ww, nbclients => nbcores)
+		port map(
+			clk => s_axi_aclk,
+			rstn => s_axi_aresetn_resync,
+			swrst => '0',
+			rdy => trng_rdy_axi,
+			valid => trng_valid_axi,
+			data => trng_data_axi,
+			rdyi => trng_rdy_axis,
+			valido => trng_valid_axis,
+			datao => trng_data_axis
+		);
+
+	-- fan-out of entropy client channel ecc_fp
+	f1: ecc_trng_fanout
+		generic map(datawidth => ww, nbclients => nbcores)
+		port map(
+			clk => s_axi_aclk,
+			rstn => s_axi_aresetn_resync,
+			swrst => '0',
+			rdy => trng_rdy_fp,
+			valid => trng_valid_fp,
+			data => trng_data_fp,
+			rdyi => trng_rdy_fps,
+			valido => trng_valid_fps,
+			datao => trng_data_fps
+		);
+
+	-- fan-out of entropy client channel ecc_curve
+	f2: ecc_trng_fanout
+		generic map(datawidth => 2, nbclients => nbcores)
+		port map(
+			clk => s_axi_aclk,
+			rstn => s_axi_aresetn_resync,
+			swrst => '0',
+			rdy => trng_rdy_curve,
+			valid => trng_valid_curve,
+			data => trng_data_curve,
+			rdyi => trng_rdy_curves,
+			valido => trng_valid_curves,
+			datao => trng_data_curves
+		);
+
+	-- fan-out of entropy client channel ecc_fp_dram_sh_*
+	f3: ecc_trng_fanout
+		generic map(datawidth => irn_width_sh, nbclients => nbcores)
+		port map(
+			clk => s_axi_aclk,
+			rstn => s_axi_aresetn_resync,
+			swrst => '0',
+			rdy => trng_rdy_sh,
+			valid => trng_valid_sh,
+			data => trng_data_sh,
+			rdyi => trng_rdy_shs,
+			valido => trng_valid_shs,
+			datao => trng_data_shs
+		);
+
+	-- -------------
+	-- drive outputs
+	-- -------------
+	irq <= or_reduce(irqs);
+	dbgtrigger <= or_reduce(dbgtriggers);
+	dbghalted <= or_reduce(dbghalteds);
+	clkdivo <= clkdivos(0);
+	clkmmdivo <= clkmmdivos(0);
+
+	-- pragma translate_off
+	process
+	begin
+		echo("[  ecc_multi.vhd ]: Config: ");
+		echo(integer'image(nbcores));
+		echo(" engines sharing one TRNG, register bank of engine #i at +i x ");
+		echo(integer'image(2**AXIAW));
+		echol(" bytes");
+		wait;
+	end process;
+	-- pragma translate_on
+
+end architecture struct;
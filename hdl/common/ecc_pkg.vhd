@@ -63,6 +63,37 @@ package ecc_pkg is
 	-- and MUST be greater than or equal to 2
 	constant w : natural := div(nn + 4, ww);
 
+	-- 'FASTRED_EN'
+	--
+	-- TRUE when the Solinas reduction mode requested by parameter 'fastred'
+	-- (see ecc_customize.vhd) can actually be implemented: it only exists in
+	-- mm_ndsp_mc (hence needs 'nbchain' > 0) and it folds the product on a
+	-- 32-bit word basis (hence needs 'ww' to evenly divide 32)
+	constant FASTRED_EN : boolean :=
+		fastred and nbchain > 0 and ww <= 32 and (32 mod ww) = 0;
+
+	-- 'HOSTMTY_EN'
+	--
+	-- TRUE when the upload of Montgomery constants by software requested by
+	-- parameter 'hostmty' (see ecc_customize.vhd) can actually be implemented:
+	-- constants are written one 'ww'-bit limb per write of W_MTYCST_DATA
+	-- register, hence 'ww' must not exceed the width of the AXI data bus.
+	-- It is never implemented in HW secure mode, as the constants are not
+	-- checked by hardware
+	constant HOSTMTY_EN : boolean :=
+		hostmty and (not hwsecure) and ww <= axi32or64;
+
+	-- 'TRNGEXP_EN'
+	--
+	-- TRUE when the export of random words to software requested by parameter
+	-- 'trngexport' (see ecc_customize.vhd) can actually be implemented: one
+	-- 'ww'-bit word is served per read of R_TRNG_DATA register, hence 'ww'
+	-- must not exceed the width of the AXI data bus. It is never implemented
+	-- in HW secure mode, as the words come from the FIFO which masks the
+	-- scalar
+	constant TRNGEXP_EN : boolean :=
+		trngexport and (not hwsecure) and ww <= axi32or64;
+
 	-- 'W_BITS'
 	--
 	-- denotes the number of bits required to encode a counter from 0 to w - 1
@@ -125,6 +156,8 @@ package ecc_pkg is
 		rnd : std_logic;
 		xxor : std_logic;
 		redc : std_logic;
+		-- extra flag for FPREDC instruction (FPSQR variant, operand b ignored)
+		sqr : std_logic;
 		extended : std_logic;
 		par : std_logic;
 		div2 : std_logic;
@@ -166,6 +199,10 @@ package ecc_pkg is
 	constant CST_ADDR_YR1 : stdop := std_nat(LARGE_NB_YR1_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_ZR01 : stdop := std_nat(LARGE_NB_ZR01_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_R : stdop := std_nat(LARGE_NB_R_ADDR, FP_ADDR_MSB);
+	constant CST_ADDR_RMODP : stdop := std_nat(LARGE_NB_RMODP_ADDR, FP_ADDR_MSB);
+	constant CST_ADDR_R2MODP : stdop := std_nat(LARGE_NB_R2MODP_ADDR, FP_ADDR_MSB);
+	constant CST_ADDR_TWOP : stdop := std_nat(LARGE_NB_TWOP_ADDR, FP_ADDR_MSB);
+	constant CST_ADDR_INVERSE : stdop := std_nat(LARGE_NB_INVERSE_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_ONE : stdop := std_nat(LARGE_NB_ONE_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_ZERO : stdop := std_nat(LARGE_NB_ZERO_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_XR0BK : stdop := std_nat(LARGE_NB_XR0BK_ADDR, FP_ADDR_MSB);
@@ -242,6 +279,7 @@ package ecc_pkg is
 	constant OPCODE_ARITH_RNH : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1100";
 	constant OPCODE_ARITH_RNF : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1101";
 	constant OPCODE_ARITH_SRH : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1110";
+	constant OPCODE_ARITH_SQR : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1111";
 
 	-- constant for the conditional test branchs (field OPCODE of the opcode word)
 	constant OPCODE_BRA_B : std_logic_vector(OP_OP_SZ - 1 downto 0) := "0001";
@@ -352,6 +390,7 @@ package ecc_pkg is
 		xy : std_logic_vector(ww - 1 downto 0);
 		xen : std_logic;
 		yen : std_logic;
+		sqr : std_logic;
 		go : std_logic;
 		zren : std_logic;
 		irq_ack : std_logic;
@@ -71,6 +71,7 @@ entity ecc_scalar is
 		--   Montgomery constants computation
 		agocstmty : in std_logic;
 		mtydone : out std_logic;
+		redmode : in std_logic_vector(1 downto 0); -- see ecc_axi (s306)
 		--   constant 'a' Montgomery transform
 		agomtya : in std_logic;
 		amtydone : out std_logic;
@@ -318,6 +319,7 @@ architecture rtl of ecc_scalar is
 	--constant NOP_ROUTINE : natural := 32;
 	constant ZDBL_NOT_ALWAYS_ROUTINE : natural := 32;
 	constant ZADD_VOID_ROUTINE : natural := 33;
+	constant CONSTSOL_ROUTINE : natural := 34;
 
 	-- Address of the routines below (all constants whose name starts with
 	-- "ECC_IRAM_" (see below definition of array constant EXEC_ADDR) are
@@ -352,11 +354,12 @@ architecture rtl of ecc_scalar is
 	-- to be synthesized as a synchronous SRAM memory (either for FPGA or
 	-- ASIC target) should not take a big effort in modifying the RTL below
 	subtype std_logic_pc is std_logic_vector(IRAM_ADDR_SZ - 1 downto 0);
-	type exec_addr_type is array(0 to 33) of std_logic_pc;
+	type exec_addr_type is array(0 to 34) of std_logic_pc;
 	constant EXEC_ADDR : exec_addr_type := ( -- (s115)  --  matching routine:
 		CONSTMTY0_ROUTINE => ECC_IRAM_CONSTMTY0_ADDR,     -- .constMTY0L[_export]
 		CONSTMTY1_ROUTINE => ECC_IRAM_CONSTMTY1_ADDR,     -- .constMTY1L[_export]
 		CONSTMTY2_ROUTINE => ECC_IRAM_CONSTMTY2_ADDR,     -- .constMTY2L[_export]
+		CONSTSOL_ROUTINE => ECC_IRAM_CONSTSOL_ADDR,       -- .constSOLL[_export]
 		-- all routines used by [k]P computation
 		CHKCURVE_ROUTINE => ECC_IRAM_CHKCURVE_ADDR,       -- .chkcurveL[_export]
 		BLINDSTART_ROUTINE => ECC_IRAM_BLINDSTART_ADDR,   -- .blindstartL_[export]
@@ -428,7 +431,7 @@ begin
 	               swrst, first2pz, xmxz, ymyz, torsion2, kap, kapp,
 	               phimsb, kb0end, small_k_sz_en, small_k_sz_en_en, small_k_sz,
 	               gentoken, tokenact, zremaskact, zremaskbits,
-	               not_always_add, dbgtrngcompletebypass)
+	               not_always_add, dbgtrngcompletebypass, redmode)
 		variable v : reg_type;
 		variable v_simkb : integer;
 		variable v01z : std_logic_vector(1 downto 0);
@@ -478,6 +481,14 @@ begin
 				v.int.ardy := '0';
 				v.int.faddr := EXEC_ADDR(CONSTMTY0_ROUTINE);
 				v.mty.step := "00";
+				-- (s127) in Solinas reduction mode (see ecc_axi (s306)) there is
+				-- neither R nor p' to compute: the one routine .constSOLL sets
+				-- R2modp & Rmodp to 1, and its completion directly ends the
+				-- sequence (as for the last step of the Montgomery one)
+				if redmode /= "00" then
+					v.int.faddr := EXEC_ADDR(CONSTSOL_ROUTINE);
+					v.mty.step := "10";
+				end if;
 				v.int.fgo := '1'; -- (s69), see (s67)
 				v.mty.computing := '1';
 				v.mty.computing_a := '0';
@@ -58,7 +58,14 @@ package ecc_software is
 	constant W_ERR_ACK : rat := std_nat(10, ADB);            -- 0x050
 	constant W_SMALL_SCALAR : rat := std_nat(11, ADB);       -- 0x058
 	constant W_SOFT_RESET : rat := std_nat(12, ADB);         -- 0x060
-	-- reserved                                              -- 0x060...0x0f8
+	constant W_CMDQ_OP : rat := std_nat(13, ADB);            -- 0x068
+	constant W_CMDQ_PUSH : rat := std_nat(14, ADB);          -- 0x070
+	constant W_CMDQ_CTRL : rat := std_nat(15, ADB);          -- 0x078
+	constant W_CURVE_SELECT : rat := std_nat(16, ADB);       -- 0x080
+	constant W_FASTRED : rat := std_nat(17, ADB);            -- 0x088
+	constant W_MTYCST : rat := std_nat(18, ADB);             -- 0x090
+	constant W_MTYCST_DATA : rat := std_nat(19, ADB);        -- 0x098
+	-- reserved                                              -- 0x0a0...0x0f8
 	-- (0x100: start of write HW unsecure/SCA features registers)
 	constant W_DBG_HALT : rat := std_nat(32, ADB);           -- 0x100
 	constant W_DBG_BKPT : rat := std_nat(33, ADB);           -- 0x108
@@ -68,6 +75,8 @@ package ecc_software is
 	constant W_DBG_TRIG_DOWN : rat := std_nat(37, ADB);      -- 0x128
 	constant W_DBG_OP_WADDR : rat := std_nat(38, ADB);       -- 0x130
 	constant W_DBG_OPCODE : rat := std_nat(39, ADB);         -- 0x138
+	-- (with top-level ecc_multi, W_DBG_TRNG_CFG, *_RESET, *_CTRL_POSTP,
+	-- *_CTRL_BYPASS & *_RAW_READ only act from the register bank of engine 0)
 	constant W_DBG_TRNG_CFG : rat := std_nat(40, ADB);       -- 0x140
 	constant W_DBG_TRNG_RESET : rat := std_nat(41, ADB);     -- 0x148
 	constant W_DBG_TRNG_CTRL_POSTP : rat:= std_nat(42, ADB); -- 0x150
@@ -93,13 +102,23 @@ package ecc_software is
 	constant R_CAPABILITIES : rat := std_nat(2, ADB);        -- 0x010
 	constant R_HW_VERSION : rat := std_nat(3, ADB);          -- 0x018
 	constant R_PRIME_SIZE : rat := std_nat(4, ADB);          -- 0x020
-	-- reserved                                              -- 0x028...0x0f8
+	constant R_CMDQ_STATUS : rat := std_nat(5, ADB);         -- 0x028
+	constant R_CMDQ_RESULT : rat := std_nat(6, ADB);         -- 0x030
+	constant R_CMDQ_IDLE : rat := std_nat(7, ADB);           -- 0x038
+	constant R_CURVE_STATUS : rat := std_nat(8, ADB);        -- 0x040
+	constant R_MTYCST : rat := std_nat(9, ADB);              -- 0x048
+	constant R_TRNG_STATUS : rat := std_nat(10, ADB);        -- 0x050
+	constant R_TRNG_DATA : rat := std_nat(11, ADB);          -- 0x058
+	-- reserved                                              -- 0x060...0x0f8
 	-- (0x100: start of read HW unsecure/SCA features registers)
 	constant R_DBG_CAPABILITIES_0 : rat := std_nat(32, ADB); -- 0x100
 	constant R_DBG_CAPABILITIES_1 : rat := std_nat(33, ADB); -- 0x108
 	constant R_DBG_CAPABILITIES_2 : rat := std_nat(34, ADB); -- 0x110
 	constant R_DBG_STATUS : rat := std_nat(35, ADB);         -- 0x118
 	constant R_DBG_TIME : rat := std_nat(36, ADB);           -- 0x120
+	-- (with top-level ecc_multi, R_DBG_TRNG_* registers below but *_DIAG_OK &
+	-- *_DIAG_STARV report the shared TRNG and are only meaningful in the
+	-- register bank of engine 0, see header of ecc_multi.vhd)
 	constant R_DBG_TRNG_RAWDUR : rat := std_nat(37, ADB);    -- 0x128
 	constant R_DBG_TRNG_STATUS : rat := std_nat(38, ADB);    -- 0x130
 	constant R_DBG_TRNG_RAW_DATA : rat := std_nat(39, ADB);  -- 0x138
@@ -123,6 +142,22 @@ package ecc_software is
 	-- Read-only register
 	constant PSEUDOTRNG_R_FIFO_COUNT : std_logic := '0';     -- 0x00
 
+	-- Register bank of the DMA engine of top-level 'ecc_dma' (mapped at
+	-- offset 2**AXIAW = 0x200 from base address of the IP, see ecc_dma.vhd)
+	-- Write registers
+	constant DMA_W_CTRL : rat := std_nat(0, ADB);            -- 0x200
+	constant DMA_W_RING_BASE : rat := std_nat(1, ADB);       -- 0x208
+	constant DMA_W_RING_LOG : rat := std_nat(2, ADB);        -- 0x210
+	constant DMA_W_TAIL : rat := std_nat(3, ADB);            -- 0x218
+	constant DMA_W_IRQ_ACK : rat := std_nat(4, ADB);         -- 0x220
+	-- Read registers
+	constant DMA_R_CTRL : rat := std_nat(0, ADB);            -- 0x200
+	constant DMA_R_RING_BASE : rat := std_nat(1, ADB);       -- 0x208
+	constant DMA_R_RING_LOG : rat := std_nat(2, ADB);        -- 0x210
+	constant DMA_R_TAIL : rat := std_nat(3, ADB);            -- 0x218
+	constant DMA_R_STATUS : rat := std_nat(4, ADB);          -- 0x220
+	constant DMA_R_HEAD : rat := std_nat(5, ADB);            -- 0x228
+
 	-- ----------------------------------------------
 	-- bit positions / fields in write registers
 	-- ----------------------------------------------
@@ -140,7 +175,7 @@ package ecc_software is
 	constant CTRL_WRITE_NB : natural := 16;
 	constant CTRL_READ_NB : natural := 17;
 	constant CTRL_WRITE_K : natural := 18;
-	-- bit 19 reserved
+	constant CTRL_AXIS : natural := 19;
 	constant CTRL_NBADDR_LSB : natural := 20;
 	constant CTRL_NBADDR_SZ : natural := 12;
 	constant CTRL_NBADDR_MSB : natural := CTRL_NBADDR_LSB + CTRL_NBADDR_SZ - 1;
@@ -173,6 +208,74 @@ package ecc_software is
 	constant PMSZ_VALNN_SZ : natural := log2(nn);
 	constant PMSZ_VALNN_MSB : natural := PMSZ_VALNN_LSB + PMSZ_VALNN_SZ - 1;
 
+	-- bit positions in W_CMDQ_OP register
+	constant CMDQ_OP_REG_LSB : natural := 0;
+	constant CMDQ_OP_REG_MSB : natural := ADB - 1;
+	constant CMDQ_OP_KIND_LSB : natural := 8;
+	constant CMDQ_OP_KIND_MSB : natural := 9;
+	-- values of the CMDQ_OP_KIND field
+	constant CMDQ_KIND_WRITE : std_logic_vector(1 downto 0) := "00";
+	constant CMDQ_KIND_READ : std_logic_vector(1 downto 0) := "01";
+	constant CMDQ_KIND_DONE : std_logic_vector(1 downto 0) := "10";
+
+	-- bit positions in W_CMDQ_CTRL register
+	constant CMDQ_CTRL_EN : natural := 0;
+	constant CMDQ_CTRL_FLUSH : natural := 4;
+	constant CMDQ_CTRL_IRQ_LSB : natural := 16;
+	constant CMDQ_CTRL_IRQ_MSB : natural := 31;
+
+	-- bit positions in W_CURVE_SELECT register
+	constant CURVE_SEL_SLOT_LSB : natural := 0;
+	constant CURVE_SEL_SLOT_MSB : natural := 3;
+	constant CURVE_SEL_LOAD : natural := 8;
+
+	-- bit positions in W_FASTRED register
+	constant FASTRED_MODE_LSB : natural := 0;
+	constant FASTRED_MODE_MSB : natural := 1;
+	-- values of the FASTRED_MODE field
+	constant FASTRED_NONE : std_logic_vector(1 downto 0) := "00";
+	constant FASTRED_P256 : std_logic_vector(1 downto 0) := "01";
+	constant FASTRED_P384 : std_logic_vector(1 downto 0) := "10";
+
+	-- bit positions in W_MTYCST register
+	constant MTYCST_NB_LSB : natural := 0;
+	constant MTYCST_NB_MSB : natural := 1;
+	-- values of the MTYCST_NB field
+	constant MTYCST_R2MODP : std_logic_vector(1 downto 0) := "00";
+	constant MTYCST_TWOP : std_logic_vector(1 downto 0) := "01";
+	constant MTYCST_RMODP : std_logic_vector(1 downto 0) := "10";
+	constant MTYCST_PPRIME : std_logic_vector(1 downto 0) := "11";
+
+	-- bit positions in DMA_W_CTRL register (ecc_dma only)
+	constant DMA_CTRL_EN : natural := 0;
+	constant DMA_CTRL_IRQ_LSB : natural := 16;
+	constant DMA_CTRL_IRQ_MSB : natural := 31;
+
+	-- bit positions in DMA_W_RING_LOG register (ecc_dma only)
+	constant DMA_RING_LOG_LSB : natural := 0;
+	constant DMA_RING_LOG_MSB : natural := 3;
+
+	-- fields of the job descriptors fetched by ecc_dma from external memory
+	-- (each descriptor is made of DMA_DESC_WORDS words of C_S_AXI_DATA_WIDTH
+	-- bits, of which only the least significant 32 bits are meaningful)
+	constant DMA_DESC_WORDS : positive := 8;
+	--   index of words
+	constant DMA_DESC_CTRL : natural := 0;
+	constant DMA_DESC_K : natural := 1;
+	constant DMA_DESC_P0 : natural := 2;
+	constant DMA_DESC_P1 : natural := 3;
+	constant DMA_DESC_RES : natural := 4;
+	constant DMA_DESC_TAG : natural := 5;
+	--   bit positions in word DMA_DESC_CTRL (the OP field holds the position
+	--   of the command bit in W_CTRL, i.e CTRL_KP, CTRL_PT_ADD, etc)
+	constant DMA_DESC_OP_LSB : natural := 0;
+	constant DMA_DESC_OP_MSB : natural := 2;
+	constant DMA_DESC_R0_NULL : natural := 8;
+	constant DMA_DESC_R1_NULL : natural := 9;
+	constant DMA_DESC_CURVE_LSB : natural := 16;
+	constant DMA_DESC_CURVE_MSB : natural := 23;
+	constant DMA_DESC_DONE : natural := 31;
+
 	-- bit positions in W_DBG_HALT register
 	constant DBG_HALT : natural := 0;
 
@@ -265,6 +368,8 @@ package ecc_software is
 	-- ----------------------------------------------
 	-- bit positions in R_STATUS register (AXI interface w/ software)
 	constant STATUS_BUSY : natural := 0;
+	constant STATUS_CMDQ : natural := 1;
+	constant STATUS_MTYOVL : natural := 2;
 	constant STATUS_KP : natural := 4;
 	constant STATUS_MTY : natural := 5;
 	constant STATUS_POP : natural := 6;
@@ -297,17 +402,59 @@ package ecc_software is
 	constant STATUS_ERR_I_LSB : natural := STATUS_ERR_LSB + 2;
 	constant STATUS_ERR_I_MSB : natural := STATUS_ERR_MSB;
 
+	-- bit positions in DMA_R_STATUS register (ecc_dma only)
+	constant DMA_ST_ACTIVE : natural := 0;
+	constant DMA_ST_IRQ : natural := 1;
+	constant DMA_ST_BUSERR : natural := 2;
+	constant DMA_ST_DONE_LSB : natural := 16;
+	constant DMA_ST_DONE_MSB : natural := 31;
+
 	-- bit positions in R_CAPABILITIES register
 	constant CAP_DBG_N_PROD : natural := 0;
+	constant CAP_MTYOVL : natural := 1;
+	constant CAP_HOSTMTY : natural := 2;
+	constant CAP_FASTRED : natural := 3;
 	constant CAP_SHF : natural := 4;
+	constant CAP_CMDQ : natural := 5;
+	constant CAP_AXIS : natural := 6;
+	constant CAP_CTX : natural := 7;
 	constant CAP_NNDYN : natural := 8;
 	constant CAP_W64 : natural := 9;
+	constant CAP_TRNGEXP : natural := 10;
 	constant CAP_NNMAX_LSB : natural := 12;
 	constant CAP_NNMAX_MSB : natural := CAP_NNMAX_LSB + log2(nn) - 1;
 
 	-- bit positions in R_PRIME_SIZE
 	--   (same definitions as for W_PRIME_SIZE register, see above)
 
+	-- bit positions in R_CMDQ_STATUS register
+	constant CMDQ_ST_FREE_LSB : natural := 0;
+	constant CMDQ_ST_FREE_MSB : natural := 15;
+	constant CMDQ_ST_RES_LSB : natural := 16;
+	constant CMDQ_ST_RES_MSB : natural := 31;
+
+	-- bit positions in R_CURVE_STATUS register
+	constant CURVE_ST_VALID_LSB : natural := 0;
+	constant CURVE_ST_VALID_MSB : natural := 15;
+	constant CURVE_ST_CUR_LSB : natural := 16;
+	constant CURVE_ST_CUR_MSB : natural := 19;
+	constant CURVE_ST_BOUND : natural := 20;
+	constant CURVE_ST_NB_LSB : natural := 24;
+	constant CURVE_ST_NB_MSB : natural := 28;
+
+	-- bit positions in R_MTYCST register
+	constant MTYCST_ST_WW_LSB : natural := 0;
+	constant MTYCST_ST_WW_MSB : natural := 7;
+	constant MTYCST_ST_SEEN_LSB : natural := 8;
+	constant MTYCST_ST_SEEN_MSB : natural := 11;
+	constant MTYCST_ST_ARMED : natural := 12;
+
+	-- bit positions in R_TRNG_STATUS register
+	constant TRNG_ST_CNT_LSB : natural := 0;
+	constant TRNG_ST_CNT_MSB : natural := 23;
+	constant TRNG_ST_WW_LSB : natural := 24;
+	constant TRNG_ST_WW_MSB : natural := 31;
+
 	-- bit positions in R_HW_VERSION
 	constant HW_VERSION_MAJ_LSB : natural := 24;
 	constant HW_VERSION_MAJ_MSB : natural := 31;
@@ -0,0 +1,112 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_log.all; -- for log2()
+
+-- Fan-out of one client channel of ecc_trng_srv to 'nbclients' consumers
+-- of the same kind (used by ecc_multi.vhd to share one ecc_trng between
+-- several [k]P engines).
+--
+-- The upstream channel is granted in round-robin to the consumers which
+-- currently assert their 'rdy' signal, so that each random word served by
+-- ecc_trng_srv is consumed by exactly one engine (random words are never
+-- duplicated between engines). Data bus is broadcast to all consumers and
+-- only qualified by the one-hot 'valido' vector.
+
+entity ecc_trng_fanout is
+	generic(
+		datawidth : positive;
+		nbclients : positive);
+	port(
+		clk : in std_logic;
+		rstn : in std_logic;
+		swrst : in std_logic;
+		-- interface with ecc_trng_srv (upstream)
+		rdy : out std_logic;
+		valid : in std_logic;
+		data : in std_logic_vector(datawidth - 1 downto 0);
+		-- interface with the consumers (downstream)
+		rdyi : in std_logic_vector(nbclients - 1 downto 0);
+		valido : out std_logic_vector(nbclients - 1 downto 0);
+		datao : out std_logic_vector(nbclients*datawidth - 1 downto 0)
+	);
+end entity ecc_trng_fanout;
+
+architecture rtl of ecc_trng_fanout is
+
+	type reg_type is record
+		sel : unsigned(log2(nbclients - 1) - 1 downto 0);
+	end record;
+
+	signal r, rin : reg_type;
+
+begin
+
+	comb: process(r, rstn, swrst, valid, rdyi)
+		variable v : reg_type;
+		variable v_next : natural range 0 to nbclients - 1;
+		variable v_found : boolean;
+	begin
+		v := r;
+
+		-- the grant moves on to the next requesting consumer (in round-robin
+		-- order) either once the current one has been served a word, or as
+		-- soon as the current one no longer requests any
+		if (valid = '1' and rdyi(to_integer(r.sel)) = '1')
+			or rdyi(to_integer(r.sel)) = '0'
+		then
+			v_found := FALSE;
+			v_next := to_integer(r.sel);
+			for i in 1 to nbclients loop
+				if not v_found and
+					rdyi((to_integer(r.sel) + i) mod nbclients) = '1'
+				then
+					v_found := TRUE;
+					v_next := (to_integer(r.sel) + i) mod nbclients;
+				end if;
+			end loop;
+			v.sel := to_unsigned(v_next, log2(nbclients - 1));
+		end if;
+
+		-- synchronous reset
+		if rstn = '0' or swrst = '1' then
+			v.sel := (others => '0');
+		end if;
+
+		rin <= v;
+	end process comb;
+
+	regs: process(clk)
+	begin
+		if clk'event and clk = '1' then
+			r <= rin;
+		end if;
+	end process regs;
+
+	-- -------------
+	-- drive outputs
+	-- -------------
+	rdy <= rdyi(to_integer(r.sel));
+
+	o0: for i in 0 to nbclients - 1 generate
+		valido(i) <= valid when to_integer(r.sel) = i else '0';
+		datao(((i + 1) * datawidth) - 1 downto i * datawidth) <= data;
+	end generate;
+
+end architecture rtl;
@@ -31,6 +31,10 @@ use std.textio.all;
 -- cryptographic preprocessing - instead it only reformats bytes received
 -- from the entropy source (es_trng) into words of 'pp_irn_width' bits
 -- (generic parameter that should typically be set to 32 or 64 bits).
+--
+-- Optionally (parameter 'trngdrbg' in ecc_customize) these words are not
+-- driven out but used to (re)seed a ChaCha20 keystream generator, the
+-- output of which is then served to ecc_trng_srv (see (s0) below).
 
 entity ecc_trng_pp is
 	port(
@@ -58,6 +62,71 @@ end entity ecc_trng_pp;
 
 architecture rtl of ecc_trng_pp is
 
+	-- (s0) DRBG expander: a ChaCha20 block function (20 rounds, 256-bit key,
+	-- 64-bit block counter, null nonce) computed one half quarter-round per
+	-- cycle on the first column of the state, the rows of which are rotated
+	-- after each quarter-round (so that the 4 columns - or the 4 diagonals,
+	-- once the rows have been shifted - are processed in turn without any
+	-- multiplexer). A block (16 words of 32 bits) takes 160 + 1 cycles.
+	-- Every 8 raw words collected from the entropy source are XORed into the
+	-- key in-between two blocks, and no more than 'trngdrbg_reseed' blocks
+	-- are generated with the same key.
+	constant DRBG_EN : boolean := trngdrbg and pp_irn_width = 32;
+
+	subtype word32 is unsigned(31 downto 0);
+	type w16_type is array(0 to 15) of word32;
+	type w8_type is array(0 to 7) of word32;
+	type drbg_state_type is (idle, round, fin, output);
+
+	type drbg_reg_type is record
+		state : drbg_state_type;
+		key : w8_type;
+		seed : w8_type;
+		seedcnt : unsigned(3 downto 0);
+		seeded : std_logic;
+		ctr : unsigned(63 downto 0);
+		x : w16_type;
+		-- half quarter-round (0 to 159)
+		step : unsigned(7 downto 0);
+		oidx : unsigned(3 downto 0);
+		blocks : unsigned(log2(trngdrbg_reseed) - 1 downto 0); -- 0 to reseed
+		valid : std_logic;
+	end record;
+
+	-- initial state of the block function
+	function drbg_init(key : w8_type; ctr : unsigned(63 downto 0))
+		return w16_type is
+		variable x : w16_type;
+	begin
+		x(0) := x"61707865"; -- "expand 32-byte k"
+		x(1) := x"3320646e";
+		x(2) := x"79622d32";
+		x(3) := x"6b206574";
+		for i in 0 to 7 loop
+			x(4 + i) := key(i);
+		end loop;
+		x(12) := ctr(31 downto 0);
+		x(13) := ctr(63 downto 32);
+		x(14) := (others => '0');
+		x(15) := (others => '0');
+		return x;
+	end function drbg_init;
+
+	-- row 0 of the state rotated to the left by one word, row k (k > 0)
+	-- by sk words
+	function drbg_rows(x : w16_type; s1, s2, s3 : natural)
+		return w16_type is
+		variable y : w16_type;
+	begin
+		for j in 0 to 3 loop
+			y(j) := x((j + 1) mod 4);
+			y(4 + j) := x(4 + ((j + s1) mod 4));
+			y(8 + j) := x(8 + ((j + s2) mod 4));
+			y(12 + j) := x(12 + ((j + s3) mod 4));
+		end loop;
+		return y;
+	end function drbg_rows;
+
 	type reg_type is record
 		rdy_t : std_logic;
 		shdata8 : std_logic_vector(7 downto 0);
@@ -71,6 +140,8 @@ architecture rtl of ecc_trng_pp is
 		pseudo_rdy : std_logic;
 		usepstprev : std_logic;
 		raw_pull_inactive : std_logic;
+		-- DRBG expander
+		drbg : drbg_reg_type;
 	end record;
 
 	signal r, rin : reg_type;
@@ -81,6 +152,8 @@ begin
 		            dbgtrngrawpullppdis, dbgtrngusepseudosource,
 		            dbgpseudotrngdata, dbgpseudotrngvalid)
 		variable v : reg_type;
+		variable v_rawrdy : std_logic;
+		variable v_a, v_b, v_c, v_d : word32;
 	begin
 		v := r;
 
@@ -135,11 +208,113 @@ begin
 			end if;
 		end if;
 
-		-- valid_s/rdy_s handshake
-		if rdy_s = '1' and r.valid_s = '1' then
+		-- valid_s/rdy_s handshake (with the DRBG expander, raw words are
+		-- consumed as seed, see (s0))
+		if DRBG_EN then -- statically resolved by synthesizer
+			if r.drbg.seedcnt(3) = '0' then
+				v_rawrdy := '1';
+			else
+				v_rawrdy := '0';
+			end if;
+		else
+			v_rawrdy := rdy_s;
+		end if;
+		if v_rawrdy = '1' and r.valid_s = '1' then
 			v.valid_s := '0';
 			v.shcnti := (others => '0');
 			v.shicanbewritten := '1';
+			if DRBG_EN then -- statically resolved by synthesizer
+				v.drbg.seed(to_integer(r.drbg.seedcnt(2 downto 0))) :=
+					unsigned(r.shdatai);
+				v.drbg.seedcnt := r.drbg.seedcnt + 1;
+			end if;
+		end if;
+
+		-- DRBG expander (see (s0))
+		if DRBG_EN then -- statically resolved by synthesizer
+			case r.drbg.state is
+				when idle =>
+					-- (re)seeding, in-between two blocks
+					if r.drbg.seedcnt(3) = '1' then
+						for i in 0 to 7 loop
+							if r.drbg.seeded = '1' then
+								v.drbg.key(i) := r.drbg.key(i) xor r.drbg.seed(i);
+							else
+								v.drbg.key(i) := r.drbg.seed(i);
+							end if;
+						end loop;
+						v.drbg.seedcnt := (others => '0');
+						v.drbg.seeded := '1';
+						v.drbg.blocks := (others => '0');
+					elsif r.drbg.seeded = '1'
+						and r.drbg.blocks /= to_unsigned(trngdrbg_reseed,
+							log2(trngdrbg_reseed))
+					then
+						v.drbg.x := drbg_init(r.drbg.key, r.drbg.ctr);
+						v.drbg.step := (others => '0');
+						v.drbg.state := round;
+					end if;
+				when round =>
+					-- half quarter-round on column 0: (a, b, c, d) = (x0, x4, x8, x12)
+					v_a := r.drbg.x(0);
+					v_b := r.drbg.x(4);
+					v_c := r.drbg.x(8);
+					v_d := r.drbg.x(12);
+					v_a := v_a + v_b;
+					v_d := v_d xor v_a;
+					if r.drbg.step(0) = '0' then
+						v_d := rotate_left(v_d, 16);
+					else
+						v_d := rotate_left(v_d, 8);
+					end if;
+					v_c := v_c + v_d;
+					v_b := v_b xor v_c;
+					if r.drbg.step(0) = '0' then
+						v_b := rotate_left(v_b, 12);
+					else
+						v_b := rotate_left(v_b, 7);
+					end if;
+					v.drbg.x(0) := v_a;
+					v.drbg.x(4) := v_b;
+					v.drbg.x(8) := v_c;
+					v.drbg.x(12) := v_d;
+					if r.drbg.step(0) = '1' then
+						-- end of quarter-round: next column comes first, and at the
+						-- end of a column (resp. diagonal) round the rows are also
+						-- shifted so that diagonals (resp. columns) come next
+						if r.drbg.step(2 downto 1) /= "11" then
+							v.drbg.x := drbg_rows(v.drbg.x, 1, 1, 1);
+						elsif r.drbg.step(3) = '0' then
+							v.drbg.x := drbg_rows(v.drbg.x, 2, 3, 0);
+						else
+							v.drbg.x := drbg_rows(v.drbg.x, 0, 3, 2);
+						end if;
+					end if;
+					v.drbg.step := r.drbg.step + 1;
+					if r.drbg.step = to_unsigned(159, 8) then
+						v.drbg.state := fin;
+					end if;
+				when fin =>
+					v.drbg.x := drbg_init(r.drbg.key, r.drbg.ctr);
+					for i in 0 to 15 loop
+						v.drbg.x(i) := r.drbg.x(i) + v.drbg.x(i);
+					end loop;
+					v.drbg.ctr := r.drbg.ctr + 1;
+					v.drbg.blocks := r.drbg.blocks + 1;
+					v.drbg.oidx := (others => '0');
+					v.drbg.valid := '1';
+					v.drbg.state := output;
+				when output =>
+					-- valid_s/rdy_s handshake, words are driven out from x0
+					if rdy_s = '1' and r.drbg.valid = '1' then
+						v.drbg.x := r.drbg.x(1 to 15) & r.drbg.x(0);
+						v.drbg.oidx := r.drbg.oidx + 1;
+						if r.drbg.oidx = "1111" then
+							v.drbg.valid := '0';
+							v.drbg.state := idle;
+						end if;
+					end if;
+			end case;
 		end if;
 
 		-- Switch from one state to the other (real to pseudo or pseudo to real).
@@ -219,6 +394,12 @@ begin
 			v.shcnt8 := (others => '0');
 			v.shcnti := (others => '0');
 			v.valid_s := '0';
+			v.drbg.state := idle;
+			v.drbg.seedcnt := (others => '0');
+			v.drbg.seeded := '0';
+			v.drbg.ctr := (others => '0');
+			v.drbg.blocks := (others => '0');
+			v.drbg.valid := '0';
 		end if;
 
 		rin <= v;
@@ -233,8 +414,16 @@ begin
 
 	-- drive outputs
 	rdy_t <= r.rdy_t;
-	valid_s <= r.valid_s;
-	data_s <= r.shdatai;
+
+	d0: if not DRBG_EN generate -- statically resolved by synthesizer
+		valid_s <= r.valid_s;
+		data_s <= r.shdatai;
+	end generate;
+
+	d1: if DRBG_EN generate -- statically resolved by synthesizer
+		valid_s <= r.drbg.valid;
+		data_s <= std_logic_vector(r.drbg.x(0));
+	end generate;
 
 	-- handshake with pseudo TRNG external device
 	dbgpseudotrngrdy <= r.pseudo_rdy;
@@ -40,6 +40,9 @@ entity mm_ndsp is
 		xyin : in std_logic_vector(ww - 1 downto 0);
 		xen : in std_logic;
 		yen : in std_logic;
+		-- squaring: y_i terms are not input, the x_i ones are used instead
+		-- (must be stable from the 1st x_i term until computation starts)
+		sqr : in std_logic;
 		fpwdata : in std_logic_vector(ww - 1 downto 0);
 		fpwe : in std_logic;
 		pen : in std_logic;
@@ -436,6 +439,7 @@ architecture rtl of mm_ndsp is
 		active : std_logic;
 		state : state_type;
 		ioforbid : std_logic;
+		sqr : std_logic;
 	end record;
 
 	-- registered signals for final output (result) barrel-shifter
@@ -947,7 +951,7 @@ begin
 	--          combinational process (clk0 clock-domain)
 	-- -----------------------------------------------------------------
 	comb : process(r, rst22, go,
-	               xyin, xen, yen, ppen, fpwdata, fpwe, pen, zren,
+	               xyin, xen, yen, sqr, ppen, fpwdata, fpwe, pen, zren,
 	               irq_ack, r_oram_rdata, r_tram_rdata, r_iram_rdata,
 	               r_pram_rdata, dsp_p,
 	               nndyn_mask, nndyn_shrcnt, nndyn_shlcnt, nndyn_w, nndyn_wm1,
@@ -976,6 +980,7 @@ begin
 		variable v_acc_tobenext : std_logic;
 		variable v_prod_nextxmsbraddr : std_logic_vector(2 downto 0);
 		variable v_prod_nextymsbraddr : std_logic_vector(2 downto 0);
+		variable v_prod_yoramaddr : std_logic_vector(2 downto 0);
 		variable v_prod_nextslkstep : unsigned(log2(div(w, ndsp)) - 1 downto 0);
 		--variable vtmp_12, vtmp_13, vtmp_14 : unsigned(log2(w) downto 0);
 	begin
@@ -1558,6 +1563,13 @@ begin
 		-- ------------------------------------------------------------------
 		-- CHECKED OK: v_prod_nextxmsbraddr always set: no LATCH should be inferred
 		-- CHECKED OK: v_prod_nextymsbraddr always set: no LATCH should be inferred
+		-- (s166) in the squaring case (FPSQR) the y_i terms are the x_i ones,
+		-- which were the only ones transferred into ORAM (or IRAM)
+		if r.ctrl.sqr = '1' then
+			v_prod_yoramaddr := X_ORAM_ADDR;
+		else
+			v_prod_yoramaddr := Y_ORAM_ADDR;
+		end if;
 		v_prod_nextxmsbraddr := (others => '0'); -- TO AVOID INFERENCE
 		v_prod_nextymsbraddr := (others => '0'); -- OF ERRONOUS LATCH
 		case r.ctrl.state is
@@ -1565,17 +1577,17 @@ begin
 			when idle =>
 
 				v_prod_nextxmsbraddr := X_ORAM_ADDR;
-				v_prod_nextymsbraddr := Y_ORAM_ADDR;
+				v_prod_nextymsbraddr := v_prod_yoramaddr;
 
 			when xy =>
 
 				if v_prod_tobenext = '1' then
 					v_prod_nextxmsbraddr := X_ORAM_ADDR;
-					v_prod_nextymsbraddr := Y_ORAM_ADDR;
+					v_prod_nextymsbraddr := v_prod_yoramaddr;
 				elsif v_prod_tobenext = '0' then
 					if r.prod.nextxymsb = '0' then
 						v_prod_nextxmsbraddr := X_ORAM_ADDR;
-						v_prod_nextymsbraddr := Y_ORAM_ADDR;
+						v_prod_nextymsbraddr := v_prod_yoramaddr;
 					elsif r.prod.nextxymsb = '1' then
 						v_prod_nextxmsbraddr := S_ORAM_ADDR;
 						v_prod_nextymsbraddr := PP_ORAM_ADDR;
@@ -1608,7 +1620,7 @@ begin
 						v_prod_nextymsbraddr := P_ORAM_ADDR;
 					elsif r.prod.nextxymsb = '1' then
 						v_prod_nextxmsbraddr := X_ORAM_ADDR;
-						v_prod_nextymsbraddr := Y_ORAM_ADDR;
+						v_prod_nextymsbraddr := v_prod_yoramaddr;
 					end if;
 				end if;
 
@@ -1627,6 +1639,7 @@ begin
 			v.ctrl.state := xy;
 			v.prod.state := mult;
 			v.ctrl.rdy := '0';
+			v.ctrl.sqr := sqr; -- see (s166)
 			-- pragma translate_off
 			v.simcnt := (others => '0');
 			-- pragma translate_on
@@ -2949,6 +2962,7 @@ begin
 			v.ctrl.rdy := '1';
 			v.ctrl.active := '0';
 			v.ctrl.irq := '0';
+			v.ctrl.sqr := '0';
 			if async then
 				v.ctrl.ioforbid := '0'; -- I/O access is allowed after reset
 			end if;
@@ -0,0 +1,841 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all; -- for 'ww' & others
+use work.mm_ndsp_pkg.all; -- for 'ndsp'
+
+-- Multi-chain (column-parallel) Montgomery multiplier.
+--
+-- This is a drop-in replacement for mm_ndsp (same ports plus 'redmode',
+-- same protocol towards ecc_fp & ecc_axi) which is instanciated by ecc_core
+-- instead of mm_ndsp when parameter 'nbchain' (see ecc_customize.vhd) is
+-- not 0.
+--
+-- Where mm_ndsp pushes all 'ndsp' MACC blocks into one single chain that
+-- scans the operands row by row (operand scanning), the present block splits
+-- them into 'nbchain' shorter chains of CHL = ndsp / nbchain blocks each
+-- and computes the products column by column (product scanning): all the
+-- chains work in parallel, each one on its own column of partial products,
+-- and the column sums they produce are then merged (i.e their carries are
+-- propagated) by a single carry-merge stage, one column per cycle.
+--
+--        columns:  base+NCH-1  ...  base+1   base
+--                      |              |        |
+--                  +-------+      +-------+ +-------+
+--                  |chain  | ...  |chain  | |chain  |   <- CHL partial
+--                  |NCH-1  |      |  1    | |  0    |      products
+--                  +-------+      +-------+ +-------+      per cycle each
+--                      |              |        |
+--                  +---------------------------------+
+--                  |  carry-merge (1 column / cycle) | <- + carry, + s_k
+--                  +---------------------------------+
+--
+-- A "batch" is a set of NCH consecutive columns, processed by the NCH
+-- chains at the same time. The carry-merge of a batch overlaps with the
+-- computation of the next one: this is enforced by having any batch last
+-- at least NCH cycles, see (s3).
+--
+-- As in mm_ndsp, one REDC operation is made of 3 phases (xy, sp & ap, see
+-- the ASCII art at the begining of mm_ndsp.vhd):
+--
+--   xy:  s = x * y                  (columns 0 to 2w - 1)
+--   sp:  alpha = (s * p') mod R     (columns 0 to q, with q = nndyn_wmin)
+--   ap:  z = (s + alpha * p) / R    (columns 0 to q + w)
+--
+-- with R = 2**(nn + 2). Phase sp only computes the columns of weight lower
+-- than R, the alpha_q term being masked using input 'nndyn_mask', see (s6).
+-- Phase ap only keeps columns of weight greater than or equal to R, shifted
+-- to the right by 'nndyn_shrcnt' bits on the fly, see (s7).
+--
+-- Operands & intermediate terms are held in register arrays (and not in
+-- SRAM blocks as in mm_ndsp) so that all the chains can get their operand
+-- terms in the same cycle. This costs logic (one w:1 multiplexer per DSP
+-- block input) but removes the SRAM read latencies from the critical loop,
+-- along with all the "slack" logic of mm_ndsp.
+--
+-- When the Solinas reduction mode is selected by input 'redmode' (see
+-- parameter 'fastred' in ecc_customize.vhd & register W_FASTRED), phases
+-- sp & ap are replaced with phase fd which folds the 32-bit words S_i of
+-- s = x * y into K = 8 (P-256) or K = 12 (P-384) words, using the special
+-- form of the prime:
+--
+--   fd:  z = sum over i of coef(j, i) * S_i * 2**(32j)  (mod p)
+--
+-- with small signed constant coefficients coef(j, i) (-4 to 5), see (s8).
+-- The result is lower than 2**(32K), hence than 2p, as with REDC.
+--
+-- Only the synchronous case (async = FALSE) is supported.
+
+entity mm_ndsp_mc is
+	port(
+		clkmm : in std_logic;
+		clk : in std_logic;
+		rstn : in std_logic;
+		-- software reset
+		swrst : in std_logic;
+		go : in std_logic;
+		rdy : out std_logic;
+		-- input data
+		xyin : in std_logic_vector(ww - 1 downto 0);
+		xen : in std_logic;
+		yen : in std_logic;
+		-- squaring: y_i terms are not input, the x_i ones are used instead
+		-- (must be stable from the 1st x_i term until computation starts)
+		sqr : in std_logic;
+		fpwdata : in std_logic_vector(ww - 1 downto 0);
+		fpwe : in std_logic;
+		pen : in std_logic;
+		ppen : in std_logic;
+		-- signals used only when nn_dynamic = TRUE
+		-- (same interface as mm_ndsp, only some of them are actually used)
+		nndyn_mask : in std_logic_vector(ww - 1 downto 0);
+		nndyn_shrcnt : in unsigned(log2(ww) - 1 downto 0);
+		nndyn_shlcnt : in unsigned(log2(ww) - 1 downto 0);
+		nndyn_w : in unsigned(log2(w) - 1 downto 0);
+		nndyn_wm1 : in unsigned(log2(w - 1) - 1 downto 0);
+		nndyn_wm2 : in unsigned(log2(w - 1) - 1 downto 0);
+		nndyn_2wm1 : in unsigned(log2((2*w) - 1) - 1 downto 0);
+		nndyn_wmin : in unsigned(log2((2*w) - 1) - 1 downto 0);
+		nndyn_wmin_excp_val : in unsigned(log2(2*w - 1) - 1 downto 0);
+		nndyn_wmin_excp : in std_logic;
+		nndyn_mask_wm2 : in std_logic;
+		nndyn_w_less_eq_ndsp : in std_logic;
+		nndyn_w_less_ndsp : in std_logic;
+		nndyn_w_multiple_of_ndsp : in std_logic;
+		nndyn_w_div_ndsp_minus_one : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+		nndyn_w_div_ndsp : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+		nndyn_nb_bursts : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+		nndyn_slkpivot_0 : in signed(NB_SLK_BITS - 1 downto 0);
+		nndyn_slkpivot_0_larger_cstslk : in std_logic;
+		nndyn_slkpivot_1 : in signed(NB_SLK_BITS - 1 downto 0);
+		nndyn_slkpivot_1_larger_cstslk : in std_logic;
+		-- reduction mode: "00" = Montgomery, "01" = P-256, "10" = P-384
+		-- (sampled upon 'go', only used if FASTRED_EN = TRUE)
+		redmode : in std_logic_vector(1 downto 0);
+		-- output data
+		z : out std_logic_vector(ww - 1 downto 0);
+		zren : in std_logic;
+		irq : out std_logic;
+		go_ack : out std_logic;
+		irq_ack : in std_logic
+	);
+end entity mm_ndsp_mc;
+
+architecture rtl of mm_ndsp_mc is
+
+	-- number of chains (parameter 'nbchain' is 0 when mm_ndsp is used
+	-- instead of present block, NCH must still be legal in that case)
+	constant NCH : positive := max(nbchain, 1);
+	-- number of MACC/DSP blocks per chain
+	constant CHL : positive := max(ndsp / NCH, 1);
+	-- number of partial products computed per cycle
+	constant NL : positive := NCH * CHL;
+	-- a column sum is made of at most w partial products
+	constant ACCW : positive := (2 * ww) + log2(w) + 1;
+	constant MRGW : positive := ACCW + 1;
+
+	subtype limb_type is std_logic_vector(ww - 1 downto 0);
+	type limbs_type is array(natural range <>) of limb_type;
+	type prods_type is array(natural range <>) of unsigned(2*ww - 1 downto 0);
+	type accs_type is array(natural range <>) of unsigned(ACCW - 1 downto 0);
+	subtype idx_type is integer range 0 to w - 1;
+	subtype col_type is integer range 0 to (2 * w) + NCH;
+	type idx_array_type is array(natural range <>) of idx_type;
+	type col_array_type is array(natural range <>) of col_type;
+	type hi_array_type is array(natural range <>) of integer range -1 to w;
+	type ich_array_type is array(natural range <>) of integer range 0 to w + CHL;
+
+	-- Solinas mode (see (s8)): nb of 'ww'-bit limbs per 32-bit word,
+	-- nb of limbs of the result & nb of 32-bit words of the product
+	-- (maximal values, that is for P-384)
+	constant FL : positive := max(32 / ww, 1);
+	constant FNO : positive := 12 * FL;
+	constant FNS : positive := 25;
+	-- a limb accumulator stays within +/- 2**(ww + 4), see (s8)
+	constant FAW : positive := ww + 6;
+	type fcoef_row_type is array(0 to FNS - 1) of integer range -4 to 5;
+	type fcoef_type is array(0 to 11) of fcoef_row_type;
+	type fcor_type is array(0 to 11) of integer range -1 to 1;
+	type faccs_type is array(natural range <>) of signed(FAW - 1 downto 0);
+	-- coef(j, i) for p256 = 2**256 - 2**224 + 2**192 + 2**96 - 1
+	constant FCOEF_256 : fcoef_type := (
+	--  S0 ......................... S8 ........................... S16
+		(1,0,0,0,0,0,0,0, 1, 1, 0,-1,-1,-1,-1, 0, 3, others => 0),
+		(0,1,0,0,0,0,0,0, 0, 1, 1, 0,-1,-1,-1,-1, 0, others => 0),
+		(0,0,1,0,0,0,0,0, 0, 0, 1, 1, 0,-1,-1,-1,-1, others => 0),
+		(0,0,0,1,0,0,0,0,-1,-1, 0, 2, 2, 1, 0,-1,-4, others => 0),
+		(0,0,0,0,1,0,0,0, 0,-1,-1, 0, 2, 2, 1, 0,-1, others => 0),
+		(0,0,0,0,0,1,0,0, 0, 0,-1,-1, 0, 2, 2, 1, 0, others => 0),
+		(0,0,0,0,0,0,1,0,-1,-1, 0, 0, 0, 1, 3, 2,-2, others => 0),
+		(0,0,0,0,0,0,0,1, 1, 0,-1,-1,-1,-1, 0, 3, 5, others => 0),
+		others => (others => 0));
+	-- coef(j, i) for p384 = 2**384 - 2**128 - 2**96 + 2**32 - 1
+	constant FCOEF_384 : fcoef_type := (
+	--  S0 ... S11                S12 ....................... S24
+		(1,0,0,0,0,0,0,0,0,0,0,0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0,-1, 1),
+		(0,1,0,0,0,0,0,0,0,0,0,0,-1, 1, 0, 0, 0, 0, 0, 0,-1, 0, 1, 1,-2),
+		(0,0,1,0,0,0,0,0,0,0,0,0, 0,-1, 1, 0, 0, 0, 0, 0, 0,-1, 0, 1, 1),
+		(0,0,0,1,0,0,0,0,0,0,0,0, 1, 0,-1, 1, 0, 0, 0, 0, 1, 1,-1,-1, 2),
+		(0,0,0,0,1,0,0,0,0,0,0,0, 1, 1, 0,-1, 1, 0, 0, 0, 1, 2, 1,-2, 0),
+		(0,0,0,0,0,1,0,0,0,0,0,0, 0, 1, 1, 0,-1, 1, 0, 0, 0, 1, 2, 1,-2),
+		(0,0,0,0,0,0,1,0,0,0,0,0, 0, 0, 1, 1, 0,-1, 1, 0, 0, 0, 1, 2, 1),
+		(0,0,0,0,0,0,0,1,0,0,0,0, 0, 0, 0, 1, 1, 0,-1, 1, 0, 0, 0, 1, 2),
+		(0,0,0,0,0,0,0,0,1,0,0,0, 0, 0, 0, 0, 1, 1, 0,-1, 1, 0, 0, 0, 1),
+		(0,0,0,0,0,0,0,0,0,1,0,0, 0, 0, 0, 0, 0, 1, 1, 0,-1, 1, 0, 0, 0),
+		(0,0,0,0,0,0,0,0,0,0,1,0, 0, 0, 0, 0, 0, 0, 1, 1, 0,-1, 1, 0, 0),
+		(0,0,0,0,0,0,0,0,0,0,0,1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0,-1, 1, 0));
+	-- 2**(32K) mod p, word by word (used to fold back the final carry)
+	constant FCOR_256 : fcor_type := (1, 0, 0, -1, 0, 0, -1, 1, others => 0);
+	constant FCOR_384 : fcor_type := (1, -1, 0, 1, 1, others => 0);
+
+	type state_type is (idle, xy, sp, ap, fd);
+
+	type ctrl_reg_type is record
+		state : state_type;
+		go : std_logic;
+		rdy : std_logic;
+		irq : std_logic;
+		sqr : std_logic;
+		active : std_logic;
+		redmode : std_logic_vector(1 downto 0);
+	end record;
+
+	-- operands & result terms
+	type mem_reg_type is record
+		x : limbs_type(0 to w - 1);
+		y : limbs_type(0 to w - 1);
+		p : limbs_type(0 to w - 1);
+		pp : limbs_type(0 to w - 1);
+		s : limbs_type(0 to (2 * w) - 1);
+		alpha : limbs_type(0 to w - 1);
+		z : limbs_type(0 to w - 1);
+	end record;
+
+	type io_reg_type is record
+		xyin : limb_type;
+		xien : std_logic;
+		yien : std_logic;
+		xien_prev : std_logic;
+		yien_prev : std_logic;
+		xycnt : idx_type;
+		pin : limb_type;
+		pien : std_logic;
+		piencnt : unsigned(log2(w - 1) - 1 downto 0);
+		pprimein : limb_type;
+		ppien : std_logic;
+		ppiencnt : unsigned(log2(w - 1) - 1 downto 0);
+		zrendel : std_logic;
+		zraddr : idx_type;
+		zout : limbs_type(1 to sramlat);
+	end record;
+
+	-- issue stage (one step of all chains per cycle)
+	type iss_reg_type is record
+		active : std_logic;
+		na : integer range 0 to w;
+		nb : integer range 0 to w;
+		base : col_type;
+		lastcol : col_type;
+		stepcnt : integer range 0 to w + NCH;
+		ich : ich_array_type(0 to NCH - 1);
+		ihi : hi_array_type(0 to NCH - 1);
+		kcol : col_array_type(0 to NCH - 1);
+	end record;
+
+	-- pipeline stages between issue & accumulation
+	type pipe_reg_type is record
+		valid : std_logic;
+		first : std_logic;
+		last : std_logic;
+		base : col_type;
+		ncols : integer range 0 to NCH;
+	end record;
+
+	type rd_reg_type is record
+		ctl : pipe_reg_type;
+		ia : idx_array_type(0 to NL - 1);
+		ib : idx_array_type(0 to NL - 1);
+		lv : std_logic_vector(0 to NL - 1);
+	end record;
+
+	type op_reg_type is record
+		ctl : pipe_reg_type;
+		a : limbs_type(0 to NL - 1);
+		b : limbs_type(0 to NL - 1);
+	end record;
+
+	type mul_reg_type is record
+		ctl : pipe_reg_type;
+		p : prods_type(0 to NL - 1);
+	end record;
+
+	type acc_reg_type is record
+		acc : accs_type(0 to NCH - 1);
+	end record;
+
+	-- carry-merge stage
+	type mrg_reg_type is record
+		busy : std_logic;
+		k : col_type;
+		cnt : integer range 0 to NCH;
+		buf : accs_type(0 to NCH - 1);
+		carry : unsigned(MRGW - ww - 1 downto 0);
+		tprev : limb_type;
+	end record;
+
+	-- Solinas fold (phase fd)
+	type fld_step_type is (acc, mrg, cor);
+	type fld_reg_type is record
+		step : fld_step_type;
+		i : integer range 0 to FNS - 1;
+		m : integer range 0 to FNO - 1;
+		acc : faccs_type(0 to FNO - 1);
+		carry : signed(FAW - ww downto 0);
+		ctop : signed(FAW - ww downto 0);
+	end record;
+
+	type reg_type is record
+		ctrl : ctrl_reg_type;
+		mem : mem_reg_type;
+		io : io_reg_type;
+		iss : iss_reg_type;
+		rd : rd_reg_type;
+		op : op_reg_type;
+		mul : mul_reg_type;
+		acc : acc_reg_type;
+		mrg : mrg_reg_type;
+		fld : fld_reg_type;
+	end record;
+
+	signal r, rin : reg_type;
+
+	signal rst0, rst1, rst2 : std_logic;
+
+begin
+
+	assert (not async)
+		report "mm_ndsp_mc (parameter 'nbchain' > 0) does not support "
+		     & "parameter 'async' = TRUE"
+			severity FAILURE;
+
+	-- rstn is assumed to be asynchronous to clk, so we must
+	-- resynchronize it before using it (same as in mm_ndsp)
+	process(clk)
+	begin
+		if clk'event and clk = '1' then
+			rst0 <= (not rstn) or swrst;
+			rst1 <= rst0;
+			rst2  <= rst1;
+		end if;
+	end process;
+
+	-- combinational process
+	comb: process(r, rst2, go, xyin, xen, yen, sqr, fpwdata, fpwe, pen, ppen,
+	              zren, nndyn_mask, nndyn_shrcnt, nndyn_w, nndyn_wm1, nndyn_wmin,
+	              redmode)
+		variable v : reg_type;
+		variable v_wd : integer range 0 to w;
+		variable v_q : integer range 0 to (2 * w) - 1;
+		variable v_setup : boolean;
+		variable v_na, v_nb : integer range 0 to w;
+		variable v_lastcol : col_type;
+		variable v_initbatch : boolean;
+		variable v_ia : integer range 0 to w + (2 * CHL);
+		variable v_more : boolean;
+		variable v_last : boolean;
+		variable v_sum : unsigned(ACCW - 1 downto 0);
+		variable v_msum : unsigned(MRGW - 1 downto 0);
+		variable v_low : limb_type;
+		variable v_cat : unsigned((2 * ww) - 1 downto 0);
+		variable v_drained : boolean;
+		variable v_fk : integer range 8 to 12;
+		variable v_fns : integer range 17 to FNS;
+		variable v_fsrc : integer range 0 to FNS * FL;
+		variable v_fcf : integer range -4 to 5;
+		variable v_fsum : signed(FAW downto 0);
+		variable v_fcarry : signed(FAW - ww downto 0);
+		variable v_fend : boolean;
+	begin
+		v := r;
+
+		v_wd := to_integer(nndyn_w);
+		v_q := to_integer(nndyn_wmin);
+
+		-- --------------------------------------------------------------------
+		--                          I / O operations
+		-- --------------------------------------------------------------------
+
+		-- same 1-cycle registering of inputs as in mm_ndsp (synchronous case)
+		v.io.xyin := xyin;
+		v.io.xien_prev := r.io.xien;
+		v.io.yien_prev := r.io.yien;
+		if r.ctrl.state = idle then
+			v.io.xien := xen;
+			v.io.yien := yen;
+		end if;
+		v.io.pien := '0';
+		if pen = '1' then
+			v.io.pin := fpwdata;
+			if fpwe = '1' then
+				v.io.pien := '1';
+			end if;
+		end if;
+		v.io.ppien := '0';
+		if ppen = '1' then
+			v.io.pprimein := fpwdata;
+			if fpwe = '1' then
+				v.io.ppien := '1';
+			end if;
+		end if;
+
+		-- transfer of X, Y, P & P' input terms into register arrays
+		if r.ctrl.state = idle then
+			if r.io.xien = '1' or r.io.yien = '1' then
+				if (r.io.xien = '1' and r.io.xien_prev = '0')
+					or (r.io.yien = '1' and r.io.yien_prev = '0')
+				then
+					v.io.xycnt := 0;
+				elsif r.io.xycnt < w - 1 then
+					v.io.xycnt := r.io.xycnt + 1;
+				end if;
+				if r.io.xien = '1' then
+					v.mem.x(v.io.xycnt) := r.io.xyin;
+				else
+					v.mem.y(v.io.xycnt) := r.io.xyin;
+				end if;
+			elsif r.io.pien = '1' then
+				v.mem.p(to_integer(r.io.piencnt)) := r.io.pin;
+				v.io.piencnt := r.io.piencnt + 1;
+				if r.io.piencnt = nndyn_wm1 then
+					v.io.piencnt := (others => '0');
+				end if;
+			elsif r.io.ppien = '1' then
+				v.mem.pp(to_integer(r.io.ppiencnt)) := r.io.pprimein;
+				v.io.ppiencnt := r.io.ppiencnt + 1;
+				if r.io.ppiencnt = nndyn_wm1 then
+					v.io.ppiencnt := (others => '0');
+				end if;
+			end if;
+		end if;
+
+		-- --------------------------------------------------------------------
+		--                     s t a r t   &   p h a s e s
+		-- --------------------------------------------------------------------
+
+		v.ctrl.go := go;
+		v.ctrl.irq := '0';
+
+		v_setup := FALSE;
+		v_na := 0;
+		v_nb := 0;
+		v_lastcol := 0;
+
+		if r.ctrl.rdy = '1' and r.ctrl.go = '0' and go = '1' then
+			v.ctrl.rdy := '0';
+			v.ctrl.active := '1';
+			v.ctrl.sqr := sqr;
+			v.ctrl.redmode := redmode;
+			v.ctrl.state := xy;
+			v_setup := TRUE;
+			v_na := v_wd;
+			v_nb := v_wd;
+			v_lastcol := (2 * v_wd) - 1;
+		end if;
+
+		-- end of a phase: nothing left to issue & everything merged (s1)
+		v_drained := r.iss.active = '0' and r.rd.ctl.valid = '0'
+			and r.op.ctl.valid = '0' and r.mul.ctl.valid = '0'
+			and r.mrg.busy = '0';
+
+		if r.ctrl.active = '1' and v_drained then
+			case r.ctrl.state is
+				when xy =>
+					if FASTRED_EN and r.ctrl.redmode /= "00" then
+						-- Solinas mode, see (s8)
+						v.ctrl.state := fd;
+						v.fld.step := acc;
+						v.fld.i := 0;
+						v.fld.acc := (others => (others => '0'));
+						v.mem.z := (others => (others => '0'));
+					else
+						v.ctrl.state := sp;
+						v_setup := TRUE;
+						v_na := v_q + 1;
+						v_nb := v_q + 1;
+						v_lastcol := v_q;
+					end if;
+				when sp =>
+					v.ctrl.state := ap;
+					v_setup := TRUE;
+					v_na := v_q + 1;
+					v_nb := v_wd;
+					v_lastcol := v_q + v_wd;
+				when ap =>
+					v.ctrl.state := idle;
+					v.ctrl.active := '0';
+					v.ctrl.rdy := '1';
+					v.ctrl.irq := '1';
+				when others => -- fd (pipeline is idle, end is decided by (s8))
+					null;
+			end case;
+		end if;
+
+		-- --------------------------------------------------------------------
+		--                   i s s u e   s t a g e
+		-- --------------------------------------------------------------------
+
+		v.rd.ctl.valid := '0';
+		v.rd.ctl.first := '0';
+		v.rd.ctl.last := '0';
+		v_initbatch := FALSE;
+
+		if v_setup then
+			v.iss.active := '1';
+			v.iss.na := v_na;
+			v.iss.nb := v_nb;
+			v.iss.base := 0;
+			v.iss.lastcol := v_lastcol;
+			v.mrg.carry := (others => '0');
+			v_initbatch := TRUE;
+		elsif r.iss.active = '1' then
+			-- one step: each chain c handles CHL terms of column r.iss.kcol(c)
+			v_more := FALSE;
+			for c in 0 to NCH - 1 loop
+				for l in 0 to CHL - 1 loop
+					v_ia := r.iss.ich(c) + l;
+					if v_ia <= r.iss.ihi(c) then
+						v.rd.ia(c*CHL + l) := v_ia;
+						v.rd.ib(c*CHL + l) := r.iss.kcol(c) - v_ia;
+						v.rd.lv(c*CHL + l) := '1';
+					else
+						v.rd.ia(c*CHL + l) := 0;
+						v.rd.ib(c*CHL + l) := 0;
+						v.rd.lv(c*CHL + l) := '0';
+					end if;
+				end loop;
+				if r.iss.ich(c) + CHL <= r.iss.ihi(c) then
+					v_more := TRUE;
+					v.iss.ich(c) := r.iss.ich(c) + CHL;
+				else
+					-- this chain has no more terms to compute in present batch
+					v.iss.ich(c) := w;
+				end if;
+			end loop;
+			-- (s3) a batch lasts at least NCH cycles, which is the time the
+			-- carry-merge stage takes to process the previous batch
+			v_last := (not v_more) and (r.iss.stepcnt + 1 >= NCH);
+			v.rd.ctl.valid := '1';
+			if r.iss.stepcnt = 0 then
+				v.rd.ctl.first := '1';
+			end if;
+			v.rd.ctl.base := r.iss.base;
+			if r.iss.lastcol - r.iss.base + 1 < NCH then
+				v.rd.ctl.ncols := r.iss.lastcol - r.iss.base + 1;
+			else
+				v.rd.ctl.ncols := NCH;
+			end if;
+			v.iss.stepcnt := r.iss.stepcnt + 1;
+			if v_last then
+				v.rd.ctl.last := '1';
+				if r.iss.base + NCH > r.iss.lastcol then
+					v.iss.active := '0'; -- all columns of the phase were issued
+				else
+					v.iss.base := r.iss.base + NCH;
+					v_initbatch := TRUE;
+				end if;
+			end if;
+		end if;
+
+		-- (s2) first step of a batch: bounds of the terms of each column
+		-- (column k gathers products a_i * b_(k-i) with 0 <= i < na
+		-- and 0 <= k - i < nb)
+		if v_initbatch then
+			v.iss.stepcnt := 0;
+			for c in 0 to NCH - 1 loop
+				v.iss.kcol(c) := v.iss.base + c;
+				if v.iss.base + c > v.iss.lastcol then
+					v.iss.ich(c) := w; -- column beyond the end of phase
+					v.iss.ihi(c) := -1;
+				else
+					if v.iss.base + c > v.iss.nb - 1 then
+						v.iss.ich(c) := v.iss.base + c - (v.iss.nb - 1);
+					else
+						v.iss.ich(c) := 0;
+					end if;
+					if v.iss.base + c < v.iss.na - 1 then
+						v.iss.ihi(c) := v.iss.base + c;
+					else
+						v.iss.ihi(c) := v.iss.na - 1;
+					end if;
+				end if;
+			end loop;
+		end if;
+
+		-- --------------------------------------------------------------------
+		--        o p e r a n d s   r e a d   &   m u l t i p l i c a t i o n
+		-- --------------------------------------------------------------------
+
+		-- operand fetch (the phase can't change while the pipeline is busy)
+		v.op.ctl := r.rd.ctl;
+		for j in 0 to NL - 1 loop
+			if r.rd.lv(j) = '0' then
+				v.op.a(j) := (others => '0');
+				v.op.b(j) := (others => '0');
+			else
+				case r.ctrl.state is
+					when xy =>
+						v.op.a(j) := r.mem.x(r.rd.ia(j));
+						if r.ctrl.sqr = '1' then
+							v.op.b(j) := r.mem.x(r.rd.ib(j));
+						else
+							v.op.b(j) := r.mem.y(r.rd.ib(j));
+						end if;
+					when sp =>
+						v.op.a(j) := r.mem.s(r.rd.ia(j));
+						v.op.b(j) := r.mem.pp(r.rd.ib(j));
+					when others => -- ap
+						v.op.a(j) := r.mem.alpha(r.rd.ia(j));
+						v.op.b(j) := r.mem.p(r.rd.ib(j));
+				end case;
+			end if;
+		end loop;
+
+		-- products (inferred DSP blocks)
+		v.mul.ctl := r.op.ctl;
+		for j in 0 to NL - 1 loop
+			v.mul.p(j) := unsigned(r.op.a(j)) * unsigned(r.op.b(j));
+		end loop;
+
+		-- --------------------------------------------------------------------
+		--                 a c c u m u l a t i o n   &   m e r g e
+		-- --------------------------------------------------------------------
+
+		-- carry-merge of one column: t_k = col_k + carry (+ s_k in phase ap)
+		if r.mrg.busy = '1' then
+			v_msum := resize(r.mrg.buf(0), MRGW) + resize(r.mrg.carry, MRGW);
+			if r.ctrl.state = ap then
+				v_msum := v_msum + resize(unsigned(r.mem.s(r.mrg.k)), MRGW);
+			end if;
+			v_low := std_logic_vector(v_msum(ww - 1 downto 0));
+			v.mrg.carry := v_msum(MRGW - 1 downto ww);
+			case r.ctrl.state is
+				when xy =>
+					v.mem.s(r.mrg.k) := v_low;
+				when sp =>
+					if r.mrg.k = v_q then
+						v.mem.alpha(r.mrg.k) := v_low and nndyn_mask; -- (s6)
+					elsif r.mrg.k < v_q then
+						v.mem.alpha(r.mrg.k) := v_low;
+					end if;
+				when others => -- ap
+					v.mrg.tprev := v_low;
+					-- (s7) z_m = (t_(q+m+1) & t_(q+m)) >> nndyn_shrcnt
+					if r.mrg.k > v_q then
+						v_cat := shift_right(unsigned(v_low) & unsigned(r.mrg.tprev),
+						                     to_integer(nndyn_shrcnt));
+						v.mem.z(r.mrg.k - v_q - 1) :=
+							std_logic_vector(v_cat(ww - 1 downto 0));
+					end if;
+			end case;
+			for c in 0 to NCH - 2 loop
+				v.mrg.buf(c) := r.mrg.buf(c + 1);
+			end loop;
+			if r.mrg.k < (2 * w) + NCH then
+				v.mrg.k := r.mrg.k + 1;
+			end if;
+			v.mrg.cnt := r.mrg.cnt - 1;
+			if r.mrg.cnt = 1 then
+				v.mrg.busy := '0';
+			end if;
+		end if;
+
+		-- accumulation of the CHL products of each chain into its column sum
+		if r.mul.ctl.valid = '1' then
+			for c in 0 to NCH - 1 loop
+				v_sum := (others => '0');
+				for l in 0 to CHL - 1 loop
+					v_sum := v_sum + resize(r.mul.p(c*CHL + l), ACCW);
+				end loop;
+				if r.mul.ctl.first = '1' then
+					v.acc.acc(c) := v_sum;
+				else
+					v.acc.acc(c) := r.acc.acc(c) + v_sum;
+				end if;
+			end loop;
+			-- end of batch: hand its column sums over to carry-merge stage
+			-- (which thx to (s3) is necessarily done w/ the previous batch)
+			if r.mul.ctl.last = '1' then
+				v.mrg.buf := v.acc.acc;
+				v.mrg.busy := '1';
+				v.mrg.k := r.mul.ctl.base;
+				v.mrg.cnt := r.mul.ctl.ncols;
+			end if;
+		end if;
+
+		-- --------------------------------------------------------------------
+		--                    S o l i n a s   f o l d
+		-- --------------------------------------------------------------------
+
+		-- (s8) phase fd, in 3 steps:
+		--   acc: one 32-bit word S_i of the product per cycle is added (times
+		--        coef(j, i)) into each of the K * FL signed limb accumulators
+		--   mrg: one limb per cycle, signed carry propagation into z
+		--   cor: while the final carry c is not null, c * (2**(32K) mod p)
+		--        is added back into z, one limb per cycle
+		if FASTRED_EN then -- statically resolved by synthesizer
+			if r.ctrl.redmode = "10" then
+				v_fk := 12;
+				v_fns := 25;
+			else
+				v_fk := 8;
+				v_fns := 17;
+			end if;
+			v_fsum := (others => '0');
+			v_fcarry := (others => '0');
+			v_fend := FALSE;
+			if r.ctrl.state = fd then
+				case r.fld.step is
+					when acc =>
+						for m in 0 to FNO - 1 loop
+							v_fsrc := (r.fld.i * FL) + (m mod FL);
+							if m / FL < v_fk and v_fsrc < 2 * v_wd then
+								if r.ctrl.redmode = "10" then
+									v_fcf := FCOEF_384(m / FL)(r.fld.i);
+								else
+									v_fcf := FCOEF_256(m / FL)(r.fld.i);
+								end if;
+								v.fld.acc(m) := r.fld.acc(m) + resize(to_signed(v_fcf, 4)
+									* signed('0' & r.mem.s(v_fsrc)), FAW);
+							end if;
+						end loop;
+						if r.fld.i = v_fns - 1 then
+							v.fld.step := mrg;
+							v.fld.m := 0;
+							v.fld.carry := (others => '0');
+						else
+							v.fld.i := r.fld.i + 1;
+						end if;
+					when mrg =>
+						v_fsum := resize(r.fld.acc(r.fld.m), FAW + 1)
+							+ resize(r.fld.carry, FAW + 1);
+						v_fcarry := v_fsum(FAW downto ww);
+						v_fend := r.fld.m = (v_fk * FL) - 1;
+					when cor =>
+						v_fsum := signed(resize(unsigned(r.mem.z(r.fld.m)), FAW + 1))
+							+ resize(r.fld.carry, FAW + 1);
+						if r.fld.m mod FL = 0 then
+							if r.ctrl.redmode = "10" then
+								v_fcf := FCOR_384(r.fld.m / FL);
+							else
+								v_fcf := FCOR_256(r.fld.m / FL);
+							end if;
+							if v_fcf = 1 then
+								v_fsum := v_fsum + resize(r.fld.ctop, FAW + 1);
+							elsif v_fcf = -1 then
+								v_fsum := v_fsum - resize(r.fld.ctop, FAW + 1);
+							end if;
+						end if;
+						v_fcarry := v_fsum(FAW downto ww);
+						v_fend := r.fld.m = (v_fk * FL) - 1;
+				end case;
+				if r.fld.step /= acc then
+					if r.fld.m < w then
+						v.mem.z(r.fld.m) := std_logic_vector(v_fsum(ww - 1 downto 0));
+					end if;
+					v.fld.carry := v_fcarry;
+					if not v_fend then
+						v.fld.m := r.fld.m + 1;
+					elsif v_fcarry = 0 then
+						-- z < 2**(32K), end of the operation
+						v.ctrl.state := idle;
+						v.ctrl.active := '0';
+						v.ctrl.rdy := '1';
+						v.ctrl.irq := '1';
+					else
+						-- one more correction pass
+						v.fld.step := cor;
+						v.fld.ctop := v_fcarry;
+						v.fld.carry := (others => '0');
+						v.fld.m := 0;
+					end if;
+				end if;
+			end if;
+		end if;
+
+		-- --------------------------------------------------------------------
+		-- Read-back of multiplication result by ecc_fp
+		-- --------------------------------------------------------------------
+		-- reproduces the 1 + sramlat cycles of latency that ecc_fp expects
+		-- from the ORAM memory of mm_ndsp, see (s120) in ecc_fp.vhd
+		v.io.zrendel := zren;
+		if zren = '1' and r.io.zrendel = '0' then
+			v.io.zraddr := 0;
+		elsif zren = '1' and r.io.zrendel = '1' and r.io.zraddr < w - 1 then
+			v.io.zraddr := r.io.zraddr + 1;
+		end if;
+		v.io.zout(1) := r.mem.z(r.io.zraddr);
+		for i in 2 to sramlat loop
+			v.io.zout(i) := r.io.zout(i - 1);
+		end loop;
+
+		-- ---------------------------------------------------------------------
+		-- Synchronous (active high) reset
+		-- ---------------------------------------------------------------------
+		if rst2 = '1' then
+			v.ctrl.state := idle;
+			v.ctrl.rdy := '1';
+			v.ctrl.irq := '0';
+			v.ctrl.sqr := '0';
+			v.ctrl.active := '0';
+			v.ctrl.redmode := (others => '0');
+			v.io.piencnt := (others => '0');
+			v.io.ppiencnt := (others => '0');
+			v.io.xien := '0';
+			v.io.yien := '0';
+			v.io.xycnt := 0;
+			v.io.zraddr := 0;
+			v.iss.active := '0';
+			v.rd.ctl.valid := '0';
+			v.op.ctl.valid := '0';
+			v.mul.ctl.valid := '0';
+			v.mrg.busy := '0';
+		end if;
+
+		-- generate combinational input of registered signals
+		rin <= v;
+	end process comb;
+
+	-- synchronous process
+	regs: process(clk)
+	begin
+		if (clk'event and clk = '1') then
+			r <= rin;
+		end if;
+	end process regs;
+
+	-- drive outputs
+	rdy <= r.ctrl.rdy;
+	z <= r.io.zout(sramlat);
+	irq <= r.ctrl.irq;
+	go_ack <= '0'; -- only used in the asynchronous case
+
+end architecture rtl;
@@ -297,6 +297,18 @@ begin
 			v.ctrl.state := idle;
 		end if;
 
+		-- Software reset of the FIFO also drops the byte possibly pending on
+		-- the output port or being read from the FIFO, so that the first byte
+		-- served after it is the first one software pushes next (this is what
+		-- makes the replay of a byte stream deterministic) - (s11)
+		if r.fifo.reset = '1' then
+			v.fifo.re := '0';
+			v.fifo.re0 := '0';
+			v.fifo.re1 := '0';
+			v.ctrl.valid := '0';
+			v.ctrl.state := idle;
+		end if;
+
 		-- --------------
 		-- Irq generation
 		-- --------------
@@ -0,0 +1,134 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# Throughput of generate-tests.sage (test vectors per second) on a given
+# workload: 'NBCURV' curves (with 'nn_constant' = nn if not 0, otherwise
+# the default range of nn), the other parameters of the configuration frame
+# being left as they are in the script.
+#
+# Each variant runs a copy of the script (in <outdir>/<variant>) where these
+# parameters are rewritten, along with 'SEED', 'NBJOBS' & 'CURVE_DB':
+#
+#   - serial:   NBJOBS = 1, no curve database
+#   - jobs:     NBJOBS = <jobs>, no curve database (its output must be the
+#               same as the one of 'serial', as both use the same seed)
+#   - jobs+db:  NBJOBS = <jobs> with curve database <db> (if given, built by
+#               build-curve-db.sage)
+#   - old:      a former version of the script (if given), e.g
+#                 git show <rev>:sage/generate-tests.sage > old.sage
+#               with only 'NBCURV' & 'nn_constant' rewritten
+#
+# The nb of tests is counted in the output of each variant, and the version
+# of SageMath is displayed with the results.
+#
+#   python3 bench.py [-o outdir] [-c nbcurv] [-n nn] [-j jobs] [-s seed]
+#                    [--db curves.txt] [--old old.sage] [--sage cmd]
+#
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# Set parameter 'name' of the configuration frame of script text 's'
+def set_param(s, name, val):
+    (s, n) = re.subn(r"^(%s\s*=\s*)(\"[^\"]*\"|\S+)" % name, lambda m: m.group(1) + val, s, flags=re.M)
+    if n != 1:
+        raise ValueError("can't find parameter '%s'" % name)
+    return s
+
+# Run one variant of 'script' in directory 'd', return (nb of tests,
+# seconds) or an error string
+def run_variant(sage, script, d, params):
+    os.makedirs(d, exist_ok=True)
+    with open(script) as f:
+        s = f.read()
+    for (name, val) in params.items():
+        s = set_param(s, name, val)
+    with open(os.path.join(d, "generate-tests.sage"), "w") as f:
+        f.write(s)
+    for dep in ("curvedb.sage", "tvbin.py"):
+        shutil.copy(os.path.join(HERE, dep), d)
+    t0 = time.time()
+    with open(os.path.join(d, "vectors.txt"), "w") as out, open(os.path.join(d, "stderr.log"), "w") as err:
+        p = subprocess.run(sage + ["generate-tests.sage"], cwd=d, stdout=out, stderr=err)
+    t = time.time() - t0
+    if p.returncode != 0:
+        return "failed (see %s)" % os.path.join(d, "stderr.log")
+    with open(os.path.join(d, "vectors.txt")) as f:
+        nbt = sum(1 for l in f if l.startswith("== TEST"))
+    return (nbt, t)
+
+def main():
+    ap = argparse.ArgumentParser(description="Throughput of generate-tests.sage")
+    ap.add_argument("-o", "--outdir", default="bench", help="directory of variants & outputs")
+    ap.add_argument("-c", "--nbcurv", type=int, default=10, help="nb of curves ('NBCURV')")
+    ap.add_argument("-n", "--nn", type=int, default=256, help="value of 'nn_constant' (0 for the default range)")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="nb of worker processes ('NBJOBS')")
+    ap.add_argument("-s", "--seed", type=int, default=1, help="value of 'SEED'")
+    ap.add_argument("--db", help="curve database for variant jobs+db")
+    ap.add_argument("--old", help="former version of generate-tests.sage for variant old")
+    ap.add_argument("--sage", default="sage", help="command running SageMath")
+    args = ap.parse_args()
+
+    sage = args.sage.split()
+    try:
+        ver = subprocess.run(sage + ["--version"], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                             universal_newlines=True).stdout.strip()
+    except OSError as e:
+        ap.error("can't run SageMath: %s" % e)
+    common = {"NBCURV": str(args.nbcurv), "nn_constant": str(args.nn)}
+    new = os.path.join(HERE, "generate-tests.sage")
+    variants = [("serial", new, dict(common, SEED=str(args.seed), NBJOBS="1", CURVE_DB='""')),
+                ("jobs", new, dict(common, SEED=str(args.seed), NBJOBS=str(args.jobs), CURVE_DB='""'))]
+    if args.db:
+        variants.append(("jobs+db", new, dict(common, SEED=str(args.seed), NBJOBS=str(args.jobs),
+                                               CURVE_DB='"%s"' % os.path.abspath(args.db))))
+    if args.old:
+        variants.append(("old", os.path.abspath(args.old), common))
+
+    res = {}
+    for (name, script, params) in variants:
+        print("  %-8s ..." % name, end="", flush=True)
+        try:
+            res[name] = run_variant(sage, script, os.path.join(args.outdir, name), params)
+        except ValueError as e:
+            res[name] = "%s in %s" % (e, script)
+        r = res[name]
+        print(" %s" % (r if isinstance(r, str) else "%d tests in %.1f s" % r))
+
+    nok = sum(1 for r in res.values() if isinstance(r, str))
+    if not (isinstance(res["serial"], str) or isinstance(res["jobs"], str)):
+        with open(os.path.join(args.outdir, "serial", "vectors.txt")) as f0, \
+                open(os.path.join(args.outdir, "jobs", "vectors.txt")) as f1:
+            if f0.read() != f1.read():
+                print("  outputs of serial & jobs differ (same seed)")
+                nok += 1
+    print("%s, %d curves, %s, %d jobs:" % (ver, args.nbcurv, ("nn = %d" % args.nn) if args.nn else "default range of nn",
+          args.jobs))
+    for (name, _, _) in variants:
+        r = res[name]
+        if not isinstance(r, str):
+            print("  %-8s %10.1f vectors/s" % (name, r[0] / r[1] if r[1] > 0 else 0.))
+    return 1 if nok else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,293 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# Binary test-vector stream format (read by driver/linux/ecc-test-linux.c,
+# see driver/linux/tvbin.c) & conversion from/to the text format (the one
+# of generate-tests.sage & sim/*.txt, which remains the one for humans).
+#
+# A stream starts with the 8-byte magic "IPECCTV1" followed by records,
+# each made of an 8-byte header:
+#
+#   type (1 byte) | flags (1 byte) | 0 (2 bytes) | len (4 bytes, little endian)
+#
+# and 'len' bytes of payload. Integers in payloads are 32-bit little endian,
+# large numbers are big endian on exactly DIV(nn, 8) bytes (that is the byte
+# order of large_number_t in the driver). Records of unknown type are skipped.
+#
+#   CURVE (type 1): id, nn, p, a, b, q
+#   TEST  (type 2): op, curve id, test id, nbbld, then
+#                     Px Py (unless flag P_NULL)
+#                     Qx Qy (P+Q & tests P==Q, P==-Q, unless flag Q_NULL)
+#                     k     ([k]P)
+#                     Rx Ry (result of [k]P, P+Q, [2]P, -P, unless flag R_NULL)
+#   COMMENT (type 3): one "# ..." line of the text format (but "# EXCEPTION",
+#                     which is flag EXCEPTION of its test), as is
+#
+# where 'op' takes the values of operation_t (driver/linux/ecc-test-linux.h).
+#
+# Comment records are skipped by the driver. A comment is recorded just
+# before the record of the curve or test it appears in, and is decoded back
+# right after the header line of that curve or test (comments before the
+# first curve have flag TOP and are decoded in place). Decoding is otherwise
+# a normalization: blank lines are only output between curves, large numbers
+# in lowercase on DIV(nn, 4) digits and the lines of a test in a fixed order,
+# so that text -> binary -> text reproduces files in the layout of
+# generate-tests.sage (e.g sim/ecc_vec_in.txt) but not any
+# hand-edited one.
+#
+# Usage: python3 tvbin.py [-h] [-d] [input [output]]  (-d: binary to text)
+#
+
+import argparse
+import sys
+import struct
+
+MAGIC = b"IPECCTV1"
+
+REC_CURVE = 1
+REC_TEST = 2
+REC_COMMENT = 3
+
+F_EXCEPTION = 0x01
+F_P_NULL = 0x02
+F_Q_NULL = 0x04
+F_R_NULL = 0x08
+F_ANSWER = 0x10
+
+F_TOP = 0x01 # (comment records)
+
+# Largest comment line (a record must fit in the buffer of the driver when
+# the stream is not a regular file, see TVBIN_REC_MAX in tvbin.c)
+COMMENT_MAX = 4096
+
+OP_KP = 1
+OP_PTADD = 2
+OP_PTDBL = 3
+OP_PTNEG = 4
+OP_TST_CHK = 5
+OP_TST_EQU = 6
+OP_TST_OPP = 7
+
+# name of operations in the text format & prefix of their result
+OPS = {"[k]P": (OP_KP, "kP"), "P+Q": (OP_PTADD, "PplusQ"), "[2]P": (OP_PTDBL, "twoP"),
+        "-P": (OP_PTNEG, "negP"), "isPoncurve": (OP_TST_CHK, None),
+        "isP==Q": (OP_TST_EQU, None), "isP==-Q": (OP_TST_OPP, None)}
+OPNAMES = dict([(v[0], (k, v[1])) for (k, v) in OPS.items()])
+
+def nnsz(nn):
+    return (nn + 7) // 8
+
+def has_q(op):
+    return op in (OP_PTADD, OP_TST_EQU, OP_TST_OPP)
+
+def has_res(op):
+    return op in (OP_KP, OP_PTADD, OP_PTDBL, OP_PTNEG)
+
+def record(rtype, flags, payload):
+    return struct.pack("<BBHI", rtype, flags, 0, len(payload)) + payload
+
+# Text to binary, line by line (curves & tests are output as soon as
+# they are complete, that is on the next header line for a test).
+class Encoder:
+    def __init__(self):
+        self.nn = 0
+        self.crv = None
+        self.tst = None
+        self.top = True
+        self.cmt = b""
+
+    def num(self, s):
+        return int(s, 16).to_bytes(nnsz(self.nn), "big")
+
+    def flush(self):
+        out = b""
+        t = self.tst
+        if t is not None:
+            self.tst = None
+            (op, flags) = (t["op"], t["flags"])
+            pl = struct.pack("<IIII", op, t["curve"], t["id"], t.get("nbbld", 0))
+            if not (flags & F_P_NULL):
+                pl += self.num(t["Px"]) + self.num(t["Py"])
+            if has_q(op) and not (flags & F_Q_NULL):
+                pl += self.num(t["Qx"]) + self.num(t["Qy"])
+            if op == OP_KP:
+                pl += self.num(t["k"])
+            if has_res(op) and not (flags & F_R_NULL):
+                pl += self.num(t["Rx"]) + self.num(t["Ry"])
+            out += self.comments() + record(REC_TEST, flags, pl)
+        return out
+
+    # comment records of the curve or test about to be output
+    def comments(self):
+        out = self.cmt
+        self.cmt = b""
+        return out
+
+    def line(self, l):
+        l = l.strip()
+        out = b""
+        if l == "":
+            return out
+        if l.startswith("#"):
+            if l.startswith("# EXCEPTION") and (self.tst is not None):
+                self.tst["flags"] |= F_EXCEPTION
+                return out
+            c = l.encode()
+            if len(c) > COMMENT_MAX:
+                raise ValueError("comment line of more than %d bytes" % COMMENT_MAX)
+            if self.top:
+                return record(REC_COMMENT, F_TOP, c)
+            self.cmt += record(REC_COMMENT, 0, c)
+            return out
+        if l.startswith("== NEW CURVE #"):
+            out += self.flush()
+            self.top = False
+            self.crv = {"id": int(l[len("== NEW CURVE #"):])}
+            return out
+        if l.startswith("== TEST "):
+            out += self.flush()
+            self.top = False
+            (name, num) = l[len("== TEST "):].rsplit(" #", 1)
+            (c, i) = num.split(".")
+            self.tst = {"op": OPS[name][0], "res": OPS[name][1], "curve": int(c),
+                    "id": int(i), "flags": 0}
+            return out
+        if self.crv is not None:
+            (key, val) = l.split("=", 1)
+            self.crv[key] = val
+            if key == "nn":
+                self.nn = int(val)
+            if key == "q":
+                c = self.crv
+                self.crv = None
+                out += self.comments() + record(REC_CURVE, 0, struct.pack("<II", c["id"], self.nn)
+                        + self.num(c["p"]) + self.num(c["a"]) + self.num(c["b"])
+                        + self.num(c["q"]))
+            return out
+        t = self.tst
+        if t is None:
+            raise ValueError("unexpected line '%s'" % l)
+        if l.lower() == "true":
+            t["flags"] |= F_ANSWER
+            return out
+        if l.lower() == "false":
+            return out
+        (key, val) = l.split("=", 1)
+        if (t["res"] is not None) and key.startswith(t["res"]):
+            # result point (P+Q, [2]P...)
+            key = "R" + key[len(t["res"]):]
+        if key in ("P", "Q", "R"):
+            t["flags"] |= {"P": F_P_NULL, "Q": F_Q_NULL, "R": F_R_NULL}[key]
+        elif key == "nbbld":
+            t["nbbld"] = int(val)
+        else:
+            t[key] = val
+        return out
+
+    def text(self, txt):
+        return b"".join([self.line(l) for l in txt.split("\n")])
+
+# Binary to text (in the format of generate-tests.sage)
+def decode(data):
+    if data[:len(MAGIC)] != MAGIC:
+        raise ValueError("not a binary test-vector stream")
+    pos = len(MAGIC)
+    nn = 0
+    out = []
+    cmt = []
+    def num(pl, i, name):
+        sz = nnsz(nn)
+        out.append("%s=0x%0*x" % (name, (nn + 3) // 4, int.from_bytes(pl[i:i+sz], "big")))
+        return i + sz
+    while pos < len(data):
+        (rtype, flags, _, ln) = struct.unpack_from("<BBHI", data, pos)
+        pl = data[pos+8:pos+8+ln]
+        pos += 8 + ln
+        if rtype == REC_COMMENT:
+            if flags & F_TOP:
+                out.append(pl.decode())
+            else:
+                cmt.append(pl.decode())
+        elif rtype == REC_CURVE:
+            (cid, nn) = struct.unpack_from("<II", pl, 0)
+            if out:
+                out.append("")
+            out.append("== NEW CURVE #%d" % cid)
+            out += cmt
+            cmt = []
+            out.append("nn=%d" % nn)
+            i = 8
+            for name in ("p", "a", "b", "q"):
+                i = num(pl, i, name)
+        elif rtype == REC_TEST:
+            (op, cid, tid, nbbld) = struct.unpack_from("<IIII", pl, 0)
+            (name, res) = OPNAMES[op]
+            out.append("== TEST %s #%d.%d" % (name, cid, tid))
+            if flags & F_EXCEPTION:
+                out.append("# EXCEPTION")
+            out += cmt
+            cmt = []
+            i = 16
+            if flags & F_P_NULL:
+                out.append("P=0")
+            else:
+                i = num(pl, i, "Px")
+                i = num(pl, i, "Py")
+            if has_q(op):
+                if flags & F_Q_NULL:
+                    out.append("Q=0")
+                else:
+                    i = num(pl, i, "Qx")
+                    i = num(pl, i, "Qy")
+            if op == OP_KP:
+                i = num(pl, i, "k")
+                if nbbld:
+                    out.append("nbbld=%d" % nbbld)
+            if has_res(op):
+                if flags & F_R_NULL:
+                    out.append(res + "=0")
+                else:
+                    i = num(pl, i, res + "x")
+                    i = num(pl, i, res + "y")
+            else:
+                out.append("true" if (flags & F_ANSWER) else "false")
+    out += cmt
+    return "\n".join(out) + "\n"
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description="Conversion of test vectors from the text format to the binary "
+                                 "one (read by ecc-test-linux) and back")
+    ap.add_argument("-d", "--decode", action="store_true", help="binary to text")
+    ap.add_argument("input", nargs="?", help="input file (default: standard input)")
+    ap.add_argument("output", nargs="?", help="output file (default: standard output)")
+    args = ap.parse_args()
+    try:
+        fin = open(args.input, "rb") if args.input else sys.stdin.buffer
+        fout = open(args.output, "wb") if args.output else sys.stdout.buffer
+        if args.decode:
+            fout.write(decode(fin.read()).encode())
+        else:
+            enc = Encoder()
+            fout.write(MAGIC)
+            for (n, l) in enumerate(fin):
+                try:
+                    fout.write(enc.line(l.decode()))
+                except (ValueError, KeyError) as e:
+                    raise ValueError("line %d: %s" % (n + 1, e))
+            fout.write(enc.flush())
+        fout.flush()
+    except (OSError, ValueError, struct.error) as e:
+        sys.exit("tvbin.py: %s" % e)
@@ -0,0 +1,134 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# Curve-switch cycles of ecc_tb with & without context slots ('nbctx') and
+# the write of a, b & q during .constMTYL ('mtyovl') (make ctxrun).
+#
+# A vector file is made of 'rounds' rounds over some curves of the input
+# file (selected by their value of nn), each curve being followed by one of
+# its [k]P tests, so that the IP switches curves before every [k]P. ecc_tb is
+# built & simulated in its own directory <outdir>/<variant> for each
+# combination of 'nbctx' (0 & the given value) and 'mtyovl' (FALSE & TRUE)
+# (see build() in regress.py). The testbench checks all [k]P results and
+# displays the nb of cycles until the IP is ready with each new curve, which
+# are gathered here: average cycles of the first upload of each curve (round
+# 0) & of the later switches (rounds 1 & up, where with 'nbctx' >= nb of
+# curves, the curve is restored from its slot). A variant fails if its
+# build or simulation does, or if any [k]P is wrong or not run.
+#
+#   python3 ctx.py [-j jobs] [-o outdir] [-t timeout] [-n nn,...] [-r rounds]
+#                  [-c nbctx] vectors.txt
+#
+
+import argparse
+import concurrent.futures
+import os
+import re
+import subprocess
+import sys
+import time
+
+import regress
+
+CURVE_RE = re.compile(r"curve set in (\d+) cycles")
+
+# Build & simulate one variant, return (cycles of curve settings, nb of [k]P
+# ok, nb of [k]P) or an error string
+def run_variant(d, params, vecs, timeout):
+    os.makedirs(d, exist_ok=True)
+    with open(os.path.join(d, "build.log"), "w") as log:
+        try:
+            regress.build(d, params, log)
+        except subprocess.CalledProcessError:
+            return "build failed (see %s)" % os.path.join(d, "build.log")
+    with open(os.path.join(d, "ecc_vec_in.txt"), "w") as f:
+        f.write(vecs)
+    res = regress.run_shard(os.path.abspath(os.path.join(d, "ecc_tb")), d, timeout)
+    with open(os.path.join(d, "ecc_tb.log")) as f:
+        cyc = [int(c) for c in CURVE_RE.findall(f.read())]
+    return (cyc, sum(1 for r in res if r[3]), len(res))
+
+def main():
+    ap = argparse.ArgumentParser(description="Curve-switch cycles of ecc_tb with & without 'nbctx' & 'mtyovl'")
+    ap.add_argument("vectors", help="test-vector file (text format)")
+    ap.add_argument("-j", "--jobs", type=int, default=4, help="nb of variants built & simulated in parallel")
+    ap.add_argument("-o", "--outdir", default="ctxrun", help="directory of variants & results")
+    ap.add_argument("-t", "--timeout", type=float, default=0, help="timeout per simulation (s, 0 for none)")
+    ap.add_argument("-n", "--nn", default="160,192,224", help="values of nn of the curves to rotate on")
+    ap.add_argument("-r", "--rounds", type=int, default=3, help="nb of rounds over the curves")
+    ap.add_argument("-c", "--nbctx", type=int, default=4, help="value of 'nbctx' (0 is always run too)")
+    args = ap.parse_args()
+
+    nns = [int(v) for v in args.nn.split(",")]
+    curves = [(hdr, nn, [t for t in tests if t[0] == "[k]P"]) for (hdr, nn, tests)
+              in regress.read_vectors([args.vectors]) if nn in nns]
+    curves = [c for c in curves if c[2]]
+    if not curves:
+        ap.error("no curve with a [k]P test and nn in %s in %s" % (args.nn, args.vectors))
+    vecs = ""
+    for r in range(args.rounds):
+        for (hdr, nn, tests) in curves:
+            vecs += hdr + "".join(tests[r % len(tests)][1])
+    nkp = args.rounds * len(curves)
+
+    variants = []
+    for nbctx in (0, args.nbctx):
+        for ovl in ("FALSE", "TRUE"):
+            variants.append(((nbctx, ovl), os.path.join(args.outdir, "nbctx_%d-mtyovl_%s" % (nbctx, ovl)),
+                             {"nbctx": str(nbctx), "mtyovl": ovl}))
+    print("%d variants of ecc_tb, %d rounds over %d curves (nn = %s)" % (len(variants), args.rounds,
+          len(curves), ",".join(str(c[1]) for c in curves)))
+
+    os.makedirs(args.outdir, exist_ok=True)
+    t0 = time.time()
+    res = {}
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as ex:
+        futs = {ex.submit(run_variant, d, params, vecs, args.timeout): k for (k, d, params) in variants}
+        for f in concurrent.futures.as_completed(futs):
+            k = futs[f]
+            r = f.result()
+            if not isinstance(r, str) and (r[1] != nkp or len(r[0]) != nkp):
+                r = "%d/%d [k]P ok, %d curves set (see %s)" % (r[1], nkp, len(r[0]),
+                    os.path.join(args.outdir, "nbctx_%d-mtyovl_%s" % k, "ecc_tb.log"))
+            res[k] = r
+            print("  nbctx = %2d, mtyovl = %-5s: %s" % (k + ((r if isinstance(r, str) else "ok"),)))
+    elapsed = time.time() - t0
+
+    with open(os.path.join(args.outdir, "ctx.csv"), "w") as f:
+        f.write("nbctx,mtyovl,round,nn,cycles\n")
+        for (k, _, _) in variants:
+            if not isinstance(res[k], str):
+                for (i, c) in enumerate(res[k][0]):
+                    f.write("%d,%s,%d,%d,%d\n" % (k + (i // len(curves), curves[i % len(curves)][1], c)))
+
+    # Average cycles per curve setting, first uploads & later switches
+    n = len(curves)
+    avg = lambda l: sum(l) // len(l) if l else 0
+    print("Cycles until the IP is ready with the new curve (average):")
+    print("  %-26s %12s %12s" % ("", "1st upload", "switch"))
+    for (k, _, _) in variants:
+        r = res[k]
+        if isinstance(r, str):
+            print("  nbctx = %2d, mtyovl = %-5s %12s %12s" % (k + ("-", "-")))
+        else:
+            print("  nbctx = %2d, mtyovl = %-5s %12d %12d" % (k + (avg(r[0][:n]), avg(r[0][n:]))))
+    nok = sum(1 for r in res.values() if isinstance(r, str))
+    print("%d variants ok, %d failed, in %.1f s (results in %s)" % (len(res) - nok, nok, elapsed,
+          os.path.join(args.outdir, "ctx.csv")))
+    return 1 if nok else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,320 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# Design-space exploration of the parameters of ecc_customize.vhd (make dse).
+#
+# A grid of values is given for some of the parameters (the cartesian product
+# of all of them is swept) and for each variant ecc_tb is compiled &
+# elaborated in its own directory <outdir>/<variant> with a copy of
+# ecc_customize.vhd where these parameters are overridden (see build() in
+# regress.py), then simulated on a fixed micro-workload: one [k]P on each of
+# NIST curves P-256, P-384 & P-521 (vectors are computed here, with the same
+# scalar for all variants). Variants are built & simulated in parallel.
+#
+# Pseudo-parameter 'fpsqr' is not a constant of ecc_customize.vhd: with
+# fpsqr=FALSE the microcode of the variant is assembled in <outdir>/<variant>/iram
+# with no FPSQR emitted (NOFPSQR=1, see ecc_curve_iram/Makefile), so that
+# -p fpsqr=TRUE,FALSE compares squarings with generic multiplications.
+#
+# The latency of each [k]P is the nb of cycles the IP is busy computing it
+# (column 'busy' of 'simcyclesfile', see ecc_tb.vhd), otherwise the total nb
+# of cycles of the test as displayed by ecc_tb.
+#
+# With 'hwsecure' = FALSE, ecc_tb also displays the nb of cycles each client
+# of the TRNG was starving & served over all [k]P (see 'trngdrbg'): their
+# totals are written to columns 'trng_starv' & 'trng_served' of dse.csv.
+#
+# Resources: the nb of DSP blocks (or multipliers on ASIC) is estimated as
+# nbmult x min(nbdsp, w) - see set_ndsp in ecc_pkg.vhd. When a synthesis flow
+# is available, option --synth gives a command to run on each variant (in
+# which '{dir}' is replaced with the directory of the variant, holding its
+# ecc_customize.vhd, and '{name}' with its name), whose output is searched for
+# 'dsp=N', 'bram=N', 'lut=N' & 'ff=N': these replace the estimates.
+#
+# Variants are written to <outdir>/dse.csv, and the Pareto-optimal ones (no
+# other variant is as fast on all curves with no more DSP & BRAM) printed &
+# written to <outdir>/pareto.csv. Only GHDL is needed.
+#
+#   python3 dse.py [-j jobs] [-o outdir] [-t timeout] [-p name=v1,v2,...]...
+#                  [--synth "command {dir}"] [--no-build]
+#
+
+import argparse
+import concurrent.futures
+import hashlib
+import itertools
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+import regress
+
+IRAM = os.path.join("..", "hdl", "common", "ecc_curve_iram")
+
+# Parameters of the grid that are not constants of ecc_customize.vhd
+PSEUDO = ("fpsqr",)
+
+# Default grid (overridden parameter by parameter with -p)
+GRID = {
+    "nbmult": ["1", "2"],
+    "nbdsp": ["2", "4", "8"],
+    "sramlat": ["1", "2"],
+}
+
+# NIST curves of the workload: (name, nn, p, a, b, q, Gx, Gy)
+P256 = 0xffffffff00000001000000000000000000000000ffffffffffffffffffffffff
+P384 = 2 ** 384 - 2 ** 128 - 2 ** 96 + 2 ** 32 - 1
+P521 = 2 ** 521 - 1
+CURVES = [
+    ("P-256", 256, P256, P256 - 3,
+     0x5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b,
+     0xffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551,
+     0x6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296,
+     0x4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5),
+    ("P-384", 384, P384, P384 - 3,
+     0xb3312fa7e23ee7e4988e056be3f82d19181d9c6efe8141120314088f5013875ac656398d8a2ed19d2a85c8edd3ec2aef,
+     0xffffffffffffffffffffffffffffffffffffffffffffffffc7634d81f4372ddf581a0db248b0a77aecec196accc52973,
+     0xaa87ca22be8b05378eb1c71ef320ad746e1d3b628ba79b9859f741e082542a385502f25dbf55296c3a545e3872760ab7,
+     0x3617de4a96262c6f5d9e98bf9292dc29f8f41dbd289a147ce9da3113b5f0b8c00a60b1ce1d7e819d7a431d7c90ea0e5f),
+    ("P-521", 521, P521, P521 - 3,
+     0x0051953eb9618e1c9a1f929a21a0b68540eea2da725b99b315f3b8b489918ef109e156193951ec7e937b1652c0bd3bb1bf073573df883d2c34f1ef451fd46b503f00,
+     0x01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffa51868783bf2f966b7fcc0148f709a5d03bb5c9b8899c47aebb6fb71e91386409,
+     0x00c6858e06b70404e9cd9e3ecb662395b4429c648139053fb521f828af606b4d3dbaa14b5e77efe75928fe1dc127a2ffa8de3348b3c1856a429bf97e7e31c2e5bd66,
+     0x011839296a789a3bc0045c8a5fb42c7d1bd998f54449579b446817afbd17273e662c97ee72995ef42640c550b9013fad0761353c7086a272c24088be94769fd16650),
+]
+
+# Affine arithmetic on y^2 = x^3 + ax + b mod p (None is the point at infinity)
+def ec_add(P, Q, a, p):
+    if P is None:
+        return Q
+    if Q is None:
+        return P
+    if P[0] == Q[0]:
+        if (P[1] + Q[1]) % p == 0:
+            return None
+        l = (3 * P[0] * P[0] + a) * pow(2 * P[1], -1, p) % p
+    else:
+        l = (Q[1] - P[1]) * pow(Q[0] - P[0], -1, p) % p
+    x = (l * l - P[0] - Q[0]) % p
+    return (x, (l * (P[0] - x) - P[1]) % p)
+
+def ec_mul(k, P, a, p):
+    R = None
+    for b in bin(k)[2:]:
+        R = ec_add(R, R, a, p)
+        if b == "1":
+            R = ec_add(R, P, a, p)
+    return R
+
+# Workload in the format of ecc_tb test-vector files (curves of at most 'nn' bits)
+def workload(nn, nbbld):
+    s = ""
+    for (i, (name, cnn, p, a, b, q, gx, gy)) in enumerate(CURVES):
+        if cnn > nn:
+            continue
+        assert (gy * gy - gx ** 3 - a * gx - b) % p == 0
+        k = int.from_bytes(hashlib.sha512(("IPECC dse " + name).encode()).digest(), "big") % q
+        kP = ec_mul(k, (gx, gy), a, p)
+        s += "== NEW CURVE #%d\n# Name: NIST curve %s\nnn=%d\n" % (i, name, cnn)
+        s += "p=0x%x\na=0x%x\nb=0x%x\nq=0x%x\n" % (p, a, b, q)
+        s += "== TEST [k]P #%d.0\nPx=0x%x\nPy=0x%x\nk=0x%x\n" % (i, gx, gy, k)
+        if 0 < nbbld < cnn:
+            s += "nbbld=%d\n" % nbbld
+        s += "kPx=0x%x\nkPy=0x%x\n\n" % kP
+    return s
+
+# Value of parameter 'name' of a variant, or of ecc_customize.vhd by default
+def param(params, name):
+    if name in PSEUDO:
+        return params.get(name, "TRUE")
+    if name in params:
+        return params[name]
+    m = re.search(r"\n\s*constant\s+%s\s*:[^:;]*:=\s*([^;]*?)\s*;" % name, open(regress.CUSTOMIZE).read())
+    return m.group(1)
+
+# Estimate of the nb of DSP blocks (see set_ww in ecc_utils.vhd & set_ndsp in ecc_pkg.vhd)
+def dsp_estimate(params):
+    techno = param(params, "techno")
+    ww = {"spartan6": 16, "virtex6": 16, "series7": 16, "ultrascale": 16, "ialtera": 27}.get(
+        techno, int(param(params, "multwidth")))
+    w = -(-(int(param(params, "nn")) + 4) // ww)
+    return int(param(params, "nbmult")) * min(int(param(params, "nbdsp")), w)
+
+# Assemble the microcode of a variant in '<d>/iram' with no FPSQR, return the directory
+def build_iram(d, out):
+    iram = os.path.join(d, "iram")
+    shutil.rmtree(iram, ignore_errors=True)
+    shutil.copytree(IRAM, iram, ignore=shutil.ignore_patterns("latex"))
+    common = os.path.abspath(os.path.join(IRAM, ".."))
+    subprocess.check_call(["make", "--no-print-directory", "-B", "-C", iram, "NOFPSQR=1",
+                           "CUSTOM_VHD=" + os.path.join(common, "ecc_customize.vhd"),
+                           "ECCPKG_VHD=" + os.path.join(common, "ecc_pkg.vhd"),
+                           "ECCSW_VHD=" + os.path.join(common, "ecc_software.vhd"), "asm", "csv2vhd"],
+                          stdout=out, stderr=out)
+    return iram
+
+TRNG_RE = re.compile(r"\]:\s+(axi|efp|crv|shf|raw) = (\d+)/(\d+)\s*$")
+
+RES_RE = re.compile(r"\b(dsp|bram|lut|ff)\s*[=:]\s*(\d+)", re.I)
+
+# Build, synthesize (optionally) & simulate variant 'name', return a dict of results
+def run_variant(name, params, args):
+    d = os.path.join(args.outdir, name)
+    r = {"dsp": dsp_estimate(params), "bram": None, "lut": None, "ff": None, "kp": {}, "ok": False,
+         "trng": None}
+    try:
+        if not args.no_build:
+            os.makedirs(d, exist_ok=True)
+            with open(os.path.join(d, "build.log"), "w") as log:
+                try:
+                    iram = build_iram(d, log) if param(params, "fpsqr") == "FALSE" else None
+                    regress.build(d, {n: v for (n, v) in params.items() if n not in PSEUDO}, log, iram=iram)
+                except subprocess.CalledProcessError:
+                    r["error"] = "build failed (see %s)" % os.path.join(d, "build.log")
+                    return r
+        if args.synth:
+            out = subprocess.run(args.synth.replace("{dir}", os.path.abspath(d)).replace("{name}", name), shell=True,
+                                 stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True).stdout
+            with open(os.path.join(d, "synth.log"), "w") as f:
+                f.write(out)
+            for m in RES_RE.finditer(out):
+                r[m.group(1).lower()] = int(m.group(2))
+        with open(os.path.join(d, "ecc_vec_in.txt"), "w") as f:
+            f.write(workload(int(param(params, "nn")), int(param(params, "blinding"))))
+        cycles = os.path.join(d, "ecc_cycles.csv")
+        if os.path.exists(cycles):
+            os.remove(cycles)
+        res = regress.run_shard(os.path.abspath(os.path.join(d, "ecc_tb")), d, args.timeout)
+    except Exception as e:
+        r["error"] = str(e)
+        return r
+    # Total cycles of each test, then busy cycles from 'simcyclesfile' if any
+    for (op, label, cyc, ok) in res:
+        r["kp"][label] = (cyc, ok)
+    if os.path.exists(cycles):
+        with open(cycles) as f:
+            hdr = f.readline().strip().split(",")
+            for l in f:
+                v = dict(zip(hdr, l.strip().split(",")))
+                if v.get("test") in r["kp"]:
+                    r["kp"][v["test"]] = (int(v["busy"]), v["status"] == "ok")
+    # TRNG starvation totals (last lines of the log, HW unsecure mode only)
+    t = []
+    if os.path.exists(os.path.join(d, "ecc_tb.log")):
+        with open(os.path.join(d, "ecc_tb.log")) as f:
+            t = [m for m in (TRNG_RE.search(l) for l in f) if m]
+    if t:
+        r["trng"] = (sum(int(m.group(2)) for m in t[-5:]), sum(int(m.group(3)) for m in t[-5:]))
+    r["ok"] = len(res) > 0 and all(ok for (_, ok) in r["kp"].values())
+    if not r["ok"]:
+        r["error"] = "test(s) failed or not run (see %s)" % os.path.join(d, "ecc_tb.log")
+    return r
+
+# TRUE if variant 'a' is at least as good as 'b' everywhere (and not the same)
+def dominates(a, b, labels):
+    ka = [a["kp"].get(l, (float("inf"),))[0] for l in labels] + [a["dsp"], a["bram"] or 0]
+    kb = [b["kp"].get(l, (float("inf"),))[0] for l in labels] + [b["dsp"], b["bram"] or 0]
+    return all(x <= y for (x, y) in zip(ka, kb)) and ka != kb
+
+def main():
+    ap = argparse.ArgumentParser(description="Design-space exploration of ecc_customize.vhd parameters")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="nb of variants built & simulated in parallel")
+    ap.add_argument("-o", "--outdir", default="dse", help="directory of variants & results")
+    ap.add_argument("-t", "--timeout", type=float, default=0, help="timeout per simulation (s, 0 for none)")
+    ap.add_argument("-p", "--param", action="append", default=[], metavar="NAME=V1,V2,...",
+                    help="values of a parameter of ecc_customize.vhd (VHDL expressions)")
+    ap.add_argument("--synth", help="synthesis command per variant, '{dir}' & '{name}' are replaced")
+    ap.add_argument("--no-build", action="store_true", help="reuse <outdir>/<variant>/ecc_tb as is")
+    args = ap.parse_args()
+
+    grid = dict(GRID)
+    for a in args.param:
+        (name, _, vals) = a.partition("=")
+        if not vals:
+            ap.error("bad -p argument '%s'" % a)
+        grid[name.strip()] = [v.strip() for v in vals.split(",")]
+    # 'multwidth' only means something on ASIC
+    if param({k: v[0] for (k, v) in grid.items()}, "techno") != "asic" and "multwidth" in grid \
+       and "techno" not in grid:
+        print("'techno' is not asic, ignoring values of 'multwidth'")
+        del grid["multwidth"]
+    names = sorted(grid)
+    variants = []
+    for vals in itertools.product(*(grid[n] for n in names)):
+        params = dict(zip(names, vals))
+        # (check that all parameters exist in ecc_customize.vhd before building anything)
+        for n in names:
+            if n in PSEUDO:
+                if params[n] not in ("TRUE", "FALSE"):
+                    ap.error("'%s' is TRUE or FALSE" % n)
+                continue
+            regress.set_constant(open(regress.CUSTOMIZE).read(), n, params[n])
+        name = "-".join("%s_%s" % (n, re.sub(r"\W", "", v)) for (n, v) in zip(names, vals))
+        variants.append((name, params))
+    labels = ["#%d.0" % i for (i, c) in enumerate(CURVES) if c[1] <= max(int(param(p, "nn")) for (_, p) in variants)]
+    print("%d variants of %s, %d jobs" % (len(variants), ", ".join(names), args.jobs))
+
+    os.makedirs(args.outdir, exist_ok=True)
+    t0 = time.time()
+    results = {}
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as ex:
+        futs = {ex.submit(run_variant, name, params, args): name for (name, params) in variants}
+        for f in concurrent.futures.as_completed(futs):
+            name = futs[f]
+            results[name] = f.result()
+            print("  %-40s %s" % (name, "ok" if results[name]["ok"] else results[name]["error"]))
+    elapsed = time.time() - t0
+
+    curves = [CURVES[int(l[1:-2])][0] for l in labels]
+    ok = [(name, params, results[name]) for (name, params) in variants if results[name]["ok"]]
+    pareto = [v for v in ok if not any(dominates(w[2], v[2], labels) for w in ok)]
+    pareto.sort(key=lambda v: (v[2]["dsp"], v[2]["bram"] or 0))
+
+    def row(params, r):
+        return [params[n] for n in names] + [str(r["kp"][l][0]) if l in r["kp"] else "" for l in labels] \
+            + ["" if r[k] is None else str(r[k]) for k in ("dsp", "bram", "lut", "ff")]
+    hdr = names + ["kP_" + c for c in curves] + ["dsp", "bram", "lut", "ff"]
+    with open(os.path.join(args.outdir, "dse.csv"), "w") as f:
+        f.write(",".join(["variant"] + hdr + ["trng_starv", "trng_served", "status"]) + "\n")
+        for (name, params) in variants:
+            r = results[name]
+            f.write(",".join([name] + row(params, r) + (["", ""] if r["trng"] is None else
+                    [str(v) for v in r["trng"]]) + ["ok" if r["ok"] else "FAILED"]) + "\n")
+    with open(os.path.join(args.outdir, "pareto.csv"), "w") as f:
+        f.write(",".join(hdr) + "\n")
+        for (name, params, r) in pareto:
+            f.write(",".join(row(params, r)) + "\n")
+
+    src = "synthesis" if args.synth else "estimated"
+    print("Pareto-optimal variants ([k]P latency in cycles, resources %s):" % src)
+    print(" ".join("%12s" % h for h in hdr))
+    for (name, params, r) in pareto:
+        print(" ".join("%12s" % c for c in row(params, r)))
+    trng = [(name, r["trng"]) for (name, _, r) in ok if r["trng"] is not None]
+    if trng:
+        print("TRNG starving/served cycles over all [k]P:")
+        for (name, t) in trng:
+            print("  %-40s %d/%d" % ((name,) + t))
+    nok = len(variants) - len(ok)
+    print("%d variants ok, %d failed, in %.1f s (results in %s)" % (len(ok), nok, elapsed,
+          os.path.join(args.outdir, "dse.csv")))
+    return 1 if nok else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,450 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.ecc_tb_pkg.all;
+use work.ecc_tb_vec.all;
+use work.ecc_vars.all;
+use work.ecc_software.all;
+
+use std.textio.all;
+
+-- Testbench for the AXI-Stream ports for large numbers of 'ecc' (see (s298)
+-- in ecc_axi.vhd, requires 'axistream' = TRUE in ecc_customize.vhd).
+--
+-- The same large number is written to & read back from the IP, first through
+-- registers W_WRITE_DATA & R_READ_DATA (as the software driver does, polling
+-- R_STATUS before each word) and then through the AXI-Stream ports (driven
+-- here as a memory-mapped to stream bridge with back-to-back beats would).
+-- The testbench checks that both readbacks match the number written, checks
+-- that TLAST is asserted with the last word only, and displays for both paths
+-- the nb of AXI clock cycles needed to transfer one coordinate.
+entity ecc_axis_tb is
+end entity ecc_axis_tb;
+
+architecture sim of ecc_axis_tb is
+
+	-- DuT component declaration
+	component ecc is
+		generic(
+			-- Width of S_AXI data bus
+			C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+			-- Width of S_AXI address bus
+			C_S_AXI_ADDR_WIDTH : integer := AXIAW -- in ecc_pkg
+			);
+		port(
+			-- AXI clock & reset
+			s_axi_aclk : in  std_logic;
+			s_axi_aresetn : in std_logic; -- asyn asserted, syn deasserted, active low
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			--  AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- AXI-Stream ports for large numbers
+			s_axis_tdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axis_tvalid : in std_logic;
+			s_axis_tready : out std_logic;
+			m_axis_tdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axis_tvalid : out std_logic;
+			m_axis_tready : in std_logic;
+			m_axis_tlast : out std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation
+			busy : out std_logic;
+			-- HW unsecure/SCA analysis feature (off-chip trigger)
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic;
+			-- clk & clkmm division & out feature
+			clkdivo : out std_logic;
+			clkmmdivo : out std_logic
+		);
+	end component ecc;
+
+	-- AXI signal buses (DuT), driven by the procedures of ecc_tb_pkg
+	signal axi0 : axi_in_type;
+	signal axo0 : axi_out_type;
+
+	signal s_axi_aclk, s_axi_aresetn : std_logic;
+
+	signal clkmm : std_logic;
+
+	signal irq : std_logic;
+	signal busy : std_logic;
+
+	-- AXI-Stream ports (DuT)
+	signal s_axis_tdata : std_logic_vector(AXIDW - 1 downto 0);
+	signal s_axis_tvalid : std_logic;
+	signal s_axis_tready : std_logic;
+	signal m_axis_tdata : std_logic_vector(AXIDW - 1 downto 0);
+	signal m_axis_tvalid : std_logic;
+	signal m_axis_tready : std_logic;
+	signal m_axis_tlast : std_logic;
+
+	-- Pseudo TRNG port (unused here)
+	signal dbgptdata : std_logic_vector(7 downto 0);
+	signal dbgptvalid : std_logic;
+
+	-- AXI clock period (150 MHz)
+	constant CLKPER : time := 6.666 ns;
+
+	constant VALNN : positive := 192;
+	-- nb of AXI words of a large number
+	constant NBW : positive := div(VALNN, AXIDW);
+
+begin
+
+	-- Emulate AXI reset.
+	process
+	begin
+		s_axi_aresetn <= '0';
+		wait for 333 ns;
+		s_axi_aresetn <= '1';
+		wait;
+	end process;
+
+	-- Emulate AXI clock (150 MHz).
+	process
+	begin
+		s_axi_aclk <= '0';
+		wait for CLKPER / 2;
+		s_axi_aclk <= '1';
+		wait for CLKPER / 2;
+	end process;
+
+	-- Emulate clkmm clock (374 MHz).
+	process
+	begin
+		clkmm <= '0';
+		wait for 1.336 ns;
+		clkmm <= '1';
+		wait for 1.336 ns;
+	end process;
+
+	dbgptdata <= (others => '0');
+	dbgptvalid <= '0';
+
+	-- DuT instance
+	e0: ecc
+		generic map(
+			C_S_AXI_DATA_WIDTH => AXIDW,
+			C_S_AXI_ADDR_WIDTH => AXIAW)
+		port map(
+			-- AXI clock & reset
+			s_axi_aclk => s_axi_aclk,
+			s_axi_aresetn => s_axi_aresetn,
+			-- AXI write-address channel
+			s_axi_awaddr => axi0.awaddr,
+			s_axi_awprot => axi0.awprot,
+			s_axi_awvalid => axi0.awvalid,
+			s_axi_awready => axo0.awready,
+			-- AXI write-data channel
+			s_axi_wdata => axi0.wdata,
+			s_axi_wstrb => axi0.wstrb,
+			s_axi_wvalid => axi0.wvalid,
+			s_axi_wready => axo0.wready,
+			-- AXI write-response channel
+			s_axi_bresp => axo0.bresp,
+			s_axi_bvalid => axo0.bvalid,
+			s_axi_bready => axi0.bready,
+			-- AXI read-address channel
+			s_axi_araddr => axi0.araddr,
+			s_axi_arprot => axi0.arprot,
+			s_axi_arvalid => axi0.arvalid,
+			s_axi_arready => axo0.arready,
+			--  AXI read-data channel
+			s_axi_rdata => axo0.rdata,
+			s_axi_rresp => axo0.rresp,
+			s_axi_rvalid => axo0.rvalid,
+			s_axi_rready => axi0.rready,
+			-- AXI-Stream ports for large numbers
+			s_axis_tdata => s_axis_tdata,
+			s_axis_tvalid => s_axis_tvalid,
+			s_axis_tready => s_axis_tready,
+			m_axis_tdata => m_axis_tdata,
+			m_axis_tvalid => m_axis_tvalid,
+			m_axis_tready => m_axis_tready,
+			m_axis_tlast => m_axis_tlast,
+			-- Clock for Montgomery multipliers in the async case
+			clkmm => clkmm,
+			-- Interrupt
+			irq => irq,
+			-- Busy signal
+			busy => busy,
+			-- HW secure/SCA analysis feature (off-chip trigger)
+			dbgtrigger => open,
+			dbghalted => open,
+			-- Pseudo-trng port
+			dbgptdata => dbgptdata,
+			dbgptvalid => dbgptvalid,
+			dbgptrdy => open,
+			-- clk & clkmm division & out feature
+			clkdivo => open,
+			clkmmdivo => open
+		);
+
+	-- ------------------------------------------
+	-- Emulating stimuli signals to DuT (ecc)
+	-- ------------------------------------------
+	steam: process
+
+		-- write of any register
+		procedure write_reg(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant reg : in rat;
+			constant data : in std_logic_vector(AXIDW - 1 downto 0)) is
+		begin
+			axi.awaddr <= reg & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			axi.wdata <= data;
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+			wait until clk'event and clk = '1';
+		end procedure;
+
+		-- write of a large number through the AXI-Stream slave port
+		procedure axis_write_big(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			signal tdata : out std_logic_vector(AXIDW - 1 downto 0);
+			signal tvalid : out std_logic;
+			signal tready : in std_logic;
+			constant addr : in natural range 0 to nblargenb - 1;
+			constant bignb : in std_logic_vector)
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			poll_until_ready(clk, axi, axo);
+			dw := (others => '0');
+			dw(CTRL_WRITE_NB) := '1';
+			dw(CTRL_AXIS) := '1';
+			dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+				:= std_logic_vector(to_unsigned(addr, FP_ADDR_MSB));
+			write_reg(clk, axi, axo, W_CTRL, dw);
+			-- no polling of R_STATUS between words: the IP back-pressures
+			-- the stream with TREADY
+			for i in 0 to NBW - 1 loop
+				tdata <= bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+				tvalid <= '1';
+				wait until clk'event and clk = '1' and tready = '1';
+			end loop;
+			tdata <= (others => 'X');
+			tvalid <= '0';
+			poll_until_ready(clk, axi, axo);
+		end procedure;
+
+		-- read of a large number through the AXI-Stream master port
+		procedure axis_read_big(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			signal tdata : in std_logic_vector(AXIDW - 1 downto 0);
+			signal tvalid : in std_logic;
+			signal tready : out std_logic;
+			signal tlast : in std_logic;
+			constant addr : in natural range 0 to nblargenb - 1;
+			variable bignb : out std_logic1024;
+			variable tlastok : out boolean)
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			poll_until_ready(clk, axi, axo);
+			dw := (others => '0');
+			dw(CTRL_READ_NB) := '1';
+			dw(CTRL_AXIS) := '1';
+			dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+				:= std_logic_vector(to_unsigned(addr, FP_ADDR_MSB));
+			write_reg(clk, axi, axo, W_CTRL, dw);
+			bignb := (others => '0');
+			tlastok := TRUE;
+			tready <= '1';
+			for i in 0 to NBW - 1 loop
+				wait until clk'event and clk = '1' and tvalid = '1';
+				bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i) := tdata;
+				if (i = NBW - 1 and tlast /= '1') or (i < NBW - 1 and tlast /= '0')
+				then
+					tlastok := FALSE;
+				end if;
+			end loop;
+			tready <= '0';
+			poll_until_ready(clk, axi, axo);
+		end procedure;
+
+		variable bignb, refnb : std_logic1024;
+		variable t0, t1 : time;
+		variable twr, trd, tswr, tsrd : time;
+		variable tlastok : boolean;
+		variable nok : natural;
+	begin
+
+		--
+		-- Time 0
+		--
+		axi0.awvalid <= '0';
+		axi0.wvalid <= '0';
+		axi0.bready <= '1';
+		axi0.arvalid <= '0';
+		axi0.rready <= '1';
+		axi0.awprot <= (others => '0');
+		axi0.arprot <= (others => '0');
+		axi0.wstrb <= (others => '1');
+
+		s_axis_tdata <= (others => 'X');
+		s_axis_tvalid <= '0';
+		m_axis_tready <= '0';
+
+		refnb := (others => '0');
+		refnb(VALNN - 1 downto 0) := BIG_XP_BPOOL192R1(VALNN - 1 downto 0);
+
+		assert axistream
+			report "ecc_axis_tb: 'axistream' must be TRUE in ecc_customize.vhd"
+				severity FAILURE;
+
+		--
+		-- Wait for out-of-reset.
+		--
+		wait until s_axi_aresetn = '1';
+		echol("[ ecc_axis_tb.vhd ]: Out-of-reset");
+		wait for 333 ns;
+		wait until s_axi_aclk'event and s_axi_aclk = '1';
+
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		if nn_dynamic then
+			set_nn(s_axi_aclk, axi0, axo0, VALNN);
+		end if;
+
+		echol("[ ecc_axis_tb.vhd ]: Init done");
+
+		nok := 0;
+
+		--
+		-- Transfers through W_WRITE_DATA & R_READ_DATA.
+		--
+		t0 := now;
+		write_big(s_axi_aclk, axi0, axo0, VALNN, LARGE_NB_XR1_ADDR, refnb);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		t1 := now;
+		twr := t1 - t0;
+		bignb := (others => '0');
+		t0 := now;
+		read_big(s_axi_aclk, axi0, axo0, VALNN, LARGE_NB_XR1_ADDR, bignb);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		t1 := now;
+		trd := t1 - t0;
+		if bignb(VALNN - 1 downto 0) /= refnb(VALNN - 1 downto 0) then
+			echol("[ ecc_axis_tb.vhd ]: **** FAILED! **** Wrong readback "
+				& "through R_READ_DATA");
+			nok := nok + 1;
+		end if;
+
+		--
+		-- Transfers through the AXI-Stream ports (the number is first erased
+		-- through W_WRITE_DATA so that the stream readback cannot be a
+		-- leftover of the previous write).
+		--
+		bignb := (others => '0');
+		write_big(s_axi_aclk, axi0, axo0, VALNN, LARGE_NB_XR1_ADDR, bignb);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		t0 := now;
+		axis_write_big(s_axi_aclk, axi0, axo0, s_axis_tdata, s_axis_tvalid,
+			s_axis_tready, LARGE_NB_XR1_ADDR, refnb);
+		t1 := now;
+		tswr := t1 - t0;
+		t0 := now;
+		axis_read_big(s_axi_aclk, axi0, axo0, m_axis_tdata, m_axis_tvalid,
+			m_axis_tready, m_axis_tlast, LARGE_NB_XR1_ADDR, bignb, tlastok);
+		t1 := now;
+		tsrd := t1 - t0;
+		if bignb(VALNN - 1 downto 0) /= refnb(VALNN - 1 downto 0) then
+			echo("[ ecc_axis_tb.vhd ]: **** FAILED! **** Wrong readback "
+				& "through the AXI-Stream port: 0x");
+			hex_echol(bignb(VALNN - 1 downto 0));
+			nok := nok + 1;
+		end if;
+		if not tlastok then
+			echol("[ ecc_axis_tb.vhd ]: **** FAILED! **** TLAST not asserted "
+				& "with the last word only");
+			nok := nok + 1;
+		end if;
+
+		-- cross-check: what was written through the stream must also be read
+		-- back through R_READ_DATA
+		bignb := (others => '0');
+		read_big(s_axi_aclk, axi0, axo0, VALNN, LARGE_NB_XR1_ADDR, bignb);
+		if bignb(VALNN - 1 downto 0) /= refnb(VALNN - 1 downto 0) then
+			echol("[ ecc_axis_tb.vhd ]: **** FAILED! **** Number written through "
+				& "the AXI-Stream port differs when read through R_READ_DATA");
+			nok := nok + 1;
+		end if;
+
+		echol("[ ecc_axis_tb.vhd ]: Write of one " & integer'image(VALNN)
+			& "-bit coordinate: " & integer'image(twr / CLKPER)
+			& " cycles through W_WRITE_DATA, " & integer'image(tswr / CLKPER)
+			& " cycles through AXI-Stream");
+		echol("[ ecc_axis_tb.vhd ]: Read of one " & integer'image(VALNN)
+			& "-bit coordinate: " & integer'image(trd / CLKPER)
+			& " cycles through R_READ_DATA, " & integer'image(tsrd / CLKPER)
+			& " cycles through AXI-Stream");
+
+		if nok = 0 then
+			echol("[ ecc_axis_tb.vhd ]: SUCCESSFULL: large numbers transferred "
+				& "through the AXI-Stream ports are the expected ones");
+		end if;
+		assert nok = 0 severity FAILURE;
+
+		echol("[ ecc_axis_tb.vhd ]: End of simulation");
+		assert FALSE severity FAILURE;
+		wait;
+	end process steam;
+
+end architecture sim;
@@ -0,0 +1,794 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.ecc_tb_pkg.all;
+use work.ecc_tb_vec.all;
+use work.ecc_vars.all;
+use work.ecc_software.all;
+
+use std.textio.all;
+
+-- Testbench for the hardware command queue of 'ecc' (see (s287) in
+-- ecc_axi.vhd, requires 'cmdqsize' > 0 in ecc_customize.vhd).
+--
+-- The same [k]P computation (on curve BRAINPOOLP192R1) is first run alone,
+-- driven by software as in ecc_tb.vhd, to get a reference result & duration.
+-- Then NBKP complete [k]P descriptors (token generation & readback, writes
+-- of the scalar & of the point, [k]P command, readback of the result and
+-- completion marker) are enqueued before the queue is enabled. The IP is
+-- expected to chain them without any software intervention, raising one
+-- single (coalesced) IRQ at the end. The testbench then checks that:
+--
+--   - all results popped from the result FIFO match the reference one ;
+--   - the dispatcher never stalled while the IP was idle (R_CMDQ_IDLE = 0).
+--
+-- The time elapsed between the end of one [k]P computation and the start of
+-- the next one (as seen on output 'busy') is also displayed.
+--
+-- Then reads of a large number producing more words than the result FIFO
+-- can hold are enqueued and not popped until the FIFO is full: software
+-- must still be able to access the IP (see (s314) in ecc_axi.vhd), and all
+-- the words must be popped in the end (a watchdog ends the simulation with
+-- a failure if the AXI interface gets stuck).
+--
+-- Then NBORD [k]P descriptors with different scalars are enqueued while the
+-- queue is enabled, all but the first one while the [k]P of the first one
+-- is in progress: their results must be popped in the order of the
+-- descriptors.
+--
+-- Last, the (disabled) command queue is filled up and one more entry is
+-- pushed: it must be dropped with error STATUS_ERR_I_WREG_FBD raised, and a
+-- flush must empty the queue.
+entity ecc_cmdq_tb is
+end entity ecc_cmdq_tb;
+
+architecture sim of ecc_cmdq_tb is
+
+	-- DuT component declaration
+	component ecc is
+		generic(
+			-- Width of S_AXI data bus
+			C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+			-- Width of S_AXI address bus
+			C_S_AXI_ADDR_WIDTH : integer := AXIAW -- in ecc_pkg
+			);
+		port(
+			-- AXI clock & reset
+			s_axi_aclk : in  std_logic;
+			s_axi_aresetn : in std_logic; -- asyn asserted, syn deasserted, active low
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			--  AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation
+			busy : out std_logic;
+			-- HW unsecure/SCA analysis feature (off-chip trigger)
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic;
+			-- clk & clkmm division & out feature
+			clkdivo : out std_logic;
+			clkmmdivo : out std_logic
+		);
+	end component ecc;
+
+	-- AXI signal buses (DuT), driven by the procedures of ecc_tb_pkg
+	signal axi0 : axi_in_type;
+	signal axo0 : axi_out_type;
+
+	signal s_axi_aclk, s_axi_aresetn : std_logic;
+
+	signal clkmm : std_logic;
+
+	signal irq : std_logic;
+	signal busy : std_logic;
+
+	-- Pseudo TRNG port (unused here)
+	signal dbgptdata : std_logic_vector(7 downto 0);
+	signal dbgptvalid : std_logic;
+
+	constant VALNN : positive := 192;
+	-- nb of AXI words of a large number
+	constant NBW : positive := div(VALNN, AXIDW);
+	-- nb of [k]P computations enqueued at once
+	constant NBKP : positive := 4;
+	-- nb of [k]P computations enqueued while the first of them is in progress
+	constant NBORD : positive := 3;
+	-- nb of words pushed into the result FIFO by each [k]P descriptor
+	-- (token, [k]P.x, [k]P.y, tag & status)
+	constant NBRES : positive := (3 * NBW) + 2;
+	-- nb of reads of a large number enqueued to fill the result FIFO
+	constant NBFILL : positive := (max(cmdqsize, 2) / NBW) + 2;
+	-- watchdog of the test of the result FIFO getting full
+	constant FILL_TIMEOUT : time := 1 ms;
+
+	type std_logic1024_array is array(natural range <>) of std_logic1024;
+
+	-- set by the stimuli process when the [k]P computations that are to
+	-- be monitored (the ones replayed from the command queue) start
+	signal monitor : boolean := FALSE;
+
+	-- set by the stimuli process when it starts to fill the result FIFO
+	signal filling : boolean := FALSE;
+
+begin
+
+	-- Emulate AXI reset.
+	process
+	begin
+		s_axi_aresetn <= '0';
+		wait for 333 ns;
+		s_axi_aresetn <= '1';
+		wait;
+	end process;
+
+	-- Emulate AXI clock (150 MHz).
+	process
+	begin
+		s_axi_aclk <= '0';
+		wait for 3.333 ns;
+		s_axi_aclk <= '1';
+		wait for 3.333 ns;
+	end process;
+
+	-- Emulate clkmm clock (374 MHz).
+	process
+	begin
+		clkmm <= '0';
+		wait for 1.336 ns;
+		clkmm <= '1';
+		wait for 1.336 ns;
+	end process;
+
+	dbgptdata <= (others => '0');
+	dbgptvalid <= '0';
+
+	-- DuT instance
+	e0: ecc
+		generic map(
+			C_S_AXI_DATA_WIDTH => AXIDW,
+			C_S_AXI_ADDR_WIDTH => AXIAW)
+		port map(
+			-- AXI clock & reset
+			s_axi_aclk => s_axi_aclk,
+			s_axi_aresetn => s_axi_aresetn,
+			-- AXI write-address channel
+			s_axi_awaddr => axi0.awaddr,
+			s_axi_awprot => axi0.awprot,
+			s_axi_awvalid => axi0.awvalid,
+			s_axi_awready => axo0.awready,
+			-- AXI write-data channel
+			s_axi_wdata => axi0.wdata,
+			s_axi_wstrb => axi0.wstrb,
+			s_axi_wvalid => axi0.wvalid,
+			s_axi_wready => axo0.wready,
+			-- AXI write-response channel
+			s_axi_bresp => axo0.bresp,
+			s_axi_bvalid => axo0.bvalid,
+			s_axi_bready => axi0.bready,
+			-- AXI read-address channel
+			s_axi_araddr => axi0.araddr,
+			s_axi_arprot => axi0.arprot,
+			s_axi_arvalid => axi0.arvalid,
+			s_axi_arready => axo0.arready,
+			--  AXI read-data channel
+			s_axi_rdata => axo0.rdata,
+			s_axi_rresp => axo0.rresp,
+			s_axi_rvalid => axo0.rvalid,
+			s_axi_rready => axi0.rready,
+			-- Clock for Montgomery multipliers in the async case
+			clkmm => clkmm,
+			-- Interrupt
+			irq => irq,
+			-- Busy signal
+			busy => busy,
+			-- HW secure/SCA analysis feature (off-chip trigger)
+			dbgtrigger => open,
+			dbghalted => open,
+			-- Pseudo-trng port
+			dbgptdata => dbgptdata,
+			dbgptvalid => dbgptvalid,
+			dbgptrdy => open,
+			-- clk & clkmm division & out feature
+			clkdivo => open,
+			clkmmdivo => open
+		);
+
+	-- ------------------------------------------------------------
+	-- Display the time elapsed between two consecutive [k]P computations
+	-- replayed from the command queue
+	-- ------------------------------------------------------------
+	kpmon: process
+		variable tend : time;
+		variable nkp : natural;
+	begin
+		wait until monitor;
+		nkp := 0;
+		loop
+			wait until busy'event and busy = '1';
+			if nkp > 0 then
+				echol("[ ecc_cmdq_tb.vhd ]: [k]P #" & integer'image(nkp)
+					& " started " & time'image(now - tend)
+					& " after the end of [k]P #" & integer'image(nkp - 1));
+			end if;
+			wait until busy'event and busy = '0';
+			tend := now;
+			nkp := nkp + 1;
+		end loop;
+	end process kpmon;
+
+	-- ------------------------------------------------------------
+	-- Watchdog of the test of the result FIFO getting full
+	-- ------------------------------------------------------------
+	fillwd: process
+	begin
+		wait until filling;
+		wait until not filling for FILL_TIMEOUT;
+		if filling then
+			echol("[ ecc_cmdq_tb.vhd ]: **** FAILED! **** AXI interface stuck with "
+				& "a full result FIFO");
+			assert FALSE severity FAILURE;
+		end if;
+		wait;
+	end process fillwd;
+
+	-- ------------------------------------------
+	-- Emulating stimuli signals to DuT (ecc)
+	-- ------------------------------------------
+	steam: process
+
+		-- write of any register
+		procedure write_reg(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant reg : in rat;
+			constant data : in std_logic_vector(AXIDW - 1 downto 0)) is
+		begin
+			axi.awaddr <= reg & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			axi.wdata <= data;
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+			wait until clk'event and clk = '1';
+		end procedure;
+
+		-- read of any register
+		procedure read_reg(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant reg : in rat;
+			variable data : out std_logic_vector(AXIDW - 1 downto 0)) is
+		begin
+			axi.araddr <= reg & "000"; axi.arvalid <= '1';
+			wait until clk'event and clk = '1' and axo.arready = '1';
+			axi.araddr <= (others => 'X'); axi.arvalid <= '0'; axi.rready <= '1';
+			wait until clk'event and clk = '1' and axo.rvalid = '1';
+			data := axo.rdata;
+			axi.rready <= '0';
+			wait until clk'event and clk = '1';
+		end procedure;
+
+		-- push of one entry into the command queue (through W_CMDQ_OP &
+		-- W_CMDQ_PUSH registers)
+		procedure cmdq_push(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant kind : in std_logic_vector(1 downto 0);
+			constant reg : in rat;
+			constant data : in std_logic_vector(AXIDW - 1 downto 0))
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			dw := (others => '0');
+			dw(CMDQ_OP_KIND_MSB downto CMDQ_OP_KIND_LSB) := kind;
+			dw(CMDQ_OP_REG_MSB downto CMDQ_OP_REG_LSB) := reg;
+			write_reg(clk, axi, axo, W_CMDQ_OP, dw);
+			write_reg(clk, axi, axo, W_CMDQ_PUSH, data);
+		end procedure;
+
+		-- enqueue the write of a large number
+		procedure cmdq_push_write_big(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant addr : in natural range 0 to nblargenb - 1;
+			constant scalar : in boolean;
+			constant bignb : in std_logic_vector)
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			dw := (others => '0');
+			dw(CTRL_WRITE_NB) := '1';
+			if scalar then
+				dw(CTRL_WRITE_K) := '1';
+			end if;
+			dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+				:= std_logic_vector(to_unsigned(addr, FP_ADDR_MSB));
+			cmdq_push(clk, axi, axo, CMDQ_KIND_WRITE, W_CTRL, dw);
+			for i in 0 to NBW - 1 loop
+				cmdq_push(clk, axi, axo, CMDQ_KIND_WRITE, W_WRITE_DATA,
+					bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i));
+			end loop;
+		end procedure;
+
+		-- enqueue the read of a large number (or of the token)
+		procedure cmdq_push_read_big(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant addr : in natural range 0 to nblargenb - 1;
+			constant token : in boolean)
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			dw := (others => '0');
+			dw(CTRL_READ_NB) := '1';
+			if token then
+				dw(CTRL_RD_TOKEN) := '1';
+			end if;
+			dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+				:= std_logic_vector(to_unsigned(addr, FP_ADDR_MSB));
+			cmdq_push(clk, axi, axo, CMDQ_KIND_WRITE, W_CTRL, dw);
+			cmdq_push(clk, axi, axo, CMDQ_KIND_READ, W_CTRL, -- reg indifferent
+				std_logic_vector(to_unsigned(NBW, AXIDW)));
+		end procedure;
+
+		-- pop of a large number from the result FIFO
+		procedure cmdq_pop_big(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			variable bignb : out std_logic1024)
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			bignb := (others => '0');
+			for i in 0 to NBW - 1 loop
+				read_reg(clk, axi, axo, R_CMDQ_RESULT, dw);
+				bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i) := dw;
+			end loop;
+		end procedure;
+
+		-- enqueue a complete [k]P descriptor (token generation & readback,
+		-- writes of the scalar & of the point, [k]P command, readback of the
+		-- result and completion marker with tag 'tag')
+		procedure cmdq_push_kp(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant k : in std_logic1024;
+			constant tag : in natural)
+		is
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			-- token generation & readback of it
+			cmdq_push(clk, axi, axo, CMDQ_KIND_WRITE, W_TOKEN,
+				std_logic_vector(to_unsigned(1, AXIDW)));
+			cmdq_push_read_big(clk, axi, axo, 0, TRUE);
+			-- scalar & point
+			cmdq_push_write_big(clk, axi, axo, LARGE_NB_K_ADDR, TRUE, k);
+			cmdq_push_write_big(clk, axi, axo, LARGE_NB_XR1_ADDR, FALSE,
+				BIG_XP_BPOOL192R1);
+			cmdq_push_write_big(clk, axi, axo, LARGE_NB_YR1_ADDR, FALSE,
+				BIG_YP_BPOOL192R1);
+			-- [k]P command
+			dw := (others => '0');
+			dw(CTRL_KP) := '1';
+			cmdq_push(clk, axi, axo, CMDQ_KIND_WRITE, W_CTRL, dw);
+			-- readback of the result
+			cmdq_push_read_big(clk, axi, axo, LARGE_NB_XR1_ADDR, FALSE);
+			cmdq_push_read_big(clk, axi, axo, LARGE_NB_YR1_ADDR, FALSE);
+			-- completion marker
+			cmdq_push(clk, axi, axo, CMDQ_KIND_DONE, W_CTRL,
+				std_logic_vector(to_unsigned(tag, AXIDW)));
+		end procedure;
+
+		-- pop the NBRES words pushed into the result FIFO by the [k]P
+		-- descriptor with tag 'tag' & check them (nb of errors added to 'nok')
+		procedure cmdq_pop_kp(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant tag : in natural;
+			constant refx, refy : in std_logic1024;
+			variable nok : inout natural)
+		is
+			variable vtoken, kpx, kpy : std_logic1024;
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			cmdq_pop_big(clk, axi, axo, vtoken);
+			cmdq_pop_big(clk, axi, axo, kpx);
+			cmdq_pop_big(clk, axi, axo, kpy);
+			kpx := kpx xor vtoken;
+			kpy := kpy xor vtoken;
+			-- tag
+			read_reg(clk, axi, axo, R_CMDQ_RESULT, dw);
+			if to_integer(unsigned(dw)) /= tag then
+				echol("[ ecc_cmdq_tb.vhd ]: **** FAILED! **** Wrong tag "
+					& integer'image(to_integer(unsigned(dw))) & " for [k]P #"
+					& integer'image(tag));
+				nok := nok + 1;
+			end if;
+			-- snapshot of R_STATUS
+			read_reg(clk, axi, axo, R_CMDQ_RESULT, dw);
+			if dw(STATUS_ERR_MSB downto STATUS_ERR_LSB) /= (
+				STATUS_ERR_MSB downto STATUS_ERR_LSB => '0')
+			then
+				echol("[ ecc_cmdq_tb.vhd ]: **** FAILED! **** Error flags raised "
+					& "during [k]P #" & integer'image(tag));
+				nok := nok + 1;
+			end if;
+			if kpx(VALNN - 1 downto 0) /= refx(VALNN - 1 downto 0)
+				or kpy(VALNN - 1 downto 0) /= refy(VALNN - 1 downto 0)
+			then
+				echo("[ ecc_cmdq_tb.vhd ]: **** FAILED! **** [k]P #"
+					& integer'image(tag) & " returned x = 0x");
+				hex_echol(kpx(VALNN - 1 downto 0));
+				nok := nok + 1;
+			end if;
+		end procedure;
+
+		variable kval : std_logic1024;
+		variable kord, ordx, ordy : std_logic1024_array(0 to NBORD - 1);
+		variable vtoken : std_logic1024;
+		variable refx, refy : std_logic1024;
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		variable t0, t1 : time;
+		variable tref, tall : time;
+		variable nok : natural;
+		variable nbres, nbpop : natural;
+	begin
+
+		--
+		-- Time 0
+		--
+		axi0.awvalid <= '0';
+		axi0.wvalid <= '0';
+		axi0.bready <= '1';
+		axi0.arvalid <= '0';
+		axi0.rready <= '1';
+		axi0.awprot <= (others => '0');
+		axi0.arprot <= (others => '0');
+		axi0.wstrb <= (others => '1');
+
+		kval := (others => '0');
+		kval(191 downto 0) := x"0123456789abcdeffedcba98765432100123456789abcdef";
+
+		assert cmdqsize > 0
+			report "ecc_cmdq_tb: 'cmdqsize' must be > 0 in ecc_customize.vhd"
+				severity FAILURE;
+		assert cmdqsize >= NBKP * ((3 * NBW) + 12)
+			and cmdqsize >= NBKP * NBRES
+			report "ecc_cmdq_tb: 'cmdqsize' too small for the NBKP descriptors"
+				severity FAILURE;
+		assert cmdqsize >= 2 * NBFILL
+			report "ecc_cmdq_tb: 'cmdqsize' too small to fill the result FIFO"
+				severity FAILURE;
+
+		--
+		-- Wait for out-of-reset.
+		--
+		wait until s_axi_aresetn = '1';
+		echol("[ ecc_cmdq_tb.vhd ]: Out-of-reset");
+		wait for 333 ns;
+		wait until s_axi_aclk'event and s_axi_aclk = '1';
+
+		--
+		-- Wait until the IP has done its (possible) init stuff, then program
+		-- the curve.
+		--
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		if not hwsecure then
+			debug_trng_use_real(s_axi_aclk, axi0, axo0);
+			debug_trng_pp_start_pulling_raw(s_axi_aclk, axi0, axo0);
+		end if;
+		if nn_dynamic then
+			set_nn(s_axi_aclk, axi0, axo0, VALNN);
+		end if;
+		set_curve(s_axi_aclk, axi0, axo0, VALNN, CURVE_PARAM_192);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		configure_irq(s_axi_aclk, axi0, axo0, TRUE);
+
+		echol("[ ecc_cmdq_tb.vhd ]: Init done");
+
+		--
+		-- Reference: one single [k]P computation driven by software.
+		--
+		get_token(s_axi_aclk, axi0, axo0, VALNN, vtoken);
+		t0 := now;
+		scalar_mult(s_axi_aclk, axi0, axo0, VALNN, kval,
+			BIG_XP_BPOOL192R1, BIG_YP_BPOOL192R1, FALSE);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		display_errors(s_axi_aclk, axi0, axo0);
+		read_and_return_kp_result(s_axi_aclk, axi0, axo0, VALNN, vtoken,
+			refx, refy);
+		t1 := now;
+		tref := t1 - t0;
+		refx := refx xor vtoken;
+		refy := refy xor vtoken;
+		ack_all_errors(s_axi_aclk, axi0, axo0);
+		echol("[ ecc_cmdq_tb.vhd ]: One [k]P driven by software took "
+			& time'image(tref));
+
+		--
+		-- References of the NBORD scalars of the ordering test (the first one
+		-- being the one above).
+		--
+		kord(0) := kval;
+		ordx(0) := refx;
+		ordy(0) := refy;
+		for i in 1 to NBORD - 1 loop
+			kord(i) := kval;
+			kord(i)(7 downto 0) := std_logic_vector(to_unsigned(16#11# * i, 8));
+			get_token(s_axi_aclk, axi0, axo0, VALNN, vtoken);
+			scalar_mult(s_axi_aclk, axi0, axo0, VALNN, kord(i),
+				BIG_XP_BPOOL192R1, BIG_YP_BPOOL192R1, FALSE);
+			poll_until_ready(s_axi_aclk, axi0, axo0);
+			read_and_return_kp_result(s_axi_aclk, axi0, axo0, VALNN, vtoken,
+				ordx(i), ordy(i));
+			ordx(i) := ordx(i) xor vtoken;
+			ordy(i) := ordy(i) xor vtoken;
+			ack_all_errors(s_axi_aclk, axi0, axo0);
+		end loop;
+
+		--
+		-- Enqueue NBKP [k]P descriptors (queue is still disabled).
+		--
+		for i in 0 to NBKP - 1 loop
+			cmdq_push_kp(s_axi_aclk, axi0, axo0, kval, i);
+		end loop;
+
+		echol("[ ecc_cmdq_tb.vhd ]: " & integer'image(NBKP)
+			& " [k]P descriptors enqueued");
+
+		--
+		-- Enable the queue (one single IRQ for the NBKP completions) and then
+		-- stay away from the AXI interface until the IRQ is raised.
+		--
+		dw := (others => '0');
+		dw(CMDQ_CTRL_EN) := '1';
+		dw(CMDQ_CTRL_IRQ_MSB downto CMDQ_CTRL_IRQ_LSB) :=
+			std_logic_vector(to_unsigned(NBKP, 16));
+		monitor <= TRUE;
+		t0 := now;
+		write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_CTRL, dw);
+		wait until irq'event and irq = '1';
+		t1 := now;
+		tall := t1 - t0;
+
+		--
+		-- Check that the dispatcher never stalled.
+		--
+		read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_IDLE, dw);
+		echol("[ ecc_cmdq_tb.vhd ]: R_CMDQ_IDLE = "
+			& integer'image(to_integer(unsigned(dw))) & " cycle(s)");
+		assert unsigned(dw) = 0
+			report "ecc_cmdq_tb: dispatcher stalled while the IP was idle"
+				severity ERROR;
+
+		read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+		assert to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB)))
+			= NBKP * NBRES
+			report "ecc_cmdq_tb: unexpected nb of words in result FIFO"
+				severity FAILURE;
+
+		--
+		-- Pop & check results.
+		--
+		nok := 0;
+		for i in 0 to NBKP - 1 loop
+			cmdq_pop_kp(s_axi_aclk, axi0, axo0, i, refx, refy, nok);
+		end loop;
+
+		echol("[ ecc_cmdq_tb.vhd ]: " & integer'image(NBKP)
+			& " [k]P from the command queue took " & time'image(tall) & " (i.e "
+			& integer'image((100 * (tall / 1 ns)) / (NBKP * (tref / 1 ns)))
+			& "% of " & integer'image(NBKP) & " [k]P driven by software)");
+
+		if nok = 0 then
+			echol("[ ecc_cmdq_tb.vhd ]: SUCCESSFULL: all [k]P replayed from the "
+				& "command queue returned the expected result");
+		end if;
+		assert nok = 0 severity FAILURE;
+
+		--
+		-- Fill the result FIFO (the queue is still enabled) with NBFILL reads
+		-- of [k]P.x, i.e more words than it can hold, and don't pop any of them
+		-- until it is full.
+		--
+		filling <= TRUE;
+		for i in 0 to NBFILL - 1 loop
+			cmdq_push_read_big(s_axi_aclk, axi0, axo0, LARGE_NB_XR1_ADDR, FALSE);
+		end loop;
+		echol("[ ecc_cmdq_tb.vhd ]: " & integer'image(NBFILL) & " reads of "
+			& integer'image(NBW) & " words enqueued, waiting for the result "
+			& "FIFO to get full");
+		loop
+			read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+			nbres := to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB)));
+			exit when nbres = cmdqsize;
+			assert nbres < cmdqsize
+				report "ecc_cmdq_tb: more words in result FIFO than its size"
+					severity FAILURE;
+		end loop;
+		echol("[ ecc_cmdq_tb.vhd ]: Result FIFO full, IP still accessible");
+
+		--
+		-- Pop everything: the dispatcher resumes as room is made in the FIFO.
+		--
+		nbpop := 0;
+		while nbpop < NBFILL * NBW loop
+			read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+			nbres := to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB)));
+			for i in 1 to nbres loop
+				read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_RESULT, dw);
+				nbpop := nbpop + 1;
+			end loop;
+		end loop;
+		read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+		assert nbpop = NBFILL * NBW
+			and to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB))) = 0
+			and to_integer(unsigned(dw(CMDQ_ST_FREE_MSB downto CMDQ_ST_FREE_LSB)))
+				= cmdqsize
+			report "ecc_cmdq_tb: unexpected nb of words popped from result FIFO"
+				severity FAILURE;
+		echol("[ ecc_cmdq_tb.vhd ]: SUCCESSFULL: " & integer'image(nbpop)
+			& " words popped from the result FIFO after it got full");
+		filling <= FALSE;
+
+		--
+		-- Enqueue NBORD [k]P descriptors, the queue being enabled: the first
+		-- one is replayed as it is pushed, the others are pushed while its
+		-- [k]P computation is in progress.
+		--
+		dw := (others => '0');
+		dw(CMDQ_CTRL_EN) := '1';
+		dw(CMDQ_CTRL_IRQ_MSB downto CMDQ_CTRL_IRQ_LSB) :=
+			std_logic_vector(to_unsigned(NBORD, 16));
+		write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_CTRL, dw);
+		nok := 0;
+		t0 := now;
+		cmdq_push_kp(s_axi_aclk, axi0, axo0, kord(0), 0);
+		if busy /= '1' then
+			wait until busy = '1';
+		end if;
+		for i in 1 to NBORD - 1 loop
+			cmdq_push_kp(s_axi_aclk, axi0, axo0, kord(i), i);
+		end loop;
+		if busy /= '1' then
+			echol("[ ecc_cmdq_tb.vhd ]: **** FAILED! **** [k]P #0 ended before "
+				& "the next descriptors were enqueued");
+			nok := nok + 1;
+		end if;
+		echol("[ ecc_cmdq_tb.vhd ]: " & integer'image(NBORD - 1)
+			& " [k]P descriptors enqueued while [k]P #0 was in progress");
+		-- wait for all results (bounded by twice the time of as many [k]P
+		-- driven by software)
+		loop
+			read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+			nbres := to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB)));
+			exit when nbres = NBORD * NBRES;
+			if now - t0 > 2 * NBORD * tref then
+				echol("[ ecc_cmdq_tb.vhd ]: **** FAILED! **** Only "
+					& integer'image(nbres) & " words in result FIFO after "
+					& time'image(now - t0));
+				assert FALSE severity FAILURE;
+			end if;
+		end loop;
+		-- results must come out in the order of the descriptors
+		for i in 0 to NBORD - 1 loop
+			cmdq_pop_kp(s_axi_aclk, axi0, axo0, i, ordx(i), ordy(i), nok);
+		end loop;
+		if nok = 0 then
+			echol("[ ecc_cmdq_tb.vhd ]: SUCCESSFULL: [k]P enqueued during a "
+				& "computation returned in order with the expected results");
+		end if;
+		assert nok = 0 severity FAILURE;
+
+		--
+		-- Fill the command queue (disabled, so that nothing is replayed) with
+		-- completion markers, then push one more: it must be dropped & raise
+		-- error STATUS_ERR_I_WREG_FBD.
+		--
+		dw := (others => '0');
+		write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_CTRL, dw);
+		ack_all_errors(s_axi_aclk, axi0, axo0);
+		dw := (others => '0');
+		dw(CMDQ_OP_KIND_MSB downto CMDQ_OP_KIND_LSB) := CMDQ_KIND_DONE;
+		write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_OP, dw);
+		for i in 0 to cmdqsize - 1 loop
+			write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_PUSH,
+				std_logic_vector(to_unsigned(i, AXIDW)));
+		end loop;
+		read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+		assert to_integer(unsigned(dw(CMDQ_ST_FREE_MSB downto CMDQ_ST_FREE_LSB))) = 0
+			report "ecc_cmdq_tb: command queue not full after "
+				& integer'image(cmdqsize) & " pushes"
+				severity FAILURE;
+		read_reg(s_axi_aclk, axi0, axo0, R_STATUS, dw);
+		assert dw(STATUS_ERR_I_WREG_FBD) = '0'
+			report "ecc_cmdq_tb: error raised before the command queue overflowed"
+				severity FAILURE;
+		write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_PUSH,
+			std_logic_vector(to_unsigned(cmdqsize, AXIDW)));
+		read_reg(s_axi_aclk, axi0, axo0, R_STATUS, dw);
+		assert dw(STATUS_ERR_I_WREG_FBD) = '1'
+			report "ecc_cmdq_tb: no error raised upon push into a full command queue"
+				severity FAILURE;
+		read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+		assert to_integer(unsigned(dw(CMDQ_ST_FREE_MSB downto CMDQ_ST_FREE_LSB))) = 0
+			and to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB))) = 0
+			report "ecc_cmdq_tb: unexpected status after command queue overflow"
+				severity FAILURE;
+		-- flush
+		dw := (others => '0');
+		dw(CMDQ_CTRL_FLUSH) := '1';
+		write_reg(s_axi_aclk, axi0, axo0, W_CMDQ_CTRL, dw);
+		read_reg(s_axi_aclk, axi0, axo0, R_CMDQ_STATUS, dw);
+		assert to_integer(unsigned(dw(CMDQ_ST_FREE_MSB downto CMDQ_ST_FREE_LSB)))
+			= cmdqsize
+			and to_integer(unsigned(dw(CMDQ_ST_RES_MSB downto CMDQ_ST_RES_LSB))) = 0
+			report "ecc_cmdq_tb: command queue not empty after flush"
+				severity FAILURE;
+		ack_all_errors(s_axi_aclk, axi0, axo0);
+		echol("[ ecc_cmdq_tb.vhd ]: SUCCESSFULL: push into the full command "
+			& "queue dropped with error, queue emptied by flush");
+
+		echol("[ ecc_cmdq_tb.vhd ]: End of simulation");
+		assert FALSE severity FAILURE;
+		wait;
+	end process steam;
+
+end architecture sim;
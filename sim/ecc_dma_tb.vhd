@@ -0,0 +1,808 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.ecc_tb_pkg.all;
+use work.ecc_tb_vec.all;
+use work.ecc_vars.all;
+use work.ecc_software.all;
+
+use std.textio.all;
+
+-- Testbench for the DMA top-level 'ecc_dma' (see ecc_dma.vhd).
+--
+-- The AXI4 master port of the DuT is connected to a behavioral model of
+-- a memory (single-beat transactions, MEMW words, whose ready signals are
+-- deasserted on pseudo-random cycles to exercise the back-pressure). The same [k]P computation
+-- and one point doubling (on curve BRAINPOOLP192R1) are first run by software
+-- as in ecc_tb.vhd, to get reference results & durations. Then NBJ job
+-- descriptors ([k]P, doubling, [k]P, ...) are written into a ring in the
+-- memory model, and the DMA engine is enabled with an IRQ coalescing
+-- threshold of NBJ. The testbench stays away from the AXI interface until
+-- the IRQ is raised (except for one read of R_STATUS, which is expected
+-- to receive a SLVERR response while the engine owns the IP) and then checks:
+--
+--   - the DMA status register (nb of completed jobs, no bus error) & the
+--     consumer index ;
+--   - that all descriptors were marked as done ;
+--   - that all results, tags & status snapshots written by the engine in
+--     memory match the reference ones.
+--
+-- Then NBJ more descriptors are written into the ring, wrapping around its
+-- end, and handed over to the (still enabled) engine by a new write of the
+-- producer index only: the same checks are made on this second batch.
+entity ecc_dma_tb is
+end entity ecc_dma_tb;
+
+architecture sim of ecc_dma_tb is
+
+	-- DuT component declaration
+	component ecc_dma is
+		generic(
+			C_S_AXI_DATA_WIDTH : integer := axi32or64;
+			C_S_AXI_ADDR_WIDTH : integer := AXIAW + 1;
+			C_M_AXI_ADDR_WIDTH : integer := 32
+		);
+		port(
+			-- AXI clock & reset
+			s_axi_aclk : in std_logic;
+			s_axi_aresetn : in std_logic;
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			-- AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- AXI4 master write-address channel
+			m_axi_awaddr : out std_logic_vector(C_M_AXI_ADDR_WIDTH - 1 downto 0);
+			m_axi_awlen : out std_logic_vector(7 downto 0);
+			m_axi_awsize : out std_logic_vector(2 downto 0);
+			m_axi_awburst : out std_logic_vector(1 downto 0);
+			m_axi_awcache : out std_logic_vector(3 downto 0);
+			m_axi_awprot : out std_logic_vector(2 downto 0);
+			m_axi_awvalid : out std_logic;
+			m_axi_awready : in std_logic;
+			-- AXI4 master write-data channel
+			m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			m_axi_wlast : out std_logic;
+			m_axi_wvalid : out std_logic;
+			m_axi_wready : in std_logic;
+			-- AXI4 master write-response channel
+			m_axi_bresp : in std_logic_vector(1 downto 0);
+			m_axi_bvalid : in std_logic;
+			m_axi_bready : out std_logic;
+			-- AXI4 master read-address channel
+			m_axi_araddr : out std_logic_vector(C_M_AXI_ADDR_WIDTH - 1 downto 0);
+			m_axi_arlen : out std_logic_vector(7 downto 0);
+			m_axi_arsize : out std_logic_vector(2 downto 0);
+			m_axi_arburst : out std_logic_vector(1 downto 0);
+			m_axi_arcache : out std_logic_vector(3 downto 0);
+			m_axi_arprot : out std_logic_vector(2 downto 0);
+			m_axi_arvalid : out std_logic;
+			m_axi_arready : in std_logic;
+			-- AXI4 master read-data channel
+			m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axi_rresp : in std_logic_vector(1 downto 0);
+			m_axi_rlast : in std_logic;
+			m_axi_rvalid : in std_logic;
+			m_axi_rready : out std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation
+			busy : out std_logic;
+			-- HW unsecure/SCA analysis feature (off-chip trigger)
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic;
+			-- clk & clkmm division & out feature
+			clkdivo : out std_logic;
+			clkmmdivo : out std_logic
+		);
+	end component ecc_dma;
+
+	-- AXI signal buses (DuT), driven by the procedures of ecc_tb_pkg
+	-- (with AXIAW-bit addresses) and extended with the bank select bit
+	-- (0: registers of 'ecc', 1: registers of the DMA engine)
+	signal axi0 : axi_in_type;
+	signal axo0 : axi_out_type;
+	signal dmabank : std_logic;
+	signal awaddr : std_logic_vector(AXIAW downto 0);
+	signal araddr : std_logic_vector(AXIAW downto 0);
+
+	signal s_axi_aclk, s_axi_aresetn : std_logic;
+
+	signal clkmm : std_logic;
+
+	signal irq : std_logic;
+	signal busy : std_logic;
+
+	-- Pseudo TRNG port (unused here)
+	signal dbgptdata : std_logic_vector(7 downto 0);
+	signal dbgptvalid : std_logic;
+
+	constant VALNN : positive := 192;
+	-- nb of AXI words of a large number
+	constant NBW : positive := div(VALNN, AXIDW);
+	-- nb of bytes in one AXI word
+	constant DB : positive := AXIDW / 8;
+	-- nb of jobs (ring of 2**RINGLOG descriptors must hold them)
+	constant NBJ : positive := 3;
+	constant RINGLOG : positive := 2;
+	-- data area of one job: K, P0 (x & y), RES (x, y, token, status & tag)
+	constant SLOTW : positive := (6 * NBW) + 2;
+	constant DATAW : natural := DMA_DESC_WORDS * (2**RINGLOG);
+
+	-- Memory model
+	constant MEMW : positive := 256; -- in words
+	constant MEMAB : positive := log2((MEMW * DB) - 1); -- nb of byte address bits
+	-- bus address of the memory (only the MEMAB lower bits are decoded)
+	constant MEMBASE : unsigned(31 downto 0) := x"80000000";
+	type mem_array_type is array(0 to MEMW - 1)
+		of std_logic_vector(AXIDW - 1 downto 0);
+	shared variable mem : mem_array_type;
+
+	-- AXI4 master port (DuT)
+	signal m_axi_awaddr : std_logic_vector(31 downto 0);
+	signal m_axi_awvalid, m_axi_awready : std_logic;
+	signal m_axi_wdata : std_logic_vector(AXIDW - 1 downto 0);
+	signal m_axi_wvalid, m_axi_wready : std_logic;
+	signal m_axi_bresp : std_logic_vector(1 downto 0);
+	signal m_axi_bvalid, m_axi_bready : std_logic;
+	signal m_axi_araddr : std_logic_vector(31 downto 0);
+	signal m_axi_arvalid, m_axi_arready : std_logic;
+	signal m_axi_rdata : std_logic_vector(AXIDW - 1 downto 0);
+	signal m_axi_rresp : std_logic_vector(1 downto 0);
+	signal m_axi_rlast, m_axi_rvalid, m_axi_rready : std_logic;
+
+	-- memory model state
+	signal mhaveaw, mhavew : std_logic;
+	-- (ready signals are deasserted when mstall = '1', i.e on the cycles
+	-- where bit 0 of a 7-bit LFSR is set)
+	signal mlfsr : std_logic_vector(6 downto 0);
+	signal mstall : std_logic;
+	signal mawaddr : std_logic_vector(31 downto 0);
+	signal mwdata : std_logic_vector(AXIDW - 1 downto 0);
+	signal nbmemrd, nbmemwr : natural;
+
+	-- word index in memory model of a bus address
+	function memidx(a : std_logic_vector) return natural is
+	begin
+		return to_integer(unsigned(a(MEMAB - 1 downto log2(DB - 1))));
+	end function memidx;
+
+	-- bus address of word 'i' of memory model
+	function memaddr(i : natural) return std_logic_vector is
+	begin
+		return std_logic_vector(MEMBASE + to_unsigned(i * DB, 32));
+	end function memaddr;
+
+begin
+
+	-- Emulate AXI reset.
+	process
+	begin
+		s_axi_aresetn <= '0';
+		wait for 333 ns;
+		s_axi_aresetn <= '1';
+		wait;
+	end process;
+
+	-- Emulate AXI clock (150 MHz).
+	process
+	begin
+		s_axi_aclk <= '0';
+		wait for 3.333 ns;
+		s_axi_aclk <= '1';
+		wait for 3.333 ns;
+	end process;
+
+	-- Emulate clkmm clock (374 MHz).
+	process
+	begin
+		clkmm <= '0';
+		wait for 1.336 ns;
+		clkmm <= '1';
+		wait for 1.336 ns;
+	end process;
+
+	awaddr <= dmabank & axi0.awaddr;
+	araddr <= dmabank & axi0.araddr;
+
+	dbgptdata <= (others => '0');
+	dbgptvalid <= '0';
+
+	-- ------------------------------------------------------------
+	-- Behavioral model of the memory (AXI4 slave, single-beat transactions
+	-- only, OKAY responses, one cycle of latency, pseudo-random stalls)
+	-- ------------------------------------------------------------
+	mstall <= mlfsr(0);
+	m_axi_awready <= not mhaveaw and not mstall;
+	m_axi_wready <= not mhavew and not mstall;
+	m_axi_arready <= not m_axi_rvalid and not mstall;
+	m_axi_bresp <= "00";
+	m_axi_rresp <= "00";
+	m_axi_rlast <= '1';
+
+	memory: process(s_axi_aclk)
+		variable vaddr : std_logic_vector(31 downto 0);
+		variable vdata : std_logic_vector(AXIDW - 1 downto 0);
+		variable vhaveaw, vhavew : std_logic;
+	begin
+		if s_axi_aclk'event and s_axi_aclk = '1' then
+			if s_axi_aresetn = '0' then
+				mhaveaw <= '0';
+				mhavew <= '0';
+				m_axi_bvalid <= '0';
+				m_axi_rvalid <= '0';
+				nbmemrd <= 0;
+				nbmemwr <= 0;
+				mlfsr <= "1010011";
+			else
+				-- x^7 + x^6 + 1
+				mlfsr <= mlfsr(5 downto 0) & (mlfsr(6) xor mlfsr(5));
+				-- write transactions
+				vhaveaw := mhaveaw;
+				vhavew := mhavew;
+				vaddr := mawaddr;
+				vdata := mwdata;
+				if m_axi_awvalid = '1' and mhaveaw = '0' and mstall = '0' then
+					vhaveaw := '1';
+					vaddr := m_axi_awaddr;
+					mawaddr <= m_axi_awaddr;
+				end if;
+				if m_axi_wvalid = '1' and mhavew = '0' and mstall = '0' then
+					vhavew := '1';
+					vdata := m_axi_wdata;
+					mwdata <= m_axi_wdata;
+				end if;
+				if m_axi_bvalid = '1' and m_axi_bready = '1' then
+					m_axi_bvalid <= '0';
+				end if;
+				if vhaveaw = '1' and vhavew = '1' and m_axi_bvalid = '0' then
+					mem(memidx(vaddr)) := vdata;
+					vhaveaw := '0';
+					vhavew := '0';
+					m_axi_bvalid <= '1';
+					nbmemwr <= nbmemwr + 1;
+				end if;
+				mhaveaw <= vhaveaw;
+				mhavew <= vhavew;
+				-- read transactions
+				if m_axi_rvalid = '1' and m_axi_rready = '1' then
+					m_axi_rvalid <= '0';
+				end if;
+				if m_axi_arvalid = '1' and m_axi_rvalid = '0' and mstall = '0' then
+					m_axi_rdata <= mem(memidx(m_axi_araddr));
+					m_axi_rvalid <= '1';
+					nbmemrd <= nbmemrd + 1;
+				end if;
+			end if;
+		end if;
+	end process memory;
+
+	-- DuT instance
+	e0: ecc_dma
+		generic map(
+			C_S_AXI_DATA_WIDTH => AXIDW,
+			C_S_AXI_ADDR_WIDTH => AXIAW + 1,
+			C_M_AXI_ADDR_WIDTH => 32)
+		port map(
+			-- AXI clock & reset
+			s_axi_aclk => s_axi_aclk,
+			s_axi_aresetn => s_axi_aresetn,
+			-- AXI write-address channel
+			s_axi_awaddr => awaddr,
+			s_axi_awprot => axi0.awprot,
+			s_axi_awvalid => axi0.awvalid,
+			s_axi_awready => axo0.awready,
+			-- AXI write-data channel
+			s_axi_wdata => axi0.wdata,
+			s_axi_wstrb => axi0.wstrb,
+			s_axi_wvalid => axi0.wvalid,
+			s_axi_wready => axo0.wready,
+			-- AXI write-response channel
+			s_axi_bresp => axo0.bresp,
+			s_axi_bvalid => axo0.bvalid,
+			s_axi_bready => axi0.bready,
+			-- AXI read-address channel
+			s_axi_araddr => araddr,
+			s_axi_arprot => axi0.arprot,
+			s_axi_arvalid => axi0.arvalid,
+			s_axi_arready => axo0.arready,
+			--  AXI read-data channel
+			s_axi_rdata => axo0.rdata,
+			s_axi_rresp => axo0.rresp,
+			s_axi_rvalid => axo0.rvalid,
+			s_axi_rready => axi0.rready,
+			-- AXI4 master port (memory model)
+			m_axi_awaddr => m_axi_awaddr,
+			m_axi_awlen => open,
+			m_axi_awsize => open,
+			m_axi_awburst => open,
+			m_axi_awcache => open,
+			m_axi_awprot => open,
+			m_axi_awvalid => m_axi_awvalid,
+			m_axi_awready => m_axi_awready,
+			m_axi_wdata => m_axi_wdata,
+			m_axi_wstrb => open,
+			m_axi_wlast => open,
+			m_axi_wvalid => m_axi_wvalid,
+			m_axi_wready => m_axi_wready,
+			m_axi_bresp => m_axi_bresp,
+			m_axi_bvalid => m_axi_bvalid,
+			m_axi_bready => m_axi_bready,
+			m_axi_araddr => m_axi_araddr,
+			m_axi_arlen => open,
+			m_axi_arsize => open,
+			m_axi_arburst => open,
+			m_axi_arcache => open,
+			m_axi_arprot => open,
+			m_axi_arvalid => m_axi_arvalid,
+			m_axi_arready => m_axi_arready,
+			m_axi_rdata => m_axi_rdata,
+			m_axi_rresp => m_axi_rresp,
+			m_axi_rlast => m_axi_rlast,
+			m_axi_rvalid => m_axi_rvalid,
+			m_axi_rready => m_axi_rready,
+			-- Clock for Montgomery multipliers in the async case
+			clkmm => clkmm,
+			-- Interrupt
+			irq => irq,
+			-- Busy signal
+			busy => busy,
+			-- HW secure/SCA analysis feature (off-chip trigger)
+			dbgtrigger => open,
+			dbghalted => open,
+			-- Pseudo-trng port
+			dbgptdata => dbgptdata,
+			dbgptvalid => dbgptvalid,
+			dbgptrdy => open,
+			-- clk & clkmm division & out feature
+			clkdivo => open,
+			clkmmdivo => open
+		);
+
+	-- ------------------------------------------
+	-- Emulating stimuli signals to DuT (ecc_dma)
+	-- ------------------------------------------
+	steam: process
+
+		-- write of any register
+		procedure write_reg(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant reg : in rat;
+			constant data : in std_logic_vector(AXIDW - 1 downto 0)) is
+		begin
+			axi.awaddr <= reg & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			axi.wdata <= data;
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+			wait until clk'event and clk = '1';
+		end procedure;
+
+		-- read of any register (also returning the response)
+		procedure read_reg(
+			signal clk: in std_logic;
+			signal axi: out axi_in_type;
+			signal axo: in axi_out_type;
+			constant reg : in rat;
+			variable data : out std_logic_vector(AXIDW - 1 downto 0);
+			variable resp : out std_logic_vector(1 downto 0)) is
+		begin
+			axi.araddr <= reg & "000"; axi.arvalid <= '1';
+			wait until clk'event and clk = '1' and axo.arready = '1';
+			axi.araddr <= (others => 'X'); axi.arvalid <= '0'; axi.rready <= '1';
+			wait until clk'event and clk = '1' and axo.rvalid = '1';
+			data := axo.rdata;
+			resp := axo.rresp;
+			axi.rready <= '0';
+			wait until clk'event and clk = '1';
+		end procedure;
+
+		-- write of a large number into the memory model
+		procedure mem_write_big(
+			constant woff : in natural;
+			constant bignb : in std_logic_vector) is
+		begin
+			for i in 0 to NBW - 1 loop
+				mem(woff + i) := bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+			end loop;
+		end procedure;
+
+		-- read of a large number from the memory model
+		procedure mem_read_big(
+			constant woff : in natural;
+			variable bignb : out std_logic1024) is
+		begin
+			bignb := (others => '0');
+			for i in 0 to NBW - 1 loop
+				bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i) := mem(woff + i);
+			end loop;
+		end procedure;
+
+		-- write of one job descriptor (slot 'j') into the ring of the
+		-- memory model, along with its operands
+		procedure mem_write_job(
+			constant j : in natural;
+			constant op : in natural;
+			constant kval : in std_logic_vector;
+			constant x : in std_logic_vector;
+			constant y : in std_logic_vector) is
+			variable d, data : natural;
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		begin
+			d := j * DMA_DESC_WORDS;
+			data := DATAW + (j * SLOTW);
+			mem_write_big(data, kval);
+			mem_write_big(data + NBW, x);
+			mem_write_big(data + (2 * NBW), y);
+			dw := (others => '0');
+			dw(DMA_DESC_OP_MSB downto DMA_DESC_OP_LSB) := std_logic_vector(
+				to_unsigned(op, DMA_DESC_OP_MSB - DMA_DESC_OP_LSB + 1));
+			mem(d + DMA_DESC_CTRL) := dw;
+			mem(d + DMA_DESC_K) := memaddr(data);
+			mem(d + DMA_DESC_P0) := memaddr(data + NBW);
+			mem(d + DMA_DESC_P1) := (others => '0');
+			mem(d + DMA_DESC_RES) := memaddr(data + (3 * NBW));
+			mem(d + DMA_DESC_TAG) := std_logic_vector(to_unsigned(100 + j, AXIDW));
+		end procedure;
+
+		-- check, in the memory model, the descriptor in slot 'j' of the ring
+		-- & the results written for it ([k]P if 'kp', otherwise doubling),
+		-- against reference ones (nb of errors added to 'nok')
+		procedure mem_check_job(
+			constant j : in natural;
+			constant kp : in boolean;
+			constant refx, refy : in std_logic1024;
+			variable nok : inout natural)
+		is
+			variable res : natural;
+			variable dw : std_logic_vector(AXIDW - 1 downto 0);
+			variable vtoken, resx, resy : std_logic1024;
+		begin
+			res := DATAW + (j * SLOTW) + (3 * NBW);
+			-- descriptor marked as done
+			if mem(j * DMA_DESC_WORDS)(DMA_DESC_DONE) /= '1' then
+				echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Descriptor #"
+					& integer'image(j) & " not marked as done");
+				nok := nok + 1;
+			end if;
+			-- tag
+			if to_integer(unsigned(mem(res + (3 * NBW) + 1))) /= 100 + j then
+				echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Wrong tag for job #"
+					& integer'image(j));
+				nok := nok + 1;
+			end if;
+			-- snapshot of R_STATUS
+			dw := mem(res + (3 * NBW));
+			if dw(STATUS_ERR_MSB downto STATUS_ERR_LSB) /= (
+				STATUS_ERR_MSB downto STATUS_ERR_LSB => '0')
+			then
+				echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Error flags raised "
+					& "during job #" & integer'image(j));
+				nok := nok + 1;
+			end if;
+			-- result
+			mem_read_big(res, resx);
+			mem_read_big(res + NBW, resy);
+			if kp then
+				mem_read_big(res + (2 * NBW), vtoken);
+				resx := resx xor vtoken;
+				resy := resy xor vtoken;
+			end if;
+			if resx(VALNN - 1 downto 0) /= refx(VALNN - 1 downto 0)
+				or resy(VALNN - 1 downto 0) /= refy(VALNN - 1 downto 0)
+			then
+				echo("[ ecc_dma_tb.vhd ]: **** FAILED! **** Job #"
+					& integer'image(j) & " returned x = 0x");
+				hex_echol(resx(VALNN - 1 downto 0));
+				nok := nok + 1;
+			end if;
+		end procedure;
+
+		variable kval : std_logic1024;
+		variable vtoken : std_logic1024;
+		variable kpx, kpy, dblx, dbly : std_logic1024;
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		variable resp : std_logic_vector(1 downto 0);
+		variable slot : natural;
+		variable t0, t1 : time;
+		variable tref, tall : time;
+		variable nok : natural;
+	begin
+
+		--
+		-- Time 0
+		--
+		axi0.awvalid <= '0';
+		axi0.wvalid <= '0';
+		axi0.bready <= '1';
+		axi0.arvalid <= '0';
+		axi0.rready <= '1';
+		axi0.awprot <= (others => '0');
+		axi0.arprot <= (others => '0');
+		axi0.wstrb <= (others => '1');
+		dmabank <= '0';
+
+		kval := (others => '0');
+		kval(191 downto 0) := x"0123456789abcdeffedcba98765432100123456789abcdef";
+
+		assert DATAW + ((2**RINGLOG) * SLOTW) <= MEMW
+			report "ecc_dma_tb: memory model too small for the ring"
+				severity FAILURE;
+		assert NBJ < 2**RINGLOG
+			report "ecc_dma_tb: ring too small for the NBJ jobs"
+				severity FAILURE;
+
+		--
+		-- Wait for out-of-reset.
+		--
+		wait until s_axi_aresetn = '1';
+		echol("[ ecc_dma_tb.vhd ]: Out-of-reset");
+		wait for 333 ns;
+		wait until s_axi_aclk'event and s_axi_aclk = '1';
+
+		--
+		-- Wait until the IP has done its (possible) init stuff, then program
+		-- the curve.
+		--
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		if not hwsecure then
+			debug_trng_use_real(s_axi_aclk, axi0, axo0);
+			debug_trng_pp_start_pulling_raw(s_axi_aclk, axi0, axo0);
+		end if;
+		if nn_dynamic then
+			set_nn(s_axi_aclk, axi0, axo0, VALNN);
+		end if;
+		set_curve(s_axi_aclk, axi0, axo0, VALNN, CURVE_PARAM_192);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+
+		echol("[ ecc_dma_tb.vhd ]: Init done");
+
+		--
+		-- References: one [k]P computation & one point doubling driven by
+		-- software.
+		--
+		get_token(s_axi_aclk, axi0, axo0, VALNN, vtoken);
+		t0 := now;
+		scalar_mult(s_axi_aclk, axi0, axo0, VALNN, kval,
+			BIG_XP_BPOOL192R1, BIG_YP_BPOOL192R1, FALSE);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		read_and_return_kp_result(s_axi_aclk, axi0, axo0, VALNN, vtoken,
+			kpx, kpy);
+		t1 := now;
+		tref := t1 - t0;
+		kpx := kpx xor vtoken;
+		kpy := kpy xor vtoken;
+		ack_all_errors(s_axi_aclk, axi0, axo0);
+
+		point_double(s_axi_aclk, axi0, axo0, VALNN, BIG_XP_BPOOL192R1,
+			BIG_YP_BPOOL192R1, FALSE);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		read_and_return_ptdbl_result(s_axi_aclk, axi0, axo0, VALNN, dblx, dbly);
+		ack_all_errors(s_axi_aclk, axi0, axo0);
+
+		echol("[ ecc_dma_tb.vhd ]: One [k]P driven by software took "
+			& time'image(tref));
+
+		--
+		-- Write NBJ job descriptors into the ring (in memory).
+		--
+		for j in 0 to NBJ - 1 loop
+			if j mod 2 = 0 then
+				mem_write_job(j, CTRL_KP, kval, BIG_XP_BPOOL192R1,
+					BIG_YP_BPOOL192R1);
+			else
+				mem_write_job(j, CTRL_PT_DBL, kval, BIG_XP_BPOOL192R1,
+					BIG_YP_BPOOL192R1);
+			end if;
+		end loop;
+
+		--
+		-- Program the DMA engine (ring & IRQ threshold), hand the NBJ
+		-- descriptors over to it & enable it.
+		--
+		dmabank <= '1';
+		dw := std_logic_vector(MEMBASE);
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_RING_BASE, dw);
+		dw := std_logic_vector(to_unsigned(RINGLOG, AXIDW));
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_RING_LOG, dw);
+		dw := std_logic_vector(to_unsigned(NBJ, AXIDW));
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_TAIL, dw);
+		dw := (others => '0');
+		dw(DMA_CTRL_EN) := '1';
+		dw(DMA_CTRL_IRQ_MSB downto DMA_CTRL_IRQ_LSB) :=
+			std_logic_vector(to_unsigned(NBJ, 16));
+		t0 := now;
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_CTRL, dw);
+
+		echol("[ ecc_dma_tb.vhd ]: " & integer'image(NBJ)
+			& " jobs handed over to the DMA engine");
+
+		nok := 0;
+
+		--
+		-- Software access to the registers of 'ecc' must be refused while
+		-- the engine owns them.
+		--
+		wait for 2 us;
+		dmabank <= '0';
+		read_reg(s_axi_aclk, axi0, axo0, R_STATUS, dw, resp);
+		if resp /= "10" then
+			echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Read of R_STATUS "
+				& "during DMA processing did not receive SLVERR");
+			nok := nok + 1;
+		end if;
+
+		--
+		-- Stay away from the AXI interface until the (coalesced) IRQ.
+		--
+		wait until irq'event and irq = '1';
+		t1 := now;
+		tall := t1 - t0;
+
+		--
+		-- Check DMA status & consumer index.
+		--
+		dmabank <= '1';
+		read_reg(s_axi_aclk, axi0, axo0, DMA_R_STATUS, dw, resp);
+		if to_integer(unsigned(dw(DMA_ST_DONE_MSB downto DMA_ST_DONE_LSB))) /= NBJ
+			or dw(DMA_ST_BUSERR) /= '0' or dw(DMA_ST_IRQ) /= '1'
+		then
+			echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Unexpected DMA status");
+			nok := nok + 1;
+		end if;
+		read_reg(s_axi_aclk, axi0, axo0, DMA_R_HEAD, dw, resp);
+		if to_integer(unsigned(dw)) /= NBJ then
+			echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Unexpected consumer "
+				& "index " & integer'image(to_integer(unsigned(dw))));
+			nok := nok + 1;
+		end if;
+		-- engine must have released the registers of 'ecc'
+		read_reg(s_axi_aclk, axi0, axo0, DMA_R_STATUS, dw, resp);
+		if dw(DMA_ST_ACTIVE) /= '0' then
+			echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** DMA engine still "
+				& "active with an empty ring");
+			nok := nok + 1;
+		end if;
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_IRQ_ACK, dw);
+		dmabank <= '0';
+
+		--
+		-- Check results in memory.
+		--
+		for j in 0 to NBJ - 1 loop
+			if j mod 2 = 0 then
+				mem_check_job(j, TRUE, kpx, kpy, nok);
+			else
+				mem_check_job(j, FALSE, dblx, dbly, nok);
+			end if;
+		end loop;
+
+		echol("[ ecc_dma_tb.vhd ]: " & integer'image(NBJ)
+			& " jobs processed by the DMA engine in " & time'image(tall)
+			& " (" & integer'image(nbmemrd) & " memory reads, "
+			& integer'image(nbmemwr) & " memory writes)");
+
+		if nok = 0 then
+			echol("[ ecc_dma_tb.vhd ]: SUCCESSFULL: all jobs processed by the "
+				& "DMA engine returned the expected result");
+		end if;
+		assert nok = 0 severity FAILURE;
+
+		--
+		-- Second batch of NBJ jobs, in slots NBJ, NBJ + 1, ... of the ring
+		-- (modulo its size, hence wrapping around its end), handed over to
+		-- the engine by a write of the producer index only.
+		--
+		for j in NBJ to (2 * NBJ) - 1 loop
+			slot := j mod (2**RINGLOG);
+			if j mod 2 = 0 then
+				mem_write_job(slot, CTRL_KP, kval, BIG_XP_BPOOL192R1,
+					BIG_YP_BPOOL192R1);
+			else
+				mem_write_job(slot, CTRL_PT_DBL, kval, BIG_XP_BPOOL192R1,
+					BIG_YP_BPOOL192R1);
+			end if;
+		end loop;
+		dmabank <= '1';
+		dw := std_logic_vector(to_unsigned((2 * NBJ) mod (2**RINGLOG), AXIDW));
+		t0 := now;
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_TAIL, dw);
+		dmabank <= '0';
+		echol("[ ecc_dma_tb.vhd ]: " & integer'image(NBJ)
+			& " more jobs handed over to the DMA engine (ring wrapping)");
+		wait until irq'event and irq = '1';
+		t1 := now;
+		tall := t1 - t0;
+
+		dmabank <= '1';
+		read_reg(s_axi_aclk, axi0, axo0, DMA_R_STATUS, dw, resp);
+		if to_integer(unsigned(dw(DMA_ST_DONE_MSB downto DMA_ST_DONE_LSB))) /= NBJ
+			or dw(DMA_ST_BUSERR) /= '0' or dw(DMA_ST_IRQ) /= '1'
+		then
+			echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Unexpected DMA status "
+				& "after the second batch");
+			nok := nok + 1;
+		end if;
+		read_reg(s_axi_aclk, axi0, axo0, DMA_R_HEAD, dw, resp);
+		if to_integer(unsigned(dw)) /= (2 * NBJ) mod (2**RINGLOG) then
+			echol("[ ecc_dma_tb.vhd ]: **** FAILED! **** Unexpected consumer "
+				& "index " & integer'image(to_integer(unsigned(dw)))
+				& " after the second batch");
+			nok := nok + 1;
+		end if;
+		write_reg(s_axi_aclk, axi0, axo0, DMA_W_IRQ_ACK, dw);
+		dmabank <= '0';
+
+		for j in NBJ to (2 * NBJ) - 1 loop
+			if j mod 2 = 0 then
+				mem_check_job(j mod (2**RINGLOG), TRUE, kpx, kpy, nok);
+			else
+				mem_check_job(j mod (2**RINGLOG), FALSE, dblx, dbly, nok);
+			end if;
+		end loop;
+
+		echol("[ ecc_dma_tb.vhd ]: " & integer'image(NBJ)
+			& " more jobs processed by the DMA engine in " & time'image(tall));
+
+		if nok = 0 then
+			echol("[ ecc_dma_tb.vhd ]: SUCCESSFULL: all jobs of the second batch "
+				& "returned the expected result");
+		end if;
+		assert nok = 0 severity FAILURE;
+
+		echol("[ ecc_dma_tb.vhd ]: End of simulation");
+		assert FALSE severity FAILURE;
+		wait;
+	end process steam;
+
+end architecture sim;
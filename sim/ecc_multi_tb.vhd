@@ -0,0 +1,354 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.ecc_tb_pkg.all;
+use work.ecc_tb_vec.all;
+use work.ecc_vars.all;
+use work.ecc_software.all;
+
+use std.textio.all;
+
+-- Testbench for the multi-core top-level 'ecc_multi'.
+--
+-- The same [k]P computation (on curve BRAINPOOLP192R1) is first run alone
+-- on engine 0 to get a reference duration, then on all 'nbcores' engines
+-- at the same time. All engines are expected to return the same result as
+-- the reference one, and the total duration of the concurrent computations
+-- is expected to be roughly the duration of one single computation (plus
+-- the time the AXI initiator spends to program the engines one after the
+-- other). The corresponding throughputs (in [k]P per second of simulated
+-- time, i.e for the clock periods set in ecc_tb_pkg) are displayed too.
+entity ecc_multi_tb is
+end entity ecc_multi_tb;
+
+architecture sim of ecc_multi_tb is
+
+	-- number of bits in AXI address buses selecting the engine
+	constant BKB : positive := log2(nbcores - 1);
+
+	-- DuT component declaration
+	component ecc_multi is
+		generic(
+			-- Width of S_AXI data bus
+			C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+			-- Width of S_AXI address bus
+			C_S_AXI_ADDR_WIDTH : integer := AXIAW + log2(nbcores - 1)
+			);
+		port(
+			-- AXI clock & reset
+			s_axi_aclk : in  std_logic;
+			s_axi_aresetn : in std_logic; -- asyn asserted, syn deasserted, active low
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			--  AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signals (one per engine)
+			busy : out std_logic_vector(nbcores - 1 downto 0);
+			-- HW unsecure/SCA analysis feature (off-chip trigger)
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic;
+			-- clk & clkmm division & out feature
+			clkdivo : out std_logic;
+			clkmmdivo : out std_logic
+		);
+	end component ecc_multi;
+
+	-- AXI signal buses (DuT), driven by the procedures of ecc_tb_pkg
+	-- (with AXIAW-bit addresses) and extended with the engine index
+	signal axi0 : axi_in_type;
+	signal axo0 : axi_out_type;
+	signal bank : natural range 0 to nbcores - 1;
+	signal awaddr : std_logic_vector(AXIAW + BKB - 1 downto 0);
+	signal araddr : std_logic_vector(AXIAW + BKB - 1 downto 0);
+
+	signal s_axi_aclk, s_axi_aresetn : std_logic;
+
+	signal clkmm : std_logic;
+
+	signal busy : std_logic_vector(nbcores - 1 downto 0);
+
+	-- Pseudo TRNG port (unused here)
+	signal dbgptdata : std_logic_vector(7 downto 0);
+	signal dbgptvalid : std_logic;
+
+	type std_logic1024_array is array(0 to nbcores - 1) of std_logic1024;
+
+	constant VALNN : positive := 192;
+
+begin
+
+	-- Emulate AXI reset.
+	process
+	begin
+		s_axi_aresetn <= '0';
+		wait for 333 ns;
+		s_axi_aresetn <= '1';
+		wait;
+	end process;
+
+	-- Emulate AXI clock (150 MHz).
+	process
+	begin
+		s_axi_aclk <= '0';
+		wait for 3.333 ns;
+		s_axi_aclk <= '1';
+		wait for 3.333 ns;
+	end process;
+
+	-- Emulate clkmm clock (374 MHz).
+	process
+	begin
+		clkmm <= '0';
+		wait for 1.336 ns;
+		clkmm <= '1';
+		wait for 1.336 ns;
+	end process;
+
+	awaddr <= std_logic_vector(to_unsigned(bank, BKB)) & axi0.awaddr;
+	araddr <= std_logic_vector(to_unsigned(bank, BKB)) & axi0.araddr;
+
+	dbgptdata <= (others => '0');
+	dbgptvalid <= '0';
+
+	-- DuT instance
+	e0: ecc_multi
+		generic map(
+			C_S_AXI_DATA_WIDTH => AXIDW,
+			C_S_AXI_ADDR_WIDTH => AXIAW + BKB)
+		port map(
+			-- AXI clock & reset
+			s_axi_aclk => s_axi_aclk,
+			s_axi_aresetn => s_axi_aresetn,
+			-- AXI write-address channel
+			s_axi_awaddr => awaddr,
+			s_axi_awprot => axi0.awprot,
+			s_axi_awvalid => axi0.awvalid,
+			s_axi_awready => axo0.awready,
+			-- AXI write-data channel
+			s_axi_wdata => axi0.wdata,
+			s_axi_wstrb => axi0.wstrb,
+			s_axi_wvalid => axi0.wvalid,
+			s_axi_wready => axo0.wready,
+			-- AXI write-response channel
+			s_axi_bresp => axo0.bresp,
+			s_axi_bvalid => axo0.bvalid,
+			s_axi_bready => axi0.bready,
+			-- AXI read-address channel
+			s_axi_araddr => araddr,
+			s_axi_arprot => axi0.arprot,
+			s_axi_arvalid => axi0.arvalid,
+			s_axi_arready => axo0.arready,
+			--  AXI read-data channel
+			s_axi_rdata => axo0.rdata,
+			s_axi_rresp => axo0.rresp,
+			s_axi_rvalid => axo0.rvalid,
+			s_axi_rready => axi0.rready,
+			-- Clock for Montgomery multipliers in the async case
+			clkmm => clkmm,
+			-- Interrupt
+			irq => open,
+			-- Busy signals
+			busy => busy,
+			-- HW secure/SCA analysis feature (off-chip trigger)
+			dbgtrigger => open,
+			dbghalted => open,
+			-- Pseudo-trng port
+			dbgptdata => dbgptdata,
+			dbgptvalid => dbgptvalid,
+			dbgptrdy => open,
+			-- clk & clkmm division & out feature
+			clkdivo => open,
+			clkmmdivo => open
+		);
+
+	-- --------------------------------------------
+	-- Emulating stimuli signals to DuT (ecc_multi)
+	-- --------------------------------------------
+	steam: process
+		variable kval : std_logic1024;
+		variable vtoken : std_logic1024_array;
+		variable kpx, kpy : std_logic1024_array;
+		variable refx, refy : std_logic1024;
+		variable t0, t1 : time;
+		variable tref, tall : time;
+		variable nok : natural;
+	begin
+
+		--
+		-- Time 0
+		--
+		axi0.awvalid <= '0';
+		axi0.wvalid <= '0';
+		axi0.bready <= '1';
+		axi0.arvalid <= '0';
+		axi0.rready <= '1';
+		axi0.awprot <= (others => '0');
+		axi0.arprot <= (others => '0');
+		axi0.wstrb <= (others => '1');
+		bank <= 0;
+
+		kval := (others => '0');
+		kval(191 downto 0) := x"0123456789abcdeffedcba98765432100123456789abcdef";
+
+		--
+		-- Wait for out-of-reset.
+		--
+		wait until s_axi_aresetn = '1';
+		echol("[ ecc_multi_tb.vhd ]: Out-of-reset");
+		wait for 333 ns;
+		wait until s_axi_aclk'event and s_axi_aclk = '1';
+
+		--
+		-- Wait until all engines have done their (possible) init stuff,
+		-- then program the same curve on each of them.
+		--
+		for i in 0 to nbcores - 1 loop
+			bank <= i;
+			poll_until_ready(s_axi_aclk, axi0, axo0);
+			if (not hwsecure) and i = 0 then
+				-- The TRNG debug controls are the ones of engine 0.
+				debug_trng_use_real(s_axi_aclk, axi0, axo0);
+				debug_trng_pp_start_pulling_raw(s_axi_aclk, axi0, axo0);
+			end if;
+			if nn_dynamic then
+				set_nn(s_axi_aclk, axi0, axo0, VALNN);
+			end if;
+			set_curve(s_axi_aclk, axi0, axo0, VALNN, CURVE_PARAM_192);
+			poll_until_ready(s_axi_aclk, axi0, axo0);
+		end loop;
+
+		echol("[ ecc_multi_tb.vhd ]: Init done (" & integer'image(nbcores)
+			& " engines)");
+
+		--
+		-- Reference: one single [k]P computation on engine 0.
+		--
+		bank <= 0;
+		get_token(s_axi_aclk, axi0, axo0, VALNN, vtoken(0));
+		t0 := now;
+		scalar_mult(s_axi_aclk, axi0, axo0, VALNN, kval,
+			BIG_XP_BPOOL192R1, BIG_YP_BPOOL192R1, FALSE);
+		poll_until_ready(s_axi_aclk, axi0, axo0);
+		t1 := now;
+		tref := t1 - t0;
+		display_errors(s_axi_aclk, axi0, axo0);
+		read_and_return_kp_result(s_axi_aclk, axi0, axo0, VALNN, vtoken(0),
+			refx, refy);
+		refx := refx xor vtoken(0);
+		refy := refy xor vtoken(0);
+		ack_all_errors(s_axi_aclk, axi0, axo0);
+		echol("[ ecc_multi_tb.vhd ]: One [k]P on engine 0 took "
+			& time'image(tref));
+
+		--
+		-- Same [k]P computation on all engines at the same time.
+		--
+		for i in 0 to nbcores - 1 loop
+			bank <= i;
+			get_token(s_axi_aclk, axi0, axo0, VALNN, vtoken(i));
+		end loop;
+		t0 := now;
+		for i in 0 to nbcores - 1 loop
+			bank <= i;
+			scalar_mult(s_axi_aclk, axi0, axo0, VALNN, kval,
+				BIG_XP_BPOOL192R1, BIG_YP_BPOOL192R1, FALSE);
+		end loop;
+		for i in 0 to nbcores - 1 loop
+			bank <= i;
+			poll_until_ready(s_axi_aclk, axi0, axo0);
+		end loop;
+		t1 := now;
+		tall := t1 - t0;
+
+		--
+		-- Check results.
+		--
+		nok := 0;
+		for i in 0 to nbcores - 1 loop
+			bank <= i;
+			display_errors(s_axi_aclk, axi0, axo0);
+			read_and_return_kp_result(s_axi_aclk, axi0, axo0, VALNN, vtoken(i),
+				kpx(i), kpy(i));
+			kpx(i) := kpx(i) xor vtoken(i);
+			kpy(i) := kpy(i) xor vtoken(i);
+			ack_all_errors(s_axi_aclk, axi0, axo0);
+			if kpx(i)(VALNN - 1 downto 0) /= refx(VALNN - 1 downto 0)
+				or kpy(i)(VALNN - 1 downto 0) /= refy(VALNN - 1 downto 0)
+			then
+				echo("[ ecc_multi_tb.vhd ]: **** FAILED! **** Engine #"
+					& integer'image(i) & " returned [k]P x = 0x");
+				hex_echol(kpx(i)(VALNN - 1 downto 0));
+				nok := nok + 1;
+			end if;
+		end loop;
+
+		echol("[ ecc_multi_tb.vhd ]: " & integer'image(nbcores)
+			& " concurrent [k]P took " & time'image(tall) & " (i.e "
+			& integer'image((100 * (tall / 1 ns)) / (tref / 1 ns))
+			& "% of one single [k]P)");
+		echol("[ ecc_multi_tb.vhd ]: throughput: "
+			& integer'image((1 sec / 1 us) / (tref / 1 us))
+			& " [k]P/s with 1 engine, "
+			& integer'image((nbcores * (1 sec / 1 us)) / (tall / 1 us))
+			& " [k]P/s with " & integer'image(nbcores) & " engines");
+
+		if nok = 0 then
+			echol("[ ecc_multi_tb.vhd ]: SUCCESSFULL: all engines returned "
+				& "the expected [k]P result");
+		end if;
+		assert nok = 0 severity FAILURE;
+
+		echol("[ ecc_multi_tb.vhd ]: End of simulation");
+		assert FALSE severity FAILURE;
+		wait;
+	end process steam;
+
+end architecture sim;
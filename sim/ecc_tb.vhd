@@ -45,6 +45,9 @@ architecture sim of ecc_tb is
 	--
 	constant CONTINUE_ON_ERROR: boolean := FALSE;
 
+	-- Period of the AXI clock (150 MHz)
+	constant AXI_CLK_PERIOD : time := 6.666 ns;
+
 	-- DuT component declaration
 	component ecc is
 		generic(
@@ -149,6 +152,10 @@ architecture sim of ecc_tb is
 	-- AXI signal buses (DuT)
 	signal axi0 : axi_in_type;
 	signal axo0 : axi_out_type;
+	-- Set by the AXI bus monitor (see process 'axi_monitor' hereafter)
+	signal mon_cmd_t0, mon_cmd_t1 : time := 0 ns;
+	signal mon_cmd_sel : natural := 0;
+	signal mon_sel : natural := 0;
 
 	type axi1_in_type is record
 		-- in
@@ -446,14 +453,17 @@ architecture sim of ecc_tb is
 		(OP_NONE, OP_KP, OP_PTADD, OP_PTDBL, OP_PTNEG, OP_TST_CHK, OP_TST_EQU,
 		 OP_TST_OPP);
 
+	-- The nb of AXI clock cycles since the test started ('t0') is displayed
+	-- after its label, between brackets (sim/regress.py relies on it).
 	procedure echo_test_label(
 		constant t: in string(1 to 16384); constant sz: in natural;
-		constant op: in string) is
+		constant op: in string; constant t0: in time) is
 	begin
 		echo("[     ecc_tb.vhd ]: >>>> END TEST " & op);
 		if sz > 0 then
 			echo(t(1 to sz));
 		end if;
+		echo(" [" & integer'image((now - t0) / AXI_CLK_PERIOD) & " cycles]");
 	end procedure echo_test_label;
 
 	function str_low_case(constant s: string) return string is
@@ -487,9 +497,9 @@ begin
 	process
 	begin
 		s_axi_aclk <= '0';
-		wait for 3.333 ns;
+		wait for AXI_CLK_PERIOD / 2;
 		s_axi_aclk <= '1';
-		wait for 3.333 ns;
+		wait for AXI_CLK_PERIOD / 2;
 	end process;
 
 	-- Emulate clkmm clock (374 MHz).
@@ -614,6 +624,8 @@ begin
 		variable b_val : std_logic1024;
 		variable q_val : std_logic1024;
 		variable curve_param : curve_param_type;
+		variable curve_ctx : ctx_cache_type; -- (option nbctx > 0)
+		variable t_curve : time;
 		--
 		-- Common to different point operations
 		--
@@ -685,10 +697,26 @@ begin
 		variable line_length : integer;
 		variable test_label : string(1 to 16384);
 		variable test_label_sz : natural;
+		variable test_t0 : time; -- Simulation time at which current test started
+		-- Cycle accounting of tests (written in file 'simcyclesfile')
+		file fcyc : text open write_mode is simcyclesfile;
+		variable cycline : line;
+		variable test_nok0 : natural;
+		variable test_ran : boolean := FALSE;
+		variable phase_wr, phase_rdy : time;
+		variable phase_wrsel, phase_rdsel : natural;
+		variable cmd_t0, cmd_t1 : time;
+		variable cmd_sel : natural;
 		variable nbbld : natural; -- Nb of blinding bits.
 		variable op: operation_t;
 		variable line_type_expected : line_t;
 		variable test_is_an_exception : boolean;
+		-- TRNG starvation of [k]P tests (HW unsecure mode only), per client
+		-- interface: 0 = axi, 1 = efp, 2 = crv, 3 = shf, 4 = raw
+		type trng_diag_t is array(0 to 4) of natural;
+		constant TRNG_DIAG_NAME : string(1 to 15) := "axiefpcrvshfraw";
+		variable trng_ok, trng_starv : natural;
+		variable trng_ok_tot, trng_starv_tot : trng_diag_t := (others => 0);
 		-- Statistics
 		variable stats_ok: natural;
 		variable stats_nok: natural;
@@ -698,6 +726,7 @@ begin
 		begin
 			echol("Statistics so far: ok = " & integer'image(stats_ok) & ", nok = "
 				& integer'image(stats_nok) & ", total = " & integer'image(stats_total));
+			file_close(fcyc);
 			assert FALSE severity FAILURE;
 		end procedure print_stats_and_exit;
 
@@ -706,10 +735,93 @@ begin
 			if CONTINUE_ON_ERROR = FALSE then
 				echol("Statistics so far: ok = " & integer'image(stats_ok) & ", nok = "
 					& integer'image(stats_nok) & ", total = " & integer'image(stats_total));
+				file_close(fcyc);
 				assert FALSE severity FAILURE;
 			end if;
 		end procedure print_stats_and_possibly_exit;
 
+		-- Cycle accounting of tests: each test is split in phases, the
+		-- boundaries of which are timestamped here, except for the ones
+		-- of the command (the write of W_CTRL starting the operation),
+		-- timestamped by the AXI bus monitor, which also counts the cycles
+		-- spent writing W_CTRL to select large numbers ('mon_sel').
+		--
+		--   setup : from the test header to the transfer of operands
+		--           (configuration of blinding & acquisition of the token
+		--           for [k]P, nothing otherwise)
+		--   wrsel : selection of the operands in the transfer of operands
+		--   wrdata: rest of the transfer of operands (data writes & polling)
+		--   cmd   : command
+		--   busy  : from the command to the IP being ready again
+		--   rdsel : selection of the result in the read of the result
+		--   rddata: rest of the read of the result (errors, data reads)
+
+		-- Start of the transfer of operands
+		procedure cyc_operands is
+		begin
+			phase_wr := now;
+			phase_wrsel := mon_sel;
+		end procedure cyc_operands;
+
+		-- End of the computation (IP is ready again)
+		procedure cyc_computed is
+		begin
+			phase_rdy := now;
+			phase_rdsel := mon_sel;
+			cmd_t0 := mon_cmd_t0;
+			cmd_t1 := mon_cmd_t1;
+			cmd_sel := mon_cmd_sel;
+			test_ran := TRUE;
+		end procedure cyc_computed;
+
+		-- End of test: write its line in file 'simcyclesfile'
+		procedure cyc_end_of_test is
+			variable wrsel, rdsel : natural;
+			variable i : natural := 1;
+		begin
+			wrsel := cmd_sel - phase_wrsel;
+			rdsel := mon_sel - phase_rdsel;
+			-- (test label without its leading blanks, e.g "#0.0")
+			while (i < test_label_sz) and (test_label(i) = ' ') loop
+				i := i + 1;
+			end loop;
+			write(cycline, test_label(i to test_label_sz));
+			write(cycline, "," & operation_t'image(op) & "," & integer'image(valnn)
+				& "," & integer'image(nbbld));
+			write(cycline, "," & integer'image((phase_wr - test_t0) / AXI_CLK_PERIOD));
+			write(cycline, "," & integer'image(wrsel));
+			write(cycline, "," & integer'image(((cmd_t0 - phase_wr) / AXI_CLK_PERIOD) - wrsel));
+			write(cycline, "," & integer'image((cmd_t1 - cmd_t0) / AXI_CLK_PERIOD));
+			write(cycline, "," & integer'image((phase_rdy - cmd_t1) / AXI_CLK_PERIOD));
+			write(cycline, "," & integer'image(rdsel));
+			write(cycline, "," & integer'image(((now - phase_rdy) / AXI_CLK_PERIOD) - rdsel));
+			write(cycline, "," & integer'image((now - test_t0) / AXI_CLK_PERIOD));
+			if stats_nok = test_nok0 then
+				write(cycline, string'(",ok"));
+			else
+				write(cycline, string'(",FAILED"));
+			end if;
+			writeline(fcyc, cycline);
+			test_ran := FALSE;
+		end procedure cyc_end_of_test;
+
+		-- End of a [k]P test: display the TRNG diagnostic counters (reset
+		-- by the IP at the start of each [k]P computation, see (s268) in
+		-- ecc_axi.vhd), i.e the nb of cycles each client interface was
+		-- starving & served, and add them to the totals of the simulation.
+		procedure trng_diag_end_of_kp is
+		begin
+			echo("[     ecc_tb.vhd ]: TRNG starving/served cycles:");
+			for i in 0 to 4 loop
+				debug_trng_read_diag(s_axi_aclk, axi0, axo0, i, trng_ok, trng_starv);
+				echo(" " & TRNG_DIAG_NAME(3*i + 1 to 3*i + 3) & " "
+					& integer'image(trng_starv) & "/" & integer'image(trng_ok));
+				trng_ok_tot(i) := trng_ok_tot(i) + trng_ok;
+				trng_starv_tot(i) := trng_starv_tot(i) + trng_starv;
+			end loop;
+			echol("");
+		end procedure trng_diag_end_of_kp;
+
 	begin
 
 		--
@@ -774,6 +886,10 @@ begin
 
 		echol("[     ecc_tb.vhd ]: Execution traced in output file: """
 			& simlogfile & """");
+		echol("[     ecc_tb.vhd ]: Cycles of tests in output file: """
+			& simcyclesfile & """");
+		write(cycline, string'("test,op,nn,nbbld,setup,wrsel,wrdata,cmd,busy,rdsel,rddata,total,status"));
+		writeline(fcyc, cycline);
 
 		nbbld := 0; op := OP_NONE; line_type_expected := EXPECT_NONE;
 		stats_ok := 0; stats_nok := 0; stats_total := 0;
@@ -838,6 +954,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST [k]P");
 						-- print anything that may follow "TEST [k]P"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 13 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -858,6 +976,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST P+Q");
 						-- print anything that may follow "TEST P+Q"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 12 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -878,6 +998,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST [2]P");
 						-- print anything that may follow "TEST [2]P"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 13 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -898,6 +1020,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST (-P)");
 						-- print anything that may follow "TEST (-P)"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 11 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -918,6 +1042,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST isPoncurve");
 						-- print anything that may follow "TEST isPoncurve"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 19 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -938,6 +1064,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST isP==Q");
 						-- print anything that may follow "TEST isP==Q"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 15 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -958,6 +1086,8 @@ begin
 						echo("[     ecc_tb.vhd ]: <<<< NEW TEST isP==-Q");
 						-- print anything that may follow "TEST isP==-Q"
 						test_label_sz := 0;
+						test_t0 := now;
+						test_nok0 := stats_nok;
 						for i in 16 to line_length loop
 							if nline(i) = LF then
 								exit;
@@ -1089,9 +1219,18 @@ begin
 								nn_s <= valnn;
 							end if;
 							-- Then set curve according to the parameters extracted
-							-- from the testbench input file.
+							-- from the testbench input file (possibly restoring it
+							-- from a context slot). The nb of cycles until the IP
+							-- is ready with the new curve is displayed (sim/ctx.py
+							-- relies on it).
 							--
-							set_curve(s_axi_aclk, axi0, axo0, valnn, curve_param);
+							t_curve := now;
+							set_curve(s_axi_aclk, axi0, axo0, valnn, curve_param,
+								curve_ctx);
+							poll_until_ready(s_axi_aclk, axi0, axo0);
+							echol("[     ecc_tb.vhd ]: curve set in "
+								& integer'image((now - t_curve) / AXI_CLK_PERIOD)
+								& " cycles");
 						else
 							echol("[     ecc_tb.vhd ]: ERROR: Wrong syntax in input file "
 								& "(expecting an hexadecimal number after ""q=0x"").");
@@ -1331,18 +1470,20 @@ begin
 						-- infinity.
 						-- Hence here it is set to 'sw_p_is_null' according to what was given
 						-- in the input test-vectors file.
+						cyc_operands;
 						scalar_mult(s_axi_aclk, axi0, axo0, valnn, k_val, px_val, py_val,
 							sw_p_is_null);
 						--
 						-- Poll until IP has completed computation and is ready.
 						--
 						poll_until_ready(s_axi_aclk, axi0, axo0);
+						cyc_computed;
 						-- Check & display possible errors.
 						display_errors(s_axi_aclk, axi0, axo0);
 						-- Check if R1 is null.
 						check_if_r1_null(s_axi_aclk, axi0, axo0, hw_kp_is_null);
 						if hw_kp_is_null then
-							echo_test_label(test_label, test_label_sz, "[k]P");
+							echo_test_label(test_label, test_label_sz, "[k]P", test_t0);
 							echol(" - SUCCESSFULL: RTL result for [k]P matches the one "
 								& "expected by test-vectors file (both are the null point).");
 							stats_ok := stats_ok + 1;
@@ -1351,7 +1492,7 @@ begin
 							-- Read back the [k]P result coordinates.
 							read_and_return_kp_result(s_axi_aclk, axi0, axo0, valnn, vtoken,
 								hw_kpx_val, hw_kpy_val);
-							echo_test_label(test_label, test_label_sz, "[k]P");
+							echo_test_label(test_label, test_label_sz, "[k]P", test_t0);
 							echol(" **** FAILED! **** Mismatch between simulated RTL ([k]P != 0) "
 								& "and result expected by test-vectors file ([k]P = 0).");
 							stats_nok := stats_nok + 1;
@@ -1426,18 +1567,20 @@ begin
 							-- infinity.
 							-- Hence here it is set to 'sw_p_is_null' according to what was given
 							-- in the input test-vectors file.
+							cyc_operands;
 							scalar_mult(s_axi_aclk, axi0, axo0, valnn, k_val, px_val, py_val,
 								sw_p_is_null);
 							--
 							-- Poll until IP has completed computation and is ready.
 							--
 							poll_until_ready(s_axi_aclk, axi0, axo0);
+							cyc_computed;
 							-- Check & display possible errors.
 							display_errors(s_axi_aclk, axi0, axo0);
 							-- Check if R1 is null.
 							check_if_r1_null(s_axi_aclk, axi0, axo0, hw_kp_is_null);
 							if hw_kp_is_null then
-								echo_test_label(test_label, test_label_sz, "[k]P");
+								echo_test_label(test_label, test_label_sz, "[k]P", test_t0);
 								echol(" **** FAILED! **** Mismatch between simulated RTL ([k]P = 0) "
 									& "and result expected by test-vectors file ([k]P != 0).");
 								stats_nok := stats_nok + 1;
@@ -1453,13 +1596,13 @@ begin
 								if compare_two_points_coords(sw_kpx_val, sw_kpy_val,
 									hw_kpx_val xor vtoken, hw_kpy_val xor vtoken, valnn)
 								then
-									echo_test_label(test_label, test_label_sz, "[k]P");
+									echo_test_label(test_label, test_label_sz, "[k]P", test_t0);
 									echol(" - SUCCESSFULL: [k]P point coordinates match the ones given "
 										& "in the input test-vectors file.");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "[k]P");
+									echo_test_label(test_label, test_label_sz, "[k]P", test_t0);
 									echol(" **** FAILED! **** Mismatch on points coordinates. Simulated hardware gave:");
 									echo("[     ecc_tb.vhd ]: [k]P.x = 0x");
 									hex_echol(hw_kpx_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
@@ -1523,24 +1666,26 @@ begin
 						-- Hence here they are set to 'sw_p_is_null' (resp. sw_q_is_null)
 						-- according to what was given in the input test-vectors file.
 						--
+						cyc_operands;
 						point_add(s_axi_aclk, axi0, axo0, valnn, px_val, py_val, qx_val,
 							qy_val, sw_p_is_null, sw_q_is_null);
 						--
 						-- Poll until IP has completed computation and is ready.
 						--
 						poll_until_ready(s_axi_aclk, axi0, axo0);
+						cyc_computed;
 						-- Check & display possible errors.
 						display_errors(s_axi_aclk, axi0, axo0);
 						-- Check if result P + Q (now buffered in R1) is null.
 						check_if_r1_null(s_axi_aclk, axi0, axo0, hw_pplusq_is_null);
 						if hw_pplusq_is_null then
-							echo_test_label(test_label, test_label_sz, "P+Q");
+							echo_test_label(test_label, test_label_sz, "P+Q", test_t0);
 							echol(" - SUCCESSFULL: RTL result for P+Q matches the one "
 								& "expected by test-vectors file (both are the null point).");
 							stats_ok := stats_ok + 1;
 							stats_total := stats_total + 1;
 						else
-							echo_test_label(test_label, test_label_sz, "P+Q");
+							echo_test_label(test_label, test_label_sz, "P+Q", test_t0);
 							echol(" **** FAILED! **** Mismatch between simulated RTL (P+Q != 0) and "
 								& "result expected by test-vectors file (P+Q = 0).");
 							stats_nok := stats_nok + 1;
@@ -1580,26 +1725,28 @@ begin
 							-- Hence here they are set to 'sw_p_is_null' (resp. sw_q_is_null)
 							-- according to what was given in the input test-vectors file.
 							--
+							cyc_operands;
 							point_add(s_axi_aclk, axi0, axo0, valnn, px_val, py_val, qx_val,
 								qy_val, sw_p_is_null, sw_q_is_null);
 							--
 							-- Poll until IP has completed computation and is ready.
 							--
 							poll_until_ready(s_axi_aclk, axi0, axo0);
+							cyc_computed;
 							-- Check & display possible errors.
 							display_errors(s_axi_aclk, axi0, axo0);
 							-- Check if result P + Q (now buffered in R1) is null.
 							check_if_r1_null(s_axi_aclk, axi0, axo0, hw_pplusq_is_null);
 							if hw_pplusq_is_null then
 								if sw_pplusq_is_null then
-									echo_test_label(test_label, test_label_sz, "P+Q");
+									echo_test_label(test_label, test_label_sz, "P+Q", test_t0);
 									echol(" - SUCCESSFULL: RTL result for P+Q matches the one "
 										& "expected by test-vectors file (both are the null "
 										& "point).");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "P+Q");
+									echo_test_label(test_label, test_label_sz, "P+Q", test_t0);
 									echol(" **** FAILED! **** Mismatch between simulated RTL (P+Q = 0) "
 										& "and result expected by test-vectors file (P+Q != 0).");
 									stats_nok := stats_nok + 1;
@@ -1616,13 +1763,13 @@ begin
 								if compare_two_points_coords(sw_pplusqx_val, sw_pplusqy_val,
 									hw_pplusqx_val, hw_pplusqy_val, valnn)
 								then
-									echo_test_label(test_label, test_label_sz, "P+Q");
+									echo_test_label(test_label, test_label_sz, "P+Q", test_t0);
 									echol(" - SUCCESSFULL: P+Q point coordinates match the ones given "
 										& "in the input test-vectors file.");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "P+Q");
+									echo_test_label(test_label, test_label_sz, "P+Q", test_t0);
 									echol(" **** FAILED! **** Mismatch on points coordinates. "
 										& "Simulated RTL gave:");
 									echo("[     ecc_tb.vhd ]: (P+Q).x = 0x");
@@ -1686,24 +1833,26 @@ begin
 						-- Hence here it is set to 'sw_p_is_null' according to what was
 						-- given in the input test-vectors file.
 						--
+						cyc_operands;
 						point_double(s_axi_aclk, axi0, axo0, valnn, px_val, py_val,
 							sw_p_is_null);
 						--
 						-- Poll until IP has completed computation and is ready.
 						--
 						poll_until_ready(s_axi_aclk, axi0, axo0);
+						cyc_computed;
 						-- Check & display possible errors.
 						display_errors(s_axi_aclk, axi0, axo0);
 						-- Check if result [2]P (now buffered in R1) is null.
 						check_if_r1_null(s_axi_aclk, axi0, axo0, hw_twop_is_null);
 						if hw_twop_is_null then
-							echo_test_label(test_label, test_label_sz, "[2]P");
+							echo_test_label(test_label, test_label_sz, "[2]P", test_t0);
 							echol(" - SUCCESSFULL: RTL result for [2]P matches the one "
 								& "expected by test-vectors file (both are the null point).");
 							stats_ok := stats_ok + 1;
 							stats_total := stats_total + 1;
 						else
-							echo_test_label(test_label, test_label_sz, "[2]P");
+							echo_test_label(test_label, test_label_sz, "[2]P", test_t0);
 							echol(" **** FAILED! **** Mismatch between simulated RTL ([2]P != 0) and "
 								& "result expected by test-vectors file ([2]P = 0).");
 							stats_nok := stats_nok + 1;
@@ -1743,26 +1892,28 @@ begin
 							-- Hence it is set to 'sw_p_is_null' according to what was
 							-- given in the input test-vectors file.
 							--
+							cyc_operands;
 							point_double(s_axi_aclk, axi0, axo0, valnn, px_val, py_val,
 								sw_p_is_null);
 							--
 							-- Poll until IP has completed computation and is ready.
 							--
 							poll_until_ready(s_axi_aclk, axi0, axo0);
+							cyc_computed;
 							-- Check & display possible errors.
 							display_errors(s_axi_aclk, axi0, axo0);
 							-- Check if result [2]P (now buffered in R1) is null.
 							check_if_r1_null(s_axi_aclk, axi0, axo0, hw_twop_is_null);
 							if hw_twop_is_null then
 								if sw_twop_is_null then
-									echo_test_label(test_label, test_label_sz, "[2]P");
+									echo_test_label(test_label, test_label_sz, "[2]P", test_t0);
 									echol(" - SUCCESSFULL: RTL result for [2]P matches the one "
 										& "expected by test-vectors file (both are the null "
 										& "point).");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "[2]P");
+									echo_test_label(test_label, test_label_sz, "[2]P", test_t0);
 									echol(" **** FAILED! **** Mismatch between simulated RTL ([2]P = 0) "
 										& "and result expected by test-vectors file ([2]P != 0).");
 									stats_nok := stats_nok + 1;
@@ -1779,13 +1930,13 @@ begin
 								if compare_two_points_coords(sw_twopx_val, sw_twopy_val,
 									hw_twopx_val, hw_twopy_val, valnn)
 								then
-									echo_test_label(test_label, test_label_sz, "[2]P");
+									echo_test_label(test_label, test_label_sz, "[2]P", test_t0);
 									echol(" - SUCCESSFULL: [2]P point coordinates match the ones given "
 										& "in the input test-vectors file.");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "[2]P");
+									echo_test_label(test_label, test_label_sz, "[2]P", test_t0);
 									echol(" **** FAILED! **** Mismatch on points coordinates. "
 										& "Simulated RTL gave:");
 									echo("[     ecc_tb.vhd ]: [2]P.x = 0x");
@@ -1849,24 +2000,26 @@ begin
 						-- Hence here it is set to 'sw_p_is_null' according to what was
 						-- given in the input test-vectors file.
 						--
+						cyc_operands;
 						point_negate(s_axi_aclk, axi0, axo0, valnn, px_val, py_val,
 							sw_p_is_null);
 						--
 						-- Poll until IP has completed computation and is ready.
 						--
 						poll_until_ready(s_axi_aclk, axi0, axo0);
+						cyc_computed;
 						-- Check & display possible errors.
 						display_errors(s_axi_aclk, axi0, axo0);
 						-- Check if result -P (now buffered in R1) is null.
 						check_if_r1_null(s_axi_aclk, axi0, axo0, hw_negp_is_null);
 						if hw_negp_is_null then
-							echo_test_label(test_label, test_label_sz, "(-P)");
+							echo_test_label(test_label, test_label_sz, "(-P)", test_t0);
 							echol(" - SUCCESSFULL: RTL result for (-P) matches the one "
 								& "expected by test-vectors file (both are the null point).");
 							stats_ok := stats_ok + 1;
 							stats_total := stats_total + 1;
 						else
-							echo_test_label(test_label, test_label_sz, "(-P)");
+							echo_test_label(test_label, test_label_sz, "(-P)", test_t0);
 							echol(" **** FAILED! **** Mismatch between simulated RTL (-P != 0) and "
 								& "result expected by test-vectors file (-P = 0).");
 							stats_nok := stats_nok + 1;
@@ -1906,26 +2059,28 @@ begin
 							-- Hence it is set to 'sw_p_is_null' according to what was
 							-- given in the input test-vectors file.
 							--
+							cyc_operands;
 							point_negate(s_axi_aclk, axi0, axo0, valnn, px_val, py_val,
 								sw_p_is_null);
 							--
 							-- Poll until IP has completed computation and is ready.
 							--
 							poll_until_ready(s_axi_aclk, axi0, axo0);
+							cyc_computed;
 							-- Check & display possible errors.
 							display_errors(s_axi_aclk, axi0, axo0);
 							-- Check if result -P (now buffered in R1) is null.
 							check_if_r1_null(s_axi_aclk, axi0, axo0, hw_negp_is_null);
 							if hw_negp_is_null then
 								if sw_negp_is_null then
-									echo_test_label(test_label, test_label_sz, "(-P)");
+									echo_test_label(test_label, test_label_sz, "(-P)", test_t0);
 									echol(" - SUCCESSFULL: RTL result for (-P) matches the one "
 										& "expected by test-vectors file (both are the null "
 										& "point).");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "(-P)");
+									echo_test_label(test_label, test_label_sz, "(-P)", test_t0);
 									echol(" **** FAILED! **** Mismatch between simulated RTL (-P = 0) "
 										& "and result expected by test-vectors file (-P != 0).");
 									stats_nok := stats_nok + 1;
@@ -1942,13 +2097,13 @@ begin
 								if compare_two_points_coords(sw_negpx_val, sw_negpy_val,
 									hw_negpx_val, hw_negpy_val, valnn)
 								then
-									echo_test_label(test_label, test_label_sz, "(-P)");
+									echo_test_label(test_label, test_label_sz, "(-P)", test_t0);
 									echol(" - SUCCESSFULL: (-P) point coordinates match the ones given "
 										& "in the input test-vectors file.");
 									stats_ok := stats_ok + 1;
 									stats_total := stats_total + 1;
 								else
-									echo_test_label(test_label, test_label_sz, "(-P)");
+									echo_test_label(test_label, test_label_sz, "(-P)", test_t0);
 									echol(" **** FAILED! **** Mismatch on points coordinates. "
 										& "Simulated RTL gave:");
 									echo("[     ecc_tb.vhd ]: (-P).x = 0x");
@@ -1993,6 +2148,7 @@ begin
 					-- Set point(s) to do the test on, according to parameters
 					-- extracted from the input test-vectors file.
 					--
+					cyc_operands;
 					case op is
 						when OP_TST_CHK =>
 							point_test_on_curve(s_axi_aclk, axi0, axo0, valnn, px_val, py_val,
@@ -2011,6 +2167,7 @@ begin
 					-- Poll until IP has completed computation and is ready.
 					--
 					poll_until_ready(s_axi_aclk, axi0, axo0);
+					cyc_computed;
 					-- Check & display possible errors.
 					display_errors(s_axi_aclk, axi0, axo0);
 					-- Get answer to test from DuT.
@@ -2019,11 +2176,11 @@ begin
 					-- file.
 					case op is
 						when OP_TST_CHK =>
-							echo_test_label(test_label, test_label_sz, "isPoncurve");
+							echo_test_label(test_label, test_label_sz, "isPoncurve", test_t0);
 						when OP_TST_EQU =>
-							echo_test_label(test_label, test_label_sz, "isP==Q");
+							echo_test_label(test_label, test_label_sz, "isP==Q", test_t0);
 						when OP_TST_OPP =>
-							echo_test_label(test_label, test_label_sz, "isP==-Q");
+							echo_test_label(test_label, test_label_sz, "isP==-Q", test_t0);
 						when others =>
 							echol("[     ecc_tb.vhd ]: Internal ERROR (Unknown test type).");
 							print_stats_and_exit;
@@ -2066,6 +2223,12 @@ begin
 
 			-- Reset a certain number of flags is expect_none = TRUE.
 			if line_type_expected = EXPECT_NONE then
+				if test_ran then
+					cyc_end_of_test;
+					if (not hwsecure) and op = OP_KP then
+						trng_diag_end_of_kp;
+					end if;
+				end if;
 				nbbld := 0;
 				op := OP_NONE;
 				test_is_an_exception := FALSE;
@@ -2073,18 +2236,66 @@ begin
 
 		end loop; -- while not EOF
 
+		file_close(fcyc);
 		echol("[     ecc_tb.vhd ]: End of testbench simulation (EOF) (" & time'image(now) & ")");
 
 		echol("[     ecc_tb.vhd ]: Tests statistics:");
 		echol("[     ecc_tb.vhd ]:      ok = " & integer'image(stats_ok));
 		echol("[     ecc_tb.vhd ]:      nok = " & integer'image(stats_nok));
 		echol("[     ecc_tb.vhd ]:      total = " & integer'image(stats_total));
+		if not hwsecure then
+			echol("[     ecc_tb.vhd ]: TRNG starving/served cycles over all [k]P "
+				& "tests (trngdrbg = " & boolean'image(trngdrbg) & "):");
+			for i in 0 to 4 loop
+				echol("[     ecc_tb.vhd ]:      " & TRNG_DIAG_NAME(3*i + 1 to 3*i + 3)
+					& " = " & integer'image(trng_starv_tot(i)) & "/"
+					& integer'image(trng_ok_tot(i)));
+			end loop;
+		end if;
 
 		-- Wait indefinitely.
 		wait;
 
 	end process steam;
 
+	-- ------------------------------------------------------------------
+	-- Passive monitor of the AXI bus, for the cycle accounting of tests
+	-- (see process 'steam' above): it timestamps the writes of W_CTRL
+	-- which start an operation (from the address to the data handshake)
+	-- and counts the cycles spent in all other writes of W_CTRL (selection
+	-- of a large number to write or read, token).
+	-- ------------------------------------------------------------------
+	axi_monitor: process(s_axi_aclk)
+		variable inctrl : boolean := FALSE;
+		variable t0 : time;
+		variable nbcyc : natural;
+	begin
+		if s_axi_aclk'event and s_axi_aclk = '1' then
+			if (not inctrl) and axi0.awvalid = '1' and axi0.awaddr = W_CTRL & "000" then
+				inctrl := TRUE;
+				t0 := now;
+				nbcyc := 0;
+			end if;
+			if inctrl then
+				nbcyc := nbcyc + 1;
+				if axi0.wvalid = '1' and axo0.wready = '1' then
+					inctrl := FALSE;
+					if axi0.wdata(CTRL_KP) = '1' or axi0.wdata(CTRL_PT_ADD) = '1'
+						or axi0.wdata(CTRL_PT_DBL) = '1' or axi0.wdata(CTRL_PT_CHK) = '1'
+						or axi0.wdata(CTRL_PT_NEG) = '1' or axi0.wdata(CTRL_PT_EQU) = '1'
+						or axi0.wdata(CTRL_PT_OPP) = '1'
+					then
+						mon_cmd_t0 <= t0;
+						mon_cmd_t1 <= now;
+						mon_cmd_sel <= mon_sel;
+					else
+						mon_sel <= mon_sel + nbcyc;
+					end if;
+				end if;
+			end if;
+		end if;
+	end process axi_monitor;
+
 	-- ------------------------------------------------------------------
 	-- Generation of stimuli signals to pseudo_trng.
 	--
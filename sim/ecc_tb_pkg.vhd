@@ -91,6 +91,19 @@ package ecc_tb_pkg is
 		constant addr : in natural range 0 to nblargenb - 1;
 		constant bignb : in std_logic_vector);
 
+	-- Identical to write_big, except that if 'ovl' is TRUE, R_STATUS is
+	-- polled until it shows either ready or MTYOVL, i.e until the IP is only
+	-- busy computing the Montgomery constants of p (option mtyovl = TRUE in
+	-- ecc_customize.vhd), which is when a, b & q can be written.
+	procedure write_big(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant addr : in natural range 0 to nblargenb - 1;
+		constant bignb : in std_logic_vector;
+		constant ovl : in boolean);
+
 	-- Identical to write_big, except that here HW unsecure mode
 	-- is assumed, hence we do not poll the BUSY bit in R_STATUS register
 	-- (otherwise we would be creating a deadlock)
@@ -234,7 +247,9 @@ package ecc_tb_pkg is
 		signal axi: out axi_in_type;
 		signal axo: in axi_out_type);
 
-	-- Emulate software driver setting all curve parameters.
+	-- Emulate software driver setting all curve parameters (after having
+	-- selected the Solinas reduction mode through W_FASTRED if p is p256 or
+	-- p384 and the IP has the mode, like hw_driver_set_curve() does).
 	procedure set_curve(
 		signal clk: in std_logic;
 		signal axi: out axi_in_type;
@@ -242,6 +257,31 @@ package ecc_tb_pkg is
 		constant size: in positive;
 		constant curve: curve_param_type);
 
+	-- Copy of the curves software has bound to the context slots of the IP
+	-- (option nbctx > 0 in ecc_customize.vhd), like ip_ecc_ctx[] of the
+	-- driver: 'nn' = 0 means the slot is empty, 'stamp' is the date of its
+	-- last use (slots are replaced in LRU order).
+	type ctx_curves_type is array(integer range 0 to 15) of curve_param_type;
+	type ctx_naturals_type is array(integer range 0 to 15) of natural;
+	type ctx_cache_type is record
+		curve : ctx_curves_type;
+		nn : ctx_naturals_type;
+		stamp : ctx_naturals_type;
+		date : natural;
+	end record;
+
+	-- Identical to set_curve, except that if the IP has context slots (nbctx
+	-- > 0), a curve already held by one of them is restored with one write
+	-- of W_CURVE_SELECT, otherwise the least recently used slot is bound to
+	-- the curve before it is uploaded (like hw_driver_set_curve() does).
+	procedure set_curve(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant size: in positive;
+		constant curve: curve_param_type;
+		variable ctx : inout ctx_cache_type);
+
 	-- Emulate software driver setting R0 to be the null point.
 	procedure set_r0_null(
 		signal clk: in std_logic;
@@ -694,10 +734,49 @@ package ecc_tb_pkg is
 		signal axi: out axi_in_type;
 		signal axo: in axi_out_type);
 
+	-- Emulate software driver reading the TRNG diagnostic counters of one
+	-- client interface (id = DBG_TRNG_CTRL_DIAG_[AXI|EFP|CRV|SHF|RAW]): nb
+	-- of cycles where a random word was served ('ok') & nb of cycles where
+	-- the client was starving ('starv').
+	procedure debug_trng_read_diag(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant id : in natural;
+		variable ok : out natural;
+		variable starv : out natural);
+
 end package ecc_tb_pkg;
 
 package body ecc_tb_pkg is
 
+	-- Poll R_STATUS until bit BUSY is deasserted or, if 'ovl' is TRUE, until
+	-- bit MTYOVL is asserted
+	procedure poll_until_ready_or_mtyovl(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant ovl : in boolean) is
+	begin
+		loop
+			wait until clk'event and clk = '1';
+			-- read R_STATUS register
+			axi.araddr <= R_STATUS & "000";
+			axi.arvalid <= '1';
+			wait until clk'event and clk = '1' and axo.arready = '1';
+			axi.araddr <= (others => 'X');
+			axi.arvalid <= '0';
+			axi.rready <= '1';
+			wait until clk'event and clk = '1' and axo.rvalid = '1';
+			axi.rready <= '0';
+			if axo.rdata(STATUS_BUSY) = '0'
+				or (ovl and axo.rdata(STATUS_MTYOVL) = '1')
+			then
+				exit;
+			end if;
+		end loop;
+	end procedure;
+
 	procedure poll_until_ready(
 		signal clk: in std_logic;
 		signal axi: out axi_in_type;
@@ -746,12 +825,24 @@ package body ecc_tb_pkg is
 		signal axo: in axi_out_type;
 		constant valnn : in positive;
 		constant addr : in natural range 0 to nblargenb - 1;
-		constant bignb : in std_logic_vector)
+		constant bignb : in std_logic_vector) is
+	begin
+		write_big(clk, axi, axo, valnn, addr, bignb, FALSE);
+	end procedure;
+
+	procedure write_big(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant addr : in natural range 0 to nblargenb - 1;
+		constant bignb : in std_logic_vector;
+		constant ovl : in boolean)
 	is
 		variable dw : std_logic_vector(AXIDW - 1 downto 0);
 	begin
 		wait until clk'event and clk = '1';
-		poll_until_ready(clk, axi, axo);
+		poll_until_ready_or_mtyovl(clk, axi, axo, ovl);
 		wait until clk'event and clk = '1';
 		-- write W_CTRL register
 		axi.awaddr <= W_CTRL & "000"; axi.awvalid <= '1';
@@ -768,7 +859,7 @@ package body ecc_tb_pkg is
 		axi.wvalid <= '0';
 		-- now perform the proper nb of writes of the W_WRITE_DATA register
 		for i in 0 to div(valnn,AXIDW) - 1 loop
-			poll_until_ready(clk, axi, axo);
+			poll_until_ready_or_mtyovl(clk, axi, axo, ovl);
 			axi.awaddr <= W_WRITE_DATA & "000"; axi.awvalid <= '1';
 			wait until clk'event and clk = '1' and axo.awready = '1';
 			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
@@ -1439,7 +1530,9 @@ package body ecc_tb_pkg is
 		wait until clk'event and clk = '1';
 	end procedure;
 
-	procedure set_curve(
+	-- Select the Solinas reduction mode through W_FASTRED if p is p256 or
+	-- p384 and the IP has the mode (the generic one otherwise)
+	procedure set_fastred(
 		signal clk: in std_logic;
 		signal axi: out axi_in_type;
 		signal axo: in axi_out_type;
@@ -1447,14 +1540,136 @@ package body ecc_tb_pkg is
 		constant curve: curve_param_type)
 	is
 		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		variable p, p256, p384 : unsigned(1023 downto 0);
+		constant one : unsigned(1023 downto 0) := to_unsigned(1, 1024);
 	begin
 		wait until clk'event and clk = '1';
-		for i in 0 to 3 loop
+		if FASTRED_EN then -- statically resolved
+			p := resize(unsigned(curve(0)(size - 1 downto 0)), 1024);
+			p256 := shift_left(one, 256) - shift_left(one, 224)
+				+ shift_left(one, 192) + shift_left(one, 96) - 1;
+			p384 := shift_left(one, 384) - shift_left(one, 128)
+				- shift_left(one, 96) + shift_left(one, 32) - 1;
+			dw := (others => '0');
+			if p = p256 then
+				dw(FASTRED_MODE_MSB downto FASTRED_MODE_LSB) := FASTRED_P256;
+			elsif p = p384 then
+				dw(FASTRED_MODE_MSB downto FASTRED_MODE_LSB) := FASTRED_P384;
+			else
+				dw(FASTRED_MODE_MSB downto FASTRED_MODE_LSB) := FASTRED_NONE;
+			end if;
 			poll_until_ready(clk, axi, axo);
-			write_big(clk, axi, axo, size, CURVE_PARAM_ADDR(i), curve(i));
+			-- write W_FASTRED register
+			axi.awaddr <= W_FASTRED & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			axi.wdata <= dw;
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+			wait until clk'event and clk = '1';
+		end if;
+	end procedure;
+
+	-- Upload p, a, b & q (with mtyovl = TRUE in ecc_customize.vhd, a, b & q
+	-- are written while the Montgomery constants of p are being computed)
+	procedure upload_curve(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant size: in positive;
+		constant curve: curve_param_type) is
+	begin
+		for i in 0 to 3 loop
+			write_big(clk, axi, axo, size, CURVE_PARAM_ADDR(i), curve(i),
+				mtyovl and i > 0);
 		end loop;
 	end procedure;
 
+	procedure set_curve(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant size: in positive;
+		constant curve: curve_param_type) is
+	begin
+		set_fastred(clk, axi, axo, size, curve);
+		upload_curve(clk, axi, axo, size, curve);
+	end procedure;
+
+	procedure set_curve(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant size: in positive;
+		constant curve: curve_param_type;
+		variable ctx : inout ctx_cache_type)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+		variable slot : natural;
+		variable hit : boolean;
+	begin
+		if nbctx = 0 then -- statically resolved
+			set_curve(clk, axi, axo, size, curve);
+			return;
+		end if;
+		-- is the curve held by one of the slots?
+		hit := FALSE;
+		slot := 0;
+		for i in 0 to nbctx - 1 loop
+			if ctx.nn(i) = size then
+				hit := TRUE;
+				for j in 0 to 3 loop
+					if ctx.curve(i)(j)(size - 1 downto 0)
+						/= curve(j)(size - 1 downto 0)
+					then
+						hit := FALSE;
+					end if;
+				end loop;
+			end if;
+			if hit then
+				slot := i;
+				exit;
+			end if;
+		end loop;
+		-- otherwise, replace the least recently used one
+		if not hit then
+			for i in 1 to nbctx - 1 loop
+				if ctx.stamp(i) < ctx.stamp(slot) then
+					slot := i;
+				end if;
+			end loop;
+		end if;
+		ctx.date := ctx.date + 1;
+		ctx.stamp(slot) := ctx.date;
+		-- (the reduction mode a slot was computed with must be the current
+		-- one for it to be restored)
+		set_fastred(clk, axi, axo, size, curve);
+		poll_until_ready(clk, axi, axo);
+		-- write W_CURVE_SELECT register
+		axi.awaddr <= W_CURVE_SELECT & "000"; axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+		dw := (others => '0');
+		dw(CURVE_SEL_SLOT_MSB downto CURVE_SEL_SLOT_LSB) :=
+			std_logic_vector(to_unsigned(slot,
+				CURVE_SEL_SLOT_MSB - CURVE_SEL_SLOT_LSB + 1));
+		if hit then
+			dw(CURVE_SEL_LOAD) := '1';
+		end if;
+		axi.wdata <= dw;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+		wait until clk'event and clk = '1';
+		if not hit then
+			-- the slot is now bound to the curve, upload it
+			upload_curve(clk, axi, axo, size, curve);
+			ctx.nn(slot) := size;
+			ctx.curve(slot) := curve;
+		end if;
+	end procedure;
+
 	procedure set_r0_null(
 		signal clk: in std_logic;
 		signal axi: out axi_in_type;
@@ -3071,4 +3286,57 @@ package body ecc_tb_pkg is
 		wait until clk'event and clk = '1';
 	end procedure debug_trng_nnrnd_not_deterministic;
 
+	procedure debug_trng_read_diag(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant id : in natural;
+		variable ok : out natural;
+		variable starv : out natural)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		wait until clk'event and clk = '1';
+		-- Write W_DBG_TRNG_CTRL_DIAG register to select the client interface.
+		axi.awaddr <= W_DBG_TRNG_CTRL_DIAG & "000";
+		axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X');
+		axi.awvalid <= '0';
+		dw := (others => '0');
+		dw(DBG_TRNG_CTRL_DIAG_SELECT_MSB downto DBG_TRNG_CTRL_DIAG_SELECT_LSB) :=
+			std_logic_vector(to_unsigned(id, DBG_TRNG_CTRL_DIAG_SELECT_MSB
+				- DBG_TRNG_CTRL_DIAG_SELECT_LSB + 1));
+		axi.wdata <= dw;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X');
+		axi.wvalid <= '0';
+		-- Read R_DBG_TRNG_DIAG_OK & R_DBG_TRNG_DIAG_STARV registers
+		-- (counts are not expected to reach 2**31 in simulation)
+		wait until clk'event and clk = '1';
+		axi.araddr <= R_DBG_TRNG_DIAG_OK & "000";
+		axi.arvalid <= '1';
+		wait until clk'event and clk = '1' and axo.arready = '1';
+		axi.araddr <= (others => 'X');
+		axi.arvalid <= '0';
+		axi.rready <= '1';
+		wait until clk'event and clk = '1' and axo.rvalid = '1';
+		axi.rready <= '0';
+		ok := to_integer(unsigned(axo.rdata(R_DBG_TRNG_DIAG_OK_MSB - 1
+			downto R_DBG_TRNG_DIAG_OK_LSB)));
+		wait until clk'event and clk = '1';
+		axi.araddr <= R_DBG_TRNG_DIAG_STARV & "000";
+		axi.arvalid <= '1';
+		wait until clk'event and clk = '1' and axo.arready = '1';
+		axi.araddr <= (others => 'X');
+		axi.arvalid <= '0';
+		axi.rready <= '1';
+		wait until clk'event and clk = '1' and axo.rvalid = '1';
+		axi.rready <= '0';
+		starv := to_integer(unsigned(axo.rdata(R_DBG_TRNG_DIAG_ST_MSB - 1
+			downto R_DBG_TRNG_DIAG_ST_LSB)));
+		wait until clk'event and clk = '1';
+	end procedure debug_trng_read_diag;
+
 end package body;
@@ -0,0 +1,196 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_trng_pkg.all;
+
+use std.textio.all;
+
+-- Known-answer test of the ChaCha20 block function of the DRBG expander of
+-- ecc_trng_pp (see (s0) in ecc_trng_pp.vhd, requires 'trngdrbg' = TRUE in
+-- ecc_customize.vhd).
+--
+-- The expander uses a null nonce and a 64-bit block counter starting at 0,
+-- which for counters lower than 2**32 is the same as the block function of
+-- RFC 8439 with a null nonce. The raw bytes fed to ecc_trng_pp make up the
+-- key (byte i of the key is the i-th byte received, the first 8 raw words
+-- being the key itself and the following ones XORed into it), so the test
+-- vectors of RFC 8439 appendix A.1 with a null nonce can be used:
+--
+--   - 32 null bytes are fed: blocks 0 & 1 must be those of test vectors #1
+--     (null key, counter 0) & #2 (null key, counter 1) ;
+--   - before block 1 is read, the bytes of key 00:ff:00:...:00 are fed
+--     (XORed into the null key when block 1 has been served), so block 2
+--     must be the one of test vector #4 (same key, counter 2).
+--
+-- Each output word is the little-endian reading of 4 bytes of keystream.
+entity ecc_trng_pp_tb is
+end entity ecc_trng_pp_tb;
+
+architecture sim of ecc_trng_pp_tb is
+
+	-- DuT component declaration
+	component ecc_trng_pp is
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_scalar
+			irn_reset : in std_logic;
+			-- interface with es_trng
+			data_t : in std_logic_vector(7 downto 0);
+			valid_t : in std_logic;
+			rdy_t : out std_logic;
+			-- interface with ecc_trng_srv
+			data_s : out std_logic_vector(pp_irn_width - 1 downto 0);
+			valid_s : out std_logic;
+			rdy_s : in std_logic;
+			dbgtrngrawpullppdis : in std_logic;
+			dbgtrngusepseudosource : in std_logic;
+			-- interface with the external pseudo TRNG component
+			dbgpseudotrngdata : in std_logic_vector(7 downto 0);
+			dbgpseudotrngvalid : in std_logic;
+			dbgpseudotrngrdy : out std_logic
+		);
+	end component ecc_trng_pp;
+
+	constant CLK_PERIOD : time := 10 ns;
+
+	subtype word32 is std_logic_vector(31 downto 0);
+	type block_type is array(0 to 15) of word32;
+	type blocks_type is array(0 to 2) of block_type;
+
+	-- RFC 8439, appendix A.1, test vectors #1, #2 & #4 (as 32-bit words)
+	constant KAT : blocks_type := (
+		(x"ade0b876", x"903df1a0", x"e56a5d40", x"28bd8653",
+		 x"b819d2bd", x"1aed8da0", x"ccef36a8", x"c70d778b",
+		 x"7c5941da", x"8d485751", x"3fe02477", x"374ad8b8",
+		 x"f4b8436a", x"1ca11815", x"69b687c3", x"8665eeb2"),
+		(x"bee7079f", x"7a385155", x"7c97ba98", x"0d082d73",
+		 x"a0290fcb", x"6965e348", x"3e53c612", x"ed7aee32",
+		 x"7621b729", x"434ee69c", x"b03371d5", x"d539d874",
+		 x"281fed31", x"45fb0a51", x"1f0ae1ac", x"6f4d794b"),
+		(x"fb4dd572", x"4bc42ef1", x"df922636", x"327f1394",
+		 x"a78dea8f", x"5e269039", x"a1bebbc1", x"caf09aae",
+		 x"a25ab213", x"48a6b46c", x"1b9d9bcb", x"092c5be6",
+		 x"546ca624", x"1bec45d5", x"87f47473", x"96f0992e"));
+
+	signal clk : std_logic := '0';
+	signal rstn : std_logic := '0';
+	signal data_t : std_logic_vector(7 downto 0) := (others => '0');
+	signal valid_t : std_logic := '0';
+	signal rdy_t : std_logic;
+	signal data_s : std_logic_vector(pp_irn_width - 1 downto 0);
+	signal valid_s : std_logic;
+	signal rdy_s : std_logic := '0';
+	signal dbgpseudotrngrdy : std_logic;
+
+	-- stops the clock (hence the simulation) once all tests are done
+	signal done : boolean := FALSE;
+
+begin
+
+	clk <= not clk after CLK_PERIOD / 2 when not done else '0';
+
+	p0: ecc_trng_pp
+		port map(
+			clk => clk, rstn => rstn, swrst => '0', irn_reset => '0',
+			data_t => data_t, valid_t => valid_t, rdy_t => rdy_t,
+			data_s => data_s, valid_s => valid_s, rdy_s => rdy_s,
+			-- pulling of raw bytes enabled, from the real source (only
+			-- meaningful when 'hwsecure' = FALSE)
+			dbgtrngrawpullppdis => '0', dbgtrngusepseudosource => '0',
+			dbgpseudotrngdata => (others => '0'), dbgpseudotrngvalid => '0',
+			dbgpseudotrngrdy => dbgpseudotrngrdy
+		);
+
+	process
+		variable nberr : natural := 0;
+		variable lin : line;
+
+		-- feed the 32 bytes of a key (all null but byte 1, set to 'b1')
+		procedure feed_key(constant b1 : in std_logic_vector(7 downto 0)) is
+		begin
+			for i in 0 to 31 loop
+				if i = 1 then
+					data_t <= b1;
+				else
+					data_t <= x"00";
+				end if;
+				valid_t <= '1';
+				wait until clk'event and clk = '1' and rdy_t = '1';
+				valid_t <= '0';
+			end loop;
+			-- (let the last raw word be assembled & consumed as seed)
+			for i in 0 to 63 loop
+				wait until clk'event and clk = '1';
+			end loop;
+		end procedure;
+
+		-- read one block of 16 words & check it against KAT(b)
+		procedure read_block(constant b : in natural) is
+		begin
+			for i in 0 to 15 loop
+				rdy_s <= '1';
+				wait until clk'event and clk = '1' and valid_s = '1';
+				rdy_s <= '0';
+				if data_s /= KAT(b)(i) then
+					write(lin, string'("block ") & integer'image(b) & ", word "
+					     & integer'image(i) & ": MISMATCH");
+					writeline(output, lin);
+					nberr := nberr + 1;
+				end if;
+			end loop;
+			write(lin, string'("block ") & integer'image(b) & " (RFC 8439 A.1 #"
+			     & integer'image(b + 1 + (b / 2)) & ") done");
+			writeline(output, lin);
+		end procedure;
+
+	begin
+		assert trngdrbg and pp_irn_width = 32
+			report "ecc_trng_pp_tb: parameter 'trngdrbg' must be TRUE"
+				severity FAILURE;
+
+		rstn <= '0';
+		for i in 0 to 9 loop
+			wait until clk'event and clk = '1';
+		end loop;
+		rstn <= '1';
+		for i in 0 to 9 loop
+			wait until clk'event and clk = '1';
+		end loop;
+
+		-- null key, blocks 0 & 1
+		feed_key(x"00");
+		read_block(0);
+		-- block 1 has been computed & waits to be served: the next seed is
+		-- only XORed into the key in-between blocks 1 & 2
+		feed_key(x"ff");
+		read_block(1);
+		read_block(2);
+
+		assert nberr = 0
+			report "ecc_trng_pp_tb: " & integer'image(nberr) & " wrong word(s)"
+				severity FAILURE;
+		report "ecc_trng_pp_tb: all blocks OK" severity NOTE;
+		done <= TRUE;
+		wait;
+	end process;
+
+end architecture sim;
@@ -0,0 +1,595 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+use ieee.math_real.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.mm_ndsp_pkg.all;
+
+use std.textio.all;
+
+-- Testbench for the Montgomery multipliers alone.
+--
+-- The single-chain multiplier (mm_ndsp) & the multi-chain one (mm_ndsp_mc)
+-- are instanciated side by side and fed with the same random operands
+-- (x, y & p of 'nn' bits, p' = -p^-1 mod R, with R = 2**(nn + 2)), one
+-- REDC out of two being a squaring (sqr = 1).
+-- Both results are checked against (x * y + alpha * p) / R computed by the
+-- testbench itself and the number of clock cycles between 'go' & 'irq'
+-- is displayed for each of them, along with their average at the end.
+--
+-- Each squaring with a random modulus is run a second time as a generic
+-- multiplication of x by itself (sqr = 0, x & y both transferred), which
+-- is what ecc_fp does for an FPREDC instead of an FPSQR (see (s158) in
+-- ecc_fp.vhd). Both results are checked the same way, and the average nb
+-- of cycles from the start of the transfer of x to 'irq' is displayed for
+-- both ways (the testbench adds 2 idle cycles after each transfer).
+--
+-- When the Solinas reduction mode of mm_ndsp_mc is available (parameter
+-- 'fastred', see FASTRED_EN in ecc_pkg.vhd) the random tests are followed
+-- by tests with p = p256 (if 'nn' >= 256) & p = p384 (if 'nn' >= 384), for
+-- which mm_ndsp_mc runs in Solinas mode (input 'redmode') while mm_ndsp
+-- still runs a generic REDC. The result of mm_ndsp_mc is then checked to be
+-- congruent to x * y mod p & lower than 2**(32K) (K = 8 or 12), and the
+-- average latencies are displayed for each prime, which compares the two
+-- reduction methods.
+--
+-- Parameters 'nn', 'ww' (through 'techno' & 'multwidth'), 'nbdsp', 'nbchain'
+-- & 'sramlat' are taken from ecc_customize.vhd ('nbchain' = 0 is simulated
+-- as 'nbchain' = 1 here). Parameter 'async' must be set to FALSE.
+entity mm_ndsp_tb is
+end entity mm_ndsp_tb;
+
+architecture sim of mm_ndsp_tb is
+
+	-- single DSP chain Montgomery multiplier
+	component mm_ndsp is
+		port(
+			clkmm : in std_logic;
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			go : in std_logic;
+			rdy : out std_logic;
+			xyin : in std_logic_vector(ww - 1 downto 0);
+			xen : in std_logic;
+			yen : in std_logic;
+			sqr : in std_logic;
+			fpwdata : in std_logic_vector(ww - 1 downto 0);
+			fpwe : in std_logic;
+			pen : in std_logic;
+			ppen : in std_logic;
+			nndyn_mask : in std_logic_vector(ww - 1 downto 0);
+			nndyn_shrcnt : in unsigned(log2(ww) - 1 downto 0);
+			nndyn_shlcnt : in unsigned(log2(ww) - 1 downto 0);
+			nndyn_w : in unsigned(log2(w) - 1 downto 0);
+			nndyn_wm1 : in unsigned(log2(w - 1) - 1 downto 0);
+			nndyn_wm2 : in unsigned(log2(w - 1) - 1 downto 0);
+			nndyn_2wm1 : in unsigned(log2((2*w) - 1) - 1 downto 0);
+			nndyn_wmin : in unsigned(log2((2*w) - 1) - 1 downto 0);
+			nndyn_wmin_excp_val : in unsigned(log2(2*w - 1) - 1 downto 0);
+			nndyn_wmin_excp : in std_logic;
+			nndyn_mask_wm2 : in std_logic;
+			nndyn_w_less_eq_ndsp : in std_logic;
+			nndyn_w_less_ndsp : in std_logic;
+			nndyn_w_multiple_of_ndsp : in std_logic;
+			nndyn_w_div_ndsp_minus_one : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+			nndyn_w_div_ndsp : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+			nndyn_nb_bursts : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+			nndyn_slkpivot_0 : in signed(NB_SLK_BITS - 1 downto 0);
+			nndyn_slkpivot_0_larger_cstslk : in std_logic;
+			nndyn_slkpivot_1 : in signed(NB_SLK_BITS - 1 downto 0);
+			nndyn_slkpivot_1_larger_cstslk : in std_logic;
+			z : out std_logic_vector(ww - 1 downto 0);
+			zren : in std_logic;
+			irq : out std_logic;
+			go_ack : out std_logic;
+			irq_ack : in std_logic
+		);
+	end component mm_ndsp;
+
+	-- multi-chain Montgomery multiplier
+	component mm_ndsp_mc is
+		port(
+			clkmm : in std_logic;
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			go : in std_logic;
+			rdy : out std_logic;
+			xyin : in std_logic_vector(ww - 1 downto 0);
+			xen : in std_logic;
+			yen : in std_logic;
+			sqr : in std_logic;
+			fpwdata : in std_logic_vector(ww - 1 downto 0);
+			fpwe : in std_logic;
+			pen : in std_logic;
+			ppen : in std_logic;
+			nndyn_mask : in std_logic_vector(ww - 1 downto 0);
+			nndyn_shrcnt : in unsigned(log2(ww) - 1 downto 0);
+			nndyn_shlcnt : in unsigned(log2(ww) - 1 downto 0);
+			nndyn_w : in unsigned(log2(w) - 1 downto 0);
+			nndyn_wm1 : in unsigned(log2(w - 1) - 1 downto 0);
+			nndyn_wm2 : in unsigned(log2(w - 1) - 1 downto 0);
+			nndyn_2wm1 : in unsigned(log2((2*w) - 1) - 1 downto 0);
+			nndyn_wmin : in unsigned(log2((2*w) - 1) - 1 downto 0);
+			nndyn_wmin_excp_val : in unsigned(log2(2*w - 1) - 1 downto 0);
+			nndyn_wmin_excp : in std_logic;
+			nndyn_mask_wm2 : in std_logic;
+			nndyn_w_less_eq_ndsp : in std_logic;
+			nndyn_w_less_ndsp : in std_logic;
+			nndyn_w_multiple_of_ndsp : in std_logic;
+			nndyn_w_div_ndsp_minus_one : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+			nndyn_w_div_ndsp : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+			nndyn_nb_bursts : in unsigned(log2(div(w, ndsp)) - 1 downto 0);
+			nndyn_slkpivot_0 : in signed(NB_SLK_BITS - 1 downto 0);
+			nndyn_slkpivot_0_larger_cstslk : in std_logic;
+			nndyn_slkpivot_1 : in signed(NB_SLK_BITS - 1 downto 0);
+			nndyn_slkpivot_1_larger_cstslk : in std_logic;
+			redmode : in std_logic_vector(1 downto 0);
+			z : out std_logic_vector(ww - 1 downto 0);
+			zren : in std_logic;
+			irq : out std_logic;
+			go_ack : out std_logic;
+			irq_ack : in std_logic
+		);
+	end component mm_ndsp_mc;
+
+	constant CLK_PERIOD : time := 10 ns;
+	constant NBTESTS : positive := 32;
+	constant NBFAST : positive := 8; -- per NIST prime (Solinas mode)
+	constant RBITS : positive := nn + 2; -- R = 2**RBITS
+
+	signal clk : std_logic := '0';
+	signal rstn : std_logic := '0';
+	signal go : std_logic := '0';
+	signal xyin : std_logic_vector(ww - 1 downto 0) := (others => '0');
+	signal xen, yen, sqr : std_logic := '0';
+	signal fpwdata : std_logic_vector(ww - 1 downto 0) := (others => '0');
+	signal fpwe, pen, ppen : std_logic := '0';
+	signal zren : std_logic := '0';
+	signal rdy0, rdy1 : std_logic;
+	signal irq0, irq1 : std_logic;
+	signal z0, z1 : std_logic_vector(ww - 1 downto 0);
+	signal go_ack0, go_ack1 : std_logic;
+	signal redmode : std_logic_vector(1 downto 0) := "00";
+
+	-- static values, same as in ecc_axi.vhd when nn_dynamic = FALSE
+	signal nndyn_mask : std_logic_vector(ww - 1 downto 0);
+	signal nndyn_shrcnt : unsigned(log2(ww) - 1 downto 0);
+	signal nndyn_shlcnt : unsigned(log2(ww) - 1 downto 0);
+	signal nndyn_w : unsigned(log2(w) - 1 downto 0);
+	signal nndyn_wm1 : unsigned(log2(w - 1) - 1 downto 0);
+	signal nndyn_wm2 : unsigned(log2(w - 1) - 1 downto 0);
+	signal nndyn_2wm1 : unsigned(log2((2*w) - 1) - 1 downto 0);
+	signal nndyn_wmin : unsigned(log2((2*w) - 1) - 1 downto 0);
+	signal nndyn_wmin_excp_val : unsigned(log2(2*w - 1) - 1 downto 0);
+	signal nndyn_wmin_excp : std_logic;
+	signal nndyn_mask_wm2 : std_logic;
+	signal nndyn_w_less_eq_ndsp : std_logic;
+	signal nndyn_w_less_ndsp : std_logic;
+	signal nndyn_w_multiple_of_ndsp : std_logic;
+	signal nndyn_w_div_ndsp_minus_one : unsigned(log2(div(w, ndsp)) - 1 downto 0);
+	signal nndyn_w_div_ndsp : unsigned(log2(div(w, ndsp)) - 1 downto 0);
+	signal nndyn_nb_bursts : unsigned(log2(div(w, ndsp)) - 1 downto 0);
+	signal nndyn_slkpivot_0 : signed(NB_SLK_BITS - 1 downto 0);
+	signal nndyn_slkpivot_0_larger_cstslk : std_logic;
+	signal nndyn_slkpivot_1 : signed(NB_SLK_BITS - 1 downto 0);
+	signal nndyn_slkpivot_1_larger_cstslk : std_logic;
+
+	-- cycle counter
+	signal cycles : natural := 0;
+
+	-- stops the clock (hence the simulation) once all tests are done
+	signal done : boolean := FALSE;
+
+begin
+
+	clk <= not clk after CLK_PERIOD / 2 when not done else '0';
+
+	process(clk)
+	begin
+		if clk'event and clk = '1' then
+			cycles <= cycles + 1;
+		end if;
+	end process;
+
+	nndyn_mask <= std_logic_vector (
+		resize(unsigned(to_signed(-1, (nn + 2) mod ww)), ww) );
+	nndyn_shrcnt <= to_unsigned((nn + 2) mod ww, log2(ww));
+	nndyn_shlcnt <= to_unsigned(ww - ((nn + 2) mod ww), log2(ww));
+	nndyn_w <= to_unsigned(w, log2(w));
+	nndyn_wm1 <= to_unsigned(w - 1, log2(w - 1));
+	nndyn_wm2 <= to_unsigned(w - 2, log2(w - 1));
+	nndyn_2wm1 <= to_unsigned(2*w - 1, log2(2*w - 1));
+	nndyn_mask_wm2 <= '1' when ((nn + 2) mod ww) = ww - 1 else '0';
+	nndyn_wmin <= to_unsigned(w - 2, log2(2*w - 1))
+		when ((nn + 2) mod ww) = ww - 1
+		else to_unsigned(w - 1, log2(2*w - 1));
+	nndyn_wmin_excp_val <= to_unsigned((div(w,ndsp)-1) * ndsp, log2(2*w - 1));
+	nndyn_wmin_excp <= '1'
+		when ( (div(w, ndsp) - 1) * ndsp ) > ( (nn + 2) / ww )
+		else '0';
+	nndyn_w_less_eq_ndsp <= '1' when w <= ndsp else '0';
+	nndyn_w_less_ndsp <= '1' when w < ndsp else '0';
+	nndyn_w_multiple_of_ndsp <= '1' when w mod ndsp = 0 else '0';
+	nndyn_w_div_ndsp <= to_unsigned(w / ndsp, log2(div(w, ndsp)));
+	nndyn_w_div_ndsp_minus_one <=
+		to_unsigned((w / ndsp) - 1, log2(div(w, ndsp)));
+	nndyn_nb_bursts <= to_unsigned(div(w, ndsp), log2(div(w, ndsp)));
+	nndyn_slkpivot_0 <= to_signed(
+			NBRP + sramlat + 4 + ndsp - (MIN_SLK - 1) - (2 * w) - (w mod ndsp),
+		NB_SLK_BITS);
+	nndyn_slkpivot_0_larger_cstslk <=
+		'1' when (((NBRP + sramlat + 4 + ndsp - (MIN_SLK-1) - (2*w) - (w mod ndsp)))
+		         > MIN_SLK_LAST - 1)
+		else '0';
+	nndyn_slkpivot_1 <= to_signed(
+			NBRP + sramlat + 4 - (MIN_SLK - 1) - (2 * w), NB_SLK_BITS);
+	nndyn_slkpivot_1_larger_cstslk <=
+		'1' when ((NBRP + sramlat + 4 - (MIN_SLK-1) - (2*w)) > MIN_SLK_LAST - 1)
+		else '0';
+
+	-- single DSP chain multiplier
+	m0: mm_ndsp
+		port map(
+			clkmm => clk, clk => clk, rstn => rstn, swrst => '0',
+			go => go, rdy => rdy0,
+			xyin => xyin, xen => xen, yen => yen, sqr => sqr,
+			fpwdata => fpwdata, fpwe => fpwe, pen => pen, ppen => ppen,
+			nndyn_mask => nndyn_mask,
+			nndyn_shrcnt => nndyn_shrcnt,
+			nndyn_shlcnt => nndyn_shlcnt,
+			nndyn_w => nndyn_w,
+			nndyn_wm1 => nndyn_wm1,
+			nndyn_wm2 => nndyn_wm2,
+			nndyn_2wm1 => nndyn_2wm1,
+			nndyn_wmin => nndyn_wmin,
+			nndyn_wmin_excp_val => nndyn_wmin_excp_val,
+			nndyn_wmin_excp => nndyn_wmin_excp,
+			nndyn_mask_wm2 => nndyn_mask_wm2,
+			nndyn_w_less_eq_ndsp => nndyn_w_less_eq_ndsp,
+			nndyn_w_less_ndsp => nndyn_w_less_ndsp,
+			nndyn_w_multiple_of_ndsp => nndyn_w_multiple_of_ndsp,
+			nndyn_w_div_ndsp_minus_one => nndyn_w_div_ndsp_minus_one,
+			nndyn_w_div_ndsp => nndyn_w_div_ndsp,
+			nndyn_nb_bursts => nndyn_nb_bursts,
+			nndyn_slkpivot_0 => nndyn_slkpivot_0,
+			nndyn_slkpivot_0_larger_cstslk => nndyn_slkpivot_0_larger_cstslk,
+			nndyn_slkpivot_1 => nndyn_slkpivot_1,
+			nndyn_slkpivot_1_larger_cstslk => nndyn_slkpivot_1_larger_cstslk,
+			z => z0, zren => zren, irq => irq0,
+			go_ack => go_ack0, irq_ack => '0'
+		);
+
+	-- multi-chain multiplier
+	m1: mm_ndsp_mc
+		port map(
+			clkmm => clk, clk => clk, rstn => rstn, swrst => '0',
+			go => go, rdy => rdy1,
+			xyin => xyin, xen => xen, yen => yen, sqr => sqr,
+			fpwdata => fpwdata, fpwe => fpwe, pen => pen, ppen => ppen,
+			nndyn_mask => nndyn_mask,
+			nndyn_shrcnt => nndyn_shrcnt,
+			nndyn_shlcnt => nndyn_shlcnt,
+			nndyn_w => nndyn_w,
+			nndyn_wm1 => nndyn_wm1,
+			nndyn_wm2 => nndyn_wm2,
+			nndyn_2wm1 => nndyn_2wm1,
+			nndyn_wmin => nndyn_wmin,
+			nndyn_wmin_excp_val => nndyn_wmin_excp_val,
+			nndyn_wmin_excp => nndyn_wmin_excp,
+			nndyn_mask_wm2 => nndyn_mask_wm2,
+			nndyn_w_less_eq_ndsp => nndyn_w_less_eq_ndsp,
+			nndyn_w_less_ndsp => nndyn_w_less_ndsp,
+			nndyn_w_multiple_of_ndsp => nndyn_w_multiple_of_ndsp,
+			nndyn_w_div_ndsp_minus_one => nndyn_w_div_ndsp_minus_one,
+			nndyn_w_div_ndsp => nndyn_w_div_ndsp,
+			nndyn_nb_bursts => nndyn_nb_bursts,
+			nndyn_slkpivot_0 => nndyn_slkpivot_0,
+			nndyn_slkpivot_0_larger_cstslk => nndyn_slkpivot_0_larger_cstslk,
+			nndyn_slkpivot_1 => nndyn_slkpivot_1,
+			nndyn_slkpivot_1_larger_cstslk => nndyn_slkpivot_1_larger_cstslk,
+			redmode => redmode,
+			z => z1, zren => zren, irq => irq1,
+			go_ack => go_ack1, irq_ack => '0'
+		);
+
+	-- stimuli & checks
+	process
+		variable seed1 : positive := 17;
+		variable seed2 : positive := 3;
+		variable vrnd : real;
+		variable p, x, y : unsigned(nn - 1 downto 0);
+		variable inv, pp : unsigned(RBITS - 1 downto 0);
+		variable s : unsigned((2 * nn) - 1 downto 0);
+		variable alpha : unsigned(RBITS - 1 downto 0);
+		variable t : unsigned((2 * nn) + RBITS downto 0);
+		variable zref : unsigned((w * ww) - 1 downto 0);
+		variable zhw0, zhw1 : unsigned((w * ww) - 1 downto 0);
+		variable sm, zm : unsigned((2 * nn) - 1 downto 0);
+		variable t0, tx : natural;
+		variable npass : positive range 1 to 2;
+		variable lat0, lat1 : natural;
+		type sums_type is array(0 to 2) of natural;
+		variable sum0, sum1, nbt : sums_type := (others => 0);
+		variable md : natural range 0 to 2; -- 0: random p, 1: p256, 2: p384
+		-- transfer + REDC cycles of squarings, as such (index 0) or as
+		-- generic multiplications (index 1)
+		type sqsums_type is array(0 to 1) of natural;
+		variable sqsum0, sqsum1, nbsq : sqsums_type := (others => 0);
+		variable nberr : natural := 0;
+		variable lin : line;
+
+		-- random number of 'nn' bits (made of random bytes)
+		procedure rnd_nn(variable r : out unsigned(nn - 1 downto 0)) is
+			variable tmp : unsigned(8 * div(nn, 8) - 1 downto 0);
+		begin
+			for i in 0 to div(nn, 8) - 1 loop
+				uniform(seed1, seed2, vrnd);
+				tmp(8*i + 7 downto 8*i) := to_unsigned(integer(vrnd * 255.0), 8);
+			end loop;
+			r := tmp(nn - 1 downto 0);
+		end procedure;
+
+		-- NIST prime p256 (sz = 256) or p384 (sz = 384), with nn >= sz
+		function nist_p(constant sz : natural) return unsigned is
+			variable tmp : unsigned((2 * nn) - 1 downto 0);
+		begin
+			tmp := shift_left(to_unsigned(1, 2 * nn), sz) - 1;
+			if sz = 256 then
+				tmp := tmp - shift_left(to_unsigned(1, 2 * nn), 224)
+					+ shift_left(to_unsigned(1, 2 * nn), 192)
+					+ shift_left(to_unsigned(1, 2 * nn), 96);
+			else
+				tmp := tmp - shift_left(to_unsigned(1, 2 * nn), 128)
+					- shift_left(to_unsigned(1, 2 * nn), 96)
+					+ shift_left(to_unsigned(1, 2 * nn), 32);
+			end if;
+			return tmp(nn - 1 downto 0);
+		end function;
+
+		-- write a large number, one limb per cycle, using enable signal 'en'
+		procedure wr_large(
+			constant val : in unsigned; signal en : out std_logic;
+			signal data : out std_logic_vector; constant withfpwe : boolean) is
+			variable tmp : unsigned(w * ww - 1 downto 0);
+		begin
+			tmp := resize(val, w * ww);
+			wait until clk'event and clk = '1';
+			en <= '1';
+			for i in 0 to w - 1 loop
+				data <= std_logic_vector(tmp(ww*i + ww - 1 downto ww*i));
+				if withfpwe then
+					fpwe <= '1';
+				end if;
+				wait until clk'event and clk = '1';
+			end loop;
+			en <= '0';
+			fpwe <= '0';
+			wait until clk'event and clk = '1';
+			wait until clk'event and clk = '1';
+		end procedure;
+
+	begin
+		assert (not async)
+			report "mm_ndsp_tb: parameter 'async' must be FALSE"
+				severity FAILURE;
+
+		rstn <= '0';
+		for i in 0 to 9 loop
+			wait until clk'event and clk = '1';
+		end loop;
+		rstn <= '1';
+		for i in 0 to 9 loop
+			wait until clk'event and clk = '1';
+		end loop;
+
+		for tst in 0 to NBTESTS + (2 * NBFAST) - 1 loop
+
+			if tst < NBTESTS then
+				md := 0;
+			elsif tst < NBTESTS + NBFAST then
+				md := 1;
+			else
+				md := 2;
+			end if;
+			-- Solinas tests only if the mode exists & the prime fits in nn bits
+			next when md = 1 and ((not FASTRED_EN) or nn < 256);
+			next when md = 2 and ((not FASTRED_EN) or nn < 384);
+
+			if md = 0 then
+				-- random odd prime-like modulus of exactly nn bits
+				rnd_nn(p);
+				p(nn - 1) := '1';
+				p(0) := '1';
+			else
+				p := nist_p(128 + (128 * md));
+			end if;
+			-- p' = -p^-1 mod R (Newton iteration, each one doubles the precision)
+			inv := to_unsigned(1, RBITS);
+			for i in 0 to log2(RBITS) loop
+				inv := resize(inv * (to_unsigned(2, RBITS)
+				       - resize(resize(p, RBITS) * inv, RBITS)), RBITS);
+			end loop;
+			pp := (not inv) + 1;
+			-- operands (x, y < p)
+			rnd_nn(x);
+			x(nn - 1) := '0';
+			rnd_nn(y);
+			y(nn - 1) := '0';
+			if md /= 0 then
+				x := x mod p;
+				y := y mod p;
+			end if;
+			if tst mod 2 = 1 then
+				y := x;
+			end if;
+			-- expected result
+			s := x * y;
+			alpha := resize(resize(s, RBITS) * pp, RBITS);
+			t := resize(s, t'length) + resize(alpha * p, t'length);
+			zref := resize(shift_right(t, RBITS), w * ww);
+
+			-- a squaring with a random modulus is run twice: with sqr = 1,
+			-- then as a generic multiplication (sqr = 0, y = x)
+			if tst mod 2 = 1 and md = 0 then
+				npass := 2;
+			else
+				npass := 1;
+			end if;
+			for pass in 0 to npass - 1 loop
+				-- transfer operands
+				wr_large(p, pen, fpwdata, TRUE);
+				wr_large(pp, ppen, fpwdata, TRUE);
+				tx := cycles;
+				if tst mod 2 = 1 and pass = 0 then
+					sqr <= '1';
+					wr_large(x, xen, xyin, FALSE);
+				else
+					sqr <= '0';
+					wr_large(x, xen, xyin, FALSE);
+					wr_large(y, yen, xyin, FALSE);
+				end if;
+
+				-- start both multipliers at the same time
+				redmode <= std_logic_vector(to_unsigned(md, 2));
+				go <= '1';
+				wait until clk'event and clk = '1';
+				go <= '0';
+				t0 := cycles;
+				lat0 := 0;
+				lat1 := 0;
+				while lat0 = 0 or lat1 = 0 loop
+					wait until clk'event and clk = '1';
+					if irq0 = '1' and lat0 = 0 then
+						lat0 := cycles - t0;
+					end if;
+					if irq1 = '1' and lat1 = 0 then
+						lat1 := cycles - t0;
+					end if;
+				end loop;
+				sqr <= '0';
+				redmode <= "00";
+				if pass = 0 then
+					sum0(md) := sum0(md) + lat0;
+					sum1(md) := sum1(md) + lat1;
+					nbt(md) := nbt(md) + 1;
+				end if;
+				if npass = 2 then
+					sqsum0(pass) := sqsum0(pass) + lat0 + t0 - tx;
+					sqsum1(pass) := sqsum1(pass) + lat1 + t0 - tx;
+					nbsq(pass) := nbsq(pass) + 1;
+				end if;
+
+				-- read back both results (1 + sramlat cycles of latency, plus one
+				-- as signals are sampled at the same time as clock edges)
+				zren <= '1';
+				for i in 0 to w + sramlat loop
+					wait until clk'event and clk = '1';
+					if i >= 1 + sramlat then
+						zhw0(ww*(i-1-sramlat) + ww - 1 downto ww*(i-1-sramlat)) :=
+							unsigned(z0);
+						zhw1(ww*(i-1-sramlat) + ww - 1 downto ww*(i-1-sramlat)) :=
+							unsigned(z1);
+					end if;
+					if i = w - 1 then
+						zren <= '0';
+					end if;
+				end loop;
+
+				write(lin, string'("REDC #") & integer'image(tst));
+				if tst mod 2 = 1 and pass = 0 then
+					write(lin, string'(" (sqr)"));
+				elsif tst mod 2 = 1 then
+					write(lin, string'(" (x * x, sqr = 0)"));
+				end if;
+				if md /= 0 then
+					write(lin, string'(" (p") & integer'image(128 + (128 * md))
+					     & ", Solinas mode for mm_ndsp_mc)");
+				end if;
+				write(lin, string'(": mm_ndsp ") & integer'image(lat0)
+				     & " cycles, mm_ndsp_mc " & integer'image(lat1) & " cycles");
+				if zhw0 /= zref then
+					write(lin, string'(" - mm_ndsp MISMATCH"));
+					nberr := nberr + 1;
+				end if;
+				if md = 0 then
+					if zhw1 /= zref then
+						write(lin, string'(" - mm_ndsp_mc MISMATCH"));
+						nberr := nberr + 1;
+					end if;
+				else
+					-- Solinas mode: z = x * y mod p, with z < 2**(32K)
+					sm := s mod resize(p, 2 * nn);
+					zm := resize(zhw1, 2 * nn) mod resize(p, 2 * nn);
+					if zm /= sm or shift_right(zhw1, 128 + (128 * md)) /= 0 then
+						write(lin, string'(" - mm_ndsp_mc MISMATCH"));
+						nberr := nberr + 1;
+					end if;
+				end if;
+				writeline(output, lin);
+
+				for i in 0 to 9 loop
+					wait until clk'event and clk = '1';
+				end loop;
+			end loop;
+		end loop;
+
+		write(lin, string'("nn = ") & integer'image(nn) & ", ww = "
+		     & integer'image(ww) & ", ndsp = " & integer'image(ndsp)
+		     & ", nbchain = " & integer'image(nbchain)
+		     & ", sramlat = " & integer'image(sramlat));
+		writeline(output, lin);
+		write(lin, string'("average REDC latency: mm_ndsp ")
+		     & integer'image(sum0(0) / nbt(0)) & " cycles, mm_ndsp_mc "
+		     & integer'image(sum1(0) / nbt(0)) & " cycles");
+		writeline(output, lin);
+		write(lin, string'("average squaring latency (transfer + REDC): sqr = 1 mm_ndsp ")
+		     & integer'image(sqsum0(0) / nbsq(0)) & " mm_ndsp_mc "
+		     & integer'image(sqsum1(0) / nbsq(0)) & " cycles, sqr = 0 mm_ndsp "
+		     & integer'image(sqsum0(1) / nbsq(1)) & " mm_ndsp_mc "
+		     & integer'image(sqsum1(1) / nbsq(1)) & " cycles");
+		writeline(output, lin);
+		for i in 1 to 2 loop
+			if nbt(i) > 0 then
+				write(lin, string'("average latency for p")
+				     & integer'image(128 + (128 * i)) & ": generic REDC (mm_ndsp) "
+				     & integer'image(sum0(i) / nbt(i)) & " cycles, Solinas "
+				     & "multiply-and-fold (mm_ndsp_mc) "
+				     & integer'image(sum1(i) / nbt(i)) & " cycles");
+				writeline(output, lin);
+			end if;
+		end loop;
+		if not FASTRED_EN then
+			write(lin, string'("(Solinas mode not tested, see parameter "
+			     & "'fastred')"));
+			writeline(output, lin);
+		end if;
+		assert nberr = 0
+			report "mm_ndsp_tb: " & integer'image(nberr) & " wrong result(s)"
+				severity FAILURE;
+		report "mm_ndsp_tb: all results OK" severity NOTE;
+		done <= TRUE;
+		wait;
+	end process;
+
+end architecture sim;
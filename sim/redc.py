@@ -0,0 +1,162 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# REDC latencies of the Montgomery multipliers over a (ww, nbdsp) grid
+# (part of make mc).
+#
+# For each value of 'ww' (through 'techno' = asic & 'multwidth') and of
+# 'nbdsp', mm_ndsp_tb is compiled & elaborated in its own directory
+# <outdir>/<variant> with a copy of ecc_customize.vhd where these parameters
+# are overridden along with 'nn', 'nbchain' & 'async' (see build() in
+# regress.py), then simulated. The testbench runs mm_ndsp & mm_ndsp_mc on the
+# same random operands, checks both results and displays their average
+# latency in cycles, which are gathered here in a table in the layout of the
+# one of parameter 'nbdsp' in ecc_customize.vhd (and in <outdir>/redc.csv).
+# The average cycles of squarings (transfer + REDC) with sqr = 1 and as
+# generic multiplications (sqr = 0) are also written to <outdir>/redc.csv.
+# With --fastred, 'fastred' is set to TRUE and the average latencies of the
+# multiplications modulo p256 & p384 (generic REDC of mm_ndsp vs. Solinas
+# mode of mm_ndsp_mc, 'nn' must be >= 384 for both) are displayed as well.
+# A variant fails if its build or simulation does, or if any result is wrong.
+#
+#   python3 redc.py [-j jobs] [-o outdir] [-t timeout] [-n nn] [-c nbchain]
+#                   [-w ww,...] [-d nbdsp,...] [--mhz f] [--fastred]
+#
+
+import argparse
+import concurrent.futures
+import os
+import re
+import subprocess
+import sys
+import time
+
+import regress
+
+AVG_RE = re.compile(r"average REDC latency: mm_ndsp (\d+) cycles, mm_ndsp_mc (\d+) cycles")
+SQR_RE = re.compile(r"average squaring latency \(transfer \+ REDC\): sqr = 1 mm_ndsp (\d+) mm_ndsp_mc (\d+) "
+                    r"cycles, sqr = 0 mm_ndsp (\d+) mm_ndsp_mc (\d+) cycles")
+FAST_RE = re.compile(r"average latency for p(256|384): generic REDC \(mm_ndsp\) (\d+) cycles, Solinas "
+                     r"multiply-and-fold \(mm_ndsp_mc\) (\d+) cycles")
+
+# Build & simulate one variant, return (mm_ndsp, mm_ndsp_mc) latencies followed by
+# squaring cycles (sqr = 1 then sqr = 0, both multipliers), then with 'fast' generic
+# & Solinas latencies for p256 & p384, or an error string
+def run_variant(d, params, timeout, fast=False):
+    os.makedirs(d, exist_ok=True)
+    with open(os.path.join(d, "build.log"), "w") as log:
+        try:
+            regress.build(d, params, log, tb="mm_ndsp_tb")
+        except subprocess.CalledProcessError:
+            return "build failed (see %s)" % os.path.join(d, "build.log")
+    try:
+        p = subprocess.run([os.path.abspath(os.path.join(d, "mm_ndsp_tb")), "--ieee-asserts=disable"], cwd=d,
+                           stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True,
+                           timeout=timeout or None)
+    except subprocess.TimeoutExpired:
+        return "timeout"
+    with open(os.path.join(d, "mm_ndsp_tb.log"), "w") as f:
+        f.write(p.stdout)
+    m = AVG_RE.search(p.stdout)
+    q = SQR_RE.search(p.stdout)
+    if p.returncode != 0 or "MISMATCH" in p.stdout or not m or not q:
+        return "simulation failed (see %s)" % os.path.join(d, "mm_ndsp_tb.log")
+    r = tuple(int(v) for v in m.groups() + q.groups())
+    if fast:
+        f = {int(g[0]): (int(g[1]), int(g[2])) for g in FAST_RE.findall(p.stdout)}
+        if len(f) != 2:
+            return "Solinas mode not simulated (see %s)" % os.path.join(d, "mm_ndsp_tb.log")
+        r += f[256] + f[384]
+    return r
+
+def main():
+    ap = argparse.ArgumentParser(description="REDC latencies of mm_ndsp & mm_ndsp_mc over a (ww, nbdsp) grid")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="nb of variants built & simulated in parallel")
+    ap.add_argument("-o", "--outdir", default="redc", help="directory of variants & results")
+    ap.add_argument("-t", "--timeout", type=float, default=0, help="timeout per simulation (s, 0 for none)")
+    ap.add_argument("-n", "--nn", type=int, default=256, help="value of 'nn'")
+    ap.add_argument("-c", "--nbchain", type=int, default=2, help="value of 'nbchain' (must divide all nbdsp values)")
+    ap.add_argument("-w", "--ww", default="8,16,32,64", help="values of 'ww' ('multwidth' with 'techno' = asic)")
+    ap.add_argument("-d", "--nbdsp", default="2,4,6,8,10,12", help="values of 'nbdsp'")
+    ap.add_argument("--mhz", type=float, default=300, help="clock frequency for latencies in us")
+    ap.add_argument("--fastred", action="store_true", help="set 'fastred' to TRUE (Solinas mode for p256 & p384)")
+    args = ap.parse_args()
+
+    wws = [int(v) for v in args.ww.split(",")]
+    dsps = [int(v) for v in args.nbdsp.split(",")]
+    if any(d % args.nbchain for d in dsps):
+        ap.error("'nbchain' = %d must divide all values of 'nbdsp'" % args.nbchain)
+    if args.fastred and (args.nn < 384 or any(32 % ww for ww in wws)):
+        ap.error("--fastred needs 'nn' >= 384 and values of 'ww' dividing 32")
+    variants = []
+    for ww in wws:
+        for nbdsp in dsps:
+            params = {"nn": str(args.nn), "techno": "asic", "multwidth": str(ww), "nbdsp": str(nbdsp),
+                      "nbchain": str(args.nbchain), "async": "FALSE"}
+            if args.fastred:
+                params["fastred"] = "TRUE"
+            variants.append(((ww, nbdsp), os.path.join(args.outdir, "ww_%d-nbdsp_%d" % (ww, nbdsp)), params))
+    print("%d variants of mm_ndsp_tb (nn = %d, nbchain = %d), %d jobs" % (len(variants), args.nn, args.nbchain,
+          args.jobs))
+
+    os.makedirs(args.outdir, exist_ok=True)
+    t0 = time.time()
+    res = {}
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as ex:
+        futs = {ex.submit(run_variant, d, params, args.timeout, args.fastred): k for (k, d, params) in variants}
+        for f in concurrent.futures.as_completed(futs):
+            k = futs[f]
+            res[k] = f.result()
+            print("  ww = %2d, nbdsp = %2d: %s" % (k + ((res[k] if isinstance(res[k], str)
+                  else "mm_ndsp %d, mm_ndsp_mc %d cycles" % res[k][:2]),)))
+    elapsed = time.time() - t0
+
+    with open(os.path.join(args.outdir, "redc.csv"), "w") as f:
+        f.write("nn,ww,nbdsp,nbchain,mm_ndsp,mm_ndsp_mc,sqr_mm_ndsp,sqr_mm_ndsp_mc,mul_mm_ndsp,mul_mm_ndsp_mc,"
+                + ("p256_generic,p256_solinas,p384_generic,p384_solinas," if args.fastred else "") + "status\n")
+        for (k, _, _) in variants:
+            r = res[k]
+            f.write(",".join(str(v) for v in (args.nn,) + k + (args.nbchain,) + (("",) * (10 if args.fastred else 6) + (r,)
+                    if isinstance(r, str) else r + ("ok",))) + "\n")
+
+    # Table in us, mm_ndsp_mc above & mm_ndsp below (in parentheses)
+    print("REDC latency in us at %g MHz, mm_ndsp_mc (nbchain = %d) and (mm_ndsp):" % (args.mhz, args.nbchain))
+    print("   \\ nbdsp |" + "".join("%8d" % d for d in dsps))
+    print(" ww \\      |")
+    print("  ---------+" + "-" * (8 * len(dsps)))
+    us = lambda c: "%8.2f" % (c / args.mhz)
+    for ww in wws:
+        rs = [res[(ww, d)] for d in dsps]
+        print("  %5d    |" % ww + "".join("%8s" % "-" if isinstance(r, str) else us(r[1]) for r in rs))
+        print("           |" + "".join("%8s" % "" if isinstance(r, str) else "%8s" % ("(%.2f)" % (r[0] / args.mhz))
+              for r in rs))
+    print("Squarings (transfer + REDC) in cycles, FPSQR (sqr = 1) vs. generic multiplication (sqr = 0):")
+    for (k, _, _) in variants:
+        if not isinstance(res[k], str):
+            print("  ww = %2d, nbdsp = %2d: mm_ndsp %d vs. %d, mm_ndsp_mc %d vs. %d" % (k + (res[k][2], res[k][4],
+                  res[k][3], res[k][5])))
+    if args.fastred:
+        print("Multiplications modulo p256 & p384 in cycles, generic REDC (mm_ndsp) vs. Solinas mode (mm_ndsp_mc):")
+        for (k, _, _) in variants:
+            if not isinstance(res[k], str):
+                print("  ww = %2d, nbdsp = %2d: p256 %d vs. %d, p384 %d vs. %d" % (k + res[k][6:10]))
+    nok = sum(1 for r in res.values() if isinstance(r, str))
+    print("%d variants ok, %d failed, in %.1f s (results in %s)" % (len(res) - nok, nok, elapsed,
+          os.path.join(args.outdir, "redc.csv")))
+    return 1 if nok else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
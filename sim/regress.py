@@ -0,0 +1,264 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# Sharded regression of ecc_tb (make regress).
+#
+# ecc_tb reads one test-vector file ('simvecfile') serially. Here vector
+# files are split by curve into shards, each one holding the description of
+# a curve followed by some of its tests (the tests of a curve are spread on
+# several shards when they weigh too much for one, so that shards have
+# about the same simulation time), and shards are simulated in parallel on
+# all cores, each one in its own directory.
+#
+# To that end the testbench is compiled & elaborated once (in <outdir>/work)
+# with a copy of ecc_customize.vhd where 'simvecfile', 'simlogfile' &
+# 'simcyclesfile' are relative paths, which the simulator resolves in the
+# directory of each shard.
+#
+# Pass/fail & the nb of cycles of each test (AXI clock, as displayed by
+# ecc_tb at the end of each test) are merged in <outdir>/report.csv, the
+# cycles per phase of tests ('simcyclesfile') in <outdir>/cycles.csv, and a
+# summary of cycle counts per operation & nn is printed. Exit status is 1 if
+# any test failed or was not run (simulation crash or timeout).
+#
+#   python3 regress.py [-j jobs] [-o outdir] [-t timeout] [--no-build] vectors.txt...
+#
+
+import argparse
+import concurrent.futures
+import os
+import pty
+import re
+import subprocess
+import sys
+import threading
+import time
+
+CUSTOMIZE = os.path.join("..", "hdl", "common", "ecc_customize.vhd")
+
+# Relative cost of one test for balancing shards ([k]P is about nn point
+# operations, each one a constant nb of multiplications in O(nn^2))
+def cost(op, nn):
+    return nn ** 3 if op == "[k]P" else nn ** 2
+
+# Split vector files in curves: {header: (nn, [(op, lines), ...])},
+# in order of first appearance
+def read_vectors(files):
+    curves = {}
+    order = []
+    for fn in files:
+        hdr = None
+        cur = None
+        with open(fn) as f:
+            for l in f:
+                if l.startswith("== NEW CURVE"):
+                    hdr = [l]
+                    cur = None
+                elif l.startswith("== TEST"):
+                    if hdr is None:
+                        raise ValueError("%s: test before any curve" % fn)
+                    if isinstance(hdr, list):
+                        hdr = "".join(hdr)
+                        if hdr not in curves:
+                            m = re.search(r"^nn=(\d+)", hdr, re.M)
+                            curves[hdr] = (int(m.group(1)) if m else 0, [])
+                            order.append(hdr)
+                    # (op is what follows "== TEST ", up to the blank)
+                    cur = [l]
+                    curves[hdr][1].append((l.split()[2], cur))
+                elif cur is not None:
+                    cur.append(l)
+                elif isinstance(hdr, list):
+                    hdr.append(l)
+    return [(h, curves[h][0], curves[h][1]) for h in order]
+
+# Cut curves in shards of about 'target' cost each
+def make_shards(curves, target):
+    shards = []
+    for (hdr, nn, tests) in curves:
+        cur = []
+        c = 0
+        for t in tests:
+            cur.append(t)
+            c += cost(t[0], nn)
+            if c >= target:
+                shards.append((hdr, nn, cur, c))
+                cur = []
+                c = 0
+        if cur:
+            shards.append((hdr, nn, cur, c))
+    return shards
+
+# Set constant 'name' of ecc_customize.vhd text 's' to VHDL expression 'val'
+def set_constant(s, name, val):
+    (s, n) = re.subn(r"(\n\s*constant\s+%s\s*:[^:;]*:=\s*)[^;]*;" % name, lambda m: m.group(1) + val + ";", s)
+    if n != 1:
+        raise ValueError("can't find constant '%s' in %s" % (name, CUSTOMIZE))
+    return s
+
+# Compile & elaborate testbench 'tb' (ecc_tb by default) in 'outdir', with the
+# parameters of ecc_customize.vhd possibly overridden by 'params' ({name: VHDL
+# expression}) and the microcode & its packages taken from directory 'iram' if
+# given (see ecc_curve_iram/Makefile), displaying on 'out'
+def build(outdir, params={}, out=None, tb="ecc_tb", iram=None):
+    os.makedirs(outdir, exist_ok=True)
+    with open(CUSTOMIZE) as f:
+        s = f.read()
+    for (name, val) in params.items():
+        s = set_constant(s, name, val)
+    for (name, val) in (("simvecfile", "ecc_vec_in.txt"), ("simlogfile", "ecc.log"),
+                        ("simcyclesfile", "ecc_cycles.csv")):
+        s = set_constant(s, name, '"%s"' % val)
+    custom = os.path.join(outdir, "ecc_customize.vhd")
+    # (don't touch it if unchanged, not to have make recompile everything)
+    if (not os.path.exists(custom)) or (open(custom).read() != s):
+        with open(custom, "w") as f:
+            f.write(s)
+    work = os.path.join(outdir, "work")
+    cmd = ["make", "--no-print-directory", "WORK=" + work, "CUSTOMIZE=" + custom]
+    if iram:
+        cmd.append("IRAM=" + os.path.abspath(iram))
+    subprocess.check_call(cmd + ["workdir", os.path.join(work, tb + ".o")], stdout=out, stderr=out)
+    print("[GHDL-LLVM] -e " + tb, file=out, flush=True)
+    subprocess.check_call(["ghdl-llvm", "-e", "-fsynopsys", "--workdir=" + work,
+                           "-o", os.path.join(outdir, tb), tb], stdout=out, stderr=out)
+
+END_RE = re.compile(r">>>> END TEST (\S+)\s*(.*?) \[(\d+) cycles\](.*)$")
+
+# Simulate shard in directory 'd', return [(op, label, cycles, ok), ...]
+def run_shard(exe, d, timeout):
+    res = []
+    # Through a pseudo-terminal for the simulator to flush its output
+    # line by line (ecc_tb doesn't end the simulation at the end of the
+    # input file, it is killed once it displays it reached it)
+    (master, slave) = pty.openpty()
+    with open(os.path.join(d, "ecc_tb.log"), "w") as log:
+        p = subprocess.Popen([exe, "--ieee-asserts=disable"], cwd=d, stdin=subprocess.DEVNULL,
+                             stdout=slave, stderr=slave)
+        os.close(slave)
+        timer = threading.Timer(timeout, p.kill) if timeout else None
+        if timer:
+            timer.start()
+        buf = b""
+        while True:
+            try:
+                data = os.read(master, 65536)
+            except OSError:
+                data = b""
+            if not data:
+                break
+            buf += data
+            lines = buf.split(b"\n")
+            buf = lines.pop()
+            for l in lines:
+                l = l.decode(errors="replace").rstrip("\r")
+                log.write(l + "\n")
+                m = END_RE.search(l)
+                if m:
+                    res.append((m.group(1), m.group(2), int(m.group(3)), "SUCCESSFULL" in m.group(4)))
+                elif "End of testbench simulation (EOF)" in l:
+                    p.kill()
+        os.close(master)
+        p.wait()
+        if timer:
+            timer.cancel()
+    return res
+
+def main():
+    ap = argparse.ArgumentParser(description="Sharded regression of ecc_tb")
+    ap.add_argument("vectors", nargs="+", help="test-vector files (text format)")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="nb of parallel simulations")
+    ap.add_argument("-o", "--outdir", default="regress", help="build & shards directory")
+    ap.add_argument("-t", "--timeout", type=float, default=0, help="timeout per shard (s, 0 for none)")
+    ap.add_argument("-s", "--shards-per-job", type=int, default=4,
+                    help="nb of shards per job (more balances better, each one pays the IP init)")
+    ap.add_argument("--no-build", action="store_true", help="reuse <outdir>/ecc_tb as is")
+    args = ap.parse_args()
+
+    curves = read_vectors(args.vectors)
+    total = sum(cost(op, nn) for (_, nn, tests) in curves for (op, _) in tests)
+    if total == 0:
+        print("No test in input files")
+        return 1
+    shards = make_shards(curves, max(1, total // (args.jobs * args.shards_per_job)))
+    # Longest shards first
+    shards.sort(key=lambda s: -s[3])
+    if not args.no_build:
+        build(args.outdir)
+    exe = os.path.abspath(os.path.join(args.outdir, "ecc_tb"))
+    dirs = []
+    for (i, (hdr, nn, tests, c)) in enumerate(shards):
+        d = os.path.join(args.outdir, "shard-%04d" % i)
+        os.makedirs(d, exist_ok=True)
+        with open(os.path.join(d, "ecc_vec_in.txt"), "w") as f:
+            f.write(hdr)
+            for (op, lines) in tests:
+                f.write("".join(lines))
+        dirs.append(d)
+    ntests = sum(len(s[2]) for s in shards)
+    print("%d tests of %d curves in %d shards, %d jobs" % (ntests, len(curves), len(shards), args.jobs))
+
+    t0 = time.time()
+    report = []
+    notrun = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as ex:
+        futs = {ex.submit(run_shard, exe, d, args.timeout): i for (i, d) in enumerate(dirs)}
+        for f in concurrent.futures.as_completed(futs):
+            i = futs[f]
+            res = f.result()
+            nn = shards[i][1]
+            for (op, label, cyc, ok) in res:
+                report.append((i, op, label, nn, cyc, ok))
+            missing = len(shards[i][2]) - len(res)
+            notrun += missing
+            print("  shard %4d: %d/%d tests, %d failed%s" % (i, len(res), len(shards[i][2]),
+                  sum(1 for r in res if not r[3]), ", %d NOT RUN (see %s/ecc_tb.log)" % (missing, dirs[i])
+                  if missing else ""))
+    elapsed = time.time() - t0
+
+    report.sort()
+    with open(os.path.join(args.outdir, "report.csv"), "w") as f:
+        f.write("shard,op,test,nn,cycles,status\n")
+        for (i, op, label, nn, cyc, ok) in report:
+            f.write("%d,%s,%s,%d,%d,%s\n" % (i, op, label, nn, cyc, "ok" if ok else "FAILED"))
+    # Cycles per phase, shard after shard
+    with open(os.path.join(args.outdir, "cycles.csv"), "w") as f:
+        hdr = False
+        for (i, d) in enumerate(dirs):
+            fn = os.path.join(d, "ecc_cycles.csv")
+            if not os.path.exists(fn):
+                continue
+            for (n, l) in enumerate(open(fn)):
+                if n == 0:
+                    if not hdr:
+                        f.write("shard," + l)
+                        hdr = True
+                elif l.strip():
+                    f.write("%d,%s" % (i, l))
+    # Cycles per operation & nn
+    stats = {}
+    for (_, op, _, nn, cyc, ok) in report:
+        stats.setdefault((op, nn), []).append(cyc)
+    print("%-12s %5s %6s %10s %10s %10s" % ("op", "nn", "count", "min", "mean", "max"))
+    for ((op, nn), l) in sorted(stats.items()):
+        print("%-12s %5d %6d %10d %10d %10d" % (op, nn, len(l), min(l), sum(l) // len(l), max(l)))
+    nok = sum(1 for r in report if not r[5])
+    print("ok = %d, failed = %d, not run = %d, in %.1f s (report in %s)" % (len(report) - nok, nok, notrun,
+          elapsed, os.path.join(args.outdir, "report.csv")))
+    return 1 if (nok or notrun) else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,100 @@
+#
+#  Copyright (C) 2023 - This file is part of IPECC project
+#
+#  Authors:
+#      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#      Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+#  Contributors:
+#      Adrian THILLARD
+#      Emmanuel PROUFF
+#
+#  This software is licensed under GPL v2 license.
+#  See LICENSE file at the root folder of the project.
+#
+
+#
+# Out-of-context synthesis of one top-level of the IP in Vivado (non-project
+# mode) and report of its resource utilization, e.g to compare 'ecc' with
+# 'ecc_multi' (see make multicmp in sim/):
+#
+#   vivado -mode batch -source utilization.tcl \
+#     -tclargs <ecc_customize.vhd> <top> [<part> [<outdir>]]
+#
+# <ecc_customize.vhd> replaces the one of hdl/common (parameter 'techno'
+# selects the sources of hdl/techno-specific). The microcode packages must
+# have been generated (make in hdl/common/ecc_curve_iram). The full report
+# is written to <outdir>/<top>_utilization.rpt and the totals printed as
+#
+#   <top>: lut=N ff=N dsp=N bram=N
+#
+# (BRAM in 36 Kb tiles, rounded up) which is the format dse.py --synth
+# expects.
+#
+
+if {[llength $argv] < 2} {
+	puts "usage: utilization.tcl <ecc_customize.vhd> <top> \[<part> \[<outdir>\]\]"
+	exit 1
+}
+set customize [file normalize [lindex $argv 0]]
+set top [lindex $argv 1]
+set part [expr {[llength $argv] > 2 ? [lindex $argv 2] : "xc7z020clg484-1"}]
+set outdir [file normalize [expr {[llength $argv] > 3 ? [lindex $argv 3] : "."}]]
+
+set hdl [file normalize [file join [file dirname [info script]] .. hdl]]
+
+# techno-specific sources, as selected in ecc_customize.vhd
+set f [open $customize]
+set s [read $f]
+close $f
+if {![regexp -line {^\s*constant\s+techno\s*:\s*techno_type\s*:=\s*(\w+)\s*;} $s -> techno]} {
+	puts "utilization.tcl: no 'techno' in $customize"
+	exit 1
+}
+switch -- $techno {
+	series7 - ultrascale { set tdir [file join $hdl techno-specific xilinxa $techno] }
+	default {
+		puts "utilization.tcl: 'techno' = $techno is not a Xilinx target"
+		exit 1
+	}
+}
+
+read_vhdl $customize
+foreach v [concat [glob [file join $hdl common *.vhd]] \
+	[glob [file join $hdl common ecc_trng *.vhd]] \
+	[glob [file join $hdl common ecc_curve_iram *.vhd]] \
+	[glob [file join $tdir *.vhd]]] {
+	# (the package of parameters is replaced, and the TRNG model is
+	# simulation-only)
+	if {[file tail $v] ni {ecc_customize.vhd es_trng_sim.vhd}} {
+		read_vhdl $v
+	}
+}
+
+synth_design -top $top -part $part -mode out_of_context
+
+file mkdir $outdir
+set rpt [file join $outdir ${top}_utilization.rpt]
+report_utilization -file $rpt
+
+# totals, from the summary tables of the report (row names differ between
+# 7-series & UltraScale)
+set f [open $rpt]
+set r [read $f]
+close $f
+proc total {r rows} {
+	foreach row $rows {
+		if {[regexp -line "^\\|\\s*${row}\\s*\\|\\s*(\[0-9.\]+)" $r -> n]} {
+			return $n
+		}
+	}
+	return "?"
+}
+set lut [total $r {"Slice LUTs\\*?" "CLB LUTs\\*?"}]
+set ff [total $r {"Slice Registers" "CLB Registers"}]
+set dsp [total $r {"DSPs"}]
+set bram [total $r {"Block RAM Tile"}]
+if {[string is double -strict $bram]} {
+	set bram [expr {int(ceil($bram))}]
+}
+puts "$top: lut=$lut ff=$ff dsp=$dsp bram=$bram"